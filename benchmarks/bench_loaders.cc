@@ -0,0 +1,476 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/Archive.hh>
+#include <zenkit/Logger.hh>
+#include <zenkit/Mesh.hh>
+#include <zenkit/Misc.hh>
+#include <zenkit/ModelAnimation.hh>
+#include <zenkit/MultiResolutionMesh.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/Texture.hh>
+#include <zenkit/Vfs.hh>
+#include <zenkit/World.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Allocations are counted by replacing the global allocation functions. This also counts the allocations made by
+// ZenKit itself, unless it is a DLL, which has its own allocation functions.
+static std::atomic_size_t g_allocations {0};
+static std::atomic_size_t g_allocated_bytes {0};
+
+void* operator new(std::size_t size) {
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+	if (auto* p = std::malloc(size == 0 ? 1 : size)) return p;
+	throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void print_usage() {
+	std::cerr << "Usage: zenkit_bench [-s SAMPLES] [-r ROUNDS] [GAME]\n\n"
+	          << "Measures the loaders using the test samples in SAMPLES (default: tests/samples). If the directory\n"
+	          << "of a Gothic installation is given, all VDF disks in its Data directory are mounted and the worlds,\n"
+	          << "meshes, textures and animations in them are measured as well. Each benchmark is run for at least\n"
+	          << "50ms, ROUNDS times (default: 5), and the fastest round is reported together with the allocations\n"
+	          << "of one run and the peak resident set size of the process so far.\n";
+}
+
+/// \return The peak resident set size of the process in bytes.
+static std::size_t peak_rss() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters {};
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters);
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage {};
+	getrusage(RUSAGE_SELF, &usage);
+	#ifdef __APPLE__
+	return static_cast<std::size_t>(usage.ru_maxrss);
+	#else
+	return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+	#endif
+#endif
+}
+
+static int g_rounds = 5;
+
+/// \brief Calls \p fn until at least 50ms passed, `g_rounds` times, and prints the fastest time per operation.
+/// \param name The name of the benchmark.
+/// \param ops The number of operations performed by each call to \p fn.
+/// \param bytes The number of bytes of input processed by each call to \p fn or 0 to not report the throughput.
+/// \param fn The function to measure.
+template <typename F>
+static void bench(std::string const& name, std::size_t ops, std::size_t bytes, F const& fn) {
+	using namespace std::chrono;
+
+	auto allocations = g_allocations.load();
+	auto allocated_bytes = g_allocated_bytes.load();
+	fn();
+	allocations = g_allocations.load() - allocations;
+	allocated_bytes = g_allocated_bytes.load() - allocated_bytes;
+
+	auto best = duration<double, std::nano>::max();
+	for (auto round = 0; round < g_rounds; ++round) {
+		auto calls = 0u;
+		auto start = Clock::now();
+		auto elapsed = Clock::duration::zero();
+
+		do {
+			fn();
+			++calls;
+			elapsed = Clock::now() - start;
+		} while (elapsed < milliseconds {50});
+
+		best = std::min(best, duration<double, std::nano> {elapsed} / static_cast<double>(calls));
+	}
+
+	auto per_op = best.count() / static_cast<double>(ops);
+	if (per_op >= 1e6) {
+		std::printf("%-40s %10.2f ms/op", name.c_str(), per_op / 1e6);
+	} else if (per_op >= 1e3) {
+		std::printf("%-40s %10.2f us/op", name.c_str(), per_op / 1e3);
+	} else {
+		std::printf("%-40s %10.2f ns/op", name.c_str(), per_op);
+	}
+
+	if (bytes != 0) {
+		std::printf(" %10.1f MB/s", static_cast<double>(bytes) / best.count() * 1e3);
+	} else {
+		std::printf(" %15s", "");
+	}
+
+	std::printf(" %12.1f allocs/op %10.1f KiB/op %8.1f MiB peak\n",
+	            static_cast<double>(allocations) / static_cast<double>(ops),
+	            static_cast<double>(allocated_bytes) / static_cast<double>(ops) / 1024.,
+	            static_cast<double>(peak_rss()) / 1024. / 1024.);
+}
+
+/// \return The contents of the file at \p path or an empty vector if it could not be read.
+static std::vector<std::byte> read_file(std::filesystem::path const& path) {
+	auto r = zenkit::Read::from(path);
+	if (r == nullptr) return {};
+
+	r->seek(0, zenkit::Whence::END);
+	std::vector<std::byte> data(r->tell());
+	r->seek(0, zenkit::Whence::BEG);
+	r->read(data.data(), data.size());
+	return data;
+}
+
+/// \brief Measures loading \p T from each of the \p files in memory using `T::load(Read*, args...)`. Empty files,
+///        i.e. missing samples, are ignored.
+template <typename T, typename... Args>
+static void bench_load(std::string const& name, std::vector<std::vector<std::byte>> files, Args... args) {
+	files.erase(std::remove_if(files.begin(), files.end(), [](auto const& file) { return file.empty(); }), files.end());
+
+	if (files.empty()) {
+		std::printf("%-40s skipped, no samples\n", name.c_str());
+		return;
+	}
+
+	std::size_t bytes = 0;
+	for (auto const& file : files) {
+		bytes += file.size();
+	}
+
+	bench(name, files.size(), bytes, [&] {
+		for (auto const& file : files) {
+			auto r = zenkit::Read::from(file.data(), file.size());
+			T value {};
+			value.load(r.get(), args...);
+		}
+	});
+}
+
+static void bench_stream() {
+	constexpr std::size_t N = 64 * 1024;
+
+	std::vector<std::byte> data;
+	auto w = zenkit::Write::to(&data);
+	for (std::size_t i = 0; i < N; ++i) {
+		w->write_uint(static_cast<std::uint32_t>(i));
+		w->write_float(static_cast<float>(i));
+		w->write_vec3({1, 2, 3});
+		w->write_line("ZENGIN_LINE");
+	}
+
+	auto r = zenkit::Read::from(&data);
+	std::uint64_t sink = 0;
+
+	bench("Read::read_uint", data.size() / 4, data.size(), [&] {
+		r->seek(0, zenkit::Whence::BEG);
+		for (std::size_t i = 0; i < data.size() / 4; ++i) {
+			sink += r->read_uint();
+		}
+	});
+
+	bench("Read::read_float", data.size() / 4, data.size(), [&] {
+		r->seek(0, zenkit::Whence::BEG);
+		for (std::size_t i = 0; i < data.size() / 4; ++i) {
+			sink += static_cast<std::uint64_t>(r->read_float());
+		}
+	});
+
+	bench("Read::read_vec3", N, N * 12, [&] {
+		r->seek(0, zenkit::Whence::BEG);
+		for (std::size_t i = 0; i < N; ++i) {
+			sink += static_cast<std::uint64_t>(r->read_vec3().x);
+		}
+	});
+
+	bench("Read::read_string(16)", N, N * 16, [&] {
+		r->seek(0, zenkit::Whence::BEG);
+		for (std::size_t i = 0; i < N; ++i) {
+			sink += r->read_string(16).size();
+		}
+	});
+
+	bench("Read::read_line (mixed records)", N, data.size(), [&] {
+		r->seek(0, zenkit::Whence::BEG);
+		for (std::size_t i = 0; i < N; ++i) {
+			sink += r->read_uint();
+			sink += static_cast<std::uint64_t>(r->read_float());
+			sink += static_cast<std::uint64_t>(r->read_vec3().x);
+			sink += r->read_line(false).size();
+		}
+	});
+
+	// Keeps the reads from being optimized away.
+	if (sink == 0) std::printf("\n");
+}
+
+static constexpr zenkit::ArchiveFormat ARCHIVE_FORMATS[] = {
+    zenkit::ArchiveFormat::ASCII,
+    zenkit::ArchiveFormat::BINARY,
+    zenkit::ArchiveFormat::BINSAFE,
+};
+
+static std::vector<std::byte> write_archive(std::vector<std::shared_ptr<zenkit::Object>> const& objects,
+                                            zenkit::ArchiveFormat format,
+                                            zenkit::GameVersion version) {
+	std::vector<std::byte> data;
+	auto w = zenkit::Write::to(&data);
+	auto ar = zenkit::WriteArchive::to(w.get(), format);
+	for (auto const& obj : objects) {
+		ar->write_object(obj, version);
+	}
+	ar->write_header();
+	return data;
+}
+
+/// \return Whether \p obj can be read back after writing it in every archive format.
+static bool round_trips(std::shared_ptr<zenkit::Object> const& obj, zenkit::GameVersion version) {
+	for (auto format : ARCHIVE_FORMATS) {
+		try {
+			auto data = write_archive({obj}, format, version);
+			auto r = zenkit::Read::from(&data);
+			(void) zenkit::ReadArchive::from(r.get())->read_object(version);
+		} catch (std::exception const&) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// \brief Measures reading the VObs in \p dir from an archive of each format.
+static void bench_archives(std::string const& name, std::filesystem::path const& dir, zenkit::GameVersion version) {
+	std::vector<std::shared_ptr<zenkit::Object>> objects;
+
+	std::error_code ec;
+	for (auto const& entry : std::filesystem::directory_iterator {dir, ec}) {
+		auto r = zenkit::Read::from(entry.path());
+		auto obj = zenkit::ReadArchive::from(r.get())->read_object(version);
+
+		// Some VObs are not written exactly like they are read in every format. Those are not measured.
+		if (obj != nullptr && round_trips(obj, version)) objects.push_back(obj);
+	}
+
+	if (objects.empty()) {
+		std::printf("%-40s skipped, no samples\n", (name + " ReadArchive").c_str());
+		return;
+	}
+
+	for (auto format : ARCHIVE_FORMATS) {
+		auto data = write_archive(objects, format, version);
+		auto label = format == zenkit::ArchiveFormat::ASCII ? " (ASCII)"
+		    : format == zenkit::ArchiveFormat::BINARY       ? " (BINARY)"
+		                                                    : " (BINSAFE)";
+
+		bench(name + " ReadArchive" + label, objects.size(), data.size(), [&] {
+			auto r = zenkit::Read::from(&data);
+			auto ar = zenkit::ReadArchive::from(r.get());
+			for (std::size_t i = 0; i < objects.size(); ++i) {
+				(void) ar->read_object(version);
+			}
+		});
+	}
+}
+
+static void bench_textures(std::string const& name, std::vector<std::vector<std::byte>> files) {
+	files.erase(std::remove_if(files.begin(), files.end(), [](auto const& file) { return file.empty(); }), files.end());
+
+	bench_load<zenkit::Texture>(name + " Texture::load", files);
+	if (files.empty()) return;
+
+	std::vector<zenkit::Texture> textures(files.size());
+	std::size_t pixels = 0;
+	for (std::size_t i = 0; i < files.size(); ++i) {
+		auto r = zenkit::Read::from(files[i].data(), files[i].size());
+		textures[i].load(r.get());
+		pixels += textures[i].width() * textures[i].height();
+	}
+
+	bench(name + " Texture::as_rgba8", textures.size(), pixels * 4, [&] {
+		for (auto const& texture : textures) {
+			(void) texture.as_rgba8(0);
+		}
+	});
+
+	std::vector<std::uint8_t> buffer(pixels * 4);
+	bench(name + " Texture::as_rgba8_into", textures.size(), pixels * 4, [&] {
+		for (auto const& texture : textures) {
+			texture.as_rgba8_into(buffer.data(), texture.width() * texture.height() * 4, 0);
+		}
+	});
+}
+
+/// \brief Collects the paths of all files in \p node and its children.
+static void collect_files(zenkit::VfsNode const& node, std::string const& prefix, std::vector<std::string>& out) {
+	for (auto const& child : node.children()) {
+		auto path = prefix + "/" + child.name();
+		if (child.type() == zenkit::VfsNodeType::DIRECTORY) {
+			collect_files(child, path, out);
+		} else {
+			out.push_back(path);
+		}
+	}
+}
+
+static void bench_vfs_lookups(std::string const& name, zenkit::Vfs const& vfs) {
+	std::vector<std::string> paths;
+	collect_files(vfs.root(), "", paths);
+	if (paths.empty()) return;
+
+	std::vector<std::string> names;
+	for (auto const& path : paths) {
+		names.push_back(path.substr(path.rfind('/') + 1));
+	}
+
+	bench(name + " Vfs::find", names.size(), 0, [&] {
+		for (auto const& file : names) {
+			(void) vfs.find(file);
+		}
+	});
+
+	bench(name + " Vfs::resolve", paths.size(), 0, [&] {
+		for (auto const& path : paths) {
+			(void) vfs.resolve(path);
+		}
+	});
+}
+
+static void bench_samples(std::filesystem::path const& samples) {
+	auto vdf = samples / "basic.vdf";
+	auto vdf_data = read_file(vdf);
+
+	if (vdf_data.empty()) {
+		std::printf("%-40s skipped, no samples\n", "samples Vfs::mount_disk");
+	} else {
+		bench("samples Vfs::mount_disk", 1, vdf_data.size(), [&] {
+			zenkit::Vfs vfs;
+			vfs.mount_disk(vdf);
+		});
+
+		zenkit::Vfs vfs;
+		vfs.mount_disk(vdf);
+		bench_vfs_lookups("samples", vfs);
+	}
+
+	bench_archives("samples G1", samples / "G1" / "VOb", zenkit::GameVersion::GOTHIC_1);
+	bench_archives("samples G2", samples / "G2" / "VOb", zenkit::GameVersion::GOTHIC_2);
+
+	bench_load<zenkit::World>("samples World::load (G1 save)",
+	                          {read_file(samples / "G1" / "Save" / "WORLD.SAV")},
+	                          zenkit::GameVersion::GOTHIC_1);
+	bench_load<zenkit::World>("samples World::load (G2 save)",
+	                          {read_file(samples / "G2" / "Save" / "NEWWORLD.SAV")},
+	                          zenkit::GameVersion::GOTHIC_2);
+	bench_load<zenkit::MultiResolutionMesh>("samples MultiResolutionMesh::load", {read_file(samples / "mesh0.mrm")});
+	bench_load<zenkit::ModelAnimation>("samples ModelAnimation::load",
+	                                   {read_file(samples / "G1" / "HUMANS-S_FISTRUN.MAN"),
+	                                    read_file(samples / "G2" / "HUMANS-S_FISTRUN.MAN")});
+	bench_textures("samples", {read_file(samples / "erz.tex")});
+}
+
+/// \return The contents of all files in \p vfs whose name ends with \p extension.
+static std::vector<std::vector<std::byte>> collect_by_extension(zenkit::Vfs const& vfs, std::string_view extension) {
+	std::vector<std::string> paths;
+	collect_files(vfs.root(), "", paths);
+
+	std::vector<std::vector<std::byte>> files;
+	for (auto const& path : paths) {
+		if (path.size() < extension.size()) continue;
+		if (!zenkit::iequals(std::string_view {path}.substr(path.size() - extension.size()), extension)) continue;
+
+		auto span = vfs.resolve(path)->data_view();
+		auto const* data = span.data();
+		files.emplace_back(data, data + span.size());
+	}
+
+	return files;
+}
+
+static void bench_game(std::filesystem::path const& game) {
+	std::vector<std::filesystem::path> disks;
+
+	std::error_code ec;
+	for (auto const& dir : std::filesystem::directory_iterator {game, ec}) {
+		if (!zenkit::iequals(dir.path().filename().string(), "data")) continue;
+
+		for (auto const& entry : std::filesystem::directory_iterator {dir.path(), ec}) {
+			if (zenkit::iequals(entry.path().extension().string(), ".vdf")) disks.push_back(entry.path());
+		}
+	}
+
+	if (disks.empty()) {
+		std::cerr << "No VDF disks found in " << (game / "Data") << "\n";
+		return;
+	}
+
+	std::size_t disk_bytes = 0;
+	for (auto const& disk : disks) {
+		disk_bytes += std::filesystem::file_size(disk);
+	}
+
+	bench("game Vfs::mount_disks", disks.size(), disk_bytes, [&] {
+		zenkit::Vfs vfs;
+		vfs.mount_disks(disks);
+	});
+
+	zenkit::Vfs vfs;
+	vfs.mount_disks(disks);
+	bench_vfs_lookups("game", vfs);
+
+	bench_load<zenkit::World>("game World::load", collect_by_extension(vfs, ".ZEN"));
+	bench_load<zenkit::Mesh>("game Mesh::load", collect_by_extension(vfs, ".MSH"), false);
+	bench_load<zenkit::MultiResolutionMesh>("game MultiResolutionMesh::load", collect_by_extension(vfs, ".MRM"));
+	bench_load<zenkit::ModelAnimation>("game ModelAnimation::load", collect_by_extension(vfs, ".MAN"));
+	bench_textures("game", collect_by_extension(vfs, ".TEX"));
+}
+
+int main(int argc, char const** argv) {
+	std::filesystem::path samples = "tests/samples";
+	std::filesystem::path game;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg {argv[i]};
+
+		if (arg == "-s" && i + 1 < argc) {
+			samples = argv[++i];
+		} else if (arg == "-r" && i + 1 < argc) {
+			g_rounds = std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "-h" || arg[0] == '-' || !game.empty()) {
+			print_usage();
+			return arg == "-h" ? 0 : 1;
+		} else {
+			game = arg;
+		}
+	}
+
+	zenkit::Logger::set_default(zenkit::LogLevel::ERROR);
+
+	bench_stream();
+	bench_samples(samples);
+	if (!game.empty()) bench_game(game);
+	return 0;
+}
@@ -0,0 +1,330 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/DaedalusScript.hh>
+#include <zenkit/DaedalusVm.hh>
+#include <zenkit/Logger.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/addon/daedalus.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Op = zenkit::DaedalusOpcode;
+using Type = zenkit::DaedalusDataType;
+using Clock = std::chrono::steady_clock;
+
+void print_usage() {
+	std::cerr << "Usage: zenkit_bench_vm [GOTHIC.DAT]\n\n"
+	          << "Measures the Daedalus VM using small scripts assembled in memory. If a compiled script like\n"
+	          << "GOTHIC.DAT is given, loading it, looking up its symbols and initializing its items and NPCs\n"
+	          << "is measured as well.\n";
+}
+
+/// \brief Calls \p fn until at least 50ms passed, five times, and prints the fastest time per operation.
+/// \param name The name of the benchmark.
+/// \param ops The number of operations performed by each call to \p fn.
+/// \param fn The function to measure.
+template <typename F>
+static void bench(char const* name, std::size_t ops, F const& fn) {
+	using namespace std::chrono;
+
+	auto best = duration<double, std::nano>::max();
+	for (auto round = 0; round < 5; ++round) {
+		auto calls = 0u;
+		auto start = Clock::now();
+		auto elapsed = Clock::duration::zero();
+
+		do {
+			fn();
+			++calls;
+			elapsed = Clock::now() - start;
+		} while (elapsed < milliseconds {50});
+
+		best = std::min(best, duration<double, std::nano> {elapsed} / (static_cast<double>(calls) * ops));
+	}
+
+	std::printf("%-32s %12.2f ns/op %14.0f op/s\n", name, best.count(), 1e9 / best.count());
+}
+
+/// \brief Assembles a compiled Daedalus script in memory.
+class Assembler {
+public:
+	std::uint32_t variable(std::string const& name, Type type) {
+		_m_symbols.push_back({name, type, 0, 1, 0, 0});
+		return static_cast<std::uint32_t>(_m_symbols.size() - 1);
+	}
+
+	/// \brief Declares a function starting at the current end of the code, followed by its parameters.
+	std::uint32_t function(std::string const& name, std::vector<Type> const& params, Type rtype, bool external) {
+		auto flags = zenkit::DaedalusSymbolFlag::CONST;
+		if (rtype != Type::VOID) flags |= zenkit::DaedalusSymbolFlag::RETURN;
+		if (external) flags |= zenkit::DaedalusSymbolFlag::EXTERNAL;
+
+		_m_symbols.push_back({name,
+		                      Type::FUNCTION,
+		                      flags,
+		                      static_cast<std::uint32_t>(params.size()),
+		                      static_cast<std::uint32_t>(rtype),
+		                      external ? 0 : here()});
+		auto index = static_cast<std::uint32_t>(_m_symbols.size() - 1);
+
+		for (auto i = 0u; i < params.size(); ++i) {
+			this->variable(name + ".P" + std::to_string(i), params[i]);
+		}
+
+		return index;
+	}
+
+	[[nodiscard]] std::uint32_t here() const {
+		return static_cast<std::uint32_t>(_m_code.size());
+	}
+
+	void op(Op o) {
+		_m_code.push_back(static_cast<std::uint8_t>(o));
+	}
+
+	/// \brief Emits an instruction with a 32-bit operand and returns the offset of the operand.
+	std::size_t op(Op o, std::uint32_t operand) {
+		this->op(o);
+		auto at = _m_code.size();
+		for (auto i = 0; i < 4; ++i) {
+			_m_code.push_back(static_cast<std::uint8_t>(operand >> (8 * i)));
+		}
+		return at;
+	}
+
+	void patch(std::size_t at, std::uint32_t operand) {
+		for (auto i = 0; i < 4; ++i) {
+			_m_code[at + i] = static_cast<std::uint8_t>(operand >> (8 * i));
+		}
+	}
+
+	[[nodiscard]] zenkit::DaedalusScript build() const {
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		w->write_ubyte(50);
+		w->write_uint(static_cast<std::uint32_t>(_m_symbols.size()));
+
+		for (auto i = 0u; i < _m_symbols.size(); ++i) {
+			w->write_uint(i); // Sort table
+		}
+
+		for (auto const& sym : _m_symbols) {
+			w->write_uint(1);
+			w->write_line(sym.name);
+			w->write_uint(sym.vary);
+			w->write_uint(sym.count | static_cast<std::uint32_t>(sym.type) << 12 | sym.flags << 16);
+
+			for (auto i = 0; i < 5; ++i) {
+				w->write_uint(0); // File, line and character info
+			}
+
+			if (sym.type == Type::INT) w->write_uint(0);
+			if (sym.type == Type::STRING) w->write_line("");
+			if (sym.type == Type::FUNCTION) w->write_uint(sym.address);
+			w->write_int(-1);
+		}
+
+		w->write_uint(static_cast<std::uint32_t>(_m_code.size()));
+		w->write(_m_code.data(), _m_code.size());
+
+		auto r = zenkit::Read::from(&data);
+		zenkit::DaedalusScript script;
+		script.load(r.get());
+		return script;
+	}
+
+private:
+	struct Symbol {
+		std::string name;
+		Type type;
+		std::uint32_t flags, count, vary, address;
+	};
+
+	std::vector<Symbol> _m_symbols;
+	std::vector<std::uint8_t> _m_code;
+};
+
+/// \brief Emits `while (i < n) { <body> i += 1; }` with `i` starting at zero and `n` being the first parameter of
+///        the function \p fn.
+template <typename F>
+static void emit_loop(Assembler& a, std::uint32_t fn, std::uint32_t i, F const& body) {
+	a.op(Op::PUSHV, fn + 1);
+	a.op(Op::MOVI);
+	a.op(Op::PUSHI, 0);
+	a.op(Op::PUSHV, i);
+	a.op(Op::MOVI);
+
+	auto loop = a.here();
+	a.op(Op::PUSHV, fn + 1);
+	a.op(Op::PUSHV, i);
+	a.op(Op::LT);
+	auto end = a.op(Op::BZ, 0);
+	body();
+	a.op(Op::PUSHI, 1);
+	a.op(Op::PUSHV, i);
+	a.op(Op::ADDMOVI);
+	a.op(Op::B, loop);
+	a.patch(end, a.here());
+}
+
+/// \brief Assembles the functions measured by #bench_synthetic.
+static zenkit::DaedalusScript make_synthetic_script() {
+	Assembler a;
+	auto i = a.variable("I", Type::INT);
+	auto s = a.variable("S", Type::INT);
+	auto t = a.variable("T", Type::STRING);
+	a.op(Op::RSR);
+
+	auto twice = a.function("TWICE", {Type::INT}, Type::INT, true);
+	auto itos = a.function("INTTOSTRING", {Type::INT}, Type::STRING, true);
+	auto concat = a.function("CONCATSTRINGS", {Type::STRING, Type::STRING}, Type::STRING, true);
+
+	// func int ARITHMETIC(var int n) { s = 0; while (i < n) { s += i * 3 - 1; i += 1; }; return s; }
+	auto arithmetic = a.function("ARITHMETIC", {Type::INT}, Type::INT, false);
+	a.op(Op::PUSHI, 0);
+	a.op(Op::PUSHV, s);
+	a.op(Op::MOVI);
+	emit_loop(a, arithmetic, i, [&] {
+		a.op(Op::PUSHI, 1);
+		a.op(Op::PUSHI, 3);
+		a.op(Op::PUSHV, i);
+		a.op(Op::MUL);
+		a.op(Op::SUB);
+		a.op(Op::PUSHV, s);
+		a.op(Op::ADDMOVI);
+	});
+	a.op(Op::PUSHV, s);
+	a.op(Op::RSR);
+
+	// func void EXTERNALS(var int n) { while (i < n) { s += TWICE(i); i += 1; }; }
+	auto externals = a.function("EXTERNALS", {Type::INT}, Type::VOID, false);
+	emit_loop(a, externals, i, [&] {
+		a.op(Op::PUSHV, i);
+		a.op(Op::BE, twice);
+		a.op(Op::PUSHV, s);
+		a.op(Op::ADDMOVI);
+	});
+	a.op(Op::RSR);
+
+	// func void STRINGS(var int n) { while (i < n) { t = CONCATSTRINGS("", INTTOSTRING(i)); i += 1; }; }
+	auto strings = a.function("STRINGS", {Type::INT}, Type::VOID, false);
+	auto empty = a.variable("STRINGS.EMPTY", Type::STRING);
+	emit_loop(a, strings, i, [&] {
+		a.op(Op::PUSHV, empty);
+		a.op(Op::PUSHV, i);
+		a.op(Op::BE, itos);
+		a.op(Op::BE, concat);
+		a.op(Op::PUSHV, t);
+		a.op(Op::MOVS);
+	});
+	a.op(Op::RSR);
+
+	// func int IDENTITY(var int v) { return v; }
+	auto identity = a.function("IDENTITY", {Type::INT}, Type::INT, false);
+	a.op(Op::PUSHV, identity + 1);
+	a.op(Op::MOVI);
+	a.op(Op::PUSHV, identity + 1);
+	a.op(Op::RSR);
+
+	return a.build();
+}
+
+/// \return The number of instructions executed by \p fn.
+template <typename F>
+static std::size_t count_instructions(zenkit::DaedalusVm& vm, F const& fn) {
+	vm.set_profiling(true);
+	fn();
+	auto count = vm.profile()->instructions;
+	vm.set_profiling(false);
+	return count;
+}
+
+static void bench_synthetic() {
+	constexpr std::int32_t N = 10000;
+
+	zenkit::DaedalusVm vm {make_synthetic_script()};
+	vm.register_external("TWICE", [](std::int32_t v) { return v * 2; });
+	vm.register_external("INTTOSTRING", [](std::int32_t v) { return std::to_string(v); });
+	vm.register_external("CONCATSTRINGS", [](std::string_view a, std::string_view b) {
+		return std::string {a} + std::string {b};
+	});
+
+	auto arithmetic = [&] { (void) vm.call_function<std::int32_t>("ARITHMETIC", N); };
+	bench("interpreter (per instruction)", count_instructions(vm, arithmetic), arithmetic);
+
+	bench("external (per call)", N, [&] { vm.call_function<void>("EXTERNALS", N); });
+	bench("strings (per iteration)", N, [&] { vm.call_function<void>("STRINGS", N); });
+
+	auto const* identity = vm.find_symbol_by_name("IDENTITY");
+	bench("call_function (per call)", N, [&] {
+		for (auto i = 0; i < N; ++i) {
+			(void) vm.call_function<std::int32_t>(identity, i);
+		}
+	});
+}
+
+static void bench_script(char const* path) {
+	auto rd = zenkit::Read::from(path);
+	if (rd == nullptr) {
+		std::cerr << "Failed to open " << path << "\n";
+		return;
+	}
+
+	bench("load", 1, [&] {
+		rd->seek(0, zenkit::Whence::BEG);
+		zenkit::DaedalusScript script;
+		script.load(rd.get());
+	});
+
+	rd->seek(0, zenkit::Whence::BEG);
+	zenkit::DaedalusScript script;
+	script.load(rd.get());
+
+	std::vector<std::string> names;
+	for (auto const& sym : script.symbols()) {
+		names.push_back(sym.name());
+	}
+
+	bench("find_symbol_by_name", names.size(), [&] {
+		for (auto const& name : names) {
+			(void) script.find_symbol_by_name(name);
+		}
+	});
+
+	zenkit::DaedalusVm vm {std::move(script)};
+	zenkit::register_all_script_classes(vm);
+	vm.register_default_external([](zenkit::DaedalusSymbol const&) {});
+
+	std::vector<zenkit::DaedalusSymbol*> items;
+	vm.enumerate_instances_by_class_name("C_ITEM", [&](zenkit::DaedalusSymbol& sym) { items.push_back(&sym); });
+
+	std::vector<zenkit::DaedalusSymbol*> npcs;
+	vm.enumerate_instances_by_class_name("C_NPC", [&](zenkit::DaedalusSymbol& sym) { npcs.push_back(&sym); });
+
+	if (!items.empty()) {
+		bench("init_instances C_ITEM (per item)", items.size(), [&] { vm.init_instances<zenkit::IItem>(items); });
+	}
+
+	if (!npcs.empty()) {
+		bench("init_instances C_NPC (per npc)", npcs.size(), [&] { vm.init_instances<zenkit::INpc>(npcs); });
+	}
+}
+
+int main(int argc, char const** argv) {
+	if (argc > 2 || (argc == 2 && std::string_view {argv[1]} == "-h")) {
+		print_usage();
+		return argc > 2 ? 1 : 0;
+	}
+
+	zenkit::Logger::set_default(zenkit::LogLevel::ERROR);
+
+	bench_synthetic();
+	if (argc == 2) bench_script(argv[1]);
+	return 0;
+}
@@ -0,0 +1,209 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/DaedalusScript.hh>
+#include <zenkit/Logger.hh>
+#include <zenkit/Stream.hh>
+
+#include <cstdio>
+#include <iostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+void print_usage() {
+	std::cerr << "Usage: daedalus2cpp INPUT [FUNCTION...]\n\n"
+	          << "Translates Daedalus functions into C++ code to be registered with\n"
+	          << "zenkit::DaedalusVm::register_compiled_function. The code is written to stdout and\n"
+	          << "defines `void register_compiled_functions(zenkit::DaedalusVm&)`.\n\n"
+	          << "If no functions are given, all functions of the script are translated.\n";
+}
+
+/// \brief Writes the given symbol name as a C++ string literal.
+static std::string quote(std::string const& name) {
+	std::string out = "\"";
+	for (unsigned char c : name) {
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += static_cast<char>(c);
+		} else if (c < 0x20 || c >= 0x7F) {
+			char buf[5];
+			std::snprintf(buf, sizeof buf, "\\%03o", c);
+			out += buf;
+		} else {
+			out += static_cast<char>(c);
+		}
+	}
+	return out + "\"";
+}
+
+/// \return An expression computing the given binary operator on `a` and `b` as popped off the stack.
+static char const* binary_operator(zenkit::DaedalusOpcode op) {
+	using zenkit::DaedalusOpcode;
+
+	switch (op) {
+	case DaedalusOpcode::ADD:
+		return "a + b";
+	case DaedalusOpcode::SUB:
+		return "a - b";
+	case DaedalusOpcode::MUL:
+		return "a * b";
+	case DaedalusOpcode::OR:
+		return "a | b";
+	case DaedalusOpcode::ANDB:
+		return "a & b";
+	case DaedalusOpcode::LT:
+		return "a < b";
+	case DaedalusOpcode::GT:
+		return "a > b";
+	case DaedalusOpcode::LSL:
+		return "a << b";
+	case DaedalusOpcode::LSR:
+		return "a >> b";
+	case DaedalusOpcode::LTE:
+		return "a <= b";
+	case DaedalusOpcode::EQ:
+		return "a == b";
+	case DaedalusOpcode::NEQ:
+		return "a != b";
+	case DaedalusOpcode::GTE:
+		return "a >= b";
+	case DaedalusOpcode::ORR:
+		return "a || b";
+	case DaedalusOpcode::AND:
+		return "a && b";
+	default:
+		return nullptr;
+	}
+}
+
+/// \return An expression computing the given unary operator on `a` as popped off the stack.
+static char const* unary_operator(zenkit::DaedalusOpcode op) {
+	using zenkit::DaedalusOpcode;
+
+	switch (op) {
+	case DaedalusOpcode::PLUS:
+		return "+a";
+	case DaedalusOpcode::NEGATE:
+		return "-a";
+	case DaedalusOpcode::NOT:
+		return "!a";
+	case DaedalusOpcode::CMPL:
+		return "~a";
+	default:
+		return nullptr;
+	}
+}
+
+/// \brief Emits the body of the given function.
+///
+/// Arithmetic, constants and control flow are translated directly. All other instructions deal with symbols,
+/// instances or externals and are handed back to the VM using `unsafe_exec`, which executes them exactly like the
+/// interpreter does.
+static void emit_function(zenkit::DaedalusScript const& script,
+                          zenkit::DaedalusSymbol const& sym,
+                          std::vector<std::uint32_t> const& code) {
+	using zenkit::DaedalusOpcode;
+
+	std::set<std::uint32_t> targets;
+	for (auto address : code) {
+		auto instr = script.instruction_at(address);
+		if (instr.op == DaedalusOpcode::B || instr.op == DaedalusOpcode::BZ) targets.insert(instr.address);
+	}
+
+	std::cout << "\t// " << sym.name() << "\n"
+	          << "\tvoid fn_" << sym.index() << "(zenkit::DaedalusVm& vm) {\n"
+	          << "\t\t[[maybe_unused]] std::int32_t a, b;\n";
+
+	for (auto address : code) {
+		auto instr = script.instruction_at(address);
+
+		if (targets.count(address) != 0) std::cout << "\tL" << address << ":\n";
+
+		if (auto* expr = binary_operator(instr.op)) {
+			std::cout << "\t\ta = vm.pop_int();\n\t\tb = vm.pop_int();\n\t\tvm.push_int(" << expr << ");\n";
+		} else if (auto* unary = unary_operator(instr.op)) {
+			std::cout << "\t\ta = vm.pop_int();\n\t\tvm.push_int(" << unary << ");\n";
+		} else if (instr.op == DaedalusOpcode::PUSHI) {
+			std::cout << "\t\tvm.push_int(" << instr.immediate << ");\n";
+		} else if (instr.op == DaedalusOpcode::B) {
+			std::cout << "\t\tgoto L" << instr.address << ";\n";
+		} else if (instr.op == DaedalusOpcode::BZ) {
+			std::cout << "\t\tif (vm.pop_int() == 0) goto L" << instr.address << ";\n";
+		} else if (instr.op == DaedalusOpcode::RSR) {
+			std::cout << "\t\treturn;\n";
+		} else if (instr.op != DaedalusOpcode::NOP) {
+			std::cout << "\t\tvm.unsafe_exec(" << address << ");\n";
+		}
+	}
+
+	std::cout << "\t}\n\n";
+}
+
+int main(int argc, char const** argv) {
+	if (argc < 2 || std::string_view {argv[1]} == "-h") {
+		print_usage();
+		return argc < 2 ? 1 : 0;
+	}
+
+	zenkit::Logger::set_default(zenkit::LogLevel::WARNING);
+
+	zenkit::DaedalusScript script;
+	auto rd = zenkit::Read::from(argv[1]);
+	if (rd == nullptr) {
+		std::cerr << "Failed to open " << argv[1] << "\n";
+		return 1;
+	}
+	script.load(rd.get());
+
+	std::vector<zenkit::DaedalusSymbol const*> functions;
+	if (argc == 2) {
+		for (auto const& sym : script.symbols()) {
+			if (sym.type() == zenkit::DaedalusDataType::FUNCTION && sym.is_const() && !sym.is_member() &&
+			    !sym.is_external()) {
+				functions.push_back(&sym);
+			}
+		}
+	} else {
+		for (auto i = 2; i < argc; ++i) {
+			auto const* sym = script.find_symbol_by_name(argv[i]);
+			if (sym == nullptr || sym->type() != zenkit::DaedalusDataType::FUNCTION || sym->is_external()) {
+				std::cerr << "Skipping " << argv[i] << ": not a script function\n";
+				continue;
+			}
+
+			functions.push_back(sym);
+		}
+	}
+
+	std::cout << "// Generated by daedalus2cpp from " << argv[1] << ". Do not edit.\n"
+	          << "#include <zenkit/DaedalusVm.hh>\n\n"
+	          << "namespace {\n";
+
+	std::vector<zenkit::DaedalusSymbol const*> emitted;
+	for (auto const* sym : functions) {
+		auto code = script.find_function_code(*sym);
+		if (code.empty()) {
+			// The interpreter can still execute these, so they are simply left out.
+			std::cerr << "Skipping " << sym->name() << ": its code cannot be followed\n";
+			continue;
+		}
+
+		emit_function(script, *sym, code);
+		emitted.push_back(sym);
+	}
+
+	std::cout << "} // namespace\n\n"
+	          << "void register_compiled_functions(zenkit::DaedalusVm& vm) {\n";
+
+	for (auto const* sym : emitted) {
+		char checksum[16];
+		std::snprintf(checksum, sizeof checksum, "0x%08Xu", script.function_checksum(*sym));
+
+		std::cout << "\tvm.register_compiled_function(" << quote(sym->name()) << ", " << checksum << ", fn_"
+		          << sym->index() << ");\n";
+	}
+
+	std::cout << "}\n";
+	return 0;
+}
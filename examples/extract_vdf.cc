@@ -1,36 +1,45 @@
 // Copyright © 2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 
+#include <zenkit/Executor.hh>
 #include <zenkit/Vfs.hh>
 #include <zenkit/Stream.hh>
 
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 
-static void extract_tree(zenkit::VfsNode const& node,
+static std::mutex outputLock;
+
+/// \brief Creates the directories of the tree and collects its files together with the path to write them to.
+static void collect_tree(zenkit::VfsNode const& node,
                          fs::path const& outputRoot,
+                         std::vector<std::pair<zenkit::VfsNode const*, fs::path>>& files,
                          fs::path const& relativePath = fs::path()) {
     if (node.type() == zenkit::VfsNodeType::DIRECTORY) {
         auto dirPath = outputRoot / relativePath / node.name();
         std::error_code ec;
         fs::create_directories(dirPath, ec);
         for (auto const& child : node.children()) {
-            extract_tree(child, outputRoot, relativePath / node.name());
+            collect_tree(child, outputRoot, files, relativePath / node.name());
         }
         return;
     }
 
-    auto filePath = outputRoot / relativePath / node.name();
-    std::error_code ec;
-    fs::create_directories(filePath.parent_path(), ec);
+    files.emplace_back(&node, outputRoot / relativePath / node.name());
+}
 
+static void extract_file(zenkit::VfsNode const& node, fs::path const& filePath) {
     auto reader = node.open_read();
     std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
     if (!out) {
+        std::lock_guard guard {outputLock};
         std::cerr << "Failed to open output file: " << filePath << "\n";
         return;
     }
@@ -44,8 +53,21 @@ static void extract_tree(zenkit::VfsNode const& node,
 }
 
 int main(int argc, char** argv) {
+    std::size_t jobs = 1;
+    if (argc == 4 && std::string_view {argv[1]} == "-j") {
+        try {
+            jobs = std::stoul(argv[2]);
+        } catch (std::exception const&) {
+            argc = 0;
+        }
+
+        argv += 2;
+        argc -= 2;
+    }
+
     if (argc != 2) {
-        std::cerr << "Usage: extract_vdf <path/to/archive.vdf>\n";
+        std::cerr << "Usage: extract_vdf [-j JOBS] <path/to/archive.vdf>\n\n"
+                  << "Writes up to JOBS files at once, 0 for one per CPU (default: 1).\n";
         return 1;
     }
 
@@ -62,9 +84,25 @@ int main(int argc, char** argv) {
     try {
         zenkit::Vfs vfs;
         vfs.mount_disk(vdfPath);
+
+        std::vector<std::pair<zenkit::VfsNode const*, fs::path>> files;
         for (auto const& child : vfs.root().children()) {
-            extract_tree(child, outRoot);
+            collect_tree(child, outRoot, files);
+        }
+
+        // The directories exist now, so the files can be written in any order.
+        std::unique_ptr<zenkit::ThreadPool> pool;
+        if (jobs != 1) {
+            pool = std::make_unique<zenkit::ThreadPool>(jobs == 0 ? 0 : jobs - 1);
+            zenkit::set_executor(pool.get());
         }
+
+        zenkit::parallel_for(
+            files.size(),
+            [&files](std::size_t i) { extract_file(*files[i].first, files[i].second); },
+            jobs);
+
+        zenkit::set_executor(nullptr);
         std::cout << "Extracted to: " << outRoot << "\n";
         return 0;
     } catch (std::exception const& ex) {
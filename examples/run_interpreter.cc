@@ -6,10 +6,20 @@
 #include <zenkit/addon/daedalus.hh>
 
 #include <iostream>
+#include <string_view>
 
 int main(int argc, char** argv) {
+	// Passing `--profile OUTPUT` records which script functions were executed and writes them to OUTPUT as folded
+	// call stacks, which can be turned into a flame graph using tools like `flamegraph.pl` or speedscope.
+	char const* profile_path = nullptr;
+	if (argc == 4 && std::string_view {argv[1]} == "--profile") {
+		profile_path = argv[2];
+		argv += 2;
+		argc -= 2;
+	}
+
 	if (argc != 2) {
-		std::cerr << "Please provide a path to GOTHIC.DAT.";
+		std::cerr << "Usage: run_interpreter [--profile OUTPUT] GOTHIC.DAT\n";
 		return -1;
 	}
 
@@ -28,6 +38,9 @@ int main(int argc, char** argv) {
 	// Generally, registering class definitions is required for scripts to work correctly.
 	zenkit::register_all_script_classes(vm);
 
+	// The profiler is opt-in, since counting instructions makes the interpreter a little slower.
+	if (profile_path != nullptr) vm.set_profiling(true);
+
 	// Register a catch-all callback for all calls to un-registered external functions. ZenKit will handle all required
 	// internal VM state as required so as to not corrupt the stack.
 	//
@@ -92,5 +105,13 @@ int main(int argc, char** argv) {
 
 	std::cout << "\nCalling B_GIVEINVITEMS(NONE_100_XARDAS, PC_HERO, " << gold->symbol_index()
 	          << ", 1) resulted in return of " << ret << "\n";
+
+	if (auto const* profile = vm.profile()) {
+		auto w = zenkit::Write::to(std::filesystem::path {profile_path});
+		profile->save_folded(w.get(), vm, zenkit::DaedalusProfileWeight::INSTRUCTIONS);
+		std::cout << "Executed " << profile->instructions << " instructions, profile written to " << profile_path
+		          << "\n";
+	}
+
 	return 0;
 }
@@ -106,6 +106,14 @@ async function testWorld() {
             console.log(`     - Normals: ${normalsTyped ? 'Float32Array' : 'null'} (${normalsTyped ? normalsTyped.length / 3 : 0} normals)`);
             console.log(`     - UVs: ${uvsTyped ? 'Float32Array' : 'null'} (${uvsTyped ? uvsTyped.length / 2 : 0} coords)`);
             console.log(`     - Indices: ${indicesTyped ? 'Uint32Array' : 'null'} (${indicesTyped ? indicesTyped.length : 0} indices)`);
+
+            // Interleaved buffers grouped by material, ready to be uploaded as is
+            const renderBuffers = world.getRenderBuffers(false);
+            console.log('   • Render buffers (world.getRenderBuffers):');
+            console.log(`     - Buffer: ${renderBuffers.buffer.byteLength} bytes`);
+            console.log(`     - Vertices: ${renderBuffers.vertexCount} (${renderBuffers.vertexStride} bytes each)`);
+            console.log(`     - Indices: ${renderBuffers.indexCount} (${renderBuffers.indexFormat})`);
+            console.log(`     - Batches: ${renderBuffers.batches.length}`);
             console.log();
 
             // Test mesh data safety improvements
@@ -153,6 +161,7 @@ async function testWorld() {
             console.log('   ✅ Safe count access: mesh.vertexCount, mesh.featureCount');
             console.log('   ✅ Fixed bounding box: mesh.boundingBoxMin/Max work properly');
             console.log('   ✅ Performance: getVerticesTypedArray() for direct WebGL use');
+            console.log('   ✅ Performance: getRenderBuffers() for interleaved, per-material GPU buffers');
             console.log('   ✅ Safety: Bounds checking prevents WASM crashes');
             console.log('   ✅ Property access: Clean API with properties instead of functions');
             console.log('   ✅ Automatic memory management: No malloc/free needed!');
@@ -3,25 +3,65 @@
 #include "zenkit/vobs/Camera.hh"
 
 #include <zenkit/Archive.hh>
+#include <zenkit/Executor.hh>
 #include <zenkit/SaveGame.hh>
 #include <zenkit/World.hh>
 #include <zenkit/Logger.hh>
 
+#include <atomic>
+#include <cctype>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <string>
+
+namespace fs = std::filesystem;
 
 void print_usage() {
-	std::cerr << "Usage: zen2zen [-f FORMAT] [-i VERSION_INPUT] [-o VERSION_OUTPUT] INPUT OUTPUT\n\n"
+	std::cerr << "Usage: zen2zen [-f FORMAT] [-i VERSION_INPUT] [-o VERSION_OUTPUT] [-j JOBS] INPUT OUTPUT\n"
+	    << "       zen2zen [-f FORMAT] [-i VERSION_INPUT] [-o VERSION_OUTPUT] [-j JOBS] INPUT... DIRECTORY\n\n"
 	    << "Converts ZenGin archives from and to different formats.\n\n"
+	    << "If more than one input is given or an input is a directory, the archives are written to DIRECTORY.\n"
+	    << "Directories are searched for *.ZEN files recursively and their structure is kept.\n\n"
 	    << "Options:\n"
 	    << "\t-f FORMAT                      \t\tSet the output file format (default: ascii)\n"
 	    << "\t-i,--version-in VERSION_INPUT  \t\tSet the game version the archive is from (default: gothic1)\n"
-	    << "\t-o,--version-out VERSION_OUTPUT\t\tSet the game version the archive should be converted to (default: gothic1)\n\n"
+	    << "\t-o,--version-out VERSION_OUTPUT\t\tSet the game version the archive should be converted to (default: gothic1)\n"
+	    << "\t-j,--jobs JOBS                 \t\tConvert up to JOBS archives at once, 0 for one per CPU (default: 1)\n\n"
 	    << "Possible values:\n"
 	    << "\tFORMAT        \t\tascii, binary, binsafe\n"
 	    << "\tVERSION_INPUT \t\t1, g1, gothic1, 2, g2, gothic2\n"
 	    << "\tVERSION_OUTPUT\t\t1, g1, gothic1, 2, g2, gothic2\n";
 }
 
+static void convert(fs::path const& input,
+                    fs::path const& output,
+                    zenkit::ArchiveFormat fmt,
+                    zenkit::GameVersion ver_input,
+                    zenkit::GameVersion ver_output) {
+	auto a_in = zenkit::Read::from(input);
+	auto a_ar = zenkit::ReadArchive::from(a_in.get());
+
+	auto a_out = zenkit::Write::to(output);
+	auto a_ar_o = zenkit::WriteArchive::to(a_out.get(), fmt);
+
+	// Without a version change, the archive can be piped through entry by entry without loading any objects.
+	// That does not work for binary archives, since they don't store the types of their entries.
+	if (ver_input == ver_output && a_ar->get_header().format != zenkit::ArchiveFormat::BINARY) {
+		a_ar->transcode(*a_ar_o);
+		return;
+	}
+
+	auto a = a_ar->read_object(ver_input);
+	a_ar_o->write_object(a, ver_output);
+}
+
+static bool is_zen(fs::path const& path) {
+	auto ext = path.extension().string();
+	for (auto& c : ext) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+	return ext == ".ZEN";
+}
+
 
 int main(int argc, char const** argv) {
 	if (argc < 3) {
@@ -34,13 +74,10 @@ int main(int argc, char const** argv) {
 	auto fmt = zenkit::ArchiveFormat::ASCII;
 	auto ver_input = zenkit::GameVersion::GOTHIC_1;
 	auto ver_output = zenkit::GameVersion::GOTHIC_1;
+	std::size_t jobs = 1;
 
 	for (int i = 1; i < argc; i++) {
 		if (argv[i][0] != '-') {
-			if (positional.size() >= 2) {
-				std::cerr << "Expected only two positionals, ignoring '" << argv[i] << "'\n";
-				continue;
-			}
 			positional.push_back(argv[i]);
 			continue;
 		}
@@ -79,24 +116,87 @@ int main(int argc, char const** argv) {
 				std::cerr << "Expected one of '1', 'g1' or 'gothic1' (default) or '2', 'g2' or 'gothic2' as an output version\n";
 				return 1;
 			}
+		} else if (name == "-j" || name == "--jobs") {
+			try {
+				jobs = std::stoul(std::string {arg});
+			} catch (std::exception const&) {
+				std::cerr << "Expected a number of jobs\n";
+				return 1;
+			}
 		} else {
 			std::cerr << "Unknown option: " << name << "\n";
 			return 1;
 		}
 	}
 
+	if (positional.size() < 2) {
+		print_usage();
+		return 1;
+	}
+
+	fs::path output = positional.back();
+	positional.pop_back();
+
+	if (positional.size() == 1 && !fs::is_directory(positional[0])) {
+		try {
+			convert(positional[0], output, fmt, ver_input, ver_output);
+		} catch (const std::exception& e) {
+			std::cerr << "Error during conversion: " << e.what() << "\n";
+			return -1;
+		}
+
+		return 0;
+	}
+
+	// Collect the archives to convert together with the path to write each of them to.
+	std::vector<std::pair<fs::path, fs::path>> files;
 	try {
-		auto a_in = zenkit::Read::from(positional[0]);
-		auto a_ar = zenkit::ReadArchive::from(a_in.get());
-		auto a = a_ar->read_object(ver_input);
+		for (fs::path input : positional) {
+			if (!fs::is_directory(input)) {
+				files.emplace_back(input, output / input.filename());
+				continue;
+			}
+
+			for (auto const& entry : fs::recursive_directory_iterator {input}) {
+				if (!entry.is_regular_file() || !is_zen(entry.path())) continue;
+				files.emplace_back(entry.path(), output / fs::relative(entry.path(), input));
+			}
+		}
 
-		auto a_out = zenkit::Write::to(positional[1]);
-		auto a_ar_o = zenkit::WriteArchive::to(a_out.get(), fmt);
-		a_ar_o->write_object(a, ver_output);
+		for (auto const& [in, out] : files) {
+			fs::create_directories(out.parent_path());
+		}
 	} catch (const std::exception& e) {
-		std::cerr << "Error during conversion: " << e.what() << "\n";
+		std::cerr << "Error while collecting archives: " << e.what() << "\n";
 		return -1;
 	}
 
-    return 0;
+	// Each archive is converted on its own, so they can all be converted at the same time.
+	std::unique_ptr<zenkit::ThreadPool> pool;
+	if (jobs != 1) {
+		pool = std::make_unique<zenkit::ThreadPool>(jobs == 0 ? 0 : jobs - 1);
+		zenkit::set_executor(pool.get());
+	}
+
+	std::mutex output_lock;
+	std::atomic_size_t failed {0};
+
+	zenkit::parallel_for(
+	    files.size(),
+	    [&](std::size_t i) {
+		    auto const& [in, out] = files[i];
+
+		    try {
+			    convert(in, out, fmt, ver_input, ver_output);
+		    } catch (const std::exception& e) {
+			    std::lock_guard guard {output_lock};
+			    std::cerr << "Error during conversion of " << in << ": " << e.what() << "\n";
+			    ++failed;
+		    }
+	    },
+	    jobs);
+
+	zenkit::set_executor(nullptr);
+	std::cout << "Converted " << files.size() - failed << " of " << files.size() << " archives\n";
+	return failed == 0 ? 0 : -1;
 }
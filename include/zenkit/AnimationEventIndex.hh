@@ -0,0 +1,171 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace zenkit {
+	/// \brief A view of the animation events which fire in a range of frames, ordered by frame.
+	///
+	/// <p>The view does not own the events. It is only valid as long as the event list it was created from is
+	/// alive and not modified.</p>
+	///
+	/// \tparam T The type of event. Must have a `frame` member.
+	/// \see AnimationEventIndex
+	template <typename T>
+	class AnimationEventRange {
+	public:
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T const*;
+			using reference = T const&;
+
+			Iterator() = default;
+			Iterator(T const* events, std::uint32_t const* order, std::size_t position)
+			    : _m_events(events), _m_order(order), _m_position(position) {}
+
+			reference operator*() const noexcept {
+				return _m_events[_m_order != nullptr ? _m_order[_m_position] : _m_position];
+			}
+
+			pointer operator->() const noexcept {
+				return &**this;
+			}
+
+			Iterator& operator++() noexcept {
+				++_m_position;
+				return *this;
+			}
+
+			Iterator operator++(int) noexcept {
+				auto copy = *this;
+				++_m_position;
+				return copy;
+			}
+
+			bool operator==(Iterator const& other) const noexcept {
+				return _m_position == other._m_position;
+			}
+
+			bool operator!=(Iterator const& other) const noexcept {
+				return _m_position != other._m_position;
+			}
+
+		private:
+			T const* _m_events {nullptr};
+			std::uint32_t const* _m_order {nullptr};
+			std::size_t _m_position {0};
+		};
+
+		AnimationEventRange() = default;
+		AnimationEventRange(T const* events, std::uint32_t const* order, std::size_t begin, std::size_t end)
+		    : _m_events(events), _m_order(order), _m_begin(begin), _m_end(end) {}
+
+		[[nodiscard]] Iterator begin() const noexcept {
+			return {_m_events, _m_order, _m_begin};
+		}
+
+		[[nodiscard]] Iterator end() const noexcept {
+			return {_m_events, _m_order, _m_end};
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return _m_end - _m_begin;
+		}
+
+		[[nodiscard]] bool empty() const noexcept {
+			return _m_end == _m_begin;
+		}
+
+		[[nodiscard]] T const& operator[](std::size_t i) const noexcept {
+			return *Iterator {_m_events, _m_order, _m_begin + i};
+		}
+
+	private:
+		T const* _m_events {nullptr};
+		std::uint32_t const* _m_order {nullptr};
+		std::size_t _m_begin {0};
+		std::size_t _m_end {0};
+	};
+
+	/// \brief An index of a list of animation events, sorted by the frame they fire in.
+	///
+	/// <p>The index lets animation players find the events which fire between two frames using a binary search
+	/// instead of scanning all events. Events are usually stored in order already, in which case the index is
+	/// empty and the event list is searched directly. Otherwise, it stores the order of the events, which keeps
+	/// events firing in the same frame in the order they are listed in.</p>
+	///
+	/// <p>The index refers to events by their position in the list, so it stays valid if the list is copied or
+	/// moved along with it. It must be rebuilt whenever the list is modified.</p>
+	///
+	/// \tparam T The type of event. Must have a `frame` member.
+	template <typename T>
+	class AnimationEventIndex {
+	public:
+		/// \brief Builds the index of the given list of events.
+		/// \param events The events to index.
+		void build(std::vector<T> const& events) {
+			_m_order.clear();
+
+			auto by_frame = [](T const& a, T const& b) {
+				return a.frame < b.frame;
+			};
+
+			if (std::is_sorted(events.begin(), events.end(), by_frame)) return;
+
+			_m_order.resize(events.size());
+			std::iota(_m_order.begin(), _m_order.end(), 0u);
+			std::stable_sort(_m_order.begin(), _m_order.end(), [&events](std::uint32_t a, std::uint32_t b) {
+				return events[a].frame < events[b].frame;
+			});
+		}
+
+		/// \brief Finds all events which fire after frame \p a up to and including frame \p b.
+		///
+		/// <p>The range `(a, b]` matches the frames passed when advancing an animation from frame \p a to frame
+		/// \p b. To include events in the first frame of an animation, pass `-1` for \p a. Looping animations
+		/// have to be queried in two parts when they wrap around. Nothing is allocated.</p>
+		///
+		/// \param events The events this index was built from.
+		/// \param a The frame before the first frame to include.
+		/// \param b The last frame to include.
+		/// \return The events in the range, ordered by frame. Empty if \p b is not greater than \p a or if the
+		///         index is out of date.
+		[[nodiscard]] AnimationEventRange<T>
+		query(std::vector<T> const& events, std::int64_t a, std::int64_t b) const noexcept {
+			if (b <= a || events.empty()) return {};
+			if (!_m_order.empty() && _m_order.size() != events.size()) return {};
+
+			auto order = _m_order.empty() ? nullptr : _m_order.data();
+			auto frame_at = [&](std::size_t i) {
+				return static_cast<std::int64_t>(events[order != nullptr ? order[i] : i].frame);
+			};
+
+			// Finds the first event firing after the given frame.
+			auto upper_bound = [&](std::int64_t frame) {
+				std::size_t lo = 0, hi = events.size();
+				while (lo < hi) {
+					auto mid = lo + (hi - lo) / 2;
+					if (frame_at(mid) <= frame) {
+						lo = mid + 1;
+					} else {
+						hi = mid;
+					}
+				}
+				return lo;
+			};
+
+			return {events.data(), order, upper_bound(a), upper_bound(b)};
+		}
+
+	private:
+		std::vector<std::uint32_t> _m_order;
+	};
+} // namespace zenkit
@@ -7,14 +7,35 @@
 #include "zenkit/Object.hh"
 #include "zenkit/Stream.hh"
 
+#include <bitset>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace zenkit {
 	class Read;
 	class ReadArchive;
+	class WriteArchive;
+
+	namespace detail {
+		/// \brief An open-addressing hash map from objects to the archive indices they were written with.
+		class ObjectIndexMap {
+		public:
+			/// \brief Makes room for at least \p n objects without rehashing.
+			ZKINT void reserve(std::size_t n);
+
+			/// \return The index of \p obj or `nullptr` if it was not inserted before.
+			[[nodiscard]] ZKINT std::uint32_t const* find(Object const* obj) const noexcept;
+
+			ZKINT void insert_or_assign(Object const* obj, std::uint32_t index);
+
+		private:
+			std::vector<std::pair<Object const*, std::uint32_t>> _m_slots {};
+			std::size_t _m_size {0};
+		};
+	} // namespace detail
 
 	enum class ArchiveFormat {
 		BINARY = 0,
@@ -91,6 +112,63 @@ namespace zenkit {
 		std::uint32_t index;
 	};
 
+	/// \brief The location of an object in the stream of an archive.
+	/// \see ArchiveIndex
+	struct ArchiveObjectLocation {
+		/// \brief The stream offset of the object's begin, relative to the beginning of the stream.
+		std::uint64_t offset;
+
+		/// \brief The index of the object in the archive.
+		std::uint32_t index;
+
+		/// \brief The name of the sub-object used for storing this object in the ZenGin.
+		std::string object_name;
+
+		/// \brief The original class name of the object in the ZenGin.
+		std::string class_name;
+	};
+
+	/// \brief A side index mapping the objects of an archive to their location in the archive's stream.
+	///
+	/// <p>The index is built while reading (see ReadArchive::set_index) or writing (see WriteArchive::set_index)
+	/// an archive. It can be stored next to the archive using #save and loaded again using #load, so that later
+	/// readers can jump straight to a specific object using ReadArchive::seek_object instead of reading the
+	/// archive front to back.</p>
+	class ZKAPI ArchiveIndex {
+	public:
+		/// \brief Add an object to the index. Objects already present in the index are ignored.
+		/// \param loc The location of the object.
+		void add(ArchiveObjectLocation loc);
+
+		/// \brief Find the location of the object with the given archive index.
+		/// \param index The archive index of the object.
+		/// \return The location of the object or `nullptr` if it is not indexed.
+		[[nodiscard]] ArchiveObjectLocation const* find(std::uint32_t index) const noexcept;
+
+		/// \brief Find the location of the first object with the given object name.
+		/// \param object_name The name of the object, compared case-sensitively.
+		/// \return The location of the object or `nullptr` if it is not indexed.
+		[[nodiscard]] ArchiveObjectLocation const* find(std::string_view object_name) const noexcept;
+
+		/// \return All indexed objects in the order they were added.
+		[[nodiscard]] std::vector<ArchiveObjectLocation> const& objects() const noexcept {
+			return _m_objects;
+		}
+
+		/// \brief Load an index previously stored using #save.
+		/// \param r The stream to read from.
+		/// \throws ParserError if the stream does not contain an archive index.
+		void load(Read* r);
+
+		/// \brief Store the index to the given stream.
+		/// \param w The stream to write to.
+		void save(Write* w) const;
+
+	private:
+		std::vector<ArchiveObjectLocation> _m_objects;
+		std::unordered_map<std::uint32_t, std::size_t> _m_by_index;
+	};
+
 	enum class ArchiveEntryType : uint8_t {
 		STRING = 0x1,
 		INTEGER = 0x2,
@@ -144,6 +222,106 @@ namespace zenkit {
 
 		std::shared_ptr<Object> read_object(GameVersion version);
 
+		/// \brief Set the arena to allocate all objects read from this archive in.
+		/// \param arena The arena to use or `nullptr` to allocate objects on the heap individually.
+		/// \see ObjectArena
+		void set_arena(std::shared_ptr<ObjectArena> arena) noexcept {
+			_m_arena = std::move(arena);
+		}
+
+		/// \return The arena objects read from this archive are allocated in or `nullptr` if there is none.
+		[[nodiscard]] std::shared_ptr<ObjectArena> const& get_arena() const noexcept {
+			return _m_arena;
+		}
+
+		/// \brief Set the pool to intern strings read using #read_string_interned in.
+		/// \param pool The pool to use or `nullptr` to create a new pool on the next call to #read_string_interned.
+		/// \see StringPool
+		void set_string_pool(std::shared_ptr<StringPool> pool) noexcept {
+			_m_strings = std::move(pool);
+		}
+
+		/// \return The pool strings read from this archive are interned in or `nullptr` if there is none yet.
+		[[nodiscard]] std::shared_ptr<StringPool> const& get_string_pool() const noexcept {
+			return _m_strings;
+		}
+
+		/// \brief Reads a string value and interns it in the string pool of the archive.
+		///
+		/// Use this instead of #read_string for values which repeat often, like visual names, to store and compare
+		/// them as handles.
+		///
+		/// \return The handle of the string in #get_string_pool.
+		/// \throws zenkit::ParserError
+		/// \see StringPool
+		std::uint32_t read_string_interned();
+
+		/// \brief Only materialize objects of the given classes when calling #read_object.
+		///
+		/// Objects of any other class are skipped using #skip_object without being allocated and #read_object
+		/// returns `nullptr` for them. References to skipped objects also resolve to `nullptr`.
+		///
+		/// If all of the given classes are VOb classes, only VObs are filtered. The objects they contain, like their
+		/// visual, AI and event manager, are always loaded.
+		///
+		/// \param types The classes of objects to load. Pass an empty list to load all objects again.
+		void set_class_filter(std::vector<ObjectType> const& types);
+
+		/// \return `true` if objects of the given class are loaded by #read_object with the current class filter.
+		[[nodiscard]] bool is_class_loaded(ObjectType type) const noexcept;
+
+		/// \brief Record the location of every object read using #read_object into the given index.
+		///
+		/// <p>The index is also used to resolve references to objects which have not been read yet and to
+		/// find objects for #seek_object.</p>
+		///
+		/// \param index The index to use or `nullptr` to stop recording.
+		void set_index(std::shared_ptr<ArchiveIndex> index) noexcept {
+			_m_index = std::move(index);
+		}
+
+		/// \return The index objects are recorded in or `nullptr` if there is none.
+		[[nodiscard]] std::shared_ptr<ArchiveIndex> const& get_index() const noexcept {
+			return _m_index;
+		}
+
+		/// \brief Release all objects read so far which are kept around to resolve references.
+		///
+		/// <p>Later references to these objects are resolved by reading them again if an index is set using
+		/// #set_index and resolve to `nullptr` otherwise.</p>
+		void clear_object_cache() noexcept {
+			_m_cache.clear();
+			_m_cache_sparse.clear();
+		}
+
+		/// \brief Copy the rest of this archive to the given writer entry by entry.
+		///
+		/// <p>No objects are created while transcoding, so memory usage does not depend on the size of the archive.
+		/// Object indices are re-assigned by the writer and references are rewritten accordingly. The raw mesh and
+		/// BSP-tree data of worlds is copied verbatim. The header of \p w is written once transcoding is done.</p>
+		///
+		/// <p>ASCII archives created by the ZenGin store bytes and words as `int` entries. These are transcoded as
+		/// integers since their actual type is unknown.</p>
+		///
+		/// \param w The writer to copy the archive to.
+		/// \throws ParserError if the format of this archive does not store the types of its entries, which is the
+		///                     case for ArchiveFormat::BINARY.
+		void transcode(WriteArchive& w);
+
+		/// \brief Move the reader to the begin of the object with the given index.
+		///
+		/// <p>The next call to #read_object will read that object. All objects read before remain available to
+		/// resolve references.</p>
+		///
+		/// \param index The archive index of the object to seek to.
+		/// \return `true` if the object was found in the index set using #set_index, `false` if not.
+		bool seek_object(std::uint32_t index);
+
+		/// \return `true` if the last call to #read_object skipped an object because of the class filter.
+		[[nodiscard]] bool last_object_filtered() const noexcept {
+			return _m_last_filtered;
+		}
+
 		/// \brief Tries to read the begin of a new object from the archive.
 		///
 		/// If a beginning of an object could not be read, the internal buffer is reverted to the state
@@ -220,8 +398,29 @@ namespace zenkit {
 		/// \return The matrix.
 		virtual Mat3 read_mat3x3() = 0;
 
+		/// \brief Reads a raw entry of \p size bytes from the reader.
+		///
+		/// <p>Binary and binsafe archives return a Read::slice of their underlying stream. If that stream is backed by
+		/// memory, the returned stream shares this memory instead of owning a copy of the bytes, so it must not be
+		/// used after the archive's stream or its backing memory are gone. Callers which need the bytes for longer
+		/// must copy them out.</p>
+		///
+		/// \param size The number of bytes to read.
+		/// \return A stream over the bytes of the entry.
+		/// \throws zenkit::ParserError if the value actually present is not a raw entry.
 		virtual std::unique_ptr<Read> read_raw(std::size_t size) = 0;
 
+		/// \brief Reads a run of consecutive fixed-size entries as one block of raw bytes.
+		///
+		/// Only formats which store such entries back-to-back without any framing support this. Readers of other
+		/// formats do not consume anything and return `false`, in which case each entry has to be read separately.
+		///
+		/// \param buf The buffer to read into.
+		/// \param size The combined size of the entries in bytes.
+		/// \return `true` if the entries were read into \p buf, `false` otherwise.
+		/// \throws zenkit::ParserError if the archive ends before all entries were read.
+		virtual bool read_packed(std::byte* buf, std::size_t size);
+
 		/// \brief Skips the next object in the reader and all it's children
 		/// \param skip_current If `false` skips the next object in this buffer, otherwise skip the object
 		///                     currently being read.
@@ -251,12 +450,35 @@ namespace zenkit {
 		/// \brief Skips the next entry in the reader.
 		virtual void skip_entry() = 0;
 
+		/// \brief Reads the next entry and writes it to the given writer, keeping its name and type.
+		/// \throws ParserError if the format does not support this.
+		/// \see #transcode
+		virtual void copy_entry(WriteArchive& w);
+
+		/// \return `true` if there are entries left to read in the archive.
+		[[nodiscard]] virtual bool has_entries() const noexcept {
+			return !read->eof();
+		}
+
 		ArchiveHeader header;
 		Read* read;
 
 	private:
-		std::unordered_map<uint32_t, std::shared_ptr<Object>> _m_cache {};
+		ZKINT std::shared_ptr<Object> const* find_cached(uint32_t index) const noexcept;
+		ZKINT void cache(uint32_t index, std::shared_ptr<Object> const& obj);
+
+		// Object indices are dense and increase monotonically, so they are used to index the cache directly. Indices
+		// far beyond the objects read so far are only found in corrupted archives and end up in the sparse cache.
+		std::vector<std::shared_ptr<Object>> _m_cache {};
+		std::unordered_map<uint32_t, std::shared_ptr<Object>> _m_cache_sparse {};
 		std::unique_ptr<Read> _m_owned;
+		std::shared_ptr<ObjectArena> _m_arena;
+		std::shared_ptr<StringPool> _m_strings;
+		std::bitset<static_cast<size_t>(ObjectType::zCCSProps) + 1> _m_filter {};
+		bool _m_filter_enabled = false;
+		bool _m_filter_vobs = false;
+		bool _m_last_filtered = false;
+		std::shared_ptr<ArchiveIndex> _m_index;
 	};
 
 	class ZKAPI WriteArchive {
@@ -299,8 +521,16 @@ namespace zenkit {
 
 		[[nodiscard]] virtual Write* get_stream() const noexcept = 0;
 
+		/// \brief Record the location of every object written using #write_object into the given index.
+		/// \param index The index to use or `nullptr` to stop recording.
+		/// \see ArchiveIndex
+		void set_index(std::shared_ptr<ArchiveIndex> index) noexcept {
+			_m_index = std::move(index);
+		}
+
 	private:
-		std::unordered_map<Object const*, uint32_t> _m_cache {};
+		detail::ObjectIndexMap _m_cache {};
+		std::shared_ptr<ArchiveIndex> _m_index;
 		bool _m_save {false};
 	};
 } // namespace zenkit
@@ -0,0 +1,104 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+namespace zenkit {
+	class VfsNode;
+	class Model;
+	class ModelAnimation;
+	class ModelHierarchy;
+	class ModelMesh;
+	class MorphMesh;
+	class MultiResolutionMesh;
+
+	/// \brief How an AssetCache holds on to the assets it has loaded.
+	enum class AssetCacheOwnership {
+		/// \brief Assets are only kept while they are used elsewhere. Once the last `std::shared_ptr` to an asset
+		///        is gone, it is freed and loaded again on the next request.
+		WEAK,
+
+		/// \brief Assets are kept until AssetCache::clear is called.
+		SHARED,
+	};
+
+	/// \brief A thread-safe cache of loaded assets, keyed by the contents of the files they were loaded from.
+	///
+	/// <p>Assets are identified by the hash of their file's contents (see VfsNode::hash) and size, so identical
+	/// files are only parsed once, even if they have different names or live in different disks. Enable
+	/// Vfs::set_hash_files to avoid hashing the files on every request.</p>
+	///
+	/// <p>The `checksum` stored in model hierarchies, model meshes and animations identifies the hierarchy they
+	/// were made for, not the file itself, so it is not used as a key. Loaded hierarchies can however be looked up
+	/// by their checksum using #find_model_hierarchy.</p>
+	class AssetCache {
+	public:
+		ZKAPI explicit AssetCache(AssetCacheOwnership ownership = AssetCacheOwnership::WEAK);
+
+		/// \return A process-wide cache with AssetCacheOwnership::WEAK ownership.
+		[[nodiscard]] ZKAPI static AssetCache& global();
+
+		/// \brief Returns the cached asset loaded from a file with the same contents as \p node or loads it.
+		/// \param node The file to load the asset from.
+		/// \return The shared asset.
+		/// \throws zenkit::ParserError if the file could not be parsed. Nothing is cached in that case.
+		/// \throws std::bad_variant_access if \p node is a directory.
+		[[nodiscard]] ZKAPI std::shared_ptr<ModelHierarchy const> load_model_hierarchy(VfsNode const& node);
+
+		/// \copydoc load_model_hierarchy
+		[[nodiscard]] ZKAPI std::shared_ptr<ModelMesh const> load_model_mesh(VfsNode const& node);
+
+		/// \copydoc load_model_hierarchy
+		[[nodiscard]] ZKAPI std::shared_ptr<Model const> load_model(VfsNode const& node);
+
+		/// \copydoc load_model_hierarchy
+		[[nodiscard]] ZKAPI std::shared_ptr<ModelAnimation const> load_model_animation(VfsNode const& node);
+
+		/// \copydoc load_model_hierarchy
+		[[nodiscard]] ZKAPI std::shared_ptr<MultiResolutionMesh const> load_multi_resolution_mesh(VfsNode const& node);
+
+		/// \copydoc load_model_hierarchy
+		[[nodiscard]] ZKAPI std::shared_ptr<MorphMesh const> load_morph_mesh(VfsNode const& node);
+
+		/// \brief Finds a cached model hierarchy, including the hierarchies of cached models, by its checksum.
+		/// \param checksum The checksum of the hierarchy, see ModelHierarchy::checksum.
+		/// \return The hierarchy or `nullptr` if no live hierarchy with the given checksum is cached.
+		[[nodiscard]] ZKAPI std::shared_ptr<ModelHierarchy const> find_model_hierarchy(std::uint32_t checksum);
+
+		/// \return The number of cached assets which are still alive.
+		[[nodiscard]] ZKAPI std::size_t size();
+
+		/// \brief Removes all assets from the cache. Assets which are still in use stay alive, but are no longer
+		///        shared with later requests.
+		ZKAPI void clear();
+
+	private:
+		enum class AssetType : std::uint8_t;
+		using Key = std::tuple<AssetType, std::uint64_t, std::size_t>;
+
+		struct Entry {
+			std::weak_ptr<void const> weak;
+			std::shared_ptr<void const> strong;
+		};
+
+		template <typename T>
+		std::shared_ptr<T const> load(VfsNode const& node, AssetType type);
+
+		void index_hierarchy(std::shared_ptr<ModelHierarchy const> const& hierarchy);
+		void prune();
+
+		AssetCacheOwnership _m_ownership;
+
+		std::mutex _m_lock;
+		std::map<Key, Entry> _m_entries;
+		std::unordered_map<std::uint32_t, std::weak_ptr<ModelHierarchy const>> _m_hierarchies;
+		std::size_t _m_prune_at {64};
+	};
+} // namespace zenkit
@@ -0,0 +1,160 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+
+namespace zenkit {
+	class Executor;
+	class Read;
+	class Vfs;
+
+	namespace detail {
+		struct AssetSlot;
+		struct AssetManagerState;
+	} // namespace detail
+
+	/// \brief Options for streaming assets using an AssetManager.
+	struct AssetManagerOptions {
+		/// \brief The amount of memory the cached assets may take up, in bytes.
+		///
+		/// The memory taken up by an asset is estimated using the size of the file it was loaded from. Once the
+		/// budget is exceeded, the least recently requested assets which are not in use are released. Assets which
+		/// are in use are never released, so the budget may be exceeded by them.
+		std::size_t memory_budget {256 * 1024 * 1024};
+
+		/// \brief The maximum number of assets to load at once. Set to `0` to use all threads of the executor.
+		std::uint32_t thread_count {0};
+
+		/// \brief The executor to load assets on or `nullptr` to use the ::get_executor.
+		Executor* executor {nullptr};
+	};
+
+	class AssetManager;
+
+	/// \brief A shared handle to an asset requested from an AssetManager.
+	///
+	/// <p>Handles are cheap to copy. All handles to the same asset refer to the same request and the same loaded
+	/// instance. Assets which could not be found or loaded are `nullptr`.</p>
+	template <typename T>
+	class AssetHandle {
+	public:
+		AssetHandle() = default;
+
+		/// \return `true` if the handle refers to a request.
+		[[nodiscard]] bool valid() const noexcept {
+			return _m_slot != nullptr;
+		}
+
+		/// \return `true` if the asset has been loaded or failed to load.
+		[[nodiscard]] bool ready() const noexcept;
+
+		/// \return The asset or `nullptr` if it is not #ready yet or could not be loaded.
+		[[nodiscard]] std::shared_ptr<T const> get() const;
+
+		/// \brief Waits for the asset to be loaded. If loading has not started yet, the asset is loaded on the
+		///        calling thread instead.
+		/// \return The asset or `nullptr` if it could not be loaded.
+		[[nodiscard]] std::shared_ptr<T const> wait() const;
+
+	private:
+		friend class AssetManager;
+		AssetHandle(std::shared_ptr<detail::AssetSlot> slot, AssetManager* manager)
+		    : _m_slot(std::move(slot)), _m_manager(manager) {}
+
+		std::shared_ptr<detail::AssetSlot> _m_slot;
+		AssetManager* _m_manager {nullptr};
+	};
+
+	/// \brief Streams assets from a Vfs in the background.
+	///
+	/// <p>Assets are requested by name and type, e.g. `request<MultiResolutionMesh>("CHESTBIG.MRM", 10)`, and loaded
+	/// on the Executor, highest priority first. Requesting an asset which is already loaded or still being loaded
+	/// returns a handle to the same request, raising its priority if necessary. Any type with a `load(Read*)`
+	/// function can be requested.</p>
+	///
+	/// <p>Loaded assets stay cached after they are no longer used, until the AssetManagerOptions::memory_budget is
+	/// exceeded and they are released in least recently requested order. Assets which could not be loaded are cached
+	/// as `nullptr` until #clear is called.</p>
+	///
+	/// <p>The manager may be used from multiple threads at once. Its handles must not outlive it.</p>
+	///
+	/// \see AssetCache and ModelLoader for synchronous loading.
+	class AssetManager {
+	public:
+		/// \brief Creates a manager for files from the given Vfs. The Vfs must outlive the manager and may not be
+		///        modified while assets are being loaded.
+		ZKAPI explicit AssetManager(Vfs const& vfs, AssetManagerOptions const& options = {});
+
+		/// \brief Waits for the assets which are being loaded. Assets which were requested, but not started yet,
+		///        are not loaded and become `nullptr`.
+		ZKAPI ~AssetManager() noexcept;
+
+		AssetManager(AssetManager const&) = delete;
+		AssetManager& operator=(AssetManager const&) = delete;
+
+		/// \brief Requests an asset to be loaded in the background.
+		/// \param name The name of the file to load the asset from. It is looked up case-insensitively.
+		/// \param priority The priority of the request. Requests with a higher priority are loaded first.
+		/// \return A handle to the asset.
+		template <typename T>
+		[[nodiscard]] AssetHandle<T> request(std::string_view name, std::int32_t priority = 0) {
+			return AssetHandle<T> {this->request(name, priority, typeid(T), &load_asset<T>), this};
+		}
+
+		/// \return The number of cached assets, including those still being loaded.
+		[[nodiscard]] ZKAPI std::size_t size() const;
+
+		/// \return The memory taken up by all loaded assets, estimated as for AssetManagerOptions::memory_budget.
+		[[nodiscard]] ZKAPI std::size_t memory_used() const;
+
+		/// \brief Releases all loaded assets which are not in use. Requests which are still pending are kept.
+		ZKAPI void clear();
+
+	private:
+		template <typename>
+		friend class AssetHandle;
+
+		using LoadFn = std::shared_ptr<void const> (*)(Read*);
+
+		template <typename T>
+		static std::shared_ptr<void const> load_asset(Read* r) {
+			auto asset = std::make_shared<T>();
+			asset->load(r);
+			return asset;
+		}
+
+		ZKAPI std::shared_ptr<detail::AssetSlot>
+		request(std::string_view name, std::int32_t priority, std::type_index type, LoadFn load);
+
+		[[nodiscard]] ZKAPI static bool ready(detail::AssetSlot const& slot) noexcept;
+		[[nodiscard]] ZKAPI static std::shared_ptr<void const> get(detail::AssetSlot const& slot);
+		[[nodiscard]] ZKAPI std::shared_ptr<void const> wait(std::shared_ptr<detail::AssetSlot> const& slot);
+
+		std::shared_ptr<detail::AssetManagerState> _m_state;
+	};
+
+	template <typename T>
+	bool AssetHandle<T>::ready() const noexcept {
+		return _m_slot != nullptr && AssetManager::ready(*_m_slot);
+	}
+
+	template <typename T>
+	std::shared_ptr<T const> AssetHandle<T>::get() const {
+		if (_m_slot == nullptr) return nullptr;
+		return std::static_pointer_cast<T const>(AssetManager::get(*_m_slot));
+	}
+
+	template <typename T>
+	std::shared_ptr<T const> AssetHandle<T>::wait() const {
+		if (_m_slot == nullptr) return nullptr;
+		return std::static_pointer_cast<T const>(_m_manager->wait(_m_slot));
+	}
+} // namespace zenkit
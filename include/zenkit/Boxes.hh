@@ -4,6 +4,11 @@
 #include "zenkit/Library.hh"
 #include "zenkit/Misc.hh"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <vector>
 
 namespace zenkit {
@@ -24,6 +29,83 @@ namespace zenkit {
 
 		ZKAPI void load(Read* r);
 		ZKAPI void save(Write* w) const;
+
+		/// \return `true` if \p point is inside the box or on its surface.
+		[[nodiscard]] constexpr bool contains(Vec3 const& point) const noexcept {
+			return min.x <= point.x && point.x <= max.x && min.y <= point.y && point.y <= max.y && min.z <= point.z &&
+			    point.z <= max.z;
+		}
+
+		/// \return `true` if the box overlaps or touches \p other.
+		[[nodiscard]] constexpr bool intersects(AxisAlignedBoundingBox const& other) const noexcept {
+			return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y &&
+			    min.z <= other.max.z && other.min.z <= max.z;
+		}
+	};
+
+	/// \brief Computes the smallest box containing all of the given boxes.
+	/// \param boxes The boxes to merge.
+	/// \param count The number of boxes.
+	/// \return The merged box or AxisAlignedBoundingBox::zero if \p count is `0`.
+	[[nodiscard]] ZKAPI AxisAlignedBoundingBox merge_bounding_boxes(AxisAlignedBoundingBox const* boxes,
+	                                                                std::size_t count) noexcept;
+
+	/// \brief Transforms boxes by an affine matrix and computes the axis-aligned boxes containing the results.
+	///
+	/// <p>The columns of \p transform are stored in Mat4::columns. Its last row is ignored.</p>
+	///
+	/// \param transform The matrix to transform the boxes by.
+	/// \param boxes The boxes to transform.
+	/// \param out Receives the transformed boxes. May be the same as \p boxes.
+	/// \param count The number of boxes.
+	ZKAPI void transform_bounding_boxes(Mat4 const& transform,
+	                                    AxisAlignedBoundingBox const* boxes,
+	                                    AxisAlignedBoundingBox* out,
+	                                    std::size_t count) noexcept;
+
+	/// \brief Finds all boxes which overlap or touch the given box.
+	/// \param box The box to test against.
+	/// \param boxes The boxes to test.
+	/// \param count The number of boxes.
+	/// \param hits Receives the indices of all intersecting boxes in ascending order. It is cleared first.
+	/// \see AxisAlignedBoundingBox::intersects
+	ZKAPI void find_intersecting_boxes(AxisAlignedBoundingBox const& box,
+	                                   AxisAlignedBoundingBox const* boxes,
+	                                   std::size_t count,
+	                                   std::vector<std::uint32_t>& hits);
+
+	/// \brief Finds all boxes which contain the given point.
+	/// \param point The point to test.
+	/// \param boxes The boxes to test.
+	/// \param count The number of boxes.
+	/// \param hits Receives the indices of all boxes containing \p point in ascending order. It is cleared first.
+	/// \see AxisAlignedBoundingBox::contains
+	ZKAPI void find_boxes_containing(Vec3 const& point,
+	                                 AxisAlignedBoundingBox const* boxes,
+	                                 std::size_t count,
+	                                 std::vector<std::uint32_t>& hits);
+
+	/// \brief Finds all points inside the given box.
+	/// \param box The box to test against.
+	/// \param points The points to test.
+	/// \param count The number of points.
+	/// \param hits Receives the indices of all points inside \p box in ascending order. It is cleared first.
+	/// \see AxisAlignedBoundingBox::contains
+	ZKAPI void find_points_inside(AxisAlignedBoundingBox const& box,
+	                              Vec3 const* points,
+	                              std::size_t count,
+	                              std::vector<std::uint32_t>& hits);
+
+	struct OrientedBoundingBox;
+
+	/// \brief A box hit by a ray cast using OrientedBoundingBox::raycast.
+	struct OrientedBoundingBoxHit {
+		/// \brief The distance from the origin of the ray to the point at which it enters the box, in multiples
+		///        of the length of the direction of the ray. Zero if the ray starts inside the box.
+		float distance;
+
+		/// \brief The leaf box which was hit.
+		OrientedBoundingBox const* box;
 	};
 
 	/// \brief Represents an oriented bounding box.
@@ -45,5 +127,130 @@ namespace zenkit {
 		/// \todo Write a test for this.
 		/// \return An AABB which contains this OBB.
 		[[nodiscard]] ZKAPI AxisAlignedBoundingBox as_bbox() const;
+
+		/// \brief Intersects a ray with this box, ignoring its #children.
+		///
+		/// <p>The #axes are expected to be orthonormal, which they are for all boxes found in game files.</p>
+		///
+		/// \param origin The origin of the ray.
+		/// \param direction The direction of the ray. It does not need to be normalized.
+		/// \return The distance at which the ray enters the box in multiples of \p direction, `0` if \p origin
+		///         is inside the box or `std::nullopt` if the ray misses it.
+		[[nodiscard]] ZKAPI std::optional<float> intersect(Vec3 const& origin, Vec3 const& direction) const noexcept;
+
+		/// \brief Tests whether this box overlaps another one, ignoring the #children of both.
+		///
+		/// <p>Uses the separating axis test with the 15 axes of the two boxes and their cross products. The
+		/// #axes are expected to be orthonormal.</p>
+		///
+		/// \param other The box to test against.
+		/// \return `true` if the boxes overlap or touch.
+		[[nodiscard]] ZKAPI bool intersects(OrientedBoundingBox const& other) const noexcept;
+
+		/// \brief Finds the closest leaf of this box tree hit by a ray.
+		///
+		/// <p>Each box contains its #children, so the children of a box are only tested if the ray hits the box
+		/// itself. Boxes without children are the leaves of the tree.</p>
+		///
+		/// \param origin The origin of the ray.
+		/// \param direction The direction of the ray. It does not need to be normalized.
+		/// \param max_distance The maximum distance at which boxes are hit, in multiples of \p direction.
+		/// \return The closest leaf hit or `std::nullopt` if the ray doesn't hit any leaf.
+		[[nodiscard]] ZKAPI std::optional<OrientedBoundingBoxHit>
+		raycast(Vec3 const& origin,
+		        Vec3 const& direction,
+		        float max_distance = std::numeric_limits<float>::max()) const noexcept;
+
+		/// \brief Tests whether any leaf of this box tree overlaps any leaf of another box tree.
+		///
+		/// <p>Both trees are descended together, only visiting the children of boxes which overlap.</p>
+		///
+		/// \param other The root of the other tree.
+		/// \return `true` if any pair of leaves overlaps.
+		[[nodiscard]] ZKAPI bool overlaps(OrientedBoundingBox const& other) const noexcept;
+	};
+
+	/// \brief The result of testing a bounding box against a Frustum.
+	enum class FrustumTest : std::uint8_t {
+		OUTSIDE = 0,
+		INTERSECTS = 1,
+		INSIDE = 2,
+	};
+
+	/// \brief A view frustum given by six planes facing into it.
+	///
+	/// <p>A point is inside the frustum if it lies on the front side of each of its planes, where
+	/// `dot(plane.xyz, point) - plane.w >= 0`. This is the same convention used by BspNode::plane.</p>
+	struct Frustum {
+		std::array<Vec4, 6> planes;
+
+		/// \brief Extracts the planes of the frustum from a view-projection matrix.
+		///
+		/// The matrix is expected to map points to clip space like in OpenGL, where a point is visible if
+		/// `-w <= x, y, z <= w`. Its columns are stored in Mat4::columns.
+		///
+		/// \param view_projection The combined view and projection matrix.
+		/// \return The frustum containing all points visible through \p view_projection.
+		[[nodiscard]] ZKAPI static Frustum from_matrix(Mat4 const& view_projection);
+
+		/// \brief Tests whether the given bounding box is inside the frustum.
+		///
+		/// The test is conservative: boxes near the corners of the frustum may be reported to intersect it even
+		/// if they are actually outside.
+		///
+		/// \param box The box to test.
+		/// \return Whether the box is completely outside, partially inside or completely inside the frustum.
+		[[nodiscard]] ZKAPI FrustumTest test(AxisAlignedBoundingBox const& box) const noexcept;
+
+		/// \brief Tests the given bounding box against the planes selected by \p mask only.
+		///
+		/// Bit `i` of \p mask selects #planes[i]. Planes the box is completely in front of are cleared from
+		/// \p mask, so that boxes contained in this one can skip them. This is used for hierarchical culling.
+		///
+		/// \param box The box to test.
+		/// \param mask The planes to test against. Updated to the planes the box intersects.
+		/// \return `false` if the box is completely outside one of the planes.
+		[[nodiscard]] ZKAPI bool test(AxisAlignedBoundingBox const& box, std::uint8_t& mask) const noexcept;
+	};
+
+	/// \brief A packed set of bounding boxes which can be culled against a Frustum in bulk.
+	///
+	/// <p>The boxes are stored in groups of four with each coordinate of the group next to each other, so that the
+	/// compiler can test four boxes against a plane at once using vector instructions. Cull a set built once from
+	/// static objects, like the VObs of a world, instead of testing each object's box individually every frame.</p>
+	class BoundingBoxSet {
+	public:
+		/// \brief Adds a box to the set.
+		/// \param box The box to add.
+		/// \return The index of the box in the set.
+		ZKAPI std::uint32_t add(AxisAlignedBoundingBox const& box);
+
+		/// \brief Removes all boxes from the set.
+		ZKAPI void clear() noexcept;
+
+		/// \return The number of boxes in the set.
+		[[nodiscard]] ZKAPI std::uint32_t size() const noexcept;
+
+		/// \brief Finds all boxes in the set not completely outside the given frustum.
+		///
+		/// The test is the same as Frustum::test.
+		///
+		/// \param frustum The frustum to cull the boxes against.
+		/// \param visible Receives the indices of all visible boxes in ascending order. It is cleared first.
+		ZKAPI void cull(Frustum const& frustum, std::vector<std::uint32_t>& visible) const;
+
+	private:
+		/// \brief Four boxes, stored coordinate by coordinate.
+		struct Group {
+			alignas(16) float min_x[4];
+			alignas(16) float min_y[4];
+			alignas(16) float min_z[4];
+			alignas(16) float max_x[4];
+			alignas(16) float max_y[4];
+			alignas(16) float max_z[4];
+		};
+
+		std::vector<Group> _m_groups;
+		std::uint32_t _m_size = 0;
 	};
 } // namespace zenkit
@@ -0,0 +1,121 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Boxes.hh"
+#include "zenkit/Library.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace zenkit {
+	class Read;
+	class Write;
+	class Mesh;
+
+	/// \brief A triangle of a CollisionMesh.
+	struct CollisionTriangle {
+		Vec3 a;
+		Vec3 b;
+		Vec3 c;
+
+		/// \brief The index of the polygon in Mesh::geometry the triangle was taken from.
+		std::uint32_t polygon;
+	};
+
+	/// \brief A node of the bounding volume hierarchy of a CollisionMesh.
+	struct CollisionNode {
+		AxisAlignedBoundingBox bbox;
+
+		/// \brief For leaf nodes, the index of the first triangle in CollisionMesh::triangles. For inner nodes, the
+		///        index of the first of the two children, which are stored next to each other.
+		std::uint32_t offset;
+
+		/// \brief The number of triangles of a leaf node or 0 for inner nodes.
+		std::uint32_t count;
+	};
+
+	/// \brief The result of a query against a CollisionMesh.
+	struct CollisionHit {
+		/// \brief How far along the query the hit occurred, from 0 at its start to 1 at its end.
+		float fraction;
+
+		/// \brief The point at which the triangle was touched.
+		Vec3 point;
+
+		/// \brief The normalized direction from #point to the center of the sphere at the time of the hit. For rays,
+		///        the normal of the triangle facing the ray.
+		Vec3 normal;
+
+		/// \brief The index of the triangle in CollisionMesh::triangles.
+		std::uint32_t triangle;
+	};
+
+	/// \brief A bounding volume hierarchy over the triangles of a mesh used for collision queries.
+	///
+	/// <p>The polygons of the mesh are split into triangle fans, leaving out polygons which do not collide in the
+	/// ZenGin: portals, ghost occluders and polygons with a material which has Material::disable_collision set.
+	/// The triangles are copied, so the mesh is not needed after building the hierarchy.</p>
+	///
+	/// <p>Building the hierarchy of a world mesh takes a moment, so it should be stored next to the world using
+	/// #save and loaded again using #load.</p>
+	class CollisionMesh {
+	public:
+		/// \brief The maximum number of triangles in a leaf node.
+		static constexpr std::uint32_t MAX_LEAF_SIZE = 4;
+
+		/// \brief Builds the hierarchy from all polygons of the given mesh.
+		/// \param mesh The mesh to build the hierarchy from.
+		ZKAPI void build(Mesh const& mesh);
+
+		/// \brief Builds the hierarchy from the given polygons of the given mesh.
+		/// \param mesh The mesh to build the hierarchy from.
+		/// \param polygons The indices of the polygons in Mesh::geometry to use, like BspTree::leaf_polygons
+		///                 for world meshes.
+		ZKAPI void build(Mesh const& mesh, std::vector<std::uint32_t> const& polygons);
+
+		/// \brief Loads a hierarchy stored using #save.
+		/// \param r The stream to read from.
+		/// \return `false` if the stream does not contain a valid hierarchy. The hierarchy is left unchanged in
+		///         that case.
+		ZKAPI bool load(Read* r);
+
+		/// \brief Stores the hierarchy in a compact binary format.
+		/// \param w The stream to write to.
+		ZKAPI void save(Write* w) const;
+
+		/// \brief Finds the first triangle hit by a ray.
+		/// \param origin The origin of the ray.
+		/// \param direction The direction of the ray. The ray ends at `origin + direction`.
+		/// \return The closest triangle hit or `std::nullopt` if the ray doesn't hit any triangle.
+		[[nodiscard]] ZKAPI std::optional<CollisionHit> raycast(Vec3 const& origin, Vec3 const& direction) const;
+
+		/// \brief Finds the first triangle touched by a sphere moving along a line.
+		///
+		/// <p>To snap a character to the ground, sweep a sphere around its feet downwards and place it at
+		/// `from + (to - from) * fraction`. If the sphere already touches a triangle at \p from, the hit has a
+		/// fraction of 0.</p>
+		///
+		/// \param from The center of the sphere at the start of the movement.
+		/// \param to The center of the sphere at the end of the movement.
+		/// \param radius The radius of the sphere.
+		/// \return The first triangle touched or `std::nullopt` if the sphere can move freely.
+		[[nodiscard]] ZKAPI std::optional<CollisionHit>
+		sweep_sphere(Vec3 const& from, Vec3 const& to, float radius) const;
+
+		/// \brief Finds all triangles touched by a capsule.
+		/// \param a The center of one end of the capsule.
+		/// \param b The center of the other end of the capsule.
+		/// \param radius The radius of the capsule.
+		/// \param triangles Receives the indices of the triangles in #triangles. It is cleared first.
+		ZKAPI void
+		overlap_capsule(Vec3 const& a, Vec3 const& b, float radius, std::vector<std::uint32_t>& triangles) const;
+
+		/// \brief The nodes of the hierarchy, starting with the root.
+		std::vector<CollisionNode> nodes;
+
+		/// \brief The triangles of the mesh, ordered so that each leaf node refers to a contiguous range.
+		std::vector<CollisionTriangle> triangles;
+	};
+} // namespace zenkit
@@ -5,7 +5,11 @@
 #include "zenkit/Library.hh"
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace zenkit {
@@ -65,6 +69,41 @@ namespace zenkit {
 		ZKAPI void save(WriteArchive& w, GameVersion version) const override;
 	};
 
+	/// \brief Options for loading a CutsceneLibrary.
+	/// \see CutsceneLibrary::load
+	struct CutsceneLibraryLoadOptions {
+		/// \brief Set to `true` to only read the names of the blocks and decode their messages once they are first
+		///        accessed using CutsceneLibrary::block_by_name.
+		///
+		/// <p>The stream the library is loaded from must outlive the library and all of its copies.</p>
+		bool lazy = false;
+
+		/// \brief Set to `true` to store the names and texts of all messages in one contiguous buffer instead of
+		///        creating a CutsceneBlock for each of them.
+		///
+		/// <p>CutsceneLibrary::blocks stays empty. Use CutsceneLibrary::message and CutsceneLibrary::message_by_name
+		/// to access the messages instead. Takes precedence over #lazy.</p>
+		bool compact = false;
+	};
+
+	/// \brief A read-only view of a message of a CutsceneLibrary.
+	///
+	/// <p>The views point into the library the message was retrieved from and are only valid as long as it is
+	/// alive and not loaded again.</p>
+	struct CutsceneMessageView {
+		/// \brief The name of the block containing the message.
+		std::string_view block;
+
+		/// \brief The text associated with the message.
+		std::string_view text;
+
+		/// \brief The name of the WAV file containing the message's audio.
+		std::string_view name;
+
+		/// \see ConversationMessageEvent::type
+		std::uint32_t type;
+	};
+
 	/// \brief Represents a cutscene library.
 	///
 	/// <p>Cutscene libraries, also called message databases, contain voice lines and a reference to the associated
@@ -77,16 +116,90 @@ namespace zenkit {
 		ZK_OBJECT(ObjectType::zCCSLib);
 
 	public:
-		/// \brief Retrieves a message block by it's name.
+		/// \brief Retrieves a message block by it's name, ignoring case.
+		///
+		/// <p>The blocks are looked up in an index built while loading. Call #invalidate_block_index after adding,
+		/// removing or renaming blocks. If the library was loaded lazily, the message of the block is decoded on
+		/// first access. Lookups may happen from multiple threads at once, even after the index was invalidated, as
+		/// long as the blocks are not modified at the same time.</p>
+		///
 		/// \param name The name of the block to get
 		/// \return A pointer to the block or `nullptr` if the block was not found.
 		[[nodiscard]] ZKAPI std::shared_ptr<CutsceneBlock> block_by_name(std::string_view name) const;
 
+		/// \brief Drops the index used by #block_by_name. It is rebuilt by the next lookup.
+		ZKAPI void invalidate_block_index() noexcept;
+
+		/// \return The number of messages in the library, either stored compactly or in #blocks.
+		[[nodiscard]] ZKAPI std::size_t message_count() const noexcept;
+
+		/// \brief Retrieves a message by its position in the library.
+		///
+		/// <p>Works for libraries loaded with or without CutsceneLibraryLoadOptions::compact. For libraries loaded
+		/// lazily, the message must have been decoded using #block_by_name before.</p>
+		///
+		/// \param i The index of the message. Must be less than #message_count.
+		/// \return A view of the message.
+		[[nodiscard]] ZKAPI CutsceneMessageView message(std::size_t i) const;
+
+		/// \brief Retrieves a message by the name of its block, ignoring case.
+		/// \param name The name of the block containing the message.
+		/// \return A view of the message or `std::nullopt` if there is no block with the given name.
+		/// \see #block_by_name
+		[[nodiscard]] ZKAPI std::optional<CutsceneMessageView> message_by_name(std::string_view name) const;
+
+		/// \brief Load the library from the given archive stream.
+		/// \param r The stream to read the library from.
+		/// \param version The game version the library was made for.
+		/// \param options Options for loading the library.
+		/// \throws ParserError if the stream does not contain a cutscene library.
+		ZKAPI void load(Read* r, GameVersion version, CutsceneLibraryLoadOptions const& options = {});
+
 		ZKAPI void load(ReadArchive& r, GameVersion version) override;
 		ZKAPI void save(WriteArchive& w, GameVersion version) const override;
 
 		/// \brief A list of all message blocks in the database.
+		/// \note If the library was loaded lazily, the blocks only contain their name until they are looked up
+		///       using #block_by_name. If it was loaded compactly, the list is empty.
 		std::vector<std::shared_ptr<CutsceneBlock>> blocks {};
+
+	private:
+		/// \brief A string stored in CutsceneLibrary::_m_strings.
+		struct CompactString {
+			std::uint32_t offset;
+			std::uint32_t size;
+		};
+
+		struct CompactMessage {
+			CompactString block;
+			CompactString text;
+			CompactString name;
+			std::uint32_t type;
+		};
+
+		/// \brief The indices of the blocks, or messages if #_m_compact is set, ordered by the ihash of their name.
+		using BlockIndex = std::vector<std::pair<std::uint64_t, std::uint32_t>>;
+
+		void load_compact(ReadArchive& r);
+		std::shared_ptr<BlockIndex const> block_index() const;
+		std::shared_ptr<BlockIndex const> build_block_index() const;
+		void decode_block(CutsceneBlock& block) const;
+
+		[[nodiscard]] CompactString intern(std::string_view s);
+		[[nodiscard]] std::string_view view(CompactString s) const noexcept;
+
+		/// \brief The index used by #block_by_name or `nullptr` if it needs to be rebuilt. Accessed atomically.
+		mutable std::shared_ptr<BlockIndex const> _m_block_names;
+
+		// Set if the library was loaded lazily. Shared between copies of the library.
+		struct LazyBlocks;
+		std::shared_ptr<LazyBlocks> _m_lazy;
+
+		// Set if the library was loaded compactly. The strings of all messages are stored back-to-back in
+		// #_m_strings and the messages are ordered by the name of their block.
+		bool _m_compact {false};
+		std::string _m_strings;
+		std::vector<CompactMessage> _m_messages;
 	};
 
 	struct CutsceneProps final : Object {
@@ -7,10 +7,13 @@
 
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -305,9 +308,15 @@ namespace zenkit {
 
 	/// \brief Represents an object associated with an instance in the script.
 	///
-	/// Instances allocated with init_opaque will be backed up by this class with plain memory storage
+	/// Instances allocated with init_opaque will be backed up by this class with plain memory storage. All members
+	/// live in a single block laid out by DaedalusScript::register_as_opaque, which places the strings at its start.
 	class DaedalusOpaqueInstance final : public DaedalusInstance {
 	public:
+		/// \brief Allocates zeroed storage for an instance of the given class.
+		/// \param cls A class registered using DaedalusScript::register_as_opaque.
+		ZKAPI explicit DaedalusOpaqueInstance(DaedalusSymbol const& cls);
+
+		ZKREM("the member list is no longer needed, use DaedalusOpaqueInstance(cls)")
 		ZKAPI DaedalusOpaqueInstance(DaedalusSymbol const& sym, std::vector<DaedalusSymbol*> const& members);
 		ZKAPI ~DaedalusOpaqueInstance() override;
 
@@ -323,11 +332,8 @@ namespace zenkit {
 		}
 
 	private:
-		template <typename T, typename... Args>
-		ZKINT T* construct_at(size_t offset, Args&&... args);
-
 		std::unique_ptr<std::uint8_t[]> _m_storage;
-		std::vector<std::string*> _m_strings;
+		std::uint32_t _m_string_count {0};
 	};
 
 	/// \brief Represents object instance in the script with no defined backing to memory.
@@ -690,6 +696,20 @@ namespace zenkit {
 
 	private:
 		friend class DaedalusScript;
+		friend class DaedalusVm;
+		friend class DaedalusOpaqueInstance;
+
+		/// \brief Writes the symbol including its current value for DaedalusScript::save_compiled.
+		ZKINT void save_compiled(Write* w) const;
+
+		/// \brief Reads a symbol written by #save_compiled.
+		ZKINT void load_compiled(Read* r);
+
+		/// \return The number of elements in #_m_value. Non-constant function symbols store a single function index.
+		[[nodiscard]] std::uint32_t value_count() const noexcept {
+			return _m_type == DaedalusDataType::FUNCTION ? 1 : _m_count;
+		}
+
 		std::string _m_name;
 		std::variant<std::unique_ptr<std::int32_t[]>,
 		             std::unique_ptr<float[]>,
@@ -713,6 +733,7 @@ namespace zenkit {
 
 		std::uint32_t _m_member_offset {static_cast<uint32_t>(-1)};
 		std::uint32_t _m_class_size {static_cast<uint32_t>(-1)};
+		std::uint32_t _m_class_string_count {0};
 		DaedalusDataType _m_return_type {DaedalusDataType::VOID};
 		std::uint32_t _m_index {static_cast<uint32_t>(-1)};
 		std::type_info const* _m_registered_to {nullptr};
@@ -733,7 +754,195 @@ namespace zenkit {
 		ZKINT static DaedalusInstruction decode(Read* r);
 	};
 
+	/// \brief Assigns a value to a member of the instance being initialized.
+	/// \see DaedalusConstantInitializer
+	struct DaedalusConstantAssignment {
+		/// \brief The instruction performing the assignment. One of MOVI, MOVVF, MOVF or MOVS.
+		DaedalusOpcode op {DaedalusOpcode::MOVI};
+
+		/// \brief The index of the member symbol assigned to and the array element of it.
+		std::uint32_t member {0};
+		std::uint8_t member_index {0};
+
+		/// \brief The index of the global symbol the value is read from and the array element of it
+		///        or `static_cast<std::uint32_t>(-1)` if #immediate is assigned instead.
+		std::uint32_t source {static_cast<std::uint32_t>(-1)};
+		std::uint8_t source_index {0};
+		std::int32_t immediate {0};
+	};
+
+	/// \brief The code of an instance or prototype which only assigns values to members of the instance.
+	///
+	/// Initializers like this are found while loading the script. Since they don't call any functions or externals,
+	/// DaedalusVm applies their assignments directly instead of interpreting their code.
+	///
+	/// \see DaedalusScript::find_constant_initializer
+	struct DaedalusConstantInitializer {
+		/// \brief The prototypes called by the initializer, from the outermost one to the innermost one.
+		std::vector<std::uint32_t> prototypes;
+
+		/// \brief The assignments in the order they are executed in, including those of #prototypes.
+		std::vector<DaedalusConstantAssignment> assignments;
+	};
+
+	/// \brief A function of a script together with the functions it calls, see DaedalusScript::analyze_functions.
+	struct DaedalusFunctionInfo {
+		/// \brief The index of the function symbol.
+		std::uint32_t symbol {0};
+
+		/// \brief The indices of all functions and externals called by the function in ascending order.
+		std::vector<std::uint32_t> callees;
+
+		/// \brief Whether the function only computes a value from its parameters and global constants. Pure
+		///        functions do not call externals, access instances or write to any symbol but their own locals.
+		bool pure {false};
+	};
+
+	namespace detail {
+		struct DaedalusScriptCode;
+	}
+
+	/// \brief A symbol looked up by name once, which can be used to retrieve the symbol again without a lookup.
+	///
+	/// Handles are valid for the script they were resolved in and all of its forks, since they share the same
+	/// symbol table, see DaedalusScript::fork.
+	///
+	/// \see DaedalusScript::resolve_symbol
+	struct DaedalusSymbolHandle {
+		/// \brief The index of the symbol.
+		std::uint32_t index {static_cast<std::uint32_t>(-1)};
+
+		/// \brief The code of the script the handle was resolved in.
+		detail::DaedalusScriptCode const* code {nullptr};
+
+		[[nodiscard]] explicit operator bool() const noexcept {
+			return code != nullptr;
+		}
+	};
+
+	/// \brief A member of a script class to register using DaedalusScript::register_members.
+	///
+	/// Bindings are meant to be written as tables, like `{"NAME", &INpc::name}`, where the name does not include
+	/// the name of the class.
+	struct DaedalusMemberBinding {
+		/// \param member_name The name of the member in the script, without the name of its class.
+		/// \param field The field to register.
+		/// \param is_optional Whether to skip the member if the script does not define it, like members only used
+		///                    by Gothic 2.
+		template <typename _class, typename _member>
+		DaedalusMemberBinding(std::string_view member_name, _member _class::*field, bool is_optional = false)
+		    : DaedalusMemberBinding(member_name, &typeid(_class), type_of<_member>(), 1, is_optional) {
+			_class* base = nullptr;
+			offset = reinterpret_cast<std::uint64_t>(&(base->*field)) & 0xFFFFFFFF;
+		}
+
+		/// \param member_name The name of the member in the script, without the name of its class.
+		/// \param field The array field to register.
+		/// \param is_optional Whether to skip the member if the script does not define it.
+		template <typename _class, typename _member, int N>
+		DaedalusMemberBinding(std::string_view member_name, _member (_class::*field)[N], bool is_optional = false)
+		    : DaedalusMemberBinding(member_name, &typeid(_class), type_of<_member>(), N, is_optional) {
+			_class* base = nullptr;
+			offset = reinterpret_cast<std::uint64_t>(&(base->*field)) & 0xFFFFFFFF;
+		}
+
+		std::string_view name;
+		std::type_info const* owner;
+		DaedalusDataType type;
+		std::uint32_t count;
+		std::uint32_t offset {0};
+		bool optional;
+
+	private:
+		DaedalusMemberBinding(std::string_view member_name,
+		                      std::type_info const* owner_type,
+		                      DaedalusDataType data_type,
+		                      std::uint32_t element_count,
+		                      bool is_optional)
+		    : name(member_name), owner(owner_type), type(data_type), count(element_count), optional(is_optional) {}
+
+		template <typename _member>
+		static constexpr DaedalusDataType type_of() {
+			static_assert(std::is_same_v<_member, std::string> || std::is_same_v<_member, float> ||
+			                  std::is_same_v<_member, std::int32_t> ||
+			                  (std::is_enum_v<_member> && sizeof(_member) == 4),
+			              "only strings, floats, 32-bit integers and 32-bit enums can be registered");
+
+			if constexpr (std::is_same_v<_member, std::string>) {
+				return DaedalusDataType::STRING;
+			} else if constexpr (std::is_same_v<_member, float>) {
+				return DaedalusDataType::FLOAT;
+			} else {
+				return DaedalusDataType::INT;
+			}
+		}
+	};
+
 	/// \brief Represents a compiled daedalus script
+	namespace detail {
+		/// \brief A short sequence of integer instructions executed as one by the interpreter.
+		///
+		/// An operand is a PUSHI or a PUSHV or PUSHVV of an integer variable which is not a member. A target is an
+		/// operand which is a variable and not constant. Sequences are only fused where none of the instructions but
+		/// the last one can fail, so errors are still reported at the instruction which caused them.
+		enum class DaedalusFusion : std::uint8_t {
+			NONE = 0,
+
+			/// \brief An operand followed by a binary operator.
+			BINARY = 1,
+
+			/// \brief Two operands followed by a binary operator.
+			BINARY2 = 2,
+
+			/// \brief An operand followed by a binary operator and a BZ.
+			BINARY_BZ = 3,
+
+			/// \brief Two operands followed by a binary operator and a BZ.
+			BINARY2_BZ = 4,
+
+			/// \brief A target followed by MOVI, ADDMOVI, SUBMOVI, MULMOVI or DIVMOVI.
+			STORE = 5,
+
+			/// \brief An operand and a target followed by MOVI, ADDMOVI, SUBMOVI, MULMOVI or DIVMOVI.
+			ASSIGN = 6,
+		};
+
+		/// \brief The parts of a loaded script which do not change after loading it.
+		///
+		/// They are shared between a script and all of its forks, see DaedalusScript::fork.
+		struct DaedalusScriptCode {
+			/// \brief The case-insensitive hash of the name of every symbol together with its index, sorted by
+			///        hash and then by index. See DaedalusScript::find_symbol_by_name.
+			std::vector<std::pair<std::uint32_t, std::uint32_t>> symbols_by_name;
+			std::unordered_map<std::uint32_t, uint32_t> symbols_by_address;
+
+			/// \brief The indices of all member symbols by the index of their parent, in the order of their indices.
+			std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> members_by_parent;
+
+			/// \brief The indices of all instance symbols by the index of their parent and, if the parent is a
+			///        prototype, the index of the prototype's parent, in the order of their indices.
+			std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> instances_by_parent;
+
+			/// \brief The initializers of all instances and prototypes which only assign values to their members by
+			///        the index of the instance or prototype. See DaedalusScript::find_constant_initializer.
+			std::unordered_map<std::uint32_t, DaedalusConstantInitializer> constant_initializers;
+
+			/// \brief The number of symbols loaded from the script file.
+			std::uint32_t symbol_count {0};
+
+			std::vector<std::byte> text;
+
+			// The code segment is decoded once while loading. Instruction addresses are mapped to their index in
+			// `instructions` using `instruction_index`, which has an entry for every byte of the code segment.
+			std::vector<DaedalusInstruction> instructions;
+			std::vector<std::uint32_t> instruction_index;
+
+			/// \brief The fused sequence starting at each index of `instructions`. It has one more entry than
+			///        `instructions`, which is always DaedalusFusion::NONE.
+			std::vector<DaedalusFusion> fusions {DaedalusFusion::NONE};
+		};
+	} // namespace detail
+
 	class DaedalusScript {
 	public:
 		ZKAPI DaedalusScript() = default;
@@ -742,6 +951,34 @@ namespace zenkit {
 
 		ZKAPI void load(Read* r);
 
+		/// \brief Saves the script in a format which loads faster than the original script file.
+		///
+		/// <p>Besides the symbols, the file contains the decoded instructions and the symbol name index, so that
+		/// #load_compiled only needs to copy them. Instructions are stored in their in-memory representation, which
+		/// is why the file can only be loaded by builds of ZenKit using the same representation. The current values
+		/// of all symbols are saved, but member registrations are not.</p>
+		///
+		/// \param w The stream to write the compiled script to.
+		/// \see #load_compiled
+		ZKAPI void save_compiled(Write* w) const;
+
+		/// \brief Loads a script saved using #save_compiled.
+		/// \param r The stream to read the compiled script from.
+		/// \throws ParserError if \p r does not contain a compiled script or it was saved by an incompatible build.
+		ZKAPI void load_compiled(Read* r);
+
+		/// \brief Creates a copy of the script which shares its code with this script.
+		///
+		/// <p>The copy gets its own symbol values, so that multiple VMs can run the same script independently of
+		/// each other without loading it again. The code, the decoded instructions and the symbol lookup tables are
+		/// immutable after loading and are shared between all forks of a script, even across threads.</p>
+		///
+		/// <p>Member registrations are copied. Instance symbols are reset to `nullptr` in the copy, since
+		/// instances belong to the VM they were initialized in.</p>
+		///
+		/// \return A new script with the same symbols as this one.
+		[[nodiscard]] ZKAPI DaedalusScript fork() const;
+
 		/// \brief Registers a member offset
 		/// \param name The name of the member in the script
 		/// \param field The field to register
@@ -784,6 +1021,20 @@ namespace zenkit {
 			sym->_m_registered_to = type;
 		}
 
+		/// \brief Registers many members of a class at once.
+		///
+		/// <p>This is equivalent to calling #register_member for every binding, but the members are looked up
+		/// among the members of the class instead of among all symbols of the script. Prefer it for registering
+		/// whole classes.</p>
+		///
+		/// \param class_name The name of the class in the script.
+		/// \param members The members to register. Their names do not include the name of the class.
+		/// \throws DaedalusSymbolNotFound if the class or a member which is not optional does not exist.
+		/// \throws DaedalusMemberRegistrationError if a member could not be registered.
+		/// \throws DaedalusInvalidRegistrationDataType If the datatype of a member is different than that of its
+		/// symbol.
+		ZKAPI void register_members(std::string_view class_name, std::initializer_list<DaedalusMemberBinding> members);
+
 		/// \return All symbols in the script
 		[[nodiscard]] ZKAPI std::vector<DaedalusSymbol> const& symbols() const noexcept {
 			return _m_symbols;
@@ -794,6 +1045,27 @@ namespace zenkit {
 		/// \return The symbol or `nullptr` if the index was out-of-range.
 		[[nodiscard]] ZKAPI DaedalusSymbol const* find_symbol_by_index(std::uint32_t index) const;
 
+		/// \brief Looks up the symbol with the given name once, for retrieving it repeatedly using #find_symbol.
+		/// \param name The name of the symbol, which is compared case-insensitively.
+		/// \return A handle to the symbol or an empty handle if no symbol with that name was found.
+		[[nodiscard]] ZKAPI DaedalusSymbolHandle resolve_symbol(std::string_view name) const;
+
+		/// \brief Retrieves the symbol referred to by a handle.
+		/// \param handle A handle returned by #resolve_symbol.
+		/// \return The symbol or `nullptr` if the handle is empty or was resolved in an unrelated script.
+		[[nodiscard]] ZKAPI DaedalusSymbol const* find_symbol(DaedalusSymbolHandle handle) const noexcept {
+			if (handle.code != _m_code.get() || handle.index >= _m_symbols.size()) return nullptr;
+			return &_m_symbols[handle.index];
+		}
+
+		/// \brief Retrieves the symbol referred to by a handle.
+		/// \param handle A handle returned by #resolve_symbol.
+		/// \return The symbol or `nullptr` if the handle is empty or was resolved in an unrelated script.
+		[[nodiscard]] ZKAPI DaedalusSymbol* find_symbol(DaedalusSymbolHandle handle) noexcept {
+			if (handle.code != _m_code.get() || handle.index >= _m_symbols.size()) return nullptr;
+			return &_m_symbols[handle.index];
+		}
+
 		/// \brief Looks for parameters of the given function symbol. Only works for external functions.
 		/// \param parent The function symbol to get the parameter symbols for.
 		/// \return A list of function parameter symbols.
@@ -806,6 +1078,10 @@ namespace zenkit {
 		[[nodiscard]] ZKAPI DaedalusSymbol const* find_symbol_by_address(std::uint32_t address) const;
 
 		/// \brief Retrieves the symbol with the given \p name.
+		///
+		/// The name is compared case-insensitively, without allocating. To look the same symbol up repeatedly,
+		/// prefer #resolve_symbol.
+		///
 		/// \param name The name of the symbol to get.
 		/// \return The symbol or `nullptr` if no symbol with that name was found.
 		[[nodiscard]] ZKAPI DaedalusSymbol const* find_symbol_by_name(std::string_view name) const;
@@ -842,6 +1118,50 @@ namespace zenkit {
 		/// \return The instruction.
 		[[nodiscard]] ZKAPI DaedalusInstruction instruction_at(std::uint32_t address) const;
 
+		/// \brief Finds the index of the instruction starting at \p address in #instructions.
+		/// \param address The address of the instruction.
+		/// \return The index of the instruction or `static_cast<std::uint32_t>(-1)` if no instruction starts at
+		///         the given address.
+		[[nodiscard]] ZKAPI std::uint32_t instruction_index(std::uint32_t address) const noexcept {
+			auto const& index = _m_code->instruction_index;
+			return address < index.size() ? index[address] : static_cast<uint32_t>(-1);
+		}
+
+		/// \return All instructions of the script, decoded once while loading and ordered by address.
+		[[nodiscard]] ZKAPI std::vector<DaedalusInstruction> const& instructions() const noexcept {
+			return _m_code->instructions;
+		}
+
+		/// \brief Finds all instructions reachable from the start of the given function without returning from it.
+		/// \param sym The function to find the instructions of.
+		/// \return The addresses of the instructions in ascending order or an empty list if the function is external
+		///         or jumps to an address at which no instruction starts.
+		[[nodiscard]] ZKAPI std::vector<std::uint32_t> find_function_code(DaedalusSymbol const& sym) const;
+
+		/// \brief Computes a checksum of the instructions returned by #find_function_code.
+		///
+		/// The checksum only changes if the code of the function itself changes, which is used to detect whether
+		/// code generated from a function still matches the loaded script.
+		///
+		/// \param sym The function to compute the checksum of.
+		/// \return The checksum of the function's code.
+		[[nodiscard]] ZKAPI std::uint32_t function_checksum(DaedalusSymbol const& sym) const;
+
+		/// \brief Builds the call graph of the script and finds all pure functions in it.
+		///
+		/// Only functions for which #find_function_code can follow the code are analyzed. Functions calling an
+		/// unanalyzed function are never pure.
+		///
+		/// \return Information about all analyzed functions ordered by symbol index.
+		[[nodiscard]] ZKAPI std::vector<DaedalusFunctionInfo> analyze_functions() const;
+
+		/// \brief Finds the constant initializer of the given instance or prototype.
+		/// \param sym The instance or prototype symbol.
+		/// \return The initializer or `nullptr` if the code of the symbol does more than assigning values to
+		///         members of the instance.
+		[[nodiscard]] ZKAPI DaedalusConstantInitializer const*
+		find_constant_initializer(DaedalusSymbol const& sym) const;
+
 		/// \return The total size of the script.
 		[[nodiscard]] ZKAPI std::uint32_t size() const noexcept;
 
@@ -890,6 +1210,11 @@ namespace zenkit {
 		void register_as_opaque(DaedalusSymbol* sym);
 
 	protected:
+		/// \return The fused sequence starting at each instruction, see detail::DaedalusFusion.
+		[[nodiscard]] std::vector<detail::DaedalusFusion> const& fusions() const noexcept {
+			return _m_code->fusions;
+		}
+
 		template <typename _member, int N>
 		DaedalusSymbol* _check_member(std::string_view name, std::type_info const* type) {
 			auto* sym = find_symbol_by_name(name);
@@ -931,11 +1256,14 @@ namespace zenkit {
 		ZKAPI DaedalusSymbol* add_temporary_strings_symbol();
 
 	private:
-		std::vector<DaedalusSymbol> _m_symbols;
-		std::unordered_map<std::string, uint32_t> _m_symbols_by_name;
-		std::unordered_map<std::uint32_t, uint32_t> _m_symbols_by_address;
+		/// \brief Builds the address, member and instance indices, folds constant initializers and finds
+		///        fused instructions.
+		///
+		/// The symbols and the instructions have to be loaded into \p code already.
+		ZKINT void build_indices(detail::DaedalusScriptCode& code) const;
 
-		mutable std::unique_ptr<Read> _m_text;
+		std::vector<DaedalusSymbol> _m_symbols;
+		std::shared_ptr<detail::DaedalusScriptCode const> _m_code {std::make_shared<detail::DaedalusScriptCode>()};
 		std::uint8_t _m_version {0};
 	};
 } // namespace zenkit
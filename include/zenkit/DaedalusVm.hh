@@ -4,14 +4,17 @@
 #include "zenkit/DaedalusScript.hh"
 #include "zenkit/Library.hh"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <memory>
 #include <optional>
-#include <stack>
-#include <string>
 #include <unordered_map>
+#include <string>
 
 namespace zenkit {
 	struct IgnoreReturnValue {};
@@ -70,14 +73,81 @@ namespace zenkit {
 		fail_ ZKREM("renamed to DaedalusVmExceptionStrategy::FAIL") = FAIL,
 	};
 
+	/// \brief The kind of value stored in a DaedalusStackFrame.
+	enum class DaedalusStackFrameType : std::uint8_t {
+		INT = 0,       ///< An immediate integer stored in DaedalusStackFrame::i.
+		FLOAT = 1,     ///< An immediate float stored in DaedalusStackFrame::f.
+		INSTANCE = 2,  ///< An immediate instance stored in DaedalusStackFrame::instance.
+		REFERENCE = 3, ///< A reference to the symbol DaedalusStackFrame::symbol in DaedalusStackFrame::instance.
+		STRING = 4,    ///< A string in the string pool of the VM with the handle DaedalusStackFrame::symbol.
+	};
+
 	/// \brief A stack frame in the VM.
+	///
+	/// Frames only hold raw pointers to instances, so that pushing and popping values does not have to touch any
+	/// reference counts. The VM keeps the instances alive while they are on the stack.
 	struct DaedalusStackFrame {
-		std::shared_ptr<DaedalusInstance> context;
-		bool reference;
-		std::variant<int32_t, float, DaedalusSymbol*, std::shared_ptr<DaedalusInstance>> value;
-		uint16_t index {0};
+		/// \brief The value of an immediate instance or the context of a reference.
+		DaedalusInstance* instance {nullptr};
+
+		union {
+			std::int32_t i {0};
+			float f;
+			std::uint32_t symbol;
+		};
+
+		std::uint16_t index {0};
+		DaedalusStackFrameType type {DaedalusStackFrameType::INT};
+	};
+
+	/// \brief The parameter symbols of a function, in declaration order.
+	///
+	/// Parameter lists point into a symbol table owned by the VM, so looking them up does not allocate.
+	struct DaedalusParameterList {
+		DaedalusSymbol* const* symbols {nullptr};
+		std::uint32_t count {0};
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return count;
+		}
+
+		[[nodiscard]] DaedalusSymbol* operator[](std::size_t i) const noexcept {
+			return symbols[i];
+		}
+
+		[[nodiscard]] DaedalusSymbol* const* begin() const noexcept {
+			return symbols;
+		}
+
+		[[nodiscard]] DaedalusSymbol* const* end() const noexcept {
+			return symbols + count;
+		}
 	};
 
+	class DaedalusVm;
+
+	/// \brief A native function called in place of a Daedalus function or external.
+	struct DaedalusExternalCallback {
+		/// \brief A plain function pointer which is called instead of #function if set.
+		void (*direct)(DaedalusVm&) {nullptr};
+		std::function<void(DaedalusVm&)> function;
+
+		[[nodiscard]] explicit operator bool() const noexcept {
+			return direct != nullptr || function != nullptr;
+		}
+
+		void operator()(DaedalusVm& vm) const {
+			if (direct != nullptr) {
+				direct(vm);
+			} else {
+				function(vm);
+			}
+		}
+	};
+
+	/// \brief Native code executing the body of a Daedalus function, see DaedalusVm::register_compiled_function.
+	using DaedalusCompiledFunction = void (*)(DaedalusVm&);
+
 	/// \brief A call stack frame in the VM.
 	struct DaedalusCallStackFrame {
 		DaedalusSymbol const* function;
@@ -101,9 +171,111 @@ namespace zenkit {
 		static constexpr std::uint8_t vm_ignore_const_specifier = IGNORE_CONST_SPECIFIER;
 	} // namespace DaedalusVmExecutionFlag
 
+	/// \brief The values of all symbols of a DaedalusVm at some point in time.
+	/// \see DaedalusVm::snapshot
+	struct DaedalusVmSnapshot {
+		/// \brief The int, float and string values of all symbols in the order of their indices.
+		///
+		/// Ints and floats are stored as is, strings are prefixed with their 32-bit length.
+		std::vector<std::byte> values;
+
+		/// \brief The instances bound to all instance symbols in the order of their indices.
+		std::vector<std::shared_ptr<DaedalusInstance>> instances;
+
+		/// \brief The current instance of the VM.
+		std::shared_ptr<DaedalusInstance> instance;
+
+		/// \brief The number of symbols of the VM the snapshot was taken from.
+		std::uint32_t symbol_count {0};
+
+		/// \brief The execution flags of the VM.
+		std::uint8_t flags {DaedalusVmExecutionFlag::NONE};
+	};
+
+	/// \brief Statistics about the calls of a function or external recorded by the profiler of a DaedalusVm.
+	///
+	/// Inclusive values contain everything done by the function and the functions it calls while exclusive values
+	/// only contain what was done by the function itself. Externals and function overrides do not execute any
+	/// instructions, so only their call counts and times are recorded.
+	struct DaedalusProfileEntry {
+		std::uint64_t calls {0};
+		std::uint64_t inclusive_instructions {0};
+		std::uint64_t exclusive_instructions {0};
+		std::chrono::nanoseconds inclusive_time {0};
+		std::chrono::nanoseconds exclusive_time {0};
+	};
+
+	/// \brief A function in the call tree recorded by the profiler of a DaedalusVm.
+	struct DaedalusProfileNode {
+		/// \brief The index of the function's symbol.
+		std::uint32_t symbol {0};
+
+		/// \brief The index of the node of the calling function in DaedalusVmProfile::nodes.
+		std::uint32_t parent {0};
+
+		/// \brief The statistics of all calls of the function made through this exact call stack.
+		DaedalusProfileEntry stats;
+	};
+
+	/// \brief What to weigh the call stacks written by DaedalusVmProfile::save_folded with.
+	enum class DaedalusProfileWeight {
+		INSTRUCTIONS = 0, ///< The number of instructions executed.
+		TIME = 1,         ///< The wall time spent in microseconds.
+	};
+
+	/// \brief The statistics recorded by the profiler of a DaedalusVm.
+	/// \see DaedalusVm::set_profiling
+	struct DaedalusVmProfile {
+		/// \brief The statistics of all functions and externals by their symbol index.
+		std::vector<DaedalusProfileEntry> functions;
+
+		/// \brief The call tree. The first node is the root, which does not refer to a function.
+		std::vector<DaedalusProfileNode> nodes {DaedalusProfileNode {}};
+
+		/// \brief The total number of instructions executed.
+		std::uint64_t instructions {0};
+
+		/// \brief Writes the call tree in the folded stack format used by flame graph tools.
+		///
+		/// Each line contains the names of the functions on a call stack separated by semicolons, followed by
+		/// the exclusive weight of the function on top of it, for example `B_ASSESSTALK;NPC_ISPLAYER 12`. Call
+		/// stacks with a weight of zero are left out.
+		///
+		/// \param w The stream to write to.
+		/// \param script The script the profile was recorded for, used to look up the names of the functions.
+		/// \param weight What to weigh each call stack with.
+		ZKAPI void save_folded(Write* w, DaedalusScript const& script, DaedalusProfileWeight weight) const;
+
+		/// \brief Records the start of a call of the given function.
+		ZKINT void enter(std::uint32_t symbol);
+
+		/// \brief Records the end of the innermost call started by #enter.
+		ZKINT void leave();
+
+	private:
+		struct Frame {
+			std::uint32_t node;
+			std::uint64_t instructions;
+			std::chrono::steady_clock::time_point start;
+			std::uint64_t child_instructions {0};
+			std::chrono::nanoseconds child_time {0};
+		};
+
+		/// \brief Finds the child of the given node for the given function, adding it if it does not exist yet.
+		ZKINT std::uint32_t find_child(std::uint32_t parent, std::uint32_t symbol);
+
+		/// \brief The calls currently executing, innermost last.
+		std::vector<Frame> _m_frames;
+
+		/// \brief The child nodes of all nodes, by the index of the parent node in the upper 32 bits and the symbol
+		///        index of the child in the lower 32 bits.
+		std::unordered_map<std::uint64_t, std::uint32_t> _m_children;
+	};
+
 	class DaedalusVm : public DaedalusScript {
 	public:
 		static constexpr auto stack_size = 2048;
+		static constexpr auto call_stack_size = 1024;
 
 		/// \brief Creates a DaedalusVM DaedalusInstance for the given script.
 		/// \param scr The script to load into the VM.
@@ -118,6 +290,15 @@ namespace zenkit {
 			return call_function<R, P...>(find_symbol_by_name(sym), args...);
 		}
 
+		/// \brief Calls a function by a handle resolved using DaedalusScript::resolve_symbol.
+		/// \tparam P The types for the argument values.
+		/// \param sym The handle of the function to call.
+		/// \param args The arguments for the function call.
+		template <typename R = IgnoreReturnValue, typename... P>
+		R call_function(DaedalusSymbolHandle sym, P... args) {
+			return call_function<R, P...>(find_symbol(sym), args...);
+		}
+
 		/// \brief Calls a function by it's symbol.
 		/// \tparam P The types for the argument values.
 		/// \param sym The symbol of the function to call.
@@ -132,7 +313,7 @@ namespace zenkit {
 				throw DaedalusVmException {"Cannot call " + sym->name() + ": not a function"};
 			}
 
-			std::vector<DaedalusSymbol*> params = find_parameters_for_function(sym);
+			auto params = find_parameters(sym);
 			if (params.size() < sizeof...(P)) {
 				throw DaedalusVmException {"too many arguments provided for " + sym->name() + ": given " +
 				                           std::to_string(sizeof...(P)) + " expected " + std::to_string(params.size())};
@@ -168,7 +349,9 @@ namespace zenkit {
 		/// \brief Initializes an instance with the given type and name and returns it.
 		///
 		/// This will result in a call into the VM to initialize the instance, so it may be slow.
-		/// Try to initialize all your instances before doing time-critical stuff.
+		/// Try to initialize all your instances before doing time-critical stuff. Instances which only assign
+		/// values to their members are initialized without running the VM, see
+		/// DaedalusScript::find_constant_initializer.
 		///
 		/// \tparam _instance_t The type of the instance to initialize (ie. C_NPC).
 		/// \param name The name of the instance to initialize (ie. 'STT_309_WHISTLER')
@@ -192,7 +375,9 @@ namespace zenkit {
 		/// \brief Initializes an instance with the given type and name and returns it.
 		///
 		/// This will result in a call into the VM to initialize the instance, so it may be slow.
-		/// Try to initialize all your instances before doing time-critical stuff.
+		/// Try to initialize all your instances before doing time-critical stuff. Instances which only assign
+		/// values to their members are initialized without running the VM, see
+		/// DaedalusScript::find_constant_initializer.
 		///
 		/// \tparam _instance_t The type of the instance to initialize (ie. C_NPC).
 		/// \param sym The symbol to initialize.
@@ -223,13 +408,85 @@ namespace zenkit {
 
 			if (_m_self_sym) _m_self_sym->set_instance(_m_instance);
 
-			unsafe_call(sym);
+			call_initializer(sym);
 
 			// reset the VM state
 			_m_instance = old_instance;
 			if (_m_self_sym) _m_self_sym->set_instance(old_self_instance);
 		}
 
+		/// \brief Initializes instances for all of the given symbols at once.
+		///
+		/// <p>This works like calling #init_instance for every symbol in order, but the global `self` and the
+		/// current instance are swapped out only once for the whole batch and the class registration is only
+		/// checked once for each parent of the symbols.</p>
+		///
+		/// <p>A VM can only initialize its own instances. To initialize instances on multiple threads, give every
+		/// thread a VM of its own running a fork of the same script, see DaedalusScript::fork.</p>
+		///
+		/// \tparam _instance_t The type of the instances to initialize (ie. C_NPC).
+		/// \param symbols The symbols to initialize.
+		/// \param factory Called with each symbol to create the instance to initialize for it.
+		/// \return The initialized instances in the order of \p symbols.
+		/// \throws DaedalusVmException if any of the symbols cannot be initialized as an instance of \p _instance_t.
+		template <typename _instance_t, typename F>
+		std::enable_if_t<std::is_base_of_v<DaedalusInstance, _instance_t>, std::vector<std::shared_ptr<_instance_t>>>
+		init_instances(std::vector<DaedalusSymbol*> const& symbols, F const& factory) {
+			std::vector<std::shared_ptr<_instance_t>> instances;
+			instances.reserve(symbols.size());
+
+			auto old_instance = std::move(_m_instance);
+			auto old_self_instance = _m_self_sym != nullptr ? _m_self_sym->get_instance() : nullptr;
+			auto checked_parent = static_cast<std::uint32_t>(-1);
+
+			try {
+				for (auto* sym : symbols) {
+					if (sym == nullptr) {
+						throw DaedalusVmException {"Cannot init instance: not found"};
+					}
+
+					std::shared_ptr<_instance_t> instance = factory(*sym);
+
+					if (sym->type() == DaedalusDataType::INSTANCE && sym->parent() == checked_parent) {
+						instance->_m_symbol_index = sym->index();
+						instance->_m_type = &typeid(_instance_t);
+						sym->set_instance(instance);
+					} else {
+						this->allocate_instance(instance, sym);
+						checked_parent = sym->parent();
+					}
+
+					_m_instance = instance;
+					if (_m_self_sym) _m_self_sym->set_instance(_m_instance);
+
+					call_initializer(sym);
+					instances.push_back(std::move(instance));
+				}
+			} catch (...) {
+				_m_instance = std::move(old_instance);
+				if (_m_self_sym) _m_self_sym->set_instance(old_self_instance);
+				throw;
+			}
+
+			// reset the VM state
+			_m_instance = std::move(old_instance);
+			if (_m_self_sym) _m_self_sym->set_instance(old_self_instance);
+			return instances;
+		}
+
+		/// \brief Initializes newly created instances for all of the given symbols at once.
+		/// \tparam _instance_t The type of the instances to initialize (ie. C_NPC).
+		/// \param symbols The symbols to initialize.
+		/// \return The initialized instances in the order of \p symbols.
+		/// \see #init_instances(std::vector<DaedalusSymbol*> const&, F const&)
+		template <typename _instance_t>
+		std::enable_if_t<std::is_base_of_v<DaedalusInstance, _instance_t>, std::vector<std::shared_ptr<_instance_t>>>
+		init_instances(std::vector<DaedalusSymbol*> const& symbols) {
+			return init_instances<_instance_t>(symbols, [](DaedalusSymbol&) { //
+				return std::make_shared<_instance_t>();
+			});
+		}
+
 		std::shared_ptr<DaedalusInstance> init_opaque_instance(DaedalusSymbol* sym);
 
 		/// \brief Allocates an instance with the given type and name and returns it.
@@ -414,64 +671,31 @@ namespace zenkit {
 		/// \throws runtime_error if any other error occurs.
 		template <typename R, typename... P>
 		void register_external(std::string_view name, std::function<R(P...)> const& callback) {
-			auto* sym = find_symbol_by_name(name);
+			auto* sym = find_external<R, P...>(name);
 			if (sym == nullptr) return;
 
-			if (!sym->is_external()) throw DaedalusVmException {"symbol is not external"};
-
-			if constexpr (!std::is_same_v<void, R>) {
-				if (!sym->has_return()) throw DaedalusIllegalExternalReturnType(sym, "<non-void>");
-				if constexpr (is_instance_ptr_v<R>) {
-					if (sym->rtype() != DaedalusDataType::INSTANCE)
-						throw DaedalusIllegalExternalReturnType(sym, "instance");
-				} else if constexpr (std::is_floating_point_v<R>) {
-					if (sym->rtype() != DaedalusDataType::FLOAT) throw DaedalusIllegalExternalReturnType(sym, "float");
-				} else if constexpr (std::is_convertible_v<int32_t, R>) {
-					if (sym->rtype() != DaedalusDataType::INT) throw DaedalusIllegalExternalReturnType(sym, "int");
-				} else if constexpr (std::is_convertible_v<std::string, R>) {
-					if (sym->rtype() != DaedalusDataType::STRING)
-						throw DaedalusIllegalExternalReturnType(sym, "string");
-				} else {
-					throw DaedalusVmException {"unsupported return type"};
-				}
-			} else {
-				if (sym->has_return()) throw DaedalusIllegalExternalReturnType(sym, "void");
-			}
-
-			std::vector<DaedalusSymbol*> params = find_parameters_for_function(sym);
-			if (params.size() < sizeof...(P))
-				throw DaedalusIllegalExternalDefinition {sym,
-				                                         "too many arguments declared for external " + sym->name() +
-				                                             ": declared " + std::to_string(sizeof...(P)) +
-				                                             " expected " + std::to_string(params.size())};
-
-			if (params.size() > sizeof...(P))
-				throw DaedalusIllegalExternalDefinition {sym,
-				                                         "not enough arguments declared for external " + sym->name() +
-				                                             ": declared " + std::to_string(sizeof...(P)) +
-				                                             " expected " + std::to_string(params.size())};
-
-			if constexpr (sizeof...(P) > 0) {
-				check_external_params<0, P...>(params);
-			}
+			auto& external = _m_externals[sym->index()];
+			external.direct = nullptr;
+			external.function = [callback](DaedalusVm& machine) { machine.invoke_external<R, P...>(callback); };
+		}
 
-			// *evil template hacking ensues*
-			_m_externals[sym] = [callback](DaedalusVm& machine) {
-				if constexpr (std::is_same_v<void, R>) {
-					if constexpr (sizeof...(P) > 0) {
-						auto v = machine.pop_values_for_external<P...>();
-						std::apply(callback, v);
-					} else {
-						callback();
-					}
-				} else {
-					if constexpr (sizeof...(P) > 0) {
-						machine.push_value_from_external(std::apply(callback, machine.pop_values_for_external<P...>()));
-					} else {
-						machine.push_value_from_external(callback());
-					}
-				}
-			};
+		/// \brief Registers a plain C++ function as a Daedalus external.
+		///
+		/// Works like #register_external(std::string_view, std::function) but the function is called directly
+		/// instead of through a std::function, which makes calling the external from a script slightly cheaper.
+		///
+		/// \code
+		/// static int32_t hlp_random(int32_t max) { return rand() % max; }
+		///
+		/// vm.register_external<hlp_random>("Hlp_Random");
+		/// \endcode
+		///
+		/// \tparam F The function to register.
+		/// \param name The name of the external to register.
+		/// \see #register_external(std::string_view, std::function)
+		template <auto F>
+		void register_external(std::string_view name) {
+			register_external_pointer<F>(name, F);
 		}
 
 		/// \brief Registers an external function.
@@ -525,7 +749,7 @@ namespace zenkit {
 				if (sym->has_return()) throw DaedalusIllegalExternalReturnType(sym, "void");
 			}
 
-			std::vector<DaedalusSymbol*> params = find_parameters_for_function(sym);
+			auto params = find_parameters(sym);
 			if (params.size() < sizeof...(P))
 				throw DaedalusIllegalExternalDefinition {
 				    sym,
@@ -542,23 +766,11 @@ namespace zenkit {
 				check_external_params<0, P...>(params);
 			}
 
-			// *evil template hacking ensues*
-			_m_function_overrides[sym->address()] = [callback, sym](DaedalusVm& machine) {
+			auto& external = _m_externals[find_override_index(sym)];
+			external.direct = nullptr;
+			external.function = [callback, sym](DaedalusVm& machine) {
 				machine.push_call(sym);
-				if constexpr (std::is_same_v<void, R>) {
-					if constexpr (sizeof...(P) > 0) {
-						auto v = machine.pop_values_for_external<P...>();
-						std::apply(callback, v);
-					} else {
-						callback();
-					}
-				} else {
-					if constexpr (sizeof...(P) > 0) {
-						machine.push_value_from_external(std::apply(callback, machine.pop_values_for_external<P...>()));
-					} else {
-						machine.push_value_from_external(callback());
-					}
-				}
+				machine.invoke_external<R, P...>(callback);
 				machine.pop_call();
 			};
 		}
@@ -575,7 +787,9 @@ namespace zenkit {
 			if (sym == nullptr) throw DaedalusVmException {"symbol not found"};
 			if (sym->is_external()) throw DaedalusVmException {"symbol is already an external"};
 
-			_m_function_overrides[sym->address()] = [callback](DaedalusVm& machine) { callback(machine); };
+			auto& external = _m_externals[find_override_index(sym)];
+			external.direct = nullptr;
+			external.function = [callback](DaedalusVm& machine) { callback(machine); };
 		}
 
 		/// \brief Overrides a function in Daedalus code with an external definition.
@@ -618,6 +832,16 @@ namespace zenkit {
 
 		ZKAPI void register_access_trap(std::function<void(DaedalusSymbol&)> const& callback);
 
+		/// \brief Registers a function to be called before the interpreter executes an instruction.
+		///
+		/// <p>The hook is meant for tracing and debugging and must not alter the VM's state. While a trace hook, an
+		/// access trap or profiling is active, the VM runs an interpreter which checks for them before every
+		/// instruction. Otherwise, they don't cost anything.</p>
+		///
+		/// \param callback The function to call with the VM and the instruction at its program counter or an empty
+		///                 function to remove the hook.
+		ZKAPI void register_trace_hook(std::function<void(DaedalusVm&, DaedalusInstruction const&)> const& callback);
+
 		/// \brief Registers a function to be called when script execution fails.
 		///
 		/// A variety of exceptions can occur within the VM while executing. The function passed to this handler can
@@ -632,6 +856,25 @@ namespace zenkit {
 		                                              DaedalusScriptError const&,
 		                                              DaedalusInstruction const&)> const& callback);
 
+		/// \brief Registers native code to execute instead of interpreting the given function.
+		///
+		/// <p>Compiled functions are generated ahead of time from the bytecode of a script, for example by the
+		/// `daedalus2cpp` example. Unlike function overrides, they replace only the body of the function: the VM
+		/// still sets up and tears down the call stack frame, so the compiled code has to behave exactly like the
+		/// bytecode. Instructions it does not translate itself can be executed using #unsafe_exec.</p>
+		///
+		/// <p>If the code of the function in the loaded script does not match \p checksum, the function is not
+		/// registered and will be interpreted as usual. If an exception is raised inside a compiled function, the
+		/// exception handler is invoked but execution cannot resume within the function, so it returns instead.</p>
+		///
+		/// \param name The name of the function to compile.
+		/// \param checksum The DaedalusScript::function_checksum of the function the code was generated from.
+		/// \param fn The compiled code.
+		/// \return `true` if the compiled function was registered, `false` if the function was not found or the
+		///         checksum does not match.
+		ZKAPI bool
+		register_compiled_function(std::string_view name, std::uint32_t checksum, DaedalusCompiledFunction fn);
+
 		/// \brief Calls the given symbol as a function.
 		///
 		/// Automatically pushes a call stack frame. If the function has parameters and/or a return value,
@@ -640,6 +883,52 @@ namespace zenkit {
 		/// \param sym The symbol to unsafe_call.
 		ZKAPI void unsafe_call(DaedalusSymbol const* sym);
 		ZKAPI void unsafe_jump(uint32_t address);
+
+		/// \brief Executes the single instruction at the given address, as if the program counter was there.
+		///
+		/// Exceptions are not passed to the exception handler. Branches and returns only update the program
+		/// counter, so this is meant to be used by compiled functions, which handle control flow themselves.
+		///
+		/// \param address The address of the instruction to execute.
+		ZKAPI void unsafe_exec(std::uint32_t address);
+
+		/// \brief Calls the given symbol as a function which can be suspended by the externals it calls.
+		///
+		/// <p>This works like #unsafe_call, except that an external called by the function, or by any function
+		/// called from it, may call #suspend. The VM then returns from this function right after the external
+		/// returns, keeping its stack, call stack and program counter, until #resume is called. Parameters and the
+		/// return value are dealt with by the caller once the function has returned.</p>
+		///
+		/// <p>Only one resumable call can be active in a VM at a time. To multiplex many script executions, give each
+		/// of them a VM of its own, e.g. running a fork of the same script, see DaedalusScript::fork. A suspended VM
+		/// may be resumed on any thread.</p>
+		///
+		/// \param sym The symbol to call.
+		/// \return `true` if the function returned and `false` if it was suspended.
+		/// \throws DaedalusVmException if a resumable call is already active.
+		ZKAPI bool unsafe_call_resumable(DaedalusSymbol const* sym);
+
+		/// \brief Suspends the resumable call currently executing the calling external.
+		///
+		/// The return value of the external is pushed using #push_int, #push_float, #push_string or #push_instance
+		/// before calling #resume instead of being returned. The value returned by an external registered using
+		/// #register_external is discarded when it suspends. Default externals and function overrides must not push
+		/// a return value when suspending.
+		///
+		/// \throws DaedalusVmException if not called from an external executing as part of #unsafe_call_resumable
+		///         or if the call cannot be suspended, because it runs inside a compiled function or another external,
+		///         or because profiling is enabled.
+		ZKAPI void suspend();
+
+		/// \brief Continues a call suspended using #suspend.
+		/// \return `true` if the function returned and `false` if it was suspended again.
+		/// \throws DaedalusVmException if the VM is not suspended.
+		ZKAPI bool resume();
+
+		/// \return Whether the VM is waiting for #resume to be called.
+		[[nodiscard]] ZKAPI bool suspended() const noexcept {
+			return _m_suspended;
+		}
 		ZKAPI std::shared_ptr<DaedalusInstance> unsafe_get_gi();
 		ZKAPI void unsafe_set_gi(std::shared_ptr<DaedalusInstance> i);
 
@@ -671,6 +960,36 @@ namespace zenkit {
 		/// \brief Prints the contents of the function call stack and the VMs stack to stderr.
 		ZKAPI void print_stack_trace() const;
 
+		/// \brief Captures the values of all symbols, the instances bound to them and the execution flags.
+		///
+		/// <p>Together with #restore, this allows resetting the global state of the scripts, for example to a state
+		/// saved right after initializing them, without running any script code. The state of the instances
+		/// themselves is not captured, only which instance each symbol refers to.</p>
+		///
+		/// \return A snapshot of the current state of the VM.
+		[[nodiscard]] ZKAPI DaedalusVmSnapshot snapshot() const;
+
+		/// \brief Restores the state of the VM captured by #snapshot.
+		/// \param snapshot A snapshot taken from this VM or another VM running the same script.
+		/// \throws DaedalusVmException if the snapshot was taken from a different script or if the VM is currently
+		///                             executing a function. The VM is left unchanged in this case.
+		ZKAPI void restore(DaedalusVmSnapshot const& snapshot);
+
+		/// \brief Enables or disables the profiler.
+		///
+		/// <p>While enabled, the VM records how often each function and external is called, how many instructions
+		/// it executes and how much time it takes, see DaedalusVmProfile. A slightly slower variant of the
+		/// interpreter, which counts instructions, is used in the meantime.</p>
+		///
+		/// \param enabled `true` to start a new profile, discarding any previous one, `false` to stop profiling.
+		/// \throws DaedalusVmException if the VM is currently executing a function.
+		ZKAPI void set_profiling(bool enabled);
+
+		/// \return The profile recorded since profiling was enabled or `nullptr` if it is disabled.
+		[[nodiscard]] ZKAPI DaedalusVmProfile const* profile() const noexcept {
+			return _m_profile.get();
+		}
+
 		/// \return The current program counter (or instruction index) the VM is at.
 		[[nodiscard]] ZKAPI uint32_t pc() const noexcept {
 			return _m_pc;
@@ -701,10 +1020,111 @@ namespace zenkit {
 		/// \return false, the instruction executed was a op_return instruction, otherwise true.
 		ZKINT bool exec();
 
+		/// \brief Runs instructions starting at the current program counter until the current function returns.
+		ZKINT void run();
+
 		/// \brief Validates the given address and jumps to it (sets the program counter).
 		/// \param address The address to jump to.
 		ZKINT void jump(std::uint32_t address);
 
+		/// \brief Looks up an external and checks that it matches the given C++ signature.
+		/// \return The external's symbol or `nullptr` if there is no symbol with the given name.
+		/// \throws DaedalusVmException if the symbol is not an external.
+		/// \throws DaedalusIllegalExternalReturnType if the return types don't match.
+		/// \throws DaedalusIllegalExternalDefinition if the number of parameters does not match.
+		/// \throws DaedalusIllegalExternalParameter if the parameter types don't match.
+		template <typename R, typename... P>
+		DaedalusSymbol* find_external(std::string_view name) {
+			auto* sym = find_symbol_by_name(name);
+			if (sym == nullptr) return nullptr;
+
+			if (!sym->is_external()) throw DaedalusVmException {"symbol is not external"};
+
+			if constexpr (!std::is_same_v<void, R>) {
+				if (!sym->has_return()) throw DaedalusIllegalExternalReturnType(sym, "<non-void>");
+				if constexpr (is_instance_ptr_v<R>) {
+					if (sym->rtype() != DaedalusDataType::INSTANCE)
+						throw DaedalusIllegalExternalReturnType(sym, "instance");
+				} else if constexpr (std::is_floating_point_v<R>) {
+					if (sym->rtype() != DaedalusDataType::FLOAT) throw DaedalusIllegalExternalReturnType(sym, "float");
+				} else if constexpr (std::is_convertible_v<int32_t, R>) {
+					if (sym->rtype() != DaedalusDataType::INT) throw DaedalusIllegalExternalReturnType(sym, "int");
+				} else if constexpr (std::is_convertible_v<std::string, R>) {
+					if (sym->rtype() != DaedalusDataType::STRING)
+						throw DaedalusIllegalExternalReturnType(sym, "string");
+				} else {
+					throw DaedalusVmException {"unsupported return type"};
+				}
+			} else {
+				if (sym->has_return()) throw DaedalusIllegalExternalReturnType(sym, "void");
+			}
+
+			auto params = find_parameters(sym);
+			if (params.size() < sizeof...(P))
+				throw DaedalusIllegalExternalDefinition {sym,
+				                                         "too many arguments declared for external " + sym->name() +
+				                                             ": declared " + std::to_string(sizeof...(P)) +
+				                                             " expected " + std::to_string(params.size())};
+
+			if (params.size() > sizeof...(P))
+				throw DaedalusIllegalExternalDefinition {sym,
+				                                         "not enough arguments declared for external " + sym->name() +
+				                                             ": declared " + std::to_string(sizeof...(P)) +
+				                                             " expected " + std::to_string(params.size())};
+
+			if constexpr (sizeof...(P) > 0) {
+				check_external_params<0, P...>(params);
+			}
+
+			return sym;
+		}
+
+		template <auto F, typename R, typename... P>
+		void register_external_pointer(std::string_view name, R (*)(P...)) {
+			auto* sym = find_external<R, P...>(name);
+			if (sym == nullptr) return;
+
+			auto& external = _m_externals[sym->index()];
+			external.direct = [](DaedalusVm& machine) { machine.invoke_external<R, P...>(F); };
+			external.function = nullptr;
+		}
+
+		/// \brief Pops the arguments of an external call off the stack, calls the external and pushes its result.
+		template <typename R, typename... P, typename F>
+		void invoke_external(F const& callback) {
+			if constexpr (std::is_same_v<void, R>) {
+				if constexpr (sizeof...(P) > 0) {
+					std::apply(callback, this->pop_values_for_external<P...>());
+				} else {
+					callback();
+				}
+			} else {
+				if constexpr (sizeof...(P) > 0) {
+					this->push_value_from_external(std::apply(callback, this->pop_values_for_external<P...>()));
+				} else {
+					this->push_value_from_external(callback());
+				}
+			}
+		}
+
+		/// \return The index at which an override for the given function is stored in the external table.
+		[[nodiscard]] std::uint32_t find_override_index(DaedalusSymbol const* sym) const {
+			// BL instructions refer to functions by address, so overrides are stored at the symbol found by address.
+			auto* target = find_symbol_by_address(sym->address());
+			return target != nullptr ? target->index() : sym->index();
+		}
+
+		/// \brief Looks up the parameters of the given function symbol without allocating.
+		/// \param sym The function symbol to get the parameter symbols for.
+		/// \return The parameter symbols of \p sym.
+		[[nodiscard]] DaedalusParameterList find_parameters(DaedalusSymbol const* sym) const noexcept {
+			auto first = static_cast<std::size_t>(sym->index()) + 1;
+			if (first >= _m_symbol_table.size()) return {};
+
+			auto count = std::min<std::size_t>(sym->count(), _m_symbol_table.size() - first);
+			return {_m_symbol_table.data() + first, static_cast<std::uint32_t>(count)};
+		}
+
 		/// \brief Pushes a call stack frame onto the call stack.
 		///
 		/// This method also pushes the current state of the interpreter to be restored as soon
@@ -733,7 +1153,7 @@ namespace zenkit {
 		/// \throws DaedalusIllegalExternalParameter If the types don't match.
 		/// \note Requires that sizeof...(Px) + 1 == defined.size().
 		template <int32_t i, typename P, typename... Px>
-		void check_external_params(std::vector<DaedalusSymbol*> const& defined) {
+		void check_external_params(DaedalusParameterList const& defined) {
 			if constexpr (is_instance_ptr_v<P> || std::is_same_v<DaedalusSymbol*, P> || is_raw_instance_ptr_v<P>) {
 				if (defined[i]->type() != DaedalusDataType::INSTANCE)
 					throw DaedalusIllegalExternalParameter(defined[i], "instance", i + 1);
@@ -915,7 +1335,7 @@ namespace zenkit {
 		                     std::is_same_v<std::remove_reference_t<P>, std::string_view> ||
 		                     std::is_same_v<std::remove_reference_t<P>, DaedalusSymbol*>,
 		                 void>
-		push_call_parameters(std::vector<DaedalusSymbol*> const& defined, P value, Px... more) { // clang-format on
+		push_call_parameters(DaedalusParameterList const& defined, P value, Px... more) { // clang-format on
 			if constexpr (is_instance_ptr_v<P> || std::is_same_v<DaedalusSymbol*, P>) {
 				if (defined[i]->type() != DaedalusDataType::INSTANCE)
 					throw DaedalusIllegalExternalParameter(defined[i], "instance", i + 1);
@@ -973,17 +1393,100 @@ namespace zenkit {
 		}
 
 	private:
+		/// \brief The interpreter loop shared by #exec and #run.
+		/// \tparam STEP If `true`, return after executing a single instruction.
+		/// \tparam INSTRUMENTED If `true`, count the instructions executed in the profile, pass them to the trace
+		///                      hook and invoke access traps. See #instrumented.
+		/// \return `false` if the instruction executed last was a return instruction, `true` otherwise.
+		template <bool STEP, bool INSTRUMENTED>
+		ZKINT bool interpret();
+
+		/// \return Whether profiling, a trace hook or an access trap is active, which requires the instrumented
+		///         interpreter. Otherwise, the interpreter does not check for any of them.
+		[[nodiscard]] ZKINT bool instrumented() const noexcept {
+			return _m_profile != nullptr || _m_trace_hook || _m_access_trap;
+		}
+
+		/// \brief Executes the call started by #unsafe_call_resumable until it returns or is suspended.
+		/// \return `true` if the function returned.
+		ZKINT bool continue_resumable();
+
+		/// \brief Runs the code of an instance or prototype for the current instance.
+		///
+		/// Constant initializers found by DaedalusScript::find_constant_initializer are applied directly, unless
+		/// doing so would behave differently from executing their code, e.g. because an access trap is set or the
+		/// instructions are being profiled or traced.
+		ZKAPI void call_initializer(DaedalusSymbol const* sym);
+
+		/// \brief Passes an exception raised while executing the current instruction to the exception handler.
+		/// \return `false` if execution should return from the current function, `true` to continue.
+		/// \throws The given exception if there is no handler or the handler requests it.
+		ZKINT bool handle_exception(DaedalusScriptError& err);
+
+		/// \brief Pops a reference off the stack without taking ownership of its context.
+		ZKINT std::tuple<DaedalusSymbol*, std::uint16_t, DaedalusInstance*> pop_raw_reference();
+
+		ZKINT std::int32_t read_int(DaedalusInstance const* context, DaedalusSymbol* ref, uint16_t index) const;
+		ZKINT float read_float(DaedalusInstance const* context, DaedalusSymbol* ref, uint16_t index) const;
+		ZKINT void write_int(DaedalusInstance* context, DaedalusSymbol* ref, uint16_t index, std::int32_t value);
+		ZKINT void write_float(DaedalusInstance* context, DaedalusSymbol* ref, uint16_t index, float value);
+		ZKINT void
+		write_string(DaedalusInstance* context, DaedalusSymbol* ref, uint16_t index, std::string_view value);
+
+		/// \brief Keeps the given instance alive while it might be referenced by a stack frame.
+		///
+		/// Pinned instances are released by #unpin once no stack frame refers to them anymore. This happens when
+		/// the outermost function call returns or when there are more pinned instances than stack frames.
+		///
+		/// \param instance The instance to pin.
+		ZKINT void pin(std::shared_ptr<DaedalusInstance> instance);
+
+		/// \brief Releases all pinned instances which are not referred to by a stack frame.
+		ZKINT void unpin();
+
+		/// \return The owning pointer of an instance referred to by a stack frame or `nullptr` if it is not known.
+		[[nodiscard]] ZKINT std::shared_ptr<DaedalusInstance> find_pinned(DaedalusInstance const* instance) const;
+
+		/// \brief Moves all pooled strings still referred to by a stack frame to the front of the string pool.
+		///
+		/// Strings popped off the stack may still be viewed by a running external, so this is only done when no
+		/// external is executing.
+		ZKINT void collect_strings();
+
 		std::array<DaedalusStackFrame, stack_size> _m_stack;
 		uint16_t _m_stack_ptr {0};
-
-		std::stack<DaedalusCallStackFrame> _m_call_stack;
-		std::unordered_map<DaedalusSymbol*, std::function<void(DaedalusVm&)>> _m_externals;
-		std::unordered_map<uint32_t, std::function<void(DaedalusVm&)>> _m_function_overrides;
+		std::vector<std::shared_ptr<DaedalusInstance>> _m_pinned;
+
+		/// \brief Strings pushed onto the stack. A deque does not move its elements when growing, so views into
+		///        popped strings stay valid until the pool is collected.
+		std::deque<std::string> _m_strings;
+		std::uint32_t _m_strings_used {0};
+		std::uint32_t _m_external_depth {0};
+		std::uint32_t _m_compiled_depth {0};
+
+		/// \brief Whether a call started by #unsafe_call_resumable is active, the size of the call stack when it was
+		///        started and whether it is currently suspended.
+		bool _m_resumable {false};
+		std::uint16_t _m_resumable_base {0};
+		bool _m_suspended {false};
+
+		std::array<DaedalusCallStackFrame, call_stack_size> _m_call_stack;
+		uint16_t _m_call_stack_ptr {0};
+
+		/// \brief Pointers to all symbols by their index, used to hand out parameter lists.
+		std::vector<DaedalusSymbol*> _m_symbol_table;
+		/// \brief Registered externals and function overrides by symbol index.
+		std::vector<DaedalusExternalCallback> _m_externals;
+		/// \brief Registered compiled functions by symbol index.
+		std::vector<DaedalusCompiledFunction> _m_compiled;
 		std::optional<std::function<void(DaedalusVm&, DaedalusSymbol&)>> _m_default_external {std::nullopt};
 		std::function<void(DaedalusSymbol&)> _m_access_trap;
+		std::function<void(DaedalusVm&, DaedalusInstruction const&)> _m_trace_hook;
 		std::optional<std::function<
 		    DaedalusVmExceptionStrategy(DaedalusVm&, DaedalusScriptError const&, DaedalusInstruction const&)>>
 		    _m_exception_handler {std::nullopt};
+		/// \brief The last error which failed a call, see #handle_exception.
+		std::exception_ptr _m_failed_error;
 
 		DaedalusSymbol* _m_self_sym;
 		DaedalusSymbol* _m_other_sym;
@@ -994,6 +1497,7 @@ namespace zenkit {
 		DaedalusSymbol* _m_temporary_strings;
 
 		std::shared_ptr<DaedalusInstance> _m_instance;
+		std::unique_ptr<DaedalusVmProfile> _m_profile;
 		std::uint32_t _m_pc {0};
 		std::uint8_t _m_flags {DaedalusVmExecutionFlag::NONE};
 	};
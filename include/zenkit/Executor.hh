@@ -0,0 +1,105 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace zenkit {
+	namespace detail {
+		struct ThreadPoolState;
+		struct TaskGroupTask;
+	} // namespace detail
+
+	/// \brief Runs the tasks of ZenKit's parallel algorithms.
+	///
+	/// <p>All parallel work done by ZenKit, like mounting disks, loading the mesh of a world alongside its VObs or
+	/// converting textures, is handed to the executor set using ::set_executor. By default, that is a ThreadPool
+	/// shared by the whole library. Implement this interface to run the tasks on the job system of the host
+	/// application instead.</p>
+	///
+	/// <p>The thread waiting for a group of tasks always runs those which have not been started yet itself, so an
+	/// executor may start tasks late, in any order or on the calling thread without causing a deadlock.</p>
+	class Executor {
+	public:
+		virtual ~Executor() noexcept = default;
+
+		/// \return The number of tasks the executor can run at the same time in addition to the calling thread.
+		[[nodiscard]] virtual std::size_t concurrency() const noexcept = 0;
+
+		/// \brief Run a task at some point in the future.
+		/// \param task The task to run. It does not throw exceptions.
+		virtual void execute(std::function<void()> task) = 0;
+	};
+
+	/// \brief A work-stealing pool of threads.
+	///
+	/// <p>Each thread has its own queue of tasks. Tasks submitted by a worker are added to its own queue and run in
+	/// last-in-first-out order, while idle threads steal the oldest tasks from the queues of other threads. In builds
+	/// without thread support, tasks are run immediately instead.</p>
+	class ThreadPool final : public Executor {
+	public:
+		/// \param thread_count The number of threads to start or `0` to start one less than the number of hardware
+		///                     threads, since the thread waiting for a group of tasks helps running them.
+		ZKAPI explicit ThreadPool(std::size_t thread_count = 0);
+
+		/// \brief Runs the remaining tasks and stops all threads.
+		ZKAPI ~ThreadPool() noexcept override;
+
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+
+		[[nodiscard]] ZKAPI std::size_t concurrency() const noexcept override;
+		ZKAPI void execute(std::function<void()> task) override;
+
+	private:
+		std::unique_ptr<detail::ThreadPoolState> _m_state;
+	};
+
+	/// \brief Set the executor used for all parallel work done by ZenKit.
+	/// \param executor The executor to use or `nullptr` to use the default ThreadPool. It has to outlive all tasks
+	///                 submitted to it.
+	ZKAPI void set_executor(Executor* executor) noexcept;
+
+	/// \return The executor set using ::set_executor.
+	[[nodiscard]] ZKAPI Executor* get_executor();
+
+	/// \brief A set of tasks which can be waited for together.
+	///
+	/// <p>Tasks are run by an Executor. Waiting for the group runs all tasks which have not been started yet on the
+	/// calling thread. Exceptions thrown by the tasks are rethrown by #wait. Each task is attributed to the
+	/// MemoryCategory and LoadStatsScope which were current when it was added.</p>
+	class TaskGroup {
+	public:
+		/// \param executor The executor to run the tasks or `nullptr` to use ::get_executor.
+		ZKAPI explicit TaskGroup(Executor* executor = nullptr);
+
+		/// \brief Waits for all tasks, discarding their exceptions.
+		ZKAPI ~TaskGroup() noexcept;
+
+		TaskGroup(TaskGroup const&) = delete;
+		TaskGroup& operator=(TaskGroup const&) = delete;
+
+		/// \brief Add a task to the group.
+		/// \param task The task to run.
+		ZKAPI void run(std::function<void()> task);
+
+		/// \brief Wait for all tasks added to the group.
+		/// \throws The first exception thrown by any of the tasks.
+		ZKAPI void wait();
+
+	private:
+		Executor* _m_executor;
+		std::vector<std::shared_ptr<detail::TaskGroupTask>> _m_tasks;
+	};
+
+	/// \brief Call \p fn for every index in `[0, count)`, concurrently on the calling thread and the ::get_executor.
+	/// \param count The number of indices.
+	/// \param fn The function to call.
+	/// \param max_threads The maximum number of threads to use, including the calling one, or `0` for no limit.
+	/// \throws The first exception thrown by \p fn. Indices not yet started when it was thrown are skipped.
+	ZKAPI void parallel_for(std::size_t count, std::function<void(std::size_t)> const& fn, std::size_t max_threads = 0);
+} // namespace zenkit
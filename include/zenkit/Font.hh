@@ -4,8 +4,10 @@
 #include "zenkit/Library.hh"
 #include "zenkit/Misc.hh"
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace zenkit {
@@ -26,6 +28,16 @@ namespace zenkit {
 		[[nodiscard]] ZKAPI bool operator==(FontGlyph const& g) const noexcept;
 	};
 
+	/// \brief A textured rectangle drawing a single glyph of laid out text.
+	/// \see Font::layout
+	struct FontQuad {
+		/// \brief The position of the top left and bottom right corners of the quad in pixels.
+		Vec2 position[2];
+
+		/// \brief The texture coordinates of the top left and bottom right corners of the quad. See FontGlyph::uv.
+		Vec2 uv[2];
+	};
+
 	/// \brief Represents a *ZenGin* font file.
 	///
 	/// <p>Fonts in the *ZenGin* consist of a font definition file and a font texture. This class represents the former.
@@ -51,6 +63,34 @@ namespace zenkit {
 		ZKAPI void load(Read* r);
 		ZKAPI void save(Write* w) const;
 
+		/// \brief Updates the glyph width table used by #measure and #layout.
+		///
+		/// <p>The table is built automatically when the font is loaded or constructed from a list of glyphs. It
+		/// has to be rebuilt manually after modifying #glyphs.</p>
+		ZKAPI void update_metrics() noexcept;
+
+		/// \brief Calculates the size of the given text when drawn using this font.
+		///
+		/// <p>The text is expected to be in the single-byte encoding of the font, usually Windows-1252 or
+		/// Windows-1250, so every byte is looked up as a glyph. Lines are separated by `\n`. Characters without a
+		/// glyph have no width.</p>
+		///
+		/// \param text The text to measure.
+		/// \return The width of the longest line and the total height of all lines in pixels.
+		[[nodiscard]] ZKAPI Vec2 measure(std::string_view text) const noexcept;
+
+		/// \brief Lays out the given text and appends one quad for every visible glyph to \p quads.
+		///
+		/// <p>Glyphs are placed next to each other starting at \p origin, which is the top left corner of the first
+		/// line. Each `\n` starts a new line. Text is handled like in #measure. Glyphs without a width are skipped.
+		/// </p>
+		///
+		/// \param text The text to lay out.
+		/// \param quads The list to append the quads to. It is not cleared, so multiple texts can be batched.
+		/// \param origin The position of the top left corner of the text in pixels.
+		/// \return The size of the text, like #measure.
+		ZKAPI Vec2 layout(std::string_view text, std::vector<FontQuad>& quads, Vec2 origin = {}) const;
+
 		/// \brief The name of this font.
 		std::string name;
 
@@ -69,5 +109,9 @@ namespace zenkit {
 		/// \note The glyphs UV-coordinates are not straightforward. Refer to glyph::uv for an explanation about to
 		///       how to use them
 		std::vector<FontGlyph> glyphs {};
+
+	private:
+		// The width of every glyph in pixels, indexed by character, so measuring needs no bounds checks.
+		std::array<std::uint8_t, 256> _m_widths {};
 	};
 } // namespace zenkit
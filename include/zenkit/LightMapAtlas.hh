@@ -0,0 +1,81 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace zenkit {
+	class Mesh;
+	struct LightMap;
+
+	/// \brief Options for building a LightMapAtlas.
+	struct LightMapAtlasOptions {
+		/// \brief The maximum width and height of each page. Light map textures larger than this get a page of
+		///        their own.
+		std::uint32_t page_size {2048};
+
+		/// \brief The number of pixels around each light map texture which are filled with its border pixels to
+		///        avoid bleeding between neighbors when filtering.
+		std::uint32_t padding {2};
+	};
+
+	/// \brief The area of a LightMapAtlas a light map texture was copied to.
+	struct LightMapAtlasRegion {
+		/// \brief The value of #page for light maps without an image.
+		static constexpr std::uint32_t NO_PAGE = std::numeric_limits<std::uint32_t>::max();
+
+		/// \brief The index of the page in LightMapAtlas::pages.
+		std::uint32_t page;
+
+		/// \brief The texture coordinates of the top-left corner of the texture on the page.
+		Vec2 offset;
+
+		/// \brief The size of the texture on the page in texture coordinates.
+		Vec2 scale;
+	};
+
+	/// \brief An RGBA8 image containing one or more light map textures.
+	struct LightMapAtlasPage {
+		std::uint32_t width;
+		std::uint32_t height;
+
+		/// \brief The pixels of the page, four bytes per pixel, row by row.
+		std::vector<std::uint8_t> pixels;
+	};
+
+	/// \brief The light map textures of a mesh packed into a few large pages.
+	///
+	/// <p>Each light map of a mesh refers to a texture, which is usually shared with many other light maps. The
+	/// light map texture coordinates of a point `p` on a polygon are computed from its LightMap `l` as
+	/// `u = dot(p - l.origin, l.normals[0])` and `v = dot(p - l.origin, l.normals[1])`. The atlas moves every
+	/// texture onto a page, so these coordinates have to be transformed using the LightMapAtlasRegion of the light
+	/// map, which is what #uv and #compute_uvs do.</p>
+	///
+	/// \see Mesh::build_lightmap_atlas
+	struct LightMapAtlas {
+		/// \brief The packed pages.
+		std::vector<LightMapAtlasPage> pages;
+
+		/// \brief For each element of Mesh::lightmaps, the area of its texture.
+		std::vector<LightMapAtlasRegion> regions;
+
+		/// \brief Computes the texture coordinates of a point on the page of a light map.
+		/// \param lightmap The light map.
+		/// \param region The region of the light map.
+		/// \param position The point on a polygon using the light map.
+		/// \return The texture coordinates on the page LightMapAtlasRegion::page.
+		[[nodiscard]] ZKAPI static Vec2
+		uv(LightMap const& lightmap, LightMapAtlasRegion const& region, Vec3 const& position) noexcept;
+
+		/// \brief Computes the light map texture coordinates of all triangles of a mesh.
+		/// \param mesh The mesh the atlas was built from.
+		/// \param uvs Receives the texture coordinates for each element of PolygonList::vertex_indices. Corners of
+		///            triangles without a light map get `{0, 0}`. The page of each triangle is the one of the region
+		///            of its light map in PolygonList::lightmap_indices. It is cleared first.
+		ZKAPI void compute_uvs(Mesh const& mesh, std::vector<Vec2>& uvs) const;
+	};
+} // namespace zenkit
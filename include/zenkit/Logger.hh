@@ -3,6 +3,7 @@
 #pragma once
 #include "zenkit/Library.hh"
 
+#include <atomic>
 #include <cstdarg>
 #include <cstdint>
 #include <functional>
@@ -40,6 +41,17 @@ namespace zenkit {
 		/// \brief Use the default logger callback for ZenKit.
 		ZKREM("renamed to ::set_default") ZKAPI static void use_default_logger();
 
+		/// \brief Check whether messages of the given level pass the level set using ::set or ::set_default.
+		///
+		/// This is a single relaxed atomic load, so it can be used to skip formatting the arguments of messages which
+		/// would be discarded anyway.
+		///
+		/// \param lvl The level to check.
+		/// \return `true` if messages of the given level are logged.
+		[[nodiscard]] static bool enabled(LogLevel lvl) noexcept {
+			return lvl <= _s_level.load(std::memory_order_relaxed);
+		}
+
 		ZK_PRINTF_LIKE(3, 4) ZKAPI static void log(LogLevel lvl, char const* name, char const* fmt, ...);
 		ZKAPI static void logv(LogLevel lvl, char const* name, char const* fmt, va_list ap);
 		ZKAPI static void set(LogLevel lvl, std::function<void(LogLevel, char const*, char const*)> const& cb);
@@ -47,6 +59,6 @@ namespace zenkit {
 
 	private:
 		static std::function<void(LogLevel, char const*, char const*)> _s_callback;
-		static LogLevel _s_level;
+		ZKAPI static std::atomic<LogLevel> _s_level;
 	};
 } // namespace zenkit
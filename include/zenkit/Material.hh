@@ -5,7 +5,13 @@
 #include "zenkit/Library.hh"
 #include "zenkit/Misc.hh"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace zenkit {
 	class ReadArchive;
@@ -174,4 +180,44 @@ namespace zenkit {
 		AlphaFunction alpha_func {AlphaFunction::NONE};
 		Vec2 default_mapping {};
 	};
+
+	/// \brief A table which stores each distinct material only once.
+	///
+	/// <p>Every mesh embeds full copies of its materials, even though a world and the thousands of meshes placed in
+	/// it only use a few hundred distinct ones. Interning them in a registry turns each distinct material into a
+	/// small integer handle which renderers can use to batch draws by material, while all meshes share a single
+	/// instance of it. Materials are compared by their contents, not by their address.</p>
+	///
+	/// <p>Handles are assigned in the order materials are first interned, starting with `0`. Unlike StringPool,
+	/// the registry may be used from multiple threads at once, so that it can be shared by meshes loaded in
+	/// parallel.</p>
+	///
+	/// \see MultiResolutionMeshLoadOptions::materials
+	/// \see WorldLoadOptions::materials
+	class MaterialRegistry {
+	public:
+		/// \brief Adds a material to the registry unless an equal material was added before.
+		/// \param material The material to intern.
+		/// \return The handle of the material.
+		ZKAPI std::uint32_t intern(Material material);
+
+		/// \brief Looks up a material without adding it to the registry.
+		/// \param material The material to look up.
+		/// \return The handle of the material or `std::nullopt` if it was not interned before.
+		[[nodiscard]] ZKAPI std::optional<std::uint32_t> find(Material const& material) const;
+
+		/// \param handle The handle of a material.
+		/// \return The interned material or `nullptr` if \p handle is invalid.
+		[[nodiscard]] ZKAPI std::shared_ptr<Material const> get(std::uint32_t handle) const;
+
+		/// \return The number of distinct materials in the registry.
+		[[nodiscard]] ZKAPI std::size_t size() const;
+
+	private:
+		[[nodiscard]] std::optional<std::uint32_t> find_locked(Material const& material, std::size_t hash) const;
+
+		mutable std::mutex _m_lock;
+		std::vector<std::shared_ptr<Material const>> _m_materials;
+		std::unordered_multimap<std::size_t, std::uint32_t> _m_handles;
+	};
 } // namespace zenkit
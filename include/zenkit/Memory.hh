@@ -0,0 +1,129 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace zenkit {
+	/// \brief The subsystems memory is attributed to.
+	enum class MemoryCategory : std::uint8_t {
+		OTHER = 0,     ///< Memory allocated outside of any loader.
+		WORLD = 1,     ///< Worlds, their VObs and their way-nets, not including the world mesh.
+		MESH = 2,      ///< Meshes of all kinds, including the world mesh and the BSP-tree.
+		TEXTURE = 3,   ///< Textures, including the light-maps of meshes.
+		SCRIPT = 4,    ///< Compiled Daedalus scripts.
+		ANIMATION = 5, ///< Model animations.
+		VFS = 6,       ///< The catalogs and in-memory copies of mounted disks.
+	};
+
+	/// \brief The number of values of MemoryCategory.
+	static constexpr std::size_t MEMORY_CATEGORY_COUNT = 7;
+
+	/// \brief A source of memory, like `std::pmr::memory_resource`.
+	///
+	/// <p>ZenKit allocates the memory it manages itself, i.e. the blocks of every ObjectArena, from the resource set
+	/// using ::set_memory_resource or the one passed to a loader. To use a `std::pmr::memory_resource`, forward both
+	/// functions to it.</p>
+	class MemoryResource {
+	public:
+		virtual ~MemoryResource() noexcept = default;
+
+		/// \brief Allocate memory.
+		/// \param size The number of bytes to allocate.
+		/// \param alignment The alignment of the memory to allocate. Always a power of two.
+		/// \return The allocated memory. Must not be `nullptr`, throw `std::bad_alloc` instead.
+		[[nodiscard]] virtual void* allocate(std::size_t size, std::size_t alignment) = 0;
+
+		/// \brief Free memory returned by #allocate.
+		/// \param p The memory to free.
+		/// \param size The size passed to #allocate.
+		/// \param alignment The alignment passed to #allocate.
+		virtual void deallocate(void* p, std::size_t size, std::size_t alignment) noexcept = 0;
+	};
+
+	/// \return A resource using the global `operator new` and `operator delete`.
+	[[nodiscard]] ZKAPI MemoryResource* new_delete_memory_resource() noexcept;
+
+	/// \brief Set the resource used by ZenKit for memory it manages itself unless a loader is given another one.
+	/// \param resource The resource to use or `nullptr` to use ::new_delete_memory_resource. It has to outlive all
+	///                 memory allocated from it.
+	ZKAPI void set_memory_resource(MemoryResource* resource) noexcept;
+
+	/// \return The resource set using ::set_memory_resource.
+	[[nodiscard]] ZKAPI MemoryResource* get_memory_resource() noexcept;
+
+	/// \return The category of the loader currently running on the calling thread.
+	[[nodiscard]] ZKAPI MemoryCategory current_memory_category() noexcept;
+
+	/// \brief Attributes the memory allocated on the calling thread to a category until it is destroyed.
+	///
+	/// <p>The loaders of ZenKit open a scope for their category, so #current_memory_category tells which subsystem
+	/// an allocation belongs to. Most of ZenKit's memory is held in standard containers, which allocate using the
+	/// global `operator new`. To attribute those allocations as well, replace it and pass the size of each allocation
+	/// and the current category to MemoryTracker::record_allocation.</p>
+	class MemoryScope {
+	public:
+		ZKAPI explicit MemoryScope(MemoryCategory category) noexcept;
+		ZKAPI ~MemoryScope() noexcept;
+
+		MemoryScope(MemoryScope const&) = delete;
+		MemoryScope& operator=(MemoryScope const&) = delete;
+
+	private:
+		MemoryCategory _m_previous;
+	};
+
+	/// \brief Allocation statistics of one MemoryCategory.
+	struct MemoryStats {
+		/// \brief The number of bytes currently allocated.
+		std::size_t current;
+
+		/// \brief The largest number of bytes allocated at once.
+		std::size_t peak;
+
+		/// \brief The number of bytes allocated in total.
+		std::size_t total;
+
+		/// \brief The number of allocations made in total.
+		std::size_t allocations;
+	};
+
+	/// \brief A MemoryResource which collects statistics about the memory allocated from it per MemoryCategory.
+	///
+	/// <p>Allocations are forwarded to another resource and attributed to the #current_memory_category of the
+	/// allocating thread. The tracker is thread-safe if its upstream resource is.</p>
+	class MemoryTracker final : public MemoryResource {
+	public:
+		/// \param upstream The resource to forward allocations to or `nullptr` to use ::get_memory_resource.
+		ZKAPI explicit MemoryTracker(MemoryResource* upstream = nullptr) noexcept;
+
+		[[nodiscard]] ZKAPI void* allocate(std::size_t size, std::size_t alignment) override;
+		ZKAPI void deallocate(void* p, std::size_t size, std::size_t alignment) noexcept override;
+
+		/// \brief Record an allocation which was not made using this tracker, e.g. from a replaced `operator new`.
+		ZKAPI void record_allocation(std::size_t size, MemoryCategory category) noexcept;
+
+		/// \brief Record freeing memory recorded using #record_allocation.
+		ZKAPI void record_deallocation(std::size_t size, MemoryCategory category) noexcept;
+
+		/// \return The statistics of the given category.
+		[[nodiscard]] ZKAPI MemoryStats stats(MemoryCategory category) const noexcept;
+
+		/// \return The statistics of all categories combined. The peak is the sum of the peaks of all categories.
+		[[nodiscard]] ZKAPI MemoryStats total() const noexcept;
+
+	private:
+		struct Counters {
+			std::atomic_size_t current {0};
+			std::atomic_size_t peak {0};
+			std::atomic_size_t total {0};
+			std::atomic_size_t allocations {0};
+		};
+
+		MemoryResource* _m_upstream;
+		Counters _m_counters[MEMORY_CATEGORY_COUNT];
+	};
+} // namespace zenkit
@@ -4,9 +4,12 @@
 #include "zenkit/Boxes.hh"
 #include "zenkit/Date.hh"
 #include "zenkit/Library.hh"
+#include "zenkit/LightMapAtlas.hh"
 #include "zenkit/Material.hh"
+#include "zenkit/MeshBuffers.hh"
 #include "zenkit/Texture.hh"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,6 +17,7 @@
 namespace zenkit {
 	class Read;
 	class Write;
+	struct MeshTile;
 
 	/// \brief Represents a light map.
 	struct LightMap {
@@ -88,9 +92,71 @@ namespace zenkit {
 		ZKAPI void load(Read* r, std::vector<std::uint32_t> const& leaf_polygons, bool force_wide_indices);
 		ZKAPI void save(Write* w, GameVersion version) const;
 
+		/// \brief Interns #materials in a registry and stores their handles in #material_handles.
+		///
+		/// <p>Unlike MultiResolutionMesh, the mesh keeps its own copies of the materials, since polygons and
+		/// MeshTile refer to them by index. A world mesh only contains each of its materials once.</p>
+		///
+		/// \param registry The registry to intern the materials in.
+		/// \see WorldLoadOptions::materials
+		ZKAPI void intern_materials(MaterialRegistry& registry);
+
+		/// \brief Builds deduplicated, interleaved vertex and index buffers of #polygons grouped by material.
+		///
+		/// Vertices are built from #vertices and #features. Batches refer to #materials and are ordered by material
+		/// index; materials without any polygons are left out.
+		///
+		/// \param options Options for building the buffers.
+		/// \return The buffers of the mesh.
+		[[nodiscard]] ZKAPI MeshBuffers build_render_buffers(MeshBufferOptions const& options = {}) const;
+
+		/// \brief Groups the triangles of #polygons by material.
+		///
+		/// The triangles are sorted using a counting sort, which runs on multiple threads for large meshes.
+		/// Triangles with a material index outside of #materials are left out.
+		///
+		/// \return The triangles ordered by material and the range of each material.
+		[[nodiscard]] ZKAPI MeshMaterialBatches material_batches() const;
+
+		/// \brief Packs the textures of all #lightmaps into a few large pages.
+		///
+		/// Textures shared by several light maps are only copied once. Textures are decoded using
+		/// Texture::as_rgba8.
+		///
+		/// \param options Options for building the atlas.
+		/// \return The atlas.
+		/// \throws zenkit::UnsupportedFormatError if a light map texture can not be decoded.
+		[[nodiscard]] ZKAPI LightMapAtlas build_lightmap_atlas(LightMapAtlasOptions const& options = {}) const;
+
+		/// \brief Splits all polygons of this mesh into square tiles on the x-z-plane.
+		/// \param tile_size The edge length of each tile.
+		/// \return The non-empty tiles ordered by MeshTile::x and then by MeshTile::z.
+		/// \see #split_into_tiles(float, std::vector<std::uint32_t> const&) const
+		[[nodiscard]] ZKAPI std::vector<MeshTile> split_into_tiles(float tile_size) const;
+
+		/// \brief Splits the given polygons of this mesh into square tiles on the x-z-plane.
+		///
+		/// <p>Each polygon is assigned to the tile containing its center. Every tile holds a self-contained mesh
+		/// with only the vertices, features, materials and light maps used by its polygons, so that tiles can be
+		/// saved and streamed in independently of each other. Tile meshes are already triangulated.</p>
+		///
+		/// \param tile_size The edge length of each tile. If it is not positive, no tiles are returned.
+		/// \param polygons The indices of the polygons in #geometry to use, like BspTree::leaf_polygons for world
+		///                 meshes. Duplicates and invalid indices are ignored.
+		/// \return The non-empty tiles ordered by MeshTile::x and then by MeshTile::z.
+		[[nodiscard]] ZKAPI std::vector<MeshTile> split_into_tiles(float tile_size,
+		                                                           std::vector<std::uint32_t> const& polygons) const;
+
 	private:
+		friend class World;
 		ZKINT void triangulate(std::vector<std::uint32_t> const& leaf_polygons);
 
+		/// \brief Writes the triangulated mesh in its in-memory representation for World::save_cooked.
+		ZKINT void save_cooked(Write* w, GameVersion version) const;
+
+		/// \brief Reads a mesh written by #save_cooked.
+		ZKINT void load_cooked(Read* r);
+
 	public:
 		/// \brief The creation date of this mesh.
 		Date date {};
@@ -107,6 +173,11 @@ namespace zenkit {
 		/// \brief A list of materials used by this mesh.
 		std::vector<Material> materials {};
 
+		/// \brief The handle of each element of #materials in a MaterialRegistry or empty if the materials were
+		///        not interned.
+		/// \see #intern_materials
+		std::vector<std::uint32_t> material_handles {};
+
 		/// \brief A list of vertices of this mesh.
 		std::vector<Vec3> vertices {};
 
@@ -123,4 +194,19 @@ namespace zenkit {
 		/// \brief A list of polygons of this mesh.
 		PolygonList polygons {};
 	};
+
+	/// \brief A square part of a mesh created by Mesh::split_into_tiles.
+	struct MeshTile {
+		/// \brief The position of the tile along the x-axis, in multiples of the tile size.
+		std::int32_t x;
+
+		/// \brief The position of the tile along the z-axis, in multiples of the tile size.
+		std::int32_t z;
+
+		/// \brief The self-contained mesh of the tile. Its #Mesh::bbox tightly encloses its vertices.
+		Mesh mesh;
+
+		/// \brief For each polygon in Mesh::geometry of #mesh, the index of the polygon in the original mesh.
+		std::vector<std::uint32_t> polygons;
+	};
 } // namespace zenkit
@@ -0,0 +1,170 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstdint>
+#include <vector>
+
+namespace zenkit {
+	/// \brief An interleaved vertex of MeshBuffers, laid out so that it can be uploaded to the GPU as is.
+	struct MeshBufferVertex {
+		Vec3 position;
+		Vec3 normal;
+		Vec2 texture;
+
+		/// \brief The light color of the vertex, see VertexFeature::light. White for meshes without vertex colors.
+		std::uint32_t color;
+	};
+
+	/// \brief A range of MeshBuffers::indices drawn using a single material.
+	struct MeshBufferBatch {
+		/// \brief The index of the material. For Mesh, this is an index into Mesh::materials and for
+		///        MultiResolutionMesh an index into MultiResolutionMesh::sub_meshes.
+		std::uint32_t material;
+
+		/// \brief The index of the first index of the batch.
+		std::uint32_t index_offset;
+
+		/// \brief The number of indices of the batch. Always a multiple of 3.
+		std::uint32_t index_count;
+	};
+
+	/// \brief Options for building MeshBuffers.
+	struct MeshBufferOptions {
+		/// \brief Whether to always emit 32-bit indices. Otherwise, 16-bit indices are used if all vertices can be
+		///        addressed using them.
+		bool force_wide_indices {false};
+
+		/// \brief Whether to reorder the triangles of each batch to make better use of the post-transform vertex
+		///        cache of the GPU. This makes building the buffers a bit slower.
+		bool optimize_vertex_cache {false};
+	};
+
+	/// \brief Deduplicated, interleaved vertex and index buffers of a mesh, grouped by material.
+	///
+	/// <p>All batches share a single vertex buffer. Exactly one of #indices16 and #indices32 is filled, depending
+	/// on the number of vertices and MeshBufferOptions::force_wide_indices.</p>
+	///
+	/// \see Mesh::build_render_buffers
+	/// \see MultiResolutionMesh::build_render_buffers
+	struct MeshBuffers {
+		std::vector<MeshBufferVertex> vertices;
+		std::vector<std::uint16_t> indices16;
+		std::vector<std::uint32_t> indices32;
+		std::vector<MeshBufferBatch> batches;
+
+		/// \return Whether #indices32 is used instead of #indices16.
+		[[nodiscard]] bool wide_indices() const noexcept {
+			return !indices32.empty();
+		}
+
+		/// \return The total number of indices.
+		[[nodiscard]] std::size_t index_count() const noexcept {
+			return indices16.size() + indices32.size();
+		}
+	};
+
+	/// \brief A level of detail of MeshLodChain.
+	struct MeshLod {
+		/// \brief The fraction of wedges kept in this level, see MultiResolutionMesh::build_lod.
+		float ratio;
+
+		/// \brief The index of the first batch of the level in MeshLodChain::buffers.
+		std::uint32_t batch_offset;
+
+		/// \brief The number of batches of the level.
+		std::uint32_t batch_count;
+	};
+
+	/// \brief Render buffers of several levels of detail of a mesh.
+	///
+	/// <p>All levels share the vertices of MeshBuffers::vertices. The batches of all levels are stored one level
+	/// after the other in MeshBuffers::batches, each with its own range of indices.</p>
+	///
+	/// \see MultiResolutionMesh::build_lod_chain
+	struct MeshLodChain {
+		MeshBuffers buffers;
+
+		/// \brief The levels of detail ordered from the most to the least detailed.
+		std::vector<MeshLod> levels;
+	};
+
+	/// \brief An interleaved vertex of SkinnedMeshBuffers, laid out so that it can be uploaded to the GPU as is.
+	///
+	/// <p>Soft-skin meshes store the position of each vertex relative to each node influencing it instead of a
+	/// single bind-pose position. A vertex shader computes the skinned position as the sum of
+	/// `weights[i] * (transform[nodes[i]] * positions[i])` over all four influences, where `transform` holds the
+	/// model-space transforms of the nodes listed in SkinnedMeshBuffers::nodes.</p>
+	struct SkinnedMeshBufferVertex {
+		/// \brief The position of the vertex relative to each influencing node.
+		Vec3 positions[4];
+
+		/// \brief The weight of each influence. The weights add up to one. Unused influences have a weight of zero.
+		float weights[4];
+
+		/// \brief The normal of the vertex in the rest pose of the model.
+		Vec3 normal;
+		Vec2 texture;
+
+		/// \brief The index in SkinnedMeshBuffers::nodes of the node of each influence.
+		std::uint8_t nodes[4];
+	};
+
+	/// \brief Interleaved vertex and index buffers of a soft-skin mesh for skinning on the GPU.
+	///
+	/// <p>The buffers are organized like MeshBuffers, with one batch for each sub-mesh of the soft-skin mesh.</p>
+	///
+	/// \see SoftSkinMesh::build_skinned_buffers
+	/// \see ModelMesh::build_skinned_buffers
+	struct SkinnedMeshBuffers {
+		std::vector<SkinnedMeshBufferVertex> vertices;
+		std::vector<std::uint16_t> indices16;
+		std::vector<std::uint32_t> indices32;
+
+		/// \brief The batches of the buffers. MeshBufferBatch::material is an index into
+		///        MultiResolutionMesh::sub_meshes.
+		std::vector<MeshBufferBatch> batches;
+
+		/// \brief The index in ModelHierarchy::nodes of each node referenced by SkinnedMeshBufferVertex::nodes.
+		std::vector<std::int32_t> nodes;
+
+		/// \return Whether #indices32 is used instead of #indices16.
+		[[nodiscard]] bool wide_indices() const noexcept {
+			return !indices32.empty();
+		}
+
+		/// \return The total number of indices.
+		[[nodiscard]] std::size_t index_count() const noexcept {
+			return indices16.size() + indices32.size();
+		}
+	};
+
+	/// \brief A range of MeshMaterialBatches::triangles using a single material.
+	struct MeshMaterialBatch {
+		/// \brief The index of the material in Mesh::materials.
+		std::uint32_t material;
+
+		/// \brief The index of the first triangle of the batch in MeshMaterialBatches::triangles.
+		std::uint32_t offset;
+
+		/// \brief The number of triangles of the batch.
+		std::uint32_t count;
+	};
+
+	/// \brief The triangles of a mesh grouped by material.
+	///
+	/// <p>Unlike MeshBuffers, no vertex data is copied. The batches only describe the order in which to draw the
+	/// triangles of Mesh::polygons, so renderers can build one index buffer and issue one draw per material.</p>
+	///
+	/// \see Mesh::material_batches
+	struct MeshMaterialBatches {
+		/// \brief The indices of the triangles in Mesh::polygons, ordered by material. Triangles with the same
+		///        material keep their relative order.
+		std::vector<std::uint32_t> triangles;
+
+		/// \brief The batches ordered by material. Materials without any triangles are left out.
+		std::vector<MeshMaterialBatch> batches;
+	};
+} // namespace zenkit
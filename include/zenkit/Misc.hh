@@ -3,6 +3,7 @@
 #pragma once
 #include "zenkit/Library.hh"
 
+#include <cstdint>
 #include <string_view>
 
 namespace zenkit {
@@ -310,6 +311,74 @@ namespace zenkit {
 		}
 	};
 
+	/// \brief An affine transformation stored as the upper three rows of a 4x4 matrix.
+	///
+	/// <p>Each row contains three components of the rotation and scale followed by one component of the translation.
+	/// The omitted fourth row is always `(0, 0, 0, 1)`. This is the layout commonly used for bone matrices.</p>
+	struct Mat3x4 {
+		Vec4 rows[3] {};
+
+		constexpr Mat3x4() = default;
+		constexpr Mat3x4(Vec4 const& r0, Vec4 const& r1, Vec4 const& r2) : rows {r0, r1, r2} {}
+
+		/// \brief Takes the upper three rows of a matrix.
+		explicit constexpr Mat3x4(Mat4 const& m)
+		    : rows {Vec4 {m[0][0], m[1][0], m[2][0], m[3][0]},
+		            Vec4 {m[0][1], m[1][1], m[2][1], m[3][1]},
+		            Vec4 {m[0][2], m[1][2], m[2][2], m[3][2]}} {}
+
+		constexpr Vec4& operator[](unsigned index) {
+			return rows[index];
+		}
+
+		constexpr Vec4 const& operator[](unsigned index) const {
+			return rows[index];
+		}
+
+		constexpr bool operator==(Mat3x4 const& v) const {
+			return rows[0] == v.rows[0] && rows[1] == v.rows[1] && rows[2] == v.rows[2];
+		}
+
+		/// \brief Concatenates two transformations. The result applies \p v first.
+		[[nodiscard]] constexpr Mat3x4 operator*(Mat3x4 const& v) const {
+			Mat3x4 r {};
+			for (unsigned i = 0; i < 3; ++i) {
+				auto const& a = rows[i];
+				r.rows[i] = Vec4 {a.x * v.rows[0].x + a.y * v.rows[1].x + a.z * v.rows[2].x,
+				                  a.x * v.rows[0].y + a.y * v.rows[1].y + a.z * v.rows[2].y,
+				                  a.x * v.rows[0].z + a.y * v.rows[1].z + a.z * v.rows[2].z,
+				                  a.x * v.rows[0].w + a.y * v.rows[1].w + a.z * v.rows[2].w + a.w};
+			}
+			return r;
+		}
+
+		/// \brief Transforms a point, including the translation.
+		[[nodiscard]] constexpr Vec3 transform_point(Vec3 const& p) const {
+			return Vec3 {rows[0].x * p.x + rows[0].y * p.y + rows[0].z * p.z + rows[0].w,
+			             rows[1].x * p.x + rows[1].y * p.y + rows[1].z * p.z + rows[1].w,
+			             rows[2].x * p.x + rows[2].y * p.y + rows[2].z * p.z + rows[2].w};
+		}
+
+		/// \brief Transforms a direction, ignoring the translation.
+		[[nodiscard]] constexpr Vec3 transform_direction(Vec3 const& d) const {
+			return Vec3 {rows[0].x * d.x + rows[0].y * d.y + rows[0].z * d.z,
+			             rows[1].x * d.x + rows[1].y * d.y + rows[1].z * d.z,
+			             rows[2].x * d.x + rows[2].y * d.y + rows[2].z * d.z};
+		}
+
+		/// \return The transformation as a 4x4 matrix.
+		[[nodiscard]] constexpr Mat4 to_mat4() const {
+			return Mat4 {Vec4 {rows[0].x, rows[1].x, rows[2].x, 0},
+			             Vec4 {rows[0].y, rows[1].y, rows[2].y, 0},
+			             Vec4 {rows[0].z, rows[1].z, rows[2].z, 0},
+			             Vec4 {rows[0].w, rows[1].w, rows[2].w, 1}};
+		}
+
+		constexpr static Mat3x4 identity() {
+			return Mat3x4 {Vec4 {1, 0, 0, 0}, Vec4 {0, 1, 0, 0}, Vec4 {0, 0, 1, 0}};
+		}
+	};
+
 	/// \brief Tests whether two strings are equal when ignoring case.
 	///
 	/// Internally, uses std::tolower to compare the strings character by character.
@@ -327,4 +396,12 @@ namespace zenkit {
 	/// \param b Another string.
 	/// \return ``true`` if \p a is lexicographically less than \p b.
 	ZKAPI bool icompare(std::string_view a, std::string_view b);
+
+	/// \brief Hashes a string ignoring case.
+	///
+	/// Strings which are equal according to #iequals have the same hash.
+	///
+	/// \param s A string.
+	/// \return The 64-bit FNV-1a hash of the lower-case version of \p s.
+	ZKAPI std::uint64_t ihash(std::string_view s) noexcept;
 } // namespace zenkit
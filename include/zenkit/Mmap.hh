@@ -22,11 +22,65 @@ namespace zenkit {
 			return _m_size;
 		}
 
+		/// \brief Hints to the operating system that the given range of the mapping will be needed soon.
+		///
+		/// The pages are read in asynchronously. The range is clamped to the mapping. This is only a hint and
+		/// may be ignored by the platform.
+		///
+		/// \param offset The offset of the first byte to prefetch.
+		/// \param len The number of bytes to prefetch.
+		void prefetch(std::size_t offset, std::size_t len) const noexcept;
+
+		/// \brief Hints to the operating system that the mapping will be accessed sequentially.
+		void advise_sequential() const noexcept;
+
 	private:
 		std::byte const* _m_data;
 		std::size_t _m_size;
 
 		void* _m_platform_handle {nullptr};
 	};
+
+	/// \brief A writable memory mapping of a file which can be grown on demand.
+	///
+	/// The file is created or truncated when the mapping is constructed. On destruction, the file is truncated to
+	/// the size set using MutableMmap::truncate, which defaults to the size of the mapping.
+	class MutableMmap {
+	public:
+		MutableMmap(std::filesystem::path const& path, std::size_t initial_size);
+
+		MutableMmap(MutableMmap const&) = delete;
+		MutableMmap(MutableMmap&&) noexcept;
+
+		~MutableMmap() noexcept;
+
+		/// \brief Grows the underlying file and the mapping to the given size.
+		/// \note Invalidates all pointers previously obtained using MutableMmap::data.
+		/// \throws std::runtime_error if the file cannot be resized or re-mapped.
+		void resize(std::size_t size);
+
+		/// \brief Sets the size the file should have once the mapping is closed.
+		void truncate(std::size_t size) noexcept {
+			_m_final_size = size;
+		}
+
+		/// \brief Writes all modified pages back to the file.
+		void sync() noexcept;
+
+		[[nodiscard]] std::byte* data() const noexcept {
+			return _m_data;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return _m_size;
+		}
+
+	private:
+		std::byte* _m_data {nullptr};
+		std::size_t _m_size {0};
+		std::size_t _m_final_size {0};
+
+		void* _m_platform_handle {nullptr};
+	};
 #endif
 } // namespace zenkit
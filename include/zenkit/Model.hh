@@ -15,6 +15,7 @@ namespace zenkit {
 	class Model {
 	public:
 		ZKAPI void load(Read* r);
+		ZKAPI void load(Read* r, MultiResolutionMeshLoadOptions const& options);
 		ZKAPI void save(Write* w, GameVersion version) const;
 
 		/// \brief The zenkit::ModelHierarchy associated with this model.
@@ -1,15 +1,19 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "zenkit/AnimationEventIndex.hh"
 #include "zenkit/Boxes.hh"
 #include "zenkit/Date.hh"
 #include "zenkit/Library.hh"
 
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace zenkit {
 	class Read;
+	class ModelHierarchy;
 
 	/// \brief A single sample of an Animation.
 	///
@@ -25,6 +29,26 @@ namespace zenkit {
 		[[nodiscard]] ZKAPI bool operator==(AnimationSample const& other) const noexcept;
 	};
 
+	/// \brief A single sample of an animation as it is stored in animation files.
+	///
+	/// <p>Quantized samples take up 12 bytes instead of the 28 bytes of an AnimationSample. They are kept by
+	/// ModelAnimation::load if ModelAnimationLoadOptions::compact is set.</p>
+	///
+	/// \see http://phoenix.gothickit.dev/engine/formats/animation/#samples
+	struct QuantizedAnimationSample {
+		/// \brief The x, y and z components of the rotation. The w component is reconstructed when decoding.
+		std::uint16_t rotation[3];
+
+		/// \brief The components of the position, relative to the smallest position component of the animation.
+		std::uint16_t position[3];
+
+		/// \brief Converts the sample to an AnimationSample.
+		/// \param scale The scaling factor of the positions, see ModelAnimation::sample_position_scale.
+		/// \param minimum The smallest position component, see ModelAnimation::sample_position_min.
+		/// \return The decoded sample.
+		[[nodiscard]] ZKAPI AnimationSample decode(float scale, float minimum) const noexcept;
+	};
+
 	/// \brief Types of animation events.
 	enum class AnimationEventType : std::uint32_t {
 		/// \brief Also known as "*eventTag"
@@ -100,10 +124,142 @@ namespace zenkit {
 		float probability;
 	};
 
+	/// \brief Options for loading a ModelAnimation.
+	/// \see ModelAnimation::load
+	struct ModelAnimationLoadOptions {
+		/// \brief Set to `true` to keep the samples quantized in ModelAnimation::quantized_samples instead of
+		///        decoding them into ModelAnimation::samples. Use ModelAnimation::decode_frame to decode them later.
+		bool compact = false;
+	};
+
+	/// \brief Maps the nodes of an animation to the nodes of a model hierarchy it was not made for.
+	/// \see ModelAnimation::remap_nodes
+	struct AnimationNodeRemap {
+		/// \brief Marks nodes which do not exist in the target hierarchy.
+		static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+		/// \brief The checksum of the hierarchy the animation was made for.
+		std::uint32_t source_checksum {};
+
+		/// \brief The checksum of the hierarchy the nodes were mapped to.
+		std::uint32_t target_checksum {};
+
+		/// \brief For each entry of ModelAnimation::node_indices, the index of the node with the same name in the
+		///        target hierarchy or #NONE.
+		std::vector<std::uint32_t> nodes {};
+	};
+
 	/// \brief Represents a model animation.
 	class ModelAnimation {
 	public:
 		ZKAPI void load(Read* r);
+		ZKAPI void load(Read* r, ModelAnimationLoadOptions const& options);
+
+		/// \return `true` if the samples are stored in #quantized_samples instead of #samples.
+		[[nodiscard]] bool is_compact() const noexcept {
+			return !quantized_samples.empty();
+		}
+
+		/// \brief Decodes the samples of all nodes of a single frame.
+		///
+		/// <p>Works for both, compact and regular animations. For compact animations, the samples are
+		/// decoded from #quantized_samples, which is intended to be done during playback.</p>
+		///
+		/// \param frame The index of the frame to decode.
+		/// \param out Receives #node_count samples, one for each node in #node_indices.
+		/// \return `false` if \p frame is out of range. \p out is left unchanged in that case.
+		ZKAPI bool decode_frame(std::uint32_t frame, AnimationSample* out) const noexcept;
+
+		/// \brief Decodes the sample of a single node in a single frame.
+		/// \param frame The index of the frame.
+		/// \param node The index of the node in #node_indices.
+		/// \return The sample or a default-constructed one if either index is out of range.
+		[[nodiscard]] ZKAPI AnimationSample sample(std::uint32_t frame, std::uint32_t node) const noexcept;
+
+		/// \brief Computes the pose of all nodes at the given point in time.
+		///
+		/// <p>The two frames around \p time are interpolated, linearly for the positions and using normalized linear
+		/// interpolation for the rotations.</p>
+		///
+		/// \param time The time since the start of the animation in seconds.
+		/// \param out Receives #node_count samples, one for each node in #node_indices.
+		/// \param loop Set to `true` to wrap \p time around the end of the animation and to interpolate between the
+		///             last and the first frame. Otherwise, \p time is clamped to the duration of the animation.
+		ZKAPI void sample_pose(float time, AnimationSample* out, bool loop = true) const noexcept;
+
+		/// \brief Blends the pose of this animation at the given point in time into the pose of a skeleton.
+		///
+		/// <p>Animations of higher layers override the nodes they animate in animations of lower layers. To play
+		/// multiple animations at once, apply them to the same pose in order of ascending #layer.</p>
+		///
+		/// \param time The time since the start of the animation in seconds.
+		/// \param weight How much of the animation to blend in. `1` replaces the affected nodes of \p pose.
+		/// \param pose The pose of the skeleton, one sample for each node of the ModelHierarchy, indexed like
+		///             ModelHierarchy::nodes. Only the nodes in #node_indices are changed.
+		/// \param pose_size The number of samples in \p pose. Nodes beyond it are ignored.
+		/// \param loop Whether to loop the animation, see #sample_pose.
+		ZKAPI void apply_layer(float time,
+		                       float weight,
+		                       AnimationSample* pose,
+		                       std::size_t pose_size,
+		                       bool loop = true) const noexcept;
+
+		/// \brief Blends the pose of this animation into the pose of a skeleton it was not made for.
+		///
+		/// <p>Works like #apply_layer, except that the nodes of \p pose are indexed like the nodes of the target
+		/// hierarchy of \p remap.</p>
+		///
+		/// \param remap The node mapping returned by #remap_nodes.
+		/// \see #apply_layer
+		ZKAPI void apply_layer(float time,
+		                       float weight,
+		                       AnimationSample* pose,
+		                       std::size_t pose_size,
+		                       AnimationNodeRemap const& remap,
+		                       bool loop = true) const noexcept;
+
+		/// \brief Maps #node_indices to the nodes with the same names in another hierarchy.
+		///
+		/// <p>Node indices in animations refer to the hierarchy they were made for. To play an animation on a
+		/// different skeleton with some of the same node names, the indices have to be mapped by name, which is
+		/// done once and cached in the animation. The cache is keyed by the checksums of both hierarchies, so
+		/// repeated calls with the same pair of hierarchies return the same mapping. This is thread-safe.</p>
+		///
+		/// <p>The cache assumes that hierarchies with the same checksum have the same nodes. Mappings involving a
+		/// hierarchy with a checksum of 0 are therefore never cached. The cache is cleared by #load, but not when
+		/// #node_indices is changed directly.</p>
+		///
+		/// \param source The hierarchy the animation was made for. Its checksum usually matches #checksum.
+		/// \param target The hierarchy to map the nodes to.
+		/// \return The node mapping.
+		[[nodiscard]] ZKAPI std::shared_ptr<AnimationNodeRemap const> remap_nodes(ModelHierarchy const& source,
+		                                                                          ModelHierarchy const& target) const;
+
+		/// \brief Blends two poses.
+		/// \param a The first pose.
+		/// \param b The second pose.
+		/// \param count The number of samples in each pose.
+		/// \param weight The weight of \p b. `0` yields \p a and `1` yields \p b.
+		/// \param out Receives \p count samples. May be the same as \p a or \p b.
+		ZKAPI static void blend_poses(AnimationSample const* a,
+		                              AnimationSample const* b,
+		                              std::size_t count,
+		                              float weight,
+		                              AnimationSample* out) noexcept;
+
+		/// \brief Finds the events which fire after frame \p a up to and including frame \p b.
+		/// \return The events in the range, ordered by frame. Nothing is allocated.
+		/// \see AnimationEventIndex::query
+		[[nodiscard]] AnimationEventRange<AnimationEvent> events_in_range(std::int64_t a,
+		                                                                  std::int64_t b) const noexcept {
+			return _m_event_index.query(this->events, a, b);
+		}
+
+		/// \brief Rebuilds the index used by #events_in_range. Called by #load and needs to be called again
+		///        after modifying #events.
+		void index_events() {
+			_m_event_index.build(this->events);
+		}
 
 		/// \brief The name of the animation
 		std::string name {};
@@ -150,9 +306,14 @@ namespace zenkit {
 		/// \brief The original model script snippet this animation was generated from.
 		std::string source_script {};
 
-		/// \brief The list of animation samples of this animation.
+		/// \brief The list of animation samples of this animation. Empty if it was loaded in compact mode.
 		std::vector<AnimationSample> samples {};
 
+		/// \brief The list of quantized animation samples of this animation if it was loaded in compact mode,
+		///        ordered like #samples. Empty otherwise.
+		/// \see ModelAnimationLoadOptions::compact
+		std::vector<QuantizedAnimationSample> quantized_samples {};
+
 		/// \brief The list of animation events of this animation.
 		/// \warning Though I could not find any source specifically mentioning this, all animation file I have seen
 		///          **do not contain any events**, meaning **this vector will always be empty**. You should retrieve
@@ -161,5 +322,94 @@ namespace zenkit {
 
 		/// \brief A list of model hierarchy node indices.
 		std::vector<std::uint32_t> node_indices;
+
+	private:
+		void apply_layer(float time,
+		                 float weight,
+		                 AnimationSample* pose,
+		                 std::size_t pose_size,
+		                 std::uint32_t const* nodes,
+		                 std::size_t node_count,
+		                 bool loop) const noexcept;
+
+		AnimationEventIndex<AnimationEvent> _m_event_index;
+		mutable std::shared_ptr<AnimationNodeRemap const> _m_node_remap;
+	};
+
+	/// \brief A ModelAnimation bound to the nodes of a ModelHierarchy.
+	///
+	/// <p>Binding an animation resolves which node of the hierarchy each animated node drives once, including
+	/// checking that the animation was made for the hierarchy. Applying the animation afterwards only gathers the
+	/// samples of each bound node, without any further lookups. This is useful when animations are shared between
+	/// hierarchies with slightly different nodes, such as the skeletons of modded creatures.</p>
+	///
+	/// <p>The binding refers to the animation it was created for, which must outlive it.</p>
+	class AnimationBinding {
+	public:
+		/// \brief Marks nodes of the hierarchy which are not driven by the animation.
+		static constexpr std::uint32_t NONE = AnimationNodeRemap::NONE;
+
+		AnimationBinding() = default;
+
+		/// \brief Binds an animation to the hierarchy it was made for.
+		///
+		/// <p>If the checksum of \p target does not match ModelAnimation::checksum, a warning is logged and no
+		/// nodes are bound. Use the other constructor to bind animations to other hierarchies.</p>
+		///
+		/// \param animation The animation to bind.
+		/// \param target The hierarchy to bind the animation to.
+		ZKAPI AnimationBinding(ModelAnimation const& animation, ModelHierarchy const& target);
+
+		/// \brief Binds an animation to a hierarchy by the names of the nodes it animates.
+		///
+		/// <p>If \p target is the hierarchy the animation was made for, its node indices are used directly.
+		/// Otherwise, the nodes are mapped by name using ModelAnimation::remap_nodes. Nodes missing in
+		/// \p target are not bound.</p>
+		///
+		/// \param animation The animation to bind.
+		/// \param source The hierarchy the animation was made for.
+		/// \param target The hierarchy to bind the animation to.
+		ZKAPI AnimationBinding(ModelAnimation const& animation,
+		                       ModelHierarchy const& source,
+		                       ModelHierarchy const& target);
+
+		/// \brief Blends the pose of the animation at the given point in time into a pose of the target hierarchy.
+		///
+		/// \param time The time since the start of the animation in seconds.
+		/// \param weight How much of the animation to blend in. `1` replaces the bound nodes of \p pose.
+		/// \param pose One sample for each node of the target hierarchy. Only bound nodes are changed.
+		/// \param loop Whether to loop the animation, see ModelAnimation::sample_pose.
+		/// \see ModelAnimation::apply_layer
+		ZKAPI void apply_layer(float time, float weight, AnimationSample* pose, bool loop = true) const noexcept;
+
+		/// \return The index in ModelAnimation::node_indices of the channel driving the given node of the target
+		///         hierarchy or #NONE if it is not driven by the animation.
+		[[nodiscard]] std::uint32_t channel(std::uint32_t node) const noexcept {
+			return node < _m_channels.size() ? _m_channels[node] : NONE;
+		}
+
+		/// \return The number of nodes of the target hierarchy driven by the animation.
+		[[nodiscard]] std::uint32_t bound_node_count() const noexcept {
+			return _m_bound_node_count;
+		}
+
+		/// \return The number of nodes of the target hierarchy.
+		[[nodiscard]] std::size_t node_count() const noexcept {
+			return _m_channels.size();
+		}
+
+		/// \return The animation this binding was created for or `nullptr` if it is empty.
+		[[nodiscard]] ModelAnimation const* animation() const noexcept {
+			return _m_animation;
+		}
+
+	private:
+		void bind(std::uint32_t const* nodes, std::size_t count);
+
+		ModelAnimation const* _m_animation {nullptr};
+
+		/// \brief For each node of the target hierarchy, the index of the channel driving it or #NONE.
+		std::vector<std::uint32_t> _m_channels;
+		std::uint32_t _m_bound_node_count {0};
 	};
 } // namespace zenkit
@@ -5,11 +5,15 @@
 #include "zenkit/Date.hh"
 #include "zenkit/Library.hh"
 
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace zenkit {
 	class Read;
+	struct AnimationSample;
 
 	/// \brief A node in the hierarchy tree.
 	struct ModelHierarchyNode {
@@ -32,6 +36,49 @@ namespace zenkit {
 		ZKAPI void load(Read* r);
 		ZKAPI void save(Write* w) const;
 
+		/// \brief Rebuilds #evaluation_order from #nodes.
+		///
+		/// This is done when loading the hierarchy. If #nodes is changed afterwards, this function must be called
+		/// again. If the size of #evaluation_order does not match #nodes, each evaluation builds a temporary order
+		/// instead.
+		ZKAPI void build_evaluation_order();
+
+		/// \brief Rebuilds the index used by #find_node from #nodes.
+		///
+		/// This is done when loading the hierarchy. If the nodes are changed afterwards, this function must be
+		/// called again. Until then, #find_node falls back to comparing the names of all nodes if the number of
+		/// nodes changed.
+		ZKAPI void build_node_index();
+
+		/// \brief Finds a node by its name, ignoring case.
+		/// \param name The name of the node to find.
+		/// \return The index of the node in #nodes or `std::nullopt` if there is none.
+		[[nodiscard]] ZKAPI std::optional<std::uint32_t> find_node(std::string_view name) const noexcept;
+
+		/// \brief Computes the rest pose of the hierarchy from the transforms of its nodes.
+		/// \param out Receives one sample for each node, indexed like #nodes.
+		ZKAPI void compute_rest_pose(AnimationSample* out) const noexcept;
+
+		/// \brief Converts a pose to transformation matrices relative to the parent of each node.
+		/// \param pose One sample for each node, indexed like #nodes. See ModelAnimation::apply_layer.
+		/// \param out Receives one transform for each node.
+		ZKAPI void compute_local_transforms(AnimationSample const* pose, Mat3x4* out) const noexcept;
+
+		/// \brief Computes the model-space transformation of each node from its transformation relative to its
+		///        parent.
+		///
+		/// <p>Nodes are processed in #evaluation_order, so the transform of each parent is complete before it is
+		/// applied to its children. Nodes without a valid parent are treated as roots.</p>
+		///
+		/// \param local One transform relative to the parent for each node, indexed like #nodes.
+		/// \param out Receives one model-space transform for each node. Must not overlap \p local.
+		ZKAPI void compute_world_transforms(Mat3x4 const* local, Mat3x4* out) const;
+
+		/// \brief Computes the model-space transformation of each node for the given pose.
+		/// \param pose One sample for each node, indexed like #nodes.
+		/// \param out Receives one model-space transform for each node.
+		ZKAPI void compute_world_transforms(AnimationSample const* pose, Mat3x4* out) const;
+
 		/// \brief The list of nodes this hierarchy consists of.
 		std::vector<ModelHierarchyNode> nodes {};
 
@@ -47,7 +94,14 @@ namespace zenkit {
 		/// \brief The checksum of this hierarchy.
 		std::uint32_t checksum;
 
+		/// \brief The indices of all nodes ordered so that each parent comes before its children.
+		std::vector<std::uint16_t> evaluation_order {};
+
 		Date source_date;
 		std::string source_path;
+
+	private:
+		/// \brief The indices of the nodes ordered by the ihash of their name.
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> _m_node_names;
 	};
 } // namespace zenkit
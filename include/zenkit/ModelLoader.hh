@@ -0,0 +1,97 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+#include "zenkit/Model.hh"
+#include "zenkit/ModelAnimation.hh"
+#include "zenkit/ModelHierarchy.hh"
+#include "zenkit/ModelMesh.hh"
+#include "zenkit/ModelScript.hh"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace zenkit {
+	class Vfs;
+
+	/// \brief Options for loading models using a ModelLoader.
+	struct ModelLoaderOptions {
+		/// \brief The maximum number of threads to load the files of a model on. Set to `0` to use all threads of
+		///        the ::get_executor.
+		std::uint32_t thread_count {0};
+
+		/// \brief Set to `false` to skip loading the animations of the model script.
+		bool load_animations {true};
+
+		/// \brief Options passed to ModelAnimation::load.
+		ModelAnimationLoadOptions animation {};
+
+		/// \brief Options passed to ModelMesh::load and Model::load. Set MultiResolutionMeshLoadOptions::materials to share the
+		///        materials of all meshes.
+		MultiResolutionMeshLoadOptions mesh {};
+	};
+
+	/// \brief A model script together with all files it references.
+	///
+	/// <p>Files which could not be found or loaded are `nullptr`. All files are shared with other models loaded by
+	/// the same ModelLoader which reference them.</p>
+	struct LoadedModel {
+		std::shared_ptr<ModelScript const> script;
+
+		/// \brief The hierarchy of the model, loaded from the `MDH` or `MDL` file named like the model script.
+		std::shared_ptr<ModelHierarchy const> hierarchy;
+
+		/// \brief The mesh of the skeleton or `nullptr` if MdsSkeleton::disable_mesh is set.
+		std::shared_ptr<ModelMesh const> mesh;
+
+		/// \brief For each element of ModelScript::meshes, the mesh loaded from the matching `MDM` file.
+		std::vector<std::shared_ptr<ModelMesh const>> meshes;
+
+		/// \brief For each element of ModelScript::animations, the animation loaded from the matching `MAN` file.
+		std::vector<std::shared_ptr<ModelAnimation const>> animations;
+	};
+
+	/// \brief Loads model scripts and all the files they reference from a Vfs.
+	///
+	/// <p>For a model script `NAME.MDS`, the hierarchy is loaded from `NAME.MDH`, falling back to `NAME.MDL`, and
+	/// every animation `ANI` is loaded from `NAME-ANI.MAN`. Meshes are loaded from `MDM` files named like the `ASC`
+	/// files given in the script. If a compiled `NAME.MSB` exists, it is preferred over the script source.</p>
+	///
+	/// <p>The files of a model are loaded in parallel. Every file is only loaded once and then shared between all
+	/// models referencing it for as long as the loader lives or until #clear is called. The loader may be used
+	/// from multiple threads at once.</p>
+	class ModelLoader {
+	public:
+		/// \brief Creates a loader for files from the given Vfs. The Vfs must outlive the loader and may not be
+		///        modified while models are being loaded.
+		ZKAPI explicit ModelLoader(Vfs const& vfs, ModelLoaderOptions const& options = {});
+
+		/// \brief Loads a model script and all files referenced by it.
+		/// \param name The name of the model script with or without the `MDS` or `MSB` extension.
+		/// \return The loaded model. LoadedModel::script is `nullptr` if the model script was not found.
+		[[nodiscard]] ZKAPI LoadedModel load(std::string_view name);
+
+		/// \brief Releases the files kept for sharing with models loaded later. Files still used by a LoadedModel
+		///        stay alive until the model is destroyed.
+		ZKAPI void clear();
+
+	private:
+		template <typename T>
+		using Cache = std::unordered_map<std::string, std::shared_ptr<T const>>;
+
+		Vfs const* _m_vfs;
+		ModelLoaderOptions _m_options;
+
+		std::mutex _m_lock;
+		Cache<ModelScript> _m_scripts;
+		Cache<ModelHierarchy> _m_hierarchies;
+		Cache<ModelMesh> _m_meshes;
+		Cache<ModelAnimation> _m_animations;
+		Cache<Model> _m_models;
+	};
+} // namespace zenkit
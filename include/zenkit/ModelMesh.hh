@@ -20,8 +20,16 @@ namespace zenkit {
 	class ModelMesh {
 	public:
 		ZKAPI void load(Read* r);
+		ZKAPI void load(Read* r, MultiResolutionMeshLoadOptions const& options);
 		ZKAPI void save(Write* w, GameVersion version) const;
 
+		/// \brief Builds vertex and index buffers for skinning each soft-skin mesh on the GPU.
+		/// \param options Options for building the buffers.
+		/// \return The buffers of each element of #meshes.
+		/// \see SoftSkinMesh::build_skinned_buffers
+		[[nodiscard]] ZKAPI std::vector<SkinnedMeshBuffers>
+		build_skinned_buffers(MeshBufferOptions const& options = {}) const;
+
 		/// \brief A list of soft-skin meshes associated with this model mesh.
 		std::vector<SoftSkinMesh> meshes {};
 
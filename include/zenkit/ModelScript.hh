@@ -1,6 +1,7 @@
 // Copyright © 2022-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "zenkit/AnimationEventIndex.hh"
 #include "zenkit/Library.hh"
 
 #include <cstdint>
@@ -9,6 +10,7 @@
 
 namespace zenkit {
 	class Read;
+	class Write;
 
 	enum class MdsEventType : uint8_t {
 		UNKNOWN = 0,
@@ -219,6 +221,72 @@ namespace zenkit {
 		std::vector<MdsSoundEffectGround> sfx_ground {};
 		std::vector<MdsMorphAnimation> morph {};
 		std::vector<MdsCameraTremor> tremors {};
+
+		/// \brief Frame-sorted indices of all event lists of this animation.
+		/// \see #index_events
+		struct {
+			AnimationEventIndex<MdsEventTag> events;
+			AnimationEventIndex<MdsParticleEffect> pfx;
+			AnimationEventIndex<MdsParticleEffectStop> pfx_stop;
+			AnimationEventIndex<MdsSoundEffect> sfx;
+			AnimationEventIndex<MdsSoundEffectGround> sfx_ground;
+			AnimationEventIndex<MdsMorphAnimation> morph;
+			AnimationEventIndex<MdsCameraTremor> tremors;
+		} event_index {};
+
+		/// \brief Rebuilds #event_index. Called by ModelScript::load and needs to be called again after modifying
+		///        any of the event lists.
+		void index_events() {
+			event_index.events.build(events);
+			event_index.pfx.build(pfx);
+			event_index.pfx_stop.build(pfx_stop);
+			event_index.sfx.build(sfx);
+			event_index.sfx_ground.build(sfx_ground);
+			event_index.morph.build(morph);
+			event_index.tremors.build(tremors);
+		}
+
+		/// \brief Finds the event tags which fire after frame \p a up to and including frame \p b.
+		/// \return The events in the range, ordered by frame. Nothing is allocated.
+		/// \see AnimationEventIndex::query
+		[[nodiscard]] AnimationEventRange<MdsEventTag> events_in_range(std::int64_t a, std::int64_t b) const noexcept {
+			return event_index.events.query(events, a, b);
+		}
+
+		/// \copydoc events_in_range
+		[[nodiscard]] AnimationEventRange<MdsParticleEffect> pfx_in_range(std::int64_t a,
+		                                                                  std::int64_t b) const noexcept {
+			return event_index.pfx.query(pfx, a, b);
+		}
+
+		/// \copydoc events_in_range
+		[[nodiscard]] AnimationEventRange<MdsParticleEffectStop> pfx_stop_in_range(std::int64_t a,
+		                                                                           std::int64_t b) const noexcept {
+			return event_index.pfx_stop.query(pfx_stop, a, b);
+		}
+
+		/// \copydoc events_in_range
+		[[nodiscard]] AnimationEventRange<MdsSoundEffect> sfx_in_range(std::int64_t a, std::int64_t b) const noexcept {
+			return event_index.sfx.query(sfx, a, b);
+		}
+
+		/// \copydoc events_in_range
+		[[nodiscard]] AnimationEventRange<MdsSoundEffectGround> sfx_ground_in_range(std::int64_t a,
+		                                                                           std::int64_t b) const noexcept {
+			return event_index.sfx_ground.query(sfx_ground, a, b);
+		}
+
+		/// \copydoc events_in_range
+		[[nodiscard]] AnimationEventRange<MdsMorphAnimation> morph_in_range(std::int64_t a,
+		                                                                    std::int64_t b) const noexcept {
+			return event_index.morph.query(morph, a, b);
+		}
+
+		/// \copydoc events_in_range
+		[[nodiscard]] AnimationEventRange<MdsCameraTremor> tremors_in_range(std::int64_t a,
+		                                                                    std::int64_t b) const noexcept {
+			return event_index.tremors.query(tremors, a, b);
+		}
 	};
 
 	/// \brief The `aniAlias` tag
@@ -264,6 +332,14 @@ namespace zenkit {
 	public:
 		ZKAPI void load(Read* r);
 
+		/// \brief Saves the model script in its binary (`MSB`) form.
+		///
+		/// <p>Loading binary model scripts is a lot faster than parsing their source. Scripts parsed from `MDS`
+		/// files can be saved using this function and cached, so that later loads can take the fast path.</p>
+		///
+		/// \param w The stream to write the script to.
+		ZKAPI void save(Write* w) const;
+
 	private:
 		ZKINT void load_binary(Read* r);
 		ZKINT void load_source(Read* r);
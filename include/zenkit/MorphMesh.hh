@@ -22,8 +22,10 @@ namespace zenkit {
 		float blend_in;
 		float blend_out;
 
-		/// \brief The duration of the animation in seconds.
+		/// \brief The duration of the animation in milliseconds.
 		float duration;
+
+		/// \brief The number of frames played per millisecond.
 		float speed;
 		std::uint8_t flags;
 
@@ -37,6 +39,22 @@ namespace zenkit {
 		std::vector<Vec3> samples;
 	};
 
+	/// \brief An animation of a MorphMesh which is currently playing.
+	/// \see MorphMesh::evaluate
+	struct MorphAnimationState {
+		/// \brief The index of the animation in MorphMesh::animations.
+		std::uint32_t animation;
+
+		/// \brief The time since the animation was started in seconds.
+		float time;
+
+		/// \brief How much of the animation to apply. Use this to fade animations in and out.
+		float weight {1};
+
+		/// \brief Whether to wrap #time around the end of the animation. Otherwise, the last frame is held.
+		bool loop {true};
+	};
+
 	/// \brief A reference to a morph mesh source file.
 	struct MorphSource {
 		/// \brief The date of file creation.
@@ -54,6 +72,24 @@ namespace zenkit {
 	public:
 		ZKAPI void load(Read* r);
 
+		/// \brief Computes the positions of all vertices of the mesh while playing the given animations.
+		///
+		/// <p>The samples of each animation are offsets to #morph_positions. For each animation, the two frames
+		/// around its current time are interpolated and the result is scaled by its weight and added to the
+		/// vertices affected by the animation. Only those vertices are touched, so the cost depends on the size of
+		/// the animations and not on the size of the mesh.</p>
+		///
+		/// \param animations The animations to play. Invalid animation indices are ignored.
+		/// \param animation_count The number of elements in \p animations.
+		/// \param positions Receives one position for each element of #morph_positions.
+		ZKAPI void evaluate(MorphAnimationState const* animations,
+		                    std::size_t animation_count,
+		                    Vec3* positions) const noexcept;
+
+		/// \brief Computes the positions of all vertices of the mesh while playing the given animations.
+		/// \see #evaluate(MorphAnimationState const*, std::size_t, Vec3*) const
+		ZKAPI void evaluate(std::vector<MorphAnimationState> const& animations, std::vector<Vec3>& positions) const;
+
 		/// \brief The name of the mesh.
 		std::string name {};
 
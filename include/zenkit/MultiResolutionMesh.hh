@@ -4,6 +4,7 @@
 #include "zenkit/Boxes.hh"
 #include "zenkit/Library.hh"
 #include "zenkit/Material.hh"
+#include "zenkit/MeshBuffers.hh"
 
 #include <cstdint>
 #include <vector>
@@ -29,6 +30,65 @@ namespace zenkit {
 		std::uint16_t index;
 	};
 
+	/// \brief A vertex position quantized to 16 bits per component.
+	///
+	/// <p>Quantized positions take up 6 bytes instead of 12. Each component is stored relative to the smallest
+	/// component of all positions of the mesh, see MultiResolutionMesh::quantized_position_min and
+	/// MultiResolutionMesh::quantized_position_scale.</p>
+	struct QuantizedPosition {
+		std::uint16_t position[3];
+
+		/// \brief Quantizes a position.
+		/// \param position The position to quantize.
+		/// \param minimum The smallest position component of the mesh in each axis.
+		/// \param scale The size of one quantization step in each axis.
+		/// \return The quantized position.
+		[[nodiscard]] ZKAPI static QuantizedPosition
+		encode(Vec3 const& position, Vec3 const& minimum, Vec3 const& scale) noexcept;
+
+		/// \brief Converts the quantized position back to a Vec3, computing `position * scale + minimum`.
+		/// \param minimum The smallest position component of the mesh in each axis.
+		/// \param scale The size of one quantization step in each axis.
+		/// \return The decoded position.
+		[[nodiscard]] ZKAPI Vec3 decode(Vec3 const& minimum, Vec3 const& scale) const noexcept;
+	};
+
+	/// \brief A unit vector stored using the octahedral mapping, with 16-bit signed normalized components.
+	///
+	/// <p>Quantized normals take up 4 bytes instead of 12. The vector is projected onto an octahedron, which is
+	/// then unfolded into a square, so that shaders can decode it with a few instructions.</p>
+	struct QuantizedNormal {
+		std::int16_t oct[2];
+
+		/// \brief Quantizes a normal vector. The vector does not need to be normalized.
+		/// \param normal The vector to quantize.
+		/// \return The quantized vector.
+		[[nodiscard]] ZKAPI static QuantizedNormal encode(Vec3 const& normal) noexcept;
+
+		/// \brief Converts the quantized vector back to a normalized Vec3.
+		/// \return The decoded vector.
+		[[nodiscard]] ZKAPI Vec3 decode() const noexcept;
+	};
+
+	/// \brief A MeshWedge with a quantized normal and half-precision texture coordinates.
+	///
+	/// <p>Quantized wedges take up 10 bytes instead of 24. The texture coordinates are stored as IEEE 754
+	/// half-precision floats, which GPUs can read natively.</p>
+	struct QuantizedMeshWedge {
+		QuantizedNormal normal;
+		std::uint16_t texture[2];
+		std::uint16_t index;
+
+		/// \brief Quantizes a wedge.
+		/// \param wedge The wedge to quantize.
+		/// \return The quantized wedge.
+		[[nodiscard]] ZKAPI static QuantizedMeshWedge encode(MeshWedge const& wedge) noexcept;
+
+		/// \brief Converts the quantized wedge back to a MeshWedge.
+		/// \return The decoded wedge.
+		[[nodiscard]] ZKAPI MeshWedge decode() const noexcept;
+	};
+
 	struct MeshPlane {
 		float distance;
 		Vec3 normal;
@@ -55,9 +115,32 @@ namespace zenkit {
 		MeshSection edge_scores;
 	};
 
+	/// \brief Options for loading a MultiResolutionMesh.
+	/// \see MultiResolutionMesh::load
+	struct MultiResolutionMeshLoadOptions {
+		/// \brief Set to `true` to skip loading SubMesh::triangle_planes and SubMesh::triangle_plane_indices.
+		bool skip_planes = false;
+
+		/// \brief Set to `true` to skip loading the progressive mesh data of the sub-meshes, that is
+		///        SubMesh::triangle_edges, SubMesh::edges, SubMesh::edge_scores and SubMesh::wedge_map.
+		/// \note Without the wedge map, MultiResolutionMesh::build_lod keeps all sub-meshes at full detail.
+		bool skip_progressive = false;
+
+		/// \brief Set to `true` to store the mesh in compact mode, see MultiResolutionMesh::compact.
+		bool compact = false;
+
+		/// \brief The registry to intern the materials of the mesh in or `nullptr` to store copies in the mesh.
+		///
+		/// If set, MultiResolutionMesh::material_handles is filled instead of MultiResolutionMesh::materials and
+		/// SubMesh::mat, which are left empty. Meshes loaded this way cannot be saved. The registry has to outlive
+		/// the mesh.
+		MaterialRegistry* materials {nullptr};
+	};
+
 	/// \brief Represents a sub-mesh.
 	struct SubMesh {
-		/// \brief The material of this sub mesh.
+		/// \brief The material of this sub mesh. Empty if the mesh was loaded into a MaterialRegistry.
+		/// \see MultiResolutionMeshLoadOptions::materials
 		Material mat;
 
 		std::vector<MeshTriangle> triangles;
@@ -70,7 +153,11 @@ namespace zenkit {
 		std::vector<float> edge_scores;
 		std::vector<std::uint16_t> wedge_map;
 
-		ZKINT void load(Read* r, SubMeshSection const& map);
+		/// \brief The quantized wedges of the sub-mesh if the mesh is stored in compact mode, empty otherwise.
+		/// \see MultiResolutionMesh::compact
+		std::vector<QuantizedMeshWedge> quantized_wedges;
+
+		ZKINT void load(Read* r, SubMeshSection const& map, MultiResolutionMeshLoadOptions const& options = {});
 		ZKINT SubMeshSection save(Write* w) const;
 	};
 
@@ -81,22 +168,103 @@ namespace zenkit {
 	class MultiResolutionMesh {
 	public:
 		ZKAPI void load(Read* r);
-		ZKINT void load_from_section(Read* r);
+		ZKAPI void load(Read* r, MultiResolutionMeshLoadOptions const& options);
+		ZKINT void load_from_section(Read* r, MultiResolutionMeshLoadOptions const& options = {});
+
+		/// \brief Saves the mesh in the format of the given game version.
+		/// \throws std::logic_error if the mesh was loaded into a MaterialRegistry.
+		/// \see MultiResolutionMeshLoadOptions::materials
 		ZKAPI void save(Write* w, GameVersion version) const;
 		ZKINT void save_to_section(Write* w, GameVersion version) const;
 
-		/// \brief The vertex positions associated with the mesh.
+		/// \brief Builds deduplicated, interleaved vertex and index buffers of the full-detail mesh with one batch
+		///        per sub-mesh.
+		///
+		/// Vertices are built from #positions and the wedges of each sub-mesh. Since sub-meshes don't have vertex
+		/// colors, all vertices are white.
+		///
+		/// \param options Options for building the buffers.
+		/// \return The buffers of the mesh.
+		[[nodiscard]] ZKAPI MeshBuffers build_render_buffers(MeshBufferOptions const& options = {}) const;
+
+		/// \brief Builds render buffers of a reduced level of detail using the progressive mesh data of the
+		///        sub-meshes.
+		///
+		/// <p>Each sub-mesh keeps \p target_ratio of its wedges. Removed wedges are collapsed into the remaining ones
+		/// using SubMesh::wedge_map, the same way the *ZenGin* reduces the detail of distant meshes, and triangles
+		/// which degenerate in the process are dropped. Sub-meshes without a wedge map are kept at full detail.</p>
+		///
+		/// \param target_ratio The fraction of wedges to keep, between 0 and 1.
+		/// \param options Options for building the buffers.
+		/// \return The buffers of the reduced mesh.
+		/// \see #build_render_buffers
+		[[nodiscard]] ZKAPI MeshBuffers build_lod(float target_ratio, MeshBufferOptions const& options = {}) const;
+
+		/// \brief Builds render buffers of several levels of detail which share a single vertex buffer.
+		///
+		/// <p>The first level is the full-detail mesh and each following level keeps \p reduction times the wedges
+		/// of the previous one. Small meshes may end up without any triangles in their least detailed levels.</p>
+		///
+		/// \param level_count The number of levels to build.
+		/// \param reduction The factor by which the ratio of kept wedges is reduced from one level to the next.
+		/// \param options Options for building the buffers.
+		/// \return The buffers of all levels.
+		/// \see #build_lod
+		[[nodiscard]] ZKAPI MeshLodChain
+		build_lod_chain(std::uint32_t level_count, float reduction = 0.5f, MeshBufferOptions const& options = {}) const;
+
+		/// \brief Converts the mesh to compact mode.
+		///
+		/// <p>In compact mode, #positions, #normals and SubMesh::wedges are replaced by #quantized_positions,
+		/// #quantized_normals and SubMesh::quantized_wedges, which use less than half the memory. They are laid out
+		/// so that they can be uploaded to the GPU as is and decoded in shaders. The functions building render
+		/// buffers decode them on the fly.</p>
+		///
+		/// <p>Compact meshes have to be converted back using #decode before they can be saved.</p>
+		///
+		/// \see MultiResolutionMeshLoadOptions::compact
+		ZKAPI void compact();
+
+		/// \brief Converts a compact mesh back to full precision. Does nothing if the mesh is not compact.
+		/// \see #compact
+		ZKAPI void decode();
+
+		/// \return `true` if the mesh is stored in compact mode.
+		[[nodiscard]] bool is_compact() const noexcept {
+			return !quantized_positions.empty() || !quantized_normals.empty();
+		}
+
+		/// \brief The vertex positions associated with the mesh. Empty if the mesh is compact.
 		std::vector<Vec3> positions;
 
-		/// \brief The normal vectors of the mesh.
+		/// \brief The normal vectors of the mesh. Empty if the mesh is compact.
 		std::vector<Vec3> normals;
 
+		/// \brief The quantized vertex positions of the mesh if it is compact, empty otherwise.
+		/// \see #compact
+		std::vector<QuantizedPosition> quantized_positions;
+
+		/// \brief The quantized normal vectors of the mesh if it is compact, empty otherwise.
+		/// \see #compact
+		std::vector<QuantizedNormal> quantized_normals;
+
+		/// \brief The smallest component of all #positions in each axis, used to decode #quantized_positions.
+		Vec3 quantized_position_min {};
+
+		/// \brief The size of one quantization step of #quantized_positions in each axis.
+		Vec3 quantized_position_scale {};
+
 		/// \brief A list of sub-meshes of the mesh.
 		std::vector<SubMesh> sub_meshes;
 
-		/// \brief A list of all materials used by the mesh.
+		/// \brief A list of all materials used by the mesh. Empty if the mesh was loaded into a MaterialRegistry.
 		std::vector<Material> materials;
 
+		/// \brief The handle of the material of each sub-mesh if the mesh was loaded into a MaterialRegistry,
+		///        empty otherwise.
+		/// \see MultiResolutionMeshLoadOptions::materials
+		std::vector<std::uint32_t> material_handles;
+
 		/// \brief If alpha testing should be enabled.
 		std::uint8_t alpha_test {true};
 
@@ -1,9 +1,16 @@
 // Copyright © 2023 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "Memory.hh"
 #include "Misc.hh"
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace zenkit {
 	class ReadArchive;
@@ -108,4 +115,157 @@ public:
 		virtual void load(ReadArchive& r, GameVersion version);
 		virtual void save(WriteArchive& w, GameVersion version) const;
 	};
+
+	/// \brief A monotonic buffer which objects loaded from archives can be allocated in.
+	///
+	/// <p>Loading a world creates tens of thousands of objects and each of them would otherwise be a separate heap
+	/// allocation. When an arena is set using ReadArchive::set_arena or passed to World::load, all objects read from
+	/// the archive are instead created with std::allocate_shared in large blocks owned by the arena.</p>
+	///
+	/// <p>Memory is never returned to the arena. Instead, every object allocated in an arena keeps it alive, so all
+	/// blocks are freed at once when the last object is destroyed. Allocating from an arena is not thread-safe.</p>
+	///
+	/// <p>The blocks are allocated from a MemoryResource, by default the one set using ::set_memory_resource.</p>
+	///
+	/// <p>To load many worlds one after the other without allocating new blocks each time, keep the arena alive and
+	/// call #reset once the objects of the previous world have been destroyed. The next objects then reuse its
+	/// blocks.</p>
+	class ObjectArena : public std::enable_shared_from_this<ObjectArena> {
+	public:
+		/// \brief A standard allocator which allocates from an ObjectArena.
+		template <typename T>
+		class Allocator {
+		public:
+			using value_type = T;
+
+			explicit Allocator(std::shared_ptr<ObjectArena> arena) noexcept : _m_arena(std::move(arena)) {}
+
+			template <typename U>
+			Allocator(Allocator<U> const& other) noexcept : _m_arena(other._m_arena) {}
+
+			[[nodiscard]] T* allocate(std::size_t n) {
+				return static_cast<T*>(_m_arena->allocate(n * sizeof(T), alignof(T)));
+			}
+
+			void deallocate(T*, std::size_t) noexcept {}
+
+			template <typename U>
+			bool operator==(Allocator<U> const& other) const noexcept {
+				return _m_arena == other._m_arena;
+			}
+
+			template <typename U>
+			bool operator!=(Allocator<U> const& other) const noexcept {
+				return _m_arena != other._m_arena;
+			}
+
+		private:
+			template <typename U>
+			friend class Allocator;
+
+			std::shared_ptr<ObjectArena> _m_arena;
+		};
+
+		/// \brief Create a new, empty arena.
+		/// \param block_size The size of the blocks to allocate memory in. Larger allocations get their own block.
+		/// \return The new arena.
+		[[nodiscard]] ZKAPI static std::shared_ptr<ObjectArena> create(std::size_t block_size = 1024 * 1024);
+
+		/// \brief Create a new, empty arena which allocates its blocks from the given resource.
+		/// \param block_size The size of the blocks to allocate memory in. Larger allocations get their own block.
+		/// \param memory The resource to allocate blocks from or `nullptr` to use ::get_memory_resource. It has to
+		///               outlive the arena.
+		/// \return The new arena.
+		[[nodiscard]] ZKAPI static std::shared_ptr<ObjectArena> create(std::size_t block_size, MemoryResource* memory);
+
+		ZKAPI ~ObjectArena() noexcept;
+		ObjectArena(ObjectArena const&) = delete;
+		ObjectArena& operator=(ObjectArena const&) = delete;
+
+		/// \brief Allocate memory from the arena.
+		/// \param size The number of bytes to allocate.
+		/// \param alignment The alignment of the memory to allocate. Must be a power of two.
+		/// \return A pointer to the allocated memory, which stays valid until the arena is destroyed.
+		[[nodiscard]] ZKAPI void* allocate(std::size_t size, std::size_t alignment);
+
+		/// \brief Create a new object of type \p T in the arena.
+		template <typename T, typename... Args>
+		[[nodiscard]] std::shared_ptr<T> make(Args&&... args) {
+			return std::allocate_shared<T>(Allocator<T> {this->shared_from_this()}, std::forward<Args>(args)...);
+		}
+
+		/// \return The number of blocks allocated from the system and held by the arena.
+		[[nodiscard]] ZKAPI std::size_t block_count() const noexcept;
+
+		/// \return The number of bytes handed out by #allocate so far.
+		[[nodiscard]] ZKAPI std::size_t bytes_used() const noexcept;
+
+		/// \brief Rewind the arena so that subsequent allocations reuse its blocks.
+		///
+		/// <p>Blocks of the arena's block size are kept and handed out again, larger blocks are freed. This is only
+		/// possible if none of the objects allocated in the arena are alive anymore, which is the case if the caller
+		/// holds the only reference to the arena.</p>
+		///
+		/// \return `true` if the arena was rewound and `false` if other references to it, i.e. objects allocated
+		///         in it, still exist. The arena is unchanged in that case.
+		ZKAPI bool reset() noexcept;
+
+	private:
+		ObjectArena(std::size_t block_size, MemoryResource* memory) noexcept;
+
+		struct Block {
+			std::byte* data;
+			std::size_t size;
+		};
+
+		MemoryResource* _m_memory;
+
+		std::vector<Block> _m_blocks;
+		std::size_t _m_next_block {0}; // Blocks from this index on are unused and can be handed out again
+		std::byte* _m_cursor {nullptr};
+		std::size_t _m_left {0};
+		std::size_t _m_block_size;
+		std::size_t _m_used {0};
+	};
+
+	/// \brief A table which stores each distinct string only once.
+	///
+	/// <p>Worlds contain many copies of the same strings, like the names of visuals and waypoints. Interning them
+	/// in a pool turns each distinct string into a small integer handle, so they can be stored in four bytes and
+	/// compared without looking at their characters. The characters are kept in an ObjectArena, so views returned
+	/// by the pool stay valid as long as the pool exists.</p>
+	///
+	/// <p>Handles are assigned in the order strings are first interned, starting with `0` for the empty string.
+	/// Interning is not thread-safe.</p>
+	///
+	/// \see ReadArchive::read_string_interned
+	class StringPool {
+	public:
+		ZKAPI StringPool();
+
+		/// \brief Adds a string to the pool unless an equal string was added before.
+		/// \param s The string to intern.
+		/// \return The handle of the string.
+		ZKAPI std::uint32_t intern(std::string_view s);
+
+		/// \brief Looks up a string without adding it to the pool.
+		/// \param s The string to look up.
+		/// \return The handle of the string or `std::nullopt` if it was not interned before.
+		[[nodiscard]] ZKAPI std::optional<std::uint32_t> find(std::string_view s) const;
+
+		/// \param handle The handle of a string.
+		/// \return The interned string or an empty string if \p handle is invalid.
+		[[nodiscard]] ZKAPI std::string_view get(std::uint32_t handle) const noexcept;
+
+		/// \return The number of distinct strings in the pool, including the empty string.
+		[[nodiscard]] ZKAPI std::size_t size() const noexcept;
+
+		/// \return The number of bytes used to store the characters of all strings.
+		[[nodiscard]] ZKAPI std::size_t bytes_used() const noexcept;
+
+	private:
+		std::shared_ptr<ObjectArena> _m_storage;
+		std::vector<std::string_view> _m_strings;
+		std::unordered_map<std::string_view, std::uint32_t> _m_handles;
+	};
 } // namespace zenkit
@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <future>
 #include <optional>
 #include <string>
 #include <vector>
@@ -15,6 +16,7 @@
 namespace zenkit {
 	class World;
 	class Read;
+	struct WorldLoadOptions;
 
 	/// \brief Contains general information about a save-game.
 	///
@@ -126,22 +128,102 @@ namespace zenkit {
 		ZKINT void save(WriteArchive& w, GameVersion version) const;
 	};
 
+	/// \brief Options for loading only selected parts of a save-game.
+	/// \see SaveGame::load
+	struct SaveGameLoadOptions {
+		/// \brief Set to `true` to leave SaveGame::state empty without reading `SAVEDAT.SAV`.
+		bool skip_state = false;
+
+		/// \brief Set to `true` to leave SaveGame::thumbnail empty without reading `THUMB.SAV`.
+		bool skip_thumbnail = false;
+	};
+
 	class SaveGame {
 	public:
 		ZKAPI explicit SaveGame(GameVersion version);
 
 		ZKAPI void load(std::filesystem::path const& path);
+
+		/// \brief Loads only selected parts of a save-game.
+		///
+		/// <p>With SaveGameLoadOptions::skip_state set, only the small `SAVEINFO.SAV` file is parsed, which is
+		/// enough to list save-games in a menu. Worlds are never loaded up-front, see #load_world.</p>
+		///
+		/// \param path The directory containing the save-game.
+		/// \param options Selects the parts of the save-game to load.
+		/// \throws ParserError if the directory does not contain a save-game.
+		ZKAPI void load(std::filesystem::path const& path, SaveGameLoadOptions const& options);
 		ZKAPI void save(std::filesystem::path const& path, World& world, std::string const& world_name);
 
+		/// \brief Saves the save-game on a background thread.
+		///
+		/// <p>The metadata, state and thumbnail of the save-game are copied before this function returns, so they
+		/// may be changed right away. The world is not copied and must not be modified until the returned future
+		/// is ready. The world and the remaining files are written in parallel.</p>
+		///
+		/// <p>Like #save, this makes \p path the location of this save-game. Don't call #load_world for it or
+		/// start another save until the returned future is ready.</p>
+		///
+		/// \param path The directory to save to. It is replaced if it already exists.
+		/// \param world The world to save.
+		/// \param world_name The name of the world, without its extension.
+		/// \return A future which becomes ready once all files are written and rethrows errors which occurred.
+		[[nodiscard]] ZKAPI std::future<void> save_async(std::filesystem::path const& path,
+		                                                 std::shared_ptr<World const> world,
+		                                                 std::string const& world_name);
+
 		[[nodiscard]] ZKAPI std::shared_ptr<World> load_world() const;
 		[[nodiscard]] ZKAPI std::shared_ptr<World> load_world(std::string_view name) const;
 
+		/// \brief Loads only selected parts of a world saved in this save-game.
+		///
+		/// <p>Use WorldLoadOptions::skip_vobs to only load the NPCs of the world or WorldLoadOptions::skip_npcs to
+		/// only load the state of its VObs.</p>
+		///
+		/// \param name The name of the world, with or without its extension. Case is ignored.
+		/// \param options Selects the parts of the world to load.
+		/// \return The world or `nullptr` if the save-game does not contain a world with the given name.
+		[[nodiscard]] ZKAPI std::shared_ptr<World> load_world(std::string_view name,
+		                                                      WorldLoadOptions const& options) const;
+
+		/// \brief Saves the save-game, storing the world as the changes relative to a base world.
+		///
+		/// <p>Only the VObs and NPCs which differ from \p base are stored, see WorldPatch. Usually, \p base is the
+		/// world as it was loaded from the previous save, so small changes produce small saves. The same base
+		/// world has to be passed to #load_world_delta to restore the world. Any full copy of the world in the
+		/// save-game is removed, as is any delta of the world when saving it using #save.</p>
+		///
+		/// \param path The directory to save to. It is replaced if it already exists.
+		/// \param base The world to store the changes relative to.
+		/// \param world The world to save.
+		/// \param world_name The name of the world, without its extension.
+		ZKAPI void save_delta(std::filesystem::path const& path,
+		                      World const& base,
+		                      World const& world,
+		                      std::string const& world_name);
+
+		/// \brief Restores a world saved using #save_delta by applying the stored changes to its base world.
+		/// \param name The name of the world, with or without its extension. Case is ignored.
+		/// \param base The base world passed to #save_delta. It is modified in place.
+		/// \return `false` if the save-game does not contain a delta of a world with the given name.
+		/// \throws ParserError if the delta could not be loaded.
+		ZKAPI bool load_world_delta(std::string_view name, World& base) const;
+
+		/// \return The names of all worlds stored in this save-game, without their extension, as found on disk.
+		[[nodiscard]] ZKAPI std::vector<std::string> worlds() const;
+
 		SaveMetadata metadata {};
 		SaveState state {};
 		std::optional<Texture> thumbnail {};
 
 	private:
+		void index_worlds();
+		[[nodiscard]] std::filesystem::path const* find_world(std::string_view name, std::string_view extension) const;
+
 		GameVersion _m_version;
 		std::filesystem::path _m_path;
+
+		/// \brief The paths of all world and world delta files in the save-game directory.
+		std::vector<std::filesystem::path> _m_worlds;
 	};
 } // namespace zenkit
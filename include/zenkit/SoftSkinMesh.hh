@@ -22,12 +22,60 @@ namespace zenkit {
 		std::uint8_t node_index;
 	};
 
+	/// \brief The node weights of all vertices of a SoftSkinMesh stored in flat arrays.
+	///
+	/// <p>The influences of vertex `i` are stored at `offsets[i]` up to `offsets[i + 1]` in the other arrays. Unlike
+	/// SoftSkinMesh::weights, this layout needs only a few allocations and can be traversed linearly.</p>
+	struct SoftSkinPackedWeights {
+		/// \brief For each vertex, the index of its first influence. Contains one more element than there are
+		///        vertices.
+		std::vector<std::uint32_t> offsets;
+
+		/// \brief The weight of each influence.
+		std::vector<float> weights;
+
+		/// \brief The position of the vertex relative to the node of each influence.
+		std::vector<Vec3> positions;
+
+		/// \brief The index in SoftSkinMesh::nodes of the node of each influence.
+		std::vector<std::uint8_t> node_indices;
+	};
+
 	/// \brief Represents a soft-skin mesh.
 	class SoftSkinMesh {
 	public:
 		ZKAPI void load(Read* r);
+		ZKAPI void load(Read* r, MultiResolutionMeshLoadOptions const& options);
 		ZKAPI void save(Write* w, GameVersion version) const;
 
+		/// \brief Rebuilds #packed_weights from #weights.
+		///
+		/// This is done when loading the mesh. If #weights is changed afterwards, this function must be called
+		/// again. If the size of #packed_weights does not match #weights, #skin falls back to #weights.
+		ZKAPI void pack_weights();
+
+		/// \brief Computes the positions of all vertices of the mesh for a pose of its skeleton.
+		///
+		/// <p>Each vertex is placed at the weighted sum of its position relative to each of its nodes, transformed by
+		/// the model-space transform of that node. The function does not modify the mesh, so multiple meshes can be
+		/// skinned on different threads at the same time.</p>
+		///
+		/// \param node_transforms The model-space transform of each node of the ModelHierarchy, indexed like
+		///                        ModelHierarchy::nodes. See ModelHierarchy::compute_world_transforms.
+		/// \param node_transform_count The number of elements in \p node_transforms. Influences of nodes beyond it
+		///                             are ignored.
+		/// \param positions Receives one position for each element of MultiResolutionMesh::positions.
+		ZKAPI void skin(Mat3x4 const* node_transforms, std::size_t node_transform_count, Vec3* positions) const;
+
+		/// \brief Builds vertex and index buffers for skinning the mesh on the GPU.
+		///
+		/// <p>Each wedge of each sub-mesh becomes one vertex. Vertices influenced by more than four nodes keep
+		/// the four strongest influences, and their weights are normalized again.</p>
+		///
+		/// \param options Options for building the buffers. MeshBufferOptions::optimize_vertex_cache is ignored.
+		/// \return The buffers.
+		[[nodiscard]] ZKAPI SkinnedMeshBuffers build_skinned_buffers(MeshBufferOptions const& options = {}) const;
+
 		/// \brief The embedded proto-mesh.
 		MultiResolutionMesh mesh;
 
@@ -40,6 +88,9 @@ namespace zenkit {
 		/// \brief Node weights.
 		std::vector<std::vector<SoftSkinWeightEntry>> weights;
 
+		/// \brief A copy of #weights in flat arrays, see #pack_weights.
+		SoftSkinPackedWeights packed_weights;
+
 		/// \brief Nodes.
 		std::vector<std::int32_t> nodes;
 	};
@@ -6,6 +6,7 @@
 #include "zenkit/Misc.hh"
 
 #include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <functional>
 #include <memory>
@@ -20,6 +21,109 @@ namespace zenkit {
 
 	enum class Whence { BEG = 0x00, CUR = 0x01, END = 0x02 };
 
+	/// \brief A non-virtual cursor over a contiguous region of memory.
+	///
+	/// <p>Provides the same primitive readers as Read but without virtual dispatch, allowing the compiler to inline
+	/// the bounds checks and loads. Like Read, reading past the end of the span yields zeroed values. A ReadSpan never
+	/// owns the memory it points to. It can be obtained from memory-backed streams using Read::as_contiguous.</p>
+	class ReadSpan {
+	public:
+		constexpr ReadSpan() noexcept = default;
+		constexpr ReadSpan(std::byte const* data, size_t size) noexcept : _m_data(data), _m_size(size) {}
+
+		[[nodiscard]] char read_char() noexcept {
+			return read_any<char>();
+		}
+
+		[[nodiscard]] int8_t read_byte() noexcept {
+			return read_any<int8_t>();
+		}
+
+		[[nodiscard]] uint8_t read_ubyte() noexcept {
+			return read_any<uint8_t>();
+		}
+
+		[[nodiscard]] int16_t read_short() noexcept {
+			return read_any<int16_t>();
+		}
+
+		[[nodiscard]] uint16_t read_ushort() noexcept {
+			return read_any<uint16_t>();
+		}
+
+		[[nodiscard]] int32_t read_int() noexcept {
+			return read_any<int32_t>();
+		}
+
+		[[nodiscard]] uint32_t read_uint() noexcept {
+			return read_any<uint32_t>();
+		}
+
+		[[nodiscard]] float read_float() noexcept {
+			return read_any<float>();
+		}
+
+		[[nodiscard]] Vec2 read_vec2() noexcept {
+			Vec2 v {};
+			this->read(v.pointer(), sizeof(float) * 2);
+			return v;
+		}
+
+		[[nodiscard]] Vec3 read_vec3() noexcept {
+			Vec3 v {};
+			this->read(v.pointer(), sizeof(float) * 3);
+			return v;
+		}
+
+		size_t read(void* buf, size_t len) noexcept {
+			len = len > _m_size - _m_position ? _m_size - _m_position : len;
+			if (len != 0) memcpy(buf, _m_data + _m_position, len);
+			_m_position += len;
+			return len;
+		}
+
+		/// \brief Advances the cursor by \p len bytes, stopping at the end of the span.
+		void skip(size_t len) noexcept {
+			_m_position += len > _m_size - _m_position ? _m_size - _m_position : len;
+		}
+
+		[[nodiscard]] std::byte const* data() const noexcept {
+			return _m_data;
+		}
+
+		[[nodiscard]] size_t size() const noexcept {
+			return _m_size;
+		}
+
+		[[nodiscard]] size_t remaining() const noexcept {
+			return _m_size - _m_position;
+		}
+
+		[[nodiscard]] size_t tell() const noexcept {
+			return _m_position;
+		}
+
+		[[nodiscard]] bool eof() const noexcept {
+			return _m_position >= _m_size;
+		}
+
+	private:
+		template <typename T>
+		[[nodiscard]] T read_any() noexcept {
+			T v {};
+			if (sizeof v <= _m_size - _m_position) {
+				memcpy(&v, _m_data + _m_position, sizeof v);
+				_m_position += sizeof v;
+			} else {
+				_m_position = _m_size;
+			}
+			return v;
+		}
+
+		std::byte const* _m_data {nullptr};
+		size_t _m_size {0}, _m_position {0};
+	};
+
 	/// \brief Basic input device abstraction for <i>ZenKit</i>.
 	///
 	/// <p>Provides functions for reading primitives from an underlying datasource in little-endian. May be subclassed
@@ -47,6 +151,12 @@ namespace zenkit {
 	///     thus std::cin is not fully supported.</td>
 	///   </tr>
 	///   <tr>
+	///     <td>Read::from(::FILE*, size_t)<br/>Read::from(std::istream*, size_t)</td>
+	///     <td>Like the unbuffered variants above but serves reads from an internal buffer of the given size which is
+	///     refilled in large blocks. Useful when memory-mapping is not available. The underlying stream must not be
+	///     used by anything else while the Read instance is alive.</td>
+	///   </tr>
+	///   <tr>
 	///     <td>Read::from(std::byte const*, size_t)</td>
 	///     <td>Uses a raw memory buffer as the data source. The given buffer is never copied and thus must remain valid
 	///     as long as the stream is in use.</td>
@@ -73,7 +183,8 @@ namespace zenkit {
 	///
 	/// <h3>Implementing a custom Read</h3>
 	/// <p>Implementing a custom Read is as simple as creating a new subclass and implementing the Read::read,
-	/// Read::seek, Read::tell and Read::eof member functions.</p>
+	/// Read::seek, Read::tell and Read::eof member functions. Memory-backed implementations should also override
+	/// Read::as_contiguous so that parsers can decode directly from the underlying buffer.</p>
 	class ZKAPI Read {
 	public:
 		virtual ~Read() noexcept = default;
@@ -93,19 +204,103 @@ namespace zenkit {
 		[[nodiscard]] Mat3 read_mat3() noexcept;
 		[[nodiscard]] Mat4 read_mat4() noexcept;
 
+		/// \brief Reads \p count consecutive values into \p out using a single call to Read::read.
+		///
+		/// If the stream ends before all values could be read, the remaining values in \p out are set to zero.
+		///
+		/// \param out A buffer with space for at least \p count values.
+		/// \param count The number of values to read.
+		void read_ushort_array(uint16_t* out, size_t count) noexcept;
+		void read_uint_array(uint32_t* out, size_t count) noexcept;
+		void read_float_array(float* out, size_t count) noexcept;
+		void read_vec2_array(Vec2* out, size_t count) noexcept;
+		void read_vec3_array(Vec3* out, size_t count) noexcept;
+
 		[[nodiscard]] virtual std::string read_line_then_ignore(std::string_view chars) noexcept;
 
+		/// \brief Reads a line like Read::read_line but returns a view instead of a new string.
+		///
+		/// For memory-backed streams, the view points directly into the underlying buffer and no allocation takes
+		/// place. Other streams store the line in \p buffer, so the view is only valid as long as \p buffer is not
+		/// modified.
+		///
+		/// \param skipws Whether to skip whitespace following the line.
+		/// \param buffer Storage for the line, if the stream cannot return a view into its own data.
+		/// \return A view of the line without its terminator.
+		[[nodiscard]] virtual std::string_view read_line_view(bool skipws, std::string& buffer) noexcept;
+
 		virtual size_t read(void* buf, size_t len) noexcept = 0;
 		virtual void seek(ssize_t off, Whence whence) noexcept = 0;
 		[[nodiscard]] virtual size_t tell() const noexcept = 0;
 		[[nodiscard]] virtual bool eof() const noexcept = 0;
 
+		/// \brief Gets a view of the bytes between the current position and the end of the stream.
+		///
+		/// The returned span is only valid as long as the stream is alive and does not advance the stream. Callers
+		/// are expected to Read::seek past the bytes they have consumed from the span. Streams which are not backed by
+		/// contiguous memory return an empty span.
+		///
+		/// \return A span over the remaining bytes in the stream or an empty span if the stream is not memory-backed.
+		[[nodiscard]] virtual ReadSpan as_contiguous() noexcept;
+
+		/// \brief Creates a bounded view of the next \p len bytes of this stream and advances past them.
+		///
+		/// For memory-backed streams, the slice shares the underlying buffer and no data is copied. In that case this
+		/// stream (and its backing memory) must outlive the slice. Other streams are read into an owned buffer
+		/// instead. The slice is clamped to the number of bytes actually remaining in this stream.
+		///
+		/// \param len The number of bytes to include in the slice.
+		/// \return A new stream which can only see the given range of bytes.
+		[[nodiscard]] std::unique_ptr<Read> slice(size_t len);
+
+		/// \brief Hints that the given range of the stream will be read soon.
+		///
+		/// Memory-mapped streams ask the operating system to page in the range asynchronously. For all other streams
+		/// this does nothing.
+		///
+		/// \param offset The offset of the first byte which will be read relative to the beginning of the stream.
+		/// \param len The number of bytes which will be read.
+		virtual void prefetch(size_t offset, size_t len) noexcept;
+
+		/// \brief Hints that the stream will be read sequentially from here on out.
+		///
+		/// Memory-mapped streams pass this on to the operating system which may read ahead more aggressively. For
+		/// all other streams this does nothing.
+		virtual void advise_sequential() noexcept;
+
 		[[nodiscard]] static std::unique_ptr<Read> from(FILE* stream);
 		[[nodiscard]] static std::unique_ptr<Read> from(std::istream* stream);
+		[[nodiscard]] static std::unique_ptr<Read> from(FILE* stream, size_t buffer_size);
+		[[nodiscard]] static std::unique_ptr<Read> from(std::istream* stream, size_t buffer_size);
 		[[nodiscard]] static std::unique_ptr<Read> from(std::byte const* bytes, size_t len);
 		[[nodiscard]] static std::unique_ptr<Read> from(std::vector<std::byte> const* vector);
 		[[nodiscard]] static std::unique_ptr<Read> from(std::vector<std::byte> vector);
 		[[nodiscard]] static std::unique_ptr<Read> from(std::filesystem::path const& path);
+
+		/// \brief Opens a stream created by Write::to_compressed and transparently decompresses it.
+		///
+		/// <p>The data is stored as a sequence of independently compressed LZ4 frames followed by an index of all
+		/// frames. Seeking only requires decompressing the frame containing the new position, so the returned stream
+		/// can be passed to any loader. One frame is kept in memory at a time.</p>
+		///
+		/// \param source The compressed stream. It is owned by the returned stream.
+		/// \return A stream over the uncompressed data.
+		/// \throws zenkit::ParserError if \p source does not contain a valid compressed stream.
+		[[nodiscard]] static std::unique_ptr<Read> from_compressed(std::unique_ptr<Read> source);
+
+		/// \brief Loads many files concurrently and hands each of them to \p cb once it is ready.
+		///
+		/// <p>Up to \p max_in_flight files are read into memory at the same time using background threads, which
+		/// keeps the storage device busy when loading lots of small assets. The callback is always invoked on the
+		/// calling thread, in the order in which the files finish loading, together with the index of the file in
+		/// \p paths. If a file cannot be read, an error is logged and the callback receives `nullptr`.</p>
+		///
+		/// \param paths The files to load.
+		/// \param cb The function to call for every file.
+		/// \param max_in_flight The maximum number of files to read at the same time or `0` to choose automatically.
+		static void from_many(std::vector<std::filesystem::path> const& paths,
+		                      std::function<void(size_t, std::unique_ptr<Read>)> const& cb,
+		                      size_t max_in_flight = 0);
 	};
 
 	class Write ZKAPI {
@@ -132,9 +327,43 @@ namespace zenkit {
 		virtual void seek(ssize_t off, Whence whence) noexcept = 0;
 		[[nodiscard]] virtual size_t tell() const noexcept = 0;
 
+		/// \brief Writes all buffered data to the underlying sink.
+		///
+		/// Buffered implementations also flush when they are destroyed. The default implementation does nothing.
+		virtual void flush() noexcept {}
+
+		/// \brief Creates a buffered Write which creates or truncates the file at the given path.
 		[[nodiscard]] static std::unique_ptr<Write> to(std::filesystem::path const& path);
 		[[nodiscard]] static std::unique_ptr<Write> to(FILE* stream);
 		[[nodiscard]] static std::unique_ptr<Write> to(std::ostream* stream);
+
+		/// \brief Creates a Write which memory-maps the file at the given path, creating or truncating it.
+		///
+		/// The mapping starts out with \p initial_size bytes and is grown in large steps as needed. When the Write is
+		/// destroyed, the file is truncated to the number of bytes actually written. If ZenKit was built without
+		/// memory-mapping support, this behaves like Write::to(std::filesystem::path const&).
+		///
+		/// \param path The path of the file to write.
+		/// \param initial_size The number of bytes to reserve in the file up front.
+		/// \throws std::runtime_error if the file cannot be created or mapped.
+		[[nodiscard]] static std::unique_ptr<Write> to_mmap(std::filesystem::path const& path, size_t initial_size);
+
+		/// \brief Creates a Write which compresses all data into frames of \p frame_size bytes before passing it on.
+		///
+		/// <p>The output can be read back using Read::from_compressed. Each frame is compressed once it is full, and
+		/// the frame index is appended when the Write is destroyed. Seeking is therefore only possible within the
+		/// frame currently being written. To compress data which is patched after the fact, like chunked formats,
+		/// write it to memory first.</p>
+		///
+		/// \param sink The stream to write the compressed data to. It must outlive the returned Write.
+		/// \param frame_size The number of uncompressed bytes in each frame. Must be between 1 byte and 2 GiB.
+		/// \throws std::invalid_argument if \p frame_size is out of range.
+		[[nodiscard]] static std::unique_ptr<Write> to_compressed(Write* sink, size_t frame_size = 64 * 1024);
+
+		/// \brief Creates a Write which collects writes in an internal buffer of the given size before passing them
+		///        to the underlying stream. Call Write::flush before using the stream directly again.
+		[[nodiscard]] static std::unique_ptr<Write> to(FILE* stream, size_t buffer_size);
+		[[nodiscard]] static std::unique_ptr<Write> to(std::ostream* stream, size_t buffer_size);
 		[[nodiscard]] static std::unique_ptr<Write> to(std::byte* bytes, size_t len);
 		[[nodiscard]] static std::unique_ptr<Write> to(std::vector<std::byte>* vector);
 	};
@@ -217,10 +446,11 @@ namespace zenkit {
 
 			cb(w);
 
-			auto len = static_cast<ssize_t>(w->tell()) - size_off;
+			auto end_off = static_cast<ssize_t>(w->tell());
+			auto len = end_off - size_off;
 			w->seek(size_off, Whence::BEG);
 			w->write_uint(static_cast<uint32_t>(len) - sizeof(uint32_t));
-			w->seek(len, Whence::CUR);
+			w->seek(end_off, Whence::BEG);
 		}
 	} // namespace proto
 } // namespace zenkit
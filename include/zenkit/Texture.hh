@@ -3,14 +3,15 @@
 #pragma once
 #include "zenkit/Error.hh"
 #include "zenkit/Library.hh"
+#include "zenkit/Stream.hh"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace zenkit {
-	class Read;
-	class Write;
 
 	constexpr std::uint16_t ZTEX_PALETTE_ENTRIES = 0x100;
 
@@ -46,11 +47,48 @@ namespace zenkit {
 		explicit UnsupportedFormatError(std::string msg) : Error("Format not supported: " + msg) {}
 	};
 
+	/// \brief The trade-off between speed and quality to make when compressing textures into a DXT format.
+	enum class TextureCompressionQuality {
+		/// \brief Fits the colors of each block to the principal axis of its colors. Many times faster than
+		///        NORMAL, at a slightly lower quality.
+		FAST,
+
+		/// \brief Searches for the best colors for each block.
+		NORMAL,
+
+		/// \brief Repeats the search of NORMAL to improve its result. Very slow.
+		BEST,
+	};
+
+	/// \brief Options for converting textures between formats.
+	/// \see TextureBuilder::build
+	struct TextureConversionOptions {
+		/// \brief The quality to compress DXT textures with.
+		TextureCompressionQuality quality {TextureCompressionQuality::NORMAL};
+
+		/// \brief The maximum number of threads to convert a texture on. Set to `0` to use all threads of the
+		///        ::get_executor. Small textures are always converted on a single thread.
+		/// \note Ignored on platforms without thread support.
+		std::uint32_t thread_count {0};
+	};
+
 	/// \brief Simple ARGB quad.
 	struct ColorARGB {
 		std::uint8_t a, r, g, b;
 	};
 
+	/// \brief Options for loading a Texture.
+	/// \see Texture::load
+	struct TextureLoadOptions {
+		/// \brief Set to `true` to only copy a mipmap level out of the stream once it is first accessed using
+		///        Texture::data.
+		///
+		/// <p>This only has an effect on memory-backed streams, like the ones returned by VfsNode::open_read. The
+		/// memory backing the stream must outlive the texture and all of its copies. Other streams are read
+		/// completely.</p>
+		bool lazy = false;
+	};
+
 	/// \brief Represents a ZenGin texture.
 	class Texture {
 	public:
@@ -62,6 +100,7 @@ namespace zenkit {
 		Texture& operator=(Texture const&) = default;
 
 		ZKAPI void load(Read* r);
+		ZKAPI void load(Read* r, TextureLoadOptions const& options);
 		ZKAPI void save(Write* r) const;
 
 		/// \return The format of the texture.
@@ -116,11 +155,34 @@ namespace zenkit {
 			return _m_palette.data();
 		}
 
+		/// \brief Gets the palette of the texture as RGBA8 colors.
+		///
+		/// <p>The data of TextureFormat::P8 textures returned by #data and #data_view contains one palette index
+		/// per pixel. Renderers which look up the palette in a shader can upload the index data as-is together
+		/// with this palette, which needs a quarter of the memory of the textures returned by #as_rgba8.</p>
+		///
+		/// \return The 256 palette entries, four bytes each.
+		[[nodiscard]] ZKAPI std::array<std::uint8_t, ZTEX_PALETTE_ENTRIES * 4> palette_rgba8() const noexcept;
+
+		/// \brief Gets the texture data at the given mipmap level.
+		///
+		/// <p>If the texture was loaded lazily, the level is copied out of the stream it was loaded from on first
+		/// access. This may happen from multiple threads at once.</p>
+		///
 		/// \param mipmap_level The mipmap level to get.
 		/// \return The texture data at the given mipmap level.
-		[[nodiscard]] ZKAPI std::vector<std::uint8_t> const& data(std::uint32_t mipmap_level = 0) const noexcept {
-			return _m_textures.at(_m_mipmap_count - 1 - mipmap_level);
-		}
+		/// \throws std::out_of_range if the texture does not have the given mipmap level.
+		/// \throws std::bad_alloc if a lazily loaded level cannot be copied.
+		[[nodiscard]] ZKAPI std::vector<std::uint8_t> const& data(std::uint32_t mipmap_level = 0) const;
+
+		/// \brief Gets a view of the texture data at the given mipmap level without copying it.
+		///
+		/// <p>For lazily loaded textures, the view points into the memory the texture was loaded from. Otherwise,
+		/// it points to the data returned by #data.</p>
+		///
+		/// \param mipmap_level The mipmap level to get.
+		/// \return A view of the texture data at the given mipmap level.
+		[[nodiscard]] ZKAPI ReadSpan data_view(std::uint32_t mipmap_level = 0) const noexcept;
 
 		/// \brief Converts the texture data of the given mipmap-level to RGBA8
 		/// \param mipmap_level The mipmap level of the texture to convert
@@ -128,6 +190,17 @@ namespace zenkit {
 		/// \attention This method is very expensive as it allocates a new buffer and copies the internal data into it.
 		[[nodiscard]] ZKAPI std::vector<std::uint8_t> as_rgba8(std::uint32_t mipmap_level = 0) const;
 
+		/// \brief Converts the texture data of the given mipmap-level to RGBA8 and writes it into the given buffer.
+		///
+		/// <p>Unlike #as_rgba8, this does not allocate, so one buffer can be reused to convert many textures.</p>
+		///
+		/// \param buffer The buffer to write the converted texture data into.
+		/// \param size The size of \p buffer in bytes. Must be at least `mipmap_width(mipmap_level) *
+		///             mipmap_height(mipmap_level) * 4`.
+		/// \param mipmap_level The mipmap level of the texture to convert
+		/// \throws InvalidMipmapSize if \p buffer is too small.
+		ZKAPI void as_rgba8_into(std::uint8_t* buffer, std::size_t size, std::uint32_t mipmap_level = 0) const;
+
 	private:
 		TextureFormat _m_format {};
 		std::array<ColorARGB, ZTEX_PALETTE_ENTRIES> _m_palette {};
@@ -141,6 +214,10 @@ namespace zenkit {
 		// Quirk: largest mipmap (level 0) stored at the end of the vector
 		std::vector<std::vector<std::uint8_t>> _m_textures;
 
+		// Set if the texture was loaded lazily. Shared between copies of the texture.
+		struct LazyMipmaps;
+		std::shared_ptr<LazyMipmaps> _m_lazy;
+
 		friend class TextureBuilder;
 	};
 
@@ -150,7 +227,7 @@ namespace zenkit {
 
 		TextureBuilder& add_mipmap(std::vector<uint8_t> bytes, TextureFormat format);
 
-		Texture build(TextureFormat format);
+		Texture build(TextureFormat format, TextureConversionOptions const& options = {});
 
 	private:
 		std::uint32_t _m_width;
@@ -0,0 +1,131 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace zenkit {
+	class Write;
+
+	namespace detail {
+		struct LoadStatsCollector;
+	} // namespace detail
+
+	/// \brief A span of work recorded by the Tracer.
+	struct TraceSpan {
+		/// \brief The name of the span, e.g. `"World.VobTree"`. Always points to a string literal.
+		char const* name;
+
+		/// \brief The thread which did the work, numbered in the order of the first span of each thread.
+		std::uint32_t thread;
+
+		/// \brief The start of the span in nanoseconds since the Tracer was started.
+		std::uint64_t begin;
+
+		/// \brief The end of the span in nanoseconds since the Tracer was started.
+		std::uint64_t end;
+
+		/// \brief The number of bytes of input processed in the span or 0 if it is unknown.
+		std::uint64_t bytes;
+	};
+
+	/// \brief Records how long the loaders take for each of their major parse phases.
+	///
+	/// The loaders of worlds, meshes, textures, scripts and VDF disks are instrumented with spans, which also carry the
+	/// number of bytes they processed. Spans are only recorded with the `ZK_ENABLE_TRACING` CMake option. With
+	/// `ZK_ENABLE_TRACY`, spans are sent to the Tracy profiler instead of being recorded by this class.
+	///
+	/// \see LoadStats for statistics which are available in all builds.
+	class Tracer {
+	public:
+		/// \return Whether this build of ZenKit records spans using the Tracer.
+		[[nodiscard]] ZKAPI static bool available() noexcept;
+
+		/// \brief Start recording spans, removing all spans recorded before.
+		ZKAPI static void start();
+
+		/// \brief Stop recording spans. Spans which are still open are discarded.
+		ZKAPI static void stop() noexcept;
+
+		/// \return Whether spans are currently being recorded.
+		[[nodiscard]] ZKAPI static bool active() noexcept;
+
+		/// \return All spans recorded since the last call to ::start in the order they ended.
+		[[nodiscard]] ZKAPI static std::vector<TraceSpan> spans();
+
+		/// \brief Write the recorded spans in the Chrome trace event format.
+		///
+		/// The output is a JSON document which can be opened in `chrome://tracing` or https://ui.perfetto.dev.
+		///
+		/// \param w The stream to write to.
+		ZKAPI static void write_chrome_trace(Write* w);
+	};
+
+	/// \brief The time spent in one parse phase of the loaders, see LoadStats::phases.
+	struct LoadPhaseStats {
+		/// \brief The name of the phase, the same as TraceSpan::name. Always points to a string literal.
+		char const* name;
+
+		/// \brief The wall time spent in the phase in nanoseconds, summed over all times it ran.
+		std::uint64_t nanoseconds;
+
+		/// \brief The number of bytes of input processed in the phase or 0 if it is unknown.
+		std::uint64_t bytes;
+
+		/// \brief The number of times the phase ran.
+		std::uint32_t count;
+	};
+
+	/// \brief Statistics about the assets loaded while a LoadStatsScope was open.
+	///
+	/// <p>The loaders of worlds, meshes, textures, animations and scripts report the same phases which are recorded
+	/// by the Tracer, but unlike it, load statistics are available in all builds. They are cheap enough to collect
+	/// for every load in production, e.g. to find the assets of a mod which make loading slow.</p>
+	struct LoadStats {
+		/// \brief The number of top-level loads, i.e. loads not done as part of another load, like the mesh of a
+		///        world.
+		std::uint64_t loads {0};
+
+		/// \brief The number of bytes read by the top-level loads.
+		std::uint64_t bytes_read {0};
+
+		/// \brief The wall time spent in the top-level loads in nanoseconds.
+		std::uint64_t nanoseconds {0};
+
+		/// \brief The number of objects loaded, i.e. objects read from archives like VObs and materials and the
+		///        symbols of scripts.
+		std::uint64_t objects {0};
+
+		/// \brief The number of allocations made while loading. Only allocations seen by a MemoryTracker are
+		///        counted, i.e. those made from it and those passed to MemoryTracker::record_allocation.
+		std::uint64_t allocations {0};
+
+		/// \brief The number of bytes allocated in #allocations.
+		std::uint64_t allocated_bytes {0};
+
+		/// \brief Each phase of the loaders which ran, in the order they first ended.
+		std::vector<LoadPhaseStats> phases {};
+	};
+
+	/// \brief Collects LoadStats of everything loaded on the calling thread until it is destroyed.
+	///
+	/// <p>Work which the loaders do in parallel using a TaskGroup is included. The statistics are added to the
+	/// values already in the LoadStats when the scope is destroyed. Scopes may be nested, in which case only the
+	/// innermost one collects statistics.</p>
+	class LoadStatsScope {
+	public:
+		ZKAPI explicit LoadStatsScope(LoadStats& stats);
+		ZKAPI ~LoadStatsScope() noexcept;
+
+		LoadStatsScope(LoadStatsScope const&) = delete;
+		LoadStatsScope& operator=(LoadStatsScope const&) = delete;
+
+	private:
+		std::unique_ptr<detail::LoadStatsCollector> _m_collector;
+		detail::LoadStatsCollector* _m_previous;
+		std::uint32_t _m_previous_depth;
+	};
+} // namespace zenkit
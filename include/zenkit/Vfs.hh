@@ -8,8 +8,10 @@
 #include "Stream.hh"
 
 #include <filesystem>
+#include <functional>
+#include <atomic>
 #include <memory>
-#include <set>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -36,16 +38,54 @@ namespace zenkit {
 		FILE = 2,
 	};
 
+	namespace detail {
+		struct VfsIndex;
+		struct VfsIndexCache;
+		struct VfsState;
+		struct VfsLazyDisk;
+		struct VfsDiskLayout;
+		struct VfsFileStats;
+		class VfsHostWatch;
+
+		/// \brief A host file whose contents are referenced by nodes in a Vfs.
+		struct VfsSource {
+			std::filesystem::path path;
+			std::filesystem::file_time_type time;
+			std::byte const* data;
+			std::size_t size;
+			std::shared_ptr<VfsLazyDisk> lazy {};
+		};
+	} // namespace detail
+
 	struct VfsFileDescriptor {
+		/// \brief The contents of the file or `nullptr` if it lives on a disk which has not been mapped yet.
+		/// \see #data
 		std::byte const* memory;
 		std::size_t size;
 
 		VfsFileDescriptor(std::byte const* mem, size_t len, bool del);
+		VfsFileDescriptor(std::shared_ptr<detail::VfsLazyDisk> disk, size_t offset, size_t len);
 		VfsFileDescriptor(VfsFileDescriptor const& cpy);
+		VfsFileDescriptor(VfsFileDescriptor&& mv) noexcept;
 		~VfsFileDescriptor() noexcept;
 
+		VfsFileDescriptor& operator=(VfsFileDescriptor const& cpy);
+		VfsFileDescriptor& operator=(VfsFileDescriptor&& mv) noexcept;
+
+		/// \brief Get the contents of the file, mapping the disk it lives on first if necessary.
+		/// \throws std::runtime_error if the disk could not be mapped.
+		[[nodiscard]] std::byte const* data() const;
+
 	private:
-		size_t* refcnt;
+		friend class Vfs;
+		friend class VfsNode;
+
+		std::atomic_size_t* refcnt;
+		std::shared_ptr<detail::VfsLazyDisk> _m_disk {};
+		std::size_t _m_offset {0};
+		std::uint64_t _m_hash {0};
+		bool _m_hashed {false};
+		detail::VfsFileStats* _m_stats {nullptr};
 	};
 
 	class VfsNode;
@@ -58,10 +98,27 @@ namespace zenkit {
 		ZKAPI [[nodiscard]] bool operator()(std::string_view a, VfsNode const& b) const noexcept;
 	};
 
+	/// \brief A file or directory in the virtual file system.
+	///
+	/// The children of a directory are stored in one contiguous block, sorted case-insensitively by name. Adding or
+	/// removing a child thus invalidates pointers to all other children of the same directory.
 	class VfsNode {
-		using ChildContainer = std::set<VfsNode, VfsNodeComparator>;
-
 	public:
+		/// \brief The container holding the children of a directory, sorted case-insensitively by name.
+		using ChildContainer = std::vector<VfsNode>;
+
+		/// \brief Copy a node and all its children. The copy does not belong to any Vfs until it is inserted.
+		VfsNode(VfsNode const& cpy) = default;
+		VfsNode(VfsNode&& mv) noexcept = default;
+		~VfsNode() noexcept = default;
+
+		/// \brief Replace the contents of this node with a copy of another node.
+		///
+		/// A directory which is part of a Vfs stays part of it, together with the copied children. Nodes of a Vfs
+		/// should otherwise be changed using #create and #remove only, so that the Vfs can keep its index up to date.
+		ZKAPI VfsNode& operator=(VfsNode const& cpy);
+		VfsNode& operator=(VfsNode&& mv) noexcept = default;
+
 		[[nodiscard]] ZKAPI VfsNodeType type() const noexcept;
 		[[nodiscard]] ZKAPI std::time_t time() const noexcept;
 		[[nodiscard]] ZKAPI std::string const& name() const noexcept;
@@ -75,6 +132,26 @@ namespace zenkit {
 
 		[[nodiscard]] ZKAPI std::unique_ptr<Read> open_read() const;
 
+		/// \brief Get a view of the contents of this file without copying them.
+		///
+		/// Files are always stored in contiguous memory, either in a memory-mapped disk or host file or in a buffer
+		/// owned by the Vfs. The view points directly into that memory and stays valid as long as the node exists,
+		/// so the contents can be uploaded to GPU or audio buffers without going through a Read.
+		///
+		/// \return A span over the contents of the file.
+		/// \throws std::bad_variant_access if this node is a directory.
+		/// \throws std::runtime_error if the disk the file lives on could not be mapped.
+		[[nodiscard]] ZKAPI ReadSpan data_view() const;
+
+		/// \brief Get the 64-bit xxHash (XXH64, seed 0) of the contents of this file.
+		///
+		/// If the file was mounted with Vfs::set_hash_files enabled, the hash is returned immediately. Otherwise it
+		/// is calculated from the contents of the file on every call.
+		///
+		/// \return The hash of the file's contents.
+		/// \throws std::bad_variant_access if this node is a directory.
+		[[nodiscard]] ZKAPI std::uint64_t hash() const;
+
 		[[nodiscard]] ZKAPI static VfsNode directory(std::string_view name);
 		[[nodiscard]] ZKAPI static VfsNode file(std::string_view name, VfsFileDescriptor dev);
 
@@ -86,9 +163,35 @@ namespace zenkit {
 		ZKAPI explicit VfsNode(std::string_view name, VfsFileDescriptor dev, std::time_t ts);
 
 	private:
+		friend class Vfs;
+
+		/// \brief The children of a directory and the index of the Vfs it belongs to, if any.
+		///
+		/// Only directories can be modified, so files don't need to know their Vfs. Copies of a directory don't
+		/// belong to any Vfs until they are inserted.
+		struct Directory {
+			ChildContainer children;
+			std::shared_ptr<detail::VfsIndexCache> index;
+
+			Directory() = default;
+			Directory(Directory const& cpy) : children(cpy.children) {}
+			Directory(Directory&& mv) noexcept = default;
+			~Directory() noexcept = default;
+
+			Directory& operator=(Directory const& cpy) {
+				children = cpy.children;
+				return *this;
+			}
+
+			Directory& operator=(Directory&& mv) noexcept = default;
+		};
+
+		/// \brief Make this directory and all directories below it invalidate the given index when they are modified.
+		ZKINT void attach(std::shared_ptr<detail::VfsIndexCache> const& index);
+
 		std::string _m_name;
 		std::time_t _m_time;
-		std::variant<ChildContainer, VfsFileDescriptor> _m_data;
+		std::variant<Directory, VfsFileDescriptor> _m_data;
 	};
 
 	enum class VfsOverwriteBehavior {
@@ -98,11 +201,73 @@ namespace zenkit {
 		OLDER = 3, ///< Overwrite older conflicting nodes.
 	};
 
+	/// \brief Options for Vfs::save.
+	struct VfsSaveOptions {
+		/// \brief Store the contents of files which are byte-identical only once.
+		///
+		/// All their catalog entries then point to the same data. Candidates are found using VfsNode::hash.
+		bool deduplicate = false;
+
+		/// \brief Store file contents in the order the files were first opened in.
+		///
+		/// Requires access statistics to have been collected using Vfs::set_access_stats. Files which were never
+		/// opened are stored last. The catalog itself is not affected.
+		bool access_order = false;
+	};
+
+	/// \brief Access statistics of a single file. See Vfs::access_stats.
+	struct VfsFileAccess {
+		/// \brief The path of the file, using the names as stored in the tree.
+		std::string path;
+
+		/// \brief The number of times the file was opened.
+		std::uint32_t opens;
+
+		/// \brief The position of the file in the order in which files were first opened, starting at 1.
+		std::uint64_t first_access;
+
+		/// \brief The number of bytes handed out by opening the file, i.e. its size times #opens.
+		std::uint64_t bytes;
+	};
+
+	/// \brief Access statistics of a single host file, e.g. a disk. See Vfs::access_stats.
+	struct VfsSourceAccess {
+		std::filesystem::path host;
+		std::uint32_t opens;
+		std::uint64_t bytes;
+	};
+
+	struct VfsAccessStats {
+		/// \brief All files which were opened at least once, in the order they were first opened in.
+		std::vector<VfsFileAccess> files;
+
+		/// \brief The totals for all host files the Vfs was mounted from.
+		std::vector<VfsSourceAccess> sources;
+	};
+
 	/// \brief An implementation of the virtual file system.
+	///
+	/// <p>Once mounting is complete, #resolve, #find and VfsNode::open_read may be called from any number of threads
+	/// at the same time without any locking. If the file system is also modified at runtime, all functions which
+	/// change it take an exclusive lock internally and readers must hold the lock returned by #lock_shared for as
+	/// long as they use any node of the file system.</p>
+	///
 	/// \see https://zk.gothickit.dev/library/api/virtual-file-system/
 	class Vfs {
 	public:
 		ZKAPI Vfs();
+		ZKAPI Vfs(Vfs&&) noexcept;
+		ZKAPI ~Vfs() noexcept;
+
+		ZKAPI Vfs& operator=(Vfs&&) noexcept;
+
+		/// \brief Acquire shared access to the file system.
+		///
+		/// This is only required if the file system is modified while other threads read from it. Changes wait for
+		/// all shared locks to be released, so a thread must not modify the file system while holding one itself.
+		///
+		/// \return A lock which grants shared access until it is released.
+		[[nodiscard]] ZKAPI std::shared_lock<std::shared_mutex> lock_shared() const;
 
 		/// \brief Get the root node of the file system structure.
 		/// \return The root node of the file system structure.
@@ -145,6 +310,51 @@ namespace zenkit {
 		ZKAPI void mount_disk(std::filesystem::path const& host,
 		                      VfsOverwriteBehavior overwrite = VfsOverwriteBehavior::OLDER);
 
+		/// \brief Enable or disable lazy mapping of disks.
+		///
+		/// <p>When enabled, #mount_disk, #mount_disks and #load_index only read the catalogs of disks from the host
+		/// file system. A disk is memory-mapped (or read, if memory-mapping is not available) only once a file
+		/// stored on it is opened for the first time. This saves address space for disks which are never used,
+		/// which matters on 32-bit and WebAssembly targets. Disabled by default.</p>
+		///
+		/// \param enable Whether to map disks lazily.
+		ZKAPI void set_lazy_disks(bool enable) noexcept;
+
+		/// \brief Enable or disable hashing the contents of files as they are mounted.
+		///
+		/// <p>When enabled, the hash returned by VfsNode::hash is calculated once for every file mounted afterwards
+		/// instead of on every call. #mount_disks hashes the files of each disk on its worker thread. Hashing reads
+		/// every file, so lazily mapped disks are mapped immediately. Disabled by default.</p>
+		///
+		/// \param enable Whether to hash files while mounting them.
+		ZKAPI void set_hash_files(bool enable) noexcept;
+
+		/// \brief Enable or disable collecting access statistics.
+		///
+		/// <p>When enabled, every call to VfsNode::open_read and VfsNode::data_view on a file in this Vfs is counted,
+		/// including files mounted later on. This only costs an atomic increment per call. Use #access_stats to
+		/// retrieve the counters and VfsSaveOptions::access_order to lay out a disk according to them. Disabling
+		/// statistics discards all counters. Disabled by default.</p>
+		///
+		/// \param enable Whether to collect access statistics.
+		ZKAPI void set_access_stats(bool enable);
+
+		/// \brief Get the access statistics collected since they were enabled using #set_access_stats.
+		/// \return The access statistics of all files and host files which were opened at least once.
+		[[nodiscard]] ZKAPI VfsAccessStats access_stats() const;
+
+		/// \brief Mount multiple disk files at once.
+		///
+		/// The catalogs of all disks are loaded and parsed in parallel. Afterwards, they are merged into the file
+		/// system in the order given, so the result is the same as calling #mount_disk for each of them in turn.
+		///
+		/// \param hosts The paths of the disks to mount.
+		/// \param overwrite The behavior of the system when conflicting files are found.
+		/// \throws VfsBrokenDiskError if one of the disks is corrupted or invalid. All disks preceding it in \p hosts
+		///                            are mounted regardless.
+		ZKAPI void mount_disks(std::vector<std::filesystem::path> const& hosts,
+		                       VfsOverwriteBehavior overwrite = VfsOverwriteBehavior::OLDER);
+
 		/// \brief Mount the disk file in the given buffer into the file system.
 		///
 		/// The disk contents are mounted at the root node of the file system and existing
@@ -155,6 +365,23 @@ namespace zenkit {
 		/// \throws VfsBrokenDiskError if the disk file is corrupted or invalid and thus, can't be loaded.
 		ZKAPI void mount_disk(Read* buf, VfsOverwriteBehavior overwrite = VfsOverwriteBehavior::OLDER);
 
+		/// \brief Mount a disk whose files are read from the given stream on demand.
+		///
+		/// <p>Only the header and catalog of the disk are read while mounting. Afterwards, VfsNode::open_read reads
+		/// the contents of a file from \p source into a buffer owned by the returned stream, so only files which are
+		/// actually opened are transferred. This is meant for disks which are not stored locally, e.g. ones which are
+		/// fetched using HTTP range requests. VfsNode::data_view and VfsNode::hash read a file once and keep it in
+		/// memory for as long as the disk is mounted.</p>
+		///
+		/// <p>The stream is shared by all files of the disk. It is only used by one thread at a time.</p>
+		///
+		/// \param source The stream to read the disk from. It is owned by the Vfs.
+		/// \param overwrite The behavior of the system when conflicting files are found.
+		/// \throws VfsBrokenDiskError if the disk file is corrupted or invalid and thus, can't be loaded.
+		/// \throws std::runtime_error if a file could not be fully read from \p source when it is opened.
+		ZKAPI void mount_disk_streamed(std::unique_ptr<Read> source,
+		                               VfsOverwriteBehavior overwrite = VfsOverwriteBehavior::OLDER);
+
 		/// \brief Mount a file or directory from the host file system into the Vfs.
 		/// \note If a path to a directory is provided, only its children are mounted, not the directory itself.
 		/// \param host The path of the file or directory to mount.
@@ -166,7 +393,33 @@ namespace zenkit {
 		                      std::string_view parent,
 		                      VfsOverwriteBehavior overwrite = VfsOverwriteBehavior::ALL);
 
+		/// \brief Watch a host directory mounted using #mount_host for changes.
+		///
+		/// <p>Changes are not applied automatically. Instead, #poll_host_changes must be called regularly, for example
+		/// once per frame, to update the nodes which correspond to the changed host files and directories. Only the
+		/// changed nodes are replaced or removed, which is much faster than re-mounting the whole directory.</p>
+		///
+		/// <p>On Linux, changes are reported by inotify. On other platforms, the directory tree is scanned for
+		/// changed modification times and sizes on every poll.</p>
+		///
+		/// \param host The path of the host directory to watch. This should match the path given to #mount_host.
+		/// \param parent The path of the node the directory was mounted into.
+		/// \throws Error if the directory cannot be watched.
+		ZKAPI void watch_host(std::filesystem::path const& host, std::string_view parent);
+
+		/// \brief Apply all changes made to host directories watched using #watch_host since the last call.
+		///
+		/// Changed files are read into memory owned by their node, so they are not accounted for by #save_index.
+		/// Must not be called from multiple threads at the same time.
+		///
+		/// \return The number of changed host paths which were applied.
+		ZKAPI std::size_t poll_host_changes();
+
 		/// \brief Resolve the given path in the Vfs to a file system node.
+		///
+		/// Lookups are served from a hash index of all paths in the Vfs, which is rebuilt on the first lookup after
+		/// any node was added or removed.
+		///
 		/// \param path The path to the node to resolve.
 		/// \return The node at the given path or `nullptr` if the path could not be resolved.
 		[[nodiscard]] ZKAPI VfsNode const* resolve(std::string_view path) const noexcept;
@@ -177,6 +430,10 @@ namespace zenkit {
 		[[nodiscard]] ZKAPI VfsNode* resolve(std::string_view path) noexcept;
 
 		/// \brief Find the first node with the given name in the Vfs.
+		///
+		/// Like #resolve, this is served from a hash index. If multiple nodes share the same name, the one found
+		/// first by a depth-first search starting at the root is returned.
+		///
 		/// \param name The name of the node to find.
 		/// \return The node with the given name or `nullptr` if no node with the given name was found.
 		[[nodiscard]] ZKAPI VfsNode const* find(std::string_view name) const noexcept;
@@ -186,13 +443,96 @@ namespace zenkit {
 		/// \return The node with the given name or `nullptr` if no node with the given name was found.
 		[[nodiscard]] ZKAPI VfsNode* find(std::string_view name) noexcept;
 
-		ZKAPI void save(Write* w, GameVersion version, time_t unix_t = 0) const;
+		/// \brief Enumerate all nodes whose path matches the given glob pattern.
+		///
+		/// <p>The pattern is a path with segments separated by `/`. Within a segment, `*` matches any number of
+		/// characters and `?` matches exactly one character. A segment consisting only of `**` matches any number of
+		/// directories, including none. Like in #resolve, matching is case-insensitive and leading slashes are
+		/// ignored. For example, `_WORK/DATA/MESHES/**/*.MRM` matches all `.MRM` files in the `MESHES` directory
+		/// and all of its subdirectories.</p>
+		///
+		/// <p>Matching nodes are passed to the callback as they are found, so no list of results is built. Segments
+		/// without wildcards are looked up directly, so only the parts of the tree which can match are visited.</p>
+		///
+		/// \param pattern The glob pattern to match paths against.
+		/// \param cb A callback invoked with the path and node of every match. The path is only valid during the
+		///           call and uses the names as stored in the tree. Return `false` to stop the enumeration.
+		ZKAPI void enumerate(std::string_view pattern,
+		                     std::function<bool(std::string_view path, VfsNode const& node)> const& cb) const;
+
+		/// \brief Save the file system tree as a disk.
+		/// \param w The stream to write the disk to.
+		/// \param version The game version to write the disk for.
+		/// \param unix_t The timestamp to write to the disk or 0 to use the current time.
+		/// \param options Options controlling how file contents are stored.
+		ZKAPI void save(Write* w, GameVersion version, time_t unix_t = 0, VfsSaveOptions const& options = {}) const;
+
+		/// \brief Save the file system tree to a disk file on the host.
+		///
+		/// The output is the same as for #save, but the location of every file in the output is calculated up-front
+		/// and the file contents are copied into a memory-mapped output file by multiple threads at once. When memory
+		/// mapping is not available, this falls back to writing the disk sequentially.
+		///
+		/// \param path The path of the disk file to write.
+		/// \param version The game version to write the disk for.
+		/// \param unix_t The timestamp to write to the disk or 0 to use the current time.
+		/// \param options Options controlling how file contents are stored.
+		ZKAPI void save(std::filesystem::path const& path,
+		                GameVersion version,
+		                time_t unix_t = 0,
+		                VfsSaveOptions const& options = {}) const;
+
+		/// \brief Save the current file system tree to a catalog cache file.
+		///
+		/// The cache records the structure of the tree and, for every file, the host file and offset its contents
+		/// live at, together with the size and modification time of all host files. Use #load_index to restore it.
+		///
+		/// \param path The path of the cache file to write.
+		/// \throws Error if a file in the tree was not mounted from a host file, for example by mounting a disk from
+		///              memory or by creating the node manually.
+		ZKAPI void save_index(std::filesystem::path const& path) const;
+
+		/// \brief Restore a file system tree previously saved using #save_index.
+		///
+		/// <p>No disk catalogs are parsed. Instead, the host files referenced by the cache are mapped directly and the
+		/// cached tree is mounted into the root as if using VfsOverwriteBehavior::ALL. This is meant to be called on
+		/// an empty Vfs.</p>
+		///
+		/// <p>If the cache file is missing or invalid, or if any of the host files it references was modified since
+		/// the cache was written, nothing is mounted and `false` is returned. The caller should then mount the disks
+		/// as usual and call #save_index to update the cache.</p>
+		///
+		/// \param path The path of the cache file to load.
+		/// \return `true` if the cache was loaded and `false` if it is out of date.
+		/// \throws VfsBrokenDiskError if the cache file is truncated or corrupted.
+		ZKAPI bool load_index(std::filesystem::path const& path);
 
 	private:
 		ZKINT void mount_disk(std::byte const* buf, std::size_t size, VfsOverwriteBehavior overwrite);
+		[[nodiscard]] ZKINT detail::VfsIndex const& index() const;
+		[[nodiscard]] ZKINT VfsNode* walk(std::string_view path) noexcept;
+		ZKINT void layout(detail::VfsDiskLayout& layout, VfsSaveOptions const& options) const;
+		ZKINT void attach_stats(VfsNode& node);
+		[[nodiscard]] ZKINT std::vector<std::uint32_t> source_order() const;
+		[[nodiscard]] ZKINT bool find_source(std::vector<std::uint32_t> const& order,
+		                                     VfsFileDescriptor const& fd,
+		                                     std::uint32_t& source,
+		                                     std::uint64_t& offset) const;
+		ZKINT static void hash_tree(VfsNode& node);
+		ZKINT void apply_host_change(detail::VfsHostWatch const& watch, std::filesystem::path const& rel);
+		ZKINT void add_source(std::filesystem::path const& path,
+		                      std::byte const* data,
+		                      std::size_t size,
+		                      std::shared_ptr<detail::VfsLazyDisk> lazy = {});
 
 		VfsNode _m_root;
+		std::unique_ptr<detail::VfsState> _m_state;
+		std::vector<detail::VfsSource> _m_sources;
+		bool _m_lazy_disks {false};
+		bool _m_hash_files {false};
+		bool _m_access_stats {false};
 		std::vector<std::unique_ptr<std::byte[]>> _m_data;
+		std::vector<std::unique_ptr<detail::VfsHostWatch>> _m_watches;
 
 #ifdef _ZK_WITH_MMAP
 		std::vector<Mmap> _m_data_mapped;
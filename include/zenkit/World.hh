@@ -9,10 +9,15 @@
 #include "zenkit/world/VobTree.hh"
 #include "zenkit/world/WayNet.hh"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace zenkit {
+	class Vfs;
 	struct VNpc;
 	struct CutsceneContext;
 
@@ -62,6 +67,50 @@ namespace zenkit {
 		float timer;
 	};
 
+	/// \brief Options for loading only selected parts of a world.
+	/// \see World::load
+	struct WorldLoadOptions {
+		/// \brief The classes of VObs to load. If empty, all VObs are loaded.
+		///
+		/// VObs of other classes are skipped without being allocated. Their loaded descendants are attached to
+		/// the closest loaded ancestor or, if there is none, to World::world_vobs directly.
+		std::vector<ObjectType> vob_classes {};
+
+		/// \brief Set to `true` to leave World::world_mesh empty.
+		bool skip_mesh = false;
+
+		/// \brief Set to `true` to leave World::world_bsp_tree empty.
+		bool skip_bsp = false;
+
+		/// \brief Set to `true` to leave the way-net of the world empty.
+		bool skip_way_net = false;
+
+		/// \brief Set to `true` to leave World::world_vobs empty.
+		bool skip_vobs = false;
+
+		/// \brief Set to `true` to leave World::npcs and World::npc_spawns of save-game worlds empty.
+		bool skip_npcs = false;
+
+		/// \brief Set to `true` to decode the mesh and BSP-tree using the ::get_executor while the VOb tree is loaded.
+		/// \note Ignored on platforms without thread support.
+		bool parallel = false;
+
+		/// \brief The arena to allocate the objects of the world in or `nullptr` to use the heap.
+		/// \see ObjectArena
+		std::shared_ptr<ObjectArena> arena {};
+
+		/// \brief The resource to allocate the objects of the world from if #arena is `nullptr`.
+		///
+		/// If set, the objects are allocated in a new arena which takes its blocks from this resource. Pass a
+		/// MemoryTracker to measure the memory used by the VObs of the world. The resource has to outlive the world.
+		MemoryResource* memory {nullptr};
+
+		/// \brief The registry to intern the materials of World::world_mesh in or `nullptr` to leave
+		///        Mesh::material_handles empty.
+		/// \see Mesh::intern_materials
+		MaterialRegistry* materials {nullptr};
+	};
+
 	/// \brief Represents a ZenGin world.
 	class World : public Object {
 		ZK_OBJECT(ObjectType::oCWorld);
@@ -69,10 +118,98 @@ namespace zenkit {
 		ZKAPI void load(Read* r);
 		ZKAPI void load(Read* r, GameVersion version);
 
+		/// \brief Load the world, allocating all objects it contains in the given arena.
+		/// \param r The stream to read the world from.
+		/// \param version The game version the world was made for.
+		/// \param arena The arena to allocate the VObs, visuals and other objects of the world in.
+		/// \see ObjectArena
+		ZKAPI void load(Read* r, GameVersion version, std::shared_ptr<ObjectArena> arena);
+
+		/// \brief Load only selected parts of the world.
+		/// \param r The stream to read the world from.
+		/// \param version The game version the world was made for.
+		/// \param options Selects the parts of the world to load.
+		ZKAPI void load(Read* r, GameVersion version, WorldLoadOptions const& options);
+
+		/// \brief Load only selected parts of the world, detecting the game version it was made for like load(Read*).
+		/// \param r The stream to read the world from.
+		/// \param options Selects the parts of the world to load.
+		ZKAPI void load(Read* r, WorldLoadOptions const& options);
+
+		/// \brief Saves the world in a format which loads much faster than a world archive.
+		///
+		/// <p>The mesh and the BSP-tree are stored after triangulation with all of their arrays in their in-memory
+		/// representation, so loading them only copies memory. VObs and materials are stored in binary archives.
+		/// Each part is stored in its own 16-byte aligned section, addressed relative to the start of the cooked
+		/// world, so it can be loaded straight from a memory-mapped file (see Read::from) or from within a larger
+		/// file. Like compiled scripts, cooked worlds can only be loaded by builds of ZenKit using the same in-memory
+		/// representation.</p>
+		///
+		/// <p>The NPCs, the cutscene player and the sky controller of save-game worlds are not saved.</p>
+		///
+		/// \param w The stream to write the cooked world to.
+		/// \param version The game version to save the VObs and materials for.
+		/// \param assets If not `nullptr`, the compiled textures and multi-resolution meshes used by the world are
+		///               looked up in this file system and stored as part of the cooked world.
+		/// \see #load_cooked
+		ZKAPI void save_cooked(Write* w, GameVersion version, Vfs const* assets = nullptr) const;
+
+		/// \brief Loads a world saved using #save_cooked.
+		///
+		/// <p>All options are supported. With WorldLoadOptions::parallel, the mesh and the BSP-tree are loaded using
+		/// the ::get_executor while the VObs are loaded.</p>
+		///
+		/// \param r The stream to read the cooked world from.
+		/// \param options Selects the parts of the world to load.
+		/// \param assets If not `nullptr`, the assets stored in the cooked world are mounted into this file system.
+		/// \throws ParserError if \p r does not contain a cooked world or if it was saved by an incompatible build.
+		ZKAPI void load_cooked(Read* r, WorldLoadOptions const& options = {}, Vfs* assets = nullptr);
+
 		ZKAPI void load(ReadArchive& r, GameVersion version) override;
 		ZKAPI void save(WriteArchive& w, GameVersion version) const override;
 		[[nodiscard]] ZKAPI uint16_t get_version_identifier(GameVersion game) const override;
 
+		/// \brief Packs the bounding boxes of all VObs of the world, including their children, for culling.
+		///
+		/// Build the set once after loading the world and cull it using BoundingBoxSet::cull each frame instead
+		/// of walking #world_vobs. The set must be rebuilt if VObs are added, removed or moved.
+		///
+		/// \param vobs Receives the VObs in depth-first order. It is cleared first.
+		/// \return The bounding boxes of the VObs, where box `i` belongs to `vobs[i]`.
+		[[nodiscard]] ZKAPI BoundingBoxSet build_vob_bounds(std::vector<VirtualObject*>& vobs) const;
+
+		/// \brief Finds a VOb of the world or one of their children by its VirtualObject::vob_name, ignoring case.
+		///
+		/// <p>The first lookup builds an index of all names, so repeated lookups don't need to walk the VOb tree.
+		/// Call #invalidate_vob_index after adding, removing or renaming VObs. Because the index is built lazily,
+		/// lookups must not run concurrently until the first one has returned.</p>
+		///
+		/// \param name The name of the VOb to find.
+		/// \return The first VOb with the given name in depth-first order or `nullptr` if there is none.
+		[[nodiscard]] ZKAPI VirtualObject* find_vob(std::string_view name) const;
+
+		/// \brief Finds all VObs of the world or one of their children with the given name, ignoring case.
+		/// \param name The name of the VObs to find.
+		/// \param vobs Receives the VObs in depth-first order. It is cleared first.
+		/// \see #find_vob
+		ZKAPI void find_vobs(std::string_view name, std::vector<VirtualObject*>& vobs) const;
+
+		/// \brief Finds a waypoint of the way-net of the world by its name, ignoring case.
+		///
+		/// <p>Like #find_vob, the first lookup builds an index. Call #invalidate_waypoint_index after changing the
+		/// way-net.</p>
+		///
+		/// \param name The name of the waypoint to find.
+		/// \return The index of the waypoint in WayNet::waypoints (or WayNet::points with `ZK_FUTURE`) or
+		///         `std::nullopt` if there is none.
+		[[nodiscard]] ZKAPI std::optional<std::uint32_t> find_waypoint(std::string_view name) const;
+
+		/// \brief Drops the index used by #find_vob and #find_vobs. It is rebuilt by the next lookup.
+		ZKAPI void invalidate_vob_index() noexcept;
+
+		/// \brief Drops the index used by #find_waypoint. It is rebuilt by the next lookup.
+		ZKAPI void invalidate_waypoint_index() noexcept;
+
 		/// \brief The list of VObs defined in this world.
 		std::vector<std::shared_ptr<VirtualObject>> world_vobs;
 
@@ -101,5 +238,17 @@ namespace zenkit {
 
 		// \note Only available in save-games, otherwise null.
 		std::shared_ptr<SkyController> sky_controller;
+
+	private:
+		void load(ReadArchive& r, GameVersion version, WorldLoadOptions const& options);
+		void build_vob_index() const;
+
+		/// \brief The VObs ordered by the ihash of their name, in depth-first order for equal hashes.
+		mutable std::vector<std::pair<std::uint64_t, VirtualObject*>> _m_vob_names;
+		mutable bool _m_vob_names_valid {false};
+
+		/// \brief The indices of the waypoints ordered by the ihash of their name.
+		mutable std::vector<std::pair<std::uint64_t, std::uint32_t>> _m_waypoint_names;
+		mutable bool _m_waypoint_names_valid {false};
 	};
 } // namespace zenkit
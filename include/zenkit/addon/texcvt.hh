@@ -4,11 +4,71 @@
 #include "zenkit/Library.hh"
 #include "zenkit/Texture.hh"
 
+#include <cstdint>
+#include <functional>
+#include <string_view>
 #include <vector>
 
 namespace zenkit {
+	class Vfs;
+
+	/// \brief The formats textures can be stored in by #to_ktx2.
+	enum class Ktx2Format {
+		/// \brief Stores the texture data as-is if KTX2 supports its format, otherwise as RGBA8. DXT1, DXT3 and DXT5
+		///        are stored as BC1, BC2 and BC3 without being decoded.
+		NATIVE,
+
+		/// \brief Decodes the texture to 32-bit RGBA.
+		RGBA8,
+
+		/// \brief Transcodes the texture to BC7.
+		BC7,
+	};
+
 	/// \brief Converts a texture to the DDS format.
 	/// \param tex The texture to convert.
 	/// \return A buffer containing the DDS file.
 	[[nodiscard]] ZKAPI std::vector<std::byte> to_dds(Texture const& tex);
+
+	/// \brief Converts a texture to the KTX2 format.
+	///
+	/// <p>Textures transcoded to BC7 are decoded and then encoded block by block, which runs on multiple threads for
+	/// large textures. BC7 keeps the quality of the DXT source while being supported natively by modern desktop
+	/// GPUs and WebGPU.</p>
+	///
+	/// \param tex The texture to convert.
+	/// \param format The format to store the texture data in.
+	/// \param thread_count The maximum number of threads to transcode the texture on. Set to `0` to use all threads
+	///                     of the ::get_executor.
+	/// \return A buffer containing the KTX2 file.
+	/// \throws ParserError if the texture cannot be decoded.
+	[[nodiscard]] ZKAPI std::vector<std::byte>
+	to_ktx2(Texture const& tex, Ktx2Format format = Ktx2Format::NATIVE, std::uint32_t thread_count = 0);
+
+	/// \brief Encodes a texture into the contents of a file, for example using #to_dds or #to_ktx2.
+	using TextureEncoder = std::function<std::vector<std::byte>(Texture const& tex)>;
+
+	/// \brief Receives the path and the encoded contents of a converted texture.
+	using TextureSink = std::function<void(std::string_view path, std::vector<std::byte> const& data)>;
+
+	/// \brief Loads and encodes all textures in a Vfs matching a glob pattern.
+	///
+	/// <p>Textures are loaded and encoded on \p thread_count worker threads and handed to \p sink on the calling
+	/// thread in the order they finish. Workers pause while twice as many converted textures as there are workers
+	/// are waiting for the sink, which bounds the memory in flight if the sink is slower than the workers.</p>
+	///
+	/// <p>\p encoder is called concurrently from multiple threads. Textures which cannot be loaded or encoded are
+	/// logged and skipped.</p>
+	///
+	/// \param vfs The Vfs to load textures from.
+	/// \param pattern A glob pattern matching the textures to convert, see Vfs::enumerate.
+	/// \param encoder The function to encode each texture with.
+	/// \param sink The function to pass each encoded texture to.
+	/// \param thread_count The number of worker threads or `0` to use one thread for each hardware thread.
+	/// \return The number of textures passed to \p sink.
+	ZKAPI std::size_t convert_all(Vfs const& vfs,
+	                              std::string_view pattern,
+	                              TextureEncoder const& encoder,
+	                              TextureSink const& sink,
+	                              std::uint32_t thread_count = 0);
 } // namespace zenkit
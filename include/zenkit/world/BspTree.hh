@@ -8,10 +8,13 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <optional>
 
 namespace zenkit {
 	class Read;
 	class Write;
+	class Mesh;
+	class BspTree;
 
 	enum class BspTreeType : std::uint32_t {
 		INDOOR = 0,
@@ -45,6 +48,98 @@ namespace zenkit {
 		std::vector<std::uint32_t> portal_polygon_indices;
 	};
 
+	/// \brief An inner node of a BspTraversal.
+	struct BspTraversalNode {
+		/// \brief The plane of the node, see BspNode::plane.
+		Vec4 plane;
+
+		/// \brief The children of the node. Inner nodes are indices into BspTraversal::nodes and leaf nodes are
+		///        indices into BspTraversal::leaves with BspTraversal::LEAF set. Missing children are
+		///        BspTraversal::NONE.
+		std::uint32_t front;
+		std::uint32_t back;
+	};
+
+	/// \brief A compact copy of the planes and links of BspTree::nodes used by the queries of BspTree.
+	///
+	/// <p>Only what is needed to walk the tree is kept, so walking it touches far fewer cache lines than walking
+	/// BspTree::nodes. Inner nodes are stored depth-first, with the front child of each node directly following it.
+	/// Bounding boxes and polygons are only looked up in BspTree::nodes once a leaf is reached.</p>
+	///
+	/// \see BspTree::build_traversal
+	struct BspTraversal {
+		static constexpr std::uint32_t LEAF = 0x80000000;
+		static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+
+		/// \brief The root of the tree. Encoded like the children of a BspTraversalNode.
+		std::uint32_t root {NONE};
+
+		/// \brief All inner nodes.
+		std::vector<BspTraversalNode> nodes;
+
+		/// \brief The index of each leaf node in BspTree::nodes.
+		std::vector<std::uint32_t> leaves;
+	};
+
+	/// \brief The polygon hit by a ray cast using BspTree::raycast.
+	struct BspRaycastHit {
+		/// \brief The distance from the origin of the ray to #point.
+		float distance;
+
+		/// \brief The point at which the ray hit the polygon.
+		Vec3 point;
+
+		/// \brief The index of the polygon in Mesh::geometry.
+		std::uint32_t polygon;
+
+		/// \brief The index of the leaf node the polygon was found in.
+		std::uint32_t node;
+	};
+
+	/// \brief Precomputed sector-to-sector visibility of an indoor BspTree.
+	///
+	/// <p>Sectors are connected through the portal polygons listed in BspSector::portal_polygon_indices. Two
+	/// sectors are neighbours if they list the same portal polygon or two portal polygons with the same vertex
+	/// positions. A portal listed by only one sector connects it to the outside, which is treated as an additional
+	/// sector with the index #outside.</p>
+	///
+	/// <p>A sector is considered visible from another one if there is a chain of portals leading to it where each
+	/// portal lies at least partly beyond the planes of all portals before it. This is conservative: sectors
+	/// may be reported as visible even though they are not, but never the other way round.</p>
+	///
+	/// <p>Building the visibility is expensive, so it should be computed once and stored next to the world using
+	/// #save. At runtime, #is_visible is a single bit lookup.</p>
+	///
+	/// \see BspTree::build_visibility
+	class BspVisibility {
+	public:
+		/// \brief Loads visibility stored using #save.
+		/// \param r The stream to read from.
+		/// \param tree The tree the visibility will be used with.
+		/// \return `false` if the stream does not contain visibility or if it was built for a tree with different
+		///         sectors. The visibility is left unchanged in that case.
+		ZKAPI bool load(Read* r, BspTree const& tree);
+
+		/// \brief Stores the visibility in a compact binary format.
+		/// \param w The stream to write to.
+		ZKAPI void save(Write* w) const;
+
+		/// \param from The index of the sector the viewer is in or #outside.
+		/// \param to The index of the sector to test or #outside.
+		/// \return Whether \p to may be visible from \p from. Always `false` for invalid indices.
+		[[nodiscard]] ZKAPI bool is_visible(std::uint32_t from, std::uint32_t to) const noexcept;
+
+		/// \brief The index used for the space outside of all sectors. Equal to the number of sectors.
+		std::uint32_t outside {0};
+
+		/// \brief A hash of the sectors of the tree the visibility was built for.
+		std::uint64_t fingerprint {0};
+
+		/// \brief One row of `outside + 1` bits per sector, each padded to whole words. Bit `to` of row `from` is
+		///        set if sector `to` may be visible from sector `from`.
+		std::vector<std::uint64_t> bits;
+	};
+
 	/// \brief Represents a binary space partitioning tree as implemented in the ZenGin.
 	///
 	/// [Binary space partitioning](https://en.wikipedia.org/wiki/Binary_space_partitioning) is used for rapidly
@@ -54,6 +149,72 @@ namespace zenkit {
 		ZKINT void load(Read* r, std::uint32_t version);
 		ZKINT void save(Write* w, GameVersion version) const;
 
+		/// \brief Writes the tree including #traversal in its in-memory representation for World::save_cooked.
+		ZKINT void save_cooked(Write* w) const;
+
+		/// \brief Reads a tree written by #save_cooked.
+		ZKINT void load_cooked(Read* r);
+
+		/// \brief Rebuilds #traversal from #nodes.
+		///
+		/// This is done when loading the tree. If #nodes is changed afterwards, this function must be called again
+		/// before running any queries. If the node count of #traversal does not match #nodes, each query builds a
+		/// temporary traversal instead.
+		ZKAPI void build_traversal();
+
+		/// \brief Finds the leaf node containing the given point.
+		///
+		/// <p>Starting at the root, the point is tested against the plane of each node. Points on the front side
+		/// of a plane, where `dot(plane.xyz, point) - plane.w >= 0`, continue with the front child of the node and
+		/// all other points continue with the back child.</p>
+		///
+		/// \param point The point to locate.
+		/// \return The index of the leaf node in #nodes or -1 if the point is in a part of space not covered by any
+		///         leaf.
+		[[nodiscard]] ZKAPI std::int32_t find_leaf(Vec3 const& point) const noexcept;
+
+		/// \brief Finds the sector containing the given point.
+		/// \param point The point to locate.
+		/// \return The sector listing the leaf node containing \p point or `nullptr` if there is none.
+		/// \see #find_leaf
+		[[nodiscard]] ZKAPI BspSector const* sector_at(Vec3 const& point) const noexcept;
+
+		/// \brief Finds the first polygon of the given mesh hit by a ray.
+		///
+		/// <p>Only the leaf nodes the ray passes through are tested, visiting them from front to back. Polygons
+		/// which are not part of Mesh::polygons, like portals, are ignored. Both sides of a polygon are hit.</p>
+		///
+		/// \param mesh The mesh the tree was loaded with, usually World::world_mesh.
+		/// \param origin The origin of the ray.
+		/// \param direction The direction of the ray. It does not need to be normalized.
+		/// \param max_distance The maximum distance from \p origin at which polygons are hit.
+		/// \return The closest polygon hit or `std::nullopt` if the ray doesn't hit any polygon.
+		[[nodiscard]] ZKAPI std::optional<BspRaycastHit>
+		raycast(Mesh const& mesh, Vec3 const& origin, Vec3 const& direction, float max_distance) const;
+
+		/// \brief Finds all leaf nodes whose bounding box is not completely outside the given frustum.
+		///
+		/// <p>The tree is walked from the root using the bounding box of each node. Subtrees outside the frustum
+		/// are skipped and subtrees completely inside it are added without testing them any further. Planes a node
+		/// is completely in front of are not tested again for its children.</p>
+		///
+		/// \param frustum The frustum to cull the tree against.
+		/// \param leaves Receives the indices of the visible leaf nodes in #nodes. It is cleared first.
+		/// \see Frustum::test
+		ZKAPI void cull(Frustum const& frustum, std::vector<std::uint32_t>& leaves) const;
+
+		/// \brief Computes which sectors of the tree can see each other through their portals.
+		///
+		/// This is only useful for indoor trees, since outdoor trees usually have no sectors. The result can be
+		/// stored using BspVisibility::save and loaded again using BspVisibility::load.
+		///
+		/// \param mesh The mesh the tree was loaded with, usually World::world_mesh.
+		/// \return The sector-to-sector visibility of the tree.
+		[[nodiscard]] ZKAPI BspVisibility build_visibility(Mesh const& mesh) const;
+
+		/// \return A hash of the sectors of the tree, used to check that a BspVisibility belongs to it.
+		[[nodiscard]] ZKAPI std::uint64_t sector_fingerprint() const noexcept;
+
 		/// \brief The mode of the tree (either indoor or outdoor).
 		BspTreeType mode;
 
@@ -77,5 +238,8 @@ namespace zenkit {
 
 		/// \brief All BSP leaf node indices.
 		std::vector<std::uint64_t> leaf_node_indices;
+
+		/// \brief The compact copy of #nodes used by #find_leaf, #sector_at and #raycast.
+		BspTraversal traversal;
 	};
 } // namespace zenkit
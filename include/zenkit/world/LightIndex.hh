@@ -0,0 +1,80 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Boxes.hh"
+#include "zenkit/Library.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstdint>
+#include <vector>
+
+namespace zenkit {
+	class World;
+	class BspTree;
+	struct VLight;
+
+	/// \brief Lists the light VObs which can reach each leaf of a BSP-tree.
+	///
+	/// <p>The reach of a light is a sphere around its position with the radius returned by #radius_of. Each light is
+	/// added to every leaf node whose bounding box overlaps its sphere, so renderers only need to consider the
+	/// lights listed for the leaves they draw. The lists are stored in compressed sparse row form: the lights of node
+	/// `i` are `lights[indices[offsets[i]]]` up to `lights[indices[offsets[i + 1]]]`. Inner nodes have no lights.
+	/// </p>
+	///
+	/// <p>The index does not own the lights. It has to be rebuilt when lights are added, removed or moved.</p>
+	class LightIndex {
+	public:
+		/// \brief Replaces the contents of the index with all light VObs of the world, including children, and lists
+		///        them for the leaves of World::world_bsp_tree.
+		/// \param world The world to index.
+		ZKAPI void build(World const& world);
+
+		/// \brief Replaces the contents of the index with the given lights.
+		/// \param lights The lights to index. They must remain valid while the index is used.
+		/// \param tree The tree to list the lights for the leaves of.
+		ZKAPI void build(std::vector<VLight*> const& lights, BspTree const& tree);
+
+		/// \return The number of lights in the index.
+		[[nodiscard]] std::size_t size() const noexcept {
+			return lights.size();
+		}
+
+		/// \brief Finds the lights listed for a node of the BSP-tree.
+		/// \param node The index of the node in BspTree::nodes.
+		/// \param result Receives the lights. It is cleared first.
+		ZKAPI void query_leaf(std::uint32_t node, std::vector<VLight*>& result) const;
+
+		/// \brief Finds the lights which reach the given point.
+		/// \param tree The tree the index was built for, used to find the leaf containing \p point.
+		/// \param point The point to find the lights for.
+		/// \param result Receives the lights. It is cleared first.
+		ZKAPI void query_point(BspTree const& tree, Vec3 const& point, std::vector<VLight*>& result) const;
+
+		/// \brief Finds the lights which reach any part of the given box.
+		/// \param box The box to find the lights for.
+		/// \param result Receives the lights. It is cleared first.
+		ZKAPI void query_box(AxisAlignedBoundingBox const& box, std::vector<VLight*>& result) const;
+
+		/// \brief Computes how far a light can reach.
+		/// \param light The light.
+		/// \return LightPreset::range scaled by the largest value of LightPreset::range_animation_scale, if it is
+		///         larger than `1`.
+		[[nodiscard]] ZKAPI static float radius_of(VLight const& light) noexcept;
+
+		/// \brief The lights in the index.
+		std::vector<VLight*> lights;
+
+		/// \brief The position of each light.
+		std::vector<Vec3> positions;
+
+		/// \brief The radius of each light, see #radius_of.
+		std::vector<float> radii;
+
+		/// \brief For each node of the tree, the index of its first light in #indices. Contains one more element
+		///        than the tree has nodes.
+		std::vector<std::uint32_t> offsets;
+
+		/// \brief The indices in #lights of the lights of all nodes.
+		std::vector<std::uint32_t> indices;
+	};
+} // namespace zenkit
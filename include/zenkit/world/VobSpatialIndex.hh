@@ -0,0 +1,115 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Boxes.hh"
+#include "zenkit/Library.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace zenkit {
+	class World;
+	struct VirtualObject;
+
+	/// \brief A uniform grid over the bounding boxes of VObs for answering spatial queries.
+	///
+	/// <p>Each VOb is added to every grid cell its box overlaps, so queries only need to look at the cells they
+	/// touch instead of walking all VObs of a world. VObs spanning more than #MAX_CELLS cells, like the level mesh
+	/// VOb, are kept in a separate list which every query tests directly.</p>
+	///
+	/// <p>The bounds of a VOb are taken from VirtualObject::bbox. VObs without a visual usually have an empty
+	/// bounding box which does not contain their position; the point at VirtualObject::position is used for them
+	/// instead. The index does not own the VObs and has to be updated using #update whenever one of them moves or
+	/// using #remove before one of them is destroyed.</p>
+	///
+	/// <p>Queries may run concurrently with each other, but not with any modification of the index.</p>
+	class ZKAPI VobSpatialIndex {
+	public:
+		/// \brief The maximum number of cells a VOb is added to before it is tested by every query instead.
+		static constexpr std::uint32_t MAX_CELLS = 64;
+
+		/// \param cell_size The edge length of each grid cell in world units. Should be on the order of the size of
+		///                  a typical VOb and the radius of typical queries.
+		explicit VobSpatialIndex(float cell_size = 1000.0f);
+
+		/// \brief Replaces the contents of the index with all VObs of the given world, including their children.
+		/// \param world The world to index.
+		void build(World const& world);
+
+		/// \brief Adds a VOb to the index. Its children are not added.
+		///
+		/// If the VOb is already in the index, this is the same as calling #update.
+		///
+		/// \param vob The VOb to add. Must remain valid until it is removed from the index.
+		void insert(VirtualObject* vob);
+
+		/// \brief Removes a VOb from the index.
+		/// \param vob The VOb to remove.
+		/// \return `true` if the VOb was in the index.
+		bool remove(VirtualObject const* vob);
+
+		/// \brief Moves a VOb in the index after its position or bounding box changed.
+		///
+		/// If the VOb still overlaps the same grid cells, only its stored bounds are updated.
+		///
+		/// \param vob The VOb to update. If it is not in the index, it is added.
+		void update(VirtualObject* vob);
+
+		/// \brief Removes all VObs from the index.
+		void clear() noexcept;
+
+		/// \return The number of VObs in the index.
+		[[nodiscard]] std::size_t size() const noexcept;
+
+		/// \brief Finds all VObs whose bounds overlap the given box.
+		/// \param box The box to test.
+		/// \param vobs Receives the VObs found in no particular order. It is cleared first.
+		void query_box(AxisAlignedBoundingBox const& box, std::vector<VirtualObject*>& vobs) const;
+
+		/// \brief Finds all VObs whose bounds overlap the given sphere.
+		/// \param center The center of the sphere.
+		/// \param radius The radius of the sphere.
+		/// \param vobs Receives the VObs found in no particular order. It is cleared first.
+		void query_radius(Vec3 const& center, float radius, std::vector<VirtualObject*>& vobs) const;
+
+		/// \brief Finds all VObs whose bounds are hit by the given ray.
+		/// \param origin The start of the ray.
+		/// \param direction The direction of the ray. Does not need to be normalized.
+		/// \param max_distance The length of the ray in multiples of \p direction.
+		/// \param vobs Receives the VObs hit ordered by the distance at which the ray enters their bounds. It is
+		///             cleared first.
+		void query_ray(Vec3 const& origin,
+		               Vec3 const& direction,
+		               float max_distance,
+		               std::vector<VirtualObject*>& vobs) const;
+
+	private:
+		struct Entry {
+			VirtualObject* vob;
+			AxisAlignedBoundingBox box;
+			std::int32_t min[3];
+			std::int32_t max[3];
+			bool oversized;
+		};
+
+		[[nodiscard]] std::int32_t cell_of(float v) const noexcept;
+		[[nodiscard]] static std::uint64_t key_of(std::int32_t x, std::int32_t y, std::int32_t z) noexcept;
+
+		void link(std::uint32_t index);
+		void unlink(std::uint32_t index);
+		void collect(std::int32_t const (&min)[3], std::int32_t const (&max)[3], std::vector<std::uint32_t>& out) const;
+
+		float _m_cell_size;
+		std::vector<Entry> _m_entries;
+		std::vector<std::uint32_t> _m_free;
+		std::vector<std::uint32_t> _m_oversized;
+		std::unordered_map<VirtualObject const*, std::uint32_t> _m_lookup;
+		std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> _m_cells;
+
+		/// \brief The range of cells containing any VOb not in #_m_oversized. Never shrinks until #clear.
+		std::int32_t _m_bounds_min[3] {0, 0, 0};
+		std::int32_t _m_bounds_max[3] {-1, -1, -1};
+	};
+} // namespace zenkit
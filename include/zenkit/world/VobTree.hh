@@ -6,12 +6,72 @@
 #include "zenkit/vobs/VirtualObject.hh"
 
 #include <memory>
+#include <vector>
 
 namespace zenkit {
 	/// \brief Parses a VOB tree from the given reader.
 	/// \param in The reader to read from.
 	/// \param version The version of Gothic being used.
 	/// \return The tree parsed.
+	/// \note If the reader has a class filter set, use the overload below instead, since it keeps the
+	///       children of VObs which were skipped by the filter.
 	ZKAPI std::shared_ptr<VirtualObject> parse_vob_tree(ReadArchive& in, GameVersion version);
+
+	/// \brief Parses a VOB tree from the given reader and appends it to the given list.
+	///
+	/// If the root VOb of the tree is skipped by the reader's class filter, its loaded descendants are appended to
+	/// \p out instead. The same applies to VObs further down the tree: their loaded descendants are attached to the
+	/// closest loaded ancestor.
+	///
+	/// \param in The reader to read from.
+	/// \param version The version of Gothic being used.
+	/// \param out The list to append the parsed tree to.
+	/// \see ReadArchive::set_class_filter
+	ZKAPI void parse_vob_tree(ReadArchive& in, GameVersion version, std::vector<std::shared_ptr<VirtualObject>>& out);
+
+	/// \brief Reads the VOb tree of a world one root VOb at a time.
+	///
+	/// <p>In contrast to World::load, this only keeps the root VOb currently being processed in memory. Each call
+	/// to #next parses the next root VOb of the world together with all of its children. Once the caller releases
+	/// it, its memory is freed.</p>
+	///
+	/// <p>References between VObs of different root trees are resolved by reading the referenced object again,
+	/// so the objects returned for them are copies rather than the original VObs.</p>
+	class ZKAPI VobStream {
+	public:
+		/// \brief Open the VOb tree of the world stored in the given stream.
+		///
+		/// The sections of the world before the VOb tree are skipped without being parsed.
+		///
+		/// \param r The stream to read the world from. Must outlive the returned stream.
+		/// \param version The game version the world was made for.
+		/// \return The VOb stream positioned at the first root VOb.
+		/// \throws ParserError if the stream does not contain a world or if its VOb count is invalid.
+		static std::unique_ptr<VobStream> from(Read* r, GameVersion version);
+
+		/// \brief Parse the next root VOb of the world.
+		/// \return The next root VOb including its children or `nullptr` if there are no more VObs.
+		std::shared_ptr<VirtualObject> next();
+
+		/// \return The archive reader the VObs are read from, e.g. to set a class filter.
+		/// \see ReadArchive::set_class_filter
+		[[nodiscard]] ReadArchive& get_archive() noexcept {
+			return *_m_archive;
+		}
+
+		/// \return The number of root VObs which have not been read yet.
+		[[nodiscard]] std::size_t remaining() const noexcept {
+			return _m_remaining + _m_pending.size();
+		}
+
+	private:
+		VobStream(std::unique_ptr<ReadArchive> archive, GameVersion version);
+
+		std::unique_ptr<ReadArchive> _m_archive;
+		GameVersion _m_version;
+		std::size_t _m_remaining {0};
+		std::vector<std::shared_ptr<VirtualObject>> _m_pending;
+	};
+
 	ZKAPI void save_vob_tree(WriteArchive& w, GameVersion version, std::shared_ptr<VirtualObject> const& obj);
 } // namespace zenkit
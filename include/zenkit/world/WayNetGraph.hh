@@ -0,0 +1,180 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Library.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace zenkit {
+	class Read;
+	class Write;
+	class WayNet;
+	class WayNetGraph;
+
+	/// \brief Buffers used by the queries of a WayNetGraph.
+	///
+	/// <p>Reusing the same scratch object for many queries avoids allocating memory for each one of them. A scratch
+	/// object may only be used by one query at a time, so each thread should have its own.</p>
+	class WayNetScratch {
+	private:
+		friend class WayNetGraph;
+
+		struct Entry {
+			float priority;
+			std::uint32_t waypoint;
+		};
+
+		std::vector<float> _m_cost;
+		std::vector<std::uint32_t> _m_parent;
+		std::vector<std::uint32_t> _m_stamp;
+		std::vector<Entry> _m_open;
+		std::uint32_t _m_generation {0};
+	};
+
+	/// \brief Precomputed path lengths from every waypoint of a WayNetGraph to a set of target waypoints.
+	///
+	/// <p>Looking up a distance in the table is much faster than searching for a path, which helps when the
+	/// distances from many NPCs to the same few targets, like the `FP_` and `WP_` points used by their daily
+	/// routines, are needed over and over again. Building the table for a large way-net takes a moment, so it
+	/// should be stored next to the world using #save and loaded again using #load.</p>
+	///
+	/// \see WayNetGraph::build_distance_table
+	class WayNetDistanceTable {
+	public:
+		/// \brief Loads a table stored using #save.
+		/// \param r The stream to read from.
+		/// \param graph The graph the table was built from.
+		/// \return `false` if the stream does not contain a valid table or the table was built from a different
+		///         graph. The table is left unchanged in that case.
+		ZKAPI bool load(Read* r, WayNetGraph const& graph);
+
+		/// \brief Stores the table in a compact binary format.
+		/// \param w The stream to write to.
+		ZKAPI void save(Write* w) const;
+
+		/// \brief Looks up the length of the shortest path between a waypoint and a target.
+		/// \param waypoint The index of the waypoint.
+		/// \param target The index of the target waypoint.
+		/// \return The length of the path or `std::nullopt` if \p target is not a target of the table, \p waypoint
+		///         is out of range or there is no path between the two.
+		[[nodiscard]] ZKAPI std::optional<float> distance(std::uint32_t waypoint, std::uint32_t target) const;
+
+		/// \brief The fingerprint of the graph the table was built from, see WayNetGraph::fingerprint.
+		std::uint64_t fingerprint {0};
+
+		/// \brief The number of waypoints in the graph the table was built from.
+		std::uint32_t waypoint_count {0};
+
+		/// \brief The indices of the target waypoints.
+		std::vector<std::uint32_t> targets;
+
+		/// \brief For each target in order, the length of the shortest path from each waypoint to it. Waypoints
+		///        without a path to the target are infinitely far away.
+		std::vector<float> distances;
+	};
+
+	/// \brief The adjacency of a WayNet prepared for path finding.
+	///
+	/// <p>Waypoints are identified by their index in WayNet::waypoints (or WayNet::points with `ZK_FUTURE`). The
+	/// edges of the way-net are stored in compressed sparse row form: the neighbors of waypoint `i` are
+	/// `targets[offsets[i]]` up to `targets[offsets[i + 1]]`, with the length of each edge in #costs. Edges can be
+	/// travelled in both directions.</p>
+	///
+	/// <p>The graph copies everything it needs, so it remains valid when the way-net is destroyed. Queries may run
+	/// concurrently as long as each uses its own WayNetScratch.</p>
+	class WayNetGraph {
+	public:
+		/// \brief Replaces the contents of the graph with the waypoints and edges of the given way-net.
+		/// \param way_net The way-net to build the graph from.
+		ZKAPI void build(WayNet const& way_net);
+
+		/// \return The number of waypoints in the graph.
+		[[nodiscard]] std::size_t size() const noexcept {
+			return positions.size();
+		}
+
+		/// \brief Finds the shortest path between two waypoints using A*.
+		/// \param from The index of the waypoint to start at.
+		/// \param to The index of the waypoint to end at.
+		/// \param path Receives the indices of the waypoints along the path, including \p from and \p to. It is
+		///             cleared first.
+		/// \param scratch The buffers to use for the search.
+		/// \return The length of the path or `std::nullopt` if there is no path between the waypoints or either
+		///         index is out of range.
+		ZKAPI std::optional<float> find_path(std::uint32_t from,
+		                                     std::uint32_t to,
+		                                     std::vector<std::uint32_t>& path,
+		                                     WayNetScratch& scratch) const;
+
+		/// \brief Finds the shortest path between two waypoints using A* and temporary buffers.
+		/// \see #find_path(std::uint32_t, std::uint32_t, std::vector<std::uint32_t>&, WayNetScratch&) const
+		ZKAPI std::optional<float>
+		find_path(std::uint32_t from, std::uint32_t to, std::vector<std::uint32_t>& path) const;
+
+		/// \brief Computes the length of the shortest path from every waypoint to the closest of the given sources
+		///        using Dijkstra's algorithm.
+		/// \param sources The indices of the waypoints to start at. Indices out of range are ignored.
+		/// \param distances Receives the distance of each waypoint. Waypoints without a path to any of the sources
+		///                  are infinitely far away.
+		/// \param scratch The buffers to use for the search.
+		ZKAPI void distances(std::vector<std::uint32_t> const& sources,
+		                     std::vector<float>& distances,
+		                     WayNetScratch& scratch) const;
+
+		/// \brief Computes the lengths of the shortest paths from every waypoint to each of the given targets.
+		///
+		/// <p>The targets are processed on multiple threads.</p>
+		///
+		/// \param targets The indices of the target waypoints. Indices out of range and duplicates are ignored.
+		/// \return The distance table.
+		[[nodiscard]] ZKAPI WayNetDistanceTable build_distance_table(std::vector<std::uint32_t> const& targets) const;
+
+		/// \brief Computes the lengths of the shortest paths between all pairs of waypoints.
+		///
+		/// <p>The table grows quadratically with the number of waypoints, which amounts to about 25 MiB for the
+		/// way-net of the Gothic II main world.</p>
+		///
+		/// \return The distance table.
+		[[nodiscard]] ZKAPI WayNetDistanceTable build_distance_table() const;
+
+		/// \return A hash of the waypoints and edges used to detect stale distance tables.
+		[[nodiscard]] ZKAPI std::uint64_t fingerprint() const noexcept;
+
+		/// \brief Finds the waypoint closest to the given position.
+		/// \param position The position to search around.
+		/// \return The index of the closest waypoint or `std::nullopt` if the graph is empty.
+		[[nodiscard]] ZKAPI std::optional<std::uint32_t> nearest_waypoint(Vec3 const& position) const;
+
+		/// \brief The position of each waypoint.
+		std::vector<Vec3> positions;
+
+		/// \brief For each waypoint, the index of its first neighbor in #targets. Contains one more element than
+		///        #positions, so that the neighbors of the last waypoint end at the last element.
+		std::vector<std::uint32_t> offsets;
+
+		/// \brief The indices of the neighbors of all waypoints.
+		std::vector<std::uint32_t> targets;
+
+		/// \brief The length of the edge leading to each element of #targets.
+		std::vector<float> costs;
+
+	private:
+		ZKINT void dijkstra(std::uint32_t const* sources,
+		                    std::size_t source_count,
+		                    float* distances,
+		                    WayNetScratch& scratch) const;
+
+		ZKINT void nearest(std::size_t begin,
+		                   std::size_t end,
+		                   unsigned axis,
+		                   Vec3 const& position,
+		                   std::uint32_t& best,
+		                   float& best_distance) const;
+
+		/// \brief The waypoints ordered as an implicit, balanced k-d tree.
+		std::vector<std::uint32_t> _m_tree;
+	};
+} // namespace zenkit
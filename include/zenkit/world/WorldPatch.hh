@@ -0,0 +1,121 @@
+// Copyright © 2021-2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Archive.hh"
+#include "zenkit/Misc.hh"
+#include "zenkit/vobs/VirtualObject.hh"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace zenkit {
+	class Read;
+	class Write;
+	class World;
+	struct SkyController;
+
+	/// \brief A VOb added to or modified in a world by a WorldPatch.
+	struct WorldPatchEntry {
+		/// \brief The key of the VOb.
+		/// \see WorldPatch::key
+		std::string key;
+
+		/// \brief The key of the VOb's parent or an empty string if it is a root VOb.
+		std::string parent;
+
+		/// \brief The new state of the VOb, without its children.
+		std::shared_ptr<VirtualObject> vob;
+	};
+
+	/// \brief An NPC spawn location stored in a WorldPatch.
+	struct WorldPatchSpawn {
+		/// \brief The key of the NPC to spawn if it is one of the NPCs of the world. Otherwise empty.
+		std::string npc;
+
+		/// \brief The NPC to spawn if it is not one of the NPCs of the world. Otherwise `nullptr`.
+		std::shared_ptr<VNpc> vob;
+
+		Vec3 position;
+		float timer;
+	};
+
+	/// \brief The differences between the VOb trees of two worlds.
+	///
+	/// <p>Patches are created using #diff and contain only the VObs which were added, removed, modified or moved to
+	/// a different parent. They can be stored in an archive of any format and applied to a copy of the original
+	/// world using #apply, which is much cheaper than loading the complete modified world.</p>
+	///
+	/// <p>VObs are matched by their name if it is unique within the world. Otherwise, they are matched by their name
+	/// and their position among the VObs of the same name in depth-first order, so VObs which should be patched
+	/// reliably should be named uniquely. The mesh, BSP-tree and way-net of the world are not part of the patch.</p>
+	///
+	/// <p>Patches of save-game worlds compare the save-game state of VObs too. They also contain the changed NPCs of
+	/// the world, matched like VObs, as well as its NPC spawn locations and sky controller. The cutscene player is
+	/// not part of the patch.</p>
+	class ZKAPI WorldPatch {
+	public:
+		/// \brief Compare the VOb trees of two worlds.
+		/// \param base The world the patch will be applied to.
+		/// \param target The world which applying the patch to \p base should produce.
+		/// \param version The game version the worlds were made for.
+		/// \param save_game Set to `true` to create a patch of save-game worlds.
+		/// \return The patch turning \p base into \p target.
+		static WorldPatch diff(World const& base, World const& target, GameVersion version, bool save_game = false);
+
+		/// \brief Apply the patch to the given world.
+		///
+		/// The VObs of the patch are moved into the world, so the patch is empty afterwards. Added VObs are appended
+		/// to the children of their parent, modified VObs keep their position and their children.
+		///
+		/// \param world The world to patch. Should be the base world passed to #diff.
+		void apply(World& world);
+
+		/// \brief Load a patch stored using #save.
+		/// \param r The stream to read from.
+		/// \param version The game version the patch was made for.
+		/// \throws ParserError if the stream does not contain a patch.
+		void load(Read* r, GameVersion version);
+
+		/// \brief Store the patch in an archive.
+		/// \param w The stream to write to.
+		/// \param version The game version the patch is made for.
+		/// \param format The format of the archive to write.
+		void save(Write* w, GameVersion version, ArchiveFormat format = ArchiveFormat::BINARY) const;
+
+		/// \return `true` if applying the patch would not change the VObs or NPCs of the world.
+		[[nodiscard]] bool empty() const noexcept {
+			return removed.empty() && changed.empty() && removed_npcs.empty() && changed_npcs.empty();
+		}
+
+		/// \return The key used to match the given VOb between worlds.
+		/// \param vob The VOb to get the key of.
+		/// \param unique_name Whether the name of the VOb is unique within its world.
+		/// \param occurrence The number of VObs with the same name which precede the VOb in depth-first order.
+		static std::string key(VirtualObject const& vob, bool unique_name, std::uint32_t occurrence);
+
+		/// \brief The keys of the VObs to remove, together with their children.
+		std::vector<std::string> removed;
+
+		/// \brief The VObs to add or replace, parents before children.
+		std::vector<WorldPatchEntry> changed;
+
+		/// \brief Whether this is a patch of save-game worlds. The fields below are only used if it is.
+		bool save_game = false;
+
+		/// \brief The keys of the NPCs to remove.
+		std::vector<std::string> removed_npcs;
+
+		/// \brief The NPCs to add or replace. WorldPatchEntry::parent is always empty.
+		std::vector<WorldPatchEntry> changed_npcs;
+
+		/// \brief The NPC spawn locations which replace those of the world.
+		std::vector<WorldPatchSpawn> npc_spawns;
+		bool npc_spawn_enabled = false;
+		int npc_spawn_flags = 0;
+
+		/// \brief The sky controller which replaces that of the world or `nullptr` to keep it.
+		std::shared_ptr<SkyController> sky_controller;
+	};
+} // namespace zenkit
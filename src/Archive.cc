@@ -23,157 +23,180 @@
 #include "zenkit/SaveGame.hh"
 #include "zenkit/World.hh"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <stdexcept>
 
 namespace zenkit {
-	static std::unordered_map<std::string, ObjectType> const OBJECTS = {
-	    {"zCVob", ObjectType::zCVob},
-	    {"zCVobLevelCompo:zCVob", ObjectType::zCVobLevelCompo},
-	    {"oCItem:zCVob", ObjectType::oCItem},
-	    {"oCNpc:zCVob", ObjectType::oCNpc},
-	    {"oCMOB:zCVob", ObjectType::oCMOB},
-	    {"oCMobInter:oCMOB:zCVob", ObjectType::oCMobInter},
-	    {"oCMobBed:oCMobInter:oCMOB:zCVob", ObjectType::oCMobBed},
-	    {"oCMobFire:oCMobInter:oCMOB:zCVob", ObjectType::oCMobFire},
-	    {"oCMobLadder:oCMobInter:oCMOB:zCVob", ObjectType::oCMobLadder},
-	    {"oCMobSwitch:oCMobInter:oCMOB:zCVob", ObjectType::oCMobSwitch},
-	    {"oCMobWheel:oCMobInter:oCMOB:zCVob", ObjectType::oCMobWheel},
-	    {"oCMobContainer:oCMobInter:oCMOB:zCVob", ObjectType::oCMobContainer},
-	    {"oCMobDoor:oCMobInter:oCMOB:zCVob", ObjectType::oCMobDoor},
-	    {"zCPFXControler:zCVob", ObjectType::zCPFXController},
-	    {"zCVobAnimate:zCVob", ObjectType::zCVobAnimate},
-	    {"zCVobLensFlare:zCVob", ObjectType::zCVobLensFlare},
-	    {"zCVobLight:zCVob", ObjectType::zCVobLight},
-	    {"zCVobSpot:zCVob", ObjectType::zCVobSpot},
-	    {"zCVobStartpoint:zCVob", ObjectType::zCVobStartpoint},
-	    {"zCVobSound:zCVob", ObjectType::zCVobSound},
-	    {"zCVobSoundDaytime:zCVobSound:zCVob", ObjectType::zCVobSoundDaytime},
-	    {"oCZoneMusic:zCVob", ObjectType::oCZoneMusic},
-	    {"oCZoneMusicDefault:oCZoneMusic:zCVob", ObjectType::oCZoneMusicDefault},
-	    {"zCZoneZFog:zCVob", ObjectType::zCZoneZFog},
-	    {"zCZoneZFogDefault:zCZoneZFog:zCVob", ObjectType::zCZoneZFogDefault},
-	    {"zCZoneVobFarPlane:zCVob", ObjectType::zCZoneVobFarPlane},
-	    {"zCZoneVobFarPlaneDefault:zCZoneVobFarPlane:zCVob", ObjectType::zCZoneVobFarPlaneDefault},
-	    {"zCMessageFilter:zCVob", ObjectType::zCMessageFilter},
-	    {"zCCodeMaster:zCVob", ObjectType::zCCodeMaster},
-	    {"zCTrigger:zCVob", ObjectType::zCTrigger},
-	    {"zCTriggerList:zCTrigger:zCVob", ObjectType::zCTriggerList},
-	    {"oCTriggerScript:zCTrigger:zCVob", ObjectType::oCTriggerScript},
-	    {"zCMover:zCTrigger:zCVob", ObjectType::zCMover},
-	    {"oCTriggerChangeLevel:zCTrigger:zCVob", ObjectType::oCTriggerChangeLevel},
-	    {"zCTriggerWorldStart:zCVob", ObjectType::zCTriggerWorldStart},
-	    {"zCTriggerUntouch:zCVob", ObjectType::zCTriggerUntouch},
-	    {"zCCSCamera:zCVob", ObjectType::zCCSCamera},
-	    {"zCCamTrj_KeyFrame:zCVob", ObjectType::zCCamTrj_KeyFrame},
-	    {"oCTouchDamage:zCTouchDamage:zCVob", ObjectType::oCTouchDamage},
-	    {"zCEarthquake:zCVob", ObjectType::zCEarthquake},
-	    {"zCMoverControler:zCVob", ObjectType::zCMoverController},
-	    {"zCVobScreenFX:zCVob", ObjectType::zCVobScreenFX},
-	    {"zCVobStair:zCVob", ObjectType::zCVobStair},
-	    {"oCCSTrigger:zCTrigger:zCVob", ObjectType::oCCSTrigger},
-	    {"oCNpcTalent", ObjectType::oCNpcTalent},
-	    {"zCEventManager", ObjectType::zCEventManager},
-	    {"zCDecal", ObjectType::zCDecal},
-	    {"zCMesh", ObjectType::zCMesh},
-	    {"zCProgMeshProto", ObjectType::zCProgMeshProto},
-	    {"zCParticleFX", ObjectType::zCParticleFX},
-	    {"zCAICamera", ObjectType::zCAICamera},
-	    {"zCModel", ObjectType::zCModel},
-	    {"zCMorphMesh", ObjectType::zCMorphMesh},
-	    {"oCAIHuman:oCAniCtrl_Human:zCAIPlayer", ObjectType::oCAIHuman},
-	    {"oCAIVobMove", ObjectType::oCAIVobMove},
-	    {"oCCSPlayer:zCCSPlayer", ObjectType::oCCSPlayer},
-	    {"zCSkyControler_Outdoor", ObjectType::zCSkyControler_Outdoor},
-	    {"zCWayNet", ObjectType::zCWayNet},
-	    {"zCWaypoint", ObjectType::zCWaypoint},
-	    {"oCWorld:zCWorld", ObjectType::oCWorld},
-	    {"zCMaterial", ObjectType::zCMaterial},
-	    {"oCSavegameInfo", ObjectType::oCSavegameInfo},
-	    {"oCCSManager:zCCSManager", ObjectType::oCCSManager},
-	    {"zCCSPoolItem", ObjectType::zCCSPoolItem},
-	    {"zCCSBlock", ObjectType::zCCSBlock},
-	    {"zCCutscene:zCCSBlock", ObjectType::zCCutscene},
-	    {"zCCSCutsceneContext:zCCutscene:zCCSBlock", ObjectType::zCCSCutsceneContext},
-	    {"oCMsgConversation:oCNpcMessage:zCEventMessage", ObjectType::oCMsgConversation},
-	    {"zCCSAtomicBlock", ObjectType::zCCSAtomicBlock},
-	    {"zCCSLib", ObjectType::zCCSLib},
-	    {"zCCSProps", ObjectType::zCCSProps},
+	/// \brief A class which can be stored in an archive.
+	struct ObjectClass {
+		ObjectType type;
+
+		/// \brief The full class name as stored in archives or an empty string if the type can't be stored.
+		std::string_view name;
+
+		/// \brief Creates a new object of this class, optionally in an arena. `nullptr` if loading is not supported.
+		std::shared_ptr<Object> (*make)(ObjectArena* arena);
+	};
+
+	template <typename T>
+	static std::shared_ptr<Object> make_object(ObjectArena* arena) {
+		if (arena != nullptr) return arena->make<T>();
+		return std::make_shared<T>();
+	}
+
+	/// \brief All known classes, indexed by their ObjectType.
+	static constexpr ObjectClass OBJECT_CLASSES[] = {
+	    {ObjectType::zCVob, "zCVob", make_object<VirtualObject>},
+	    {ObjectType::zCVobLevelCompo, "zCVobLevelCompo:zCVob", make_object<VLevel>},
+	    {ObjectType::oCItem, "oCItem:zCVob", make_object<VItem>},
+	    {ObjectType::oCNpc, "oCNpc:zCVob", make_object<VNpc>},
+	    {ObjectType::zCMoverController, "zCMoverControler:zCVob", make_object<VMoverController>},
+	    {ObjectType::zCVobScreenFX, "zCVobScreenFX:zCVob", make_object<VScreenEffect>},
+	    {ObjectType::zCVobStair, "zCVobStair:zCVob", make_object<VStair>},
+	    {ObjectType::zCPFXController, "zCPFXControler:zCVob", make_object<VParticleEffectController>},
+	    {ObjectType::zCVobAnimate, "zCVobAnimate:zCVob", make_object<VAnimate>},
+	    {ObjectType::zCVobLensFlare, "zCVobLensFlare:zCVob", make_object<VLensFlare>},
+	    {ObjectType::zCVobLight, "zCVobLight:zCVob", make_object<VLight>},
+	    {ObjectType::zCVobSpot, "zCVobSpot:zCVob", make_object<VSpot>},
+	    {ObjectType::zCVobStartpoint, "zCVobStartpoint:zCVob", make_object<VStartPoint>},
+	    {ObjectType::zCMessageFilter, "zCMessageFilter:zCVob", make_object<VMessageFilter>},
+	    {ObjectType::zCCodeMaster, "zCCodeMaster:zCVob", make_object<VCodeMaster>},
+	    {ObjectType::zCTriggerWorldStart, "zCTriggerWorldStart:zCVob", make_object<VTriggerWorldStart>},
+	    {ObjectType::zCCSCamera, "zCCSCamera:zCVob", make_object<VCutsceneCamera>},
+	    {ObjectType::zCCamTrj_KeyFrame, "zCCamTrj_KeyFrame:zCVob", make_object<VCameraTrajectoryFrame>},
+	    {ObjectType::oCTouchDamage, "oCTouchDamage:zCTouchDamage:zCVob", make_object<VTouchDamage>},
+	    {ObjectType::zCTriggerUntouch, "zCTriggerUntouch:zCVob", make_object<VTriggerUntouch>},
+	    {ObjectType::zCEarthquake, "zCEarthquake:zCVob", make_object<VEarthquake>},
+	    {ObjectType::oCMOB, "oCMOB:zCVob", make_object<VMovableObject>},
+	    {ObjectType::oCMobInter, "oCMobInter:oCMOB:zCVob", make_object<VInteractiveObject>},
+	    {ObjectType::oCMobBed, "oCMobBed:oCMobInter:oCMOB:zCVob", make_object<VBed>},
+	    {ObjectType::oCMobFire, "oCMobFire:oCMobInter:oCMOB:zCVob", make_object<VFire>},
+	    {ObjectType::oCMobLadder, "oCMobLadder:oCMobInter:oCMOB:zCVob", make_object<VLadder>},
+	    {ObjectType::oCMobSwitch, "oCMobSwitch:oCMobInter:oCMOB:zCVob", make_object<VSwitch>},
+	    {ObjectType::oCMobWheel, "oCMobWheel:oCMobInter:oCMOB:zCVob", make_object<VWheel>},
+	    {ObjectType::oCMobContainer, "oCMobContainer:oCMobInter:oCMOB:zCVob", make_object<VContainer>},
+	    {ObjectType::oCMobDoor, "oCMobDoor:oCMobInter:oCMOB:zCVob", make_object<VDoor>},
+	    {ObjectType::zCTrigger, "zCTrigger:zCVob", make_object<VTrigger>},
+	    {ObjectType::zCTriggerList, "zCTriggerList:zCTrigger:zCVob", make_object<VTriggerList>},
+	    {ObjectType::oCTriggerScript, "oCTriggerScript:zCTrigger:zCVob", make_object<VTriggerScript>},
+	    {ObjectType::oCTriggerChangeLevel, "oCTriggerChangeLevel:zCTrigger:zCVob", make_object<VTriggerChangeLevel>},
+	    {ObjectType::oCCSTrigger, "oCCSTrigger:zCTrigger:zCVob", make_object<VCutsceneTrigger>},
+	    {ObjectType::zCMover, "zCMover:zCTrigger:zCVob", make_object<VMover>},
+	    {ObjectType::zCVobSound, "zCVobSound:zCVob", make_object<VSound>},
+	    {ObjectType::zCVobSoundDaytime, "zCVobSoundDaytime:zCVobSound:zCVob", make_object<VSoundDaytime>},
+	    {ObjectType::oCZoneMusic, "oCZoneMusic:zCVob", make_object<VZoneMusic>},
+	    {ObjectType::oCZoneMusicDefault, "oCZoneMusicDefault:oCZoneMusic:zCVob", make_object<VZoneMusicDefault>},
+	    {ObjectType::zCZoneZFog, "zCZoneZFog:zCVob", make_object<VZoneFog>},
+	    {ObjectType::zCZoneZFogDefault, "zCZoneZFogDefault:zCZoneZFog:zCVob", make_object<VZoneFogDefault>},
+	    {ObjectType::zCZoneVobFarPlane, "zCZoneVobFarPlane:zCVob", make_object<VZoneFarPlane>},
+	    {ObjectType::zCZoneVobFarPlaneDefault,
+	     "zCZoneVobFarPlaneDefault:zCZoneVobFarPlane:zCVob",
+	     make_object<VZoneFarPlaneDefault>},
+	    {ObjectType::ignored, "", nullptr},
+	    {ObjectType::unknown, "", nullptr},
+	    {ObjectType::oCNpcTalent, "oCNpcTalent", make_object<VNpc::Talent>},
+	    {ObjectType::zCEventManager, "zCEventManager", make_object<EventManager>},
+	    {ObjectType::zCDecal, "zCDecal", make_object<VisualDecal>},
+	    {ObjectType::zCMesh, "zCMesh", make_object<VisualMesh>},
+	    {ObjectType::zCProgMeshProto, "zCProgMeshProto", make_object<VisualMultiResolutionMesh>},
+	    {ObjectType::zCParticleFX, "zCParticleFX", make_object<VisualParticleEffect>},
+	    {ObjectType::zCAICamera, "zCAICamera", make_object<VisualCamera>},
+	    {ObjectType::zCModel, "zCModel", make_object<VisualModel>},
+	    {ObjectType::zCMorphMesh, "zCMorphMesh", make_object<VisualMorphMesh>},
+	    {ObjectType::oCAIHuman, "oCAIHuman:oCAniCtrl_Human:zCAIPlayer", make_object<AiHuman>},
+	    {ObjectType::oCAIVobMove, "oCAIVobMove", make_object<AiMove>},
+	    {ObjectType::oCCSPlayer, "oCCSPlayer:zCCSPlayer", make_object<CutscenePlayer>},
+	    {ObjectType::zCSkyControler_Outdoor, "zCSkyControler_Outdoor", make_object<SkyController>},
+	    {ObjectType::oCWorld, "oCWorld:zCWorld", make_object<World>},
+#ifdef ZK_FUTURE
+	    {ObjectType::zCWayNet, "zCWayNet", make_object<WayNet>},
+	    {ObjectType::zCWaypoint, "zCWaypoint", make_object<WayPoint>},
+#else
+	    {ObjectType::zCWayNet, "zCWayNet", nullptr},
+	    {ObjectType::zCWaypoint, "zCWaypoint", nullptr},
+#endif
+	    {ObjectType::zCMaterial, "zCMaterial", make_object<Material>},
+	    {ObjectType::oCSavegameInfo, "oCSavegameInfo", make_object<SaveMetadata>},
+	    {ObjectType::oCCSManager, "oCCSManager:zCCSManager", make_object<CutsceneManager>},
+	    {ObjectType::zCCSPoolItem, "zCCSPoolItem", make_object<CutscenePoolItem>},
+	    {ObjectType::zCCSBlock, "zCCSBlock", make_object<CutsceneBlock>},
+	    {ObjectType::zCCutscene, "zCCutscene:zCCSBlock", make_object<Cutscene>},
+	    {ObjectType::zCCSCutsceneContext, "zCCSCutsceneContext:zCCutscene:zCCSBlock", make_object<CutsceneContext>},
+	    {ObjectType::oCMsgConversation,
+	     "oCMsgConversation:oCNpcMessage:zCEventMessage",
+	     make_object<ConversationMessageEvent>},
+	    {ObjectType::zCCSAtomicBlock, "zCCSAtomicBlock", make_object<CutsceneAtomicBlock>},
+	    {ObjectType::zCCSLib, "zCCSLib", make_object<CutsceneLibrary>},
+	    {ObjectType::zCCSProps, "zCCSProps", make_object<CutsceneProps>},
 	};
 
-	static std::unordered_map<ObjectType, std::string> const CLASS_NAMES = {
-	    {ObjectType::zCVob, "zCVob"},
-	    {ObjectType::zCVobLevelCompo, "zCVobLevelCompo:zCVob"},
-	    {ObjectType::oCItem, "oCItem:zCVob"},
-	    {ObjectType::oCNpc, "oCNpc:zCVob"},
-	    {ObjectType::oCMOB, "oCMOB:zCVob"},
-	    {ObjectType::oCMobInter, "oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobBed, "oCMobBed:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobFire, "oCMobFire:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobLadder, "oCMobLadder:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobSwitch, "oCMobSwitch:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobWheel, "oCMobWheel:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobContainer, "oCMobContainer:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::oCMobDoor, "oCMobDoor:oCMobInter:oCMOB:zCVob"},
-	    {ObjectType::zCPFXController, "zCPFXControler:zCVob"},
-	    {ObjectType::zCVobAnimate, "zCVobAnimate:zCVob"},
-	    {ObjectType::zCVobLensFlare, "zCVobLensFlare:zCVob"},
-	    {ObjectType::zCVobLight, "zCVobLight:zCVob"},
-	    {ObjectType::zCVobSpot, "zCVobSpot:zCVob"},
-	    {ObjectType::zCVobStartpoint, "zCVobStartpoint:zCVob"},
-	    {ObjectType::zCVobSound, "zCVobSound:zCVob"},
-	    {ObjectType::zCVobSoundDaytime, "zCVobSoundDaytime:zCVobSound:zCVob"},
-	    {ObjectType::oCZoneMusic, "oCZoneMusic:zCVob"},
-	    {ObjectType::oCZoneMusicDefault, "oCZoneMusicDefault:oCZoneMusic:zCVob"},
-	    {ObjectType::zCZoneZFog, "zCZoneZFog:zCVob"},
-	    {ObjectType::zCZoneZFogDefault, "zCZoneZFogDefault:zCZoneZFog:zCVob"},
-	    {ObjectType::zCZoneVobFarPlane, "zCZoneVobFarPlane:zCVob"},
-	    {ObjectType::zCZoneVobFarPlaneDefault, "zCZoneVobFarPlaneDefault:zCZoneVobFarPlane:zCVob"},
-	    {ObjectType::zCMessageFilter, "zCMessageFilter:zCVob"},
-	    {ObjectType::zCCodeMaster, "zCCodeMaster:zCVob"},
-	    {ObjectType::zCTrigger, "zCTrigger:zCVob"},
-	    {ObjectType::zCTriggerList, "zCTriggerList:zCTrigger:zCVob"},
-	    {ObjectType::oCTriggerScript, "oCTriggerScript:zCTrigger:zCVob"},
-	    {ObjectType::zCMover, "zCMover:zCTrigger:zCVob"},
-	    {ObjectType::oCTriggerChangeLevel, "oCTriggerChangeLevel:zCTrigger:zCVob"},
-	    {ObjectType::zCTriggerWorldStart, "zCTriggerWorldStart:zCVob"},
-	    {ObjectType::zCTriggerUntouch, "zCTriggerUntouch:zCVob"},
-	    {ObjectType::zCCSCamera, "zCCSCamera:zCVob"},
-	    {ObjectType::zCCamTrj_KeyFrame, "zCCamTrj_KeyFrame:zCVob"},
-	    {ObjectType::oCTouchDamage, "oCTouchDamage:zCTouchDamage:zCVob"},
-	    {ObjectType::zCEarthquake, "zCEarthquake:zCVob"},
-	    {ObjectType::zCMoverController, "zCMoverControler:zCVob"},
-	    {ObjectType::zCVobScreenFX, "zCVobScreenFX:zCVob"},
-	    {ObjectType::zCVobStair, "zCVobStair:zCVob"},
-	    {ObjectType::oCCSTrigger, "oCCSTrigger:zCTrigger:zCVob"},
-	    {ObjectType::oCNpcTalent, "oCNpcTalent"},
-	    {ObjectType::zCEventManager, "zCEventManager"},
-	    {ObjectType::zCDecal, "zCDecal"},
-	    {ObjectType::zCMesh, "zCMesh"},
-	    {ObjectType::zCProgMeshProto, "zCProgMeshProto"},
-	    {ObjectType::zCParticleFX, "zCParticleFX"},
-	    {ObjectType::zCAICamera, "zCAICamera"},
-	    {ObjectType::zCModel, "zCModel"},
-	    {ObjectType::zCMorphMesh, "zCMorphMesh"},
-	    {ObjectType::oCAIHuman, "oCAIHuman:oCAniCtrl_Human:zCAIPlayer"},
-	    {ObjectType::oCAIVobMove, "oCAIVobMove"},
-	    {ObjectType::oCCSPlayer, "oCCSPlayer:zCCSPlayer"},
-	    {ObjectType::zCSkyControler_Outdoor, "zCSkyControler_Outdoor"},
-	    {ObjectType::zCWayNet, "zCWayNet"},
-	    {ObjectType::zCWaypoint, "zCWaypoint"},
-	    {ObjectType::oCWorld, "oCWorld:zCWorld"},
-	    {ObjectType::zCMaterial, "zCMaterial"},
-	    {ObjectType::oCSavegameInfo, "oCSavegameInfo"},
-	    {ObjectType::oCCSManager, "oCCSManager:zCCSManager"},
-	    {ObjectType::zCCSPoolItem, "zCCSPoolItem"},
-	    {ObjectType::zCCSBlock, "zCCSBlock"},
-	    {ObjectType::zCCutscene, "zCCutscene:zCCSBlock"},
-	    {ObjectType::zCCSCutsceneContext, "zCCSCutsceneContext:zCCutscene:zCCSBlock"},
-	    {ObjectType::oCMsgConversation, "oCMsgConversation:oCNpcMessage:zCEventMessage"},
-	    {ObjectType::zCCSAtomicBlock, "zCCSAtomicBlock"},
-	    {ObjectType::zCCSLib, "zCCSLib"},
-	    {ObjectType::zCCSProps, "zCCSProps"},
+	static constexpr bool object_classes_are_indexed_by_type() {
+		for (size_t i = 0; i < std::size(OBJECT_CLASSES); ++i) {
+			if (static_cast<size_t>(OBJECT_CLASSES[i].type) != i) return false;
+		}
+
+		return true;
+	}
+
+	static_assert(object_classes_are_indexed_by_type());
+	static_assert(std::size(OBJECT_CLASSES) == static_cast<size_t>(ObjectType::zCCSProps) + 1);
+
+	/// \brief FNV-1a with a seeded offset basis and a final avalanche step.
+	static constexpr uint32_t object_class_hash(std::string_view name, uint32_t seed) noexcept {
+		uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+		for (auto c : name) {
+			h ^= static_cast<uint8_t>(c);
+			h *= 16777619u;
+		}
+
+		h ^= h >> 16;
+		h *= 0x85EBCA6Bu;
+		h ^= h >> 13;
+		return h;
+	}
+
+	static constexpr size_t OBJECT_CLASS_SLOTS = 1024;
+	static constexpr uint8_t OBJECT_CLASS_EMPTY = 0xFF;
+
+	/// \brief A perfect hash table mapping class names to indices into OBJECT_CLASSES.
+	struct ObjectClassTable {
+		uint32_t seed;
+		std::array<uint8_t, OBJECT_CLASS_SLOTS> slots;
 	};
 
+	/// \brief Finds a seed for which no two class names share a slot.
+	static constexpr ObjectClassTable make_object_class_table() {
+		for (uint32_t seed = 0; seed < 4096; ++seed) {
+			ObjectClassTable table {seed, {}};
+			for (auto& slot : table.slots) {
+				slot = OBJECT_CLASS_EMPTY;
+			}
+
+			bool perfect = true;
+			for (uint8_t i = 0; i < std::size(OBJECT_CLASSES) && perfect; ++i) {
+				if (OBJECT_CLASSES[i].name.empty()) continue;
+
+				auto& slot = table.slots[object_class_hash(OBJECT_CLASSES[i].name, seed) % OBJECT_CLASS_SLOTS];
+				perfect = slot == OBJECT_CLASS_EMPTY;
+				slot = i;
+			}
+
+			if (perfect) return table;
+		}
+
+		throw std::logic_error {"no perfect hash seed found for the object class names"};
+	}
+
+	static constexpr ObjectClassTable OBJECT_CLASS_TABLE = make_object_class_table();
+
+	static ObjectClass const* find_object_class(std::string_view name) noexcept {
+		auto index = OBJECT_CLASS_TABLE.slots[object_class_hash(name, OBJECT_CLASS_TABLE.seed) % OBJECT_CLASS_SLOTS];
+		if (index == OBJECT_CLASS_EMPTY || OBJECT_CLASSES[index].name != name) return nullptr;
+		return &OBJECT_CLASSES[index];
+	}
+
 	ReadArchive::ReadArchive(ArchiveHeader head, Read* read) : header(std::move(head)), read(read) {}
 
 	ReadArchive::ReadArchive(ArchiveHeader head, Read* read, std::unique_ptr<Read> owned)
@@ -252,7 +275,138 @@ namespace zenkit {
 		return reader;
 	}
 
+	static constexpr std::uint32_t ARCHIVE_INDEX_MAGIC = 0x49414B5A; // "ZKAI"
+	static constexpr std::uint32_t ARCHIVE_INDEX_VERSION = 1;
+
+	// The smallest possible entry: Its offset and index followed by an empty object and class name.
+	static constexpr std::size_t ARCHIVE_INDEX_ENTRY_SIZE_MIN = 4 + 4 + 4 + 1 + 1;
+
+	void ArchiveIndex::add(ArchiveObjectLocation loc) {
+		if (_m_by_index.find(loc.index) != _m_by_index.end()) return;
+
+		_m_by_index.emplace(loc.index, _m_objects.size());
+		_m_objects.push_back(std::move(loc));
+	}
+
+	ArchiveObjectLocation const* ArchiveIndex::find(std::uint32_t index) const noexcept {
+		auto it = _m_by_index.find(index);
+		return it == _m_by_index.end() ? nullptr : &_m_objects[it->second];
+	}
+
+	ArchiveObjectLocation const* ArchiveIndex::find(std::string_view object_name) const noexcept {
+		for (auto& loc : _m_objects) {
+			if (loc.object_name == object_name) return &loc;
+		}
+
+		return nullptr;
+	}
+
+	void ArchiveIndex::load(Read* r) {
+		if (r->read_uint() != ARCHIVE_INDEX_MAGIC) {
+			throw ParserError {"ArchiveIndex", "magic missing"};
+		}
+
+		if (auto version = r->read_uint(); version != ARCHIVE_INDEX_VERSION) {
+			throw ParserError {"ArchiveIndex", "unsupported version: " + std::to_string(version)};
+		}
+
+		// The count comes straight from the file, so it is checked against the bytes which are left before anything
+		// is allocated for it.
+		auto count = r->read_uint();
+		auto position = r->tell();
+		r->seek(0, Whence::END);
+		auto end = r->tell();
+		r->seek(static_cast<ssize_t>(position), Whence::BEG);
+
+		if (count > (end - position) / ARCHIVE_INDEX_ENTRY_SIZE_MIN) {
+			throw ParserError {"ArchiveIndex", "corrupt index: " + std::to_string(count) + " entries"};
+		}
+
+		_m_objects.clear();
+		_m_by_index.clear();
+		_m_objects.reserve(count);
+
+		for (auto i = 0u; i < count; ++i) {
+			ArchiveObjectLocation loc {};
+			loc.offset = static_cast<std::uint64_t>(r->read_uint()) | static_cast<std::uint64_t>(r->read_uint()) << 32;
+			loc.index = r->read_uint();
+			loc.object_name = r->read_line(false);
+			loc.class_name = r->read_line(false);
+			this->add(std::move(loc));
+		}
+	}
+
+	void ArchiveIndex::save(Write* w) const {
+		w->write_uint(ARCHIVE_INDEX_MAGIC);
+		w->write_uint(ARCHIVE_INDEX_VERSION);
+		w->write_uint(static_cast<std::uint32_t>(_m_objects.size()));
+
+		for (auto& loc : _m_objects) {
+			w->write_uint(static_cast<std::uint32_t>(loc.offset));
+			w->write_uint(static_cast<std::uint32_t>(loc.offset >> 32));
+			w->write_uint(loc.index);
+			w->write_string0(loc.object_name);
+			w->write_string0(loc.class_name);
+		}
+	}
+
+	bool ReadArchive::seek_object(std::uint32_t index) {
+		if (_m_index == nullptr) return false;
+
+		auto const* loc = _m_index->find(index);
+		if (loc == nullptr) return false;
+
+		read->seek(static_cast<ssize_t>(loc->offset), Whence::BEG);
+		return true;
+	}
+
+	void ReadArchive::set_class_filter(std::vector<ObjectType> const& types) {
+		_m_filter.reset();
+		_m_filter_enabled = !types.empty();
+		_m_filter_vobs = std::all_of(types.begin(), types.end(), is_vobject);
+
+		for (auto type : types) {
+			_m_filter.set(static_cast<size_t>(type));
+		}
+	}
+
+	bool ReadArchive::is_class_loaded(ObjectType type) const noexcept {
+		if (!_m_filter_enabled || (_m_filter_vobs && !is_vobject(type))) return true;
+		return _m_filter.test(static_cast<size_t>(type));
+	}
+
+	std::shared_ptr<Object> const* ReadArchive::find_cached(uint32_t index) const noexcept {
+		if (index < _m_cache.size()) {
+			auto const& obj = _m_cache[index];
+			return obj == nullptr ? nullptr : &obj;
+		}
+
+		auto it = _m_cache_sparse.find(index);
+		return it == _m_cache_sparse.end() ? nullptr : &it->second;
+	}
+
+	void ReadArchive::cache(uint32_t index, std::shared_ptr<Object> const& obj) {
+		if (index >= _m_cache.size()) {
+			if (index > _m_cache.size() * 2 + 1024) {
+				_m_cache_sparse.insert_or_assign(index, obj);
+				return;
+			}
+
+			_m_cache.resize(std::max<size_t>(index + 1, _m_cache.size() * 2));
+		}
+
+		_m_cache[index] = obj;
+	}
+
+	std::uint32_t ReadArchive::read_string_interned() {
+		if (_m_strings == nullptr) _m_strings = std::make_shared<StringPool>();
+		return _m_strings->intern(this->read_string());
+	}
+
 	std::shared_ptr<Object> ReadArchive::read_object(GameVersion version) {
+		_m_last_filtered = false;
+
+		auto offset = read->tell();
 		ArchiveObject obj;
 		if (!this->read_object_begin(obj)) {
 			ZKLOGE("ReadArchive", "Expected object, got entry.");
@@ -265,13 +419,26 @@ namespace zenkit {
 				this->skip_object(true);
 			}
 
-			auto cached = _m_cache.find(obj.index);
-			if (cached == _m_cache.end()) {
+			auto const* cached = this->find_cached(obj.index);
+			if (cached == nullptr && _m_index != nullptr) {
+				// The referenced object might not have been read yet, e.g. after seeking using `seek_object`.
+				if (auto const* loc = _m_index->find(obj.index); loc != nullptr) {
+					auto mark = read->tell();
+					read->seek(static_cast<ssize_t>(loc->offset), Whence::BEG);
+					auto ref = this->read_object(version);
+					read->seek(static_cast<ssize_t>(mark), Whence::BEG);
+					return ref;
+				}
+			}
+
+			if (cached == nullptr) {
+				// With a class filter, the referenced object has most likely been skipped on purpose.
+				if (_m_filter_enabled) return nullptr;
 				ZKLOGW("ReadArchive", "Unresolved reference: %d", obj.index);
 				return nullptr;
 			}
 
-			return cached->second;
+			return *cached;
 		}
 
 		if (obj.class_name == "%") {
@@ -280,232 +447,24 @@ namespace zenkit {
 			return nullptr;
 		}
 
-		auto it = OBJECTS.find(obj.class_name);
-		auto type = ObjectType::unknown;
-		if (it != OBJECTS.end()) {
-			type = it->second;
+		if (_m_index != nullptr) {
+			_m_index->add(ArchiveObjectLocation {offset, obj.index, obj.object_name, obj.class_name});
+		}
+
+		auto const* cls = find_object_class(obj.class_name);
+		auto type = cls == nullptr ? ObjectType::unknown : cls->type;
+
+		if (cls != nullptr && !this->is_class_loaded(type)) {
+			_m_last_filtered = true;
+			this->skip_object(true);
+			return nullptr;
 		}
 
 		std::shared_ptr<Object> syn;
-		switch (type) {
-		case ObjectType::oCNpcTalent:
-			syn = std::make_shared<VNpc::Talent>();
-			break;
-		case ObjectType::zCEventManager:
-			syn = std::make_shared<EventManager>();
-			break;
-		case ObjectType::zCDecal:
-			syn = std::make_shared<VisualDecal>();
-			break;
-		case ObjectType::zCMesh:
-			syn = std::make_shared<VisualMesh>();
-			break;
-		case ObjectType::zCProgMeshProto:
-			syn = std::make_shared<VisualMultiResolutionMesh>();
-			break;
-		case ObjectType::zCParticleFX:
-			syn = std::make_shared<VisualParticleEffect>();
-			break;
-		case ObjectType::zCAICamera:
-			syn = std::make_shared<VisualCamera>();
-			break;
-		case ObjectType::zCModel:
-			syn = std::make_shared<VisualModel>();
-			break;
-		case ObjectType::zCMorphMesh:
-			syn = std::make_shared<VisualMorphMesh>();
-			break;
-		case ObjectType::oCAIHuman:
-			syn = std::make_shared<AiHuman>();
-			break;
-		case ObjectType::oCAIVobMove:
-			syn = std::make_shared<AiMove>();
-			break;
-		case ObjectType::zCSkyControler_Outdoor:
-			syn = std::make_shared<SkyController>();
-			break;
-		case ObjectType::oCCSPlayer:
-			syn = std::make_shared<CutscenePlayer>();
-			break;
-		case ObjectType::zCVobLevelCompo:
-			syn = std::make_shared<VLevel>();
-			break;
-		case ObjectType::zCVobStartpoint:
-			syn = std::make_shared<VStartPoint>();
-			break;
-		case ObjectType::zCVobStair:
-			syn = std::make_shared<VStair>();
-			break;
-		case ObjectType::zCVobSpot:
-			syn = std::make_shared<VSpot>();
-			break;
-		case ObjectType::zCVob:
-			syn = std::make_shared<VirtualObject>();
-			break;
-		case ObjectType::zCVobScreenFX:
-			syn = std::make_shared<VScreenEffect>();
-			break;
-		case ObjectType::zCCSCamera:
-			syn = std::make_shared<VCutsceneCamera>();
-			break;
-		case ObjectType::zCCamTrj_KeyFrame:
-			syn = std::make_shared<VCameraTrajectoryFrame>();
-			break;
-		case ObjectType::zCVobAnimate:
-			syn = std::make_shared<VAnimate>();
-			break;
-		case ObjectType::zCZoneVobFarPlane:
-			syn = std::make_shared<VZoneFarPlane>();
-			break;
-		case ObjectType::zCZoneVobFarPlaneDefault:
-			syn = std::make_shared<VZoneFarPlaneDefault>();
-			break;
-		case ObjectType::zCZoneZFogDefault:
-			syn = std::make_shared<VZoneFogDefault>();
-			break;
-		case ObjectType::zCZoneZFog:
-			syn = std::make_shared<VZoneFog>();
-			break;
-		case ObjectType::zCVobLensFlare:
-			syn = std::make_shared<VLensFlare>();
-			break;
-		case ObjectType::oCItem:
-			syn = std::make_shared<VItem>();
-			break;
-		case ObjectType::zCTrigger:
-			syn = std::make_shared<VTrigger>();
-			break;
-		case ObjectType::oCCSTrigger:
-			syn = std::make_shared<VCutsceneTrigger>();
-			break;
-		case ObjectType::oCMOB:
-			syn = std::make_shared<VMovableObject>();
-			break;
-		case ObjectType::oCMobInter:
-			syn = std::make_shared<VInteractiveObject>();
-			break;
-		case ObjectType::oCMobLadder:
-			syn = std::make_shared<VLadder>();
-			break;
-		case ObjectType::oCMobSwitch:
-			syn = std::make_shared<VSwitch>();
-			break;
-		case ObjectType::oCMobWheel:
-			syn = std::make_shared<VWheel>();
-			break;
-		case ObjectType::oCMobBed:
-			syn = std::make_shared<VBed>();
-			break;
-		case ObjectType::oCMobFire:
-			syn = std::make_shared<VFire>();
-			break;
-		case ObjectType::oCMobContainer:
-			syn = std::make_shared<VContainer>();
-			break;
-		case ObjectType::oCMobDoor:
-			syn = std::make_shared<VDoor>();
-			break;
-		case ObjectType::zCPFXController:
-			syn = std::make_shared<VParticleEffectController>();
-			break;
-		case ObjectType::zCVobLight:
-			syn = std::make_shared<VLight>();
-			break;
-		case ObjectType::zCVobSound:
-			syn = std::make_shared<VSound>();
-			break;
-		case ObjectType::zCVobSoundDaytime:
-			syn = std::make_shared<VSoundDaytime>();
-			break;
-		case ObjectType::oCZoneMusic:
-			syn = std::make_shared<VZoneMusic>();
-			break;
-		case ObjectType::oCZoneMusicDefault:
-			syn = std::make_shared<VZoneMusicDefault>();
-			break;
-		case ObjectType::zCMessageFilter:
-			syn = std::make_shared<VMessageFilter>();
-			break;
-		case ObjectType::zCCodeMaster:
-			syn = std::make_shared<VCodeMaster>();
-			break;
-		case ObjectType::zCTriggerList:
-			syn = std::make_shared<VTriggerList>();
-			break;
-		case ObjectType::oCTriggerScript:
-			syn = std::make_shared<VTriggerScript>();
-			break;
-		case ObjectType::zCMover:
-			syn = std::make_shared<VMover>();
-			break;
-		case ObjectType::oCTriggerChangeLevel:
-			syn = std::make_shared<VTriggerChangeLevel>();
-			break;
-		case ObjectType::zCTriggerWorldStart:
-			syn = std::make_shared<VTriggerWorldStart>();
-			break;
-		case ObjectType::oCTouchDamage:
-			syn = std::make_shared<VTouchDamage>();
-			break;
-		case ObjectType::zCTriggerUntouch:
-			syn = std::make_shared<VTriggerUntouch>();
-			break;
-		case ObjectType::zCEarthquake:
-			syn = std::make_shared<VEarthquake>();
-			break;
-		case ObjectType::zCMoverController:
-			syn = std::make_shared<VMoverController>();
-			break;
-		case ObjectType::oCNpc:
-			syn = std::make_shared<VNpc>();
-			break;
-		case ObjectType::oCWorld:
-			syn = std::make_shared<World>();
-			break;
-		case ObjectType::zCMaterial:
-			syn = std::make_shared<Material>();
-			break;
-		case ObjectType::oCSavegameInfo:
-			syn = std::make_shared<SaveMetadata>();
-			break;
-		case ObjectType::oCCSManager:
-			syn = std::make_shared<CutsceneManager>();
-			break;
-		case ObjectType::zCCSPoolItem:
-			syn = std::make_shared<CutscenePoolItem>();
-			break;
-		case ObjectType::zCCutscene:
-			syn = std::make_shared<Cutscene>();
-			break;
-		case ObjectType::zCCSCutsceneContext:
-			syn = std::make_shared<CutsceneContext>();
-			break;
-		case ObjectType::zCCSBlock:
-			syn = std::make_shared<CutsceneBlock>();
-			break;
-		case ObjectType::zCCSAtomicBlock:
-			syn = std::make_shared<CutsceneAtomicBlock>();
-			break;
-		case ObjectType::zCCSLib:
-			syn = std::make_shared<CutsceneLibrary>();
-			break;
-		case ObjectType::oCMsgConversation:
-			syn = std::make_shared<ConversationMessageEvent>();
-			break;
-		case ObjectType::zCCSProps:
-			syn = std::make_shared<CutsceneProps>();
-			break;
-#ifdef ZK_FUTURE
-		case ObjectType::zCWayNet:
-			syn = std::make_shared<WayNet>();
-			break;
-		case ObjectType::zCWaypoint:
-			syn = std::make_shared<WayPoint>();
-			break;
-#endif
-		default:
+		if (cls != nullptr && cls->make != nullptr) {
+			syn = cls->make(_m_arena.get());
+		} else {
 			ZKLOGE("ReadArchive", "Unknown object type: %s", obj.class_name.c_str());
-			break;
 		}
 
 		if (syn != nullptr) {
@@ -516,8 +475,9 @@ namespace zenkit {
 				reinterpret_cast<VirtualObject*>(syn.get())->id = obj.index;
 			}
 
-			_m_cache.insert_or_assign(obj.index, syn);
+			this->cache(obj.index, syn);
 			syn->load(*this, version);
+			detail::count_load_objects(1);
 		}
 
 		if (!this->read_object_end()) {
@@ -528,6 +488,89 @@ namespace zenkit {
 		return syn;
 	}
 
+	bool ReadArchive::read_packed(std::byte*, std::size_t) {
+		return false;
+	}
+
+	void ReadArchive::copy_entry(WriteArchive&) {
+		throw ParserError {"ReadArchive",
+		                   "cannot transcode archives of format " +
+		                       std::to_string(static_cast<uint32_t>(header.format)) +
+		                       ": the format does not store the types of its entries"};
+	}
+
+	void ReadArchive::transcode(WriteArchive& w) {
+		// Binary archives can't even tell object begins apart from entries without knowing the object's schema.
+		if (header.format == ArchiveFormat::BINARY) {
+			this->copy_entry(w);
+		}
+
+		// Writers re-assign object indices. Keep track of them so that references can be rewritten.
+		std::unordered_map<uint32_t, uint32_t> indices;
+		ArchiveObject obj;
+		int32_t depth = 0;
+
+		while (this->has_entries()) {
+			if (this->read_object_begin(obj)) {
+				if (obj.class_name == "\xA7") {
+					auto it = indices.find(obj.index);
+					if (it == indices.end()) {
+						throw ParserError {"ReadArchive", "unresolved reference: " + std::to_string(obj.index)};
+					}
+
+					w.write_ref(obj.object_name, it->second);
+					if (!this->read_object_end()) {
+						throw ParserError {"ReadArchive", "invalid reference object: has children"};
+					}
+					continue;
+				}
+
+				auto index = w.write_object_begin(obj.object_name, obj.class_name, obj.version);
+				if (obj.class_name != "%") indices.insert_or_assign(obj.index, index);
+				++depth;
+
+				if (obj.object_name == "MeshAndBsp") {
+					// The mesh and BSP-tree are stored as raw chunks. Walk the chunk headers to find their end,
+					// since the size stored in the header is not always reliable.
+					auto begin = read->tell();
+					read->seek(8, Whence::CUR); // version, size
+
+					for (uint16_t end_chunk : {0xB060, 0xC0FF}) {
+						uint16_t type;
+						do {
+							type = read->read_ushort();
+							read->seek(read->read_uint(), Whence::CUR);
+						} while (type != end_chunk && !read->eof());
+					}
+
+					auto size = read->tell() - begin;
+					read->seek(static_cast<ssize_t>(begin), Whence::BEG);
+
+					auto raw = read->slice(size);
+					auto span = raw->as_contiguous();
+					if (span.data() != nullptr) {
+						w.get_stream()->write(span.data(), span.size());
+					} else {
+						std::vector<std::byte> bytes(size);
+						w.get_stream()->write(bytes.data(), raw->read(bytes.data(), size));
+					}
+				}
+
+				continue;
+			}
+
+			if (depth > 0 && this->read_object_end()) {
+				w.write_object_end();
+				--depth;
+				continue;
+			}
+
+			this->copy_entry(w);
+		}
+
+		w.write_header();
+	}
+
 	void ReadArchive::skip_object(bool skip_current) {
 		ArchiveObject tmp;
 		int32_t level = skip_current ? 1 : 0;
@@ -556,6 +599,64 @@ namespace zenkit {
 		return nullptr;
 	}
 
+	namespace detail {
+		static size_t object_index_hash(Object const* obj) noexcept {
+			// Objects are at least 8-byte aligned, so the lowest bits carry no information.
+			auto v = reinterpret_cast<uintptr_t>(obj) >> 3;
+			return static_cast<size_t>(v * 0x9E3779B97F4A7C15ull);
+		}
+
+		void ObjectIndexMap::reserve(size_t n) {
+			// Keep the load factor below 1/2 so that probe sequences stay short.
+			size_t capacity = 16;
+			while (capacity < n * 2) {
+				capacity *= 2;
+			}
+
+			if (capacity <= _m_slots.size()) return;
+
+			auto old = std::move(_m_slots);
+			_m_slots.assign(capacity, {nullptr, 0});
+			_m_size = 0;
+
+			for (auto& [obj, index] : old) {
+				if (obj != nullptr) this->insert_or_assign(obj, index);
+			}
+		}
+
+		uint32_t const* ObjectIndexMap::find(Object const* obj) const noexcept {
+			if (_m_slots.empty() || obj == nullptr) return nullptr;
+
+			auto mask = _m_slots.size() - 1;
+			for (auto i = object_index_hash(obj) & mask;; i = (i + 1) & mask) {
+				auto const& slot = _m_slots[i];
+				if (slot.first == obj) return &slot.second;
+				if (slot.first == nullptr) return nullptr;
+			}
+		}
+
+		void ObjectIndexMap::insert_or_assign(Object const* obj, uint32_t index) {
+			if ((_m_size + 1) * 2 > _m_slots.size()) {
+				this->reserve(std::max<size_t>(_m_size + 1, 512));
+			}
+
+			auto mask = _m_slots.size() - 1;
+			for (auto i = object_index_hash(obj) & mask;; i = (i + 1) & mask) {
+				auto& slot = _m_slots[i];
+				if (slot.first == obj) {
+					slot.second = index;
+					return;
+				}
+
+				if (slot.first == nullptr) {
+					slot = {obj, index};
+					++_m_size;
+					return;
+				}
+			}
+		}
+	} // namespace detail
+
 	std::unique_ptr<WriteArchive> WriteArchive::to_save(Write* w, ArchiveFormat format) {
 		auto ar = to(w, format);
 		ar->_m_save = true;
@@ -567,8 +668,8 @@ namespace zenkit {
 	}
 
 	void WriteArchive::write_object(std::string_view name, std::shared_ptr<Object> const& obj, GameVersion version) {
-		if (auto it = _m_cache.find(obj.get()); it != _m_cache.end()) {
-			this->write_ref(name, it->second);
+		if (auto const* index = _m_cache.find(obj.get()); index != nullptr) {
+			this->write_ref(name, *index);
 			return;
 		}
 
@@ -582,12 +683,22 @@ namespace zenkit {
 			return;
 		}
 
-		std::string_view class_name = CLASS_NAMES.at(obj->get_object_type());
+		auto type = static_cast<size_t>(obj->get_object_type());
+		if (type >= std::size(OBJECT_CLASSES) || OBJECT_CLASSES[type].name.empty()) {
+			throw std::out_of_range {"object type cannot be stored in an archive: " + std::to_string(type)};
+		}
+
+		std::string_view class_name = OBJECT_CLASSES[type].name;
 		uint16_t obj_version = obj->get_version_identifier(version);
 
+		auto offset = this->get_stream()->tell();
 		auto index = this->write_object_begin(name, class_name, obj_version);
 		_m_cache.insert_or_assign(obj, index);
 
+		if (_m_index != nullptr) {
+			_m_index->add(ArchiveObjectLocation {offset, index, std::string {name}, std::string {class_name}});
+		}
+
 		obj->save(*this, version);
 		this->write_object_end();
 	}
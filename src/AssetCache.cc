@@ -0,0 +1,128 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/AssetCache.hh"
+#include "zenkit/Model.hh"
+#include "zenkit/ModelAnimation.hh"
+#include "zenkit/ModelHierarchy.hh"
+#include "zenkit/ModelMesh.hh"
+#include "zenkit/MorphMesh.hh"
+#include "zenkit/MultiResolutionMesh.hh"
+#include "zenkit/Stream.hh"
+#include "zenkit/Vfs.hh"
+
+#include <algorithm>
+#include <iterator>
+
+namespace zenkit {
+	enum class AssetCache::AssetType : std::uint8_t {
+		MODEL_HIERARCHY,
+		MODEL_MESH,
+		MODEL,
+		MODEL_ANIMATION,
+		MULTI_RESOLUTION_MESH,
+		MORPH_MESH,
+	};
+
+	AssetCache::AssetCache(AssetCacheOwnership ownership) : _m_ownership(ownership) {}
+
+	AssetCache& AssetCache::global() {
+		static AssetCache cache {AssetCacheOwnership::WEAK};
+		return cache;
+	}
+
+	template <typename T>
+	std::shared_ptr<T const> AssetCache::load(VfsNode const& node, AssetType type) {
+		auto view = node.data_view();
+		Key key {type, node.hash(), view.size()};
+
+		{
+			std::lock_guard guard {_m_lock};
+			auto it = _m_entries.find(key);
+			if (it != _m_entries.end()) {
+				if (auto cached = it->second.weak.lock()) return std::static_pointer_cast<T const>(cached);
+			}
+		}
+
+		// The file is parsed without holding the lock, so other assets can be loaded at the same time. If the
+		// same asset is loaded twice concurrently, the first one to finish is kept and returned to both callers.
+		auto asset = std::make_shared<T>();
+		auto r = node.open_read();
+		asset->load(r.get());
+
+		std::lock_guard guard {_m_lock};
+		auto& entry = _m_entries[key];
+		if (auto cached = entry.weak.lock()) return std::static_pointer_cast<T const>(cached);
+
+		std::shared_ptr<T const> result = std::move(asset);
+		entry.weak = result;
+		if (_m_ownership == AssetCacheOwnership::SHARED) entry.strong = result;
+
+		if (_m_entries.size() >= _m_prune_at) this->prune();
+		return result;
+	}
+
+	void AssetCache::index_hierarchy(std::shared_ptr<ModelHierarchy const> const& hierarchy) {
+		std::lock_guard guard {_m_lock};
+		_m_hierarchies[hierarchy->checksum] = hierarchy;
+	}
+
+	void AssetCache::prune() {
+		for (auto it = _m_entries.begin(); it != _m_entries.end();) {
+			it = it->second.weak.expired() ? _m_entries.erase(it) : std::next(it);
+		}
+
+		for (auto it = _m_hierarchies.begin(); it != _m_hierarchies.end();) {
+			it = it->second.expired() ? _m_hierarchies.erase(it) : std::next(it);
+		}
+
+		_m_prune_at = std::max<std::size_t>(64, _m_entries.size() * 2);
+	}
+
+	std::shared_ptr<ModelHierarchy const> AssetCache::load_model_hierarchy(VfsNode const& node) {
+		auto hierarchy = this->load<ModelHierarchy>(node, AssetType::MODEL_HIERARCHY);
+		this->index_hierarchy(hierarchy);
+		return hierarchy;
+	}
+
+	std::shared_ptr<ModelMesh const> AssetCache::load_model_mesh(VfsNode const& node) {
+		return this->load<ModelMesh>(node, AssetType::MODEL_MESH);
+	}
+
+	std::shared_ptr<Model const> AssetCache::load_model(VfsNode const& node) {
+		auto model = this->load<Model>(node, AssetType::MODEL);
+		this->index_hierarchy(std::shared_ptr<ModelHierarchy const> {model, &model->hierarchy});
+		return model;
+	}
+
+	std::shared_ptr<ModelAnimation const> AssetCache::load_model_animation(VfsNode const& node) {
+		return this->load<ModelAnimation>(node, AssetType::MODEL_ANIMATION);
+	}
+
+	std::shared_ptr<MultiResolutionMesh const> AssetCache::load_multi_resolution_mesh(VfsNode const& node) {
+		return this->load<MultiResolutionMesh>(node, AssetType::MULTI_RESOLUTION_MESH);
+	}
+
+	std::shared_ptr<MorphMesh const> AssetCache::load_morph_mesh(VfsNode const& node) {
+		return this->load<MorphMesh>(node, AssetType::MORPH_MESH);
+	}
+
+	std::shared_ptr<ModelHierarchy const> AssetCache::find_model_hierarchy(std::uint32_t checksum) {
+		std::lock_guard guard {_m_lock};
+		auto it = _m_hierarchies.find(checksum);
+		return it != _m_hierarchies.end() ? it->second.lock() : nullptr;
+	}
+
+	std::size_t AssetCache::size() {
+		std::lock_guard guard {_m_lock};
+		return static_cast<std::size_t>(std::count_if(_m_entries.begin(), _m_entries.end(), [](auto const& e) {
+			return !e.second.weak.expired();
+		}));
+	}
+
+	void AssetCache::clear() {
+		std::lock_guard guard {_m_lock};
+		_m_entries.clear();
+		_m_hierarchies.clear();
+		_m_prune_at = 64;
+	}
+} // namespace zenkit
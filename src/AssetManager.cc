@@ -0,0 +1,280 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/AssetManager.hh"
+#include "zenkit/Executor.hh"
+#include "zenkit/Stream.hh"
+#include "zenkit/Vfs.hh"
+
+#include "Internal.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace zenkit {
+	namespace detail {
+		enum class AssetState : std::uint8_t {
+			QUEUED,
+			LOADING,
+			READY,
+		};
+
+		using AssetKey = std::pair<std::type_index, std::string>;
+
+		struct AssetSlot {
+			std::string name;
+			std::shared_ptr<void const> (*load)(Read*);
+			std::int32_t priority;
+			std::uint64_t sequence;
+
+			// The value is only written before the state becomes READY, so it can be read without the lock afterwards.
+			std::atomic<AssetState> state {AssetState::QUEUED};
+			std::shared_ptr<void const> value;
+			std::size_t cost {0};
+
+			// Only valid while the slot is cached. Slots leave the cache when they are evicted.
+			std::map<AssetKey, std::shared_ptr<AssetSlot>>::iterator entry;
+			std::list<AssetSlot*>::iterator lru;
+			bool cached {false};
+		};
+
+		/// \brief Orders queued slots by descending priority, then in the order they were requested.
+		struct AssetQueueOrder {
+			bool operator()(AssetSlot const* a, AssetSlot const* b) const noexcept {
+				if (a->priority != b->priority) return a->priority > b->priority;
+				return a->sequence < b->sequence;
+			}
+		};
+
+		struct AssetManagerState {
+			Vfs const* vfs;
+			Executor* executor;
+			std::size_t budget;
+			std::size_t max_workers;
+
+			mutable std::mutex lock;
+			std::condition_variable done;
+
+			std::map<AssetKey, std::shared_ptr<AssetSlot>> assets;
+			std::set<AssetSlot*, AssetQueueOrder> queue;
+			std::list<AssetSlot*> lru; // Loaded slots, most recently requested first.
+			std::size_t memory_used {0};
+			std::uint64_t next_sequence {0};
+
+			std::size_t workers {0}; // Workers handed to the executor which have not exited yet.
+			std::size_t running {0}; // Workers which are currently running.
+			bool stopping {false};
+
+			/// \brief Checks whether a loaded slot is referenced by anything except the cache.
+			static bool in_use(AssetSlot const* slot) {
+				return slot->entry->second.use_count() > 1 || slot->value.use_count() > 1;
+			}
+
+			/// \brief Releases the least recently requested slots which are not in use until the budget is met.
+			void evict(bool all) {
+				for (auto it = lru.end(); it != lru.begin() && (all || memory_used > budget);) {
+					--it;
+
+					auto* slot = *it;
+					if (in_use(slot)) continue;
+
+					memory_used -= slot->cost;
+					slot->cached = false;
+					it = lru.erase(it);
+					assets.erase(slot->entry);
+				}
+			}
+
+			/// \brief Stores the result of a load. Must be called with the lock held.
+			void finish(AssetSlot* slot, std::shared_ptr<void const> value, std::size_t cost) {
+				slot->value = std::move(value);
+				slot->cost = cost;
+				slot->state.store(AssetState::READY, std::memory_order_release);
+
+				if (slot->cached) {
+					slot->lru = lru.insert(lru.begin(), slot);
+					memory_used += cost;
+					evict(false);
+				}
+
+				done.notify_all();
+			}
+
+			/// \brief Loads the asset of a slot. Must be called without the lock held.
+			void load(AssetSlot* slot, std::shared_ptr<void const>& value, std::size_t& cost) const {
+				auto node = vfs->find(slot->name);
+				if (node == nullptr) {
+					ZKLOGD("AssetManager", "File not found: %s", slot->name.c_str());
+					return;
+				}
+
+				try {
+					auto r = node->open_read();
+					value = slot->load(r.get());
+					cost = r->tell();
+				} catch (std::exception const& e) {
+					ZKLOGW("AssetManager", "Failed to load %s: %s", slot->name.c_str(), e.what());
+					value = nullptr;
+				}
+			}
+
+			void work() {
+				std::unique_lock guard {lock};
+				++running;
+
+				while (!stopping && !queue.empty()) {
+					auto* slot = *queue.begin();
+					queue.erase(queue.begin());
+					slot->state = AssetState::LOADING;
+
+					// Keep the slot alive, even if the caller drops its handle while the asset is loading.
+					auto owner = slot->entry->second;
+					guard.unlock();
+
+					std::shared_ptr<void const> value;
+					std::size_t cost = 0;
+					this->load(slot, value, cost);
+
+					guard.lock();
+					this->finish(slot, std::move(value), cost);
+				}
+
+				--running;
+				--workers;
+				done.notify_all();
+			}
+		};
+	} // namespace detail
+
+	AssetManager::AssetManager(Vfs const& vfs, AssetManagerOptions const& options)
+	    : _m_state(std::make_shared<detail::AssetManagerState>()) {
+		_m_state->vfs = &vfs;
+		_m_state->executor = options.executor != nullptr ? options.executor : get_executor();
+		_m_state->budget = options.memory_budget;
+		_m_state->max_workers = options.thread_count != 0
+		    ? options.thread_count
+		    : std::max<std::size_t>(_m_state->executor->concurrency(), 1);
+	}
+
+	AssetManager::~AssetManager() noexcept {
+		auto& state = *_m_state;
+		std::unique_lock guard {state.lock};
+		state.stopping = true;
+
+		for (auto* slot : state.queue) {
+			slot->state.store(detail::AssetState::READY, std::memory_order_release);
+		}
+		state.queue.clear();
+		state.done.notify_all();
+
+		// Workers which have not started yet only hold on to the state and exit immediately once they do.
+		state.done.wait(guard, [&state] { return state.running == 0; });
+	}
+
+	std::shared_ptr<detail::AssetSlot>
+	AssetManager::request(std::string_view name, std::int32_t priority, std::type_index type, LoadFn load) {
+		std::string key {name};
+		std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) {
+			return static_cast<char>(std::toupper(c));
+		});
+
+		auto& state = *_m_state;
+		std::shared_ptr<detail::AssetSlot> slot;
+		bool spawn = false;
+
+		{
+			std::lock_guard guard {state.lock};
+			auto [it, inserted] = state.assets.try_emplace(detail::AssetKey {type, std::move(key)});
+
+			if (!inserted) {
+				slot = it->second;
+
+				if (slot->state == detail::AssetState::QUEUED && priority > slot->priority) {
+					state.queue.erase(slot.get());
+					slot->priority = priority;
+					state.queue.insert(slot.get());
+				} else if (slot->state == detail::AssetState::READY) {
+					state.lru.splice(state.lru.begin(), state.lru, slot->lru);
+					state.evict(false);
+				}
+
+				return slot;
+			}
+
+			slot = std::make_shared<detail::AssetSlot>();
+			slot->name = it->first.second;
+			slot->load = load;
+			slot->priority = priority;
+			slot->sequence = state.next_sequence++;
+			slot->entry = it;
+			slot->cached = true;
+			it->second = slot;
+			state.queue.insert(slot.get());
+
+			if (state.workers < state.max_workers) {
+				++state.workers;
+				spawn = true;
+			}
+		}
+
+		// The executor may run the worker right away, so it must be called without holding the lock.
+		if (spawn) {
+			state.executor->execute([shared = _m_state] { shared->work(); });
+		}
+
+		return slot;
+	}
+
+	bool AssetManager::ready(detail::AssetSlot const& slot) noexcept {
+		return slot.state.load(std::memory_order_acquire) == detail::AssetState::READY;
+	}
+
+	std::shared_ptr<void const> AssetManager::get(detail::AssetSlot const& slot) {
+		if (!ready(slot)) return nullptr;
+		return slot.value;
+	}
+
+	std::shared_ptr<void const> AssetManager::wait(std::shared_ptr<detail::AssetSlot> const& slot) {
+		auto& state = *_m_state;
+		std::unique_lock guard {state.lock};
+
+		// Rather than waiting for a worker to get to it, load the asset right here.
+		if (slot->state == detail::AssetState::QUEUED) {
+			state.queue.erase(slot.get());
+			slot->state = detail::AssetState::LOADING;
+			guard.unlock();
+
+			std::shared_ptr<void const> value;
+			std::size_t cost = 0;
+			state.load(slot.get(), value, cost);
+
+			guard.lock();
+			state.finish(slot.get(), std::move(value), cost);
+		} else {
+			state.done.wait(guard, [&slot] { return slot->state == detail::AssetState::READY; });
+		}
+
+		return slot->value;
+	}
+
+	std::size_t AssetManager::size() const {
+		std::lock_guard guard {_m_state->lock};
+		return _m_state->assets.size();
+	}
+
+	std::size_t AssetManager::memory_used() const {
+		std::lock_guard guard {_m_state->lock};
+		return _m_state->memory_used;
+	}
+
+	void AssetManager::clear() {
+		std::lock_guard guard {_m_state->lock};
+		_m_state->evict(true);
+	}
+} // namespace zenkit
@@ -3,9 +3,181 @@
 #include "zenkit/Boxes.hh"
 #include "zenkit/Stream.hh"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZK_BOXES_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ZK_BOXES_NEON
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#define ZK_BOXES_WASM_SIMD
+#include <wasm_simd128.h>
+#endif
+
+#if defined(ZK_BOXES_SSE2) || defined(ZK_BOXES_NEON) || defined(ZK_BOXES_WASM_SIMD)
+#define ZK_BOXES_SIMD
+#endif
 
 namespace zenkit {
+	static_assert(sizeof(Vec3) == 3 * sizeof(float) && sizeof(AxisAlignedBoundingBox) == 2 * sizeof(Vec3));
+
+#if defined(ZK_BOXES_SIMD)
+	// Four float lanes of the vector instruction set of the target. Loading four lanes from Vec3::x reads one float
+	// past the vector, so the batched functions below only do that where the following float belongs to the same
+	// array. Masks only look at the lanes which hold coordinates.
+#if defined(ZK_BOXES_SSE2)
+	using Lanes = __m128;
+
+	static Lanes lanes_load(float const* p) noexcept {
+		return _mm_loadu_ps(p);
+	}
+
+	static Lanes lanes_splat(float v) noexcept {
+		return _mm_set1_ps(v);
+	}
+
+	static Lanes lanes_make(float x, float y, float z, float w) noexcept {
+		return _mm_setr_ps(x, y, z, w);
+	}
+
+	static void lanes_store(float* p, Lanes v) noexcept {
+		_mm_storeu_ps(p, v);
+	}
+
+	static Lanes lanes_min(Lanes a, Lanes b) noexcept {
+		return _mm_min_ps(a, b);
+	}
+
+	static Lanes lanes_max(Lanes a, Lanes b) noexcept {
+		return _mm_max_ps(a, b);
+	}
+
+	static Lanes lanes_add(Lanes a, Lanes b) noexcept {
+		return _mm_add_ps(a, b);
+	}
+
+	static Lanes lanes_sub(Lanes a, Lanes b) noexcept {
+		return _mm_sub_ps(a, b);
+	}
+
+	static Lanes lanes_mul(Lanes a, Lanes b) noexcept {
+		return _mm_mul_ps(a, b);
+	}
+
+	static Lanes lanes_abs(Lanes a) noexcept {
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+	}
+
+	/// \return A bit for each lane in which `a <= b`.
+	static unsigned lanes_le(Lanes a, Lanes b) noexcept {
+		return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(a, b)));
+	}
+#elif defined(ZK_BOXES_NEON)
+	using Lanes = float32x4_t;
+
+	static Lanes lanes_load(float const* p) noexcept {
+		return vld1q_f32(p);
+	}
+
+	static Lanes lanes_splat(float v) noexcept {
+		return vdupq_n_f32(v);
+	}
+
+	static Lanes lanes_make(float x, float y, float z, float w) noexcept {
+		float v[4] = {x, y, z, w};
+		return vld1q_f32(v);
+	}
+
+	static void lanes_store(float* p, Lanes v) noexcept {
+		vst1q_f32(p, v);
+	}
+
+	static Lanes lanes_min(Lanes a, Lanes b) noexcept {
+		return vminq_f32(a, b);
+	}
+
+	static Lanes lanes_max(Lanes a, Lanes b) noexcept {
+		return vmaxq_f32(a, b);
+	}
+
+	static Lanes lanes_add(Lanes a, Lanes b) noexcept {
+		return vaddq_f32(a, b);
+	}
+
+	static Lanes lanes_sub(Lanes a, Lanes b) noexcept {
+		return vsubq_f32(a, b);
+	}
+
+	static Lanes lanes_mul(Lanes a, Lanes b) noexcept {
+		return vmulq_f32(a, b);
+	}
+
+	static Lanes lanes_abs(Lanes a) noexcept {
+		return vabsq_f32(a);
+	}
+
+	static unsigned lanes_le(Lanes a, Lanes b) noexcept {
+		static constexpr std::uint32_t bits[4] = {1, 2, 4, 8};
+		return vaddvq_u32(vandq_u32(vcleq_f32(a, b), vld1q_u32(bits)));
+	}
+#else
+	using Lanes = v128_t;
+
+	static Lanes lanes_load(float const* p) noexcept {
+		return wasm_v128_load(p);
+	}
+
+	static Lanes lanes_splat(float v) noexcept {
+		return wasm_f32x4_splat(v);
+	}
+
+	static Lanes lanes_make(float x, float y, float z, float w) noexcept {
+		return wasm_f32x4_make(x, y, z, w);
+	}
+
+	static void lanes_store(float* p, Lanes v) noexcept {
+		wasm_v128_store(p, v);
+	}
+
+	static Lanes lanes_min(Lanes a, Lanes b) noexcept {
+		return wasm_f32x4_min(a, b);
+	}
+
+	static Lanes lanes_max(Lanes a, Lanes b) noexcept {
+		return wasm_f32x4_max(a, b);
+	}
+
+	static Lanes lanes_add(Lanes a, Lanes b) noexcept {
+		return wasm_f32x4_add(a, b);
+	}
+
+	static Lanes lanes_sub(Lanes a, Lanes b) noexcept {
+		return wasm_f32x4_sub(a, b);
+	}
+
+	static Lanes lanes_mul(Lanes a, Lanes b) noexcept {
+		return wasm_f32x4_mul(a, b);
+	}
+
+	static Lanes lanes_abs(Lanes a) noexcept {
+		return wasm_f32x4_abs(a);
+	}
+
+	static unsigned lanes_le(Lanes a, Lanes b) noexcept {
+		return wasm_i32x4_bitmask(wasm_f32x4_le(a, b));
+	}
+#endif
+
+	static Lanes lanes_load(Vec4 const& v) noexcept {
+		return lanes_load(&v.x);
+	}
+#endif
+
 	void AxisAlignedBoundingBox::load(Read* r) {
 		this->min = r->read_vec3();
 		this->max = r->read_vec3();
@@ -16,6 +188,160 @@ namespace zenkit {
 		w->write_vec3(this->max);
 	}
 
+	// The batched functions load the minimum of a box starting at AxisAlignedBoundingBox::min.x and its maximum
+	// starting at AxisAlignedBoundingBox::min.z, so that both loads stay within the box. The maximum then ends up
+	// in lanes 1 to 3.
+
+	AxisAlignedBoundingBox merge_bounding_boxes(AxisAlignedBoundingBox const* boxes, std::size_t count) noexcept {
+		if (count == 0) return AxisAlignedBoundingBox::zero();
+
+#ifdef ZK_BOXES_SIMD
+		auto lo = lanes_load(&boxes[0].min.x);
+		auto hi = lanes_load(&boxes[0].min.z);
+		for (std::size_t i = 1; i < count; ++i) {
+			lo = lanes_min(lo, lanes_load(&boxes[i].min.x));
+			hi = lanes_max(hi, lanes_load(&boxes[i].min.z));
+		}
+
+		float min[4], max[4];
+		lanes_store(min, lo);
+		lanes_store(max, hi);
+		return {Vec3 {min[0], min[1], min[2]}, Vec3 {max[1], max[2], max[3]}};
+#else
+		auto merged = boxes[0];
+		for (std::size_t i = 1; i < count; ++i) {
+			for (auto k = 0u; k < 3; ++k) {
+				merged.min[k] = std::min(merged.min[k], boxes[i].min[k]);
+				merged.max[k] = std::max(merged.max[k], boxes[i].max[k]);
+			}
+		}
+		return merged;
+#endif
+	}
+
+	void transform_bounding_boxes(Mat4 const& transform,
+	                              AxisAlignedBoundingBox const* boxes,
+	                              AxisAlignedBoundingBox* out,
+	                              std::size_t count) noexcept {
+		// The center of each box is transformed as a point, while its extent is transformed by the absolute
+		// values of the matrix, which yields the extent of the box containing the transformed corners.
+#ifdef ZK_BOXES_SIMD
+		auto c0 = lanes_load(transform.columns[0]);
+		auto c1 = lanes_load(transform.columns[1]);
+		auto c2 = lanes_load(transform.columns[2]);
+		auto c3 = lanes_load(transform.columns[3]);
+		auto a0 = lanes_abs(c0);
+		auto a1 = lanes_abs(c1);
+		auto a2 = lanes_abs(c2);
+		auto half = lanes_splat(0.5f);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			auto const& box = boxes[i];
+			auto lo = lanes_make(box.min.x, box.min.y, box.min.z, 0);
+			auto hi = lanes_make(box.max.x, box.max.y, box.max.z, 0);
+			auto center = lanes_mul(lanes_add(lo, hi), half);
+			auto extent = lanes_mul(lanes_sub(hi, lo), half);
+
+			float c[4], e[4];
+			lanes_store(c, center);
+			lanes_store(e, extent);
+
+			auto tc = lanes_add(lanes_add(lanes_mul(c0, lanes_splat(c[0])), lanes_mul(c1, lanes_splat(c[1]))),
+			                    lanes_add(lanes_mul(c2, lanes_splat(c[2])), c3));
+			auto te = lanes_add(lanes_add(lanes_mul(a0, lanes_splat(e[0])), lanes_mul(a1, lanes_splat(e[1]))),
+			                    lanes_mul(a2, lanes_splat(e[2])));
+
+			float min[4], max[4];
+			lanes_store(min, lanes_sub(tc, te));
+			lanes_store(max, lanes_add(tc, te));
+			out[i] = {Vec3 {min[0], min[1], min[2]}, Vec3 {max[0], max[1], max[2]}};
+		}
+#else
+		for (std::size_t i = 0; i < count; ++i) {
+			auto const& box = boxes[i];
+			Vec3 c {(box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f};
+			Vec3 e {(box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f, (box.max.z - box.min.z) * 0.5f};
+
+			Vec3 tc, te;
+			for (auto k = 0u; k < 3; ++k) {
+				tc[k] = transform[0][k] * c.x + transform[1][k] * c.y + transform[2][k] * c.z + transform[3][k];
+				te[k] = std::abs(transform[0][k]) * e.x + std::abs(transform[1][k]) * e.y +
+				    std::abs(transform[2][k]) * e.z;
+			}
+
+			out[i] = {Vec3 {tc.x - te.x, tc.y - te.y, tc.z - te.z}, Vec3 {tc.x + te.x, tc.y + te.y, tc.z + te.z}};
+		}
+#endif
+	}
+
+	void find_intersecting_boxes(AxisAlignedBoundingBox const& box,
+	                             AxisAlignedBoundingBox const* boxes,
+	                             std::size_t count,
+	                             std::vector<std::uint32_t>& hits) {
+		hits.clear();
+
+#ifdef ZK_BOXES_SIMD
+		// Each box's minimum has to be at most the maximum of the query box and vice versa.
+		auto max = lanes_make(box.max.x, box.max.y, box.max.z, 0);
+		auto min = lanes_make(0, box.min.x, box.min.y, box.min.z);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			auto below = lanes_le(lanes_load(&boxes[i].min.x), max) & 0x7;
+			auto above = lanes_le(min, lanes_load(&boxes[i].min.z)) & 0xE;
+			if ((below & above >> 1) == 0x7) hits.push_back(static_cast<std::uint32_t>(i));
+		}
+#else
+		for (std::size_t i = 0; i < count; ++i) {
+			if (boxes[i].intersects(box)) hits.push_back(static_cast<std::uint32_t>(i));
+		}
+#endif
+	}
+
+	void find_boxes_containing(Vec3 const& point,
+	                           AxisAlignedBoundingBox const* boxes,
+	                           std::size_t count,
+	                           std::vector<std::uint32_t>& hits) {
+		hits.clear();
+
+#ifdef ZK_BOXES_SIMD
+		auto lo = lanes_make(point.x, point.y, point.z, 0);
+		auto hi = lanes_make(0, point.x, point.y, point.z);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			auto below = lanes_le(lanes_load(&boxes[i].min.x), lo) & 0x7;
+			auto above = lanes_le(hi, lanes_load(&boxes[i].min.z)) & 0xE;
+			if ((below & above >> 1) == 0x7) hits.push_back(static_cast<std::uint32_t>(i));
+		}
+#else
+		for (std::size_t i = 0; i < count; ++i) {
+			if (boxes[i].contains(point)) hits.push_back(static_cast<std::uint32_t>(i));
+		}
+#endif
+	}
+
+	void find_points_inside(AxisAlignedBoundingBox const& box,
+	                        Vec3 const* points,
+	                        std::size_t count,
+	                        std::vector<std::uint32_t>& hits) {
+		hits.clear();
+		std::size_t i = 0;
+
+#ifdef ZK_BOXES_SIMD
+		auto min = lanes_make(box.min.x, box.min.y, box.min.z, 0);
+		auto max = lanes_make(box.max.x, box.max.y, box.max.z, 0);
+
+		// The last point is tested separately, since loading it would read past the end of the array.
+		for (; i + 1 < count; ++i) {
+			auto p = lanes_load(&points[i].x);
+			if ((lanes_le(min, p) & lanes_le(p, max) & 0x7) == 0x7) hits.push_back(static_cast<std::uint32_t>(i));
+		}
+#endif
+
+		for (; i < count; ++i) {
+			if (box.contains(points[i])) hits.push_back(static_cast<std::uint32_t>(i));
+		}
+	}
+
 	void OrientedBoundingBox::load(Read* r) {
 		center = r->read_vec3();
 		axes[0] = r->read_vec3();
@@ -82,4 +408,235 @@ namespace zenkit {
 
 		return box;
 	}
+
+	static float dot(Vec3 const& a, Vec3 const& b) noexcept {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	std::optional<float> OrientedBoundingBox::intersect(Vec3 const& origin, Vec3 const& direction) const noexcept {
+		auto offset = Vec3 {origin.x - center.x, origin.y - center.y, origin.z - center.z};
+
+		// Intersect the ray with the three slabs of the box in its local coordinate system.
+		float t_min = 0;
+		float t_max = std::numeric_limits<float>::max();
+		for (auto i = 0u; i < 3; ++i) {
+			auto o = dot(offset, axes[i]);
+			auto d = dot(direction, axes[i]);
+			auto extent = half_width[i];
+
+			if (std::abs(d) < std::numeric_limits<float>::epsilon()) {
+				// The ray is parallel to the slab.
+				if (o < -extent || o > extent) return std::nullopt;
+				continue;
+			}
+
+			auto t0 = (-extent - o) / d;
+			auto t1 = (extent - o) / d;
+			if (t0 > t1) std::swap(t0, t1);
+
+			t_min = std::max(t_min, t0);
+			t_max = std::min(t_max, t1);
+			if (t_min > t_max) return std::nullopt;
+		}
+
+		return t_min;
+	}
+
+	bool OrientedBoundingBox::intersects(OrientedBoundingBox const& other) const noexcept {
+		// See Christer Ericson, Real-Time Collision Detection, section 4.4.1.
+		float r[3][3];
+		float abs_r[3][3];
+
+		// A small epsilon avoids false separations when edges are nearly parallel and their cross product is
+		// close to zero.
+		constexpr float epsilon = 1e-6f;
+		for (auto i = 0u; i < 3; ++i) {
+			for (auto j = 0u; j < 3; ++j) {
+				r[i][j] = dot(axes[i], other.axes[j]);
+				abs_r[i][j] = std::abs(r[i][j]) + epsilon;
+			}
+		}
+
+		auto offset = Vec3 {other.center.x - center.x, other.center.y - center.y, other.center.z - center.z};
+		float t[3] = {dot(offset, axes[0]), dot(offset, axes[1]), dot(offset, axes[2])};
+
+		auto const& a = half_width;
+		auto const& b = other.half_width;
+
+		// The axes of this box
+		for (auto i = 0u; i < 3; ++i) {
+			auto rb = b[0] * abs_r[i][0] + b[1] * abs_r[i][1] + b[2] * abs_r[i][2];
+			if (std::abs(t[i]) > a[i] + rb) return false;
+		}
+
+		// The axes of the other box
+		for (auto j = 0u; j < 3; ++j) {
+			auto ra = a[0] * abs_r[0][j] + a[1] * abs_r[1][j] + a[2] * abs_r[2][j];
+			if (std::abs(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]) > ra + b[j]) return false;
+		}
+
+		// The cross products of the axes of both boxes
+		for (auto i = 0u; i < 3; ++i) {
+			auto i1 = (i + 1) % 3;
+			auto i2 = (i + 2) % 3;
+
+			for (auto j = 0u; j < 3; ++j) {
+				auto j1 = (j + 1) % 3;
+				auto j2 = (j + 2) % 3;
+
+				auto ra = a[i1] * abs_r[i2][j] + a[i2] * abs_r[i1][j];
+				auto rb = b[j1] * abs_r[i][j2] + b[j2] * abs_r[i][j1];
+				if (std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb) return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::optional<OrientedBoundingBoxHit> OrientedBoundingBox::raycast(Vec3 const& origin,
+	                                                                   Vec3 const& direction,
+	                                                                   float max_distance) const noexcept {
+		auto distance = this->intersect(origin, direction);
+		if (!distance || *distance > max_distance) return std::nullopt;
+		if (children.empty()) return OrientedBoundingBoxHit {*distance, this};
+
+		std::optional<OrientedBoundingBoxHit> closest;
+		for (auto& child : children) {
+			auto hit = child.raycast(origin, direction, max_distance);
+			if (!hit) continue;
+
+			closest = hit;
+			max_distance = hit->distance;
+		}
+
+		return closest;
+	}
+
+	bool OrientedBoundingBox::overlaps(OrientedBoundingBox const& other) const noexcept {
+		if (!this->intersects(other)) return false;
+		if (children.empty() && other.children.empty()) return true;
+
+		// Descend into the tree whose box is larger, so that both trees are narrowed down evenly.
+		auto volume = half_width.x * half_width.y * half_width.z;
+		auto other_volume = other.half_width.x * other.half_width.y * other.half_width.z;
+
+		if (other.children.empty() || (!children.empty() && volume >= other_volume)) {
+			for (auto& child : children) {
+				if (child.overlaps(other)) return true;
+			}
+
+			return false;
+		}
+
+		for (auto& child : other.children) {
+			if (this->overlaps(child)) return true;
+		}
+
+		return false;
+	}
+
+	Frustum Frustum::from_matrix(Mat4 const& view_projection) {
+		auto row = [&](unsigned i) {
+			return Vec4 {view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]};
+		};
+
+		auto r0 = row(0);
+		auto r1 = row(1);
+		auto r2 = row(2);
+		auto r3 = row(3);
+
+		// Each plane `a*x + b*y + c*z + d >= 0` is stored as `(a, b, c, -d)`, normalized.
+		auto plane = [](Vec4 const& a, Vec4 const& b, float sign) {
+			Vec4 p {a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, -(a.w + sign * b.w)};
+			auto length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+			return length > 0 ? p * (1.0f / length) : p;
+		};
+
+		return Frustum {{
+		    plane(r3, r0, +1), // left
+		    plane(r3, r0, -1), // right
+		    plane(r3, r1, +1), // bottom
+		    plane(r3, r1, -1), // top
+		    plane(r3, r2, +1), // near
+		    plane(r3, r2, -1), // far
+		}};
+	}
+
+	FrustumTest Frustum::test(AxisAlignedBoundingBox const& box) const noexcept {
+		std::uint8_t mask = 0x3F;
+		if (!this->test(box, mask)) return FrustumTest::OUTSIDE;
+		return mask == 0 ? FrustumTest::INSIDE : FrustumTest::INTERSECTS;
+	}
+
+	bool Frustum::test(AxisAlignedBoundingBox const& box, std::uint8_t& mask) const noexcept {
+		for (auto i = 0u; i < planes.size(); ++i) {
+			if ((mask & (1u << i)) == 0) continue;
+			auto const& plane = planes[i];
+
+			// The corners of the box furthest in front of and behind the plane.
+			Vec3 front {plane.x >= 0 ? box.max.x : box.min.x,
+			            plane.y >= 0 ? box.max.y : box.min.y,
+			            plane.z >= 0 ? box.max.z : box.min.z};
+			Vec3 back {plane.x >= 0 ? box.min.x : box.max.x,
+			           plane.y >= 0 ? box.min.y : box.max.y,
+			           plane.z >= 0 ? box.min.z : box.max.z};
+
+			if (plane.x * front.x + plane.y * front.y + plane.z * front.z - plane.w < 0) return false;
+			if (plane.x * back.x + plane.y * back.y + plane.z * back.z - plane.w >= 0) {
+				mask = static_cast<std::uint8_t>(mask & ~(1u << i));
+			}
+		}
+
+		return true;
+	}
+
+	std::uint32_t BoundingBoxSet::add(AxisAlignedBoundingBox const& box) {
+		auto index = _m_size++;
+		if (index % 4 == 0) _m_groups.emplace_back();
+
+		auto& group = _m_groups.back();
+		auto k = index % 4;
+		group.min_x[k] = box.min.x;
+		group.min_y[k] = box.min.y;
+		group.min_z[k] = box.min.z;
+		group.max_x[k] = box.max.x;
+		group.max_y[k] = box.max.y;
+		group.max_z[k] = box.max.z;
+		return index;
+	}
+
+	void BoundingBoxSet::clear() noexcept {
+		_m_groups.clear();
+		_m_size = 0;
+	}
+
+	std::uint32_t BoundingBoxSet::size() const noexcept {
+		return _m_size;
+	}
+
+	void BoundingBoxSet::cull(Frustum const& frustum, std::vector<std::uint32_t>& visible) const {
+		visible.clear();
+
+		for (auto g = 0u; g < _m_groups.size(); ++g) {
+			auto const& group = _m_groups[g];
+			std::int32_t inside[4] = {1, 1, 1, 1};
+
+			for (auto const& plane : frustum.planes) {
+				// Select the corner furthest in front of the plane once per plane, so that the inner loop
+				// has no branches and is compiled to vector instructions.
+				auto const* x = plane.x >= 0 ? group.max_x : group.min_x;
+				auto const* y = plane.y >= 0 ? group.max_y : group.min_y;
+				auto const* z = plane.z >= 0 ? group.max_z : group.min_z;
+
+				for (auto k = 0u; k < 4; ++k) {
+					inside[k] &= plane.x * x[k] + plane.y * y[k] + plane.z * z[k] - plane.w >= 0;
+				}
+			}
+
+			auto base = g * 4;
+			for (auto k = 0u; k < 4 && base + k < _m_size; ++k) {
+				if (inside[k]) visible.push_back(base + k);
+			}
+		}
+	}
 } // namespace zenkit
@@ -0,0 +1,512 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/CollisionMesh.hh"
+#include "zenkit/Mesh.hh"
+#include "zenkit/Stream.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace zenkit {
+	static constexpr char COLLISION_MESH_MAGIC[4] {'Z', 'K', 'C', 'M'};
+	static constexpr std::uint32_t COLLISION_MESH_VERSION = 1;
+
+	static Vec3 sub(Vec3 const& a, Vec3 const& b) {
+		return {a.x - b.x, a.y - b.y, a.z - b.z};
+	}
+
+	static Vec3 add(Vec3 const& a, Vec3 const& b) {
+		return {a.x + b.x, a.y + b.y, a.z + b.z};
+	}
+
+	static float dot(Vec3 const& a, Vec3 const& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	static Vec3 cross(Vec3 const& a, Vec3 const& b) {
+		return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+	}
+
+	static Vec3 normalize(Vec3 const& v) {
+		auto length = std::sqrt(dot(v, v));
+		return length > 0 ? v * (1.0f / length) : v;
+	}
+
+	/// \return The point of the triangle closest to \p p, see Ericson, Real-Time Collision Detection, 5.1.5.
+	static Vec3 closest_point(CollisionTriangle const& t, Vec3 const& p) {
+		auto ab = sub(t.b, t.a);
+		auto ac = sub(t.c, t.a);
+		auto ap = sub(p, t.a);
+
+		auto d1 = dot(ab, ap);
+		auto d2 = dot(ac, ap);
+		if (d1 <= 0 && d2 <= 0) return t.a;
+
+		auto bp = sub(p, t.b);
+		auto d3 = dot(ab, bp);
+		auto d4 = dot(ac, bp);
+		if (d3 >= 0 && d4 <= d3) return t.b;
+
+		auto vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) return add(t.a, ab * (d1 / (d1 - d3)));
+
+		auto cp = sub(p, t.c);
+		auto d5 = dot(ab, cp);
+		auto d6 = dot(ac, cp);
+		if (d6 >= 0 && d5 <= d6) return t.c;
+
+		auto vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) return add(t.a, ac * (d2 / (d2 - d6)));
+
+		auto va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+			return add(t.b, sub(t.c, t.b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))));
+		}
+
+		auto denom = 1.0f / (va + vb + vc);
+		return add(t.a, add(ab * (vb * denom), ac * (vc * denom)));
+	}
+
+	/// \return Whether \p point, which lies in the plane of the triangle, is inside of it.
+	static bool contains(CollisionTriangle const& t, Vec3 const& normal, Vec3 const& point) {
+		return dot(cross(sub(t.b, t.a), sub(point, t.a)), normal) >= 0 &&
+		    dot(cross(sub(t.c, t.b), sub(point, t.b)), normal) >= 0 &&
+		    dot(cross(sub(t.a, t.c), sub(point, t.c)), normal) >= 0;
+	}
+
+	/// \return The squared distance between the segments `p1 q1` and `p2 q2`, see Ericson, Real-Time Collision
+	///         Detection, 5.1.9.
+	static float segment_distance_sq(Vec3 const& p1, Vec3 const& q1, Vec3 const& p2, Vec3 const& q2) {
+		auto d1 = sub(q1, p1);
+		auto d2 = sub(q2, p2);
+		auto r = sub(p1, p2);
+		auto a = dot(d1, d1);
+		auto e = dot(d2, d2);
+		auto f = dot(d2, r);
+
+		float s = 0;
+		float t = 0;
+
+		if (a <= 1e-12f && e <= 1e-12f) {
+			// Both segments are points.
+		} else if (a <= 1e-12f) {
+			t = std::clamp(f / e, 0.0f, 1.0f);
+		} else {
+			auto c = dot(d1, r);
+			if (e <= 1e-12f) {
+				s = std::clamp(-c / a, 0.0f, 1.0f);
+			} else {
+				auto b = dot(d1, d2);
+				auto denom = a * e - b * b;
+
+				s = denom != 0 ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+				t = (b * s + f) / e;
+
+				if (t < 0) {
+					t = 0;
+					s = std::clamp(-c / a, 0.0f, 1.0f);
+				} else if (t > 1) {
+					t = 1;
+					s = std::clamp((b - c) / a, 0.0f, 1.0f);
+				}
+			}
+		}
+
+		auto d = sub(add(p1, d1 * s), add(p2, d2 * t));
+		return dot(d, d);
+	}
+
+	/// \return The fraction along `origin + direction` at which the ray hits the triangle or a negative value.
+	static float intersect_triangle(CollisionTriangle const& t, Vec3 const& origin, Vec3 const& direction) {
+		auto e1 = sub(t.b, t.a);
+		auto e2 = sub(t.c, t.a);
+		auto p = cross(direction, e2);
+		auto det = dot(e1, p);
+		if (std::abs(det) < 1e-12f) return -1;
+
+		auto inv = 1.0f / det;
+		auto s = sub(origin, t.a);
+		auto u = dot(s, p) * inv;
+		if (u < 0 || u > 1) return -1;
+
+		auto q = cross(s, e1);
+		auto v = dot(direction, q) * inv;
+		if (v < 0 || u + v > 1) return -1;
+
+		return dot(e2, q) * inv;
+	}
+
+	/// \return The fraction along `origin + direction` at which the ray hits the sphere or a negative value.
+	static float intersect_sphere(Vec3 const& center, float radius, Vec3 const& origin, Vec3 const& direction) {
+		auto m = sub(origin, center);
+		auto a = dot(direction, direction);
+		auto b = dot(m, direction);
+		auto c = dot(m, m) - radius * radius;
+		if (a <= 0 || (c > 0 && b > 0)) return -1;
+
+		auto disc = b * b - a * c;
+		if (disc < 0) return -1;
+		return std::max((-b - std::sqrt(disc)) / a, 0.0f);
+	}
+
+	/// \return The fraction along `origin + direction` at which the ray hits the side of the cylinder around the
+	///         segment `p q` or a negative value.
+	static float
+	intersect_cylinder(Vec3 const& p, Vec3 const& q, float radius, Vec3 const& origin, Vec3 const& direction) {
+		auto d = sub(q, p);
+		auto m = sub(origin, p);
+		auto dd = dot(d, d);
+		auto nd = dot(direction, d);
+		auto md = dot(m, d);
+
+		auto a = dd * dot(direction, direction) - nd * nd;
+		if (std::abs(a) < 1e-12f) return -1;
+
+		auto b = dd * dot(m, direction) - nd * md;
+		auto c = dd * (dot(m, m) - radius * radius) - md * md;
+		auto disc = b * b - a * c;
+		if (disc < 0) return -1;
+
+		auto t = (-b - std::sqrt(disc)) / a;
+		if (t < 0) return -1;
+
+		auto s = md + t * nd;
+		return s >= 0 && s <= dd ? t : -1;
+	}
+
+	/// \brief Tests the segment from \p origin to `origin + direction` against a box using the slab method.
+	/// \return Whether the segment enters the box before \p max.
+	static bool intersect_box(AxisAlignedBoundingBox const& box, Vec3 const& origin, Vec3 const& direction, float max) {
+		float t_near = 0;
+		float t_far = max;
+
+		for (auto i = 0u; i < 3; ++i) {
+			if (direction[i] == 0) {
+				if (origin[i] < box.min[i] || origin[i] > box.max[i]) return false;
+				continue;
+			}
+
+			auto inv = 1.0f / direction[i];
+			auto t0 = (box.min[i] - origin[i]) * inv;
+			auto t1 = (box.max[i] - origin[i]) * inv;
+			if (t0 > t1) std::swap(t0, t1);
+
+			t_near = std::max(t_near, t0);
+			t_far = std::min(t_far, t1);
+			if (t_near > t_far) return false;
+		}
+
+		return true;
+	}
+
+	static AxisAlignedBoundingBox expand(AxisAlignedBoundingBox box, float amount) {
+		for (auto i = 0u; i < 3; ++i) {
+			box.min[i] -= amount;
+			box.max[i] += amount;
+		}
+		return box;
+	}
+
+	/// \brief Builds the nodes for `triangles[begin, end)` into `nodes[index]` by splitting at the median centroid
+	///        along the longest axis.
+	static void build_node(std::vector<CollisionNode>& nodes,
+	                       std::vector<CollisionTriangle>& triangles,
+	                       std::uint32_t index,
+	                       std::uint32_t begin,
+	                       std::uint32_t end) {
+		AxisAlignedBoundingBox box {triangles[begin].a, triangles[begin].a};
+		AxisAlignedBoundingBox centers {};
+
+		for (auto i = begin; i < end; ++i) {
+			auto const& t = triangles[i];
+			for (auto const* v : {&t.a, &t.b, &t.c}) {
+				for (auto k = 0u; k < 3; ++k) {
+					box.min[k] = std::min(box.min[k], (*v)[k]);
+					box.max[k] = std::max(box.max[k], (*v)[k]);
+				}
+			}
+
+			for (auto k = 0u; k < 3; ++k) {
+				auto center = t.a[k] + t.b[k] + t.c[k];
+				if (i == begin) centers.min[k] = centers.max[k] = center;
+				centers.min[k] = std::min(centers.min[k], center);
+				centers.max[k] = std::max(centers.max[k], center);
+			}
+		}
+
+		nodes[index].bbox = box;
+		if (end - begin <= CollisionMesh::MAX_LEAF_SIZE) {
+			nodes[index].offset = begin;
+			nodes[index].count = end - begin;
+			return;
+		}
+
+		auto extent = sub(centers.max, centers.min);
+		auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0u : (extent.y >= extent.z ? 1u : 2u);
+		auto middle = begin + (end - begin) / 2;
+
+		std::nth_element(triangles.begin() + begin,
+		                 triangles.begin() + middle,
+		                 triangles.begin() + end,
+		                 [axis](CollisionTriangle const& l, CollisionTriangle const& r) {
+			                 return l.a[axis] + l.b[axis] + l.c[axis] < r.a[axis] + r.b[axis] + r.c[axis];
+		                 });
+
+		auto children = static_cast<std::uint32_t>(nodes.size());
+		nodes.resize(nodes.size() + 2);
+		nodes[index].offset = children;
+		nodes[index].count = 0;
+
+		build_node(nodes, triangles, children, begin, middle);
+		build_node(nodes, triangles, children + 1, middle, end);
+	}
+
+	void CollisionMesh::build(Mesh const& mesh) {
+		std::vector<std::uint32_t> polygons(mesh.geometry.size());
+		std::iota(polygons.begin(), polygons.end(), 0);
+		this->build(mesh, polygons);
+	}
+
+	void CollisionMesh::build(Mesh const& mesh, std::vector<std::uint32_t> const& polygons) {
+		this->nodes.clear();
+		this->triangles.clear();
+
+		for (auto index : polygons) {
+			if (index >= mesh.geometry.size()) continue;
+
+			auto const& polygon = mesh.geometry[index];
+			if (polygon.index_count < 3 || polygon.flags.is_portal || polygon.flags.is_ghost_occluder) continue;
+			if (polygon.material < mesh.materials.size() && mesh.materials[polygon.material].disable_collision) {
+				continue;
+			}
+
+			if (polygon.index_offset + polygon.index_count > mesh.polygon_vertex_indices.size()) continue;
+
+			auto const* indices = mesh.polygon_vertex_indices.data() + polygon.index_offset;
+			auto invalid = [&mesh](std::uint32_t i) { return i >= mesh.vertices.size(); };
+			if (std::any_of(indices, indices + polygon.index_count, invalid)) continue;
+
+			for (auto k = 2u; k < polygon.index_count; ++k) {
+				this->triangles.push_back(CollisionTriangle {
+				    mesh.vertices[indices[0]],
+				    mesh.vertices[indices[k - 1]],
+				    mesh.vertices[indices[k]],
+				    index,
+				});
+			}
+		}
+
+		if (this->triangles.empty()) return;
+
+		this->nodes.reserve(this->triangles.size() / MAX_LEAF_SIZE * 2 + 1);
+		this->nodes.emplace_back();
+		build_node(this->nodes, this->triangles, 0, 0, static_cast<std::uint32_t>(this->triangles.size()));
+	}
+
+	bool CollisionMesh::load(Read* r) {
+		char magic[sizeof COLLISION_MESH_MAGIC];
+		if (r->read(magic, sizeof magic) != sizeof magic ||
+		    std::memcmp(magic, COLLISION_MESH_MAGIC, sizeof magic) != 0 ||
+		    r->read_uint() != COLLISION_MESH_VERSION) {
+			return false;
+		}
+
+		std::vector<CollisionNode> node_data(r->read_uint());
+		std::vector<CollisionTriangle> triangle_data(r->read_uint());
+
+		auto node_size = node_data.size() * sizeof(CollisionNode);
+		auto triangle_size = triangle_data.size() * sizeof(CollisionTriangle);
+		if (r->read(node_data.data(), node_size) != node_size ||
+		    r->read(triangle_data.data(), triangle_size) != triangle_size) {
+			return false;
+		}
+
+		for (auto const& node : node_data) {
+			auto valid = node.count == 0 ? node.offset + 1 < node_data.size()
+			                             : node.offset + node.count <= triangle_data.size();
+			if (!valid) return false;
+		}
+
+		this->nodes = std::move(node_data);
+		this->triangles = std::move(triangle_data);
+		return true;
+	}
+
+	void CollisionMesh::save(Write* w) const {
+		w->write(COLLISION_MESH_MAGIC, sizeof COLLISION_MESH_MAGIC);
+		w->write_uint(COLLISION_MESH_VERSION);
+		w->write_uint(static_cast<std::uint32_t>(this->nodes.size()));
+		w->write_uint(static_cast<std::uint32_t>(this->triangles.size()));
+		w->write(this->nodes.data(), this->nodes.size() * sizeof(CollisionNode));
+		w->write(this->triangles.data(), this->triangles.size() * sizeof(CollisionTriangle));
+	}
+
+	std::optional<CollisionHit> CollisionMesh::raycast(Vec3 const& origin, Vec3 const& direction) const {
+		std::optional<CollisionHit> hit;
+		if (this->nodes.empty()) return hit;
+
+		std::vector<std::uint32_t> stack {0};
+		while (!stack.empty()) {
+			auto const& node = this->nodes[stack.back()];
+			stack.pop_back();
+
+			if (!intersect_box(node.bbox, origin, direction, hit ? hit->fraction : 1.0f)) continue;
+
+			if (node.count == 0) {
+				stack.push_back(node.offset + 1);
+				stack.push_back(node.offset);
+				continue;
+			}
+
+			for (auto i = node.offset; i < node.offset + node.count; ++i) {
+				auto const& triangle = this->triangles[i];
+				auto t = intersect_triangle(triangle, origin, direction);
+				if (t < 0 || t > (hit ? hit->fraction : 1.0f)) continue;
+
+				auto normal = normalize(cross(sub(triangle.b, triangle.a), sub(triangle.c, triangle.a)));
+				if (dot(normal, direction) > 0) normal = normal * -1.0f;
+				hit = CollisionHit {t, add(origin, direction * t), normal, i};
+			}
+		}
+
+		return hit;
+	}
+
+	std::optional<CollisionHit> CollisionMesh::sweep_sphere(Vec3 const& from, Vec3 const& to, float radius) const {
+		std::optional<CollisionHit> hit;
+		if (this->nodes.empty()) return hit;
+
+		auto motion = sub(to, from);
+		auto radius_sq = radius * radius;
+
+		auto consider = [&](float t, Vec3 const& point, std::uint32_t triangle) {
+			if (t < 0 || t > 1 || (hit && t >= hit->fraction)) return;
+			auto center = add(from, motion * t);
+			hit = CollisionHit {t, point, normalize(sub(center, point)), triangle};
+		};
+
+		std::vector<std::uint32_t> stack {0};
+		while (!stack.empty()) {
+			auto const& node = this->nodes[stack.back()];
+			stack.pop_back();
+
+			if (!intersect_box(expand(node.bbox, radius), from, motion, hit ? hit->fraction : 1.0f)) continue;
+
+			if (node.count == 0) {
+				stack.push_back(node.offset + 1);
+				stack.push_back(node.offset);
+				continue;
+			}
+
+			for (auto i = node.offset; i < node.offset + node.count; ++i) {
+				auto const& triangle = this->triangles[i];
+
+				// The sphere already touches the triangle at the start of the movement.
+				auto closest = closest_point(triangle, from);
+				auto offset = sub(from, closest);
+				if (dot(offset, offset) <= radius_sq) {
+					consider(0, closest, i);
+					continue;
+				}
+
+				// The sphere touches the inside of the triangle.
+				auto normal = normalize(cross(sub(triangle.b, triangle.a), sub(triangle.c, triangle.a)));
+				auto distance = dot(normal, sub(from, triangle.a));
+				if (distance < 0) {
+					normal = normal * -1.0f;
+					distance = -distance;
+				}
+
+				auto approach = -dot(normal, motion);
+				if (approach > 0) {
+					auto t = (distance - radius) / approach;
+					auto point = sub(add(from, motion * t), normal * radius);
+					if (t >= 0 && t <= 1 && contains(triangle, normal, point)) {
+						consider(t, point, i);
+						continue;
+					}
+				}
+
+				// The sphere touches one of the edges or corners of the triangle.
+				for (auto const& [p, q] : {std::pair {&triangle.a, &triangle.b},
+				                           std::pair {&triangle.b, &triangle.c},
+				                           std::pair {&triangle.c, &triangle.a}}) {
+					auto t = intersect_cylinder(*p, *q, radius, from, motion);
+					if (t >= 0) {
+						auto center = add(from, motion * t);
+						auto edge = sub(*q, *p);
+						auto s = dot(sub(center, *p), edge) / dot(edge, edge);
+						consider(t, add(*p, edge * s), i);
+					}
+
+					t = intersect_sphere(*p, radius, from, motion);
+					if (t >= 0) consider(t, *p, i);
+				}
+			}
+		}
+
+		return hit;
+	}
+
+	void CollisionMesh::overlap_capsule(Vec3 const& a,
+	                                    Vec3 const& b,
+	                                    float radius,
+	                                    std::vector<std::uint32_t>& triangles) const {
+		triangles.clear();
+		if (this->nodes.empty()) return;
+
+		AxisAlignedBoundingBox bounds {};
+		for (auto k = 0u; k < 3; ++k) {
+			bounds.min[k] = std::min(a[k], b[k]) - radius;
+			bounds.max[k] = std::max(a[k], b[k]) + radius;
+		}
+
+		auto radius_sq = radius * radius;
+		auto axis = sub(b, a);
+
+		std::vector<std::uint32_t> stack {0};
+		while (!stack.empty()) {
+			auto const& node = this->nodes[stack.back()];
+			stack.pop_back();
+
+			auto const& box = node.bbox;
+			if (box.min.x > bounds.max.x || box.max.x < bounds.min.x || box.min.y > bounds.max.y ||
+			    box.max.y < bounds.min.y || box.min.z > bounds.max.z || box.max.z < bounds.min.z) {
+				continue;
+			}
+
+			if (node.count == 0) {
+				stack.push_back(node.offset + 1);
+				stack.push_back(node.offset);
+				continue;
+			}
+
+			for (auto i = node.offset; i < node.offset + node.count; ++i) {
+				auto const& triangle = this->triangles[i];
+
+				// The axis of the capsule passes through the triangle.
+				auto t = intersect_triangle(triangle, a, axis);
+				auto touches = t >= 0 && t <= 1;
+
+				for (auto const* end : {&a, &b}) {
+					if (touches) break;
+					auto offset = sub(*end, closest_point(triangle, *end));
+					touches = dot(offset, offset) <= radius_sq;
+				}
+
+				for (auto const& [p, q] : {std::pair {&triangle.a, &triangle.b},
+				                           std::pair {&triangle.b, &triangle.c},
+				                           std::pair {&triangle.c, &triangle.a}}) {
+					if (touches) break;
+					touches = segment_distance_sq(a, b, *p, *q) <= radius_sq;
+				}
+
+				if (touches) triangles.push_back(i);
+			}
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+	}
+} // namespace zenkit
@@ -0,0 +1,58 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Error.hh"
+#include "zenkit/Stream.hh"
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace zenkit::detail {
+	// Helpers for the parts of cooked worlds (see World::save_cooked) which are stored in their in-memory
+	// representation. Arrays are prefixed with their length and copied in one go.
+
+	template <typename T>
+	void write_cooked(Write* w, std::vector<T> const& v) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		w->write_uint(static_cast<std::uint32_t>(v.size()));
+		w->write(v.data(), v.size() * sizeof(T));
+	}
+
+	/// \brief Reads the length of an array and checks that the rest of the stream holds that many elements.
+	///
+	/// Lengths come straight from the file, so they are checked before anything is allocated for them.
+	inline std::uint32_t read_cooked_count(Read* r, std::size_t element_size) {
+		auto count = r->read_uint();
+		auto position = r->tell();
+		r->seek(0, Whence::END);
+		auto end = r->tell();
+		r->seek(static_cast<ssize_t>(position), Whence::BEG);
+
+		if (count > (end - position) / element_size) {
+			throw ParserError {"World", "cooked world is truncated"};
+		}
+
+		return count;
+	}
+
+	template <typename T>
+	void read_cooked(Read* r, std::vector<T>& v) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		v.resize(read_cooked_count(r, sizeof(T)));
+
+		if (r->read(v.data(), v.size() * sizeof(T)) != v.size() * sizeof(T)) {
+			throw ParserError {"World", "cooked world is truncated"};
+		}
+	}
+
+	inline void write_cooked(Write* w, std::string const& v) {
+		w->write_uint(static_cast<std::uint32_t>(v.size()));
+		w->write_string(v);
+	}
+
+	inline void read_cooked(Read* r, std::string& v) {
+		v = r->read_string(read_cooked_count(r, 1));
+	}
+} // namespace zenkit::detail
@@ -4,10 +4,15 @@
 #include "zenkit/Archive.hh"
 #include "zenkit/Stream.hh"
 #include "zenkit/Error.hh"
+#include "zenkit/Misc.hh"
 
 #include "zenkit/vobs/Misc.hh"
 
+#include "Internal.hh"
+
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 namespace zenkit {
 	void ConversationMessageEvent::load(ReadArchive& r, GameVersion) {
@@ -80,6 +85,12 @@ namespace zenkit {
 		}
 
 		auto blk = r.read_object(version);
+		if (blk == nullptr) {
+			// Lazily loaded libraries skip the content of the block until it is accessed.
+			if (r.last_object_filtered()) return;
+			throw ParserError {"CutsceneLibrary", "missing block for " + this->name};
+		}
+
 		if (blk->get_object_type() == ObjectType::zCCSAtomicBlock) {
 			this->block = std::static_pointer_cast<CutsceneAtomicBlock>(blk);
 		} else if (blk->get_object_type() == ObjectType::zCCSBlock) {
@@ -103,37 +114,318 @@ namespace zenkit {
 		}
 	}
 
+	struct CutsceneLibrary::LazyBlocks {
+		std::unique_ptr<ReadArchive> archive;
+		GameVersion version;
+
+		// The archive indices of the blocks which have not been decoded yet.
+		std::unordered_map<CutsceneBlock const*, std::uint32_t> pending;
+		std::mutex lock;
+	};
+
 	std::shared_ptr<CutsceneBlock> CutsceneLibrary::block_by_name(std::string_view name) const {
+		if (this->_m_compact) return nullptr;
+		auto index = this->block_index();
 
-		auto result = std::lower_bound(this->blocks.begin(), this->blocks.end(), name, [](auto const& it, auto n) {
-			return it->name < n;
-		});
+		auto hash = ihash(name);
+		auto it = std::lower_bound(index->begin(), index->end(), std::pair<std::uint64_t, std::uint32_t> {hash, 0});
+
+		for (; it != index->end() && it->first == hash; ++it) {
+			if (it->second >= this->blocks.size()) continue;
+
+			auto const& block = this->blocks[it->second];
+			if (block == nullptr || !iequals(block->name, name)) continue;
+
+			this->decode_block(*block);
+			return block;
+		}
+
+		return nullptr;
+	}
+
+	void CutsceneLibrary::invalidate_block_index() noexcept {
+		std::atomic_store(&this->_m_block_names, std::shared_ptr<BlockIndex const> {});
+	}
+
+	std::size_t CutsceneLibrary::message_count() const noexcept {
+		return this->_m_compact ? this->_m_messages.size() : this->blocks.size();
+	}
+
+	CutsceneMessageView CutsceneLibrary::message(std::size_t i) const {
+		if (this->_m_compact) {
+			auto const& msg = this->_m_messages[i];
+			return CutsceneMessageView {this->view(msg.block), this->view(msg.text), this->view(msg.name), msg.type};
+		}
+
+		auto const& block = this->blocks[i];
+		auto msg = block->get_message();
+		if (msg == nullptr) return CutsceneMessageView {block->name, {}, {}, 0};
+		return CutsceneMessageView {block->name, msg->text, msg->name, msg->type};
+	}
+
+	std::optional<CutsceneMessageView> CutsceneLibrary::message_by_name(std::string_view name) const {
+		if (!this->_m_compact) {
+			auto block = this->block_by_name(name);
+			if (block == nullptr) return std::nullopt;
+
+			auto msg = block->get_message();
+			if (msg == nullptr) return CutsceneMessageView {block->name, {}, {}, 0};
+			return CutsceneMessageView {block->name, msg->text, msg->name, msg->type};
+		}
+
+		auto index = this->block_index();
+
+		auto hash = ihash(name);
+		auto it = std::lower_bound(index->begin(), index->end(), std::pair<std::uint64_t, std::uint32_t> {hash, 0});
+
+		for (; it != index->end() && it->first == hash; ++it) {
+			if (it->second >= this->_m_messages.size()) continue;
+			if (iequals(this->view(this->_m_messages[it->second].block), name)) return this->message(it->second);
+		}
+
+		return std::nullopt;
+	}
+
+	CutsceneLibrary::CompactString CutsceneLibrary::intern(std::string_view s) {
+		CompactString str {static_cast<std::uint32_t>(this->_m_strings.size()), static_cast<std::uint32_t>(s.size())};
+		this->_m_strings.append(s);
+		return str;
+	}
+
+	std::string_view CutsceneLibrary::view(CompactString s) const noexcept {
+		return std::string_view {this->_m_strings}.substr(s.offset, s.size);
+	}
 
-		if (result == this->blocks.end()) {
-			return nullptr;
+	std::shared_ptr<CutsceneLibrary::BlockIndex const> CutsceneLibrary::block_index() const {
+		auto index = std::atomic_load(&this->_m_block_names);
+		if (index == nullptr) index = this->build_block_index();
+		return index;
+	}
+
+	std::shared_ptr<CutsceneLibrary::BlockIndex const> CutsceneLibrary::build_block_index() const {
+		auto index = std::make_shared<BlockIndex>();
+
+		if (this->_m_compact) {
+			index->reserve(this->_m_messages.size());
+			for (auto i = 0u; i < this->_m_messages.size(); ++i) {
+				index->emplace_back(ihash(this->view(this->_m_messages[i].block)), i);
+			}
+		} else {
+			index->reserve(this->blocks.size());
+			for (auto i = 0u; i < this->blocks.size(); ++i) {
+				if (this->blocks[i] == nullptr) continue;
+				index->emplace_back(ihash(this->blocks[i]->name), i);
+			}
 		}
 
-		return *result;
+		std::sort(index->begin(), index->end());
+
+		// If multiple threads rebuild the index at once, each builds its own and the last one is kept.
+		std::shared_ptr<BlockIndex const> result = std::move(index);
+		std::atomic_store(&this->_m_block_names, result);
+		return result;
+	}
+
+	void CutsceneLibrary::decode_block(CutsceneBlock& block) const {
+		if (this->_m_lazy == nullptr) return;
+
+		std::lock_guard<std::mutex> guard {this->_m_lazy->lock};
+		auto it = this->_m_lazy->pending.find(&block);
+		if (it == this->_m_lazy->pending.end()) return;
+
+		auto& ar = *this->_m_lazy->archive;
+		if (!ar.seek_object(it->second)) {
+			ZKLOGE("CutsceneLibrary", "Block %s not found in archive", block.name.c_str());
+		} else if (auto full = ar.read_object<CutsceneBlock>(this->_m_lazy->version); full != nullptr) {
+			block.block = std::move(full->block);
+		}
+
+		this->_m_lazy->pending.erase(it);
+	}
+
+	void CutsceneLibrary::load(Read* r, GameVersion version, CutsceneLibraryLoadOptions const& options) {
+		ArchiveObject chnk {};
+		auto ar = ReadArchive::from(r);
+		ar->read_object_begin(chnk);
+
+		if (chnk.class_name != "zCCSLib") {
+			throw ParserError {"CutsceneLibrary", "'zCCSLib' chunk expected, got '" + chnk.class_name + "'"};
+		}
+
+		if (options.compact) {
+			this->load_compact(*ar);
+		} else if (!options.lazy) {
+			this->load(*ar, version);
+		} else {
+			// Only the outer block objects are read. Their content is skipped and recorded in the index instead, so
+			// that it can be decoded later using ReadArchive::seek_object.
+			auto index = std::make_shared<ArchiveIndex>();
+			ar->set_index(index);
+			ar->set_class_filter({ObjectType::zCCSBlock});
+
+			auto lazy = std::make_shared<LazyBlocks>();
+			lazy->version = version;
+
+			auto item_count = ar->read_int(); // NumOfItems
+			this->_m_compact = false;
+			this->_m_strings.clear();
+			this->_m_messages.clear();
+			this->blocks.clear();
+			this->blocks.reserve(static_cast<std::uint64_t>(std::max(item_count, 0)));
+
+			for (auto i = 0; i < item_count; ++i) {
+				auto first = index->objects().size();
+				auto block = ar->read_object<CutsceneBlock>(version);
+				if (block == nullptr) continue;
+
+				lazy->pending.emplace(block.get(), index->objects()[first].index);
+				this->blocks.push_back(std::move(block));
+			}
+
+			std::sort(this->blocks.begin(), this->blocks.end(), [](auto const& a, auto const& b) {
+				return a->name < b->name;
+			});
+
+			ar->set_class_filter({});
+			lazy->archive = std::move(ar);
+			this->_m_lazy = std::move(lazy);
+			this->build_block_index();
+			return;
+		}
+
+		if (!ar->read_object_end()) {
+			ZKLOGW("CutsceneLibrary", "Not fully parsed");
+			ar->skip_object(true);
+		}
 	}
 
 	void CutsceneLibrary::load(ReadArchive& r, GameVersion version) {
 		auto item_count = r.read_int(); // NumOfItems
+		this->_m_lazy = nullptr;
+		this->_m_compact = false;
+		this->_m_strings.clear();
+		this->_m_messages.clear();
 		this->blocks.reserve(static_cast<std::uint64_t>(item_count));
 
 		for (auto i = 0; i < item_count; ++i) {
 			this->blocks.push_back(r.read_object<CutsceneBlock>(version));
 		}
 
-		// Prepare blocks for binary search in block_by_name
+		// Keep the blocks ordered by name.
 		std::sort(this->blocks.begin(), this->blocks.end(), [](auto const& a, auto const& b) {
 			return a->name < b->name;
 		});
+
+		this->build_block_index();
+	}
+
+	void CutsceneLibrary::load_compact(ReadArchive& r) {
+		auto item_count = r.read_int(); // NumOfItems
+		this->_m_lazy = nullptr;
+		this->_m_compact = true;
+		this->_m_strings.clear();
+		this->_m_messages.clear();
+		this->_m_messages.reserve(static_cast<std::uint64_t>(std::max(item_count, 0)));
+		this->blocks.clear();
+
+		// Reads the entries of the blocks directly instead of creating a CutsceneBlock, CutsceneAtomicBlock and
+		// ConversationMessageEvent for each message.
+		ArchiveObject obj;
+		for (auto i = 0; i < item_count; ++i) {
+			if (!r.read_object_begin(obj) || obj.class_name != "zCCSBlock") {
+				throw ParserError {"CutsceneLibrary", "expected 'zCCSBlock' but got '" + obj.class_name + "'"};
+			}
+
+			CompactMessage msg {};
+			msg.block = this->intern(r.read_string()); // blockName
+			auto depth = 1;
+
+			// Blocks may contain another block instead of the message itself.
+			for (;;) {
+				auto block_count = r.read_int(); // numOfBlocks
+				(void) r.read_float();           // subBlock0
+
+				if (block_count != 1) {
+					throw ParserError {"CutsceneLibrary",
+					                   "expected only one block but got " + std::to_string(block_count) + " for " +
+					                       std::string {this->view(msg.block)}};
+				}
+
+				if (!r.read_object_begin(obj)) {
+					throw ParserError {"CutsceneLibrary", "missing block for " + std::string {this->view(msg.block)}};
+				}
+
+				++depth;
+				if (obj.class_name != "zCCSBlock") break;
+				(void) r.read_string(); // blockName
+			}
+
+			if (obj.class_name != "zCCSAtomicBlock" || !r.read_object_begin(obj) ||
+			    obj.class_name != "oCMsgConversation:oCNpcMessage:zCEventMessage") {
+				throw ParserError {"CutsceneLibrary",
+				                   "Unexpected block type: " + obj.class_name + " for " +
+				                       std::string {this->view(msg.block)}};
+			}
+
+			++depth;
+			msg.type = r.read_enum(); // subType
+
+			if (r.is_save_game()) {
+				(void) r.read_bool(); // highPriority
+				(void) r.read_bool(); // inUse
+				(void) r.read_bool(); // deleted
+			}
+
+			msg.text = this->intern(r.read_string()); // text
+			msg.name = this->intern(r.read_string()); // name
+
+			for (; depth > 0; --depth) {
+				if (!r.read_object_end()) {
+					ZKLOGW("CutsceneLibrary", "Not fully parsed");
+					r.skip_object(true);
+				}
+			}
+
+			this->_m_messages.push_back(msg);
+		}
+
+		// Keep the messages ordered by name, like the blocks.
+		std::sort(this->_m_messages.begin(), this->_m_messages.end(), [this](auto const& a, auto const& b) {
+			return this->view(a.block) < this->view(b.block);
+		});
+
+		this->_m_strings.shrink_to_fit();
+		this->build_block_index();
 	}
 
 	void CutsceneLibrary::save(WriteArchive& w, GameVersion version) const {
+		if (this->_m_compact) {
+			w.write_int("NumOfItems", static_cast<int32_t>(this->_m_messages.size()));
+
+			// The writer refers to objects it has seen before by their address, so all blocks are kept alive until
+			// the library has been written.
+			std::vector<std::shared_ptr<CutsceneBlock>> written;
+			written.reserve(this->_m_messages.size());
+
+			for (auto i = 0u; i < this->_m_messages.size(); ++i) {
+				auto view = this->message(i);
+				auto& block = written.emplace_back(std::make_shared<CutsceneBlock>());
+				block->name = view.block;
+
+				auto msg = block->get_message();
+				msg->text = view.text;
+				msg->name = view.name;
+				msg->type = view.type;
+				w.write_object(block, version);
+			}
+
+			return;
+		}
+
 		w.write_int("NumOfItems", static_cast<int32_t>(this->blocks.size()));
 
 		for (auto& block : this->blocks) {
+			if (block != nullptr) this->decode_block(*block);
 			w.write_object(block, version);
 		}
 	}
@@ -6,8 +6,28 @@
 #include "Internal.hh"
 
 #include <algorithm>
+#include <cstring>
 
 namespace zenkit {
+	/// \brief Converts ASCII letters to upper case. Unlike `toupper`, this does not depend on the current locale.
+	static constexpr char ascii_upper(char c) noexcept {
+		return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+	}
+
+	/// \brief Computes the FNV-1a hash of the given name, ignoring the case of ASCII letters.
+	static std::uint32_t hash_name(std::string_view name) noexcept {
+		std::uint32_t hash = 2166136261u;
+		for (auto c : name) {
+			hash = (hash ^ static_cast<std::uint8_t>(ascii_upper(c))) * 16777619u;
+		}
+		return hash;
+	}
+
+	static bool names_equal(std::string_view a, std::string_view b) noexcept {
+		return a.size() == b.size() &&
+		    std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return ascii_upper(x) == ascii_upper(y); });
+	}
+
 	DaedalusSymbolNotFound::DaedalusSymbolNotFound(std::string&& sym_name)
 	    : DaedalusScriptError("symbol not found: " + sym_name), name(sym_name) {}
 
@@ -87,40 +107,437 @@ namespace zenkit {
 		return s;
 	}
 
+	/// \return Whether a value of the given type can be read from or written to the given symbol.
+	static bool has_type(DaedalusSymbol const& sym, DaedalusDataType type) {
+		if (type == DaedalusDataType::INT) {
+			return sym.type() == DaedalusDataType::INT || sym.type() == DaedalusDataType::FUNCTION;
+		}
+
+		return sym.type() == type;
+	}
+
+	/// \brief Folds the code of an instance or prototype which only assigns values to members of the instance.
+	///
+	/// Only the patterns emitted by the Daedalus compiler are recognized: an optional call to the prototype of the
+	/// instance, followed by pushing the value and the member, followed by the move instruction. Prototypes need to
+	/// be folded before any instance using them.
+	///
+	/// \return `true` if the whole code was folded into \p init.
+	static bool fold_initializer(detail::DaedalusScriptCode const& code,
+	                             std::vector<DaedalusSymbol> const& symbols,
+	                             DaedalusSymbol const& sym,
+	                             DaedalusConstantInitializer& init) {
+		auto address = static_cast<std::uint32_t>(sym.address());
+		if (address >= code.instruction_index.size()) return false;
+
+		auto const& instructions = code.instructions;
+		auto i = code.instruction_index[address];
+		if (i == static_cast<std::uint32_t>(-1)) return false;
+
+		if (instructions[i].op == DaedalusOpcode::BL) {
+			auto it = code.symbols_by_address.find(instructions[i].address);
+			if (it == code.symbols_by_address.end()) return false;
+
+			auto proto = code.constant_initializers.find(it->second);
+			if (symbols[it->second].type() != DaedalusDataType::PROTOTYPE || proto == code.constant_initializers.end())
+				return false;
+
+			init = proto->second;
+			init.prototypes.push_back(it->second);
+			++i;
+		}
+
+		while (i < instructions.size()) {
+			if (instructions[i].op == DaedalusOpcode::RSR) return true;
+			if (i + 2 >= instructions.size()) return false;
+
+			auto const& value = instructions[i];
+			auto const& target = instructions[i + 1];
+			auto const& move = instructions[i + 2];
+			i += 3;
+
+			DaedalusDataType type;
+			switch (move.op) {
+			case DaedalusOpcode::MOVI:
+			case DaedalusOpcode::MOVVF:
+				type = DaedalusDataType::INT;
+				break;
+			case DaedalusOpcode::MOVF:
+				type = DaedalusDataType::FLOAT;
+				break;
+			case DaedalusOpcode::MOVS:
+				type = DaedalusDataType::STRING;
+				break;
+			default:
+				return false;
+			}
+
+			DaedalusConstantAssignment assignment {};
+			assignment.op = move.op;
+
+			if (value.op == DaedalusOpcode::PUSHI && type != DaedalusDataType::STRING) {
+				assignment.immediate = value.immediate;
+			} else if (value.op == DaedalusOpcode::PUSHV || value.op == DaedalusOpcode::PUSHVV) {
+				if (value.symbol >= symbols.size()) return false;
+
+				auto const& source = symbols[value.symbol];
+				std::uint8_t index = value.op == DaedalusOpcode::PUSHVV ? value.index : 0;
+				if (source.is_member() || !has_type(source, type) || index >= source.count()) return false;
+
+				assignment.source = value.symbol;
+				assignment.source_index = index;
+			} else {
+				return false;
+			}
+
+			if (target.op != DaedalusOpcode::PUSHV && target.op != DaedalusOpcode::PUSHVV) return false;
+			if (target.symbol >= symbols.size()) return false;
+
+			auto const& member = symbols[target.symbol];
+			std::uint8_t index = target.op == DaedalusOpcode::PUSHVV ? target.index : 0;
+			if (!member.is_member() || member.is_const() || !has_type(member, type) || index >= member.count())
+				return false;
+
+			assignment.member = target.symbol;
+			assignment.member_index = index;
+			init.assignments.push_back(assignment);
+		}
+
+		return false;
+	}
+
+	/// \return Whether the given opcode pops two integers and pushes the integer result.
+	static bool is_binary_operator(DaedalusOpcode op) {
+		switch (op) {
+		case DaedalusOpcode::ADD:
+		case DaedalusOpcode::SUB:
+		case DaedalusOpcode::MUL:
+		case DaedalusOpcode::DIV:
+		case DaedalusOpcode::MOD:
+		case DaedalusOpcode::OR:
+		case DaedalusOpcode::ANDB:
+		case DaedalusOpcode::LT:
+		case DaedalusOpcode::GT:
+		case DaedalusOpcode::LSL:
+		case DaedalusOpcode::LSR:
+		case DaedalusOpcode::LTE:
+		case DaedalusOpcode::EQ:
+		case DaedalusOpcode::NEQ:
+		case DaedalusOpcode::GTE:
+		case DaedalusOpcode::ORR:
+		case DaedalusOpcode::AND:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	/// \return Whether the given opcode writes an integer to a reference popped off the stack.
+	static bool is_int_assignment(DaedalusOpcode op) {
+		return op == DaedalusOpcode::MOVI || op == DaedalusOpcode::ADDMOVI || op == DaedalusOpcode::SUBMOVI ||
+		    op == DaedalusOpcode::MULMOVI || op == DaedalusOpcode::DIVMOVI;
+	}
+
+	/// \brief Finds the sequences of instructions the interpreter executes as one, see detail::DaedalusFusion.
+	static void fuse_instructions(detail::DaedalusScriptCode& code, std::vector<DaedalusSymbol> const& symbols) {
+		auto const& instructions = code.instructions;
+
+		auto operand = [&](DaedalusInstruction const& instr, bool target) {
+			if (instr.op == DaedalusOpcode::PUSHI) return !target;
+			if (instr.op != DaedalusOpcode::PUSHV && instr.op != DaedalusOpcode::PUSHVV) return false;
+			if (instr.symbol >= symbols.size()) return false;
+
+			auto const& sym = symbols[instr.symbol];
+			std::uint8_t index = instr.op == DaedalusOpcode::PUSHVV ? instr.index : 0;
+			return sym.type() == DaedalusDataType::INT && !sym.is_member() && index < sym.count() &&
+			    !(target && sym.is_const());
+		};
+
+		auto op = [&](std::size_t i) {
+			return i < instructions.size() ? instructions[i].op : DaedalusOpcode::NOP;
+		};
+
+		code.fusions.assign(instructions.size() + 1, detail::DaedalusFusion::NONE);
+		for (auto i = 0u; i < instructions.size(); ++i) {
+			auto& fusion = code.fusions[i];
+
+			if (!operand(instructions[i], false)) continue;
+
+			if (i + 1 < instructions.size() && operand(instructions[i + 1], false)) {
+				if (is_int_assignment(op(i + 2)) && operand(instructions[i + 1], true)) {
+					fusion = detail::DaedalusFusion::ASSIGN;
+				} else if (is_binary_operator(op(i + 2))) {
+					fusion = op(i + 3) == DaedalusOpcode::BZ ? detail::DaedalusFusion::BINARY2_BZ
+					                                         : detail::DaedalusFusion::BINARY2;
+				}
+			} else if (is_binary_operator(op(i + 1))) {
+				fusion = op(i + 2) == DaedalusOpcode::BZ ? detail::DaedalusFusion::BINARY_BZ
+				                                         : detail::DaedalusFusion::BINARY;
+			} else if (is_int_assignment(op(i + 1)) && operand(instructions[i], true)) {
+				fusion = detail::DaedalusFusion::STORE;
+			}
+		}
+	}
+
 	void DaedalusScript::load(Read* r) {
+		ZKTRACE_ZONE(zone, "DaedalusScript.load");
+		MemoryScope memory {MemoryCategory::SCRIPT};
+		auto begin = r->tell();
+
+		auto code = std::make_shared<detail::DaedalusScriptCode>();
+
 		this->_m_version = r->read_ubyte();
 		auto symbol_count = r->read_uint();
 
+		this->_m_symbols.clear();
 		this->_m_symbols.resize(symbol_count);
-		this->_m_symbols_by_name.reserve(symbol_count + 1);
-		this->_m_symbols_by_address.reserve(symbol_count);
+		code->symbol_count = symbol_count;
+		detail::count_load_objects(symbol_count);
+		code->symbols_by_name.reserve(symbol_count);
+		code->symbols_by_address.reserve(symbol_count);
 
 		r->seek(static_cast<ssize_t>(symbol_count * sizeof(std::uint32_t)), Whence::CUR); // Sort table
 		// The sort table is a list of indexes into the symbol table sorted lexicographically by symbol name!
 
+		{
+			ZKTRACE_ZONE(symbols_zone, "DaedalusScript.symbols");
+			auto symbols_begin = r->tell();
+
+			for (std::uint32_t i = 0; i < symbol_count; ++i) {
+				auto& sym = this->_m_symbols[i];
+				sym.load(r);
+
+				code->symbols_by_name.emplace_back(hash_name(sym.name()), i);
+				sym._m_index = i;
+			}
+
+			std::sort(code->symbols_by_name.begin(), code->symbols_by_name.end());
+			ZKTRACE_BYTES(symbols_zone, r->tell() - symbols_begin);
+		}
+
+		std::uint32_t text_size = r->read_uint();
+		code->text.resize(text_size);
+		r->read(code->text.data(), text_size);
+
+		// Decode all instructions up-front, so that executing them does not need to touch the stream.
+		code->instructions.reserve(text_size / 3);
+		code->instruction_index.assign(text_size, static_cast<uint32_t>(-1));
+
+		{
+			ZKTRACE_ZONE(decode_zone, "DaedalusScript.decode");
+			ZKTRACE_BYTES(decode_zone, text_size);
+
+			auto text = Read::from(&code->text);
+			for (std::uint32_t address = 0; address < text_size;) {
+				auto instr = DaedalusInstruction::decode(text.get());
+				code->instruction_index[address] = static_cast<uint32_t>(code->instructions.size());
+				code->instructions.push_back(instr);
+				address += instr.size;
+			}
+		}
+
+		this->build_indices(*code);
+		this->_m_code = std::move(code);
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+	}
+
+	static constexpr std::uint32_t COMPILED_SCRIPT_MAGIC = 0x53444B5A; // "ZKDS"
+	static constexpr std::uint32_t COMPILED_SCRIPT_VERSION = 1;
+
+	void DaedalusScript::save_compiled(Write* w) const {
+		w->write_uint(COMPILED_SCRIPT_MAGIC);
+		w->write_uint(COMPILED_SCRIPT_VERSION);
+		w->write_uint(sizeof(DaedalusInstruction));
+		w->write_ubyte(_m_version);
+
+		// Symbols added after loading, like the VM's temporary strings, are not part of the script.
+		w->write_uint(_m_code->symbol_count);
+		for (auto i = 0u; i < _m_code->symbol_count; ++i) {
+			_m_symbols[i].save_compiled(w);
+		}
+
+		auto const& by_name = _m_code->symbols_by_name;
+		w->write(by_name.data(), by_name.size() * sizeof(by_name[0]));
+
+		w->write_uint(static_cast<std::uint32_t>(_m_code->text.size()));
+		w->write(_m_code->text.data(), _m_code->text.size());
+
+		auto const& instructions = _m_code->instructions;
+		w->write_uint(static_cast<std::uint32_t>(instructions.size()));
+		w->write(instructions.data(), instructions.size() * sizeof(DaedalusInstruction));
+	}
+
+	void DaedalusScript::load_compiled(Read* r) {
+		ZKTRACE_ZONE(zone, "DaedalusScript.load_compiled");
+		MemoryScope memory {MemoryCategory::SCRIPT};
+		auto begin = r->tell();
+
+		if (r->read_uint() != COMPILED_SCRIPT_MAGIC) {
+			throw ParserError {"DaedalusScript", "magic missing"};
+		}
+
+		if (auto version = r->read_uint(); version != COMPILED_SCRIPT_VERSION) {
+			throw ParserError {"DaedalusScript", "unsupported compiled script version: " + std::to_string(version)};
+		}
+
+		if (r->read_uint() != sizeof(DaedalusInstruction)) {
+			throw ParserError {"DaedalusScript", "compiled script was saved by an incompatible build"};
+		}
+
+		auto code = std::make_shared<detail::DaedalusScriptCode>();
+		this->_m_version = r->read_ubyte();
+
+		auto symbol_count = r->read_uint();
+		this->_m_symbols.clear();
+		this->_m_symbols.resize(symbol_count);
+		code->symbol_count = symbol_count;
+		detail::count_load_objects(symbol_count);
+
 		for (std::uint32_t i = 0; i < symbol_count; ++i) {
-			auto& sym = this->_m_symbols[i];
-			sym.load(r);
+			this->_m_symbols[i].load_compiled(r);
+			this->_m_symbols[i]._m_index = i;
+		}
 
-			this->_m_symbols_by_name[sym.name()] = i;
-			sym._m_index = i;
+		auto& by_name = code->symbols_by_name;
+		by_name.resize(symbol_count);
+		r->read(by_name.data(), by_name.size() * sizeof(by_name[0]));
 
+		code->text.resize(r->read_uint());
+		r->read(code->text.data(), code->text.size());
+
+		code->instructions.resize(r->read_uint());
+		r->read(code->instructions.data(), code->instructions.size() * sizeof(DaedalusInstruction));
+
+		// Instructions are stored back to back, so the index is rebuilt from their sizes instead of being saved.
+		code->instruction_index.assign(code->text.size(), static_cast<uint32_t>(-1));
+
+		std::uint32_t address = 0;
+		for (std::uint32_t i = 0; i < code->instructions.size(); ++i) {
+			if (address >= code->text.size()) {
+				throw ParserError {"DaedalusScript", "instructions do not match the code segment"};
+			}
+
+			code->instruction_index[address] = i;
+			address += code->instructions[i].size;
+		}
+
+		if (address != code->text.size()) {
+			throw ParserError {"DaedalusScript", "instructions do not match the code segment"};
+		}
+
+		this->build_indices(*code);
+		this->_m_code = std::move(code);
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+	}
+
+	void DaedalusScript::build_indices(detail::DaedalusScriptCode& code) const {
+		ZKTRACE("DaedalusScript.build_indices");
+		code.symbols_by_address.reserve(_m_symbols.size());
+
+		// Symbol types and parents never change after loading, so class members and instances are indexed once.
+		for (auto const& sym : this->_m_symbols) {
 			if (sym.type() == DaedalusDataType::PROTOTYPE || sym.type() == DaedalusDataType::INSTANCE ||
 			    (sym.type() == DaedalusDataType::FUNCTION && sym.is_const() && !sym.is_member())) {
-				this->_m_symbols_by_address[sym.address()] = i;
+				code.symbols_by_address[sym.address()] = sym.index();
+			}
+
+			if (sym.is_member()) {
+				code.members_by_parent[sym.parent()].push_back(sym.index());
+			} else if (sym.type() == DaedalusDataType::INSTANCE && sym.is_const()) {
+				code.instances_by_parent[sym.parent()].push_back(sym.index());
+
+				// Instances are also enumerated for the class of their prototype, as long as the prototype was
+				// defined before the instance.
+				auto const* parent = this->find_symbol_by_index(sym.parent());
+				if (parent != nullptr && parent->type() == DaedalusDataType::PROTOTYPE &&
+				    parent->index() < sym.index()) {
+					code.instances_by_parent[parent->parent()].push_back(sym.index());
+				}
 			}
 		}
 
-		std::uint32_t text_size = r->read_uint();
-		std::vector code(text_size, std::byte {});
-		r->read(code.data(), text_size);
+		// Prototypes are folded first, so that instances can start from the initializer of their prototype.
+		for (auto type : {DaedalusDataType::PROTOTYPE, DaedalusDataType::INSTANCE}) {
+			for (auto const& sym : this->_m_symbols) {
+				if (sym.type() != type || !sym.is_const()) continue;
+
+				DaedalusConstantInitializer init;
+				if (fold_initializer(code, this->_m_symbols, sym, init)) {
+					code.constant_initializers.emplace(sym.index(), std::move(init));
+				}
+			}
+		}
+
+		fuse_instructions(code, this->_m_symbols);
+	}
+
+	DaedalusScript DaedalusScript::fork() const {
+		DaedalusScript copy;
+		copy._m_code = _m_code;
+		copy._m_version = _m_version;
+
+		// Symbols added after loading, like the temporary strings of a VM, are not part of the script.
+		copy._m_symbols.resize(std::min<size_t>(_m_code->symbol_count, _m_symbols.size()));
+
+		for (auto i = 0u; i < copy._m_symbols.size(); ++i) {
+			auto const& src = _m_symbols[i];
+			auto& dst = copy._m_symbols[i];
+
+			dst._m_name = src._m_name;
+			dst._m_address = src._m_address;
+			dst._m_parent = src._m_parent;
+			dst._m_class_offset = src._m_class_offset;
+			dst._m_count = src._m_count;
+			dst._m_type = src._m_type;
+			dst._m_flags = src._m_flags;
+			dst._m_generated = src._m_generated;
+			dst._m_file_index = src._m_file_index;
+			dst._m_line_start = src._m_line_start;
+			dst._m_line_count = src._m_line_count;
+			dst._m_char_start = src._m_char_start;
+			dst._m_char_count = src._m_char_count;
+			dst._m_member_offset = src._m_member_offset;
+			dst._m_class_size = src._m_class_size;
+			dst._m_class_string_count = src._m_class_string_count;
+			dst._m_return_type = src._m_return_type;
+			dst._m_index = src._m_index;
+			dst._m_registered_to = src._m_registered_to;
+
+			auto count = src.value_count();
+
+			if (auto* ints = std::get_if<std::unique_ptr<std::int32_t[]>>(&src._m_value)) {
+				if (*ints != nullptr) {
+					dst._m_value = std::unique_ptr<std::int32_t[]> {new std::int32_t[count]};
+					std::copy_n(ints->get(), count, std::get<0>(dst._m_value).get());
+				}
+			} else if (auto* floats = std::get_if<std::unique_ptr<float[]>>(&src._m_value)) {
+				if (*floats != nullptr) {
+					dst._m_value = std::unique_ptr<float[]> {new float[count]};
+					std::copy_n(floats->get(), count, std::get<1>(dst._m_value).get());
+				}
+			} else if (auto* strings = std::get_if<std::unique_ptr<std::string[]>>(&src._m_value)) {
+				if (*strings != nullptr) {
+					dst._m_value = std::unique_ptr<std::string[]> {new std::string[count]};
+					std::copy_n(strings->get(), count, std::get<2>(dst._m_value).get());
+				}
+			} else {
+				dst._m_value = std::shared_ptr<DaedalusInstance> {nullptr};
+			}
+		}
 
-		this->_m_text = Read::from(std::move(code));
+		return copy;
 	}
 
 	DaedalusInstruction DaedalusScript::instruction_at(std::uint32_t address) const {
-		_m_text->seek(address, Whence::BEG);
-		return DaedalusInstruction::decode(_m_text.get());
+		if (auto index = this->instruction_index(address); index != static_cast<uint32_t>(-1)) {
+			return _m_code->instructions[index];
+		}
+
+		// Not the start of an instruction. Decode whatever is there, as if the address was valid. A new reader is
+		// used, so that scripts sharing their code can do this concurrently.
+		auto text = Read::from(_m_code->text.data(), _m_code->text.size());
+		text->seek(address, Whence::BEG);
+		return DaedalusInstruction::decode(text.get());
 	}
 
 	DaedalusSymbol const* DaedalusScript::find_symbol_by_index(std::uint32_t index) const {
@@ -130,19 +547,28 @@ namespace zenkit {
 		return &_m_symbols[index];
 	}
 
-	DaedalusSymbol const* DaedalusScript::find_symbol_by_name(std::string_view name) const {
-		std::string up {name};
-		std::transform(up.begin(), up.end(), up.begin(), toupper);
+	DaedalusSymbolHandle DaedalusScript::resolve_symbol(std::string_view name) const {
+		auto const& index = _m_code->symbols_by_name;
+		auto hash = hash_name(name);
 
-		if (auto it = _m_symbols_by_name.find(up); it != _m_symbols_by_name.end()) {
-			return find_symbol_by_index(it->second);
+		auto begin = std::lower_bound(index.begin(), index.end(), std::pair {hash, 0u});
+		auto end = std::upper_bound(begin, index.end(), std::pair {hash, static_cast<std::uint32_t>(-1)});
+
+		// Symbols with the same name are ordered by index. The last one is the one which is used.
+		for (auto it = end; it != begin; --it) {
+			auto i = std::prev(it)->second;
+			if (i < _m_symbols.size() && names_equal(_m_symbols[i].name(), name)) return {i, _m_code.get()};
 		}
 
-		return nullptr;
+		return {};
+	}
+
+	DaedalusSymbol const* DaedalusScript::find_symbol_by_name(std::string_view name) const {
+		return this->find_symbol(this->resolve_symbol(name));
 	}
 
 	DaedalusSymbol const* DaedalusScript::find_symbol_by_address(std::uint32_t address) const {
-		if (auto it = _m_symbols_by_address.find(address); it != _m_symbols_by_address.end()) {
+		if (auto it = _m_code->symbols_by_address.find(address); it != _m_code->symbols_by_address.end()) {
 			return find_symbol_by_index(it->second);
 		}
 
@@ -157,18 +583,11 @@ namespace zenkit {
 	}
 
 	DaedalusSymbol* DaedalusScript::find_symbol_by_name(std::string_view name) {
-		std::string up {name};
-		std::transform(up.begin(), up.end(), up.begin(), toupper);
-
-		if (auto it = _m_symbols_by_name.find(up); it != _m_symbols_by_name.end()) {
-			return find_symbol_by_index(it->second);
-		}
-
-		return nullptr;
+		return this->find_symbol(this->resolve_symbol(name));
 	}
 
 	DaedalusSymbol* DaedalusScript::find_symbol_by_address(std::uint32_t address) {
-		if (auto it = _m_symbols_by_address.find(address); it != _m_symbols_by_address.end()) {
+		if (auto it = _m_code->symbols_by_address.find(address); it != _m_code->symbols_by_address.end()) {
 			return find_symbol_by_index(it->second);
 		}
 
@@ -180,15 +599,11 @@ namespace zenkit {
 		auto* cls = find_symbol_by_name(name);
 		if (cls == nullptr) return;
 
-		std::vector<uint32_t> prototypes {};
-		for (auto& sym : _m_symbols) {
-			if (sym.type() == DaedalusDataType::PROTOTYPE && sym.parent() == cls->index()) {
-				prototypes.push_back(sym.index());
-			} else if (sym.type() == DaedalusDataType::INSTANCE && sym.is_const() &&
-			           (std::find(prototypes.begin(), prototypes.end(), sym.parent()) != prototypes.end() ||
-			            sym.parent() == cls->index())) {
-				callback(sym);
-			}
+		auto it = _m_code->instances_by_parent.find(cls->index());
+		if (it == _m_code->instances_by_parent.end()) return;
+
+		for (auto index : it->second) {
+			callback(_m_symbols[index]);
 		}
 	}
 
@@ -216,52 +631,116 @@ namespace zenkit {
 	std::vector<DaedalusSymbol*> DaedalusScript::find_class_members(DaedalusSymbol const& cls) {
 		std::vector<DaedalusSymbol*> members {};
 
-		for (auto& sym : _m_symbols) {
-			if (!sym.is_member() || sym.parent() != cls.index()) continue;
-			members.push_back(&sym);
+		if (auto it = _m_code->members_by_parent.find(cls.index()); it != _m_code->members_by_parent.end()) {
+			members.reserve(it->second.size());
+			for (auto index : it->second) {
+				members.push_back(&_m_symbols[index]);
+			}
 		}
 
 		return members;
 	}
 
+	void DaedalusScript::register_members(std::string_view class_name,
+	                                      std::initializer_list<DaedalusMemberBinding> members) {
+		auto* cls = find_symbol_by_name(class_name);
+		if (cls == nullptr) throw DaedalusSymbolNotFound {std::string {class_name}};
+
+		// Index the members of the class by the part of their name following the class name once, instead of
+		// looking up every member among all symbols of the script.
+		std::vector<std::pair<std::uint64_t, DaedalusSymbol*>> by_name;
+		if (auto it = _m_code->members_by_parent.find(cls->index()); it != _m_code->members_by_parent.end()) {
+			by_name.reserve(it->second.size());
+			for (auto index : it->second) {
+				auto& sym = _m_symbols[index];
+				auto name = std::string_view {sym.name()};
+				by_name.emplace_back(ihash(name.substr(name.find('.') + 1)), &sym);
+			}
+		}
+
+		std::sort(by_name.begin(), by_name.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+		for (auto& member : members) {
+			auto hash = ihash(member.name);
+			auto it = std::lower_bound(by_name.begin(), by_name.end(), hash, [](auto const& entry, std::uint64_t h) {
+				return entry.first < h;
+			});
+
+			DaedalusSymbol* sym = nullptr;
+			for (; it != by_name.end() && it->first == hash; ++it) {
+				auto name = std::string_view {it->second->name()};
+				if (iequals(name.substr(name.find('.') + 1), member.name)) {
+					sym = it->second;
+					break;
+				}
+			}
+
+			if (sym == nullptr) {
+				if (member.optional) continue;
+				throw DaedalusSymbolNotFound {std::string {class_name} + "." + std::string {member.name}};
+			}
+
+			if (sym->count() > member.count) {
+				throw DaedalusMemberRegistrationError {sym,
+				                                       "incorrect number of elements: given " +
+				                                           std::to_string(member.count) + " expected " +
+				                                           std::to_string(sym->count())};
+			}
+
+			if (cls->_m_registered_to == nullptr) {
+				cls->_m_registered_to = member.owner;
+			} else if (cls->_m_registered_to != member.owner) {
+				throw DaedalusMemberRegistrationError {sym,
+				                                       "parent class is already registered with a different type (" +
+				                                           std::string {cls->_m_registered_to->name()} + ")"};
+			}
+
+			switch (member.type) {
+			case DaedalusDataType::STRING:
+				if (sym->type() != DaedalusDataType::STRING) throw DaedalusInvalidRegistrationDataType {sym, "string"};
+				break;
+			case DaedalusDataType::FLOAT:
+				if (sym->type() != DaedalusDataType::FLOAT) throw DaedalusInvalidRegistrationDataType {sym, "float"};
+				break;
+			default:
+				if (sym->type() != DaedalusDataType::INT && sym->type() != DaedalusDataType::FUNCTION)
+					throw DaedalusInvalidRegistrationDataType {sym, "int"};
+				break;
+			}
+
+			sym->_m_member_offset = member.offset;
+			sym->_m_registered_to = member.owner;
+		}
+	}
+
 	void DaedalusScript::register_as_opaque(DaedalusSymbol* sym) {
 		auto members = find_class_members(*sym);
 
 		auto registered_to = &typeid(DaedalusOpaqueInstance);
 		uint32_t class_size = 0;
+		uint32_t string_count = 0;
 
+		// Strings are placed at the start of the storage so that instances only need to remember how many of them
+		// to construct and destroy. Since the storage is allocated with new[], they are always aligned properly.
 		for (auto* member : members) {
-			member->_m_registered_to = registered_to;
-
-			switch (member->type()) {
-			case DaedalusDataType::VOID:
-			case DaedalusDataType::FLOAT:
-			case DaedalusDataType::INT:
-			case DaedalusDataType::CLASS:
-			case DaedalusDataType::FUNCTION:
-			case DaedalusDataType::PROTOTYPE:
-			case DaedalusDataType::INSTANCE:
-				member->_m_member_offset = class_size;
-				class_size += 4 * member->count();
-				break;
-			case DaedalusDataType::STRING: {
-				auto align = alignof(std::string);
-				auto offset = class_size;
+			if (member->type() != DaedalusDataType::STRING) continue;
 
-				auto remain = offset % align;
-				auto offset_remain = remain == 0 ? 0 : align - remain;
+			member->_m_member_offset = class_size;
+			class_size += sizeof(std::string) * member->count();
+			string_count += member->count();
+		}
 
-				class_size += offset_remain;
-				member->_m_member_offset = class_size;
+		for (auto* member : members) {
+			member->_m_registered_to = registered_to;
+			if (member->type() == DaedalusDataType::STRING) continue;
 
-				class_size += sizeof(std::string) * member->count();
-				break;
-			}
-			}
+			member->_m_member_offset = class_size;
+			class_size += 4 * member->count();
 		}
 
 		sym->_m_registered_to = registered_to;
 		sym->_m_class_size = class_size;
+		sym->_m_class_string_count = string_count;
 	}
 
 	DaedalusSymbol* DaedalusScript::add_temporary_strings_symbol() {
@@ -276,12 +755,154 @@ namespace zenkit {
 		return &_m_symbols.emplace_back(std::move(sym));
 	}
 
+	std::vector<std::uint32_t> DaedalusScript::find_function_code(DaedalusSymbol const& sym) const {
+		if (sym.type() != DaedalusDataType::FUNCTION || sym.is_external()) return {};
+
+		auto const& code = _m_code->instructions;
+		std::vector<bool> seen(code.size(), false);
+		std::vector<std::uint32_t> pending {sym.address()};
+		std::vector<std::uint32_t> result;
+
+		while (!pending.empty()) {
+			auto address = pending.back();
+			pending.pop_back();
+
+			auto index = this->instruction_index(address);
+			if (index == static_cast<std::uint32_t>(-1)) return {};
+			if (seen[index]) continue;
+
+			seen[index] = true;
+			result.push_back(address);
+
+			auto const& instr = code[index];
+			switch (instr.op) {
+			case DaedalusOpcode::RSR:
+				break;
+			case DaedalusOpcode::B:
+				pending.push_back(instr.address);
+				break;
+			case DaedalusOpcode::BZ:
+				pending.push_back(instr.address);
+				pending.push_back(address + instr.size);
+				break;
+			default:
+				pending.push_back(address + instr.size);
+				break;
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	std::uint32_t DaedalusScript::function_checksum(DaedalusSymbol const& sym) const {
+		// FNV-1a over the decoded instructions, so that the checksum does not depend on the layout of the struct.
+		std::uint32_t hash = 2166136261u;
+		auto mix = [&hash](std::uint32_t v) {
+			for (auto i = 0; i < 4; ++i) {
+				hash = (hash ^ ((v >> (8 * i)) & 0xFF)) * 16777619u;
+			}
+		};
+
+		for (auto address : this->find_function_code(sym)) {
+			auto const& instr = _m_code->instructions[this->instruction_index(address)];
+			mix(address);
+			mix(static_cast<std::uint32_t>(instr.op));
+			mix(instr.address);
+			mix(instr.symbol);
+			mix(static_cast<std::uint32_t>(instr.immediate));
+			mix(instr.index);
+		}
+
+		return hash;
+	}
+
+	std::vector<DaedalusFunctionInfo> DaedalusScript::analyze_functions() const {
+		std::vector<DaedalusFunctionInfo> functions;
+		std::unordered_map<std::uint32_t, std::size_t> by_symbol;
+
+		for (auto const& sym : _m_symbols) {
+			if (sym.type() != DaedalusDataType::FUNCTION || !sym.is_const() || sym.is_member() || sym.is_external())
+				continue;
+
+			auto code = this->find_function_code(sym);
+			if (code.empty()) continue;
+
+			DaedalusFunctionInfo info;
+			info.symbol = sym.index();
+			info.pure = true;
+
+			for (auto address : code) {
+				auto const& instr = _m_code->instructions[this->instruction_index(address)];
+
+				switch (instr.op) {
+				case DaedalusOpcode::BL:
+					if (auto const* callee = this->find_symbol_by_address(instr.address); callee != nullptr) {
+						info.callees.push_back(callee->index());
+					} else {
+						info.pure = false;
+					}
+					break;
+				case DaedalusOpcode::BE:
+					info.callees.push_back(instr.symbol);
+					info.pure = false;
+					break;
+				case DaedalusOpcode::PUSHV:
+				case DaedalusOpcode::PUSHVV: {
+					// Locals of a function are named after it, i.e. `FUNC.VAR`.
+					auto const* ref = this->find_symbol_by_index(instr.symbol);
+					auto const& name = sym.name();
+					auto local = ref != nullptr && ref->name().size() > name.size() &&
+					    ref->name()[name.size()] == '.' && ref->name().compare(0, name.size(), name) == 0;
+					auto constant = ref != nullptr && ref->is_const() && !ref->is_member();
+					if (!local && !constant) info.pure = false;
+					break;
+				}
+				case DaedalusOpcode::PUSHVI:
+				case DaedalusOpcode::GMOVI:
+				case DaedalusOpcode::MOVSS:
+					info.pure = false;
+					break;
+				default:
+					break;
+				}
+			}
+
+			std::sort(info.callees.begin(), info.callees.end());
+			info.callees.erase(std::unique(info.callees.begin(), info.callees.end()), info.callees.end());
+
+			by_symbol[info.symbol] = functions.size();
+			functions.push_back(std::move(info));
+		}
+
+		// A function calling an impure function is impure itself, which may in turn affect its callers.
+		for (auto changed = true; changed;) {
+			changed = false;
+
+			for (auto& info : functions) {
+				if (!info.pure) continue;
+
+				for (auto callee : info.callees) {
+					auto it = by_symbol.find(callee);
+					if (it == by_symbol.end() || !functions[it->second].pure) {
+						info.pure = false;
+						changed = true;
+						break;
+					}
+				}
+			}
+		}
+
+		return functions;
+	}
+
+	DaedalusConstantInitializer const* DaedalusScript::find_constant_initializer(DaedalusSymbol const& sym) const {
+		auto it = _m_code->constant_initializers.find(sym.index());
+		return it == _m_code->constant_initializers.end() ? nullptr : &it->second;
+	}
+
 	std::uint32_t DaedalusScript::size() const noexcept {
-		auto off = _m_text->tell();
-		_m_text->seek(0, Whence::END);
-		auto size = _m_text->tell();
-		_m_text->seek(static_cast<ssize_t>(off), Whence::BEG);
-		return static_cast<uint32_t>(size);
+		return static_cast<std::uint32_t>(_m_code->text.size());
 	}
 
 	void zk_internal_escape(std::string& s) {
@@ -303,6 +924,97 @@ namespace zenkit {
 		}
 	}
 
+	/// \brief The kinds of values stored by DaedalusSymbol::save_compiled.
+	enum class DaedalusCompiledValue : std::uint8_t { NONE, INT, FLOAT, STRING, INSTANCE };
+
+	void DaedalusSymbol::save_compiled(Write* w) const {
+		w->write_uint(static_cast<std::uint32_t>(_m_name.size()));
+		w->write_string(_m_name);
+		w->write_ubyte(_m_generated ? 1 : 0);
+		w->write_uint(static_cast<std::uint32_t>(_m_type));
+		w->write_uint(_m_flags);
+		w->write_uint(_m_count);
+		w->write_int(_m_address);
+		w->write_int(_m_parent);
+		w->write_int(_m_class_offset);
+		w->write_uint(_m_member_offset);
+		w->write_uint(_m_class_size);
+		w->write_uint(static_cast<std::uint32_t>(_m_return_type));
+		w->write_uint(_m_file_index);
+		w->write_uint(_m_line_start);
+		w->write_uint(_m_line_count);
+		w->write_uint(_m_char_start);
+		w->write_uint(_m_char_count);
+
+		auto count = this->value_count();
+		if (auto* ints = std::get_if<std::unique_ptr<std::int32_t[]>>(&_m_value); ints && *ints) {
+			w->write_ubyte(static_cast<std::uint8_t>(DaedalusCompiledValue::INT));
+			w->write(ints->get(), count * sizeof(std::int32_t));
+		} else if (auto* floats = std::get_if<std::unique_ptr<float[]>>(&_m_value); floats && *floats) {
+			w->write_ubyte(static_cast<std::uint8_t>(DaedalusCompiledValue::FLOAT));
+			w->write(floats->get(), count * sizeof(float));
+		} else if (auto* strings = std::get_if<std::unique_ptr<std::string[]>>(&_m_value); strings && *strings) {
+			w->write_ubyte(static_cast<std::uint8_t>(DaedalusCompiledValue::STRING));
+			for (auto i = 0u; i < count; ++i) {
+				w->write_uint(static_cast<std::uint32_t>((*strings)[i].size()));
+				w->write_string((*strings)[i]);
+			}
+		} else if (std::holds_alternative<std::shared_ptr<DaedalusInstance>>(_m_value)) {
+			// Instances belong to the VM they were initialized in, so only the fact that there is one is saved.
+			w->write_ubyte(static_cast<std::uint8_t>(DaedalusCompiledValue::INSTANCE));
+		} else {
+			w->write_ubyte(static_cast<std::uint8_t>(DaedalusCompiledValue::NONE));
+		}
+	}
+
+	void DaedalusSymbol::load_compiled(Read* r) {
+		_m_name = r->read_string(r->read_uint());
+		_m_generated = r->read_ubyte() != 0;
+		_m_type = static_cast<DaedalusDataType>(r->read_uint());
+		_m_flags = r->read_uint();
+		_m_count = r->read_uint();
+		_m_address = r->read_int();
+		_m_parent = r->read_int();
+		_m_class_offset = r->read_int();
+		_m_member_offset = r->read_uint();
+		_m_class_size = r->read_uint();
+		_m_return_type = static_cast<DaedalusDataType>(r->read_uint());
+		_m_file_index = r->read_uint();
+		_m_line_start = r->read_uint();
+		_m_line_count = r->read_uint();
+		_m_char_start = r->read_uint();
+		_m_char_count = r->read_uint();
+
+		auto count = this->value_count();
+		switch (static_cast<DaedalusCompiledValue>(r->read_ubyte())) {
+		case DaedalusCompiledValue::INT: {
+			std::unique_ptr<std::int32_t[]> value {new std::int32_t[count]};
+			r->read(value.get(), count * sizeof(std::int32_t));
+			_m_value = std::move(value);
+			break;
+		}
+		case DaedalusCompiledValue::FLOAT: {
+			std::unique_ptr<float[]> value {new float[count]};
+			r->read(value.get(), count * sizeof(float));
+			_m_value = std::move(value);
+			break;
+		}
+		case DaedalusCompiledValue::STRING: {
+			std::unique_ptr<std::string[]> value {new std::string[count]};
+			for (std::uint32_t i = 0; i < count; ++i) {
+				value[i] = r->read_string(r->read_uint());
+			}
+			_m_value = std::move(value);
+			break;
+		}
+		case DaedalusCompiledValue::INSTANCE:
+			_m_value = std::shared_ptr<DaedalusInstance> {nullptr};
+			break;
+		default:
+			break;
+		}
+	}
+
 	void DaedalusSymbol::load(Read* r) {
 		if (r->read_uint() != 0) {
 			this->_m_name = r->read_line(false);
@@ -577,63 +1289,25 @@ namespace zenkit {
 			_m_flags &= ~DaedalusSymbolFlag::TRAP_ACCESS;
 	}
 
-	DaedalusOpaqueInstance::DaedalusOpaqueInstance(DaedalusSymbol const& sym,
-	                                               std::vector<DaedalusSymbol*> const& members) {
-		size_t str_count = 0;
-		for (auto* member : members) {
-			if (member->type() != DaedalusDataType::STRING) continue;
-			str_count += member->count();
-		}
-
-		_m_storage.reset(new uint8_t[sym.class_size()]);
-		_m_strings.resize(str_count, nullptr);
-
-		str_count = 0;
-		for (auto* member : members) {
-			unsigned offset = member->offset_as_member();
+	DaedalusOpaqueInstance::DaedalusOpaqueInstance(DaedalusSymbol const& cls)
+	    : _m_storage(new std::uint8_t[cls.class_size()]), _m_string_count(cls._m_class_string_count) {
+		auto strings_size = sizeof(std::string) * _m_string_count;
+		std::memset(_m_storage.get() + strings_size, 0, cls.class_size() - strings_size);
 
-			for (auto i = 0U; i < member->count(); ++i) {
-				switch (member->type()) {
-				case DaedalusDataType::FLOAT:
-					this->construct_at<float>(offset, 0.f);
-					offset += 4;
-					break;
-				case DaedalusDataType::INT:
-					this->construct_at<int>(offset, 0);
-					offset += 4;
-					break;
-				case DaedalusDataType::STRING:
-					_m_strings[str_count] = this->construct_at<std::string>(offset, "");
-					str_count++;
-					offset += sizeof(std::string);
-					break;
-				case DaedalusDataType::FUNCTION:
-					this->construct_at<int>(offset, 0);
-					offset += 4;
-					break;
-				case DaedalusDataType::CLASS:
-				case DaedalusDataType::PROTOTYPE:
-				case DaedalusDataType::INSTANCE:
-				case DaedalusDataType::VOID:
-					this->construct_at<int>(offset);
-					offset += 4;
-					break;
-				}
-			}
+		auto* strings = reinterpret_cast<std::string*>(_m_storage.get());
+		for (auto i = 0U; i < _m_string_count; ++i) {
+			new (static_cast<void*>(strings + i)) std::string();
 		}
 	}
 
-	DaedalusOpaqueInstance::~DaedalusOpaqueInstance() {
-		for (auto& i : _m_strings)
-			i->std::string::~string();
-	}
+	DaedalusOpaqueInstance::DaedalusOpaqueInstance(DaedalusSymbol const& sym, std::vector<DaedalusSymbol*> const&)
+	    : DaedalusOpaqueInstance(sym) {}
 
-	template <typename T, typename... Args>
-	T* DaedalusOpaqueInstance::construct_at(size_t offset, Args&&... args) {
-		auto align = alignof(T);
-		auto remain = offset % align;
-		auto real_offset = remain == 0 ? offset : offset + (align - remain);
-		return new (static_cast<void*>(&_m_storage[real_offset])) T(std::forward<Args>(args)...);
+	DaedalusOpaqueInstance::~DaedalusOpaqueInstance() {
+		auto* strings = reinterpret_cast<std::string*>(_m_storage.get());
+		for (auto i = 0U; i < _m_string_count; ++i) {
+			strings[i].std::string::~string();
+		}
 	}
 
 	DaedalusTransientInstance::DaedalusTransientInstance() {
@@ -4,6 +4,9 @@
 
 #include "Internal.hh"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <utility>
 
 namespace zenkit {
@@ -75,6 +78,95 @@ namespace zenkit {
 		bool _m_inhibited {false};
 	};
 
+	/// \brief Marks an external or compiled function as executing for as long as it is in scope.
+	class DepthScope {
+	public:
+		explicit DepthScope(std::uint32_t& depth) : _m_depth(depth) {
+			++_m_depth;
+		}
+
+		~DepthScope() {
+			--_m_depth;
+		}
+
+	private:
+		std::uint32_t& _m_depth;
+	};
+
+	/// \brief Records a call in the profile of a VM for as long as it is in scope.
+	class ProfileScope {
+	public:
+		ProfileScope(DaedalusVmProfile* profile, std::uint32_t symbol) : _m_profile(profile) {
+			if (_m_profile != nullptr) _m_profile->enter(symbol);
+		}
+
+		~ProfileScope() {
+			if (_m_profile != nullptr) _m_profile->leave();
+		}
+
+	private:
+		DaedalusVmProfile* _m_profile;
+	};
+
+	std::uint32_t DaedalusVmProfile::find_child(std::uint32_t parent, std::uint32_t symbol) {
+		auto key = static_cast<std::uint64_t>(parent) << 32 | symbol;
+		auto [it, inserted] = _m_children.try_emplace(key, static_cast<std::uint32_t>(nodes.size()));
+		if (inserted) nodes.push_back({symbol, parent, {}});
+		return it->second;
+	}
+
+	void DaedalusVmProfile::enter(std::uint32_t symbol) {
+		auto parent = _m_frames.empty() ? 0 : _m_frames.back().node;
+		auto node = this->find_child(parent, symbol);
+		_m_frames.push_back({node, instructions, std::chrono::steady_clock::now()});
+	}
+
+	void DaedalusVmProfile::leave() {
+		auto frame = _m_frames.back();
+		_m_frames.pop_back();
+
+		auto inclusive_instructions = instructions - frame.instructions;
+		auto inclusive_time = std::chrono::steady_clock::now() - frame.start;
+
+		auto& node = nodes[frame.node];
+		if (functions.size() <= node.symbol) functions.resize(node.symbol + 1);
+
+		for (auto* stats : {&functions[node.symbol], &node.stats}) {
+			stats->calls += 1;
+			stats->inclusive_instructions += inclusive_instructions;
+			stats->exclusive_instructions += inclusive_instructions - frame.child_instructions;
+			stats->inclusive_time += inclusive_time;
+			stats->exclusive_time += inclusive_time - frame.child_time;
+		}
+
+		if (!_m_frames.empty()) {
+			_m_frames.back().child_instructions += inclusive_instructions;
+			_m_frames.back().child_time += inclusive_time;
+		}
+	}
+
+	void DaedalusVmProfile::save_folded(Write* w, DaedalusScript const& script, DaedalusProfileWeight weight) const {
+		std::string stack;
+		for (auto i = 1u; i < nodes.size(); ++i) {
+			auto const& stats = nodes[i].stats;
+			auto value = weight == DaedalusProfileWeight::INSTRUCTIONS
+			    ? stats.exclusive_instructions
+			    : static_cast<std::uint64_t>(
+			          std::chrono::duration_cast<std::chrono::microseconds>(stats.exclusive_time).count());
+			if (value == 0) continue;
+
+			// Nodes are only ever added after their parent, so walking up the tree ends at the root.
+			stack.clear();
+			for (auto n = i; n != 0; n = nodes[n].parent) {
+				auto const* sym = script.find_symbol_by_index(nodes[n].symbol);
+				auto name = sym != nullptr ? sym->name() : "$UNKNOWN";
+				stack.insert(0, stack.empty() ? name : name + ";");
+			}
+
+			w->write_line(stack + " " + std::to_string(value));
+		}
+	}
+
 	DaedalusVm::DaedalusVm(DaedalusScript&& scr, std::uint8_t flags) : DaedalusScript(std::move(scr)), _m_flags(flags) {
 		_m_temporary_strings = add_temporary_strings_symbol();
 		_m_self_sym = find_symbol_by_name("SELF");
@@ -82,6 +174,15 @@ namespace zenkit {
 		_m_victim_sym = find_symbol_by_name("VICTIM");
 		_m_hero_sym = find_symbol_by_name("HERO");
 		_m_item_sym = find_symbol_by_name("ITEM");
+
+		// No symbols are added after this point, so the pointers stay valid.
+		_m_symbol_table.resize(this->symbols().size());
+		for (auto i = 0u; i < _m_symbol_table.size(); ++i) {
+			_m_symbol_table[i] = find_symbol_by_index(i);
+		}
+
+		_m_externals.resize(_m_symbol_table.size());
+		_m_compiled.resize(_m_symbol_table.size(), nullptr);
 	}
 
 	std::shared_ptr<DaedalusInstance> DaedalusVm::init_opaque_instance(DaedalusSymbol* sym) {
@@ -96,369 +197,922 @@ namespace zenkit {
 		}
 
 		// create the instance
-		auto inst = std::make_shared<DaedalusOpaqueInstance>(*cls, find_class_members(*cls));
+		auto inst = std::make_shared<DaedalusOpaqueInstance>(*cls);
 		init_instance(inst, sym);
 		return inst;
 	}
 
+	static_assert(sizeof(DaedalusStackFrame) <= 16, "DaedalusStackFrame should fit into 16 bytes");
+
+	void DaedalusVm::call_initializer(DaedalusSymbol const* sym) {
+		auto* context = _m_instance.get();
+		// Profiles and trace hooks observe the instructions executed, so they require the code to be interpreted.
+		auto const* init = this->instrumented() ? nullptr : this->find_constant_initializer(*sym);
+		if (init == nullptr || context == nullptr) return unsafe_call(sym);
+
+		// The interpreter calls overridden prototypes and access traps and reports errors to the exception handler,
+		// so these cases are left to it.
+		for (auto proto : init->prototypes) {
+			if (_m_externals[proto]) return unsafe_call(sym);
+		}
+
+		for (auto const& assignment : init->assignments) {
+			auto const* member = this->find_symbol_by_index(assignment.member);
+			if (member->has_access_trap() || member->_m_registered_to == nullptr ||
+			    *member->_m_registered_to != *context->_m_type) {
+				return unsafe_call(sym);
+			}
+
+			auto const* source = this->find_symbol_by_index(assignment.source);
+			if (source != nullptr && source->has_access_trap()) return unsafe_call(sym);
+		}
+
+		for (auto const& assignment : init->assignments) {
+			auto* member = this->find_symbol_by_index(assignment.member);
+			auto const* source = this->find_symbol_by_index(assignment.source);
+
+			switch (assignment.op) {
+			case DaedalusOpcode::MOVF: {
+				float value;
+				if (source != nullptr) {
+					value = source->get_float(assignment.source_index);
+				} else {
+					std::memcpy(&value, &assignment.immediate, sizeof value);
+				}
+
+				member->set_float(value, assignment.member_index, context);
+				break;
+			}
+			case DaedalusOpcode::MOVS:
+				member->set_string(source->get_string(assignment.source_index), assignment.member_index, context);
+				break;
+			default: {
+				auto value = source != nullptr ? source->get_int(assignment.source_index) : assignment.immediate;
+				member->set_int(value, assignment.member_index, context);
+				break;
+			}
+			}
+		}
+	}
+
 	void DaedalusVm::unsafe_call(DaedalusSymbol const* sym) {
+		ProfileScope profiling {_m_profile.get(), sym->index()};
 		push_call(sym);
-		jump(sym->address());
 
-		// execute until an op_return is reached
-		while (exec())
-			;
+		if (auto compiled = _m_compiled[sym->index()]; compiled != nullptr) {
+			DepthScope scope {_m_compiled_depth};
+			try {
+				compiled(*this);
+			} catch (DaedalusScriptError& err) {
+				// Compiled code cannot be resumed in the middle, so the function returns even if the handler
+				// wants to continue.
+				(void) this->handle_exception(err);
+			}
+		} else {
+			jump(sym->address());
+
+			// execute until an op_return is reached
+			this->run();
+
+			// The call stack frame is kept until the function is resumed, see DaedalusVm::resume.
+			if (_m_suspended) return;
+		}
 
 		pop_call();
+
+		if (_m_call_stack_ptr == 0) {
+			this->unpin();
+			this->collect_strings();
+			_m_failed_error = nullptr;
+		}
+	}
+
+	bool DaedalusVm::unsafe_call_resumable(DaedalusSymbol const* sym) {
+		if (_m_resumable) {
+			throw DaedalusVmException {"Cannot call " + sym->name() + ": a resumable call is already active"};
+		}
+
+		push_call(sym);
+		jump(sym->address());
+
+		_m_resumable = true;
+		_m_resumable_base = _m_call_stack_ptr - 1;
+		return this->continue_resumable();
+	}
+
+	void DaedalusVm::suspend() {
+		if (!_m_resumable || _m_suspended || _m_external_depth != 1) {
+			throw DaedalusVmException {"suspend: not called from an external of a resumable call"};
+		}
+
+		if (_m_compiled_depth != 0) {
+			throw DaedalusVmException {"suspend: compiled functions cannot be suspended"};
+		}
+
+		if (_m_profile != nullptr) {
+			throw DaedalusVmException {"suspend: not supported while profiling"};
+		}
+
+		_m_suspended = true;
+	}
+
+	bool DaedalusVm::resume() {
+		if (!_m_suspended) {
+			throw DaedalusVmException {"resume: the VM is not suspended"};
+		}
+
+		_m_suspended = false;
+		return this->continue_resumable();
+	}
+
+	bool DaedalusVm::continue_resumable() {
+		try {
+			for (;;) {
+				this->run();
+				if (_m_suspended) return false;
+
+				pop_call();
+				if (_m_call_stack_ptr == _m_resumable_base) break;
+
+				// Functions above the one called initially were called by a BL instruction in the interpreter,
+				// which continues after it.
+				_m_pc += instruction_at(_m_pc).size;
+			}
+		} catch (...) {
+			_m_resumable = false;
+			_m_suspended = false;
+			throw;
+		}
+
+		_m_resumable = false;
+		if (_m_call_stack_ptr == 0) {
+			this->unpin();
+			this->collect_strings();
+		}
+
+		return true;
 	}
 
 	void DaedalusVm::unsafe_jump(uint32_t address) {
 		this->jump(address);
 	}
 
+	void DaedalusVm::unsafe_exec(std::uint32_t address) {
+		_m_pc = address;
+		(void) (this->instrumented() ? this->interpret<true, true>() : this->interpret<true, false>());
+	}
+
 	std::shared_ptr<DaedalusInstance> DaedalusVm::unsafe_get_gi() {
 		return _m_instance;
 	}
 
 	void DaedalusVm::unsafe_set_gi(std::shared_ptr<DaedalusInstance> i) {
+		// References on the stack might still use the old instance as their context.
+		this->pin(std::move(_m_instance));
 		_m_instance = std::move(i);
 	}
 
 	bool DaedalusVm::exec() {
+		try {
+			return this->instrumented() ? this->interpret<true, true>() : this->interpret<true, false>();
+		} catch (DaedalusScriptError& err) {
+			return this->handle_exception(err);
+		}
+	}
+
+	void DaedalusVm::run() {
+		// The exception handler is set up once for the whole function instead of for every instruction. After an
+		// exception has been handled, execution resumes at the program counter set by the handler.
+		for (;;) {
+			try {
+				(void) (this->instrumented() ? this->interpret<false, true>() : this->interpret<false, false>());
+				return;
+			} catch (DaedalusScriptError& err) {
+				if (!this->handle_exception(err)) return;
+			}
+		}
+	}
+
+	bool DaedalusVm::handle_exception(DaedalusScriptError& err) {
+		// Errors which already failed a nested call are passed on to the outermost caller as they are, so that they
+		// are only handled and reported once, instead of once for every function on the call stack.
+		auto current = std::current_exception();
+		if (current == _m_failed_error) throw;
+
 		auto instr = instruction_at(_m_pc);
+		uint32_t prev_pc = _m_pc;
 
-		try {
-			std::int32_t a, b;
-			DaedalusSymbol* sym;
+		auto strategy = DaedalusVmExceptionStrategy::FAIL;
+		if (_m_exception_handler) {
+			strategy = (*_m_exception_handler)(*this, err, instr);
+		}
 
-			switch (instr.op) {
-			case DaedalusOpcode::ADD:
-				push_int(pop_int() + pop_int());
-				break;
-			case DaedalusOpcode::SUB:
-				a = pop_int();
-				b = pop_int();
-				push_int(a - b);
-				break;
-			case DaedalusOpcode::MUL:
-				push_int(pop_int() * pop_int());
-				break;
-			case DaedalusOpcode::DIV:
-				a = pop_int();
-				b = pop_int();
+		if (strategy == DaedalusVmExceptionStrategy::FAIL) {
+			_m_failed_error = std::move(current);
+			ZKLOGE("DaedalusVm", "+++ Error while executing script: %s +++", err.what());
+			print_stack_trace();
+			throw;
+		}
 
-				if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+		if (strategy == DaedalusVmExceptionStrategy::RETURN) {
+			return false;
+		}
 
-				push_int(a / b);
-				break;
-			case DaedalusOpcode::MOD:
-				a = pop_int();
-				b = pop_int();
+		if (_m_pc == prev_pc) {
+			_m_pc += instr.size;
+		}
 
-				if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+		return true;
+	}
 
-				push_int(a % b);
-				break;
-			case DaedalusOpcode::OR:
-				push_int(pop_int() | pop_int());
-				break;
-			case DaedalusOpcode::ANDB:
-				push_int(pop_int() & pop_int());
-				break;
-			case DaedalusOpcode::LT:
-				a = pop_int();
-				b = pop_int();
-				push_int(a < b);
-				break;
-			case DaedalusOpcode::GT:
-				a = pop_int();
-				b = pop_int();
-				push_int(a > b);
-				break;
-			case DaedalusOpcode::LSL:
-				a = pop_int();
-				b = pop_int();
-				push_int(a << b);
-				break;
-			case DaedalusOpcode::LSR:
-				a = pop_int();
-				b = pop_int();
-				push_int(a >> b);
-				break;
-			case DaedalusOpcode::LTE:
-				a = pop_int();
-				b = pop_int();
-				push_int(a <= b);
-				break;
-			case DaedalusOpcode::EQ:
-				push_int(pop_int() == pop_int());
-				break;
-			case DaedalusOpcode::NEQ:
-				push_int(pop_int() != pop_int());
-				break;
-			case DaedalusOpcode::GTE:
-				a = pop_int();
-				b = pop_int();
-				push_int(a >= b);
-				break;
-			case DaedalusOpcode::PLUS:
-				push_int(+pop_int());
-				break;
-			case DaedalusOpcode::NEGATE:
-				push_int(-pop_int());
-				break;
-			case DaedalusOpcode::NOT:
-				push_int(!pop_int());
-				break;
-			case DaedalusOpcode::CMPL:
-				push_int(~pop_int());
-				break;
-			case DaedalusOpcode::ORR:
-				a = pop_int();
-				b = pop_int();
-				push_int(a || b);
-				break;
-			case DaedalusOpcode::AND:
-				a = pop_int();
-				b = pop_int();
-				push_int(a && b);
-				break;
-			case DaedalusOpcode::NOP:
-				// Do nothing
-				break;
-			case DaedalusOpcode::RSR:
-				return false;
-			case DaedalusOpcode::BL: {
-				// Check if the function is overridden and if it is, call the resulting external.
-				sym = find_symbol_by_address(instr.address);
-				if (auto cb = _m_function_overrides.find(instr.address); cb != _m_function_overrides.end()) {
-					// Guard against exceptions during external invocation.
-					StackGuard guard {this, sym->rtype()};
-					// Call maybe naked.
-					cb->second(*this);
-					// The stack is left intact.
-					guard.inhibit();
-				} else {
-					if (sym == nullptr) {
-						throw DaedalusVmException {"bl: no symbol found for address " + std::to_string(instr.address)};
-					}
+	/// \return The result of the binary operator \p op applied to `a` and `b` as popped off the stack.
+	static std::int32_t compute_binary(DaedalusOpcode op, std::int32_t a, std::int32_t b) {
+		switch (op) {
+		case DaedalusOpcode::ADD:
+			return a + b;
+		case DaedalusOpcode::SUB:
+			return a - b;
+		case DaedalusOpcode::MUL:
+			return a * b;
+		case DaedalusOpcode::DIV:
+			if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+			return a / b;
+		case DaedalusOpcode::MOD:
+			if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+			return a % b;
+		case DaedalusOpcode::OR:
+			return a | b;
+		case DaedalusOpcode::ANDB:
+			return a & b;
+		case DaedalusOpcode::LT:
+			return a < b;
+		case DaedalusOpcode::GT:
+			return a > b;
+		case DaedalusOpcode::LSL:
+			return a << b;
+		case DaedalusOpcode::LSR:
+			return a >> b;
+		case DaedalusOpcode::LTE:
+			return a <= b;
+		case DaedalusOpcode::EQ:
+			return a == b;
+		case DaedalusOpcode::NEQ:
+			return a != b;
+		case DaedalusOpcode::GTE:
+			return a >= b;
+		case DaedalusOpcode::ORR:
+			return a || b;
+		case DaedalusOpcode::AND:
+			return a && b;
+		default:
+			return 0;
+		}
+	}
 
-					unsafe_call(sym);
-				}
+	/// \return The value assigned to an integer with the value \p x by the assignment \p op of the value \p b.
+	static std::int32_t compute_assignment(DaedalusOpcode op, std::int32_t x, std::int32_t b) {
+		switch (op) {
+		case DaedalusOpcode::ADDMOVI:
+			return x + b;
+		case DaedalusOpcode::SUBMOVI:
+			return x - b;
+		case DaedalusOpcode::MULMOVI:
+			return x * b;
+		case DaedalusOpcode::DIVMOVI:
+			if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+			return x / b;
+		default:
+			return b;
+		}
+	}
 
-				break;
-			}
-			case DaedalusOpcode::BE: {
-				sym = find_symbol_by_index(instr.symbol);
-				if (sym == nullptr) {
-					throw DaedalusVmException {"be: no external found for index"};
-				}
+// All opcodes implemented by the interpreter. Opcodes not listed here are treated like NOP.
+#define ZK_VM_OPCODES(X) \
+	X(ADD) \
+	X(SUB) \
+	X(MUL) \
+	X(DIV) \
+	X(MOD) \
+	X(OR) \
+	X(ANDB) \
+	X(LT) \
+	X(GT) \
+	X(LSL) \
+	X(LSR) \
+	X(LTE) \
+	X(EQ) \
+	X(NEQ) \
+	X(GTE) \
+	X(PLUS) \
+	X(NEGATE) \
+	X(NOT) \
+	X(CMPL) \
+	X(ORR) \
+	X(AND) \
+	X(NOP) \
+	X(RSR) \
+	X(BL) \
+	X(BE) \
+	X(PUSHI) \
+	X(PUSHVI) \
+	X(PUSHV) \
+	X(MOVI) \
+	X(MOVVF) \
+	X(MOVF) \
+	X(MOVS) \
+	X(MOVSS) \
+	X(ADDMOVI) \
+	X(SUBMOVI) \
+	X(MULMOVI) \
+	X(DIVMOVI) \
+	X(MOVVI) \
+	X(B) \
+	X(BZ) \
+	X(GMOVI) \
+	X(PUSHVV)
+
+	/// \brief Maps every opcode to its position in ZK_VM_OPCODES plus one. Unknown opcodes map to 0.
+	static constexpr std::array<std::uint8_t, 256> VM_OPCODE_SLOTS = [] {
+		std::array<std::uint8_t, 256> slots {};
+		std::uint8_t slot = 1;
+#define X(op) slots[static_cast<std::uint8_t>(DaedalusOpcode::op)] = slot++;
+		ZK_VM_OPCODES(X)
+#undef X
+		return slots;
+	}();
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(ZK_VM_NO_COMPUTED_GOTO)
+	#define ZK_VM_COMPUTED_GOTO 1
+	#define ZK_VM_CASE(op) vm_##op:
+	#define ZK_VM_DISPATCH() goto* labels[VM_OPCODE_SLOTS[static_cast<std::uint8_t>(instr->op)]]
+
+	// Labels as values are a GNU extension.
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wpedantic"
+	#ifdef __clang__
+		#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+	#endif
+#else
+	#define ZK_VM_CASE(op) case DaedalusOpcode::op:
+	#define ZK_VM_DISPATCH() goto vm_dispatch
+#endif
+
+// Counts the instruction about to be executed in the profile and passes it to the trace hook.
+#define ZK_VM_INSTRUMENT()                                                                                             \
+	do {                                                                                                               \
+		if constexpr (INSTRUMENTED) {                                                                                  \
+			if (_m_profile != nullptr) ++_m_profile->instructions;                                                     \
+			if (_m_trace_hook) _m_trace_hook(*this, *instr);                                                           \
+		}                                                                                                              \
+	} while (false)
+
+// Advances to the next instruction. Instructions are stored in the order of their addresses, so the next one
+// directly follows the current one.
+#define ZK_VM_NEXT()                                                                                                   \
+	do {                                                                                                               \
+		_m_pc += instr->size;                                                                                          \
+		if (STEP) return true;                                                                                         \
+		if (++ip >= count) goto vm_fetch;                                                                              \
+		instr = &code[ip];                                                                                             \
+		ZK_VM_INSTRUMENT();                                                                                            \
+		ZK_VM_DISPATCH();                                                                                              \
+	} while (false)
+
+// Advances past an instruction which may have called back into user code and looks the next one up by address.
+// The user code may have suspended the VM, in which case the interpreter returns right away.
+#define ZK_VM_SYNC()                                                                                                   \
+	do {                                                                                                               \
+		_m_pc += instr->size;                                                                                          \
+		if (STEP || _m_suspended) return true;                                                                         \
+		goto vm_fetch;                                                                                                 \
+	} while (false)
+
+// Moves to the next instruction of a fused sequence without executing it on its own.
+#define ZK_VM_SKIP()                                                                                                   \
+	do {                                                                                                               \
+		_m_pc += instr->size;                                                                                          \
+		instr = &code[++ip];                                                                                           \
+	} while (false)
+
+// Continues at the current program counter after a jump.
+#define ZK_VM_FETCH()                                                                                                  \
+	do {                                                                                                               \
+		if (STEP) return true;                                                                                         \
+		goto vm_fetch;                                                                                                 \
+	} while (false)
+
+	template <bool STEP, bool INSTRUMENTED>
+	bool DaedalusVm::interpret() {
+#ifdef ZK_VM_COMPUTED_GOTO
+	#define X(op) &&vm_##op,
+		static void* const labels[] = {&&vm_unknown, ZK_VM_OPCODES(X)};
+	#undef X
+#endif
+
+		auto const& code = this->instructions();
+		auto const& fusions = this->fusions();
+		auto const count = static_cast<std::uint32_t>(code.size());
+
+		DaedalusInstruction fallback {};
+		DaedalusInstruction const* instr;
+		std::uint32_t ip;
+		std::int32_t a, b;
+		DaedalusSymbol* sym;
+		detail::DaedalusFusion fusion;
+
+		// Reads an operand of a fused sequence. Only integer variables which are not members are fused, so their
+		// value is always present, see detail::DaedalusFusion.
+		auto operand = [this](DaedalusInstruction const& in) {
+			if (in.op == DaedalusOpcode::PUSHI) return in.immediate;
+
+			auto const& value = find_symbol_by_index(in.symbol)->_m_value;
+			return std::get<std::unique_ptr<std::int32_t[]>>(value)[in.op == DaedalusOpcode::PUSHVV ? in.index : 0];
+		};
+
+	vm_fetch:
+		ip = this->instruction_index(_m_pc);
+		if (ip == static_cast<std::uint32_t>(-1)) {
+			// Not the start of a decoded instruction. Decode whatever is there and look up the one after it later.
+			fallback = this->instruction_at(_m_pc);
+			instr = &fallback;
+			ip = count;
+		} else {
+			instr = &code[ip];
+		}
+
+		ZK_VM_INSTRUMENT();
+
+#ifdef ZK_VM_COMPUTED_GOTO
+		ZK_VM_DISPATCH();
+#else
+	vm_dispatch:
+		switch (instr->op) {
+		default:
+			ZK_VM_NEXT();
+#endif
+
+		ZK_VM_CASE(ADD) {
+			push_int(pop_int() + pop_int());
+			ZK_VM_NEXT();
+		}
 
+		ZK_VM_CASE(SUB) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a - b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MUL) {
+			push_int(pop_int() * pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(DIV) {
+			a = pop_int();
+			b = pop_int();
+
+			if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+
+			push_int(a / b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MOD) {
+			a = pop_int();
+			b = pop_int();
+
+			if (b == 0) throw DaedalusVmException {"vm: division by zero"};
+
+			push_int(a % b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(OR) {
+			push_int(pop_int() | pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(ANDB) {
+			push_int(pop_int() & pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(LT) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a < b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(GT) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a > b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(LSL) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a << b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(LSR) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a >> b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(LTE) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a <= b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(EQ) {
+			push_int(pop_int() == pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(NEQ) {
+			push_int(pop_int() != pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(GTE) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a >= b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(PLUS) {
+			push_int(+pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(NEGATE) {
+			push_int(-pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(NOT) {
+			push_int(!pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(CMPL) {
+			push_int(~pop_int());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(ORR) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a || b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(AND) {
+			a = pop_int();
+			b = pop_int();
+			push_int(a && b);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(NOP) {
+			// Do nothing
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(RSR) {
+			return false;
+		}
+
+		ZK_VM_CASE(BL) {
+			// Check if the function is overridden and if it is, call the resulting external.
+			sym = find_symbol_by_address(instr->address);
+			if (sym != nullptr && !sym->is_external() && _m_externals[sym->index()]) {
 				// Guard against exceptions during external invocation.
 				StackGuard guard {this, sym->rtype()};
+				DepthScope scope {_m_external_depth};
+				ProfileScope profiling {_m_profile.get(), sym->index()};
+				// Call maybe naked.
+				_m_externals[sym->index()](*this);
+				// The stack is left intact.
+				guard.inhibit();
+			} else {
+				if (sym == nullptr) {
+					throw DaedalusVmException {"bl: no symbol found for address " + std::to_string(instr->address)};
+				}
 
-				auto cb = _m_externals.find(sym);
-				if (cb == _m_externals.end()) {
-					if (_m_default_external.has_value()) {
-						(*_m_default_external)(*this, *sym);
-						guard.inhibit();
-						break;
-					}
+				unsafe_call(sym);
+
+				// The program counter is inside the suspended function, so it must not be advanced.
+				if (_m_suspended) return true;
+			}
 
-					throw DaedalusVmException {"be: no external registered for " + sym->name()};
+			ZK_VM_SYNC();
+		}
+
+		ZK_VM_CASE(BE) {
+			sym = find_symbol_by_index(instr->symbol);
+			if (sym == nullptr) {
+				throw DaedalusVmException {"be: no external found for index"};
+			}
+
+			// Guard against exceptions during external invocation.
+			StackGuard guard {this, sym->rtype()};
+
+			auto const& cb = _m_externals[sym->index()];
+			if (!cb) {
+				if (_m_default_external.has_value()) {
+					DepthScope scope {_m_external_depth};
+					ProfileScope profiling {_m_profile.get(), sym->index()};
+					(*_m_default_external)(*this, *sym);
+					guard.inhibit();
+					ZK_VM_SYNC();
 				}
 
+				throw DaedalusVmException {"be: no external registered for " + sym->name()};
+			}
+
+			{
+				DepthScope scope {_m_external_depth};
+				ProfileScope profiling {_m_profile.get(), sym->index()};
 				push_call(sym);
-				cb->second(*this);
+				cb(*this);
 				pop_call();
 
-				// The stack is left intact.
-				guard.inhibit();
-				break;
+				// The return value of a suspending external is pushed before resuming instead.
+				if (_m_suspended && sym->has_return()) --_m_stack_ptr;
 			}
-			case DaedalusOpcode::PUSHI:
-				push_int(instr.immediate);
-				break;
-			case DaedalusOpcode::PUSHVI:
-			case DaedalusOpcode::PUSHV:
-				sym = find_symbol_by_index(instr.symbol);
-				if (sym == nullptr) {
-					throw DaedalusVmException {"pushv: no symbol found for index"};
-				}
+
+			// Scripts calling string externals in a loop would otherwise grow the pool until they return.
+			if (_m_strings_used > stack_size && _m_external_depth == 0) this->collect_strings();
+
+			// The stack is left intact.
+			guard.inhibit();
+			ZK_VM_SYNC();
+		}
+
+		ZK_VM_CASE(PUSHI) {
+			if (!STEP && !INSTRUMENTED && fusions[ip] != detail::DaedalusFusion::NONE) goto vm_fused;
+			push_int(instr->immediate);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(PUSHVI) ZK_VM_CASE(PUSHV) {
+			if (!STEP && !INSTRUMENTED && fusions[ip] != detail::DaedalusFusion::NONE) goto vm_fused;
+
+			sym = find_symbol_by_index(instr->symbol);
+			if (sym == nullptr) {
+				throw DaedalusVmException {"pushv: no symbol found for index"};
+			}
+
+			if constexpr (INSTRUMENTED) {
 				if (sym->has_access_trap() && _m_access_trap) {
 					_m_access_trap(*sym);
-				} else {
-					push_reference(sym, 0);
+					ZK_VM_SYNC();
 				}
-				break;
-			case DaedalusOpcode::MOVI:
-			case DaedalusOpcode::MOVVF: {
-				auto [ref, idx, context] = pop_reference();
-				auto value = pop_int();
-
-				this->set_int(context, ref, idx, value);
-				break;
 			}
-			case DaedalusOpcode::MOVF: {
-				auto [ref, idx, context] = pop_reference();
-				auto value = pop_float();
 
-				this->set_float(context, ref, idx, value);
-				break;
+			push_reference(sym, 0);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MOVI) ZK_VM_CASE(MOVVF) {
+			auto [ref, idx, context] = pop_raw_reference();
+			auto value = pop_int();
+
+			this->write_int(context, ref, idx, value);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MOVF) {
+			auto [ref, idx, context] = pop_raw_reference();
+			auto value = pop_float();
+
+			this->write_float(context, ref, idx, value);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MOVS) {
+			auto [target, target_idx, context] = pop_raw_reference();
+			auto source = pop_string();
+
+			this->write_string(context, target, target_idx, source);
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MOVSS) {
+			throw DaedalusVmException {"not implemented: movss"};
+		}
+
+		ZK_VM_CASE(ADDMOVI) {
+			auto [ref, idx, context] = pop_raw_reference();
+			auto value = pop_int();
+
+			if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
+				throw DaedalusIllegalConstAccess(ref);
 			}
-			case DaedalusOpcode::MOVS: {
-				auto [target, target_idx, context] = pop_reference();
-				auto source = pop_string();
 
-				this->set_string(context, target, target_idx, source);
-				break;
+			if (!ref->is_member() || context != nullptr ||
+			    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
+				auto result = ref->get_int(idx, context) + value;
+				ref->set_int(result, idx, context);
+			} else if (ref->is_member()) {
+				ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 			}
-			case DaedalusOpcode::MOVSS:
-				throw DaedalusVmException {"not implemented: movss"};
-			case DaedalusOpcode::ADDMOVI: {
-				auto [ref, idx, context] = pop_reference();
-				auto value = pop_int();
 
-				if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
-					throw DaedalusIllegalConstAccess(ref);
-				}
+			ZK_VM_NEXT();
+		}
 
-				if (!ref->is_member() || context != nullptr ||
-				    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-					auto result = ref->get_int(idx, context.get()) + value;
-					ref->set_int(result, idx, context.get());
-				} else if (ref->is_member()) {
-					ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
-				}
+		ZK_VM_CASE(SUBMOVI) {
+			auto [ref, idx, context] = pop_raw_reference();
+			auto value = pop_int();
 
-				break;
+			if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
+				throw DaedalusIllegalConstAccess(ref);
 			}
-			case DaedalusOpcode::SUBMOVI: {
-				auto [ref, idx, context] = pop_reference();
-				auto value = pop_int();
 
-				if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
-					throw DaedalusIllegalConstAccess(ref);
-				}
-
-				if (!ref->is_member() || context != nullptr ||
-				    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-					auto result = ref->get_int(idx, context.get()) - value;
-					ref->set_int(result, idx, context.get());
-				} else if (ref->is_member()) {
-					ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
-				}
-				break;
+			if (!ref->is_member() || context != nullptr ||
+			    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
+				auto result = ref->get_int(idx, context) - value;
+				ref->set_int(result, idx, context);
+			} else if (ref->is_member()) {
+				ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 			}
-			case DaedalusOpcode::MULMOVI: {
-				auto [ref, idx, context] = pop_reference();
-				auto value = pop_int();
+			ZK_VM_NEXT();
+		}
 
-				if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
-					throw DaedalusIllegalConstAccess(ref);
-				}
+		ZK_VM_CASE(MULMOVI) {
+			auto [ref, idx, context] = pop_raw_reference();
+			auto value = pop_int();
 
-				if (!ref->is_member() || context != nullptr ||
-				    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-					auto result = ref->get_int(idx, context.get()) * value;
-					ref->set_int(result, idx, context.get());
-				} else if (ref->is_member()) {
-					ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
-				}
+			if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
+				throw DaedalusIllegalConstAccess(ref);
+			}
 
-				break;
+			if (!ref->is_member() || context != nullptr ||
+			    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
+				auto result = ref->get_int(idx, context) * value;
+				ref->set_int(result, idx, context);
+			} else if (ref->is_member()) {
+				ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 			}
-			case DaedalusOpcode::DIVMOVI: {
-				auto [ref, idx, context] = pop_reference();
-				auto value = pop_int();
 
-				if (value == 0) {
-					throw DaedalusVmException {"vm: division by zero"};
-				}
+			ZK_VM_NEXT();
+		}
 
-				if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
-					throw DaedalusIllegalConstAccess(ref);
-				}
+		ZK_VM_CASE(DIVMOVI) {
+			auto [ref, idx, context] = pop_raw_reference();
+			auto value = pop_int();
 
-				if (!ref->is_member() || context != nullptr ||
-				    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-					auto result = ref->get_int(idx, context.get()) / value;
-					ref->set_int(result, idx, context.get());
-				} else if (ref->is_member()) {
-					ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
-				}
+			if (value == 0) {
+				throw DaedalusVmException {"vm: division by zero"};
+			}
 
-				break;
+			if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
+				throw DaedalusIllegalConstAccess(ref);
 			}
-			case DaedalusOpcode::MOVVI: {
-				auto [target, target_idx, _] = pop_reference();
-				target->set_instance(pop_instance());
-				break;
+
+			if (!ref->is_member() || context != nullptr ||
+			    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
+				auto result = ref->get_int(idx, context) / value;
+				ref->set_int(result, idx, context);
+			} else if (ref->is_member()) {
+				ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 			}
-			case DaedalusOpcode::B:
-				jump(instr.address);
-				return true;
-			case DaedalusOpcode::BZ:
-				if (pop_int() == 0) {
-					jump(instr.address);
-					return true;
-				}
-				break;
-			case DaedalusOpcode::GMOVI: {
-				sym = find_symbol_by_index(instr.symbol);
-				if (sym == nullptr) {
-					throw DaedalusVmException {"gmovi: no symbol found for index"};
-				}
-				_m_instance = sym->get_instance();
-				break;
+
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(MOVVI) {
+			auto [target, target_idx, _] = pop_raw_reference();
+			target->set_instance(pop_instance());
+			ZK_VM_NEXT();
+		}
+
+		ZK_VM_CASE(B) {
+			jump(instr->address);
+			ZK_VM_FETCH();
+		}
+
+		ZK_VM_CASE(BZ) {
+			if (pop_int() == 0) {
+				jump(instr->address);
+				ZK_VM_FETCH();
 			}
-			case DaedalusOpcode::PUSHVV:
-				sym = find_symbol_by_index(instr.symbol);
-				if (sym == nullptr) {
-					throw DaedalusVmException {"pushvv: no symbol found for index"};
-				}
+			ZK_VM_NEXT();
+		}
 
-				push_reference(sym, instr.index);
-				break;
+		ZK_VM_CASE(GMOVI) {
+			sym = find_symbol_by_index(instr->symbol);
+			if (sym == nullptr) {
+				throw DaedalusVmException {"gmovi: no symbol found for index"};
 			}
+			this->unsafe_set_gi(sym->get_instance());
+			ZK_VM_NEXT();
+		}
 
-			_m_pc += instr.size;
-		} catch (DaedalusScriptError& err) {
-			uint32_t prev_pc = _m_pc;
+		ZK_VM_CASE(PUSHVV) {
+			if (!STEP && !INSTRUMENTED && fusions[ip] != detail::DaedalusFusion::NONE) goto vm_fused;
 
-			if (_m_exception_handler) {
-				auto strategy = (*_m_exception_handler)(*this, err, instr);
+			sym = find_symbol_by_index(instr->symbol);
+			if (sym == nullptr) {
+				throw DaedalusVmException {"pushvv: no symbol found for index"};
+			}
 
-				if (strategy == DaedalusVmExceptionStrategy::FAIL) {
-					ZKLOGE("DaedalusVm", "+++ Error while executing script: %s +++", err.what());
-					print_stack_trace();
-					throw;
-				}
+			push_reference(sym, instr->index);
+			ZK_VM_NEXT();
+		}
 
-				if (strategy == DaedalusVmExceptionStrategy::RETURN) {
-					return false;
-				}
-			} else {
-				ZKLOGE("DaedalusVm", "+++ Error while executing script: %s +++", err.what());
-				print_stack_trace();
-				throw;
-			}
+	vm_fused:
+		// Executes a sequence of integer instructions without pushing their operands. Only the last instruction
+		// can fail, and it is only executed once the program counter points to it.
+		fusion = fusions[ip];
+		if (fusion == detail::DaedalusFusion::STORE) {
+			sym = find_symbol_by_index(instr->symbol);
+			auto& x = std::get<std::unique_ptr<std::int32_t[]>>(sym->_m_value)[instr->index];
+			ZK_VM_SKIP();
+
+			x = compute_assignment(instr->op, x, pop_int());
+			ZK_VM_NEXT();
+		}
+
+		if (fusion == detail::DaedalusFusion::ASSIGN) {
+			b = operand(*instr);
+			ZK_VM_SKIP();
+
+			sym = find_symbol_by_index(instr->symbol);
+			auto& x = std::get<std::unique_ptr<std::int32_t[]>>(sym->_m_value)[instr->index];
+			ZK_VM_SKIP();
 
-			if (_m_pc == prev_pc) {
-				_m_pc += instr.size;
+			x = compute_assignment(instr->op, x, b);
+			ZK_VM_NEXT();
+		}
+
+		if (fusion == detail::DaedalusFusion::BINARY || fusion == detail::DaedalusFusion::BINARY_BZ) {
+			a = operand(*instr);
+			ZK_VM_SKIP();
+			b = pop_int();
+		} else {
+			b = operand(*instr);
+			ZK_VM_SKIP();
+			a = operand(*instr);
+			ZK_VM_SKIP();
+		}
+
+		a = compute_binary(instr->op, a, b);
+		if (fusion == detail::DaedalusFusion::BINARY_BZ || fusion == detail::DaedalusFusion::BINARY2_BZ) {
+			ZK_VM_SKIP();
+			if (a == 0) {
+				jump(instr->address);
+				ZK_VM_FETCH();
 			}
+			ZK_VM_NEXT();
 		}
 
-		return true;
+		push_int(a);
+		ZK_VM_NEXT();
+
+#ifdef ZK_VM_COMPUTED_GOTO
+	vm_unknown:
+		ZK_VM_NEXT();
+#else
+		}
+#endif
 	}
 
+#ifdef ZK_VM_COMPUTED_GOTO
+	#pragma GCC diagnostic pop
+	#undef ZK_VM_COMPUTED_GOTO
+#endif
+#undef ZK_VM_CASE
+#undef ZK_VM_DISPATCH
+#undef ZK_VM_NEXT
+#undef ZK_VM_SYNC
+#undef ZK_VM_FETCH
+#undef ZK_VM_SKIP
+#undef ZK_VM_INSTRUMENT
+#undef ZK_VM_OPCODES
+
 	void DaedalusVm::push_call(DaedalusSymbol const* sym) {
-		auto var_count = this->find_parameters_for_function(sym).size();
-		_m_call_stack.push({sym, _m_pc, _m_stack_ptr - static_cast<uint32_t>(var_count), _m_instance});
+		if (_m_call_stack_ptr == call_stack_size) {
+			throw DaedalusVmException {"call stack overflow"};
+		}
+
+		auto var_count = this->find_parameters(sym).size();
+		_m_call_stack[_m_call_stack_ptr++] = {sym, _m_pc, _m_stack_ptr - static_cast<uint32_t>(var_count), _m_instance};
 	}
 
 	void DaedalusVm::pop_call() {
-		auto const& call = _m_call_stack.top();
+		auto& call = _m_call_stack[_m_call_stack_ptr - 1];
 
 		// First, try to fix up the stack.
 		if (!call.function->has_return()) {
@@ -476,19 +1130,22 @@ namespace zenkit {
 				// since that one is supposed to be the return value of the function.
 				DaedalusStackFrame frame = _m_stack[--_m_stack_ptr];
 				_m_stack_ptr = call.stack_ptr;
-				_m_stack[_m_stack_ptr++] = std::move(frame);
+				_m_stack[_m_stack_ptr++] = frame;
 			}
 			// else {
 			//     We have exactly one value to be returned (as indicated by the symbol's return type).
 			//     That means, that the compiler did not mess up the stack management, so we can just
 			//     return that value.
 			// }
+
+			// The return value might be a reference into the instance of the returning function.
+			if (_m_instance != call.context) this->pin(_m_instance);
 		}
 
 		// Second, reset PC and context, then remove the call stack frame
 		_m_pc = call.program_counter;
-		_m_instance = call.context;
-		_m_call_stack.pop();
+		_m_instance = std::move(call.context);
+		_m_call_stack_ptr--;
 	}
 
 	void DaedalusVm::push_int(std::int32_t value) {
@@ -496,7 +1153,9 @@ namespace zenkit {
 			throw DaedalusVmException {"stack overflow"};
 		}
 
-		_m_stack[_m_stack_ptr++] = {nullptr, false, value};
+		auto& frame = _m_stack[_m_stack_ptr++];
+		frame.type = DaedalusStackFrameType::INT;
+		frame.i = value;
 	}
 
 	void DaedalusVm::push_reference(DaedalusSymbol* value, std::uint8_t index) {
@@ -504,12 +1163,27 @@ namespace zenkit {
 			throw DaedalusVmException {"stack overflow"};
 		}
 
-		_m_stack[_m_stack_ptr++] = {_m_instance, true, value, index};
+		// The current instance is kept alive by the call stack or pinned when it is replaced.
+		auto& frame = _m_stack[_m_stack_ptr++];
+		frame.type = DaedalusStackFrameType::REFERENCE;
+		frame.instance = _m_instance.get();
+		frame.symbol = value->index();
+		frame.index = index;
 	}
 
 	void DaedalusVm::push_string(std::string_view value) {
-		_m_temporary_strings->set_string(value);
-		push_reference(_m_temporary_strings);
+		if (_m_stack_ptr == stack_size) {
+			throw DaedalusVmException {"stack overflow"};
+		}
+
+		// Pooled strings are reused once collected, so this only allocates if the string outgrows its slot.
+		if (_m_strings_used == _m_strings.size()) _m_strings.emplace_back();
+		_m_strings[_m_strings_used].assign(value.data(), value.size());
+
+		auto& frame = _m_stack[_m_stack_ptr++];
+		frame.type = DaedalusStackFrameType::STRING;
+		frame.instance = nullptr;
+		frame.symbol = _m_strings_used++;
 	}
 
 	void DaedalusVm::push_float(float value) {
@@ -517,7 +1191,9 @@ namespace zenkit {
 			throw DaedalusVmException {"stack overflow"};
 		}
 
-		_m_stack[_m_stack_ptr++] = {nullptr, false, value};
+		auto& frame = _m_stack[_m_stack_ptr++];
+		frame.type = DaedalusStackFrameType::FLOAT;
+		frame.f = value;
 	}
 
 	void DaedalusVm::push_instance(std::shared_ptr<DaedalusInstance> value) {
@@ -525,7 +1201,10 @@ namespace zenkit {
 			throw DaedalusVmException {"stack overflow"};
 		}
 
-		_m_stack[_m_stack_ptr++] = {nullptr, false, value};
+		auto& frame = _m_stack[_m_stack_ptr++];
+		frame.type = DaedalusStackFrameType::INSTANCE;
+		frame.instance = value.get();
+		this->pin(std::move(value));
 	}
 
 	std::int32_t DaedalusVm::pop_int() {
@@ -533,14 +1212,14 @@ namespace zenkit {
 			return 0;
 		}
 
-		DaedalusStackFrame v = std::move(_m_stack[--_m_stack_ptr]);
+		auto const& v = _m_stack[--_m_stack_ptr];
 
-		if (v.reference) {
-			return this->get_int(v.context, v.value, v.index);
+		if (v.type == DaedalusStackFrameType::REFERENCE) {
+			return this->read_int(v.instance, find_symbol_by_index(v.symbol), v.index);
 		}
 
-		if (std::holds_alternative<int32_t>(v.value)) {
-			return std::get<int32_t>(v.value);
+		if (v.type == DaedalusStackFrameType::INT) {
+			return v.i;
 		}
 
 		throw DaedalusVmException {"tried to pop_int but frame does not contain a int."};
@@ -551,40 +1230,48 @@ namespace zenkit {
 			return 0.0f;
 		}
 
-		DaedalusStackFrame v = std::move(_m_stack[--_m_stack_ptr]);
+		auto const& v = _m_stack[--_m_stack_ptr];
 
-		if (v.reference) {
-			return this->get_float(v.context, v.value, v.index);
+		if (v.type == DaedalusStackFrameType::REFERENCE) {
+			return this->read_float(v.instance, find_symbol_by_index(v.symbol), v.index);
 		}
 
-		if (std::holds_alternative<float>(v.value)) {
-			return std::get<float>(v.value);
+		if (v.type == DaedalusStackFrameType::FLOAT) {
+			return v.f;
 		}
 
-		if (std::holds_alternative<std::int32_t>(v.value)) {
-			auto k = std::get<std::int32_t>(v.value);
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wstrict-aliasing"
-			return *reinterpret_cast<float*>(&k);
-#pragma GCC diagnostic pop
+		if (v.type == DaedalusStackFrameType::INT) {
+			float k;
+			std::memcpy(&k, &v.i, sizeof k);
+			return k;
 		}
 
 		throw DaedalusVmException {"tried to pop_float but frame does not contain a float."};
 	}
 
-	std::tuple<DaedalusSymbol*, std::uint8_t, std::shared_ptr<DaedalusInstance>> DaedalusVm::pop_reference() {
+	std::tuple<DaedalusSymbol*, std::uint16_t, DaedalusInstance*> DaedalusVm::pop_raw_reference() {
 		if (_m_stack_ptr == 0) {
 			throw DaedalusVmException {"popping reference from empty stack"};
 		}
 
-		DaedalusStackFrame v = std::move(_m_stack[--_m_stack_ptr]);
+		auto const& v = _m_stack[--_m_stack_ptr];
 
-		if (!v.reference) {
+		// compatibility: pushed strings used to be references to the temporary strings symbol
+		if (v.type == DaedalusStackFrameType::STRING) {
+			_m_temporary_strings->set_string(_m_strings[v.symbol]);
+			return {_m_temporary_strings, 0, nullptr};
+		}
+
+		if (v.type != DaedalusStackFrameType::REFERENCE) {
 			throw DaedalusVmException {"tried to pop_reference but frame does not contain a reference."};
 		}
 
-		return {std::get<DaedalusSymbol*>(v.value), v.index, v.context};
+		return {find_symbol_by_index(v.symbol), v.index, v.instance};
+	}
+
+	std::tuple<DaedalusSymbol*, std::uint8_t, std::shared_ptr<DaedalusInstance>> DaedalusVm::pop_reference() {
+		auto [sym, index, context] = this->pop_raw_reference();
+		return {sym, static_cast<std::uint8_t>(index), this->find_pinned(context)};
 	}
 
 	std::shared_ptr<DaedalusInstance> DaedalusVm::pop_instance() {
@@ -592,14 +1279,14 @@ namespace zenkit {
 			throw DaedalusVmException {"popping instance from empty stack"};
 		}
 
-		DaedalusStackFrame v = std::move(_m_stack[--_m_stack_ptr]);
+		auto const& v = _m_stack[--_m_stack_ptr];
 
-		if (v.reference) {
-			return std::get<DaedalusSymbol*>(v.value)->get_instance();
+		if (v.type == DaedalusStackFrameType::REFERENCE) {
+			return find_symbol_by_index(v.symbol)->get_instance();
 		}
 
-		if (std::holds_alternative<std::shared_ptr<DaedalusInstance>>(v.value)) {
-			return std::get<std::shared_ptr<DaedalusInstance>>(v.value);
+		if (v.type == DaedalusStackFrameType::INSTANCE) {
+			return this->find_pinned(v.instance);
 		}
 
 		throw DaedalusVmException {"tried to pop_instance but frame does not contain am instance."};
@@ -607,7 +1294,12 @@ namespace zenkit {
 
 	std::string const& DaedalusVm::pop_string() {
 		static std::string empty {};
-		auto [s, i, context] = pop_reference();
+
+		if (_m_stack_ptr != 0 && _m_stack[_m_stack_ptr - 1].type == DaedalusStackFrameType::STRING) {
+			return _m_strings[_m_stack[--_m_stack_ptr].symbol];
+		}
+
+		auto [s, i, context] = pop_raw_reference();
 
 		// compatibility: sometimes the context might be zero, but we can't fail so when
 		//                the compatibility flag is set, we just return 0
@@ -620,7 +1312,75 @@ namespace zenkit {
 			return empty;
 		}
 
-		return s->get_string(i, context.get());
+		return s->get_string(i, context);
+	}
+
+	void DaedalusVm::pin(std::shared_ptr<DaedalusInstance> instance) {
+		if (instance == nullptr || (!_m_pinned.empty() && _m_pinned.back() == instance)) return;
+		_m_pinned.push_back(std::move(instance));
+
+		// Scripts which push many short-lived instances in a loop would otherwise accumulate them until they return.
+		if (_m_pinned.size() > stack_size) this->unpin();
+	}
+
+	void DaedalusVm::unpin() {
+		std::vector<DaedalusInstance const*> live;
+		for (auto i = 0u; i < _m_stack_ptr; ++i) {
+			if (_m_stack[i].type == DaedalusStackFrameType::INSTANCE ||
+			    _m_stack[i].type == DaedalusStackFrameType::REFERENCE) {
+				live.push_back(_m_stack[i].instance);
+			}
+		}
+
+		std::sort(live.begin(), live.end());
+		live.erase(std::unique(live.begin(), live.end()), live.end());
+
+		// Keep only one pin per instance, so that the number of pins is bounded by the number of stack frames.
+		size_t kept = 0;
+		for (auto& inst : _m_pinned) {
+			auto it = std::lower_bound(live.begin(), live.end(), inst.get());
+			if (it == live.end() || *it != inst.get()) continue;
+
+			live.erase(it);
+			_m_pinned[kept++] = std::move(inst);
+		}
+
+		_m_pinned.resize(kept);
+	}
+
+	std::shared_ptr<DaedalusInstance> DaedalusVm::find_pinned(DaedalusInstance const* instance) const {
+		if (instance == nullptr) return nullptr;
+		if (instance == _m_instance.get()) return _m_instance;
+
+		for (auto it = _m_pinned.rbegin(); it != _m_pinned.rend(); ++it) {
+			if (it->get() == instance) return *it;
+		}
+
+		// The instance might be the context of a function further up the call stack.
+		for (auto i = _m_call_stack_ptr; i > 0; --i) {
+			if (_m_call_stack[i - 1].context.get() == instance) return _m_call_stack[i - 1].context;
+		}
+
+		ZKLOGE("DaedalusVm", "Instance referenced by the stack is not pinned");
+		return nullptr;
+	}
+
+	void DaedalusVm::collect_strings() {
+		std::vector<DaedalusStackFrame*> live;
+		for (auto i = 0u; i < _m_stack_ptr; ++i) {
+			if (_m_stack[i].type == DaedalusStackFrameType::STRING) live.push_back(&_m_stack[i]);
+		}
+
+		std::sort(live.begin(), live.end(), [](auto* a, auto* b) { return a->symbol < b->symbol; });
+
+		// Swapping keeps the capacity of the discarded strings around for reuse.
+		std::uint32_t kept = 0;
+		for (auto* frame : live) {
+			if (frame->symbol != kept) std::swap(_m_strings[kept], _m_strings[frame->symbol]);
+			frame->symbol = kept++;
+		}
+
+		_m_strings_used = kept;
 	}
 
 	void DaedalusVm::jump(std::uint32_t address) {
@@ -638,14 +1398,16 @@ namespace zenkit {
 	void DaedalusVm::register_default_external(std::function<void(DaedalusSymbol const&)> const& callback) {
 		_m_default_external = [this, callback](DaedalusVm& v, DaedalusSymbol const& sym) {
 			// pop all parameters from the stack
-			auto params = find_parameters_for_function(&sym);
+			auto params = find_parameters(&sym);
 			for (int i = static_cast<int>(params.size()) - 1; i >= 0; --i) {
 				auto par = params[static_cast<unsigned>(i)];
 				if (par->type() == DaedalusDataType::INT)
 					(void) v.pop_int();
 				else if (par->type() == DaedalusDataType::FLOAT)
 					(void) v.pop_float();
-				else if (par->type() == DaedalusDataType::INSTANCE || par->type() == DaedalusDataType::STRING)
+				else if (par->type() == DaedalusDataType::STRING)
+					(void) v.pop_string();
+				else if (par->type() == DaedalusDataType::INSTANCE)
 					(void) v.pop_reference();
 			}
 
@@ -669,10 +1431,23 @@ namespace zenkit {
 		_m_default_external = callback;
 	}
 
+	void DaedalusVm::set_profiling(bool enabled) {
+		if (_m_call_stack_ptr != 0) {
+			throw DaedalusVmException {"cannot change profiling while the VM is executing"};
+		}
+
+		_m_profile = enabled ? std::make_unique<DaedalusVmProfile>() : nullptr;
+	}
+
 	void DaedalusVm::register_access_trap(std::function<void(DaedalusSymbol&)> const& callback) {
 		_m_access_trap = callback;
 	}
 
+	void DaedalusVm::register_trace_hook(
+	    std::function<void(DaedalusVm&, DaedalusInstruction const&)> const& callback) {
+		_m_trace_hook = callback;
+	}
+
 	void DaedalusVm::register_exception_handler(
 	    std::function<DaedalusVmExceptionStrategy(DaedalusVm&,
 	                                              DaedalusScriptError const&,
@@ -680,20 +1455,167 @@ namespace zenkit {
 		_m_exception_handler = callback;
 	}
 
+	bool DaedalusVm::register_compiled_function(std::string_view name,
+	                                            std::uint32_t checksum,
+	                                            DaedalusCompiledFunction fn) {
+		auto* sym = find_symbol_by_name(name);
+		if (sym == nullptr || sym->type() != DaedalusDataType::FUNCTION || sym->is_external()) {
+			ZKLOGW("DaedalusVm", "Not compiling %.*s: no such function", static_cast<int>(name.size()), name.data());
+			return false;
+		}
+
+		if (this->function_checksum(*sym) != checksum) {
+			ZKLOGW("DaedalusVm", "Not compiling %s: the code does not match the script", sym->name().c_str());
+			return false;
+		}
+
+		_m_compiled[sym->index()] = fn;
+		return true;
+	}
+
+	DaedalusVmSnapshot DaedalusVm::snapshot() const {
+		DaedalusVmSnapshot snapshot;
+		snapshot.symbol_count = static_cast<std::uint32_t>(_m_symbol_table.size());
+		snapshot.instance = _m_instance;
+		snapshot.flags = _m_flags;
+
+		// Size the buffer up-front, so that it is allocated only once.
+		size_t size = 0;
+		for (auto const* sym : _m_symbol_table) {
+			auto count = sym->value_count();
+
+			if (auto* ints = std::get_if<std::unique_ptr<std::int32_t[]>>(&sym->_m_value); ints && *ints) {
+				size += count * sizeof(std::int32_t);
+			} else if (auto* floats = std::get_if<std::unique_ptr<float[]>>(&sym->_m_value); floats && *floats) {
+				size += count * sizeof(float);
+			} else if (auto* strings = std::get_if<std::unique_ptr<std::string[]>>(&sym->_m_value);
+			           strings && *strings) {
+				for (auto i = 0u; i < count; ++i) {
+					size += sizeof(std::uint32_t) + (*strings)[i].size();
+				}
+			}
+		}
+
+		snapshot.values.resize(size);
+		auto* out = snapshot.values.data();
+
+		for (auto const* sym : _m_symbol_table) {
+			auto count = sym->value_count();
+
+			if (auto* ints = std::get_if<std::unique_ptr<std::int32_t[]>>(&sym->_m_value); ints && *ints) {
+				std::memcpy(out, ints->get(), count * sizeof(std::int32_t));
+				out += count * sizeof(std::int32_t);
+			} else if (auto* floats = std::get_if<std::unique_ptr<float[]>>(&sym->_m_value); floats && *floats) {
+				std::memcpy(out, floats->get(), count * sizeof(float));
+				out += count * sizeof(float);
+			} else if (auto* strings = std::get_if<std::unique_ptr<std::string[]>>(&sym->_m_value);
+			           strings && *strings) {
+				for (auto i = 0u; i < count; ++i) {
+					auto const& value = (*strings)[i];
+					auto length = static_cast<std::uint32_t>(value.size());
+
+					std::memcpy(out, &length, sizeof length);
+					std::memcpy(out + sizeof length, value.data(), length);
+					out += sizeof length + length;
+				}
+			} else if (auto* instance = std::get_if<std::shared_ptr<DaedalusInstance>>(&sym->_m_value)) {
+				snapshot.instances.push_back(*instance);
+			}
+		}
+
+		return snapshot;
+	}
+
+	void DaedalusVm::restore(DaedalusVmSnapshot const& snapshot) {
+		if (_m_call_stack_ptr != 0) {
+			throw DaedalusVmException {"Cannot restore a snapshot while executing a function"};
+		}
+
+		if (snapshot.symbol_count != _m_symbol_table.size()) {
+			throw DaedalusVmException {"Cannot restore a snapshot taken from a different script"};
+		}
+
+		// Check that the snapshot matches the layout of the symbols before changing any of them, so that a mismatched
+		// snapshot leaves the VM untouched.
+		auto const* begin = snapshot.values.data();
+		auto const* end = begin + snapshot.values.size();
+		auto const* in = begin;
+		size_t instances = 0;
+
+		auto take = [&in, end](size_t size) {
+			if (static_cast<size_t>(end - in) < size) {
+				throw DaedalusVmException {"Cannot restore a snapshot taken from a different script"};
+			}
+
+			auto const* data = in;
+			in += size;
+			return data;
+		};
+
+		for (auto const* sym : _m_symbol_table) {
+			auto count = sym->value_count();
+
+			if (auto* ints = std::get_if<std::unique_ptr<std::int32_t[]>>(&sym->_m_value); ints && *ints) {
+				take(count * sizeof(std::int32_t));
+			} else if (auto* floats = std::get_if<std::unique_ptr<float[]>>(&sym->_m_value); floats && *floats) {
+				take(count * sizeof(float));
+			} else if (auto* strings = std::get_if<std::unique_ptr<std::string[]>>(&sym->_m_value);
+			           strings && *strings) {
+				for (auto i = 0u; i < count; ++i) {
+					std::uint32_t length;
+					std::memcpy(&length, take(sizeof length), sizeof length);
+					take(length);
+				}
+			} else if (std::holds_alternative<std::shared_ptr<DaedalusInstance>>(sym->_m_value)) {
+				++instances;
+			}
+		}
+
+		if (in != end || instances != snapshot.instances.size()) {
+			throw DaedalusVmException {"Cannot restore a snapshot taken from a different script"};
+		}
+
+		in = begin;
+		auto instance = snapshot.instances.begin();
+
+		for (auto* sym : _m_symbol_table) {
+			auto count = sym->value_count();
+
+			if (auto* ints = std::get_if<std::unique_ptr<std::int32_t[]>>(&sym->_m_value); ints && *ints) {
+				std::memcpy(ints->get(), in, count * sizeof(std::int32_t));
+				in += count * sizeof(std::int32_t);
+			} else if (auto* floats = std::get_if<std::unique_ptr<float[]>>(&sym->_m_value); floats && *floats) {
+				std::memcpy(floats->get(), in, count * sizeof(float));
+				in += count * sizeof(float);
+			} else if (auto* strings = std::get_if<std::unique_ptr<std::string[]>>(&sym->_m_value);
+			           strings && *strings) {
+				for (auto i = 0u; i < count; ++i) {
+					std::uint32_t length;
+					std::memcpy(&length, in, sizeof length);
+
+					(*strings)[i].assign(reinterpret_cast<char const*>(in + sizeof length), length);
+					in += sizeof length + length;
+				}
+			} else if (auto* inst = std::get_if<std::shared_ptr<DaedalusInstance>>(&sym->_m_value)) {
+				*inst = *instance++;
+			}
+		}
+
+		_m_instance = snapshot.instance;
+		_m_flags = snapshot.flags;
+	}
+
 	void DaedalusVm::print_stack_trace() const {
 		auto last_pc = _m_pc;
 		auto tmp_stack_ptr = _m_stack_ptr;
 
-		std::stack callstack {_m_call_stack};
-
 		ZKLOGE("DaedalusVm", "------- CALL STACK (MOST RECENT CALL FIRST) -------");
 
-		while (!callstack.empty()) {
-			auto v = callstack.top();
+		for (auto i = _m_call_stack_ptr; i > 0; --i) {
+			auto const& v = _m_call_stack[i - 1];
 			ZKLOGE("DaedalusVm", "in %s at %x", v.function->name().c_str(), last_pc);
 
 			last_pc = v.program_counter;
-			callstack.pop();
 		}
 
 		ZKLOGE("DaedalusVm", "------- STACK (MOST RECENT PUSH FIRST) -------");
@@ -701,22 +1623,23 @@ namespace zenkit {
 		while (tmp_stack_ptr > 0) {
 			auto& v = _m_stack[--tmp_stack_ptr];
 
-			if (v.reference) {
-				auto ref = std::get<DaedalusSymbol*>(v.value);
+			if (v.type == DaedalusStackFrameType::REFERENCE) {
+				// The symbol is not modified, DaedalusSymbol::get_instance just lacks a const overload.
+				auto* ref = const_cast<DaedalusSymbol*>(find_symbol_by_index(v.symbol));
 				std::string value;
 
 				switch (ref->type()) {
 				case DaedalusDataType::FLOAT:
-					value = std::to_string(ref->get_float(v.index, _m_instance.get()));
+					value = std::to_string(ref->get_float(v.index, v.instance));
 					break;
 				case DaedalusDataType::INT:
-					value = std::to_string(ref->get_int(v.index, _m_instance.get()));
+					value = std::to_string(ref->get_int(v.index, v.instance));
 					break;
 				case DaedalusDataType::STRING:
-					value = "'" + ref->get_string(v.index, _m_instance.get()) + "'";
+					value = "'" + ref->get_string(v.index, v.instance) + "'";
 					break;
 				case DaedalusDataType::FUNCTION: {
-					auto index = ref->get_int(v.index, _m_instance.get());
+					auto index = ref->get_int(v.index, v.instance);
 					auto sym = find_symbol_by_index(static_cast<uint32_t>(index));
 					value = "&" + sym->name();
 					break;
@@ -739,21 +1662,19 @@ namespace zenkit {
 				       ref->name().c_str(),
 				       v.index,
 				       value.c_str());
+			} else if (v.type == DaedalusStackFrameType::STRING) {
+				ZKLOGE("DaedalusVm", "%d: [IMMEDIATE STRING] = '%s'", tmp_stack_ptr, _m_strings[v.symbol].c_str());
+			} else if (v.type == DaedalusStackFrameType::FLOAT) {
+				ZKLOGE("DaedalusVm", "%d: [IMMEDIATE FLOAT] = %f", tmp_stack_ptr, v.f);
+			} else if (v.type == DaedalusStackFrameType::INT) {
+				ZKLOGE("DaedalusVm", "%d: [IMMEDIATE INT] = %d", tmp_stack_ptr, v.i);
+			} else if (v.instance == nullptr) {
+				ZKLOGE("DaedalusVm", "%d: [IMMEDIATE INSTANCE] = NULL", tmp_stack_ptr);
 			} else {
-				if (std::holds_alternative<float>(v.value)) {
-					ZKLOGE("DaedalusVm", "%d: [IMMEDIATE FLOAT] = %f", tmp_stack_ptr, std::get<float>(v.value));
-				} else if (std::holds_alternative<int32_t>(v.value)) {
-					ZKLOGE("DaedalusVm", "%d: [IMMEDIATE INT] = %d", tmp_stack_ptr, std::get<int32_t>(v.value));
-				} else if (std::holds_alternative<std::shared_ptr<DaedalusInstance>>(v.value)) {
-					if (auto& inst = std::get<std::shared_ptr<DaedalusInstance>>(v.value); inst == nullptr) {
-						ZKLOGE("DaedalusVm", "%d: [IMMEDIATE INSTANCE] = NULL", tmp_stack_ptr);
-					} else {
-						ZKLOGE("DaedalusVm",
-						       "%d: [IMMEDIATE INSTANCE] = <instance of '%s'>",
-						       tmp_stack_ptr,
-						       inst->_m_type->name());
-					}
-				}
+				ZKLOGE("DaedalusVm",
+				       "%d: [IMMEDIATE INSTANCE] = <instance of '%s'>",
+				       tmp_stack_ptr,
+				       v.instance->_m_type->name());
 			}
 		}
 
@@ -890,85 +1811,102 @@ namespace zenkit {
 	DaedalusVm::get_int(std::shared_ptr<DaedalusInstance> const& context,
 	                    std::variant<int32_t, float, DaedalusSymbol*, std::shared_ptr<DaedalusInstance>> const& value,
 	                    uint16_t index) const {
-		auto* sym = std::get<DaedalusSymbol*>(value);
+		return this->read_int(context.get(), std::get<DaedalusSymbol*>(value), index);
+	}
 
+	float
+	DaedalusVm::get_float(std::shared_ptr<DaedalusInstance> const& context,
+	                      std::variant<int32_t, float, DaedalusSymbol*, std::shared_ptr<DaedalusInstance>> const& value,
+	                      uint16_t index) const {
+		return this->read_float(context.get(), std::get<DaedalusSymbol*>(value), index);
+	}
+
+	void DaedalusVm::set_int(std::shared_ptr<DaedalusInstance> const& context,
+	                         DaedalusSymbol* ref,
+	                         uint16_t index,
+	                         std::int32_t value) {
+		this->write_int(context.get(), ref, index, value);
+	}
+
+	void DaedalusVm::set_float(std::shared_ptr<DaedalusInstance> const& context,
+	                           DaedalusSymbol* ref,
+	                           uint16_t index,
+	                           float value) {
+		this->write_float(context.get(), ref, index, value);
+	}
+
+	void DaedalusVm::set_string(std::shared_ptr<DaedalusInstance> const& context,
+	                            DaedalusSymbol* ref,
+	                            uint16_t index,
+	                            std::string_view value) {
+		this->write_string(context.get(), ref, index, value);
+	}
+
+	std::int32_t DaedalusVm::read_int(DaedalusInstance const* context, DaedalusSymbol* ref, uint16_t index) const {
 		// compatibility: sometimes the context might be zero, but we can't fail so when
 		//                the compatibility flag is set, we just return 0
-		if (sym->is_member() && context == nullptr) {
+		if (ref->is_member() && context == nullptr) {
 			if (!(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-				throw DaedalusNoContextError {sym};
+				throw DaedalusNoContextError {ref};
 			}
 
-			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", sym->name().c_str());
+			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 			return 0;
 		}
 
-		return sym->get_int(index, context.get());
+		return ref->get_int(index, context);
 	}
 
-	float
-	DaedalusVm::get_float(std::shared_ptr<DaedalusInstance> const& context,
-	                      std::variant<int32_t, float, DaedalusSymbol*, std::shared_ptr<DaedalusInstance>> const& value,
-	                      uint16_t index) const {
-		auto* sym = std::get<DaedalusSymbol*>(value);
-
+	float DaedalusVm::read_float(DaedalusInstance const* context, DaedalusSymbol* ref, uint16_t index) const {
 		// compatibility: sometimes the context might be zero, but we can't fail so when
 		//                the compatibility flag is set, we just return 0
-		if (sym->is_member() && context == nullptr) {
+		if (ref->is_member() && context == nullptr) {
 			if (!(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-				throw DaedalusNoContextError {sym};
+				throw DaedalusNoContextError {ref};
 			}
 
-			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", sym->name().c_str());
+			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 			return 0;
 		}
 
-		return sym->get_float(index, context.get());
+		return ref->get_float(index, context);
 	}
 
-	void DaedalusVm::set_int(std::shared_ptr<DaedalusInstance> const& context,
-	                         DaedalusSymbol* ref,
-	                         uint16_t index,
-	                         std::int32_t value) {
+	void DaedalusVm::write_int(DaedalusInstance* context, DaedalusSymbol* ref, uint16_t index, std::int32_t value) {
 		if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
 			throw DaedalusIllegalConstAccess {ref};
 		}
 
 		if (!ref->is_member() || context != nullptr ||
 		    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-			ref->set_int(value, index, context.get());
+			ref->set_int(value, index, context);
 		} else if (ref->is_member()) {
 			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 		}
 	}
 
-	void DaedalusVm::set_float(std::shared_ptr<DaedalusInstance> const& context,
-	                           DaedalusSymbol* ref,
-	                           uint16_t index,
-	                           float value) {
+	void DaedalusVm::write_float(DaedalusInstance* context, DaedalusSymbol* ref, uint16_t index, float value) {
 		if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
 			throw DaedalusIllegalConstAccess {ref};
 		}
 
 		if (!ref->is_member() || context != nullptr ||
 		    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-			ref->set_float(value, index, context.get());
+			ref->set_float(value, index, context);
 		} else if (ref->is_member()) {
 			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 		}
 	}
 
-	void DaedalusVm::set_string(std::shared_ptr<DaedalusInstance> const& context,
-	                            DaedalusSymbol* ref,
-	                            uint16_t index,
-	                            std::string_view value) {
+	void
+	DaedalusVm::write_string(DaedalusInstance* context, DaedalusSymbol* ref, uint16_t index, std::string_view value) {
 		if (ref->is_const() && !(_m_flags & DaedalusVmExecutionFlag::IGNORE_CONST_SPECIFIER)) {
 			throw DaedalusIllegalConstAccess {ref};
 		}
 
 		if (!ref->is_member() || context != nullptr ||
 		    !(_m_flags & DaedalusVmExecutionFlag::ALLOW_NULL_INSTANCE_ACCESS)) {
-			ref->set_string(value, index, context.get());
+			ref->set_string(value, index, context);
 		} else if (ref->is_member()) {
 			ZKLOGE("DaedalusVm", "Accessing member \"%s\" without an instance set", ref->name().c_str());
 		}
@@ -0,0 +1,307 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/Executor.hh"
+
+#include "Internal.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#ifdef _ZK_WITH_THREADS
+	#include <deque>
+	#include <thread>
+#endif
+
+namespace zenkit {
+	static void executor_run(std::function<void()> const& task) noexcept {
+		try {
+			task();
+		} catch (std::exception const& e) {
+			ZKLOGE("Executor", "Task failed: %s", e.what());
+		} catch (...) {
+			ZKLOGE("Executor", "Task failed");
+		}
+	}
+
+#ifdef _ZK_WITH_THREADS
+	namespace detail {
+		struct ThreadPoolQueue {
+			std::mutex lock;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		struct ThreadPoolState {
+			std::vector<ThreadPoolQueue> queues;
+			std::vector<std::thread> threads;
+			std::atomic_size_t next_queue {0};
+
+			std::mutex sleep_lock;
+			std::condition_variable wake;
+			std::size_t pending {0};
+			bool stopping {false};
+
+			explicit ThreadPoolState(std::size_t thread_count) : queues(thread_count) {}
+
+			/// \brief Takes the newest task of the given queue or the oldest task of any other queue.
+			bool pop(std::size_t index, std::function<void()>& task) {
+				{
+					auto& own = queues[index];
+					std::lock_guard guard {own.lock};
+					if (!own.tasks.empty()) {
+						task = std::move(own.tasks.back());
+						own.tasks.pop_back();
+						return true;
+					}
+				}
+
+				for (std::size_t i = 1; i < queues.size(); ++i) {
+					auto& other = queues[(index + i) % queues.size()];
+					std::lock_guard guard {other.lock};
+					if (!other.tasks.empty()) {
+						task = std::move(other.tasks.front());
+						other.tasks.pop_front();
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			void work(std::size_t index);
+		};
+
+		/// \brief The pool and queue of the calling thread, if it is a worker.
+		thread_local ThreadPoolState* current_pool = nullptr;
+		thread_local std::size_t current_queue = 0;
+
+		void ThreadPoolState::work(std::size_t index) {
+			current_pool = this;
+			current_queue = index;
+
+			std::function<void()> task;
+			for (;;) {
+				if (this->pop(index, task)) {
+					{
+						std::lock_guard guard {sleep_lock};
+						--pending;
+					}
+
+					executor_run(task);
+					task = nullptr;
+					continue;
+				}
+
+				std::unique_lock guard {sleep_lock};
+				wake.wait(guard, [this] { return stopping || pending > 0; });
+				if (stopping && pending == 0) return;
+			}
+		}
+	} // namespace detail
+
+	ThreadPool::ThreadPool(std::size_t thread_count) {
+		if (thread_count == 0) thread_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+		if (thread_count == 0) return;
+
+		_m_state = std::make_unique<detail::ThreadPoolState>(thread_count);
+		for (std::size_t i = 0; i < thread_count; ++i) {
+			_m_state->threads.emplace_back(&detail::ThreadPoolState::work, _m_state.get(), i);
+		}
+	}
+
+	ThreadPool::~ThreadPool() noexcept {
+		if (_m_state == nullptr) return;
+
+		{
+			std::lock_guard guard {_m_state->sleep_lock};
+			_m_state->stopping = true;
+		}
+		_m_state->wake.notify_all();
+
+		for (auto& thread : _m_state->threads) {
+			thread.join();
+		}
+	}
+
+	std::size_t ThreadPool::concurrency() const noexcept {
+		return _m_state == nullptr ? 0 : _m_state->threads.size();
+	}
+
+	void ThreadPool::execute(std::function<void()> task) {
+		if (_m_state == nullptr) return executor_run(task);
+
+		auto& state = *_m_state;
+		auto index = detail::current_pool == &state ? detail::current_queue
+		                                             : state.next_queue.fetch_add(1) % state.queues.size();
+
+		// Count the task first, so that it is never popped before it is counted.
+		{
+			std::lock_guard guard {state.sleep_lock};
+			++state.pending;
+		}
+
+		{
+			auto& queue = state.queues[index];
+			std::lock_guard guard {queue.lock};
+			queue.tasks.push_back(std::move(task));
+		}
+
+		state.wake.notify_one();
+	}
+#else
+	namespace detail {
+		struct ThreadPoolState {};
+	} // namespace detail
+
+	// Threads are only available in browser builds with pthreads support.
+	ThreadPool::ThreadPool(std::size_t) {}
+
+	ThreadPool::~ThreadPool() noexcept = default;
+
+	std::size_t ThreadPool::concurrency() const noexcept {
+		return 0;
+	}
+
+	void ThreadPool::execute(std::function<void()> task) {
+		executor_run(task);
+	}
+#endif
+
+	static std::atomic<Executor*> global_executor {nullptr};
+
+	void set_executor(Executor* executor) noexcept {
+		global_executor.store(executor);
+	}
+
+	Executor* get_executor() {
+		if (auto* executor = global_executor.load()) return executor;
+
+		// The default pool is never destroyed, so that its threads don't have to be joined while the process exits.
+		static auto* pool = new ThreadPool();
+		return pool;
+	}
+
+	namespace detail {
+		struct TaskGroupShared {
+			std::mutex lock;
+			std::condition_variable done;
+		};
+
+		struct TaskGroupTask {
+			std::function<void()> fn;
+			MemoryCategory category;
+			LoadStatsCollector* stats;
+			std::uint32_t stats_depth;
+			std::shared_ptr<TaskGroupShared> shared;
+
+			std::atomic_bool claimed {false};
+			bool finished {false};
+			std::exception_ptr error;
+
+			void run() noexcept {
+				try {
+					MemoryScope memory {category};
+					LoadStatsTask load_stats {stats, stats_depth};
+					fn();
+				} catch (...) {
+					error = std::current_exception();
+				}
+
+				fn = nullptr;
+
+				{
+					std::lock_guard guard {shared->lock};
+					finished = true;
+				}
+				shared->done.notify_all();
+			}
+		};
+	} // namespace detail
+
+	TaskGroup::TaskGroup(Executor* executor) : _m_executor(executor != nullptr ? executor : get_executor()) {}
+
+	TaskGroup::~TaskGroup() noexcept {
+		try {
+			this->wait();
+		} catch (...) {
+			// The caller did not wait for the group, so it is not interested in the errors of its tasks.
+		}
+	}
+
+	void TaskGroup::run(std::function<void()> task) {
+		auto shared = _m_tasks.empty() ? std::make_shared<detail::TaskGroupShared>() : _m_tasks.front()->shared;
+
+		auto item = std::make_shared<detail::TaskGroupTask>();
+		item->fn = std::move(task);
+		item->category = current_memory_category();
+		item->stats = detail::current_load_stats();
+		item->stats_depth = detail::current_load_depth();
+		item->shared = std::move(shared);
+		_m_tasks.push_back(item);
+
+		// Whoever claims the task first runs it. The executor might not get to it before the group is waited on.
+		_m_executor->execute([item] {
+			if (!item->claimed.exchange(true)) item->run();
+		});
+	}
+
+	void TaskGroup::wait() {
+		if (_m_tasks.empty()) return;
+
+		for (auto& task : _m_tasks) {
+			if (!task->claimed.exchange(true)) task->run();
+		}
+
+		auto shared = _m_tasks.front()->shared;
+		{
+			std::unique_lock guard {shared->lock};
+			shared->done.wait(guard, [this] {
+				return std::all_of(_m_tasks.begin(), _m_tasks.end(), [](auto const& task) { return task->finished; });
+			});
+		}
+
+		std::exception_ptr error;
+		for (auto& task : _m_tasks) {
+			if (error == nullptr) error = task->error;
+		}
+
+		_m_tasks.clear();
+		if (error) std::rethrow_exception(error);
+	}
+
+	void parallel_for(std::size_t count, std::function<void(std::size_t)> const& fn, std::size_t max_threads) {
+		auto* executor = get_executor();
+
+		auto thread_count = std::min(count, executor->concurrency() + 1);
+		if (max_threads != 0) thread_count = std::min(thread_count, max_threads);
+
+		if (thread_count <= 1) {
+			for (std::size_t i = 0; i < count; ++i) {
+				fn(i);
+			}
+			return;
+		}
+
+		std::atomic_size_t next {0};
+		auto work = [&] {
+			try {
+				for (std::size_t i; (i = next.fetch_add(1)) < count;) {
+					fn(i);
+				}
+			} catch (...) {
+				next = count;
+				throw;
+			}
+		};
+
+		TaskGroup group {executor};
+		for (std::size_t i = 1; i < thread_count; ++i) {
+			group.run(work);
+		}
+
+		work();
+		group.wait();
+	}
+} // namespace zenkit
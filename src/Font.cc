@@ -4,13 +4,17 @@
 #include "zenkit/Stream.hh"
 #include "zenkit/Error.hh"
 
+#include <algorithm>
+
 namespace zenkit {
 	bool FontGlyph::operator==(FontGlyph const& g) const noexcept {
 		return this->width == g.width && this->uv[0] == g.uv[0] && this->uv[1] == g.uv[1];
 	}
 
 	Font::Font(std::string font_name, std::uint32_t font_height, std::vector<FontGlyph> font_glyphs)
-	    : name(std::move(font_name)), height(font_height), glyphs(std::move(font_glyphs)) {}
+	    : name(std::move(font_name)), height(font_height), glyphs(std::move(font_glyphs)) {
+		this->update_metrics();
+	}
 
 	void Font::load(Read* r) {
 		if (auto version = r->read_line(true); version != "1") {
@@ -32,6 +36,8 @@ namespace zenkit {
 		for (auto& glyph : glyphs) {
 			glyph.uv[1] = r->read_vec2();
 		}
+
+		this->update_metrics();
 	}
 
 	void Font::save(Write* w) const {
@@ -52,4 +58,56 @@ namespace zenkit {
 			w->write_vec2(glyph.uv[1]);
 		}
 	}
+
+	void Font::update_metrics() noexcept {
+		_m_widths.fill(0);
+
+		auto count = std::min(glyphs.size(), _m_widths.size());
+		for (std::size_t i = 0; i < count; ++i) {
+			_m_widths[i] = glyphs[i].width;
+		}
+	}
+
+	Vec2 Font::measure(std::string_view text) const noexcept {
+		std::uint32_t width = 0, line_width = 0, lines = 1;
+
+		for (auto c : text) {
+			if (c == '\n') {
+				width = std::max(width, line_width);
+				line_width = 0;
+				++lines;
+				continue;
+			}
+
+			line_width += _m_widths[static_cast<std::uint8_t>(c)];
+		}
+
+		width = std::max(width, line_width);
+		return {static_cast<float>(width), static_cast<float>(lines * this->height)};
+	}
+
+	Vec2 Font::layout(std::string_view text, std::vector<FontQuad>& quads, Vec2 origin) const {
+		auto line_height = static_cast<float>(this->height);
+		auto x = origin.x, y = origin.y, width = 0.0f;
+
+		for (auto c : text) {
+			if (c == '\n') {
+				width = std::max(width, x - origin.x);
+				x = origin.x;
+				y += line_height;
+				continue;
+			}
+
+			auto index = static_cast<std::uint8_t>(c);
+			auto advance = static_cast<float>(_m_widths[index]);
+			if (advance == 0) continue;
+
+			auto& glyph = glyphs[index];
+			quads.push_back(FontQuad {{Vec2 {x, y}, Vec2 {x + advance, y + line_height}}, {glyph.uv[0], glyph.uv[1]}});
+			x += advance;
+		}
+
+		width = std::max(width, x - origin.x);
+		return {width, y + line_height - origin.y};
+	}
 } // namespace zenkit
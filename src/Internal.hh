@@ -2,18 +2,121 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 #include "zenkit/Logger.hh"
+#include "zenkit/Memory.hh"
+#include "zenkit/Trace.hh"
+#include <cstddef>
 #include <cstdint>
 
+// Threads are available everywhere except in WebAssembly builds without pthreads support (see ZK_WASM_THREADS).
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	#define _ZK_WITH_THREADS 1
+#endif
+
+// The most verbose level of log messages compiled into the library, as the value of a zenkit::LogLevel. Messages of
+// more verbose levels are removed entirely. By default, trace messages are only compiled into debug builds.
+#ifndef ZK_LOG_LEVEL
+	#ifdef NDEBUG
+		#define ZK_LOG_LEVEL 3
+	#else
+		#define ZK_LOG_LEVEL 4
+	#endif
+#endif
+
+// Messages are only formatted if their level is compiled in and enabled at runtime, see zenkit::Logger::enabled.
+#define _ZK_LOG(lvl, ...)                                                                                              \
+	do {                                                                                                               \
+		if constexpr (static_cast<int>(lvl) <= ZK_LOG_LEVEL) {                                                         \
+			if (zenkit::Logger::enabled(lvl)) zenkit::Logger::log(lvl, __VA_ARGS__);                                   \
+		}                                                                                                              \
+	} while (false)
+
 #ifndef _MSC_VER
-	#define ZKLOGT(...) zenkit::Logger::log(zenkit::LogLevel::TRACE, __VA_ARGS__)
-	#define ZKLOGD(...) zenkit::Logger::log(zenkit::LogLevel::DEBUG, __VA_ARGS__)
-	#define ZKLOGI(...) zenkit::Logger::log(zenkit::LogLevel::INFO, __VA_ARGS__)
-	#define ZKLOGW(...) zenkit::Logger::log(zenkit::LogLevel::WARNING, __VA_ARGS__)
-	#define ZKLOGE(...) zenkit::Logger::log(zenkit::LogLevel::ERROR, __VA_ARGS__)
+	#define ZKLOGT(...) _ZK_LOG(zenkit::LogLevel::TRACE, __VA_ARGS__)
+	#define ZKLOGD(...) _ZK_LOG(zenkit::LogLevel::DEBUG, __VA_ARGS__)
+	#define ZKLOGI(...) _ZK_LOG(zenkit::LogLevel::INFO, __VA_ARGS__)
+	#define ZKLOGW(...) _ZK_LOG(zenkit::LogLevel::WARNING, __VA_ARGS__)
+	#define ZKLOGE(...) _ZK_LOG(zenkit::LogLevel::ERROR, __VA_ARGS__)
 #else
-	#define ZKLOGT(...) zenkit::Logger::log(zenkit::LogLevel::TRACE, ##__VA_ARGS__)
-	#define ZKLOGD(...) zenkit::Logger::log(zenkit::LogLevel::DEBUG, ##__VA_ARGS__)
-	#define ZKLOGI(...) zenkit::Logger::log(zenkit::LogLevel::INFO, ##__VA_ARGS__)
-	#define ZKLOGW(...) zenkit::Logger::log(zenkit::LogLevel::WARNING, ##__VA_ARGS__)
-	#define ZKLOGE(...) zenkit::Logger::log(zenkit::LogLevel::ERROR, ##__VA_ARGS__)
+	#define ZKLOGT(...) _ZK_LOG(zenkit::LogLevel::TRACE, ##__VA_ARGS__)
+	#define ZKLOGD(...) _ZK_LOG(zenkit::LogLevel::DEBUG, ##__VA_ARGS__)
+	#define ZKLOGI(...) _ZK_LOG(zenkit::LogLevel::INFO, ##__VA_ARGS__)
+	#define ZKLOGW(...) _ZK_LOG(zenkit::LogLevel::WARNING, ##__VA_ARGS__)
+	#define ZKLOGE(...) _ZK_LOG(zenkit::LogLevel::ERROR, ##__VA_ARGS__)
 #endif
+
+namespace zenkit {
+	namespace detail {
+		/// \return The collector of the LoadStatsScope open on the calling thread or `nullptr`.
+		[[nodiscard]] LoadStatsCollector* current_load_stats() noexcept;
+
+		/// \return The number of phases currently open on the calling thread.
+		[[nodiscard]] std::uint32_t current_load_depth() noexcept;
+
+		/// \brief Continues collecting load statistics in a task run on another thread, see TaskGroup.
+		class LoadStatsTask {
+		public:
+			LoadStatsTask(LoadStatsCollector* collector, std::uint32_t depth) noexcept;
+			~LoadStatsTask() noexcept;
+
+			LoadStatsTask(LoadStatsTask const&) = delete;
+			LoadStatsTask& operator=(LoadStatsTask const&) = delete;
+
+		private:
+			LoadStatsCollector* _m_previous;
+			std::uint32_t _m_previous_depth;
+		};
+
+		/// \brief Counts objects loaded for the LoadStatsScope open on the calling thread, if any.
+		void count_load_objects(std::uint64_t count) noexcept;
+
+		/// \brief Counts an allocation for the LoadStatsScope open on the calling thread, if any.
+		void count_load_allocation(std::size_t size) noexcept;
+	} // namespace detail
+
+	/// \brief Records a span for the Tracer and a phase for the current LoadStatsScope from its construction to its
+	///        destruction, see ZKTRACE.
+	class TraceZone {
+	public:
+		explicit TraceZone(char const* name) noexcept;
+		~TraceZone() noexcept;
+
+		TraceZone(TraceZone const&) = delete;
+		TraceZone& operator=(TraceZone const&) = delete;
+
+		void bytes(std::uint64_t count) noexcept {
+			_m_bytes = count;
+		}
+
+	private:
+		char const* _m_name;
+		detail::LoadStatsCollector* _m_stats;
+		std::uint64_t _m_begin {0};
+		std::uint64_t _m_bytes {0};
+		bool _m_active {false};
+	};
+} // namespace zenkit
+
+// ZKTRACE(name) opens a span which lasts until the end of the enclosing scope. ZKTRACE_ZONE(zone, name) does the same,
+// but names the span, so that ZKTRACE_BYTES(zone, n) can set the number of bytes processed in it. Spans may be nested.
+// They are reported to the Tracer or Tracy if enabled and to the current LoadStatsScope, so they are compiled into all
+// builds and should only mark coarse phases.
+#define _ZK_CONCAT_INNER(a, b) a##b
+#define _ZK_CONCAT(a, b) _ZK_CONCAT_INNER(a, b)
+
+#if defined(_ZK_WITH_TRACY)
+	#include <tracy/Tracy.hpp>
+	#define ZKTRACE_ZONE(zone, name)                                                                                   \
+		ZoneNamedN(_ZK_CONCAT(zone, _tracy), name, true);                                                              \
+		zenkit::TraceZone zone {name}
+	#define ZKTRACE_BYTES(zone, n)                                                                                     \
+		do {                                                                                                           \
+			auto _zk_trace_bytes = static_cast<std::uint64_t>(n);                                                      \
+			ZoneValueV(_ZK_CONCAT(zone, _tracy), _zk_trace_bytes);                                                     \
+			zone.bytes(_zk_trace_bytes);                                                                               \
+		} while (false)
+#else
+	#define ZKTRACE_ZONE(zone, name) zenkit::TraceZone zone {name}
+	#define ZKTRACE_BYTES(zone, n) zone.bytes(static_cast<std::uint64_t>(n))
+#endif
+
+#define ZKTRACE(name) ZKTRACE_ZONE(_ZK_CONCAT(_zk_trace_zone_, __LINE__), name)
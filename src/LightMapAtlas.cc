@@ -0,0 +1,173 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/LightMapAtlas.hh"
+#include "zenkit/Mesh.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace zenkit {
+	namespace {
+		/// \brief The position of a light map texture in the atlas.
+		struct Placement {
+			Texture const* texture;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t page;
+			std::uint32_t x;
+			std::uint32_t y;
+		};
+	} // namespace
+
+	LightMapAtlas Mesh::build_lightmap_atlas(LightMapAtlasOptions const& options) const {
+		LightMapAtlas atlas {};
+		atlas.regions.resize(this->lightmaps.size(), LightMapAtlasRegion {LightMapAtlasRegion::NO_PAGE, {}, {}});
+
+		// Light maps share a few textures, so only each distinct texture is packed.
+		std::vector<Placement> placements;
+		std::unordered_map<Texture const*, std::uint32_t> placement_indices;
+		for (auto& lightmap : this->lightmaps) {
+			auto* texture = lightmap.image.get();
+			if (texture == nullptr || texture->width() == 0 || texture->height() == 0) continue;
+
+			auto [it, added] = placement_indices.emplace(texture, static_cast<std::uint32_t>(placements.size()));
+			if (added) placements.push_back(Placement {texture, texture->width(), texture->height(), 0, 0, 0});
+		}
+
+		// Place the textures on shelves, from the tallest to the shortest one.
+		std::vector<std::uint32_t> order(placements.size());
+		std::iota(order.begin(), order.end(), 0);
+
+		std::stable_sort(order.begin(), order.end(), [&placements](std::uint32_t a, std::uint32_t b) {
+			auto& pa = placements[a];
+			auto& pb = placements[b];
+			return pa.height != pb.height ? pa.height > pb.height : pa.width > pb.width;
+		});
+
+		auto padding = options.padding;
+		auto page_size = std::max(options.page_size, 1u);
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> extents; // The used width and height of each page.
+		std::uint32_t shelf_page = 0, shelf_x = 0, shelf_y = 0, shelf_height = 0;
+		auto has_shelf = false;
+
+		for (auto index : order) {
+			auto& p = placements[index];
+			auto cell_width = p.width + 2 * padding;
+			auto cell_height = p.height + 2 * padding;
+
+			if (cell_width > page_size || cell_height > page_size) {
+				// Oversized textures get a page of their own.
+				p.page = static_cast<std::uint32_t>(extents.size());
+				p.x = padding;
+				p.y = padding;
+				extents.emplace_back(cell_width, cell_height);
+				continue;
+			}
+
+			if (has_shelf && shelf_x + cell_width > page_size) {
+				shelf_y += shelf_height;
+				shelf_x = 0;
+				shelf_height = 0;
+			}
+
+			if (!has_shelf || shelf_y + cell_height > page_size) {
+				shelf_page = static_cast<std::uint32_t>(extents.size());
+				shelf_x = 0;
+				shelf_y = 0;
+				shelf_height = 0;
+				has_shelf = true;
+				extents.emplace_back(0, 0);
+			}
+
+			p.page = shelf_page;
+			p.x = shelf_x + padding;
+			p.y = shelf_y + padding;
+
+			shelf_x += cell_width;
+			shelf_height = std::max(shelf_height, cell_height);
+			extents[shelf_page].first = std::max(extents[shelf_page].first, shelf_x);
+			extents[shelf_page].second = std::max(extents[shelf_page].second, shelf_y + shelf_height);
+		}
+
+		atlas.pages.resize(extents.size());
+		for (auto i = 0u; i < extents.size(); ++i) {
+			auto& page = atlas.pages[i];
+			page.width = extents[i].first;
+			page.height = extents[i].second;
+			page.pixels.resize(static_cast<std::size_t>(page.width) * page.height * 4, 0);
+		}
+
+		// Copy the textures, repeating their border pixels in the padding around them.
+		for (auto& p : placements) {
+			auto rgba = p.texture->as_rgba8(0);
+			auto& page = atlas.pages[p.page];
+
+			for (auto y = 0u; y < p.height + 2 * padding; ++y) {
+				auto src_y = y < padding ? 0 : std::min(y - padding, p.height - 1);
+				auto* src = rgba.data() + static_cast<std::size_t>(src_y) * p.width * 4;
+				auto* dst = page.pixels.data() +
+				    (static_cast<std::size_t>(p.y - padding + y) * page.width + (p.x - padding)) * 4;
+
+				for (auto x = 0u; x < padding; ++x) {
+					std::memcpy(dst + x * 4, src, 4);
+					std::memcpy(dst + (padding + p.width + x) * 4, src + (p.width - 1) * 4, 4);
+				}
+
+				std::memcpy(dst + padding * 4, src, static_cast<std::size_t>(p.width) * 4);
+			}
+		}
+
+		for (auto i = 0u; i < this->lightmaps.size(); ++i) {
+			auto it = placement_indices.find(this->lightmaps[i].image.get());
+			if (it == placement_indices.end()) continue;
+
+			auto& p = placements[it->second];
+			auto& page = atlas.pages[p.page];
+			auto width = static_cast<float>(page.width);
+			auto height = static_cast<float>(page.height);
+
+			atlas.regions[i] = LightMapAtlasRegion {
+			    p.page,
+			    Vec2 {static_cast<float>(p.x) / width, static_cast<float>(p.y) / height},
+			    Vec2 {static_cast<float>(p.width) / width, static_cast<float>(p.height) / height},
+			};
+		}
+
+		return atlas;
+	}
+
+	Vec2
+	LightMapAtlas::uv(LightMap const& lightmap, LightMapAtlasRegion const& region, Vec3 const& position) noexcept {
+		auto dx = position.x - lightmap.origin.x;
+		auto dy = position.y - lightmap.origin.y;
+		auto dz = position.z - lightmap.origin.z;
+
+		auto& n0 = lightmap.normals[0];
+		auto& n1 = lightmap.normals[1];
+		auto u = dx * n0.x + dy * n0.y + dz * n0.z;
+		auto v = dx * n1.x + dy * n1.y + dz * n1.z;
+		return Vec2 {region.offset.x + u * region.scale.x, region.offset.y + v * region.scale.y};
+	}
+
+	void LightMapAtlas::compute_uvs(Mesh const& mesh, std::vector<Vec2>& uvs) const {
+		auto const& indices = mesh.polygons.vertex_indices;
+		auto const& lightmaps = mesh.polygons.lightmap_indices;
+
+		uvs.assign(indices.size(), Vec2 {0, 0});
+		for (auto i = 0u; i < indices.size(); ++i) {
+			auto triangle = i / 3;
+			if (triangle >= lightmaps.size() || lightmaps[triangle] < 0) continue;
+
+			auto lightmap = static_cast<std::size_t>(lightmaps[triangle]);
+			if (lightmap >= mesh.lightmaps.size() || lightmap >= this->regions.size() ||
+			    this->regions[lightmap].page == LightMapAtlasRegion::NO_PAGE || indices[i] >= mesh.vertices.size()) {
+				continue;
+			}
+
+			uvs[i] = uv(mesh.lightmaps[lightmap], this->regions[lightmap], mesh.vertices[indices[i]]);
+		}
+	}
+} // namespace zenkit
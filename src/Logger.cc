@@ -21,7 +21,7 @@ namespace zenkit {
 	static char zk_global_logger_buffer[4096];
 
 	std::function<void(LogLevel, char const*, char const*)> Logger::_s_callback {};
-	LogLevel Logger::_s_level {LogLevel::INFO};
+	std::atomic<LogLevel> Logger::_s_level {LogLevel::INFO};
 
 	ZKINT static void zk_internal_logger_default(LogLevel level, char const* name, char const* message) {
 		time_t now_t = time(nullptr);
@@ -74,7 +74,7 @@ namespace zenkit {
 
 	void Logger::logv(LogLevel lvl, char const* name, char const* fmt, va_list ap) {
 		if (!_s_callback) return;
-		if (lvl > _s_level) return;
+		if (!enabled(lvl)) return;
 		vsnprintf(zk_global_logger_buffer, sizeof zk_global_logger_buffer - 1, fmt, ap);
 		_s_callback(lvl, name, zk_global_logger_buffer);
 	}
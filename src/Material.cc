@@ -6,6 +6,7 @@
 
 #include "Internal.hh"
 
+#include <functional>
 #include <sstream>
 
 namespace zenkit {
@@ -32,6 +33,7 @@ namespace zenkit {
 		}
 
 		this->load(r, obj.version == MATERIAL_VERSION_G1 ? GameVersion::GOTHIC_1 : GameVersion::GOTHIC_2);
+		detail::count_load_objects(1);
 
 		if (!r.read_object_end()) {
 			ZKLOGW("Material", "\"%s\" not fully parsed", this->name.c_str());
@@ -125,4 +127,70 @@ namespace zenkit {
 	uint16_t Material::get_version_identifier(GameVersion game) const {
 		return game == GameVersion::GOTHIC_1 ? MATERIAL_VERSION_G1 : MATERIAL_VERSION_G2;
 	}
+
+	static bool material_equals(Material const& a, Material const& b) {
+		return a.name == b.name && a.group == b.group && a.color == b.color && a.smooth_angle == b.smooth_angle &&
+		    a.texture == b.texture && a.texture_scale == b.texture_scale && a.texture_anim_fps == b.texture_anim_fps &&
+		    a.texture_anim_map_mode == b.texture_anim_map_mode && a.texture_anim_map_dir == b.texture_anim_map_dir &&
+		    a.disable_collision == b.disable_collision && a.disable_lightmap == b.disable_lightmap &&
+		    a.dont_collapse == b.dont_collapse && a.detail_object == b.detail_object &&
+		    a.detail_object_scale == b.detail_object_scale && a.force_occluder == b.force_occluder &&
+		    a.environment_mapping == b.environment_mapping &&
+		    a.environment_mapping_strength == b.environment_mapping_strength && a.wave_mode == b.wave_mode &&
+		    a.wave_speed == b.wave_speed && a.wave_max_amplitude == b.wave_max_amplitude &&
+		    a.wave_grid_size == b.wave_grid_size && a.ignore_sun == b.ignore_sun && a.alpha_func == b.alpha_func &&
+		    a.default_mapping == b.default_mapping;
+	}
+
+	static std::size_t material_hash(Material const& m) {
+		// Only the fields which usually differ between materials are hashed, the rest is left to material_equals.
+		std::size_t hash = std::hash<std::string> {}(m.name);
+		auto combine = [&hash](std::size_t v) { hash ^= v + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+		combine(std::hash<std::string> {}(m.texture));
+		combine(static_cast<std::size_t>(m.group));
+		combine(static_cast<std::size_t>(m.alpha_func));
+		combine(static_cast<std::size_t>(m.color.r) << 24 | static_cast<std::size_t>(m.color.g) << 16 |
+		        static_cast<std::size_t>(m.color.b) << 8 | m.color.a);
+		return hash;
+	}
+
+	std::uint32_t MaterialRegistry::intern(Material material) {
+		auto hash = material_hash(material);
+
+		std::lock_guard guard {_m_lock};
+		if (auto handle = this->find_locked(material, hash)) return *handle;
+
+		auto handle = static_cast<std::uint32_t>(_m_materials.size());
+		_m_materials.push_back(std::make_shared<Material const>(std::move(material)));
+		_m_handles.emplace(hash, handle);
+		return handle;
+	}
+
+	std::optional<std::uint32_t> MaterialRegistry::find(Material const& material) const {
+		auto hash = material_hash(material);
+
+		std::lock_guard guard {_m_lock};
+		return this->find_locked(material, hash);
+	}
+
+	std::optional<std::uint32_t> MaterialRegistry::find_locked(Material const& material, std::size_t hash) const {
+		auto [begin, end] = _m_handles.equal_range(hash);
+		for (auto it = begin; it != end; ++it) {
+			if (material_equals(*_m_materials[it->second], material)) return it->second;
+		}
+
+		return std::nullopt;
+	}
+
+	std::shared_ptr<Material const> MaterialRegistry::get(std::uint32_t handle) const {
+		std::lock_guard guard {_m_lock};
+		if (handle >= _m_materials.size()) return nullptr;
+		return _m_materials[handle];
+	}
+
+	std::size_t MaterialRegistry::size() const {
+		std::lock_guard guard {_m_lock};
+		return _m_materials.size();
+	}
 } // namespace zenkit
@@ -0,0 +1,123 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/Memory.hh"
+
+#include "Internal.hh"
+
+#include <algorithm>
+#include <new>
+
+namespace zenkit {
+	namespace {
+		class NewDeleteMemoryResource final : public MemoryResource {
+		public:
+			void* allocate(std::size_t size, std::size_t alignment) override {
+				if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(size);
+				return ::operator new(size, std::align_val_t {alignment});
+			}
+
+			void deallocate(void* p, std::size_t size, std::size_t alignment) noexcept override {
+				if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+					::operator delete(p, size);
+				} else {
+					::operator delete(p, size, std::align_val_t {alignment});
+				}
+			}
+		};
+
+		NewDeleteMemoryResource default_resource;
+		std::atomic<MemoryResource*> global_resource {&default_resource};
+		thread_local MemoryCategory current_category {MemoryCategory::OTHER};
+	} // namespace
+
+	MemoryResource* new_delete_memory_resource() noexcept {
+		return &default_resource;
+	}
+
+	void set_memory_resource(MemoryResource* resource) noexcept {
+		global_resource.store(resource != nullptr ? resource : &default_resource);
+	}
+
+	MemoryResource* get_memory_resource() noexcept {
+		return global_resource.load();
+	}
+
+	MemoryCategory current_memory_category() noexcept {
+		return current_category;
+	}
+
+	MemoryScope::MemoryScope(MemoryCategory category) noexcept : _m_previous(current_category) {
+		current_category = category;
+	}
+
+	MemoryScope::~MemoryScope() noexcept {
+		current_category = _m_previous;
+	}
+
+	MemoryTracker::MemoryTracker(MemoryResource* upstream) noexcept
+	    : _m_upstream(upstream != nullptr ? upstream : get_memory_resource()) {}
+
+	// Each allocation is prefixed with the category it was made in, so that freeing it from another thread or
+	// scope is attributed correctly. The prefix is as large as the alignment to keep the memory aligned.
+	static std::size_t tracker_prefix_size(std::size_t alignment) noexcept {
+		return std::max(alignment, alignof(std::max_align_t));
+	}
+
+	void* MemoryTracker::allocate(std::size_t size, std::size_t alignment) {
+		auto prefix = tracker_prefix_size(alignment);
+		auto* block = static_cast<std::byte*>(_m_upstream->allocate(size + prefix, prefix));
+
+		auto category = current_category;
+		block[prefix - 1] = static_cast<std::byte>(category);
+
+		this->record_allocation(size, category);
+		return block + prefix;
+	}
+
+	void MemoryTracker::deallocate(void* p, std::size_t size, std::size_t alignment) noexcept {
+		auto prefix = tracker_prefix_size(alignment);
+		auto* block = static_cast<std::byte*>(p) - prefix;
+
+		this->record_deallocation(size, static_cast<MemoryCategory>(block[prefix - 1]));
+		_m_upstream->deallocate(block, size + prefix, prefix);
+	}
+
+	void MemoryTracker::record_allocation(std::size_t size, MemoryCategory category) noexcept {
+		auto& counters = _m_counters[static_cast<std::size_t>(category)];
+		counters.allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.total.fetch_add(size, std::memory_order_relaxed);
+		detail::count_load_allocation(size);
+
+		auto current = counters.current.fetch_add(size, std::memory_order_relaxed) + size;
+		auto peak = counters.peak.load(std::memory_order_relaxed);
+		while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+	}
+
+	void MemoryTracker::record_deallocation(std::size_t size, MemoryCategory category) noexcept {
+		_m_counters[static_cast<std::size_t>(category)].current.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	MemoryStats MemoryTracker::stats(MemoryCategory category) const noexcept {
+		auto const& counters = _m_counters[static_cast<std::size_t>(category)];
+		return MemoryStats {
+		    counters.current.load(std::memory_order_relaxed),
+		    counters.peak.load(std::memory_order_relaxed),
+		    counters.total.load(std::memory_order_relaxed),
+		    counters.allocations.load(std::memory_order_relaxed),
+		};
+	}
+
+	MemoryStats MemoryTracker::total() const noexcept {
+		MemoryStats result {0, 0, 0, 0};
+
+		for (std::size_t i = 0; i < MEMORY_CATEGORY_COUNT; ++i) {
+			auto stats = this->stats(static_cast<MemoryCategory>(i));
+			result.current += stats.current;
+			result.peak += stats.peak;
+			result.total += stats.total;
+			result.allocations += stats.allocations;
+		}
+
+		return result;
+	}
+} // namespace zenkit
@@ -2,14 +2,26 @@
 // SPDX-License-Identifier: MIT
 #include "zenkit/Mesh.hh"
 #include "zenkit/Archive.hh"
+#include "zenkit/Executor.hh"
 #include "zenkit/Stream.hh"
 
+#include "Cooked.hh"
+#include "Internal.hh"
+
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <unordered_map>
 
 namespace zenkit {
 	[[maybe_unused]] static constexpr auto MESH_VERSION_G1 = 9;
 	static constexpr auto MESH_VERSION_G2 = 265;
 
+	/// \brief The minimum number of polygons triangulated by each thread.
+	static constexpr std::size_t TRIANGULATE_CHUNK_SIZE = 16384;
+
 	enum class MeshChunkType : std::uint16_t {
 		MARKER = 0xB000,
 		BBOX = 0xB010,
@@ -35,6 +47,9 @@ namespace zenkit {
 	}
 
 	void Mesh::load(Read* r, bool force_wide_indices) {
+		ZKTRACE_ZONE(zone, "Mesh.load");
+		MemoryScope memory {MemoryCategory::MESH};
+		auto begin = r->tell();
 		std::uint16_t version {};
 
 		proto::read_chunked<MeshChunkType>(
@@ -52,6 +67,8 @@ namespace zenkit {
 				    this->obb.load(c);
 				    break;
 			    case MeshChunkType::MATERIAL: {
+				    ZKTRACE_ZONE(chunk_zone, "Mesh.materials");
+				    auto chunk_begin = c->tell();
 				    auto matreader = ReadArchive::from(c);
 
 				    this->materials.resize(c->read_uint());
@@ -59,14 +76,14 @@ namespace zenkit {
 					    material.load(*matreader);
 				    }
 
+				    this->material_handles.clear();
+
+				    ZKTRACE_BYTES(chunk_zone, c->tell() - chunk_begin);
 				    break;
 			    }
 			    case MeshChunkType::VERTICES:
 				    this->vertices.resize(c->read_uint());
-
-				    for (auto& vertex : this->vertices) {
-					    vertex = c->read_vec3();
-				    }
+				    c->read_vec3_array(this->vertices.data(), this->vertices.size());
 
 				    break;
 			    case MeshChunkType::FEATURES:
@@ -80,6 +97,8 @@ namespace zenkit {
 
 				    break;
 			    case MeshChunkType::POLYGONS: {
+				    ZKTRACE_ZONE(chunk_zone, "Mesh.polygons");
+				    auto chunk_begin = c->tell();
 				    auto poly_count = c->read_uint();
 				    this->geometry.resize(poly_count);
 
@@ -135,9 +154,12 @@ namespace zenkit {
 					    index_offset += vertex_count;
 				    }
 
+				    ZKTRACE_BYTES(chunk_zone, c->tell() - chunk_begin);
 				    break;
 			    }
 			    case MeshChunkType::LIGHTMAPS_SHARED: {
+				    ZKTRACE_ZONE(chunk_zone, "Mesh.lightmaps");
+				    auto chunk_begin = c->tell();
 				    auto texture_count = c->read_uint();
 
 				    std::vector<std::shared_ptr<Texture>> lightmap_textures {};
@@ -159,9 +181,12 @@ namespace zenkit {
 					        LightMap {lightmap_textures[texture_index], {normal_a, normal_b}, origin});
 				    }
 
+				    ZKTRACE_BYTES(chunk_zone, c->tell() - chunk_begin);
 				    break;
 			    }
 			    case MeshChunkType::LIGHTMAPS: {
+				    ZKTRACE_ZONE(chunk_zone, "Mesh.lightmaps");
+				    auto chunk_begin = c->tell();
 				    auto lightmap_count = c->read_uint();
 
 				    for (std::uint32_t i = 0; i < lightmap_count; ++i) {
@@ -177,6 +202,7 @@ namespace zenkit {
 					                                           origin});
 				    }
 
+				    ZKTRACE_BYTES(chunk_zone, c->tell() - chunk_begin);
 				    break;
 			    }
 			    case MeshChunkType::END:
@@ -187,42 +213,201 @@ namespace zenkit {
 
 			    return false;
 		    });
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
 	}
 
 	void Mesh::triangulate(std::vector<std::uint32_t> const& leaf_polygons) {
-		this->polygons.material_indices.reserve(leaf_polygons.size());
-		this->polygons.lightmap_indices.reserve(leaf_polygons.size());
-		this->polygons.feature_indices.reserve(leaf_polygons.size() * 4);
-		this->polygons.vertex_indices.reserve(leaf_polygons.size() * 4);
-		this->polygons.flags.reserve(leaf_polygons.size());
-
-		for (auto i = 0u; i < this->geometry.size(); ++i) {
-			if (!std::binary_search(leaf_polygons.begin(), leaf_polygons.end(), i)) {
-				continue;
-			}
+		ZKTRACE("Mesh.triangulate");
+		MemoryScope memory {MemoryCategory::MESH};
+
+		// The leaf polygons are sorted but may contain duplicates. Collect the polygons to unpack together with the
+		// index of their first triangle, so that the output can be allocated once and filled in any order.
+		std::vector<std::pair<std::uint32_t, std::size_t>> sources;
+		sources.reserve(leaf_polygons.size());
 
-			auto& polygon = this->geometry[i];
+		std::size_t triangle_count = this->polygons.material_indices.size();
+		for (auto i = 0u; i < leaf_polygons.size(); ++i) {
+			auto index = leaf_polygons[i];
+			if (index >= this->geometry.size() || (i > 0 && leaf_polygons[i - 1] == index)) continue;
+
+			auto& polygon = this->geometry[index];
 			if (polygon.index_count < 3 || polygon.flags.is_portal || polygon.flags.is_ghost_occluder ||
 			    polygon.flags.is_outdoor) {
 				continue;
 			}
 
-			auto a = 1u;
+			sources.emplace_back(index, triangle_count);
+			triangle_count += polygon.index_count - 2;
+		}
 
-			// NOTE(lmichaelis): This unpacks triangle fans
-			for (auto b = 2u; b < polygon.index_count; ++b) {
+		this->polygons.material_indices.resize(triangle_count);
+		this->polygons.lightmap_indices.resize(triangle_count);
+		this->polygons.feature_indices.resize(triangle_count * 3);
+		this->polygons.vertex_indices.resize(triangle_count * 3);
+		this->polygons.flags.resize(triangle_count);
+
+		auto unpack = [this, &sources](std::size_t begin, std::size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				auto [index, triangle] = sources[i];
+				auto& polygon = this->geometry[index];
 				auto root = polygon.index_offset;
-				this->polygons.vertex_indices.push_back(polygon_vertex_indices[root]);
-				this->polygons.vertex_indices.push_back(polygon_vertex_indices[root + a]);
-				this->polygons.vertex_indices.push_back(polygon_vertex_indices[root + b]);
-				this->polygons.feature_indices.push_back(polygon_feature_indices[root]);
-				this->polygons.feature_indices.push_back(polygon_feature_indices[root + a]);
-				this->polygons.feature_indices.push_back(polygon_feature_indices[root + b]);
-				this->polygons.material_indices.push_back(polygon.material);
-				this->polygons.lightmap_indices.push_back(polygon.lightmap);
-				this->polygons.flags.push_back(polygon.flags);
-				a = b;
+				auto a = 1u;
+
+				// NOTE(lmichaelis): This unpacks triangle fans
+				for (auto b = 2u; b < polygon.index_count; ++b, ++triangle) {
+					this->polygons.vertex_indices[triangle * 3 + 0] = polygon_vertex_indices[root];
+					this->polygons.vertex_indices[triangle * 3 + 1] = polygon_vertex_indices[root + a];
+					this->polygons.vertex_indices[triangle * 3 + 2] = polygon_vertex_indices[root + b];
+					this->polygons.feature_indices[triangle * 3 + 0] = polygon_feature_indices[root];
+					this->polygons.feature_indices[triangle * 3 + 1] = polygon_feature_indices[root + a];
+					this->polygons.feature_indices[triangle * 3 + 2] = polygon_feature_indices[root + b];
+					this->polygons.material_indices[triangle] = polygon.material;
+					this->polygons.lightmap_indices[triangle] = polygon.lightmap;
+					this->polygons.flags[triangle] = polygon.flags;
+					a = b;
+				}
+			}
+		};
+
+		// Each polygon writes to its own range of the output, so chunks of polygons can be unpacked concurrently.
+		// Small meshes are not worth handing to other threads.
+		auto thread_count = std::min(sources.size() / TRIANGULATE_CHUNK_SIZE, get_executor()->concurrency() + 1);
+		if (thread_count <= 1) return unpack(0, sources.size());
+
+		auto chunk = (sources.size() + thread_count - 1) / thread_count;
+		parallel_for(thread_count, [&](std::size_t i) {
+			unpack(std::min(sources.size(), i * chunk), std::min(sources.size(), (i + 1) * chunk));
+		});
+	}
+
+	std::vector<MeshTile> Mesh::split_into_tiles(float tile_size) const {
+		std::vector<std::uint32_t> polygons(this->geometry.size());
+		std::iota(polygons.begin(), polygons.end(), 0);
+		return this->split_into_tiles(tile_size, polygons);
+	}
+
+	std::vector<MeshTile> Mesh::split_into_tiles(float tile_size, std::vector<std::uint32_t> const& polygons) const {
+		if (!(tile_size > 0)) return {};
+
+		// Sort the polygons into cells by their center. Using a std::map keeps the tiles in a stable order.
+		std::vector<std::uint32_t> sorted {polygons};
+		std::sort(sorted.begin(), sorted.end());
+		sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+		std::map<std::pair<std::int32_t, std::int32_t>, std::vector<std::uint32_t>> cells;
+		for (auto index : sorted) {
+			if (index >= this->geometry.size()) continue;
+
+			auto& polygon = this->geometry[index];
+			auto end = polygon.index_offset + polygon.index_count;
+			if (polygon.index_count == 0 || end > polygon_vertex_indices.size() ||
+			    end > polygon_feature_indices.size()) {
+				continue;
+			}
+
+			float center_x = 0, center_z = 0;
+			auto valid = true;
+			for (auto i = 0u; i < polygon.index_count; ++i) {
+				auto vertex = polygon_vertex_indices[polygon.index_offset + i];
+				if (vertex >= this->vertices.size() ||
+				    polygon_feature_indices[polygon.index_offset + i] >= this->features.size()) {
+					valid = false;
+					break;
+				}
+
+				center_x += this->vertices[vertex].x;
+				center_z += this->vertices[vertex].z;
+			}
+
+			if (!valid) continue;
+
+			auto scale = static_cast<float>(polygon.index_count) * tile_size;
+			auto x = static_cast<std::int32_t>(std::floor(center_x / scale));
+			auto z = static_cast<std::int32_t>(std::floor(center_z / scale));
+			cells[{x, z}].push_back(index);
+		}
+
+		// Copies an element into the tile the first time it is referenced and returns its index in the tile.
+		auto remap = [](auto& lookup, auto& output, std::uint32_t index, auto const& element) {
+			auto [it, added] = lookup.emplace(index, static_cast<std::uint32_t>(output.size()));
+			if (added) output.push_back(element);
+			return it->second;
+		};
+
+		std::vector<MeshTile> tiles;
+		tiles.reserve(cells.size());
+
+		for (auto& [cell, indices] : cells) {
+			auto& tile = tiles.emplace_back();
+			tile.x = cell.first;
+			tile.z = cell.second;
+			tile.polygons = std::move(indices);
+
+			auto& mesh = tile.mesh;
+			mesh.date = this->date;
+			mesh.name = this->name;
+			mesh.geometry.reserve(tile.polygons.size());
+
+			std::unordered_map<std::uint32_t, std::uint32_t> vertices;
+			std::unordered_map<std::uint32_t, std::uint32_t> features;
+			std::unordered_map<std::uint32_t, std::uint32_t> materials;
+			std::unordered_map<std::uint32_t, std::uint32_t> lightmaps;
+
+			for (auto index : tile.polygons) {
+				auto polygon = this->geometry[index];
+				auto offset = polygon.index_offset;
+				polygon.index_offset = mesh.polygon_vertex_indices.size();
+
+				if (polygon.material < this->materials.size()) {
+					auto& material = this->materials[polygon.material];
+					polygon.material = remap(materials, mesh.materials, polygon.material, material);
+				}
+
+				if (polygon.lightmap >= 0 && static_cast<std::size_t>(polygon.lightmap) < this->lightmaps.size()) {
+					auto lightmap = static_cast<std::uint32_t>(polygon.lightmap);
+					auto remapped = remap(lightmaps, mesh.lightmaps, lightmap, this->lightmaps[lightmap]);
+					polygon.lightmap = static_cast<std::int32_t>(remapped);
+				} else {
+					polygon.lightmap = -1;
+				}
+
+				for (auto i = 0u; i < polygon.index_count; ++i) {
+					auto vertex = polygon_vertex_indices[offset + i];
+					auto feature = polygon_feature_indices[offset + i];
+					mesh.polygon_vertex_indices.push_back(
+					    remap(vertices, mesh.vertices, vertex, this->vertices[vertex]));
+					mesh.polygon_feature_indices.push_back(
+					    remap(features, mesh.features, feature, this->features[feature]));
+				}
+
+				mesh.geometry.push_back(polygon);
+			}
+
+			Vec3 min {std::numeric_limits<float>::max()};
+			Vec3 max {std::numeric_limits<float>::lowest()};
+			for (auto& v : mesh.vertices) {
+				for (auto i = 0u; i < 3; ++i) {
+					min[i] = std::min(min[i], v[i]);
+					max[i] = std::max(max[i], v[i]);
+				}
 			}
+			mesh.bbox = AxisAlignedBoundingBox {min, max};
+
+			std::vector<std::uint32_t> all(mesh.geometry.size());
+			std::iota(all.begin(), all.end(), 0);
+			mesh.triangulate(all);
+		}
+
+		return tiles;
+	}
+
+	void Mesh::intern_materials(MaterialRegistry& registry) {
+		this->material_handles.clear();
+		this->material_handles.reserve(this->materials.size());
+
+		for (auto& material : this->materials) {
+			this->material_handles.push_back(registry.intern(material));
 		}
 	}
 
@@ -270,46 +455,183 @@ namespace zenkit {
 			c->write_uint(this->geometry.size());
 
 			for (auto& poly : this->geometry) {
-				c->write_uint(poly.material);
-				c->write_uint(static_cast<uint32_t>(poly.lightmap));
+				c->write_ushort(static_cast<std::uint16_t>(poly.material));
+				c->write_short(static_cast<std::int16_t>(poly.lightmap));
 
 				// TODO(lmichaelis): Figure these out.
 				c->write_float(0);
 				c->write_vec3({0, 0, 0});
 
-				if (version == GameVersion::GOTHIC_1) {
-					auto& flags = poly.flags;
+				// The layout must match the one expected by Mesh::load for the written version.
+				auto& flags = poly.flags;
+				if (version == GameVersion::GOTHIC_2) {
 					c->write_ubyte((flags.is_portal & 3) | ((flags.is_occluder & 1) << 2) |
 					               ((flags.is_sector & 1) << 3) | ((flags.should_relight & 1) << 4) |
 					               ((flags.is_outdoor & 1) << 5) | ((flags.is_ghost_occluder & 1) << 6) |
 					               ((flags.is_dynamically_lit & 1) << 7));
 					c->write_short(flags.sector_index);
 				} else {
-					auto& flags = poly.flags;
 					c->write_ubyte((flags.is_portal & 3) | ((flags.is_occluder & 1) << 2) |
 					               ((flags.is_sector & 1) << 3) | ((flags.is_lod & 1) << 4) |
 					               ((flags.is_outdoor & 1) << 5) | ((flags.is_ghost_occluder & 1) << 6) |
 					               ((flags.normal_axis & 1) << 7));
-					c->write_ubyte(flags.normal_axis & 2);
+					c->write_ubyte((flags.normal_axis & 2) >> 1);
 					c->write_short(flags.sector_index);
 				}
 
-				c->write_ubyte(poly.index_count);
-				for (auto i = 0u; i < poly.index_count; ++i) {
+				c->write_ubyte(static_cast<std::uint8_t>(poly.index_count));
+				for (auto i = poly.index_offset; i < poly.index_offset + poly.index_count; ++i) {
 					if (version == GameVersion::GOTHIC_1) {
-						c->write_ushort(this->polygons.vertex_indices[i]);
-						c->write_uint(this->polygons.feature_indices[i]);
+						c->write_ushort(static_cast<std::uint16_t>(this->polygon_vertex_indices[i]));
 					} else {
-						c->write_uint(this->polygons.vertex_indices[i]);
-						c->write_uint(this->polygons.feature_indices[i]);
+						c->write_uint(this->polygon_vertex_indices[i]);
 					}
+
+					c->write_uint(this->polygon_feature_indices[i]);
 				}
 			}
 		});
 
-		// TODO(lmichaelis): Fixup  lightmaps. We need to figure out all lightmaps which share a texture.
-		proto::write_chunk(w, MeshChunkType::LIGHTMAPS_SHARED, [](Write* c) { c->write_uint(0); });
+		proto::write_chunk(w, MeshChunkType::LIGHTMAPS_SHARED, [this](Write* c) {
+			// Light maps usually share a few large textures, so each texture is only written once.
+			std::vector<Texture const*> textures;
+			std::unordered_map<Texture const*, std::uint32_t> texture_indices;
+			for (auto& lightmap : this->lightmaps) {
+				auto [it, added] =
+				    texture_indices.emplace(lightmap.image.get(), static_cast<std::uint32_t>(textures.size()));
+				if (added) textures.push_back(it->first);
+			}
+
+			c->write_uint(static_cast<std::uint32_t>(textures.size()));
+			for (auto* texture : textures) {
+				if (texture == nullptr) {
+					Texture {}.save(c);
+				} else {
+					texture->save(c);
+				}
+			}
+
+			c->write_uint(static_cast<std::uint32_t>(this->lightmaps.size()));
+			for (auto& lightmap : this->lightmaps) {
+				c->write_vec3(lightmap.origin);
+				c->write_vec3(lightmap.normals[0]);
+				c->write_vec3(lightmap.normals[1]);
+				c->write_uint(texture_indices[lightmap.image.get()]);
+			}
+		});
+
 		proto::write_chunk(w, MeshChunkType::LIGHTMAPS, [](Write* c) { c->write_uint(0); });
 		proto::write_chunk(w, MeshChunkType::END, [](Write*) {});
 	}
+
+	void Mesh::save_cooked(Write* w, GameVersion version) const {
+		this->date.save(w);
+		detail::write_cooked(w, this->name);
+		this->bbox.save(w);
+		this->obb.save(w);
+
+		// Materials contain strings, so they are stored in an archive. It is prefixed with its size, so that the
+		// reader does not depend on where the archive stops reading.
+		std::vector<std::byte> materials;
+		{
+			auto mw = Write::to(&materials);
+			auto war = WriteArchive::to(mw.get(), ArchiveFormat::BINARY);
+			for (auto& mat : this->materials) {
+				war->write_string("", mat.name);
+				war->write_object("%", &mat, version);
+			}
+			war->write_header();
+		}
+
+		w->write_uint(static_cast<std::uint32_t>(this->materials.size()));
+		w->write_uint(static_cast<std::uint32_t>(materials.size()));
+		w->write(materials.data(), materials.size());
+
+		// Light maps usually share a few large textures, so each texture is only written once.
+		std::vector<Texture const*> textures;
+		std::unordered_map<Texture const*, std::uint32_t> texture_indices;
+		for (auto& lightmap : this->lightmaps) {
+			auto index = static_cast<std::uint32_t>(textures.size());
+			auto [it, added] = texture_indices.emplace(lightmap.image.get(), index);
+			if (added) textures.push_back(it->first);
+		}
+
+		w->write_uint(static_cast<std::uint32_t>(textures.size()));
+		for (auto* texture : textures) {
+			if (texture == nullptr) {
+				Texture {}.save(w);
+			} else {
+				texture->save(w);
+			}
+		}
+
+		w->write_uint(static_cast<std::uint32_t>(this->lightmaps.size()));
+		for (auto& lightmap : this->lightmaps) {
+			w->write_vec3(lightmap.origin);
+			w->write_vec3(lightmap.normals[0]);
+			w->write_vec3(lightmap.normals[1]);
+			w->write_uint(texture_indices[lightmap.image.get()]);
+		}
+
+		detail::write_cooked(w, this->vertices);
+		detail::write_cooked(w, this->features);
+		detail::write_cooked(w, this->geometry);
+		detail::write_cooked(w, this->polygon_vertex_indices);
+		detail::write_cooked(w, this->polygon_feature_indices);
+		detail::write_cooked(w, this->polygons.material_indices);
+		detail::write_cooked(w, this->polygons.lightmap_indices);
+		detail::write_cooked(w, this->polygons.feature_indices);
+		detail::write_cooked(w, this->polygons.vertex_indices);
+		detail::write_cooked(w, this->polygons.flags);
+	}
+
+	void Mesh::load_cooked(Read* r) {
+		ZKTRACE_ZONE(zone, "Mesh.load_cooked");
+		MemoryScope memory {MemoryCategory::MESH};
+		auto begin = r->tell();
+
+		this->date.load(r);
+		detail::read_cooked(r, this->name);
+		this->bbox.load(r);
+		this->obb.load(r);
+
+		this->materials.resize(r->read_uint());
+		{
+			auto mr = r->slice(r->read_uint());
+			auto matreader = ReadArchive::from(mr.get());
+			for (auto& material : this->materials) {
+				material.load(*matreader);
+			}
+		}
+		this->material_handles.clear();
+
+		std::vector<std::shared_ptr<Texture>> textures(r->read_uint());
+		for (auto& texture : textures) {
+			texture = std::make_shared<Texture>();
+			texture->load(r);
+		}
+
+		this->lightmaps.resize(r->read_uint());
+		for (auto& lightmap : this->lightmaps) {
+			lightmap.origin = r->read_vec3();
+			lightmap.normals[0] = r->read_vec3();
+			lightmap.normals[1] = r->read_vec3();
+
+			auto index = r->read_uint();
+			if (index >= textures.size()) throw ParserError {"Mesh", "invalid light map texture in cooked world"};
+			lightmap.image = textures[index];
+		}
+
+		detail::read_cooked(r, this->vertices);
+		detail::read_cooked(r, this->features);
+		detail::read_cooked(r, this->geometry);
+		detail::read_cooked(r, this->polygon_vertex_indices);
+		detail::read_cooked(r, this->polygon_feature_indices);
+		detail::read_cooked(r, this->polygons.material_indices);
+		detail::read_cooked(r, this->polygons.lightmap_indices);
+		detail::read_cooked(r, this->polygons.feature_indices);
+		detail::read_cooked(r, this->polygons.vertex_indices);
+		detail::read_cooked(r, this->polygons.flags);
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+	}
 } // namespace zenkit
@@ -0,0 +1,534 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/MeshBuffers.hh"
+#include "zenkit/Executor.hh"
+#include "zenkit/Mesh.hh"
+#include "zenkit/ModelMesh.hh"
+#include "zenkit/MultiResolutionMesh.hh"
+#include "zenkit/SoftSkinMesh.hh"
+
+#include "Internal.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+namespace zenkit {
+	/// \brief The size of the simulated vertex cache used for ordering triangles.
+	static constexpr std::uint32_t VERTEX_CACHE_SIZE = 32;
+
+	/// \brief The minimum number of triangles sorted by material on each thread.
+	static constexpr std::size_t MATERIAL_BATCH_CHUNK_SIZE = 65536;
+
+	namespace {
+		struct MeshBufferVertexHash {
+			std::size_t operator()(MeshBufferVertex const& v) const noexcept {
+				std::uint32_t words[sizeof(MeshBufferVertex) / sizeof(std::uint32_t)];
+				std::memcpy(words, &v, sizeof words);
+
+				std::size_t hash = 0;
+				for (auto word : words) {
+					hash = (hash ^ word) * 0x100000001b3;
+				}
+				return hash;
+			}
+		};
+
+		struct MeshBufferVertexEqual {
+			bool operator()(MeshBufferVertex const& a, MeshBufferVertex const& b) const noexcept {
+				return std::memcmp(&a, &b, sizeof(MeshBufferVertex)) == 0;
+			}
+		};
+
+		/// \brief Collects triangles, deduplicating their vertices and sorting them into batches by material.
+		class MeshBufferBuilder {
+		public:
+			explicit MeshBufferBuilder(std::size_t material_count) : _m_batches(material_count) {}
+
+			void add(std::uint32_t material, MeshBufferVertex const (&vertices)[3]) {
+				if (material >= _m_batches.size()) _m_batches.resize(material + 1);
+
+				auto& batch = _m_batches[material];
+				for (auto const& vertex : vertices) {
+					auto [it, added] =
+					    _m_lookup.emplace(vertex, static_cast<std::uint32_t>(_m_buffers.vertices.size()));
+					if (added) _m_buffers.vertices.push_back(vertex);
+					batch.push_back(it->second);
+				}
+			}
+
+			/// \brief Starts a new level of detail. Triangles added afterwards are emitted into separate batches
+			///        which share the vertices of all previous levels.
+			void next_level() {
+				auto material_count = _m_batches.size();
+				_m_levels.push_back(std::move(_m_batches));
+				_m_batches.clear();
+				_m_batches.resize(material_count);
+			}
+
+			MeshBuffers finish(MeshBufferOptions const& options) {
+				this->next_level();
+
+				auto wide = options.force_wide_indices ||
+				    _m_buffers.vertices.size() > std::numeric_limits<std::uint16_t>::max();
+
+				std::size_t total = 0;
+				for (auto const& level : _m_levels) {
+					for (auto const& batch : level) {
+						total += batch.size();
+					}
+				}
+
+				if (wide) {
+					_m_buffers.indices32.reserve(total);
+				} else {
+					_m_buffers.indices16.reserve(total);
+				}
+
+				for (auto& level : _m_levels) {
+					auto batch_count = _m_buffers.batches.size();
+
+					for (auto material = 0u; material < level.size(); ++material) {
+						auto& batch = level[material];
+						if (batch.empty()) continue;
+						if (options.optimize_vertex_cache) this->optimize(batch);
+
+						_m_buffers.batches.push_back(MeshBufferBatch {
+						    material,
+						    static_cast<std::uint32_t>(_m_buffers.index_count()),
+						    static_cast<std::uint32_t>(batch.size()),
+						});
+
+						if (wide) {
+							_m_buffers.indices32.insert(_m_buffers.indices32.end(), batch.begin(), batch.end());
+						} else {
+							for (auto index : batch) {
+								_m_buffers.indices16.push_back(static_cast<std::uint16_t>(index));
+							}
+						}
+					}
+
+					auto level_batches = _m_buffers.batches.size() - batch_count;
+					_m_level_batch_counts.push_back(static_cast<std::uint32_t>(level_batches));
+				}
+
+				return std::move(_m_buffers);
+			}
+
+			/// \return The number of batches emitted for each level of detail by #finish.
+			[[nodiscard]] std::vector<std::uint32_t> const& level_batch_counts() const noexcept {
+				return _m_level_batch_counts;
+			}
+
+		private:
+			static float vertex_score(std::int32_t cache_position, std::uint32_t remaining) {
+				if (remaining == 0) return -1;
+
+				float score = 0;
+				if (cache_position >= 0 && cache_position < 3) {
+					// The vertices of the last triangle are penalized slightly to avoid strips.
+					score = 0.75f;
+				} else if (cache_position >= 3) {
+					auto scale = 1.0f / static_cast<float>(VERTEX_CACHE_SIZE - 3);
+					score = std::pow(1.0f - static_cast<float>(cache_position - 3) * scale, 1.5f);
+				}
+
+				return score + 2.0f / std::sqrt(static_cast<float>(remaining));
+			}
+
+			/// \brief Reorders the triangles of a batch using Tom Forsyth's linear-speed vertex cache optimization.
+			void optimize(std::vector<std::uint32_t>& indices) {
+				auto triangle_count = indices.size() / 3;
+				if (triangle_count < 2) return;
+
+				// Map the vertices of the batch to a dense range.
+				std::unordered_map<std::uint32_t, std::uint32_t> local;
+				std::vector<std::uint32_t> corners(indices.size());
+				for (auto i = 0u; i < indices.size(); ++i) {
+					auto [it, _] = local.emplace(indices[i], static_cast<std::uint32_t>(local.size()));
+					corners[i] = it->second;
+				}
+
+				auto vertex_count = local.size();
+				std::vector<std::uint32_t> remaining(vertex_count, 0);
+				std::vector<float> score(vertex_count, 0);
+
+				for (auto v : corners) {
+					++remaining[v];
+				}
+
+				// The triangles using each vertex, stored contiguously.
+				std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+				for (auto v = 0u; v < vertex_count; ++v) {
+					offsets[v + 1] = offsets[v] + remaining[v];
+				}
+
+				std::vector<std::uint32_t> adjacency(corners.size());
+				std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+				for (auto i = 0u; i < corners.size(); ++i) {
+					adjacency[fill[corners[i]]++] = i / 3;
+				}
+
+				for (auto v = 0u; v < vertex_count; ++v) {
+					score[v] = vertex_score(-1, remaining[v]);
+				}
+
+				std::vector<float> triangle_score(triangle_count);
+				std::vector<bool> emitted(triangle_count, false);
+				for (auto t = 0u; t < triangle_count; ++t) {
+					triangle_score[t] = score[corners[t * 3]] + score[corners[t * 3 + 1]] + score[corners[t * 3 + 2]];
+				}
+
+				std::vector<std::uint32_t> cache;
+				std::vector<std::uint32_t> next_cache;
+				std::vector<std::uint32_t> output;
+				output.reserve(indices.size());
+
+				auto best = static_cast<std::uint32_t>(
+				    std::max_element(triangle_score.begin(), triangle_score.end()) - triangle_score.begin());
+				std::uint32_t scan = 0;
+
+				for (;;) {
+					emitted[best] = true;
+
+					next_cache.clear();
+					for (auto k = 0u; k < 3; ++k) {
+						auto v = corners[best * 3 + k];
+						output.push_back(indices[best * 3 + k]);
+						next_cache.push_back(v);
+
+						// Remove the triangle from the adjacency of its vertices.
+						auto begin = adjacency.begin() + offsets[v];
+						auto end = begin + remaining[v];
+						std::iter_swap(std::find(begin, end, best), end - 1);
+						--remaining[v];
+					}
+
+					for (auto v : cache) {
+						if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end()) {
+							next_cache.push_back(v);
+						}
+					}
+
+					// Vertices pushed out of the cache are scored again, but their triangles are not.
+					for (auto i = 0u; i < next_cache.size(); ++i) {
+						auto v = next_cache[i];
+						auto position = i < VERTEX_CACHE_SIZE ? static_cast<std::int32_t>(i) : -1;
+						score[v] = vertex_score(position, remaining[v]);
+					}
+
+					if (next_cache.size() > VERTEX_CACHE_SIZE) next_cache.resize(VERTEX_CACHE_SIZE);
+					std::swap(cache, next_cache);
+
+					// Find the best triangle touching the cache.
+					auto found = false;
+					float best_score = -1;
+					for (auto v : cache) {
+						for (auto j = 0u; j < remaining[v]; ++j) {
+							auto t = adjacency[offsets[v] + j];
+							auto s = score[corners[t * 3]] + score[corners[t * 3 + 1]] + score[corners[t * 3 + 2]];
+							if (s > best_score) {
+								best_score = s;
+								best = t;
+								found = true;
+							}
+						}
+					}
+
+					if (found) continue;
+
+					// The cache has no more triangles to offer, so continue with any other triangle.
+					while (scan < triangle_count && emitted[scan]) {
+						++scan;
+					}
+
+					if (scan == triangle_count) break;
+					best = scan;
+				}
+
+				indices = std::move(output);
+			}
+
+			MeshBuffers _m_buffers;
+			std::vector<std::vector<std::uint32_t>> _m_batches;
+			std::vector<std::vector<std::vector<std::uint32_t>>> _m_levels;
+			std::vector<std::uint32_t> _m_level_batch_counts;
+			std::unordered_map<MeshBufferVertex, std::uint32_t, MeshBufferVertexHash, MeshBufferVertexEqual> _m_lookup;
+		};
+	} // namespace
+
+	MeshBuffers Mesh::build_render_buffers(MeshBufferOptions const& options) const {
+		MeshBufferBuilder builder {this->materials.size()};
+
+		auto const& indices = this->polygons.vertex_indices;
+		auto const& features = this->polygons.feature_indices;
+		auto triangle_count = std::min(this->polygons.material_indices.size(), indices.size() / 3);
+
+		for (auto t = 0u; t < triangle_count; ++t) {
+			MeshBufferVertex vertices[3];
+			auto valid = true;
+
+			for (auto k = 0u; k < 3; ++k) {
+				auto vertex = indices[t * 3 + k];
+				auto feature = t * 3 + k < features.size() ? features[t * 3 + k] : this->features.size();
+				if (vertex >= this->vertices.size() || feature >= this->features.size()) {
+					valid = false;
+					break;
+				}
+
+				auto const& f = this->features[feature];
+				vertices[k] = MeshBufferVertex {this->vertices[vertex], f.normal, f.texture, f.light};
+			}
+
+			if (valid) builder.add(this->polygons.material_indices[t], vertices);
+		}
+
+		return builder.finish(options);
+	}
+
+	MeshMaterialBatches Mesh::material_batches() const {
+		auto const& materials = this->polygons.material_indices;
+		auto material_count = this->materials.size();
+		auto triangle_count = materials.size();
+
+		auto chunk_count = std::clamp<std::size_t>(triangle_count / MATERIAL_BATCH_CHUNK_SIZE,
+		                                           1,
+		                                           get_executor()->concurrency() + 1);
+		auto chunk_size = (triangle_count + chunk_count - 1) / chunk_count;
+
+		auto run = [chunk_count](std::function<void(std::size_t)> const& fn) { parallel_for(chunk_count, fn); };
+
+		// Each chunk counts its triangles per material. The counts are then turned into the position at which each
+		// chunk writes the triangles of each material, which keeps the sort stable.
+		std::vector<std::uint32_t> positions(chunk_count * material_count, 0);
+		run([&](std::size_t chunk) {
+			auto* counts = positions.data() + chunk * material_count;
+			auto end = std::min(triangle_count, (chunk + 1) * chunk_size);
+
+			for (auto i = chunk * chunk_size; i < end; ++i) {
+				if (materials[i] < material_count) ++counts[materials[i]];
+			}
+		});
+
+		MeshMaterialBatches result {};
+		std::uint32_t offset = 0;
+		for (auto material = 0u; material < material_count; ++material) {
+			auto begin = offset;
+			for (auto chunk = 0u; chunk < chunk_count; ++chunk) {
+				auto& position = positions[chunk * material_count + material];
+				auto count = position;
+				position = offset;
+				offset += count;
+			}
+
+			if (offset > begin) result.batches.push_back(MeshMaterialBatch {material, begin, offset - begin});
+		}
+
+		result.triangles.resize(offset);
+		run([&](std::size_t chunk) {
+			auto* next = positions.data() + chunk * material_count;
+			auto end = std::min(triangle_count, (chunk + 1) * chunk_size);
+
+			for (auto i = chunk * chunk_size; i < end; ++i) {
+				auto material = materials[i];
+				if (material < material_count) result.triangles[next[material]++] = static_cast<std::uint32_t>(i);
+			}
+		});
+
+		return result;
+	}
+
+	/// \brief Adds the triangles of the sub-meshes of a MultiResolutionMesh to a builder, collapsing wedges to
+	///        reach the given level of detail.
+	///
+	/// <p>The wedges of a sub-mesh are ordered so that the wedges removed first come last. The wedge map of each
+	/// wedge names the lower-indexed wedge it collapses into, or `0xFFFF` if it is never removed. To keep only the
+	/// first `n` wedges, every corner referring to a later wedge is moved along the wedge map until it reaches one
+	/// of the remaining wedges. Triangles which lose a corner or end up with two corners at the same position are
+	/// dropped.</p>
+	static void add_multi_resolution_mesh(MeshBufferBuilder& builder, MultiResolutionMesh const& mesh, float ratio) {
+		// Compact meshes are decoded on the fly.
+		auto compact = mesh.is_compact();
+		auto position_count = compact ? mesh.quantized_positions.size() : mesh.positions.size();
+		auto position_of = [&](std::uint16_t index) {
+			return compact ? mesh.quantized_positions[index].decode(mesh.quantized_position_min,
+			                                                        mesh.quantized_position_scale)
+			               : mesh.positions[index];
+		};
+
+		for (auto i = 0u; i < mesh.sub_meshes.size(); ++i) {
+			auto const& sub_mesh = mesh.sub_meshes[i];
+			auto const& wedge_map = sub_mesh.wedge_map;
+			auto total_wedge_count = compact ? sub_mesh.quantized_wedges.size() : sub_mesh.wedges.size();
+
+			auto wedge_count = total_wedge_count;
+			if (ratio < 1 && wedge_map.size() == wedge_count) {
+				auto kept = std::ceil(std::max(ratio, 0.0f) * static_cast<float>(wedge_count));
+				wedge_count = static_cast<std::size_t>(kept);
+			}
+
+			for (auto const& triangle : sub_mesh.triangles) {
+				MeshBufferVertex vertices[3];
+				std::uint16_t indices[3];
+				auto valid = true;
+				auto collapsed = false;
+
+				for (auto k = 0u; k < 3 && valid; ++k) {
+					auto wedge = triangle.wedges[k];
+					while (wedge >= wedge_count && valid) {
+						valid = wedge < wedge_map.size() && wedge_map[wedge] < wedge;
+						if (valid) wedge = wedge_map[wedge];
+						collapsed = true;
+					}
+
+					if (!valid || wedge >= total_wedge_count) {
+						valid = false;
+						break;
+					}
+
+					auto w = compact ? sub_mesh.quantized_wedges[wedge].decode() : sub_mesh.wedges[wedge];
+					if (w.index >= position_count) {
+						valid = false;
+						break;
+					}
+
+					vertices[k] = MeshBufferVertex {position_of(w.index), w.normal, w.texture, 0xFFFFFFFF};
+					indices[k] = w.index;
+				}
+
+				if (!valid) continue;
+				if (collapsed && (indices[0] == indices[1] || indices[1] == indices[2] || indices[0] == indices[2])) {
+					continue;
+				}
+
+				builder.add(i, vertices);
+			}
+		}
+	}
+
+	MeshBuffers MultiResolutionMesh::build_render_buffers(MeshBufferOptions const& options) const {
+		MeshBufferBuilder builder {this->sub_meshes.size()};
+		add_multi_resolution_mesh(builder, *this, 1);
+		return builder.finish(options);
+	}
+
+	MeshBuffers MultiResolutionMesh::build_lod(float target_ratio, MeshBufferOptions const& options) const {
+		MeshBufferBuilder builder {this->sub_meshes.size()};
+		add_multi_resolution_mesh(builder, *this, target_ratio);
+		return builder.finish(options);
+	}
+
+	MeshLodChain MultiResolutionMesh::build_lod_chain(std::uint32_t level_count,
+	                                                  float reduction,
+	                                                  MeshBufferOptions const& options) const {
+		MeshBufferBuilder builder {this->sub_meshes.size()};
+		MeshLodChain chain {};
+
+		float ratio = 1;
+		for (auto i = 0u; i < level_count; ++i) {
+			if (i != 0) builder.next_level();
+			add_multi_resolution_mesh(builder, *this, ratio);
+			chain.levels.push_back(MeshLod {ratio, 0, 0});
+			ratio *= reduction;
+		}
+
+		chain.buffers = builder.finish(options);
+
+		std::uint32_t offset = 0;
+		for (auto i = 0u; i < chain.levels.size(); ++i) {
+			chain.levels[i].batch_offset = offset;
+			chain.levels[i].batch_count = builder.level_batch_counts()[i];
+			offset += chain.levels[i].batch_count;
+		}
+
+		return chain;
+	}
+
+	SkinnedMeshBuffers SoftSkinMesh::build_skinned_buffers(MeshBufferOptions const& options) const {
+		SkinnedMeshBuffers buffers {};
+		buffers.nodes = this->nodes;
+
+		// Reduce the influences of each vertex to the four strongest ones.
+		auto const& mesh = this->mesh;
+		std::vector<SkinnedMeshBufferVertex> skins(mesh.positions.size(), SkinnedMeshBufferVertex {});
+		std::vector<SoftSkinWeightEntry> influences;
+
+		for (auto i = 0u; i < skins.size() && i < this->weights.size(); ++i) {
+			influences = this->weights[i];
+			std::stable_sort(influences.begin(), influences.end(), [](auto const& a, auto const& b) {
+				return a.weight > b.weight;
+			});
+
+			if (influences.size() > 4) influences.resize(4);
+
+			float total = 0;
+			for (auto const& influence : influences) {
+				total += influence.weight;
+			}
+
+			auto& skin = skins[i];
+			for (auto j = 0u; j < influences.size(); ++j) {
+				skin.positions[j] = influences[j].position;
+				skin.weights[j] = total > 0 ? influences[j].weight / total : 0;
+				skin.nodes[j] = influences[j].node_index;
+			}
+		}
+
+		std::size_t total = 0;
+		for (auto const& sub_mesh : mesh.sub_meshes) {
+			buffers.vertices.reserve(buffers.vertices.size() + sub_mesh.wedges.size());
+			total += sub_mesh.triangles.size() * 3;
+		}
+
+		std::vector<std::uint32_t> indices;
+		indices.reserve(total);
+
+		for (auto i = 0u; i < mesh.sub_meshes.size(); ++i) {
+			auto const& sub_mesh = mesh.sub_meshes[i];
+			auto base = static_cast<std::uint32_t>(buffers.vertices.size());
+
+			for (auto const& wedge : sub_mesh.wedges) {
+				auto vertex = wedge.index < skins.size() ? skins[wedge.index] : SkinnedMeshBufferVertex {};
+				vertex.normal = wedge.normal;
+				vertex.texture = wedge.texture;
+				buffers.vertices.push_back(vertex);
+			}
+
+			auto offset = static_cast<std::uint32_t>(indices.size());
+			for (auto const& triangle : sub_mesh.triangles) {
+				auto valid = triangle.wedges[0] < sub_mesh.wedges.size() &&
+				    triangle.wedges[1] < sub_mesh.wedges.size() && triangle.wedges[2] < sub_mesh.wedges.size();
+				if (!valid) continue;
+
+				for (auto wedge : triangle.wedges) {
+					indices.push_back(base + wedge);
+				}
+			}
+
+			auto count = static_cast<std::uint32_t>(indices.size()) - offset;
+			if (count > 0) buffers.batches.push_back(MeshBufferBatch {i, offset, count});
+		}
+
+		if (options.force_wide_indices || buffers.vertices.size() > std::numeric_limits<std::uint16_t>::max()) {
+			buffers.indices32 = std::move(indices);
+		} else {
+			buffers.indices16.assign(indices.begin(), indices.end());
+		}
+
+		return buffers;
+	}
+
+	std::vector<SkinnedMeshBuffers> ModelMesh::build_skinned_buffers(MeshBufferOptions const& options) const {
+		std::vector<SkinnedMeshBuffers> buffers;
+		buffers.reserve(this->meshes.size());
+
+		for (auto const& mesh : this->meshes) {
+			buffers.push_back(mesh.build_skinned_buffers(options));
+		}
+
+		return buffers;
+	}
+} // namespace zenkit
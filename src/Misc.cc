@@ -19,4 +19,13 @@ namespace zenkit {
 			return std::tolower(c1) < std::tolower(c2);
 		});
 	}
+
+	std::uint64_t ihash(std::string_view s) noexcept {
+		std::uint64_t hash = 0xcbf29ce484222325;
+		for (auto c : s) {
+			hash ^= static_cast<std::uint8_t>(std::tolower(c));
+			hash *= 0x100000001b3;
+		}
+		return hash;
+	}
 } // namespace zenkit
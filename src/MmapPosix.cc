@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: MIT
 #include "zenkit/Mmap.hh"
 
+#include <algorithm>
+#include <string>
+
 #include <sys/fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -47,4 +50,104 @@ namespace zenkit {
 			_m_platform_handle = nullptr;
 		}
 	}
+
+	void Mmap::prefetch(std::size_t offset, std::size_t len) const noexcept {
+		if (_m_data == nullptr || offset >= _m_size) return;
+
+		// madvise requires the address to be page-aligned.
+		static auto const page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+		auto begin = offset - offset % page_size;
+		auto end = std::min(offset + len, _m_size);
+
+		madvise((void*) (_m_data + begin), end - begin, MADV_WILLNEED);
+	}
+
+	void Mmap::advise_sequential() const noexcept {
+		if (_m_data == nullptr) return;
+		madvise((void*) _m_data, _m_size, MADV_SEQUENTIAL);
+	}
+
+	struct MutableMmapPlatform {
+		int fd;
+		std::string path;
+	};
+
+	MutableMmap::MutableMmap(std::filesystem::path const& path, std::size_t initial_size) {
+		auto handle = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+		if (handle == -1) {
+			throw std::runtime_error {"Failed to open " + path.string()};
+		}
+
+		try {
+			_m_platform_handle = new MutableMmapPlatform {handle, path.string()};
+			this->resize(initial_size);
+		} catch (...) {
+			// The destructor does not run if the constructor throws, so the file has to be closed here.
+			close(handle);
+			delete static_cast<MutableMmapPlatform*>(_m_platform_handle);
+			_m_platform_handle = nullptr;
+			throw;
+		}
+
+		_m_final_size = _m_size;
+	}
+
+	MutableMmap::MutableMmap(MutableMmap&& other) noexcept {
+		_m_data = other._m_data;
+		_m_size = other._m_size;
+		_m_final_size = other._m_final_size;
+		_m_platform_handle = other._m_platform_handle;
+
+		other._m_data = nullptr;
+		other._m_size = 0;
+		other._m_final_size = 0;
+		other._m_platform_handle = nullptr;
+	}
+
+	MutableMmap::~MutableMmap() noexcept {
+		auto* platform = static_cast<MutableMmapPlatform*>(_m_platform_handle);
+		if (platform == nullptr) return;
+
+		if (_m_data != nullptr) {
+			munmap(_m_data, _m_size);
+		}
+
+		(void) ftruncate(platform->fd, static_cast<off_t>(_m_final_size));
+		close(platform->fd);
+		delete platform;
+
+		_m_data = nullptr;
+		_m_size = 0;
+		_m_platform_handle = nullptr;
+	}
+
+	void MutableMmap::resize(std::size_t size) {
+		auto* platform = static_cast<MutableMmapPlatform*>(_m_platform_handle);
+		if (size <= _m_size) return;
+
+		if (ftruncate(platform->fd, static_cast<off_t>(size)) != 0) {
+			throw std::runtime_error {"Failed to resize " + platform->path};
+		}
+
+		if (_m_data != nullptr) {
+			munmap(_m_data, _m_size);
+			_m_data = nullptr;
+			_m_size = 0;
+		}
+
+		auto* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, platform->fd, 0);
+		if (data == MAP_FAILED) {
+			throw std::runtime_error {"Failed to mmap " + platform->path};
+		}
+
+		_m_data = static_cast<std::byte*>(data);
+		_m_size = size;
+	}
+
+	void MutableMmap::sync() noexcept {
+		if (_m_data != nullptr) {
+			msync(_m_data, _m_size, MS_SYNC);
+		}
+	}
 } // namespace zenkit
@@ -2,6 +2,10 @@
 // SPDX-License-Identifier: MIT
 #include "zenkit/Mmap.hh"
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
 #include <windows.h>
 
 namespace zenkit {
@@ -60,4 +64,134 @@ namespace zenkit {
 			_m_platform_handle = nullptr;
 		}
 	}
+
+	void Mmap::prefetch(std::size_t offset, std::size_t len) const noexcept {
+		if (_m_data == nullptr || offset >= _m_size) return;
+
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+		WIN32_MEMORY_RANGE_ENTRY entry;
+		entry.VirtualAddress = (PVOID) (_m_data + offset);
+		entry.NumberOfBytes = std::min(len, _m_size - offset);
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+#else
+		(void) len;
+#endif
+	}
+
+	void Mmap::advise_sequential() const noexcept {
+		// There is no equivalent to MADV_SEQUENTIAL for mapped views. Sequential access is already
+		// detected by the memory manager.
+	}
+
+	struct MutablePlatform {
+		HANDLE hFile;
+		HANDLE hFileMapping;
+		std::string path;
+	};
+
+	MutableMmap::MutableMmap(std::filesystem::path const& path, std::size_t initial_size) {
+		HANDLE hFile = CreateFileW(path.c_str(),
+		                           GENERIC_READ | GENERIC_WRITE,
+		                           0,
+		                           nullptr,
+		                           CREATE_ALWAYS,
+		                           FILE_ATTRIBUTE_NORMAL,
+		                           nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error {"Failed to open " + path.string()};
+		}
+
+		try {
+			_m_platform_handle = new MutablePlatform {hFile, nullptr, path.string()};
+			this->resize(initial_size);
+		} catch (...) {
+			// The destructor does not run if the constructor throws, so the handles have to be closed here.
+			auto* platform = reinterpret_cast<MutablePlatform*>(_m_platform_handle);
+			if (platform != nullptr && platform->hFileMapping != nullptr) {
+				CloseHandle(platform->hFileMapping);
+			}
+
+			CloseHandle(hFile);
+			delete platform;
+			_m_platform_handle = nullptr;
+			throw;
+		}
+
+		_m_final_size = _m_size;
+	}
+
+	MutableMmap::MutableMmap(MutableMmap&& other) noexcept {
+		_m_data = other._m_data;
+		_m_size = other._m_size;
+		_m_final_size = other._m_final_size;
+		_m_platform_handle = other._m_platform_handle;
+
+		other._m_data = nullptr;
+		other._m_size = 0;
+		other._m_final_size = 0;
+		other._m_platform_handle = nullptr;
+	}
+
+	MutableMmap::~MutableMmap() noexcept {
+		auto* platform = reinterpret_cast<MutablePlatform*>(_m_platform_handle);
+		if (platform == nullptr) return;
+
+		if (_m_data != nullptr) {
+			UnmapViewOfFile(_m_data);
+		}
+
+		if (platform->hFileMapping != nullptr) {
+			CloseHandle(platform->hFileMapping);
+		}
+
+		LARGE_INTEGER end;
+		end.QuadPart = static_cast<LONGLONG>(_m_final_size);
+		SetFilePointerEx(platform->hFile, end, nullptr, FILE_BEGIN);
+		SetEndOfFile(platform->hFile);
+
+		CloseHandle(platform->hFile);
+		delete platform;
+
+		_m_data = nullptr;
+		_m_size = 0;
+		_m_platform_handle = nullptr;
+	}
+
+	void MutableMmap::resize(std::size_t size) {
+		auto* platform = reinterpret_cast<MutablePlatform*>(_m_platform_handle);
+		if (size <= _m_size) return;
+
+		if (_m_data != nullptr) {
+			UnmapViewOfFile(_m_data);
+			CloseHandle(platform->hFileMapping);
+
+			_m_data = nullptr;
+			_m_size = 0;
+			platform->hFileMapping = nullptr;
+		}
+
+		auto size64 = static_cast<std::uint64_t>(size);
+		platform->hFileMapping = CreateFileMappingA(platform->hFile,
+		                                            nullptr,
+		                                            PAGE_READWRITE,
+		                                            static_cast<DWORD>(size64 >> 32),
+		                                            static_cast<DWORD>(size64 & 0xFFFFFFFF),
+		                                            nullptr);
+		if (platform->hFileMapping == nullptr) {
+			throw std::runtime_error {"Failed to memory-map " + platform->path};
+		}
+
+		_m_data = static_cast<std::byte*>(MapViewOfFile(platform->hFileMapping, FILE_MAP_WRITE, 0, 0, 0));
+		if (_m_data == nullptr) {
+			throw std::runtime_error {"Failed to memory-map " + platform->path};
+		}
+
+		_m_size = size;
+	}
+
+	void MutableMmap::sync() noexcept {
+		if (_m_data != nullptr) {
+			FlushViewOfFile(_m_data, 0);
+		}
+	}
 } // namespace zenkit
@@ -5,8 +5,12 @@
 
 namespace zenkit {
 	void Model::load(Read* r) {
+		this->load(r, MultiResolutionMeshLoadOptions {});
+	}
+
+	void Model::load(Read* r, MultiResolutionMeshLoadOptions const& options) {
 		this->hierarchy.load(r);
-		this->mesh.load(r);
+		this->mesh.load(r, options);
 	}
 
 	void Model::save(Write* w, GameVersion version) const {
@@ -1,8 +1,12 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include "zenkit/ModelAnimation.hh"
+#include "zenkit/ModelHierarchy.hh"
 #include "zenkit/Stream.hh"
 
+#include "Internal.hh"
+
+#include <algorithm>
 #include <math.h>
 
 namespace zenkit {
@@ -23,52 +27,113 @@ namespace zenkit {
 		SAMPLES = 0xa090u,
 	};
 
-	/// \brief Reads the position of a single animation sample from the given buffer.
-	/// \param r The stream to read from.
+	/// \brief Reads a single quantized animation sample from the given buffer.
+	/// \param r The stream or span to read from.
+	/// \return The sample as it is stored.
+	/// \see http://phoenix.gothickit.dev/engine/formats/animation/#samples
+	template <typename R>
+	static QuantizedAnimationSample read_sample(R* r) {
+		QuantizedAnimationSample v {};
+		v.rotation[0] = r->read_ushort();
+		v.rotation[1] = r->read_ushort();
+		v.rotation[2] = r->read_ushort();
+		v.position[0] = r->read_ushort();
+		v.position[1] = r->read_ushort();
+		v.position[2] = r->read_ushort();
+		return v;
+	}
+
+	/// \brief Reads all samples of an animation from the given buffer.
+	/// \param r The stream or span to read from.
+	/// \param out The samples to fill.
 	/// \param scale The scaling factor to apply (taken from the animation's header).
 	/// \param minimum The value of the smallest position component in the animation (part of its header).
-	/// \return A vector containing the parsed position.
-	/// \see http://phoenix.gothickit.dev/engine/formats/animation/#sample-positions
-	static Vec3 read_sample_position(Read* r, float scale, float minimum) {
-		Vec3 v {};
-		v.x = static_cast<float>(r->read_ushort()) * scale + minimum;
-		v.y = static_cast<float>(r->read_ushort()) * scale + minimum;
-		v.z = static_cast<float>(r->read_ushort()) * scale + minimum;
-		return v;
+	template <typename R>
+	static void read_samples(R* r, std::vector<AnimationSample>& out, float scale, float minimum) {
+		for (auto& i : out) {
+			i = read_sample(r).decode(scale, minimum);
+		}
+	}
+
+	template <typename R>
+	static void read_samples(R* r, std::vector<QuantizedAnimationSample>& out, float, float) {
+		for (auto& i : out) {
+			i = read_sample(r);
+		}
 	}
 
-	/// \brief Reads the rotation of a single animation sample from the given buffer.
-	/// \param r The stream to read from.
-	/// \return A quaternion containing the parsed rotation.
-	/// \see http://phoenix.gothickit.dev/engine/formats/animation/#sample-rotations
-	static Quat read_sample_quaternion(Read* r) {
-		Quat v {};
-		v.x = (static_cast<float>(r->read_ushort()) - SAMPLE_ROTATION_MID) * SAMPLE_ROTATION_SCALE;
-		v.y = (static_cast<float>(r->read_ushort()) - SAMPLE_ROTATION_MID) * SAMPLE_ROTATION_SCALE;
-		v.z = (static_cast<float>(r->read_ushort()) - SAMPLE_ROTATION_MID) * SAMPLE_ROTATION_SCALE;
+	/// \brief Reads all samples of an animation from the given stream.
+	/// \see read_samples
+	template <typename T>
+	static void load_samples(Read* r, std::vector<T>& out, float scale, float minimum) {
+		// Each sample is stored as six 16-bit integers. If the stream is memory-backed, we can avoid going
+		// through the virtual Read interface for every single one of them.
+		if (auto span = r->as_contiguous(); span.size() >= out.size() * 12) {
+			read_samples(&span, out, scale, minimum);
+			r->seek(static_cast<ssize_t>(span.tell()), Whence::CUR);
+		} else {
+			read_samples(r, out, scale, minimum);
+		}
+	}
 
-		float len_q = v.x * v.x + v.y * v.y + v.z * v.z;
+	/// \brief Decodes a contiguous range of quantized samples.
+	///
+	/// <p>This is a plain loop over the packed samples without any virtual calls, which is fast enough to be run
+	/// during playback.</p>
+	static void decode_samples(QuantizedAnimationSample const* in,
+	                           std::size_t count,
+	                           AnimationSample* out,
+	                           float scale,
+	                           float minimum) noexcept {
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = in[i].decode(scale, minimum);
+		}
+	}
+
+	bool AnimationSample::operator==(AnimationSample const& other) const noexcept {
+		return this->position == other.position && this->rotation == other.rotation;
+	}
+
+	AnimationSample QuantizedAnimationSample::decode(float scale, float minimum) const noexcept {
+		AnimationSample v {};
+		v.position.x = static_cast<float>(this->position[0]) * scale + minimum;
+		v.position.y = static_cast<float>(this->position[1]) * scale + minimum;
+		v.position.z = static_cast<float>(this->position[2]) * scale + minimum;
+
+		auto& q = v.rotation;
+		q.x = (static_cast<float>(this->rotation[0]) - SAMPLE_ROTATION_MID) * SAMPLE_ROTATION_SCALE;
+		q.y = (static_cast<float>(this->rotation[1]) - SAMPLE_ROTATION_MID) * SAMPLE_ROTATION_SCALE;
+		q.z = (static_cast<float>(this->rotation[2]) - SAMPLE_ROTATION_MID) * SAMPLE_ROTATION_SCALE;
+
+		float len_q = q.x * q.x + q.y * q.y + q.z * q.z;
 
 		if (len_q > 1.0f) {
 			float l = 1.0f / sqrtf(len_q);
-			v.x *= l;
-			v.y *= l;
-			v.z *= l;
-			v.w = 0;
+			q.x *= l;
+			q.y *= l;
+			q.z *= l;
+			q.w = 0;
 		} else {
 			// We know the quaternion has to be a unit quaternion, so we can calculate the missing value.
-			v.w = sqrtf(1.0f - len_q);
+			q.w = sqrtf(1.0f - len_q);
 		}
 
 		return v;
 	}
 
-	bool AnimationSample::operator==(AnimationSample const& other) const noexcept {
-		return this->position == other.position && this->rotation == other.rotation;
+	void ModelAnimation::load(Read* r) {
+		this->load(r, ModelAnimationLoadOptions {});
 	}
 
-	void ModelAnimation::load(Read* r) {
-		proto::read_chunked<AnimationChunkType>(r, "ModelAnimation", [this](Read* c, AnimationChunkType type) {
+	void ModelAnimation::load(Read* r, ModelAnimationLoadOptions const& options) {
+		ZKTRACE_ZONE(zone, "ModelAnimation.load");
+		MemoryScope memory {MemoryCategory::ANIMATION};
+		auto begin = r->tell();
+
+		// The cached mapping was built from the node indices of the previous contents.
+		std::atomic_store(&this->_m_node_remap, std::shared_ptr<AnimationNodeRemap const> {});
+
+		proto::read_chunked<AnimationChunkType>(r, "ModelAnimation", [&](Read* c, AnimationChunkType type) {
 			switch (type) {
 			case AnimationChunkType::MARKER:
 				break;
@@ -110,19 +175,24 @@ namespace zenkit {
 					event.probability = c->read_float();
 				}
 
+				this->index_events();
+
 				break;
 			case AnimationChunkType::SAMPLES:
 				this->checksum = c->read_uint();
 
 				this->node_indices.resize(this->node_count);
-				for (auto& i : this->node_indices) {
-					i = c->read_uint();
-				}
+				c->read_uint_array(this->node_indices.data(), this->node_indices.size());
 
-				this->samples.resize(this->node_count * this->frame_count);
-				for (auto& i : this->samples) {
-					i.rotation = read_sample_quaternion(c);
-					i.position = read_sample_position(c, this->sample_position_scale, this->sample_position_min);
+				this->samples.clear();
+				this->quantized_samples.clear();
+
+				if (options.compact) {
+					this->quantized_samples.resize(this->node_count * this->frame_count);
+					load_samples(c, this->quantized_samples, this->sample_position_scale, this->sample_position_min);
+				} else {
+					this->samples.resize(this->node_count * this->frame_count);
+					load_samples(c, this->samples, this->sample_position_scale, this->sample_position_min);
 				}
 
 				break;
@@ -132,5 +202,254 @@ namespace zenkit {
 
 			return false;
 		});
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+	}
+
+	bool ModelAnimation::decode_frame(std::uint32_t frame, AnimationSample* out) const noexcept {
+		if (frame >= this->frame_count) return false;
+
+		auto offset = static_cast<std::size_t>(frame) * this->node_count;
+		if (this->is_compact()) {
+			if (offset + this->node_count > this->quantized_samples.size()) return false;
+			decode_samples(this->quantized_samples.data() + offset,
+			               this->node_count,
+			               out,
+			               this->sample_position_scale,
+			               this->sample_position_min);
+		} else {
+			if (offset + this->node_count > this->samples.size()) return false;
+			std::copy_n(this->samples.begin() + static_cast<std::ptrdiff_t>(offset), this->node_count, out);
+		}
+
+		return true;
+	}
+
+	AnimationSample ModelAnimation::sample(std::uint32_t frame, std::uint32_t node) const noexcept {
+		if (frame >= this->frame_count || node >= this->node_count) return {};
+
+		auto index = static_cast<std::size_t>(frame) * this->node_count + node;
+		if (index < this->quantized_samples.size()) {
+			return this->quantized_samples[index].decode(this->sample_position_scale, this->sample_position_min);
+		}
+
+		return index < this->samples.size() ? this->samples[index] : AnimationSample {};
+	}
+
+	void ModelAnimation::sample_pose(float time, AnimationSample* out, bool loop) const noexcept {
+		if (this->frame_count == 0 || this->node_count == 0) return;
+
+		auto frame = this->fps > 0 ? time * this->fps : 0.0f;
+		auto last = static_cast<float>(this->frame_count - 1);
+		if (loop) {
+			frame = fmodf(frame, static_cast<float>(this->frame_count));
+			if (frame < 0) frame += static_cast<float>(this->frame_count);
+		} else {
+			frame = std::clamp(frame, 0.0f, last);
+		}
+
+		auto f0 = std::min(static_cast<std::uint32_t>(frame), this->frame_count - 1);
+		auto f1 = f0 + 1 < this->frame_count ? f0 + 1 : (loop ? 0 : f0);
+		auto t = frame - static_cast<float>(f0);
+
+		for (auto i = 0u; i < this->node_count; ++i) {
+			auto a = this->sample(f0, i);
+			auto b = this->sample(f1, i);
+			blend_poses(&a, &b, 1, t, out + i);
+		}
+	}
+
+	void ModelAnimation::apply_layer(float time,
+	                                 float weight,
+	                                 AnimationSample* pose,
+	                                 std::size_t pose_size,
+	                                 bool loop) const noexcept {
+		this->apply_layer(time, weight, pose, pose_size, this->node_indices.data(), this->node_indices.size(), loop);
+	}
+
+	void ModelAnimation::apply_layer(float time,
+	                                 float weight,
+	                                 AnimationSample* pose,
+	                                 std::size_t pose_size,
+	                                 AnimationNodeRemap const& remap,
+	                                 bool loop) const noexcept {
+		this->apply_layer(time, weight, pose, pose_size, remap.nodes.data(), remap.nodes.size(), loop);
+	}
+
+	void ModelAnimation::apply_layer(float time,
+	                                 float weight,
+	                                 AnimationSample* pose,
+	                                 std::size_t pose_size,
+	                                 std::uint32_t const* nodes,
+	                                 std::size_t node_count,
+	                                 bool loop) const noexcept {
+		if (this->frame_count == 0 || this->node_count == 0 || weight <= 0) return;
+
+		// Animations rarely animate more than a few dozen nodes, so the samples usually fit on the stack.
+		constexpr std::uint32_t batch = 64;
+		AnimationSample samples[batch];
+
+		std::vector<AnimationSample> heap;
+		AnimationSample* local = samples;
+		if (this->node_count > batch) {
+			heap.resize(this->node_count);
+			local = heap.data();
+		}
+
+		this->sample_pose(time, local, loop);
+
+		weight = std::min(weight, 1.0f);
+		for (auto i = 0u; i < this->node_count && i < node_count; ++i) {
+			auto node = nodes[i];
+			if (node >= pose_size) continue;
+			blend_poses(pose + node, local + i, 1, weight, pose + node);
+		}
+	}
+
+	std::shared_ptr<AnimationNodeRemap const> ModelAnimation::remap_nodes(ModelHierarchy const& source,
+	                                                                      ModelHierarchy const& target) const {
+		// Hierarchies built in code usually don't have a checksum, so they can't be told apart.
+		auto cacheable = source.checksum != 0 && target.checksum != 0;
+
+		auto cached = std::atomic_load(&this->_m_node_remap);
+		if (cacheable && cached != nullptr && cached->source_checksum == source.checksum &&
+		    cached->target_checksum == target.checksum) {
+			return cached;
+		}
+
+		auto remap = std::make_shared<AnimationNodeRemap>();
+		remap->source_checksum = source.checksum;
+		remap->target_checksum = target.checksum;
+		remap->nodes.resize(this->node_indices.size(), AnimationNodeRemap::NONE);
+
+		for (auto i = 0u; i < this->node_indices.size(); ++i) {
+			auto node = this->node_indices[i];
+			if (node >= source.nodes.size()) continue;
+
+			auto index = target.find_node(source.nodes[node].name);
+			if (index) remap->nodes[i] = *index;
+		}
+
+		// If multiple threads remap at once, each builds its own mapping and the last one is kept.
+		std::shared_ptr<AnimationNodeRemap const> result = std::move(remap);
+		if (cacheable) std::atomic_store(&this->_m_node_remap, result);
+		return result;
+	}
+
+	void ModelAnimation::blend_poses(AnimationSample const* a,
+	                                 AnimationSample const* b,
+	                                 std::size_t count,
+	                                 float weight,
+	                                 AnimationSample* out) noexcept {
+		auto wa = 1.0f - weight;
+
+		for (std::size_t i = 0; i < count; ++i) {
+			auto const& pa = a[i].position;
+			auto const& pb = b[i].position;
+			auto const& qa = a[i].rotation;
+			auto const& qb = b[i].rotation;
+
+			// Interpolate along the shorter arc.
+			auto dot = qa.w * qb.w + qa.x * qb.x + qa.y * qb.y + qa.z * qb.z;
+			auto wb = dot < 0 ? -weight : weight;
+
+			Quat q {
+			    qa.w * wa + qb.w * wb,
+			    qa.x * wa + qb.x * wb,
+			    qa.y * wa + qb.y * wb,
+			    qa.z * wa + qb.z * wb,
+			};
+
+			auto len = sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+			if (len > 0) {
+				auto l = 1.0f / len;
+				q = Quat {q.w * l, q.x * l, q.y * l, q.z * l};
+			}
+
+			out[i].position = Vec3 {
+			    pa.x * wa + pb.x * weight,
+			    pa.y * wa + pb.y * weight,
+			    pa.z * wa + pb.z * weight,
+			};
+			out[i].rotation = q;
+		}
+	}
+
+	AnimationBinding::AnimationBinding(ModelAnimation const& animation, ModelHierarchy const& target)
+	    : _m_animation(&animation), _m_channels(target.nodes.size(), NONE) {
+		if (animation.checksum != target.checksum) {
+			ZKLOGW("AnimationBinding",
+			       "Animation \"%s\" was not made for the given hierarchy (checksum %u != %u)",
+			       animation.name.c_str(),
+			       animation.checksum,
+			       target.checksum);
+			return;
+		}
+
+		this->bind(animation.node_indices.data(), animation.node_indices.size());
+	}
+
+	AnimationBinding::AnimationBinding(ModelAnimation const& animation,
+	                                   ModelHierarchy const& source,
+	                                   ModelHierarchy const& target)
+	    : _m_animation(&animation), _m_channels(target.nodes.size(), NONE) {
+		if (animation.checksum == target.checksum) {
+			this->bind(animation.node_indices.data(), animation.node_indices.size());
+			return;
+		}
+
+		if (animation.checksum != source.checksum) {
+			ZKLOGW("AnimationBinding",
+			       "Animation \"%s\" was not made for the given source hierarchy (checksum %u != %u)",
+			       animation.name.c_str(),
+			       animation.checksum,
+			       source.checksum);
+		}
+
+		auto remap = animation.remap_nodes(source, target);
+		this->bind(remap->nodes.data(), remap->nodes.size());
+	}
+
+	void AnimationBinding::bind(std::uint32_t const* nodes, std::size_t count) {
+		count = std::min<std::size_t>(count, _m_animation->node_count);
+
+		for (auto i = 0u; i < count; ++i) {
+			auto node = nodes[i];
+			if (node >= _m_channels.size() || _m_channels[node] != NONE) continue;
+
+			_m_channels[node] = i;
+			++_m_bound_node_count;
+		}
+	}
+
+	void AnimationBinding::apply_layer(float time, float weight, AnimationSample* pose, bool loop) const noexcept {
+		if (_m_bound_node_count == 0 || weight <= 0) return;
+
+		auto const& animation = *_m_animation;
+		if (animation.frame_count == 0 || animation.node_count == 0) return;
+
+		constexpr std::uint32_t batch = 64;
+		AnimationSample samples[batch];
+
+		std::vector<AnimationSample> heap;
+		AnimationSample* local = samples;
+		if (animation.node_count > batch) {
+			heap.resize(animation.node_count);
+			local = heap.data();
+		}
+
+		animation.sample_pose(time, local, loop);
+
+		weight = std::min(weight, 1.0f);
+		for (auto i = 0u; i < _m_channels.size(); ++i) {
+			auto channel = _m_channels[i];
+			if (channel == NONE) continue;
+
+			if (weight >= 1) {
+				pose[i] = local[channel];
+			} else {
+				ModelAnimation::blend_poses(pose + i, local + channel, 1, weight, pose + i);
+			}
+		}
 	}
 } // namespace zenkit
@@ -1,10 +1,14 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include "zenkit/ModelHierarchy.hh"
+#include "zenkit/ModelAnimation.hh"
 #include "zenkit/Stream.hh"
 
 #include "Internal.hh"
 
+#include <algorithm>
+#include <cmath>
+
 namespace zenkit {
 	enum class ModelHierarchyChunkType : std::uint16_t {
 		HIERARCHY = 0xD100,
@@ -12,7 +16,59 @@ namespace zenkit {
 		END = 0xD120,
 	};
 
+	/// \brief Computes the order in which the transforms of the given nodes can be evaluated.
+	/// \param nodes The nodes.
+	/// \param order Receives the indices of the nodes so that each parent comes before its children.
+	static void compute_order(std::vector<ModelHierarchyNode> const& nodes, std::vector<std::uint16_t>& order) {
+		auto count = nodes.size();
+		auto parent_of = [&nodes, count](std::size_t i) -> std::size_t {
+			auto parent = nodes[i].parent_index;
+			return parent < 0 || static_cast<std::size_t>(parent) >= count || static_cast<std::size_t>(parent) == i
+			    ? count
+			    : static_cast<std::size_t>(parent);
+		};
+
+		// Hierarchies are usually stored in order already, so a stable breadth-first walk from the roots keeps
+		// the memory access pattern of the evaluation linear.
+		std::vector<std::uint32_t> offsets(count + 2, 0);
+		for (auto i = 0u; i < count; ++i) {
+			++offsets[parent_of(i) + 1];
+		}
+
+		for (auto i = 0u; i <= count; ++i) {
+			offsets[i + 1] += offsets[i];
+		}
+
+		std::vector<std::uint16_t> children(count);
+		std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (auto i = 0u; i < count; ++i) {
+			children[fill[parent_of(i)]++] = static_cast<std::uint16_t>(i);
+		}
+
+		order.clear();
+		order.reserve(count);
+		order.insert(order.end(), children.begin() + offsets[count], children.begin() + offsets[count + 1]);
+
+		for (auto i = 0u; i < order.size(); ++i) {
+			auto node = order[i];
+			order.insert(order.end(), children.begin() + offsets[node], children.begin() + offsets[node + 1]);
+		}
+
+		// Nodes which are part of a cycle are never reached from a root. They are appended as roots.
+		if (order.size() != count) {
+			std::vector<bool> seen(count, false);
+			for (auto node : order) {
+				seen[node] = true;
+			}
+
+			for (auto i = 0u; i < count; ++i) {
+				if (!seen[i]) order.push_back(static_cast<std::uint16_t>(i));
+			}
+		}
+	}
+
 	void ModelHierarchy::load(Read* r) {
+		MemoryScope memory {MemoryCategory::MESH};
 		proto::read_chunked<ModelHierarchyChunkType>( //
 		    r,
 		    "ModelHierarchy",
@@ -48,6 +104,9 @@ namespace zenkit {
 
 			    return false;
 		    });
+
+		this->build_evaluation_order();
+		this->build_node_index();
 	}
 
 	void ModelHierarchy::save(Write* w) const {
@@ -74,4 +133,110 @@ namespace zenkit {
 
 		proto::write_chunk(w, ModelHierarchyChunkType::END, [](Write*) {});
 	}
+
+	void ModelHierarchy::build_node_index() {
+		this->_m_node_names.clear();
+		this->_m_node_names.reserve(this->nodes.size());
+		for (auto i = 0u; i < this->nodes.size(); ++i) {
+			this->_m_node_names.emplace_back(ihash(this->nodes[i].name), i);
+		}
+
+		std::sort(this->_m_node_names.begin(), this->_m_node_names.end());
+	}
+
+	std::optional<std::uint32_t> ModelHierarchy::find_node(std::string_view name) const noexcept {
+		if (this->_m_node_names.size() != this->nodes.size()) {
+			for (auto i = 0u; i < this->nodes.size(); ++i) {
+				if (iequals(this->nodes[i].name, name)) return i;
+			}
+
+			return std::nullopt;
+		}
+
+		auto hash = ihash(name);
+		auto it = std::lower_bound(this->_m_node_names.begin(),
+		                           this->_m_node_names.end(),
+		                           std::pair<std::uint64_t, std::uint32_t> {hash, 0});
+
+		for (; it != this->_m_node_names.end() && it->first == hash; ++it) {
+			if (it->second < this->nodes.size() && iequals(this->nodes[it->second].name, name)) return it->second;
+		}
+
+		return std::nullopt;
+	}
+
+	void ModelHierarchy::build_evaluation_order() {
+		compute_order(this->nodes, this->evaluation_order);
+	}
+
+	void ModelHierarchy::compute_rest_pose(AnimationSample* out) const noexcept {
+		for (auto i = 0u; i < this->nodes.size(); ++i) {
+			auto const& m = this->nodes[i].transform;
+			auto& q = out[i].rotation;
+
+			// Extract the rotation from the upper 3x3 part of the matrix, choosing the largest component first to
+			// stay numerically stable.
+			auto m00 = m[0][0], m11 = m[1][1], m22 = m[2][2];
+			auto trace = m00 + m11 + m22;
+
+			if (trace > 0) {
+				auto s = std::sqrt(trace + 1.0f) * 2;
+				q = Quat {s / 4, (m[1][2] - m[2][1]) / s, (m[2][0] - m[0][2]) / s, (m[0][1] - m[1][0]) / s};
+			} else if (m00 > m11 && m00 > m22) {
+				auto s = std::sqrt(1.0f + m00 - m11 - m22) * 2;
+				q = Quat {(m[1][2] - m[2][1]) / s, s / 4, (m[1][0] + m[0][1]) / s, (m[2][0] + m[0][2]) / s};
+			} else if (m11 > m22) {
+				auto s = std::sqrt(1.0f + m11 - m00 - m22) * 2;
+				q = Quat {(m[2][0] - m[0][2]) / s, (m[1][0] + m[0][1]) / s, s / 4, (m[2][1] + m[1][2]) / s};
+			} else {
+				auto s = std::sqrt(1.0f + m22 - m00 - m11) * 2;
+				q = Quat {(m[0][1] - m[1][0]) / s, (m[2][0] + m[0][2]) / s, (m[2][1] + m[1][2]) / s, s / 4};
+			}
+
+			out[i].position = Vec3 {m[3][0], m[3][1], m[3][2]};
+		}
+	}
+
+	void ModelHierarchy::compute_local_transforms(AnimationSample const* pose, Mat3x4* out) const noexcept {
+		for (auto i = 0u; i < this->nodes.size(); ++i) {
+			auto const& q = pose[i].rotation;
+			auto const& p = pose[i].position;
+
+			auto xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+			auto xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+			auto wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+			out[i] = Mat3x4 {
+			    Vec4 {1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy), p.x},
+			    Vec4 {2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx), p.y},
+			    Vec4 {2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy), p.z},
+			};
+		}
+	}
+
+	void ModelHierarchy::compute_world_transforms(Mat3x4 const* local, Mat3x4* out) const {
+		auto count = this->nodes.size();
+
+		std::vector<std::uint16_t> temporary;
+		auto const* order = &this->evaluation_order;
+		if (order->size() != count) {
+			compute_order(this->nodes, temporary);
+			order = &temporary;
+		}
+
+		for (auto node : *order) {
+			auto parent = this->nodes[node].parent_index;
+			if (parent < 0 || static_cast<std::size_t>(parent) >= count || parent == node) {
+				out[node] = local[node];
+			} else {
+				out[node] = out[parent] * local[node];
+			}
+		}
+	}
+
+	void ModelHierarchy::compute_world_transforms(AnimationSample const* pose, Mat3x4* out) const {
+		std::vector<Mat3x4> local(this->nodes.size());
+		this->compute_local_transforms(pose, local.data());
+		this->compute_world_transforms(local.data(), out);
+	}
 } // namespace zenkit
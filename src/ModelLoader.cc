@@ -0,0 +1,157 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/ModelLoader.hh"
+#include "zenkit/Executor.hh"
+#include "zenkit/Stream.hh"
+#include "zenkit/Vfs.hh"
+
+#include "Internal.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace zenkit {
+	/// \brief Replaces the extension of a file name and converts it to upper case, which is used as the key of
+	///        all caches of the loader.
+	static std::string file_name(std::string_view name, std::string_view extension) {
+		auto dot = name.rfind('.');
+		if (dot != std::string_view::npos) name = name.substr(0, dot);
+
+		std::string result {name};
+		result += extension;
+
+		std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+			return static_cast<char>(std::toupper(c));
+		});
+		return result;
+	}
+
+	template <typename T, typename... Args>
+	static std::shared_ptr<T const> load_file(Vfs const& vfs, std::string const& name, Args const&... args) {
+		auto node = vfs.find(name);
+		if (node == nullptr) {
+			ZKLOGD("ModelLoader", "File not found: %s", name.c_str());
+			return nullptr;
+		}
+
+		try {
+			auto r = node->open_read();
+			auto value = std::make_shared<T>();
+			value->load(r.get(), args...);
+			return value;
+		} catch (std::exception const& e) {
+			ZKLOGW("ModelLoader", "Failed to load %s: %s", name.c_str(), e.what());
+			return nullptr;
+		}
+	}
+
+	/// \brief Returns the cached value for the given file or loads it. Files which could not be loaded are cached
+	///        as well, so they are not looked up again.
+	template <typename T, typename Load>
+	static std::shared_ptr<T const> load_cached(std::mutex& lock,
+	                                            std::unordered_map<std::string, std::shared_ptr<T const>>& cache,
+	                                            std::string const& name,
+	                                            Load const& load) {
+		{
+			std::lock_guard guard {lock};
+			auto it = cache.find(name);
+			if (it != cache.end()) return it->second;
+		}
+
+		// Loading happens without holding the lock. If two threads load the same file at once, the first one to
+		// finish wins and both get the same instance.
+		std::shared_ptr<T const> value = load(name);
+
+		std::lock_guard guard {lock};
+		return cache.emplace(name, std::move(value)).first->second;
+	}
+
+	ModelLoader::ModelLoader(Vfs const& vfs, ModelLoaderOptions const& options) : _m_vfs(&vfs), _m_options(options) {}
+
+	LoadedModel ModelLoader::load(std::string_view name) {
+		auto& vfs = *_m_vfs;
+		LoadedModel model {};
+
+		model.script = load_cached(_m_lock, _m_scripts, file_name(name, ".MSB"), [&](std::string const& msb) {
+			auto script = load_file<ModelScript>(vfs, msb);
+			return script != nullptr ? script : load_file<ModelScript>(vfs, file_name(name, ".MDS"));
+		});
+
+		if (model.script == nullptr) return model;
+		auto const& script = *model.script;
+
+		std::vector<std::function<void()>> tasks;
+
+		// The hierarchy and the skeleton mesh may both come from the same MDL file, so they are loaded together.
+		tasks.emplace_back([&] {
+			auto mdl = [&] {
+				return load_cached(_m_lock, _m_models, file_name(name, ".MDL"), [&](std::string const& n) {
+					return load_file<Model>(vfs, n, _m_options.mesh);
+				});
+			};
+
+			model.hierarchy =
+			    load_cached(_m_lock, _m_hierarchies, file_name(name, ".MDH"), [&](std::string const& n) {
+				    auto hierarchy = load_file<ModelHierarchy>(vfs, n);
+				    if (hierarchy != nullptr) return hierarchy;
+
+				    auto fallback = mdl();
+				    return fallback != nullptr ? std::shared_ptr<ModelHierarchy const> {fallback, &fallback->hierarchy}
+				                               : nullptr;
+			    });
+
+			if (script.skeleton.disable_mesh || script.skeleton.name.empty()) return;
+			model.mesh = load_cached(_m_lock,
+			                         _m_meshes,
+			                         file_name(script.skeleton.name, ".MDM"),
+			                         [&](std::string const& n) {
+				                         auto mesh = load_file<ModelMesh>(vfs, n, _m_options.mesh);
+				                         if (mesh != nullptr) return mesh;
+
+				                         auto fallback = mdl();
+				                         return fallback != nullptr
+				                             ? std::shared_ptr<ModelMesh const> {fallback, &fallback->mesh}
+				                             : nullptr;
+			                         });
+		});
+
+		model.meshes.resize(script.meshes.size());
+		for (auto i = 0u; i < script.meshes.size(); ++i) {
+			tasks.emplace_back([&, i] {
+				model.meshes[i] =
+				    load_cached(_m_lock, _m_meshes, file_name(script.meshes[i], ".MDM"), [&](std::string const& n) {
+					    return load_file<ModelMesh>(vfs, n, _m_options.mesh);
+				    });
+			});
+		}
+
+		if (_m_options.load_animations) {
+			auto prefix = file_name(name, "-");
+			model.animations.resize(script.animations.size());
+
+			for (auto i = 0u; i < script.animations.size(); ++i) {
+				// The tasks run after this block, so the prefix has to be copied into them.
+				tasks.emplace_back([&, i, prefix] {
+					auto man = file_name(prefix + script.animations[i].name, ".MAN");
+					model.animations[i] = load_cached(_m_lock, _m_animations, man, [&](std::string const& n) {
+						return load_file<ModelAnimation>(vfs, n, _m_options.animation);
+					});
+				});
+			}
+		}
+
+		parallel_for(tasks.size(), [&](std::size_t i) { tasks[i](); }, _m_options.thread_count);
+
+		return model;
+	}
+
+	void ModelLoader::clear() {
+		std::lock_guard guard {_m_lock};
+		_m_scripts.clear();
+		_m_hierarchies.clear();
+		_m_meshes.clear();
+		_m_animations.clear();
+		_m_models.clear();
+	}
+} // namespace zenkit
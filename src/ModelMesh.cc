@@ -4,6 +4,8 @@
 #include "zenkit/Date.hh"
 #include "zenkit/Stream.hh"
 
+#include "Internal.hh"
+
 namespace zenkit {
 	static constexpr uint32_t VERSION_G1 = 0x04030506;
 	static constexpr uint32_t VERSION_G2 = 0x04030506;
@@ -18,11 +20,19 @@ namespace zenkit {
 	};
 
 	void ModelMesh::load(Read* r) {
+		this->load(r, MultiResolutionMeshLoadOptions {});
+	}
+
+	void ModelMesh::load(Read* r, MultiResolutionMeshLoadOptions const& options) {
+		ZKTRACE_ZONE(zone, "ModelMesh.load");
+		MemoryScope memory {MemoryCategory::MESH};
+		auto begin = r->tell();
+
 		std::vector<std::string> attachment_names {};
 		proto::read_chunked<ModelMeshChunkType>(
 		    r,
 		    "ModelMesh",
-		    [this, &attachment_names](Read* c, ModelMeshChunkType type, size_t& end) {
+		    [this, &attachment_names, &options](Read* c, ModelMeshChunkType type, size_t& end) {
 			    switch (type) {
 			    case ModelMeshChunkType::HEADER:
 				    (void) /* version = */ c->read_uint();
@@ -44,7 +54,7 @@ namespace zenkit {
 				    break;
 			    }
 			    case ModelMeshChunkType::PROTO:
-				    this->attachments[attachment_names[this->attachments.size()]].load_from_section(c);
+				    this->attachments[attachment_names[this->attachments.size()]].load_from_section(c, options);
 				    break;
 			    case ModelMeshChunkType::SOFTSKINS: {
 				    this->checksum = c->read_uint();
@@ -53,7 +63,7 @@ namespace zenkit {
 				    //        the size of these meshes) so they have to be read directly from `in`.
 				    this->meshes.resize(c->read_ushort());
 				    for (auto& mesh : this->meshes) {
-					    mesh.load(c);
+					    mesh.load(c, options);
 				    }
 
 				    end = c->tell();
@@ -67,6 +77,8 @@ namespace zenkit {
 
 			    return false;
 		    });
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
 	}
 
 	void ModelMesh::save(Write* w, GameVersion version) const {
@@ -439,10 +439,13 @@ namespace zenkit {
 
 		if (potential_chunk_type >= 0xF000 || potential_chunk_type == 0xD000) {
 			this->load_binary(r);
-			return;
+		} else {
+			this->load_source(r);
 		}
 
-		this->load_source(r);
+		for (auto& anim : this->animations) {
+			anim.index_events();
+		}
 	}
 
 	void ModelScript::load_binary(Read* r) {
@@ -454,6 +457,291 @@ namespace zenkit {
 		p.parse_script(*this);
 	}
 
+	static std::string_view event_type_name(MdsEventType type) {
+		switch (type) {
+		case MdsEventType::ITEM_CREATE:
+			return "DEF_CREATE_ITEM";
+		case MdsEventType::ITEM_INSERT:
+			return "DEF_INSERT_ITEM";
+		case MdsEventType::ITEM_REMOVE:
+			return "DEF_REMOVE_ITEM";
+		case MdsEventType::ITEM_DESTROY:
+			return "DEF_DESTROY_ITEM";
+		case MdsEventType::ITEM_PLACE:
+			return "DEF_PLACE_ITEM";
+		case MdsEventType::ITEM_EXCHANGE:
+			return "DEF_EXCHANGE_ITEM";
+		case MdsEventType::SET_FIGHT_MODE:
+			return "DEF_FIGHTMODE";
+		case MdsEventType::MUNITION_PLACE:
+			return "DEF_PLACE_MUNITION";
+		case MdsEventType::MUNITION_REMOVE:
+			return "DEF_REMOVE_MUNITION";
+		case MdsEventType::SOUND_DRAW:
+			return "DEF_DRAWSOUND";
+		case MdsEventType::SOUND_UNDRAW:
+			return "DEF_UNDRAWSOUND";
+		case MdsEventType::MESH_SWAP:
+			return "DEF_SWAPMESH";
+		case MdsEventType::TORCH_DRAW:
+			return "DEF_DRAWTORCH";
+		case MdsEventType::TORCH_INVENTORY:
+			return "DEF_INV_TORCH";
+		case MdsEventType::TORCH_DROP:
+			return "DEF_DROP_TORCH";
+		case MdsEventType::HIT_LIMB:
+			return "DEF_HIT_LIMB";
+		case MdsEventType::HIT_DIRECTION:
+			return "DEF_HIT_DIR";
+		case MdsEventType::DAMAGE_MULTIPLIER:
+			return "DEF_DAM_MULTIPLY";
+		case MdsEventType::PARRY_FRAME:
+			return "DEF_PAR_FRAME";
+		case MdsEventType::OPTIMAL_FRAME:
+			return "DEF_OPT_FRAME";
+		case MdsEventType::HIT_END:
+			return "DEF_HIT_END";
+		case MdsEventType::COMBO_WINDOW:
+			return "DEF_WINDOW";
+		default:
+			return "";
+		}
+	}
+
+	static std::string_view fight_mode_name(MdsFightMode mode) {
+		switch (mode) {
+		case MdsFightMode::FIST:
+			return "FIST";
+		case MdsFightMode::SINGLE_HANDED:
+			return "1H";
+		case MdsFightMode::DUAL_HANDED:
+			return "2H";
+		case MdsFightMode::BOW:
+			return "BOW";
+		case MdsFightMode::CROSSBOW:
+			return "CBOW";
+		case MdsFightMode::MAGIC:
+			return "MAG";
+		default:
+			return "";
+		}
+	}
+
+	static std::string animation_flags_to_string(AnimationFlags flags) {
+		std::string str;
+		if (flags & AnimationFlags::MOVE) str += 'M';
+		if (flags & AnimationFlags::ROTATE) str += 'R';
+		if (flags & AnimationFlags::QUEUE) str += 'E';
+		if (flags & AnimationFlags::FLY) str += 'F';
+		if (flags & AnimationFlags::IDLE) str += 'I';
+		if (flags & AnimationFlags::INPLACE) str += 'P';
+		return str;
+	}
+
+	static std::string_view animation_direction_to_string(AnimationDirection direction) {
+		return direction == AnimationDirection::BACKWARD ? "R" : "F";
+	}
+
+	static void write_event_tag(Write* w, MdsEventTag const& event) {
+		w->write_int(event.frame);
+		w->write_line(event_type_name(event.type));
+
+		switch (event.type) {
+		case MdsEventType::ITEM_CREATE:
+		case MdsEventType::ITEM_EXCHANGE:
+			w->write_line(event.slot);
+			w->write_line(event.item);
+			break;
+		case MdsEventType::SET_FIGHT_MODE:
+			w->write_line(fight_mode_name(event.fight_mode));
+			break;
+		case MdsEventType::MESH_SWAP:
+			w->write_line(event.slot);
+			w->write_line(event.slot2);
+			break;
+		case MdsEventType::ITEM_INSERT:
+		case MdsEventType::MUNITION_PLACE:
+		case MdsEventType::HIT_LIMB:
+		case MdsEventType::HIT_DIRECTION:
+		case MdsEventType::SOUND_DRAW:
+		case MdsEventType::SOUND_UNDRAW:
+		case MdsEventType::MUNITION_REMOVE:
+		case MdsEventType::ITEM_DESTROY:
+		case MdsEventType::TORCH_INVENTORY:
+		case MdsEventType::ITEM_REMOVE:
+			w->write_line(event.slot);
+			break;
+		case MdsEventType::DAMAGE_MULTIPLIER:
+		case MdsEventType::PARRY_FRAME:
+		case MdsEventType::OPTIMAL_FRAME:
+		case MdsEventType::HIT_END:
+		case MdsEventType::COMBO_WINDOW: {
+			std::string frames;
+			for (auto frame : event.frames) {
+				if (!frames.empty()) frames += ' ';
+				frames += std::to_string(frame);
+			}
+
+			w->write_line(frames);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	static void write_animation(Write* w, MdsAnimation const& anim) {
+		proto::write_chunk(w, ModelScriptBinaryChunkType::ANIMATION, [&](Write* c) {
+			c->write_line(anim.name);
+			c->write_uint(anim.layer);
+			c->write_line(anim.next);
+			c->write_float(anim.blend_in);
+			c->write_float(anim.blend_out);
+			c->write_line(animation_flags_to_string(anim.flags));
+			c->write_line(anim.model);
+			c->write_line(animation_direction_to_string(anim.direction));
+			c->write_int(anim.first_frame);
+			c->write_int(anim.last_frame);
+			c->write_float(anim.fps);
+			c->write_float(anim.speed);
+			c->write_float(anim.collision_volume_scale);
+		});
+
+		// Events are attached to the animation written before them.
+		for (auto& event : anim.events) {
+			// Unknown events cannot be represented in binary scripts.
+			if (event.type == MdsEventType::UNKNOWN) continue;
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_TAG, [&](Write* c) { write_event_tag(c, event); });
+		}
+
+		for (auto& effect : anim.sfx) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_SFX, [&](Write* c) {
+				c->write_int(effect.frame);
+				c->write_line(effect.name);
+				c->write_float(effect.range);
+				c->write_uint(effect.empty_slot);
+			});
+		}
+
+		for (auto& effect : anim.sfx_ground) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_SFX_GROUND, [&](Write* c) {
+				c->write_int(effect.frame);
+				c->write_line(effect.name);
+				c->write_float(effect.range);
+				c->write_uint(effect.empty_slot);
+			});
+		}
+
+		for (auto& effect : anim.pfx) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_PFX, [&](Write* c) {
+				c->write_int(effect.frame);
+				c->write_int(effect.index);
+				c->write_line(effect.name);
+				c->write_line(effect.position);
+				c->write_uint(effect.attached);
+			});
+		}
+
+		for (auto& effect : anim.pfx_stop) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_PFX_STOP, [&](Write* c) {
+				c->write_int(effect.frame);
+				c->write_int(effect.index);
+			});
+		}
+
+		for (auto& morph : anim.morph) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_MM_ANI, [&](Write* c) {
+				c->write_int(morph.frame);
+				c->write_line(morph.animation);
+				c->write_line(morph.node);
+				c->write_float(0);
+				c->write_float(0);
+			});
+		}
+
+		for (auto& tremor : anim.tremors) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::EVENT_CAMERA_TREMOR, [&](Write* c) {
+				c->write_int(tremor.frame);
+				c->write_int(tremor.field1);
+				c->write_int(tremor.field2);
+				c->write_int(tremor.field3);
+				c->write_int(tremor.field4);
+			});
+		}
+	}
+
+	void ModelScript::save(Write* w) const {
+		// The root chunk is always written first, so that ModelScript::load detects the script as binary.
+		proto::write_chunk(w, ModelScriptBinaryChunkType::ROOT, [](Write* c) {
+			c->write_uint(0);
+			c->write_line("");
+		});
+
+		proto::write_chunk(w, ModelScriptBinaryChunkType::MESH_AND_TREE, [&](Write* c) {
+			c->write_uint(this->skeleton.disable_mesh);
+			c->write_line(this->skeleton.name);
+		});
+
+		for (auto& mesh : this->meshes) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::REGISTER_MESH, [&](Write* c) { c->write_line(mesh); });
+		}
+
+		for (auto& anim : this->animations) {
+			write_animation(w, anim);
+		}
+
+		for (auto& alias : this->aliases) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::ANIMATION_ALIAS, [&](Write* c) {
+				c->write_line(alias.name);
+				c->write_uint(alias.layer);
+				c->write_line(alias.next);
+				c->write_float(alias.blend_in);
+				c->write_float(alias.blend_out);
+				c->write_line(animation_flags_to_string(alias.flags));
+				c->write_line(alias.alias);
+				c->write_line(animation_direction_to_string(alias.direction));
+			});
+		}
+
+		for (auto& blend : this->blends) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::ANIMATION_BLEND, [&](Write* c) {
+				c->write_line(blend.name);
+				c->write_line(blend.next);
+				c->write_float(blend.blend_in);
+				c->write_float(blend.blend_out);
+			});
+		}
+
+		for (auto& combo : this->combinations) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::ANIMATION_COMBINE, [&](Write* c) {
+				c->write_line(combo.name);
+				c->write_uint(combo.layer);
+				c->write_line(combo.next);
+				c->write_float(combo.blend_in);
+				c->write_float(combo.blend_out);
+				c->write_line(animation_flags_to_string(combo.flags));
+				c->write_line(combo.model);
+				c->write_int(combo.last_frame);
+			});
+		}
+
+		for (auto& name : this->disabled_animations) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::ANIMATION_DISABLE, [&](Write* c) {
+				c->write_line(name);
+			});
+		}
+
+		for (auto& tag : this->model_tags) {
+			proto::write_chunk(w, ModelScriptBinaryChunkType::MODEL_TAG, [&](Write* c) {
+				c->write_int(0);
+				c->write_line("DEF_HIT_LIMB");
+				c->write_line(tag.bone);
+			});
+		}
+
+		proto::write_chunk(w, ModelScriptBinaryChunkType::END, [](Write*) {});
+	}
+
 	bool operator&(AnimationFlags a, AnimationFlags b) {
 		return static_cast<bool>(static_cast<uint8_t>(a) & static_cast<uint8_t>(b));
 	}
@@ -7,6 +7,9 @@
 #include "zenkit/Stream.hh"
 #include "zenkit/Misc.hh"
 
+#include <algorithm>
+#include <charconv>
+
 #define WARN_SYNTAX(msg) ZKLOGW("ModelScript", "Syntax error (line %d, column %d): %s", _m_line, _m_column, msg)
 
 namespace zenkit {
@@ -26,13 +29,41 @@ namespace zenkit {
 	constexpr std::string_view token_names[] =
 	    {"KEYWORD", "integer", "float", "string", "rparen", "lparen", "rbrace", "lbrace", "colon", "eof", "null"};
 
-	MdsTokenizer::MdsTokenizer(Read* buf) : _m_buffer(buf), _m_mark(0) {}
+	MdsTokenizer::MdsTokenizer(Read* buf) : _m_buffer(buf) {
+		// Scripts are tokenized in place if the stream is backed by memory. Otherwise, the rest of the stream is
+		// copied into a buffer first.
+		if (auto span = buf->as_contiguous(); span.data() != nullptr) {
+			_m_source = {reinterpret_cast<char const*>(span.data()), span.size()};
+			_m_contiguous = true;
+			return;
+		}
+
+		char chunk[4096];
+		for (std::size_t n; (n = buf->read(chunk, sizeof chunk)) != 0;) {
+			_m_owned.append(chunk, n);
+		}
+
+		_m_source = _m_owned;
+	}
+
+	MdsTokenizer::~MdsTokenizer() noexcept {
+		// Leave the stream after the last token, like reading it character by character would.
+		if (_m_contiguous) {
+			_m_buffer->seek(static_cast<ssize_t>(std::min(_m_position, _m_source.size())), Whence::CUR);
+		}
+	}
+
+	char MdsTokenizer::read_char() noexcept {
+		// NOTE: Past the end, the position keeps advancing so that backtracking stays symmetric.
+		auto position = _m_position++;
+		return position < _m_source.size() ? _m_source[position] : '\0';
+	}
 
 	MdsToken MdsTokenizer::next() {
-		_m_value.clear();
-		while (!_m_buffer->eof()) {
-			_m_mark = _m_buffer->tell();
-			auto chr = static_cast<unsigned char>(_m_buffer->read_char());
+		_m_value = {};
+		while (!this->eof()) {
+			_m_mark = _m_position;
+			auto chr = static_cast<unsigned char>(this->read_char());
 			_m_column += 1;
 
 			// ignore spaces, quotation marks, semicolons and parentheses
@@ -49,14 +80,13 @@ namespace zenkit {
 
 			// ignore comments
 			if (chr == '/') {
-				if (_m_buffer->read_char() != '/') {
+				if (this->read_char() != '/') {
 					WARN_SYNTAX("comments must start with two slashes");
 				}
 
 				// skip everything until the end of the line
-				while (_m_buffer->read_char() != '\n')
-					_m_column += 1;
-
+				auto end = _m_source.find('\n', std::min(_m_position, _m_source.size()));
+				_m_position = end == std::string_view::npos ? _m_source.size() : end + 1;
 				_m_line += 1;
 				_m_column = 1;
 				continue;
@@ -65,32 +95,38 @@ namespace zenkit {
 			// parse keywords
 			if (std::isalpha(chr) || chr == '*' || chr == '_' || chr == '.') {
 				do {
-					_m_value.push_back(static_cast<char>(chr));
-					chr = static_cast<unsigned char>(_m_buffer->read_char());
+					chr = static_cast<unsigned char>(this->read_char());
 					_m_column += 1;
 				} while (std::isalnum(chr) || chr == '_' || chr == '-' || chr == '.');
 
 				// (backtrack one)
-				_m_buffer->seek(-1, Whence::CUR);
+				_m_position -= 1;
 				_m_column -= 1;
 
+				_m_value = this->slice(_m_mark, _m_position);
 				return MdsToken::KEYWORD;
 			}
 
 			// parse strings
 			if (chr == '"') {
-				chr = static_cast<unsigned char>(_m_buffer->read_char());
+				auto begin = _m_position;
+				chr = static_cast<unsigned char>(this->read_char());
 				_m_column += 1;
 
-				while (chr != '"' && chr != '\n' && chr != ')') {
-					_m_value.push_back(static_cast<char>(chr));
-					chr = static_cast<unsigned char>(_m_buffer->read_char());
+				while (chr != '"' && chr != '\n' && chr != ')' && !this->eof()) {
+					chr = static_cast<unsigned char>(this->read_char());
 					_m_column += 1;
 				}
 
 				if (chr != '"') {
 					WARN_SYNTAX("String not terminated");
-					_m_buffer->seek(-1, Whence::CUR);
+				}
+
+				// Exclude the closing quote or whichever other character ended the string.
+				_m_value = this->slice(begin, _m_position - 1);
+
+				if (chr != '"') {
+					_m_position -= 1;
 					_m_column -= 1;
 				}
 
@@ -102,24 +138,22 @@ namespace zenkit {
 				bool floating_point = false;
 
 				do {
-					_m_value.push_back(static_cast<char>(chr));
-					chr = static_cast<unsigned char>(_m_buffer->read_char());
+					chr = static_cast<unsigned char>(this->read_char());
 					_m_column += 1;
 
 					// (allow floating point numbers)
 					if (chr == '.') {
 						floating_point = true;
-
-						_m_value.push_back(static_cast<char>(chr));
-						chr = static_cast<unsigned char>(_m_buffer->read_char());
+						chr = static_cast<unsigned char>(this->read_char());
 						_m_column += 1;
 					}
 				} while (std::isdigit(chr));
 
 				// (backtrack one)
-				_m_buffer->seek(-1, Whence::CUR);
+				_m_position -= 1;
 				_m_column -= 1;
 
+				_m_value = this->slice(_m_mark, _m_position);
 				return floating_point ? MdsToken::FLOAT : MdsToken::INTEGER;
 			}
 
@@ -141,19 +175,25 @@ namespace zenkit {
 		return MdsToken::END_OF_FILE;
 	}
 
+	std::string_view MdsTokenizer::slice(std::size_t begin, std::size_t end) const noexcept {
+		begin = std::min(begin, _m_source.size());
+		end = std::min(end, _m_source.size());
+		return _m_source.substr(begin, end - std::min(begin, end));
+	}
+
 	std::string MdsTokenizer::format_location() const {
 		return "line " + std::to_string(_m_line) + " column " + std::to_string(_m_column);
 	}
 
 	void MdsTokenizer::backtrack() {
-		this->_m_buffer->seek(static_cast<ssize_t>(_m_mark), Whence::BEG);
+		_m_position = _m_mark;
 	}
 
 	bool MdsTokenizer::eof() const {
-		return _m_buffer->eof();
+		return _m_position >= _m_source.size();
 	}
 
-	std::string const& MdsTokenizer::token_value() const {
+	std::string_view MdsTokenizer::token_value() const {
 		return _m_value;
 	}
 
@@ -171,16 +211,16 @@ namespace zenkit {
 
 	std::string MdsParser::expect_string() {
 		this->expect<MdsToken::STRING>();
-		return _m_stream.token_value();
+		return std::string {_m_stream.token_value()};
 	}
 
 	std::string MdsParser::expect_keyword() {
 		this->expect<MdsToken::KEYWORD>();
-		return _m_stream.token_value();
+		return std::string {_m_stream.token_value()};
 	}
 
 	std::optional<std::string> MdsParser::maybe_keyword() {
-		if (this->maybe<MdsToken::KEYWORD>()) return _m_stream.token_value();
+		if (this->maybe<MdsToken::KEYWORD>()) return std::string {_m_stream.token_value()};
 		return std::nullopt;
 	}
 
@@ -202,7 +242,19 @@ namespace zenkit {
 
 	int MdsParser::expect_int() {
 		this->expect<MdsToken::INTEGER>();
-		return std::stoi(_m_stream.token_value());
+		return this->token_int();
+	}
+
+	int MdsParser::token_int() const {
+		auto value = _m_stream.token_value();
+
+		int result = 0;
+		auto [end, err] = std::from_chars(value.data(), value.data() + value.size(), result);
+		if (err != std::errc {} || end != value.data() + value.size()) {
+			throw ScriptSyntaxError {_m_stream.format_location(), "invalid integer: " + std::string {value}};
+		}
+
+		return result;
 	}
 
 	AnimationFlags MdsParser::expect_flags() {
@@ -246,7 +298,7 @@ namespace zenkit {
 			return std::nullopt;
 		}
 
-		return std::stoi(_m_stream.token_value());
+		return this->token_int();
 	}
 
 	std::optional<float> MdsParser::maybe_number() {
@@ -256,7 +308,8 @@ namespace zenkit {
 			return std::nullopt;
 		}
 
-		return std::stof(_m_stream.token_value());
+		// Number tokens are short enough for the small string optimization, so this does not allocate.
+		return std::stof(std::string {_m_stream.token_value()});
 	}
 
 	std::optional<std::string> MdsParser::maybe_string() {
@@ -264,7 +317,7 @@ namespace zenkit {
 			return std::nullopt;
 		}
 
-		return _m_stream.token_value();
+		return std::string {_m_stream.token_value()};
 	}
 
 	bool MdsParser::maybe_keyword(std::string_view value) {
@@ -391,7 +444,9 @@ namespace zenkit {
 	}
 
 	void MdsParser::ignore_block() {
-		while (this->_m_stream.next() != MdsToken::RBRACE) {}
+		for (auto token = this->_m_stream.next(); token != MdsToken::RBRACE; token = this->_m_stream.next()) {
+			if (token == MdsToken::END_OF_FILE) break;
+		}
 	}
 
 	MdsEventTag MdsParser::parse_eventTag() {
@@ -21,25 +21,42 @@ namespace zenkit {
 		NOTHING = 10,
 	};
 
+	/// \brief Splits model script source code into tokens.
+	///
+	/// <p>Tokens are views into the source, which is read directly from the memory backing the stream if possible,
+	/// so no strings are created while tokenizing.</p>
 	class MdsTokenizer {
 	public:
 		explicit MdsTokenizer(Read* buf);
+		~MdsTokenizer() noexcept;
+
+		MdsTokenizer(MdsTokenizer const&) = delete;
+		MdsTokenizer& operator=(MdsTokenizer const&) = delete;
 
 		MdsToken next();
 
 		void backtrack();
 
-		[[nodiscard]] std::string const& token_value() const;
+		/// \return The text of the last token. Only valid until the tokenizer is destroyed.
+		[[nodiscard]] std::string_view token_value() const;
 
 		[[nodiscard]] bool eof() const;
 
 		[[nodiscard]] std::string format_location() const;
 
 	private:
+		[[nodiscard]] char read_char() noexcept;
+		[[nodiscard]] std::string_view slice(std::size_t begin, std::size_t end) const noexcept;
+
 		Read* _m_buffer;
+		std::string _m_owned;
+		std::string_view _m_source;
+		bool _m_contiguous {false};
+
+		std::size_t _m_position {0};
+		std::size_t _m_mark {0};
 		uint32_t _m_line {1}, _m_column {1};
-		std::string _m_value;
-		std::size_t _m_mark;
+		std::string_view _m_value;
 	};
 
 	class MdsParser {
@@ -80,6 +97,7 @@ namespace zenkit {
 		void expect_keyword(std::string_view value);
 		[[nodiscard]] float expect_number();
 		[[nodiscard]] int expect_int();
+		[[nodiscard]] int token_int() const;
 		[[nodiscard]] AnimationFlags expect_flags();
 		[[nodiscard]] std::optional<AnimationFlags> maybe_flags();
 
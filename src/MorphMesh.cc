@@ -3,6 +3,11 @@
 #include "zenkit/MorphMesh.hh"
 #include "zenkit/Stream.hh"
 
+#include "Internal.hh"
+
+#include <algorithm>
+#include <cmath>
+
 namespace zenkit {
 	enum class MorphMeshChunkType : std::uint16_t {
 		SOURCES = 0xE010,
@@ -13,6 +18,7 @@ namespace zenkit {
 	};
 
 	void MorphMesh::load(Read* r) {
+		MemoryScope memory {MemoryCategory::MESH};
 		proto::read_chunked<MorphMeshChunkType>(r, "MorphMesh", [this](Read* c, MorphMeshChunkType type) {
 			switch (type) {
 			case MorphMeshChunkType::SOURCES: {
@@ -77,4 +83,56 @@ namespace zenkit {
 			return false;
 		});
 	}
+
+	void MorphMesh::evaluate(MorphAnimationState const* animations,
+	                         std::size_t animation_count,
+	                         Vec3* positions) const noexcept {
+		std::copy(this->morph_positions.begin(), this->morph_positions.end(), positions);
+		auto position_count = this->morph_positions.size();
+
+		for (std::size_t i = 0; i < animation_count; ++i) {
+			auto const& state = animations[i];
+			if (state.animation >= this->animations.size() || state.weight == 0) continue;
+
+			auto const& anim = this->animations[state.animation];
+			auto vertex_count = anim.vertices.size();
+			if (anim.frame_count == 0 || anim.samples.size() < vertex_count * anim.frame_count) continue;
+
+			auto speed = anim.speed;
+			if (speed <= 0 && anim.duration > 0) speed = static_cast<float>(anim.frame_count) / anim.duration;
+
+			auto frame_count = static_cast<float>(anim.frame_count);
+			auto frame = state.time * 1000 * speed;
+			if (state.loop) {
+				frame = std::fmod(frame, frame_count);
+				if (frame < 0) frame += frame_count;
+			} else {
+				frame = std::clamp(frame, 0.0f, frame_count - 1);
+			}
+
+			auto f0 = std::min(static_cast<std::uint32_t>(frame), anim.frame_count - 1);
+			auto f1 = f0 + 1 < anim.frame_count ? f0 + 1 : (state.loop ? 0 : f0);
+			auto t = frame - static_cast<float>(f0);
+
+			auto w0 = state.weight * (1 - t);
+			auto w1 = state.weight * t;
+			auto const* s0 = anim.samples.data() + f0 * vertex_count;
+			auto const* s1 = anim.samples.data() + f1 * vertex_count;
+
+			for (std::size_t j = 0; j < vertex_count; ++j) {
+				auto vertex = anim.vertices[j];
+				if (vertex >= position_count) continue;
+
+				auto& p = positions[vertex];
+				p.x += s0[j].x * w0 + s1[j].x * w1;
+				p.y += s0[j].y * w0 + s1[j].y * w1;
+				p.z += s0[j].z * w0 + s1[j].z * w1;
+			}
+		}
+	}
+
+	void MorphMesh::evaluate(std::vector<MorphAnimationState> const& animations, std::vector<Vec3>& positions) const {
+		positions.resize(this->morph_positions.size());
+		this->evaluate(animations.data(), animations.size(), positions.data());
+	}
 } // namespace zenkit
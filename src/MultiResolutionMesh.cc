@@ -4,6 +4,14 @@
 #include "zenkit/Archive.hh"
 #include "zenkit/Stream.hh"
 
+#include "Internal.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
 namespace zenkit {
 	[[maybe_unused]] static constexpr auto VERSION_G1 = 0x305;
 	static constexpr auto VERSION_G2 = 0x905;
@@ -11,10 +19,18 @@ namespace zenkit {
 	enum class MrmChunkType : std::uint16_t { MESH = 0xB100, END = 0xB1FF };
 
 	void MultiResolutionMesh::load(Read* r) {
-		proto::read_chunked<MrmChunkType>(r, "MultiResolutionMesh", [this](Read* c, MrmChunkType type) {
+		this->load(r, MultiResolutionMeshLoadOptions {});
+	}
+
+	void MultiResolutionMesh::load(Read* r, MultiResolutionMeshLoadOptions const& options) {
+		ZKTRACE_ZONE(zone, "MultiResolutionMesh.load");
+		MemoryScope memory {MemoryCategory::MESH};
+		auto begin = r->tell();
+
+		proto::read_chunked<MrmChunkType>(r, "MultiResolutionMesh", [&](Read* c, MrmChunkType type) {
 			switch (type) {
 			case MrmChunkType::MESH:
-				this->load_from_section(c);
+				this->load_from_section(c, options);
 				break;
 			case MrmChunkType::END:
 				return true;
@@ -24,9 +40,11 @@ namespace zenkit {
 
 			return false;
 		});
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
 	}
 
-	void MultiResolutionMesh::load_from_section(Read* r) {
+	void MultiResolutionMesh::load_from_section(Read* r, MultiResolutionMeshLoadOptions const& options) {
 		auto version = r->read_ushort();
 		auto content_size = r->read_uint();
 		auto content_offset = r->tell();
@@ -64,6 +82,16 @@ namespace zenkit {
 			material.load(*mats);
 		}
 
+		this->material_handles.clear();
+		if (options.materials != nullptr) {
+			this->material_handles.reserve(this->materials.size());
+			for (auto& material : this->materials) {
+				this->material_handles.push_back(options.materials->intern(std::move(material)));
+			}
+
+			this->materials.clear();
+		}
+
 		if (version == VERSION_G2) {
 			this->alpha_test = r->read_byte() != 0;
 		}
@@ -78,25 +106,29 @@ namespace zenkit {
 		// read positions
 		this->positions.resize(vertices_size);
 		r->seek(static_cast<ssize_t>(vertices_offset), Whence::BEG);
-		for (auto& pos : this->positions) {
-			pos = r->read_vec3();
-		}
+		r->read_vec3_array(this->positions.data(), this->positions.size());
 
 		// read normals
 		this->normals.resize(normals_size);
 		r->seek(static_cast<ssize_t>(normals_offset), Whence::BEG);
-		for (auto& normal : this->normals) {
-			normal = r->read_vec3();
-		}
+		r->read_vec3_array(this->normals.data(), this->normals.size());
 
 		// read submeshes
 		this->sub_meshes.resize(submesh_count);
 		for (auto i = 0u; i < submesh_count; ++i) {
-			this->sub_meshes[i].load(r, submesh_sections[i]);
-			this->sub_meshes[i].mat = this->materials[i];
+			this->sub_meshes[i].load(r, submesh_sections[i], options);
+			if (options.materials == nullptr) this->sub_meshes[i].mat = this->materials[i];
 		}
 
 		r->seek(static_cast<uint32_t>(end), Whence::BEG);
+
+		this->quantized_positions.clear();
+		this->quantized_normals.clear();
+		for (auto& sub_mesh : this->sub_meshes) {
+			sub_mesh.quantized_wedges.clear();
+		}
+
+		if (options.compact) this->compact();
 	}
 
 	void MultiResolutionMesh::save(Write* w, GameVersion version) const {
@@ -105,6 +137,11 @@ namespace zenkit {
 	}
 
 	void MultiResolutionMesh::save_to_section(Write* w, GameVersion version) const {
+		// The sub-meshes don't have their materials, so they would silently be saved with default ones.
+		if (!this->material_handles.empty()) {
+			throw std::logic_error {"meshes loaded into a MaterialRegistry cannot be saved"};
+		}
+
 		w->write_ushort(version == GameVersion::GOTHIC_1 ? VERSION_G1 : VERSION_G2);
 
 		auto off_size = static_cast<ssize_t>(w->tell());
@@ -187,13 +224,16 @@ namespace zenkit {
 		w->write(padding, 10);
 	}
 
-	void SubMesh::load(Read* r, SubMeshSection const& map) {
+	// These are stored exactly as they are laid out in memory, so they can be read in bulk.
+	static_assert(sizeof(MeshTriangle) == sizeof(std::uint16_t) * 3);
+	static_assert(sizeof(MeshTriangleEdge) == sizeof(std::uint16_t) * 3);
+	static_assert(sizeof(MeshEdge) == sizeof(std::uint16_t) * 2);
+
+	void SubMesh::load(Read* r, SubMeshSection const& map, MultiResolutionMeshLoadOptions const& options) {
 		// triangles
 		r->seek(static_cast<ssize_t>(map.triangles.offset), Whence::BEG);
 		this->triangles.resize(map.triangles.size);
-		for (auto i = 0u; i < map.triangles.size; ++i) {
-			this->triangles[i] = {{r->read_ushort(), r->read_ushort(), r->read_ushort()}};
-		}
+		r->read(this->triangles.data(), sizeof(MeshTriangle) * this->triangles.size());
 
 		// wedges
 		r->seek(static_cast<ssize_t>(map.wedges.offset), Whence::BEG);
@@ -209,58 +249,54 @@ namespace zenkit {
 		// colors
 		r->seek(static_cast<ssize_t>(map.colors.offset), Whence::BEG);
 		this->colors.resize(map.colors.size);
-
-		for (auto i = 0u; i < map.colors.size; ++i) {
-			this->colors[i] = r->read_float();
+		r->read_float_array(this->colors.data(), this->colors.size());
+
+		// Sections which are not requested are not read at all, since every section is looked up by its offset.
+		if (options.skip_planes) {
+			this->triangle_plane_indices.clear();
+			this->triangle_planes.clear();
+		} else {
+			// triangle_plane_indices
+			r->seek(static_cast<ssize_t>(map.triangle_plane_indices.offset), Whence::BEG);
+			this->triangle_plane_indices.resize(map.triangle_plane_indices.size);
+			r->read_ushort_array(this->triangle_plane_indices.data(), this->triangle_plane_indices.size());
+
+			// triangle_planes
+			r->seek(static_cast<ssize_t>(map.triangle_planes.offset), Whence::BEG);
+			this->triangle_planes.resize(map.triangle_planes.size);
+
+			for (auto i = 0u; i < map.triangle_planes.size; ++i) {
+				this->triangle_planes[i] = {r->read_float(), r->read_vec3()};
+			}
 		}
 
-		// triangle_plane_indices
-		r->seek(static_cast<ssize_t>(map.triangle_plane_indices.offset), Whence::BEG);
-		this->triangle_plane_indices.resize(map.triangle_plane_indices.size);
-
-		for (auto i = 0u; i < map.triangle_plane_indices.size; ++i) {
-			this->triangle_plane_indices[i] = r->read_ushort();
-		}
-
-		// triangle_planes
-		r->seek(static_cast<ssize_t>(map.triangle_planes.offset), Whence::BEG);
-		this->triangle_planes.resize(map.triangle_planes.size);
-
-		for (auto i = 0u; i < map.triangle_planes.size; ++i) {
-			this->triangle_planes[i] = {r->read_float(), r->read_vec3()};
+		if (options.skip_progressive) {
+			this->triangle_edges.clear();
+			this->edges.clear();
+			this->edge_scores.clear();
+			this->wedge_map.clear();
+			return;
 		}
 
 		// triangle_edges
 		r->seek(static_cast<ssize_t>(map.triangle_edges.offset), Whence::BEG);
 		this->triangle_edges.resize(map.triangle_edges.size);
-
-		for (auto i = 0u; i < map.triangle_edges.size; ++i) {
-			this->triangle_edges[i] = {{r->read_ushort(), r->read_ushort(), r->read_ushort()}};
-		}
+		r->read(this->triangle_edges.data(), sizeof(MeshTriangleEdge) * this->triangle_edges.size());
 
 		// edges
 		r->seek(static_cast<ssize_t>(map.edges.offset), Whence::BEG);
 		this->edges.resize(map.edges.size);
-
-		for (auto i = 0u; i < map.edges.size; ++i) {
-			this->edges[i] = {{r->read_ushort(), r->read_ushort()}};
-		}
+		r->read(this->edges.data(), sizeof(MeshEdge) * this->edges.size());
 
 		// edge_scores
 		r->seek(static_cast<ssize_t>(map.edge_scores.offset), Whence::BEG);
 		this->edge_scores.resize(map.edge_scores.size);
-
-		for (auto i = 0u; i < map.edge_scores.size; ++i) {
-			this->edge_scores[i] = r->read_float();
-		}
+		r->read_float_array(this->edge_scores.data(), this->edge_scores.size());
 
 		// wedge_map
 		r->seek(static_cast<ssize_t>(map.wedge_map.offset), Whence::BEG);
 		this->wedge_map.resize(map.wedge_map.size);
-
-		for (auto i = 0u; i < map.wedge_map.size; ++i) {
-			this->wedge_map[i] = r->read_ushort();
-		}
+		r->read_ushort_array(this->wedge_map.data(), this->wedge_map.size());
 	}
 
 	SubMeshSection SubMesh::save(Write* w) const {
@@ -340,4 +376,215 @@ namespace zenkit {
 
 		return section;
 	}
+
+	/// \brief Converts a float to an IEEE 754 half-precision float, rounding to the nearest even value.
+	static std::uint16_t float_to_half(float value) noexcept {
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof bits);
+
+		auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+		auto exponent = static_cast<std::int32_t>((bits >> 23) & 0xFF);
+		auto mantissa = bits & 0x7FFFFF;
+
+		// Infinity and NaN
+		if (exponent == 0xFF) return sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0);
+
+		exponent -= 127 - 15;
+		if (exponent >= 0x1F) return sign | 0x7C00; // Overflow to infinity
+
+		if (exponent <= 0) {
+			// Subnormal or zero
+			if (exponent < -10) return sign;
+
+			mantissa |= 0x800000;
+			auto shift = static_cast<std::uint32_t>(14 - exponent);
+			auto half = mantissa >> shift;
+			auto rest = mantissa & ((1u << shift) - 1);
+			auto middle = 1u << (shift - 1);
+			if (rest > middle || (rest == middle && (half & 1) != 0)) ++half;
+			return sign | static_cast<std::uint16_t>(half);
+		}
+
+		auto half = static_cast<std::uint32_t>(exponent) << 10 | mantissa >> 13;
+		auto rest = mantissa & 0x1FFF;
+		if (rest > 0x1000 || (rest == 0x1000 && (half & 1) != 0)) ++half; // May carry into infinity, as it should.
+		return sign | static_cast<std::uint16_t>(half);
+	}
+
+	/// \brief Converts an IEEE 754 half-precision float to a float.
+	static float half_to_float(std::uint16_t value) noexcept {
+		auto sign = static_cast<std::uint32_t>(value & 0x8000) << 16;
+		auto exponent = static_cast<std::uint32_t>(value >> 10) & 0x1F;
+		auto mantissa = static_cast<std::uint32_t>(value) & 0x3FF;
+
+		std::uint32_t bits;
+		if (exponent == 0x1F) {
+			bits = sign | 0x7F800000 | mantissa << 13;
+		} else if (exponent != 0) {
+			bits = sign | (exponent + 127 - 15) << 23 | mantissa << 13;
+		} else if (mantissa != 0) {
+			// Subnormal: normalize the mantissa
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x400) == 0) {
+				mantissa <<= 1;
+				--exponent;
+			}
+
+			bits = sign | exponent << 23 | (mantissa & 0x3FF) << 13;
+		} else {
+			bits = sign;
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof result);
+		return result;
+	}
+
+	static std::int16_t to_snorm16(float value) noexcept {
+		return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	QuantizedPosition
+	QuantizedPosition::encode(Vec3 const& position, Vec3 const& minimum, Vec3 const& scale) noexcept {
+		QuantizedPosition result {};
+		for (auto i = 0u; i < 3; ++i) {
+			if (scale[i] <= 0) continue;
+
+			auto steps = std::round((position[i] - minimum[i]) / scale[i]);
+			result.position[i] = static_cast<std::uint16_t>(std::clamp(steps, 0.0f, 65535.0f));
+		}
+
+		return result;
+	}
+
+	Vec3 QuantizedPosition::decode(Vec3 const& minimum, Vec3 const& scale) const noexcept {
+		return Vec3 {
+		    static_cast<float>(this->position[0]) * scale.x + minimum.x,
+		    static_cast<float>(this->position[1]) * scale.y + minimum.y,
+		    static_cast<float>(this->position[2]) * scale.z + minimum.z,
+		};
+	}
+
+	QuantizedNormal QuantizedNormal::encode(Vec3 const& normal) noexcept {
+		auto length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (length <= 0) return QuantizedNormal {{0, 0}};
+
+		auto x = normal.x / length;
+		auto y = normal.y / length;
+
+		// Fold the lower hemisphere over the diagonals of the square.
+		if (normal.z < 0) {
+			auto fx = (1 - std::abs(y)) * (x >= 0 ? 1.0f : -1.0f);
+			auto fy = (1 - std::abs(x)) * (y >= 0 ? 1.0f : -1.0f);
+			x = fx;
+			y = fy;
+		}
+
+		return QuantizedNormal {{to_snorm16(x), to_snorm16(y)}};
+	}
+
+	Vec3 QuantizedNormal::decode() const noexcept {
+		auto x = static_cast<float>(this->oct[0]) / 32767.0f;
+		auto y = static_cast<float>(this->oct[1]) / 32767.0f;
+		auto z = 1 - std::abs(x) - std::abs(y);
+
+		auto t = std::max(-z, 0.0f);
+		x += x >= 0 ? -t : t;
+		y += y >= 0 ? -t : t;
+
+		auto length = std::sqrt(x * x + y * y + z * z);
+		return Vec3 {x / length, y / length, z / length};
+	}
+
+	QuantizedMeshWedge QuantizedMeshWedge::encode(MeshWedge const& wedge) noexcept {
+		return QuantizedMeshWedge {
+		    QuantizedNormal::encode(wedge.normal),
+		    {float_to_half(wedge.texture.x), float_to_half(wedge.texture.y)},
+		    wedge.index,
+		};
+	}
+
+	MeshWedge QuantizedMeshWedge::decode() const noexcept {
+		return MeshWedge {
+		    this->normal.decode(),
+		    Vec2 {half_to_float(this->texture[0]), half_to_float(this->texture[1])},
+		    this->index,
+		};
+	}
+
+	void MultiResolutionMesh::compact() {
+		if (this->positions.empty() && this->normals.empty()) return;
+
+		auto minimum = Vec3 {std::numeric_limits<float>::max()};
+		auto maximum = Vec3 {std::numeric_limits<float>::lowest()};
+		for (auto& position : this->positions) {
+			for (auto i = 0u; i < 3; ++i) {
+				minimum[i] = std::min(minimum[i], position[i]);
+				maximum[i] = std::max(maximum[i], position[i]);
+			}
+		}
+
+		if (this->positions.empty()) minimum = maximum = Vec3 {0};
+
+		this->quantized_position_min = minimum;
+		for (auto i = 0u; i < 3; ++i) {
+			this->quantized_position_scale[i] = (maximum[i] - minimum[i]) / 65535.0f;
+		}
+
+		this->quantized_positions.resize(this->positions.size());
+		for (auto i = 0u; i < this->positions.size(); ++i) {
+			this->quantized_positions[i] =
+			    QuantizedPosition::encode(this->positions[i], minimum, this->quantized_position_scale);
+		}
+
+		this->quantized_normals.resize(this->normals.size());
+		for (auto i = 0u; i < this->normals.size(); ++i) {
+			this->quantized_normals[i] = QuantizedNormal::encode(this->normals[i]);
+		}
+
+		for (auto& sub_mesh : this->sub_meshes) {
+			sub_mesh.quantized_wedges.resize(sub_mesh.wedges.size());
+			for (auto i = 0u; i < sub_mesh.wedges.size(); ++i) {
+				sub_mesh.quantized_wedges[i] = QuantizedMeshWedge::encode(sub_mesh.wedges[i]);
+			}
+
+			sub_mesh.wedges.clear();
+			sub_mesh.wedges.shrink_to_fit();
+		}
+
+		this->positions.clear();
+		this->positions.shrink_to_fit();
+		this->normals.clear();
+		this->normals.shrink_to_fit();
+	}
+
+	void MultiResolutionMesh::decode() {
+		if (!this->is_compact()) return;
+
+		this->positions.resize(this->quantized_positions.size());
+		for (auto i = 0u; i < this->quantized_positions.size(); ++i) {
+			this->positions[i] =
+			    this->quantized_positions[i].decode(this->quantized_position_min, this->quantized_position_scale);
+		}
+
+		this->normals.resize(this->quantized_normals.size());
+		for (auto i = 0u; i < this->quantized_normals.size(); ++i) {
+			this->normals[i] = this->quantized_normals[i].decode();
+		}
+
+		for (auto& sub_mesh : this->sub_meshes) {
+			sub_mesh.wedges.resize(sub_mesh.quantized_wedges.size());
+			for (auto i = 0u; i < sub_mesh.quantized_wedges.size(); ++i) {
+				sub_mesh.wedges[i] = sub_mesh.quantized_wedges[i].decode();
+			}
+
+			sub_mesh.quantized_wedges.clear();
+			sub_mesh.quantized_wedges.shrink_to_fit();
+		}
+
+		this->quantized_positions.clear();
+		this->quantized_positions.shrink_to_fit();
+		this->quantized_normals.clear();
+		this->quantized_normals.shrink_to_fit();
+	}
 } // namespace zenkit
@@ -1,5 +1,8 @@
 #include "zenkit/Object.hh"
 
+#include <algorithm>
+#include <cstring>
+
 namespace zenkit {
 	ObjectType Object::get_object_type() const {
 		return ObjectType::unknown;
@@ -12,4 +15,115 @@ namespace zenkit {
 	void Object::load(ReadArchive&, GameVersion) {}
 
 	void Object::save(WriteArchive&, GameVersion) const {}
-} // namespace zenkit
\ No newline at end of file
+
+	ObjectArena::ObjectArena(std::size_t block_size, MemoryResource* memory) noexcept
+	    : _m_memory(memory != nullptr ? memory : get_memory_resource()), _m_block_size(block_size) {}
+
+	ObjectArena::~ObjectArena() noexcept {
+		for (auto& block : _m_blocks) {
+			_m_memory->deallocate(block.data, block.size, alignof(std::max_align_t));
+		}
+	}
+
+	std::shared_ptr<ObjectArena> ObjectArena::create(std::size_t block_size) {
+		return ObjectArena::create(block_size, nullptr);
+	}
+
+	std::shared_ptr<ObjectArena> ObjectArena::create(std::size_t block_size, MemoryResource* memory) {
+		return std::shared_ptr<ObjectArena> {new ObjectArena(block_size, memory)};
+	}
+
+	void* ObjectArena::allocate(std::size_t size, std::size_t alignment) {
+		auto padding = (alignment - reinterpret_cast<std::uintptr_t>(_m_cursor) % alignment) % alignment;
+
+		if (_m_cursor == nullptr || padding + size > _m_left) {
+			auto block_size = std::max(_m_block_size, size + alignment);
+
+			// Reuse the blocks kept by reset() first. They all have the default size.
+			if (block_size > _m_block_size || _m_next_block == _m_blocks.size()) {
+				auto* data = static_cast<std::byte*>(_m_memory->allocate(block_size, alignof(std::max_align_t)));
+
+				try {
+					auto it = _m_blocks.begin() + static_cast<std::ptrdiff_t>(_m_next_block);
+					_m_blocks.insert(it, Block {data, block_size});
+				} catch (...) {
+					_m_memory->deallocate(data, block_size, alignof(std::max_align_t));
+					throw;
+				}
+			}
+
+			auto& block = _m_blocks[_m_next_block++];
+			_m_cursor = block.data;
+			_m_left = block.size;
+			padding = (alignment - reinterpret_cast<std::uintptr_t>(_m_cursor) % alignment) % alignment;
+		}
+
+		auto* ptr = _m_cursor + padding;
+		_m_cursor += padding + size;
+		_m_left -= padding + size;
+		_m_used += size;
+		return ptr;
+	}
+
+	std::size_t ObjectArena::block_count() const noexcept {
+		return _m_blocks.size();
+	}
+
+	std::size_t ObjectArena::bytes_used() const noexcept {
+		return _m_used;
+	}
+
+	bool ObjectArena::reset() noexcept {
+		// Every object allocated in the arena holds a reference to it through its allocator.
+		if (this->weak_from_this().use_count() > 1) return false;
+
+		auto it = std::remove_if(_m_blocks.begin(), _m_blocks.end(), [this](Block const& block) {
+			if (block.size == _m_block_size) return false;
+			_m_memory->deallocate(block.data, block.size, alignof(std::max_align_t));
+			return true;
+		});
+		_m_blocks.erase(it, _m_blocks.end());
+
+		_m_next_block = 0;
+		_m_cursor = nullptr;
+		_m_left = 0;
+		_m_used = 0;
+		return true;
+	}
+
+	StringPool::StringPool() : _m_storage(ObjectArena::create(64 * 1024)) {
+		_m_strings.emplace_back();
+		_m_handles.emplace(std::string_view {}, 0);
+	}
+
+	std::uint32_t StringPool::intern(std::string_view s) {
+		if (auto it = _m_handles.find(s); it != _m_handles.end()) return it->second;
+
+		auto* data = static_cast<char*>(_m_storage->allocate(s.size(), 1));
+		std::memcpy(data, s.data(), s.size());
+
+		auto handle = static_cast<std::uint32_t>(_m_strings.size());
+		auto& stored = _m_strings.emplace_back(data, s.size());
+		_m_handles.emplace(stored, handle);
+		return handle;
+	}
+
+	std::optional<std::uint32_t> StringPool::find(std::string_view s) const {
+		auto it = _m_handles.find(s);
+		if (it == _m_handles.end()) return std::nullopt;
+		return it->second;
+	}
+
+	std::string_view StringPool::get(std::uint32_t handle) const noexcept {
+		if (handle >= _m_strings.size()) return {};
+		return _m_strings[handle];
+	}
+
+	std::size_t StringPool::size() const noexcept {
+		return _m_strings.size();
+	}
+
+	std::size_t StringPool::bytes_used() const noexcept {
+		return _m_storage->bytes_used();
+	}
+} // namespace zenkit
@@ -2,15 +2,21 @@
 // SPDX-License-Identifier: MIT
 #include "zenkit/SaveGame.hh"
 #include "zenkit/Archive.hh"
+#include "zenkit/Executor.hh"
 #include "zenkit/Stream.hh"
 #include "zenkit/World.hh"
+#include "zenkit/world/WorldPatch.hh"
 
 #include "Internal.hh"
 
 #include <algorithm>
 #include <set>
+#include <utility>
 
 namespace zenkit {
+	static constexpr std::string_view WORLD_EXTENSION = ".SAV";
+	static constexpr std::string_view DELTA_EXTENSION = ".DELTA";
+
 	void SaveMetadata::load(ReadArchive& r, GameVersion version) {
 		this->title = r.read_string();          // Title
 		this->world = r.read_string();          // WorldName
@@ -264,17 +270,79 @@ namespace zenkit {
 	}
 
 	std::shared_ptr<World> SaveGame::load_world(std::string_view world_name) const {
-		auto path = _m_path / world_name;
-		path.replace_extension("SAV");
+		return this->load_world(world_name, WorldLoadOptions {});
+	}
+
+	std::filesystem::path const* SaveGame::find_world(std::string_view name, std::string_view extension) const {
+		auto stem = std::filesystem::path {name}.stem().string();
+		auto path = std::find_if(_m_worlds.begin(), _m_worlds.end(), [&](std::filesystem::path const& p) {
+			return iequals(p.stem().string(), stem) && iequals(p.extension().string(), extension);
+		});
 
-		if (!std::filesystem::exists(path)) return nullptr;
+		return path == _m_worlds.end() ? nullptr : &*path;
+	}
+
+	std::shared_ptr<World> SaveGame::load_world(std::string_view world_name, WorldLoadOptions const& options) const {
+		auto const* path = this->find_world(world_name, WORLD_EXTENSION);
+		if (path == nullptr) return nullptr;
 
-		auto r = Read::from(path);
-		auto ar = ReadArchive::from(r.get());
-		return ar->read_object<World>(_m_version);
+		auto r = Read::from(*path);
+		auto world = std::make_shared<World>();
+		world->load(r.get(), _m_version, options);
+		return world;
+	}
+
+	std::vector<std::string> SaveGame::worlds() const {
+		std::vector<std::string> names;
+		for (auto& path : _m_worlds) {
+			// Worlds may be stored both in full and as a delta.
+			auto stem = path.stem().string();
+			if (names.empty() || !iequals(names.back(), stem)) names.push_back(std::move(stem));
+		}
+		return names;
+	}
+
+	bool SaveGame::load_world_delta(std::string_view world_name, World& base) const {
+		auto const* path = this->find_world(world_name, DELTA_EXTENSION);
+		if (path == nullptr) return false;
+
+		auto r = Read::from(*path);
+		WorldPatch patch {};
+		patch.load(r.get(), _m_version);
+		patch.apply(base);
+		return true;
+	}
+
+	void SaveGame::index_worlds() {
+		// Every `.SAV` file in the directory, except for the files belonging to the save-game itself, is a world.
+		static constexpr std::string_view NON_WORLD_FILES[] = {"SAVEINFO", "SAVEDAT", "SAVEHDR", "THUMB", "LOG"};
+
+		_m_worlds.clear();
+		for (auto& file : std::filesystem::directory_iterator(_m_path)) {
+			auto path = file.path();
+			if (!file.is_regular_file()) continue;
+
+			auto extension = path.extension().string();
+			if (!iequals(extension, WORLD_EXTENSION) && !iequals(extension, DELTA_EXTENSION)) continue;
+
+			auto stem = path.stem().string();
+			if (std::any_of(std::begin(NON_WORLD_FILES), std::end(NON_WORLD_FILES), [&stem](std::string_view n) {
+				    return iequals(stem, n);
+			    })) {
+				continue;
+			}
+
+			_m_worlds.push_back(std::move(path));
+		}
+
+		std::sort(_m_worlds.begin(), _m_worlds.end());
 	}
 
 	void SaveGame::load(std::filesystem::path const& path) {
+		this->load(path, SaveGameLoadOptions {});
+	}
+
+	void SaveGame::load(std::filesystem::path const& path, SaveGameLoadOptions const& options) {
 		this->_m_path = path;
 
 		if (!std::filesystem::is_directory(path)) {
@@ -301,7 +369,7 @@ namespace zenkit {
 		}
 
 		// Load THUMB.SAV
-		{
+		if (!options.skip_thumbnail) {
 			ZKLOGI("SaveGame", "Loading THUMB.SAV");
 			if (auto file_thumb = find_file_matching(entries, "THUMB.SAV")) {
 				auto r = Read::from(*file_thumb);
@@ -312,7 +380,7 @@ namespace zenkit {
 		}
 
 		// Load SAVEDAT.SAV
-		{
+		if (!options.skip_state) {
 			ZKLOGI("SaveGame", "Loading SAVEDAT.SAV");
 			auto file_save_dat = find_file_matching(entries, "SAVEDAT.SAV");
 			if (!file_save_dat) {
@@ -324,35 +392,43 @@ namespace zenkit {
 			auto ar = ReadArchive::from(r.get());
 			this->state.load(*ar, _m_version);
 		}
+
+		this->index_worlds();
 	}
 
-	void SaveGame::save(std::filesystem::path const& path, World& world, std::string const& world_name) {
+	static void prepare_save_directory(std::filesystem::path const& from, std::filesystem::path const& path) {
 		// Copy over the current save if necessary.
-		if (_m_path != path) {
-			if (std::filesystem::exists(path)) {
-				std::filesystem::remove_all(path);
-			}
+		if (from == path) return;
 
-			if (!_m_path.empty() && std::filesystem::exists(_m_path)) {
-				std::filesystem::copy(_m_path, path, std::filesystem::copy_options::recursive);
-			} else {
-				std::filesystem::create_directories(path);
-			}
+		if (std::filesystem::exists(path)) {
+			std::filesystem::remove_all(path);
+		}
+
+		if (!from.empty() && std::filesystem::exists(from)) {
+			std::filesystem::copy(from, path, std::filesystem::copy_options::recursive);
+		} else {
+			std::filesystem::create_directories(path);
 		}
+	}
 
+	static void write_save_files(std::filesystem::path const& path,
+	                             SaveMetadata const& metadata,
+	                             std::optional<Texture> const& thumbnail,
+	                             std::string const& world_name,
+	                             GameVersion version) {
 		{
 			auto w = Write::to(path / "SAVEINFO.SAV");
 			auto ar = WriteArchive::to(w.get(), ArchiveFormat::ASCII);
 
-			ar->write_object("%", &this->metadata, _m_version);
+			ar->write_object("%", &metadata, version);
 			ar->write_header();
 		}
 
 		{
 			auto w = Write::to(path / "THUMB.SAV");
 
-			if (this->thumbnail) {
-				this->thumbnail->save(w.get());
+			if (thumbnail) {
+				thumbnail->save(w.get());
 			}
 		}
 
@@ -361,24 +437,113 @@ namespace zenkit {
 			w->write_string(world_name);
 			w->write_string(".ZEN\n");
 		}
+	}
 
-		{
-			auto w = Write::to(path / "SAVEDAT.SAV");
-			auto ar = WriteArchive::to_save(w.get(), ArchiveFormat::ASCII);
+	static void write_save_state(std::filesystem::path const& path, SaveState const& state, GameVersion version) {
+		auto w = Write::to(path / "SAVEDAT.SAV");
+		auto ar = WriteArchive::to_save(w.get(), ArchiveFormat::ASCII);
 
-			this->state.save(*ar, _m_version);
-			ar->write_header();
-		}
+		state.save(*ar, version);
+		ar->write_header();
+	}
 
-		{
-			auto w = Write::to(path / (world_name + ".SAV"));
-			auto ar = WriteArchive::to_save(w.get(), ArchiveFormat::BINARY);
+	static void write_save_world(std::filesystem::path const& path,
+	                             World const& world,
+	                             std::string const& world_name,
+	                             GameVersion version) {
+		// A delta of the world copied over from the previous save is outdated now.
+		std::filesystem::remove(path / (world_name + std::string {DELTA_EXTENSION}));
 
-			ar->write_object("%", &world, _m_version);
-			ar->write_header();
+		auto w = Write::to(path / (world_name + std::string {WORLD_EXTENSION}));
+		auto ar = WriteArchive::to_save(w.get(), ArchiveFormat::BINARY);
+
+		ar->write_object("%", &world, version);
+		ar->write_header();
+	}
+
+	static void write_save_delta(std::filesystem::path const& path,
+	                             World const& base,
+	                             World const& world,
+	                             std::string const& world_name,
+	                             GameVersion version) {
+		std::filesystem::remove(path / (world_name + std::string {WORLD_EXTENSION}));
+
+		auto patch = WorldPatch::diff(base, world, version, true);
+		auto w = Write::to(path / (world_name + std::string {DELTA_EXTENSION}));
+		patch.save(w.get(), version, ArchiveFormat::BINARY);
+	}
+
+	void SaveGame::save(std::filesystem::path const& path, World& world, std::string const& world_name) {
+		prepare_save_directory(_m_path, path);
+		write_save_files(path, this->metadata, this->thumbnail, world_name, _m_version);
+		write_save_state(path, this->state, _m_version);
+		write_save_world(path, world, world_name, _m_version);
+
+		_m_path = path;
+		this->index_worlds();
+	}
+
+	void SaveGame::save_delta(std::filesystem::path const& path,
+	                          World const& base,
+	                          World const& world,
+	                          std::string const& world_name) {
+		prepare_save_directory(_m_path, path);
+		write_save_files(path, this->metadata, this->thumbnail, world_name, _m_version);
+		write_save_state(path, this->state, _m_version);
+		write_save_delta(path, base, world, world_name, _m_version);
+
+		_m_path = path;
+		this->index_worlds();
+	}
+
+	std::future<void> SaveGame::save_async(std::filesystem::path const& path,
+	                                       std::shared_ptr<World const> world,
+	                                       std::string const& world_name) {
+#ifndef _ZK_WITH_THREADS
+		// Without thread support, the save is written when the future is waited on.
+		constexpr auto policy = std::launch::deferred;
+#else
+		constexpr auto policy = std::launch::async;
+#endif
+
+		// The world files the save will contain once it is written.
+		std::vector<std::filesystem::path> worlds;
+		if (_m_path != path && !_m_path.empty()) {
+			for (auto& world_path : _m_worlds) {
+				worlds.push_back(path / world_path.filename());
+			}
+		} else if (_m_path == path) {
+			worlds = _m_worlds;
 		}
 
+		auto world_path = path / (world_name + std::string {WORLD_EXTENSION});
+		worlds.erase(std::remove(worlds.begin(), worlds.end(), path / (world_name + std::string {DELTA_EXTENSION})),
+		             worlds.end());
+		if (std::find(worlds.begin(), worlds.end(), world_path) == worlds.end()) worlds.push_back(world_path);
+		std::sort(worlds.begin(), worlds.end());
+
+		// Snapshot everything except for the world, which is only referenced.
+		auto task = [from = _m_path,
+		             path,
+		             version = _m_version,
+		             metadata = this->metadata,
+		             state = this->state,
+		             thumbnail = this->thumbnail,
+		             world = std::move(world),
+		             world_name]() {
+			prepare_save_directory(from, path);
+
+			// The world is usually much larger than the rest of the save, so it is written in parallel.
+			TaskGroup world_task;
+			world_task.run([&] { write_save_world(path, *world, world_name, version); });
+			write_save_files(path, metadata, thumbnail, world_name, version);
+			write_save_state(path, state, version);
+			world_task.wait();
+		};
+
 		_m_path = path;
+		_m_worlds = std::move(worlds);
+		return std::async(policy, std::move(task));
 	}
 
 	std::shared_ptr<World> SaveGame::load_world() const {
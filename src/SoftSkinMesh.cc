@@ -17,13 +17,18 @@ namespace zenkit {
 	};
 
 	void SoftSkinMesh::load(Read* r) {
-		proto::read_chunked<SoftSkinMeshChunkType>(r, "SoftSkinMesh", [this](Read* c, SoftSkinMeshChunkType type) {
+		this->load(r, MultiResolutionMeshLoadOptions {});
+	}
+
+	void SoftSkinMesh::load(Read* r, MultiResolutionMeshLoadOptions const& options) {
+		MemoryScope memory {MemoryCategory::MESH};
+		proto::read_chunked<SoftSkinMeshChunkType>(r, "SoftSkinMesh", [this, &options](Read* c, SoftSkinMeshChunkType type) {
 			switch (type) {
 			case SoftSkinMeshChunkType::HEADER:
 				(void) /* version = */ c->read_uint();
 				break;
 			case SoftSkinMeshChunkType::PROTO:
-				mesh.load_from_section(c);
+				mesh.load_from_section(c, options);
 				break;
 			case SoftSkinMeshChunkType::NODES: {
 				// weights
@@ -67,6 +72,7 @@ namespace zenkit {
 					bbox.load(c);
 				}
 
+				this->pack_weights();
 				break;
 			}
 			case SoftSkinMeshChunkType::END:
@@ -125,4 +131,77 @@ namespace zenkit {
 
 		proto::write_chunk(w, SoftSkinMeshChunkType::END, [](Write*) {});
 	}
+
+	void SoftSkinMesh::pack_weights() {
+		auto& packed = this->packed_weights;
+		packed.offsets.resize(this->weights.size() + 1);
+		packed.weights.clear();
+		packed.positions.clear();
+		packed.node_indices.clear();
+
+		std::size_t total = 0;
+		for (auto& vertex : this->weights) {
+			total += vertex.size();
+		}
+
+		packed.weights.reserve(total);
+		packed.positions.reserve(total);
+		packed.node_indices.reserve(total);
+
+		for (auto i = 0u; i < this->weights.size(); ++i) {
+			packed.offsets[i] = static_cast<std::uint32_t>(packed.weights.size());
+
+			for (auto& entry : this->weights[i]) {
+				packed.weights.push_back(entry.weight);
+				packed.positions.push_back(entry.position);
+				packed.node_indices.push_back(entry.node_index);
+			}
+		}
+
+		packed.offsets.back() = static_cast<std::uint32_t>(packed.weights.size());
+	}
+
+	void SoftSkinMesh::skin(Mat3x4 const* node_transforms, std::size_t node_transform_count, Vec3* positions) const {
+		// Resolve the transform of each node of the mesh once. Nodes without a transform don't contribute.
+		std::vector<Mat3x4 const*> transforms(this->nodes.size(), nullptr);
+		for (auto i = 0u; i < this->nodes.size(); ++i) {
+			auto node = this->nodes[i];
+			if (node >= 0 && static_cast<std::size_t>(node) < node_transform_count) {
+				transforms[i] = node_transforms + node;
+			}
+		}
+
+		auto accumulate = [&transforms](Vec3& out, float weight, Vec3 const& position, std::uint8_t node) {
+			if (node >= transforms.size() || transforms[node] == nullptr) return;
+
+			auto p = transforms[node]->transform_point(position);
+			out.x += p.x * weight;
+			out.y += p.y * weight;
+			out.z += p.z * weight;
+		};
+
+		auto const& packed = this->packed_weights;
+		auto count = this->mesh.positions.size();
+
+		if (packed.offsets.size() == this->weights.size() + 1 && this->weights.size() == count) {
+			for (std::size_t i = 0; i < count; ++i) {
+				Vec3 out {0, 0, 0};
+				for (auto j = packed.offsets[i]; j < packed.offsets[i + 1]; ++j) {
+					accumulate(out, packed.weights[j], packed.positions[j], packed.node_indices[j]);
+				}
+				positions[i] = out;
+			}
+			return;
+		}
+
+		for (std::size_t i = 0; i < count; ++i) {
+			Vec3 out {0, 0, 0};
+			if (i < this->weights.size()) {
+				for (auto& entry : this->weights[i]) {
+					accumulate(out, entry.weight, entry.position, entry.node_index);
+				}
+			}
+			positions[i] = out;
+		}
+	}
 } // namespace zenkit
@@ -1,13 +1,20 @@
 // Copyright © 2022-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include "zenkit/Stream.hh"
+#include "zenkit/Error.hh"
 #include "zenkit/Mmap.hh"
 
 #include "Internal.hh"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
 
 namespace zenkit {
 	template <typename T>
@@ -17,6 +24,16 @@ namespace zenkit {
 		return v;
 	}
 
+	template <typename T>
+	ZKINT void read_array_any(Read* r, T* out, size_t count) noexcept {
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		auto bytes = r->read(out, sizeof(T) * count);
+		if (bytes < sizeof(T) * count) {
+			memset(reinterpret_cast<std::byte*>(out) + bytes, 0, sizeof(T) * count - bytes);
+		}
+	}
+
 	template <typename T>
 	ZKINT void write_any(Write* r, T const& v) noexcept {
 		r->write(&v, sizeof v);
@@ -78,12 +95,54 @@ namespace zenkit {
 		return v.transpose();
 	}
 
+	void Read::read_ushort_array(uint16_t* out, size_t count) noexcept {
+		read_array_any(this, out, count);
+	}
+
+	void Read::read_uint_array(uint32_t* out, size_t count) noexcept {
+		read_array_any(this, out, count);
+	}
+
+	void Read::read_float_array(float* out, size_t count) noexcept {
+		read_array_any(this, out, count);
+	}
+
+	void Read::read_vec2_array(Vec2* out, size_t count) noexcept {
+		static_assert(sizeof(Vec2) == sizeof(float) * 2);
+		read_array_any(this, out, count);
+	}
+
+	void Read::read_vec3_array(Vec3* out, size_t count) noexcept {
+		static_assert(sizeof(Vec3) == sizeof(float) * 3);
+		read_array_any(this, out, count);
+	}
+
 	std::string Read::read_string(size_t len) noexcept {
 		std::string str(len, '\0');
 		this->read(str.data(), len);
 		return str;
 	}
 
+	ReadSpan Read::as_contiguous() noexcept {
+		return {};
+	}
+
+	void Read::prefetch(size_t, size_t) noexcept {}
+
+	void Read::advise_sequential() noexcept {}
+
+	std::unique_ptr<Read> Read::slice(size_t len) {
+		if (auto span = this->as_contiguous(); span.data() != nullptr) {
+			len = std::min(len, span.size());
+			this->seek(static_cast<ssize_t>(len), Whence::CUR);
+			return Read::from(span.data(), len);
+		}
+
+		std::vector<std::byte> bytes(len);
+		bytes.resize(this->read(bytes.data(), len));
+		return Read::from(std::move(bytes));
+	}
+
 	std::string Read::read_line(bool skipws) noexcept {
 		return read_line_then_ignore(skipws ? " \t\r\n\v\f" : "");
 	}
@@ -111,6 +170,11 @@ namespace zenkit {
 		return str;
 	}
 
+	std::string_view Read::read_line_view(bool skipws, std::string& buffer) noexcept {
+		buffer = this->read_line(skipws);
+		return buffer;
+	}
+
 	void Write::write_char(char v) noexcept {
 		write_any(this, v);
 	}
@@ -240,6 +304,9 @@ namespace zenkit {
 			}
 
 			void seek(ssize_t off, Whence whence) noexcept override {
+				// Like fseek, seeking should reset the end-of-file condition. A short read also sets the failbit
+				// which would otherwise cause seekg to be ignored.
+				_m_stream->clear();
 				_m_stream->seekg(off, INTO_CXX_WHENCE[static_cast<int>(whence)]);
 			}
 
@@ -255,6 +322,114 @@ namespace zenkit {
 			std::istream* _m_stream;
 		};
 
+		/// \brief Serves reads from another Read in large blocks.
+		///
+		/// The source stream is only accessed when the internal buffer is exhausted or when seeking outside of the
+		/// buffered window. Reads larger than the buffer itself bypass it entirely.
+		class ReadBuffered final ZKINT : public Read {
+		public:
+			ReadBuffered(std::unique_ptr<Read> source, size_t buffer_size)
+			    : _m_source(std::move(source)), _m_buffer(std::max<size_t>(buffer_size, 1)) {
+				_m_position = _m_source->tell();
+				_m_source_position = _m_position;
+				_m_buffer_start = _m_position;
+			}
+
+			size_t read(void* buf, size_t len) noexcept override {
+				auto* out = static_cast<std::byte*>(buf);
+				size_t total = 0;
+
+				while (len > 0) {
+					auto available = this->buffered();
+
+					if (available == 0) {
+						// Large reads go straight to the source to avoid copying twice.
+						if (len >= _m_buffer.size()) {
+							this->sync_source();
+							auto n = _m_source->read(out, len);
+							_m_position += n;
+							_m_source_position += n;
+							_m_buffer_start = _m_position;
+							_m_buffer_length = 0;
+							_m_eof = n < len;
+							return total + n;
+						}
+
+						if (this->refill() == 0) break;
+						available = this->buffered();
+					}
+
+					auto n = std::min(len, available);
+					memcpy(out, _m_buffer.data() + (_m_position - _m_buffer_start), n);
+
+					out += n;
+					len -= n;
+					total += n;
+					_m_position += n;
+				}
+
+				return total;
+			}
+
+			void seek(ssize_t off, Whence whence) noexcept override {
+				size_t end = 0;
+
+				if (whence == Whence::END) {
+					_m_source->seek(0, Whence::END);
+					end = _m_source->tell();
+					_m_source_position = end;
+				}
+
+				auto new_position = seek_internal(_m_position, end, off, whence);
+				if (static_cast<ssize_t>(new_position) < 0) return;
+
+				_m_position = new_position;
+				_m_eof = false;
+
+				// Keep the buffer if the new position is still inside of it.
+				if (_m_position < _m_buffer_start || _m_position > _m_buffer_start + _m_buffer_length) {
+					_m_buffer_start = _m_position;
+					_m_buffer_length = 0;
+				}
+			}
+
+			[[nodiscard]] size_t tell() const noexcept override {
+				return _m_position;
+			}
+
+			[[nodiscard]] bool eof() const noexcept override {
+				return _m_eof && this->buffered() == 0;
+			}
+
+		private:
+			[[nodiscard]] size_t buffered() const noexcept {
+				return _m_buffer_start + _m_buffer_length - _m_position;
+			}
+
+			void sync_source() noexcept {
+				if (_m_source_position != _m_position) {
+					_m_source->seek(static_cast<ssize_t>(_m_position), Whence::BEG);
+					_m_source_position = _m_position;
+				}
+			}
+
+			size_t refill() noexcept {
+				this->sync_source();
+
+				_m_buffer_start = _m_position;
+				_m_buffer_length = _m_source->read(_m_buffer.data(), _m_buffer.size());
+				_m_source_position += _m_buffer_length;
+				_m_eof = _m_buffer_length < _m_buffer.size();
+				return _m_buffer_length;
+			}
+
+			std::unique_ptr<Read> _m_source;
+			std::vector<std::byte> _m_buffer;
+			size_t _m_buffer_start {0}, _m_buffer_length {0};
+			size_t _m_position {0}, _m_source_position {0};
+			bool _m_eof {false};
+		};
+
 		class ReadMemory ZKINT : public Read {
 		public:
 			ReadMemory(std::byte const* byte, size_t len) : _m_bytes(byte), _m_length(len) {}
@@ -282,7 +457,63 @@ namespace zenkit {
 				return _m_position >= _m_length;
 			}
 
+			[[nodiscard]] ReadSpan as_contiguous() noexcept override {
+				return {_m_bytes + _m_position, _m_length - _m_position};
+			}
+
+			[[nodiscard]] std::string read_line_then_ignore(std::string_view chars) noexcept override {
+				return std::string {this->scan_line(chars)};
+			}
+
+			[[nodiscard]] std::string_view read_line_view(bool skipws, std::string&) noexcept override {
+				return this->scan_line(skipws ? " \t\r\n\v\f" : "");
+			}
+
 		private:
+			/// \brief Implements Read::read_line_then_ignore directly on the buffer.
+			std::string_view scan_line(std::string_view chars) noexcept {
+				auto const* begin = reinterpret_cast<char const*>(_m_bytes) + _m_position;
+				auto remaining = _m_length - _m_position;
+
+				// Lines end at '\n', '\r' or '\0'. Find the closest one of them.
+				auto const* end = static_cast<char const*>(memchr(begin, '\n', remaining));
+				auto bound = end == nullptr ? remaining : static_cast<size_t>(end - begin);
+
+				if (auto const* cr = static_cast<char const*>(memchr(begin, '\r', bound)); cr != nullptr) {
+					bound = static_cast<size_t>(cr - begin);
+				}
+
+				if (auto const* nul = static_cast<char const*>(memchr(begin, '\0', bound)); nul != nullptr) {
+					bound = static_cast<size_t>(nul - begin);
+				}
+
+				std::string_view line {begin, bound};
+
+				// Don't ignore the given chars if we're at the end of a C-style string.
+				if (bound == remaining) {
+					_m_position = _m_length;
+					return line;
+				}
+
+				auto terminator = begin[bound];
+				_m_position += bound + 1;
+
+				if (chars.empty() || terminator == '\0' || _m_position >= _m_length) return line;
+
+				auto const* data = reinterpret_cast<char const*>(_m_bytes);
+				while (_m_position < _m_length && data[_m_position] != '\0' &&
+				       chars.find(data[_m_position]) != std::string_view::npos) {
+					++_m_position;
+				}
+
+				// A null-byte at the very end of the buffer is consumed as well.
+				if (_m_position + 1 == _m_length && data[_m_position] == '\0') {
+					_m_position = _m_length;
+				}
+
+				return line;
+			}
+
 			std::byte const* _m_bytes;
 			size_t _m_length, _m_position {0};
 		};
@@ -303,6 +534,14 @@ namespace zenkit {
 
 			explicit ReadMmap(Mmap mmap) : ReadMemory(mmap.data(), mmap.size()), _m_mmap(std::move(mmap)) {}
 
+			void prefetch(size_t offset, size_t len) noexcept override {
+				_m_mmap.prefetch(offset, len);
+			}
+
+			void advise_sequential() noexcept override {
+				_m_mmap.advise_sequential();
+			}
+
 		private:
 			Mmap _m_mmap;
 		};
@@ -324,6 +563,10 @@ namespace zenkit {
 				return static_cast<size_t>(ftell(_m_stream));
 			}
 
+			void flush() noexcept override {
+				fflush(_m_stream);
+			}
+
 		private:
 			FILE* _m_stream;
 		};
@@ -357,11 +600,163 @@ namespace zenkit {
 				return _m_stream->tellp();
 			}
 
+			void flush() noexcept override {
+				_m_stream->flush();
+			}
+
 		private:
 			std::ostream* _m_stream;
 			bool _m_own;
 		};
 
+		/// \brief Collects writes in a buffer before passing them on to another Write.
+		///
+		/// Seeking back into the buffered window (e.g. to patch in a chunk size) is handled in memory. Seeking
+		/// anywhere else flushes the buffer first.
+		class WriteBuffered final ZKINT : public Write {
+		public:
+			WriteBuffered(std::unique_ptr<Write> sink, size_t buffer_size)
+			    : _m_sink(std::move(sink)), _m_buffer(std::max<size_t>(buffer_size, 1)) {
+				_m_position = _m_sink->tell();
+				_m_sink_position = _m_position;
+				_m_buffer_start = _m_position;
+			}
+
+			~WriteBuffered() noexcept override {
+				this->flush_buffer();
+			}
+
+			size_t write(void const* buf, size_t len) noexcept override {
+				auto const* in = static_cast<std::byte const*>(buf);
+				auto total = len;
+
+				if (_m_position < _m_buffer_start || _m_position > _m_buffer_start + _m_buffer_length) {
+					this->flush_buffer();
+				}
+
+				while (len > 0) {
+					auto offset = _m_position - _m_buffer_start;
+
+					if (offset == _m_buffer.size()) {
+						this->flush_buffer();
+						offset = 0;
+
+						// Large writes go straight to the sink.
+						if (len >= _m_buffer.size()) {
+							this->sync_sink();
+							auto n = _m_sink->write(in, len);
+							_m_sink_position += n;
+							_m_position += n;
+							_m_buffer_start = _m_position;
+							return total - len + n;
+						}
+					}
+
+					auto n = std::min(len, _m_buffer.size() - offset);
+					memcpy(_m_buffer.data() + offset, in, n);
+
+					in += n;
+					len -= n;
+					_m_position += n;
+					_m_buffer_length = std::max(_m_buffer_length, _m_position - _m_buffer_start);
+				}
+
+				return total;
+			}
+
+			void seek(ssize_t off, Whence whence) noexcept override {
+				size_t end = 0;
+
+				if (whence == Whence::END) {
+					this->flush_buffer();
+					_m_sink->seek(0, Whence::END);
+					end = _m_sink->tell();
+					_m_sink_position = end;
+				}
+
+				auto new_position = seek_internal(_m_position, end, off, whence);
+				if (static_cast<ssize_t>(new_position) < 0) return;
+				_m_position = new_position;
+			}
+
+			[[nodiscard]] size_t tell() const noexcept override {
+				return _m_position;
+			}
+
+			void flush() noexcept override {
+				this->flush_buffer();
+				_m_sink->flush();
+			}
+
+		private:
+			void sync_sink() noexcept {
+				if (_m_sink_position != _m_buffer_start) {
+					_m_sink->seek(static_cast<ssize_t>(_m_buffer_start), Whence::BEG);
+					_m_sink_position = _m_buffer_start;
+				}
+			}
+
+			void flush_buffer() noexcept {
+				if (_m_buffer_length != 0) {
+					this->sync_sink();
+					_m_sink_position += _m_sink->write(_m_buffer.data(), _m_buffer_length);
+				}
+
+				_m_buffer_start = _m_position;
+				_m_buffer_length = 0;
+			}
+
+			std::unique_ptr<Write> _m_sink;
+			std::vector<std::byte> _m_buffer;
+			size_t _m_buffer_start {0}, _m_buffer_length {0};
+			size_t _m_position {0}, _m_sink_position {0};
+		};
+
+#ifdef _ZK_WITH_MMAP
+		class WriteMmap final ZKINT : public Write {
+		public:
+			/// \brief The minimum number of bytes to grow the mapping by when it is full.
+			static constexpr size_t GROWTH = 64 * 1024 * 1024;
+
+			WriteMmap(std::filesystem::path const& path, size_t initial_size) : _m_mmap(path, initial_size) {}
+
+			~WriteMmap() noexcept override {
+				_m_mmap.truncate(_m_length);
+			}
+
+			size_t write(void const* buf, size_t len) noexcept override {
+				if (_m_position + len > _m_mmap.size()) {
+					try {
+						_m_mmap.resize(std::max(_m_position + len, _m_mmap.size() + std::max(_m_mmap.size(), GROWTH)));
+					} catch (std::runtime_error const&) {
+						return 0;
+					}
+				}
+
+				memcpy(_m_mmap.data() + _m_position, buf, len);
+				_m_position += len;
+				_m_length = std::max(_m_length, _m_position);
+				return len;
+			}
+
+			void seek(ssize_t off, Whence whence) noexcept override {
+				_m_position = seek_internal(_m_position, _m_length, off, whence);
+			}
+
+			[[nodiscard]] size_t tell() const noexcept override {
+				return _m_position;
+			}
+
+			void flush() noexcept override {
+				_m_mmap.sync();
+			}
+
+		private:
+			MutableMmap _m_mmap;
+			size_t _m_position {0}, _m_length {0};
+		};
+#endif
+
 		class WriteStatic final ZKINT : public Write {
 		public:
 			explicit WriteStatic(std::byte* buf, size_t len) : _m_bytes(buf), _m_length(len) {}
@@ -422,8 +817,401 @@ namespace zenkit {
 			std::vector<std::byte>* _m_vector;
 			size_t _m_position {0};
 		};
+
+		/// \brief The magic bytes at the start of a compressed stream.
+		static constexpr char COMPRESSED_MAGIC[4] {'Z', 'K', 'L', 'Z'};
+
+		/// \brief The magic bytes at the very end of a compressed stream, following the frame index.
+		static constexpr char COMPRESSED_INDEX_MAGIC[4] {'Z', 'K', 'L', 'I'};
+
+		/// \brief Set in a frame's size field if the frame is stored without compression.
+		static constexpr uint32_t COMPRESSED_FRAME_RAW = 0x8000'0000;
+
+		/// \brief The size of the fields following the frame index (total size, frame count and magic).
+		static constexpr size_t COMPRESSED_TRAILER_SIZE = sizeof(uint64_t) + sizeof(uint32_t) + 4;
+
+		/// \brief An upper bound of the ratio between the decompressed and the compressed size of an LZ4 block.
+		static constexpr size_t COMPRESSED_MAX_RATIO = 256;
+
+		ZKINT inline size_t lz4_compress_bound(size_t len) {
+			return len + len / 255 + 16;
+		}
+
+		ZKINT inline uint8_t* lz4_write_length(uint8_t* op, size_t len) {
+			for (; len >= 255; len -= 255) {
+				*op++ = 255;
+			}
+
+			*op++ = static_cast<uint8_t>(len);
+			return op;
+		}
+
+		/// \brief Compresses \p len bytes into a single LZ4 block.
+		///
+		/// \p dst must be able to hold at least lz4_compress_bound(len) bytes.
+		/// \return The number of bytes written to \p dst.
+		ZKINT size_t lz4_compress(uint8_t const* src, size_t len, uint8_t* dst) {
+			static constexpr size_t MIN_MATCH = 4;
+			static constexpr size_t LAST_LITERALS = 5;
+			static constexpr size_t MF_LIMIT = 12;
+			static constexpr size_t HASH_BITS = 12;
+
+			auto emit = [](uint8_t* op, uint8_t const* lit, size_t lit_len, size_t offset, size_t match_len) {
+				auto* token = op++;
+				*token = static_cast<uint8_t>(std::min<size_t>(lit_len, 15) << 4);
+				if (lit_len >= 15) op = lz4_write_length(op, lit_len - 15);
+
+				memcpy(op, lit, lit_len);
+				op += lit_len;
+
+				if (match_len == 0) return op;
+
+				*op++ = static_cast<uint8_t>(offset & 0xFF);
+				*op++ = static_cast<uint8_t>(offset >> 8);
+
+				match_len -= MIN_MATCH;
+				*token |= static_cast<uint8_t>(std::min<size_t>(match_len, 15));
+				if (match_len >= 15) op = lz4_write_length(op, match_len - 15);
+				return op;
+			};
+
+			auto load32 = [src](size_t pos) {
+				uint32_t v;
+				memcpy(&v, src + pos, sizeof v);
+				return v;
+			};
+
+			auto* op = dst;
+			size_t anchor = 0;
+
+			if (len > MF_LIMIT) {
+				std::vector<uint32_t> table(1 << HASH_BITS, 0);
+				size_t match_limit = len - LAST_LITERALS;
+				size_t ip = 0;
+
+				while (ip < len - MF_LIMIT) {
+					auto seq = load32(ip);
+					auto hash = (seq * 2654435761U) >> (32 - HASH_BITS);
+					size_t ref = table[hash];
+					table[hash] = static_cast<uint32_t>(ip);
+
+					if (ref >= ip || ip - ref > 0xFFFF || load32(ref) != seq) {
+						++ip;
+						continue;
+					}
+
+					size_t match_len = MIN_MATCH;
+					while (ip + match_len < match_limit && src[ref + match_len] == src[ip + match_len]) {
+						++match_len;
+					}
+
+					op = emit(op, src + anchor, ip - anchor, ip - ref, match_len);
+					ip += match_len;
+					anchor = ip;
+				}
+			}
+
+			op = emit(op, src + anchor, len - anchor, 0, 0);
+			return static_cast<size_t>(op - dst);
+		}
+
+		/// \brief Decompresses a single LZ4 block which must expand to exactly \p dst_len bytes.
+		/// \return `true` if the block was decompressed successfully and `false` if it is malformed.
+		ZKINT bool lz4_decompress(uint8_t const* src, size_t src_len, uint8_t* dst, size_t dst_len) {
+			size_t ip = 0, op = 0;
+
+			auto read_length = [&](size_t& len) {
+				uint8_t b;
+				do {
+					if (ip >= src_len) return false;
+					b = src[ip++];
+					len += b;
+				} while (b == 255);
+				return true;
+			};
+
+			while (ip < src_len) {
+				auto token = src[ip++];
+
+				size_t lit_len = token >> 4;
+				if (lit_len == 15 && !read_length(lit_len)) return false;
+				if (lit_len > src_len - ip || lit_len > dst_len - op) return false;
+
+				memcpy(dst + op, src + ip, lit_len);
+				ip += lit_len;
+				op += lit_len;
+
+				// The last sequence only contains literals.
+				if (ip == src_len) break;
+				if (src_len - ip < 2) return false;
+
+				size_t offset = src[ip] | (src[ip + 1] << 8);
+				ip += 2;
+				if (offset == 0 || offset > op) return false;
+
+				size_t match_len = token & 0xF;
+				if (match_len == 15 && !read_length(match_len)) return false;
+				match_len += 4;
+				if (match_len > dst_len - op) return false;
+
+				// Matches may overlap the output they are producing, so this must be copied byte by byte.
+				auto const* match = dst + op - offset;
+				for (size_t i = 0; i < match_len; ++i) {
+					dst[op + i] = match[i];
+				}
+
+				op += match_len;
+			}
+
+			return op == dst_len;
+		}
+
+		class ReadCompressed final ZKINT : public Read {
+		public:
+			explicit ReadCompressed(std::unique_ptr<Read> source) : _m_source(std::move(source)) {
+				char magic[4];
+				_m_source->seek(0, Whence::BEG);
+				if (_m_source->read(magic, 4) != 4 || memcmp(magic, COMPRESSED_MAGIC, 4) != 0) {
+					throw ParserError {"Read.Compressed", "invalid magic"};
+				}
+
+				_m_frame_size = _m_source->read_uint();
+				auto data_start = _m_source->tell();
+
+				_m_source->seek(0, Whence::END);
+				auto source_size = _m_source->tell();
+				if (source_size < data_start + COMPRESSED_TRAILER_SIZE) {
+					throw ParserError {"Read.Compressed", "frame index missing"};
+				}
+
+				_m_source->seek(-static_cast<ssize_t>(COMPRESSED_TRAILER_SIZE), Whence::END);
+				_m_source->read(&_m_size, sizeof _m_size);
+				auto frame_count = _m_source->read_uint();
+
+				if (_m_source->read(magic, 4) != 4 || memcmp(magic, COMPRESSED_INDEX_MAGIC, 4) != 0) {
+					throw ParserError {"Read.Compressed", "frame index missing"};
+				}
+
+				// Every frame takes up at least its entry in the index and its header, so the counts in the trailer
+				// are checked against the size of the stream before anything is allocated for them.
+				auto data_size = source_size - data_start - COMPRESSED_TRAILER_SIZE;
+				if (frame_count > data_size / (2 * sizeof(uint32_t)) || _m_size / COMPRESSED_MAX_RATIO > data_size) {
+					throw ParserError {"Read.Compressed", "frame index does not fit into the stream"};
+				}
+
+				if (_m_frame_size == 0 || frame_count != (_m_size + _m_frame_size - 1) / _m_frame_size) {
+					throw ParserError {"Read.Compressed", "frame index does not match the uncompressed size"};
+				}
+
+				auto index_start = source_size - COMPRESSED_TRAILER_SIZE - frame_count * sizeof(uint32_t);
+				_m_source->seek(static_cast<ssize_t>(index_start), Whence::BEG);
+				_m_frames.resize(frame_count);
+
+				auto offset = data_start;
+				for (size_t i = 0; i < _m_frames.size(); ++i) {
+					auto& frame = _m_frames[i];
+					frame.offset = offset + sizeof(uint32_t);
+					frame.packed = _m_source->read_uint();
+
+					auto packed_size = frame.packed & ~COMPRESSED_FRAME_RAW;
+					auto length = std::min<uint64_t>(_m_frame_size, _m_size - i * _m_frame_size);
+					if (length / COMPRESSED_MAX_RATIO > packed_size) {
+						throw ParserError {"Read.Compressed", "frame index does not match the stored frames"};
+					}
+
+					offset = frame.offset + packed_size;
+					if (offset > index_start) break;
+				}
+
+				if (offset != index_start) {
+					throw ParserError {"Read.Compressed", "frame index does not match the stored frames"};
+				}
+
+				_m_frame.resize(std::min<uint64_t>(_m_frame_size, _m_size));
+			}
+
+			size_t read(void* buf, size_t len) noexcept override {
+				auto* out = static_cast<std::byte*>(buf);
+				size_t total = 0;
+
+				while (total < len && _m_position < _m_size) {
+					auto frame = _m_position / _m_frame_size;
+					if (frame != _m_frame_index && !this->load_frame(frame)) break;
+
+					auto frame_offset = _m_position % _m_frame_size;
+					auto count = std::min(len - total, _m_frame_length - frame_offset);
+
+					memcpy(out + total, _m_frame.data() + frame_offset, count);
+					total += count;
+					_m_position += count;
+				}
+
+				return total;
+			}
+
+			void seek(ssize_t off, Whence whence) noexcept override {
+				auto new_position = seek_internal(_m_position, _m_size, off, whence);
+
+				if (new_position > _m_size) return;
+				_m_position = new_position;
+			}
+
+			[[nodiscard]] size_t tell() const noexcept override {
+				return _m_position;
+			}
+
+			[[nodiscard]] bool eof() const noexcept override {
+				return _m_position >= _m_size;
+			}
+
+		private:
+			struct Frame {
+				size_t offset;
+				uint32_t packed;
+			};
+
+			bool load_frame(size_t index) noexcept {
+				auto const& frame = _m_frames[index];
+				auto packed_size = frame.packed & ~COMPRESSED_FRAME_RAW;
+
+				_m_frame_index = index;
+				_m_frame_length = std::min<size_t>(_m_frame_size, _m_size - index * _m_frame_size);
+				_m_source->seek(static_cast<ssize_t>(frame.offset), Whence::BEG);
+
+				bool ok;
+				if (frame.packed & COMPRESSED_FRAME_RAW) {
+					ok = packed_size == _m_frame_length &&
+					    _m_source->read(_m_frame.data(), _m_frame_length) == _m_frame_length;
+				} else {
+					_m_packed.resize(packed_size);
+					ok = _m_source->read(_m_packed.data(), packed_size) == packed_size &&
+					    lz4_decompress(reinterpret_cast<uint8_t const*>(_m_packed.data()),
+					                   packed_size,
+					                   reinterpret_cast<uint8_t*>(_m_frame.data()),
+					                   _m_frame_length);
+				}
+
+				if (!ok) {
+					ZKLOGE("Read.Compressed", "Frame %zu is corrupt", index);
+					_m_frame_index = SIZE_MAX;
+				}
+
+				return ok;
+			}
+
+			std::unique_ptr<Read> _m_source;
+			std::vector<Frame> _m_frames;
+			std::vector<std::byte> _m_frame, _m_packed;
+			uint64_t _m_size {0};
+			size_t _m_frame_size {0}, _m_frame_index {SIZE_MAX}, _m_frame_length {0};
+			size_t _m_position {0};
+		};
+
+		class WriteCompressed final ZKINT : public Write {
+		public:
+			WriteCompressed(Write* sink, size_t frame_size) : _m_sink(sink) {
+				// The size of a frame must fit next to the COMPRESSED_FRAME_RAW flag.
+				if (frame_size == 0 || frame_size > UINT32_MAX / 2) {
+					throw std::invalid_argument {"Write.Compressed: invalid frame size " + std::to_string(frame_size)};
+				}
+
+				_m_frame.resize(frame_size);
+				_m_sink->write(COMPRESSED_MAGIC, 4);
+				_m_sink->write_uint(static_cast<uint32_t>(frame_size));
+			}
+
+			~WriteCompressed() noexcept override {
+				if (_m_frame_length > 0) this->flush_frame();
+
+				for (auto packed : _m_index) {
+					_m_sink->write_uint(packed);
+				}
+
+				uint64_t size = _m_position_max;
+				_m_sink->write(&size, sizeof size);
+				_m_sink->write_uint(static_cast<uint32_t>(_m_index.size()));
+				_m_sink->write(COMPRESSED_INDEX_MAGIC, 4);
+				_m_sink->flush();
+			}
+
+			size_t write(void const* buf, size_t len) noexcept override {
+				auto const* in = static_cast<std::byte const*>(buf);
+				size_t total = 0;
+
+				while (total < len) {
+					auto frame_offset = _m_position - _m_frame_start;
+					auto count = std::min(len - total, _m_frame.size() - frame_offset);
+
+					memcpy(_m_frame.data() + frame_offset, in + total, count);
+					total += count;
+					_m_position += count;
+					_m_frame_length = std::max(_m_frame_length, frame_offset + count);
+
+					if (_m_frame_length == _m_frame.size() && _m_position == _m_frame_start + _m_frame_length) {
+						this->flush_frame();
+					}
+				}
+
+				_m_position_max = std::max(_m_position_max, _m_position);
+				return total;
+			}
+
+			void seek(ssize_t off, Whence whence) noexcept override {
+				auto new_position = seek_internal(_m_position, _m_frame_start + _m_frame_length, off, whence);
+
+				// Frames which have already been compressed can't be changed anymore.
+				if (new_position < _m_frame_start || new_position > _m_frame_start + _m_frame_length) {
+					ZKLOGE("Write.Compressed", "Cannot seek to %zu outside of the current frame", new_position);
+					return;
+				}
+
+				_m_position = new_position;
+			}
+
+			[[nodiscard]] size_t tell() const noexcept override {
+				return _m_position;
+			}
+
+			void flush() noexcept override {
+				_m_sink->flush();
+			}
+
+		private:
+			void flush_frame() noexcept {
+				_m_packed.resize(lz4_compress_bound(_m_frame_length));
+				auto packed_size = lz4_compress(reinterpret_cast<uint8_t const*>(_m_frame.data()),
+				                                _m_frame_length,
+				                                reinterpret_cast<uint8_t*>(_m_packed.data()));
+
+				// Store frames which don't compress well as-is.
+				auto packed = static_cast<uint32_t>(packed_size);
+				auto const* data = _m_packed.data();
+				if (packed_size >= _m_frame_length) {
+					packed = static_cast<uint32_t>(_m_frame_length) | COMPRESSED_FRAME_RAW;
+					packed_size = _m_frame_length;
+					data = _m_frame.data();
+				}
+
+				_m_sink->write_uint(packed);
+				_m_sink->write(data, packed_size);
+				_m_index.push_back(packed);
+
+				_m_frame_start += _m_frame_length;
+				_m_frame_length = 0;
+			}
+
+			Write* _m_sink;
+			std::vector<std::byte> _m_frame, _m_packed;
+			std::vector<uint32_t> _m_index;
+			size_t _m_frame_start {0}, _m_frame_length {0};
+			size_t _m_position {0}, _m_position_max {0};
+		};
 	} // namespace detail
 
+	std::unique_ptr<Read> Read::from_compressed(std::unique_ptr<Read> source) {
+		return std::make_unique<detail::ReadCompressed>(std::move(source));
+	}
+
 	std::unique_ptr<Read> Read::from(FILE* stream) {
 		return std::make_unique<detail::ReadFile>(stream);
 	}
@@ -432,6 +1220,14 @@ namespace zenkit {
 		return std::make_unique<detail::ReadStream>(stream);
 	}
 
+	std::unique_ptr<Read> Read::from(FILE* stream, size_t buffer_size) {
+		return std::make_unique<detail::ReadBuffered>(std::make_unique<detail::ReadFile>(stream), buffer_size);
+	}
+
+	std::unique_ptr<Read> Read::from(std::istream* stream, size_t buffer_size) {
+		return std::make_unique<detail::ReadBuffered>(std::make_unique<detail::ReadStream>(stream), buffer_size);
+	}
+
 	std::unique_ptr<Read> Read::from(std::byte const* bytes, size_t len) {
 		return std::make_unique<detail::ReadMemory>(bytes, len);
 	}
@@ -458,8 +1254,120 @@ namespace zenkit {
 #endif
 	}
 
+	namespace detail {
+		ZKINT std::optional<std::vector<std::byte>> read_whole_file(std::filesystem::path const& path) {
+			std::ifstream stream {path, std::ios::ate | std::ios::binary | std::ios::in};
+			if (!stream) return std::nullopt;
+
+			std::vector<std::byte> data(static_cast<size_t>(stream.tellg()));
+			stream.seekg(0);
+			stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+			if (!stream) return std::nullopt;
+			return data;
+		}
+	} // namespace detail
+
+	void Read::from_many(std::vector<std::filesystem::path> const& paths,
+	                     std::function<void(size_t, std::unique_ptr<Read>)> const& cb,
+	                     size_t max_in_flight) {
+		auto load = [&paths](size_t i) -> std::unique_ptr<Read> {
+			auto data = detail::read_whole_file(paths[i]);
+			if (!data) {
+				ZKLOGE("Read", "Failed to read %s", paths[i].string().c_str());
+				return nullptr;
+			}
+
+			return Read::from(std::move(*data));
+		};
+
+#ifndef _ZK_WITH_THREADS
+		// Threads are only available in browser builds with pthreads support.
+		(void) max_in_flight;
+		for (size_t i = 0; i < paths.size(); ++i) {
+			cb(i, load(i));
+		}
+#else
+		if (max_in_flight == 0) {
+			max_in_flight = std::max(std::thread::hardware_concurrency(), 4u);
+		}
+
+		std::mutex lock;
+		std::condition_variable ready;
+		std::deque<std::pair<size_t, std::unique_ptr<Read>>> done;
+		size_t next = 0;
+
+		auto worker = [&]() {
+			for (;;) {
+				size_t i;
+				{
+					std::lock_guard guard {lock};
+					if (next >= paths.size()) return;
+					i = next++;
+				}
+
+				auto r = load(i);
+
+				{
+					std::lock_guard guard {lock};
+					done.emplace_back(i, std::move(r));
+				}
+				ready.notify_one();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (size_t i = 0; i < std::min(max_in_flight, paths.size()); ++i) {
+			workers.emplace_back(worker);
+		}
+
+		auto join = [&workers]() {
+			for (auto& t : workers) {
+				t.join();
+			}
+		};
+
+		try {
+			for (size_t remaining = paths.size(); remaining > 0; --remaining) {
+				std::unique_lock guard {lock};
+				ready.wait(guard, [&done] { return !done.empty(); });
+
+				auto item = std::move(done.front());
+				done.pop_front();
+				guard.unlock();
+
+				cb(item.first, std::move(item.second));
+			}
+		} catch (...) {
+			// Stop handing out new files and wait for the ones in flight before propagating.
+			{
+				std::lock_guard guard {lock};
+				next = paths.size();
+			}
+
+			join();
+			throw;
+		}
+
+		join();
+#endif
+	}
+
 	std::unique_ptr<Write> Write::to(std::filesystem::path const& path) {
-		return std::make_unique<detail::WriteStream>(path);
+		return std::make_unique<detail::WriteBuffered>(std::make_unique<detail::WriteStream>(path), 64 * 1024);
+	}
+
+	std::unique_ptr<Write> Write::to_mmap(std::filesystem::path const& path, size_t initial_size) {
+#ifdef _ZK_WITH_MMAP
+		return std::make_unique<detail::WriteMmap>(path, initial_size);
+#else
+		(void) initial_size;
+		return Write::to(path);
+#endif
+	}
+
+	std::unique_ptr<Write> Write::to_compressed(Write* sink, size_t frame_size) {
+		return std::make_unique<detail::WriteCompressed>(sink, frame_size);
 	}
 
 	std::unique_ptr<Write> Write::to(FILE* stream) {
@@ -470,6 +1378,14 @@ namespace zenkit {
 		return std::make_unique<detail::WriteStream>(stream);
 	}
 
+	std::unique_ptr<Write> Write::to(FILE* stream, size_t buffer_size) {
+		return std::make_unique<detail::WriteBuffered>(std::make_unique<detail::WriteFile>(stream), buffer_size);
+	}
+
+	std::unique_ptr<Write> Write::to(std::ostream* stream, size_t buffer_size) {
+		return std::make_unique<detail::WriteBuffered>(std::make_unique<detail::WriteStream>(stream), buffer_size);
+	}
+
 	std::unique_ptr<Write> Write::to(std::byte* bytes, size_t len) {
 		return std::make_unique<detail::WriteStatic>(bytes, len);
 	}
@@ -1,11 +1,38 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include "zenkit/Texture.hh"
+#include "zenkit/Executor.hh"
 #include "zenkit/Stream.hh"
 
+#include "Internal.hh"
+
 #include "squish.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <functional>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ZK_TEXTURE_SSSE3
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ZK_TEXTURE_SSSE3_TARGET
+#define ZK_TEXTURE_AVX2_TARGET
+#else
+#define ZK_TEXTURE_SSSE3_TARGET __attribute__((target("ssse3")))
+#define ZK_TEXTURE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ZK_TEXTURE_NEON
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#define ZK_TEXTURE_WASM_SIMD
+#include <wasm_simd128.h>
+#endif
 
 namespace zenkit {
 	constexpr std::string_view ZTEX_SIGNATURE = "ZTEX";
@@ -70,117 +97,643 @@ namespace zenkit {
 		}
 	}
 
-	std::vector<std::uint8_t> _ztex_to_rgba(uint8_t const* bytes, uint32_t width, uint32_t height, TextureFormat src) {
-		std::vector<std::uint8_t> conv;
-		conv.resize(width * height * 4);
+	/// \brief The byte of the source pixel to read for each of the R, G, B and A output channels. Channels set to
+	///        `0xFF` are filled with `0xFF` instead.
+	using _ztex_swizzle_order = std::array<std::uint8_t, 4>;
 
-		switch (src) {
-		case TextureFormat::DXT1:
-			squish::DecompressImage( //
-			    conv.data(),
-			    static_cast<int>(width),
-			    static_cast<int>(height),
-			    bytes,
-			    squish::kDxt1);
-			break;
-		case TextureFormat::DXT3:
-			squish::DecompressImage( //
-			    conv.data(),
-			    static_cast<int>(width),
-			    static_cast<int>(height),
-			    bytes,
-			    squish::kDxt3);
-			break;
-		case TextureFormat::DXT5: {
-			squish::DecompressImage( //
-			    conv.data(),
-			    static_cast<int>(width),
-			    static_cast<int>(height),
-			    bytes,
-			    squish::kDxt5);
-			break;
+	static void _ztex_swizzle_scalar(uint8_t* out,
+	                                 uint8_t const* in,
+	                                 std::size_t count,
+	                                 std::uint32_t stride,
+	                                 _ztex_swizzle_order order) {
+		for (std::size_t i = 0; i < count; ++i, in += stride, out += 4) {
+			for (auto c = 0u; c < 4; ++c) {
+				out[c] = order[c] == 0xFF ? 0xFF : in[order[c]];
+			}
 		}
-		case TextureFormat::B8G8R8A8:
-			for (auto i = 0u; i < width * height; ++i) {
-				conv[i * 4 + 0] = bytes[i * 4 + 2];
-				conv[i * 4 + 1] = bytes[i * 4 + 1];
-				conv[i * 4 + 2] = bytes[i * 4 + 0];
-				conv[i * 4 + 3] = bytes[i * 4 + 3];
+	}
+
+	static void _ztex_unpack16_scalar(uint8_t* out, uint8_t const* in, std::size_t count, TextureFormat src) {
+		for (std::size_t i = 0; i < count; ++i, in += 2, out += 4) {
+			std::uint32_t v = in[0] | in[1] << 8;
+
+			switch (src) {
+			case TextureFormat::R5G6B5:
+				out[0] = static_cast<uint8_t>((v >> 11 & 0x1F) * 255 / 31);
+				out[1] = static_cast<uint8_t>((v >> 5 & 0x3F) * 255 / 63);
+				out[2] = static_cast<uint8_t>((v & 0x1F) * 255 / 31);
+				out[3] = 0xFF;
+				break;
+			case TextureFormat::A1R5G5B5:
+				out[0] = static_cast<uint8_t>((v >> 10 & 0x1F) * 255 / 31);
+				out[1] = static_cast<uint8_t>((v >> 5 & 0x1F) * 255 / 31);
+				out[2] = static_cast<uint8_t>((v & 0x1F) * 255 / 31);
+				out[3] = v & 0x8000 ? 0xFF : 0;
+				break;
+			default: // A4R4G4B4
+				out[0] = static_cast<uint8_t>((v >> 8 & 0xF) * 17);
+				out[1] = static_cast<uint8_t>((v >> 4 & 0xF) * 17);
+				out[2] = static_cast<uint8_t>((v & 0xF) * 17);
+				out[3] = static_cast<uint8_t>((v >> 12 & 0xF) * 17);
+				break;
 			}
-			break;
-		case TextureFormat::R8G8B8A8:
-			conv.assign(bytes, bytes + width * height * 4);
-			break;
-		case TextureFormat::A8B8G8R8:
-			for (auto i = 0u; i < width * height; ++i) {
-				conv[i * 4 + 0] = bytes[i * 4 + 3];
-				conv[i * 4 + 1] = bytes[i * 4 + 2];
-				conv[i * 4 + 2] = bytes[i * 4 + 1];
-				conv[i * 4 + 3] = bytes[i * 4 + 0];
+		}
+	}
+
+	/// \brief The RGBA8 colors of a palette, one `std::uint32_t` per entry in memory order.
+	using _ztex_palette_lut = std::array<std::uint32_t, ZTEX_PALETTE_ENTRIES>;
+
+	static void
+	_ztex_expand_palette_scalar(uint8_t* out, uint8_t const* in, std::size_t count, _ztex_palette_lut const& lut) {
+		for (std::size_t i = 0; i < count; ++i) {
+			std::memcpy(out + i * 4, &lut[in[i]], 4);
+		}
+	}
+
+	// The vectorized kernels below convert as many pixels as they can and return how many they converted. The
+	// remaining pixels are converted using the scalar kernels above. To widen 5- and 6-bit channels to 8 bits
+	// without a division, they use `x * 255 / 31 == x * 1053 >> 7` and `x * 255 / 63 == (x * 259 + 3) >> 6`,
+	// which hold for all 5- and 6-bit values respectively.
+#ifdef ZK_TEXTURE_SSSE3
+	static bool _ztex_has_ssse3() {
+		static bool const supported = [] {
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 1);
+			return (info[2] & (1 << 9)) != 0;
+#else
+			return __builtin_cpu_supports("ssse3") != 0;
+#endif
+		}();
+
+		return supported;
+	}
+
+	ZK_TEXTURE_SSSE3_TARGET static std::size_t _ztex_swizzle_ssse3(uint8_t* out,
+	                                                                uint8_t const* in,
+	                                                                std::size_t count,
+	                                                                std::uint32_t stride,
+	                                                                _ztex_swizzle_order order) {
+		alignas(16) std::uint8_t mask[16];
+		alignas(16) std::uint8_t fill[16];
+		for (auto p = 0u; p < 4; ++p) {
+			for (auto c = 0u; c < 4; ++c) {
+				auto opaque = order[c] == 0xFF;
+				mask[p * 4 + c] = opaque ? 0x80 : static_cast<uint8_t>(p * stride + order[c]);
+				fill[p * 4 + c] = opaque ? 0xFF : 0;
 			}
+		}
 
-			break;
-		case TextureFormat::A8R8G8B8: {
-			for (auto i = 0u; i < width * height; ++i) {
-				conv[i * 4 + 0] = bytes[i * 4 + 1];
-				conv[i * 4 + 1] = bytes[i * 4 + 2];
-				conv[i * 4 + 2] = bytes[i * 4 + 3];
-				conv[i * 4 + 3] = bytes[i * 4 + 0];
+		auto m = _mm_load_si128(reinterpret_cast<__m128i const*>(mask));
+		auto f = _mm_load_si128(reinterpret_cast<__m128i const*>(fill));
+
+		// Four pixels are converted at a time, but 16 source bytes are loaded even if the pixels only take up 12.
+		std::size_t i = 0;
+		for (; (count - i) * stride >= 16; i += 4) {
+			auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i * stride));
+			v = _mm_or_si128(_mm_shuffle_epi8(v, m), f);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), v);
+		}
+
+		return i;
+	}
+
+	ZK_TEXTURE_SSSE3_TARGET static __m128i _ztex_widen5_ssse3(__m128i x) {
+		return _mm_srli_epi16(_mm_mullo_epi16(x, _mm_set1_epi16(1053)), 7);
+	}
+
+	ZK_TEXTURE_SSSE3_TARGET static std::size_t
+	_ztex_unpack16_ssse3(uint8_t* out, uint8_t const* in, std::size_t count, TextureFormat src) {
+		auto nibble = _mm_set1_epi8(0x0F);
+		auto bgra = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		auto bits5 = _mm_set1_epi16(0x1F);
+		auto bits6 = _mm_set1_epi16(0x3F);
+		auto opaque = _mm_set1_epi16(0xFF);
+
+		std::size_t i = 0;
+		for (; count - i >= 8; i += 8) {
+			auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i * 2));
+			__m128i lo, hi;
+
+			if (src == TextureFormat::A4R4G4B4) {
+				// Each pixel is stored as the bytes GB and AR. Widening the nibbles and interleaving the low ones with
+				// the high ones yields BGRA.
+				auto l = _mm_and_si128(v, nibble);
+				auto h = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+				l = _mm_or_si128(l, _mm_slli_epi16(l, 4));
+				h = _mm_or_si128(h, _mm_slli_epi16(h, 4));
+
+				lo = _mm_shuffle_epi8(_mm_unpacklo_epi8(l, h), bgra);
+				hi = _mm_shuffle_epi8(_mm_unpackhi_epi8(l, h), bgra);
+			} else {
+				__m128i r, g, b, a;
+				if (src == TextureFormat::R5G6B5) {
+					r = _ztex_widen5_ssse3(_mm_srli_epi16(v, 11));
+					g = _mm_and_si128(_mm_srli_epi16(v, 5), bits6);
+					g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(259)), _mm_set1_epi16(3)), 6);
+					a = opaque;
+				} else {
+					r = _ztex_widen5_ssse3(_mm_and_si128(_mm_srli_epi16(v, 10), bits5));
+					g = _ztex_widen5_ssse3(_mm_and_si128(_mm_srli_epi16(v, 5), bits5));
+					a = _mm_and_si128(_mm_srai_epi16(v, 15), opaque);
+				}
+
+				b = _ztex_widen5_ssse3(_mm_and_si128(v, bits5));
+
+				auto rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+				auto ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+				lo = _mm_unpacklo_epi16(rg, ba);
+				hi = _mm_unpackhi_epi16(rg, ba);
 			}
 
-			break;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), lo);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4 + 16), hi);
 		}
-		case TextureFormat::B8G8R8: {
-			for (std::uint32_t i = 0; i < width * height; ++i) {
-				conv[i * 4 + 0] = bytes[i * 3 + 2];
-				conv[i * 4 + 1] = bytes[i * 3 + 1];
-				conv[i * 4 + 2] = bytes[i * 3 + 0];
-				conv[i * 4 + 3] = 0xff;
+
+		return i;
+	}
+
+	static bool _ztex_has_avx2() {
+		static bool const supported = [] {
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) return false;
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2") != 0;
+#endif
+		}();
+
+		return supported;
+	}
+
+	ZK_TEXTURE_AVX2_TARGET static std::size_t
+	_ztex_expand_palette_avx2(uint8_t* out, uint8_t const* in, std::size_t count, _ztex_palette_lut const& lut) {
+		auto const* table = reinterpret_cast<int const*>(lut.data());
+
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(in + i)));
+			auto colors = _mm256_i32gather_epi32(table, indices, 4);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), colors);
+		}
+
+		return i;
+	}
+#elif defined(ZK_TEXTURE_NEON)
+	static std::size_t _ztex_swizzle_neon(uint8_t* out,
+	                                      uint8_t const* in,
+	                                      std::size_t count,
+	                                      std::uint32_t stride,
+	                                      _ztex_swizzle_order order) {
+		std::uint8_t mask[16];
+		std::uint8_t fill[16];
+		for (auto p = 0u; p < 4; ++p) {
+			for (auto c = 0u; c < 4; ++c) {
+				auto opaque = order[c] == 0xFF;
+				mask[p * 4 + c] = opaque ? 0x80 : static_cast<uint8_t>(p * stride + order[c]);
+				fill[p * 4 + c] = opaque ? 0xFF : 0;
 			}
+		}
 
-			break;
+		auto m = vld1q_u8(mask);
+		auto f = vld1q_u8(fill);
+
+		// Four pixels are converted at a time, but 16 source bytes are loaded even if the pixels only take up 12.
+		std::size_t i = 0;
+		for (; (count - i) * stride >= 16; i += 4) {
+			auto v = vld1q_u8(in + i * stride);
+			vst1q_u8(out + i * 4, vorrq_u8(vqtbl1q_u8(v, m), f));
 		}
-		case TextureFormat::R8G8B8: {
-			for (std::uint32_t i = 0; i < width * height; ++i) {
-				conv[i * 4 + 0] = bytes[i * 3 + 0];
-				conv[i * 4 + 1] = bytes[i * 3 + 1];
-				conv[i * 4 + 2] = bytes[i * 3 + 2];
-				conv[i * 4 + 3] = 0xff;
+
+		return i;
+	}
+
+	static std::size_t _ztex_unpack16_neon(uint8_t* out, uint8_t const* in, std::size_t count, TextureFormat src) {
+		static constexpr std::uint8_t BGRA[16] = {2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15};
+		auto bgra = vld1q_u8(BGRA);
+		auto bits5 = vdupq_n_u16(0x1F);
+		auto bits6 = vdupq_n_u16(0x3F);
+		auto opaque = vdupq_n_u16(0xFF);
+
+		auto widen5 = [](uint16x8_t x) {
+			return vshrq_n_u16(vmulq_n_u16(x, 1053), 7);
+		};
+
+		std::size_t i = 0;
+		for (; count - i >= 8; i += 8) {
+			uint8x16_t lo, hi;
+
+			if (src == TextureFormat::A4R4G4B4) {
+				// Each pixel is stored as the bytes GB and AR. Widening the nibbles and interleaving the low ones with
+				// the high ones yields BGRA.
+				auto v = vld1q_u8(in + i * 2);
+				auto l = vandq_u8(v, vdupq_n_u8(0x0F));
+				auto h = vshrq_n_u8(v, 4);
+				auto zip = vzipq_u8(vorrq_u8(l, vshlq_n_u8(l, 4)), vorrq_u8(h, vshlq_n_u8(h, 4)));
+
+				lo = vqtbl1q_u8(zip.val[0], bgra);
+				hi = vqtbl1q_u8(zip.val[1], bgra);
+			} else {
+				auto v = vreinterpretq_u16_u8(vld1q_u8(in + i * 2));
+				uint16x8_t r, g, b, a;
+
+				if (src == TextureFormat::R5G6B5) {
+					r = widen5(vshrq_n_u16(v, 11));
+					g = vandq_u16(vshrq_n_u16(v, 5), bits6);
+					g = vshrq_n_u16(vaddq_u16(vmulq_n_u16(g, 259), vdupq_n_u16(3)), 6);
+					a = opaque;
+				} else {
+					r = widen5(vandq_u16(vshrq_n_u16(v, 10), bits5));
+					g = widen5(vandq_u16(vshrq_n_u16(v, 5), bits5));
+					a = vandq_u16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(v), 15)), opaque);
+				}
+
+				b = widen5(vandq_u16(v, bits5));
+
+				auto zip = vzipq_u16(vorrq_u16(r, vshlq_n_u16(g, 8)), vorrq_u16(b, vshlq_n_u16(a, 8)));
+				lo = vreinterpretq_u8_u16(zip.val[0]);
+				hi = vreinterpretq_u8_u16(zip.val[1]);
 			}
 
-			break;
+			vst1q_u8(out + i * 4, lo);
+			vst1q_u8(out + i * 4 + 16, hi);
 		}
-		case TextureFormat::R5G6B5: {
-			for (auto i = 0u; i < width * height; ++i) {
-				auto* rgb = reinterpret_cast<r5g6b5 const*>(&bytes[i * 2]);
-				conv[i * 4 + 0] = static_cast<uint8_t>(static_cast<float>(rgb->r) * 8.225806452f);
-				conv[i * 4 + 1] = static_cast<uint8_t>(static_cast<float>(rgb->g) * 4.047619048f);
-				conv[i * 4 + 2] = static_cast<uint8_t>(static_cast<float>(rgb->b) * 8.225806452f);
-				conv[i * 4 + 3] = 0xff;
+
+		return i;
+	}
+#elif defined(ZK_TEXTURE_WASM_SIMD)
+	static std::size_t _ztex_swizzle_wasm(uint8_t* out,
+	                                      uint8_t const* in,
+	                                      std::size_t count,
+	                                      std::uint32_t stride,
+	                                      _ztex_swizzle_order order) {
+		std::uint8_t mask[16];
+		std::uint8_t fill[16];
+		for (auto p = 0u; p < 4; ++p) {
+			for (auto c = 0u; c < 4; ++c) {
+				auto opaque = order[c] == 0xFF;
+				mask[p * 4 + c] = opaque ? 0x80 : static_cast<uint8_t>(p * stride + order[c]);
+				fill[p * 4 + c] = opaque ? 0xFF : 0;
 			}
+		}
 
-			break;
+		auto m = wasm_v128_load(mask);
+		auto f = wasm_v128_load(fill);
+
+		// Four pixels are converted at a time, but 16 source bytes are loaded even if the pixels only take up 12.
+		std::size_t i = 0;
+		for (; (count - i) * stride >= 16; i += 4) {
+			auto v = wasm_v128_load(in + i * stride);
+			wasm_v128_store(out + i * 4, wasm_v128_or(wasm_i8x16_swizzle(v, m), f));
 		}
-		case TextureFormat::A4R4G4B4: {
-			for (auto i = 0u; i < width * height; ++i) {
-				conv[i * 4 + 2] = ((bytes[i * 2 + 0] >> 0) & 0x0F) * 17;
-				conv[i * 4 + 1] = ((bytes[i * 2 + 0] >> 4) & 0x0F) * 17;
-				conv[i * 4 + 0] = ((bytes[i * 2 + 1] >> 0) & 0x0F) * 17;
-				conv[i * 4 + 3] = ((bytes[i * 2 + 1] >> 4) & 0x0F) * 17;
+
+		return i;
+	}
+
+	static v128_t _ztex_widen5_wasm(v128_t x) {
+		return wasm_u16x8_shr(wasm_i16x8_mul(x, wasm_i16x8_splat(1053)), 7);
+	}
+
+	static std::size_t _ztex_unpack16_wasm(uint8_t* out, uint8_t const* in, std::size_t count, TextureFormat src) {
+		auto bgra = wasm_i8x16_make(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		auto nibble = wasm_i8x16_splat(0x0F);
+		auto bits5 = wasm_i16x8_splat(0x1F);
+		auto bits6 = wasm_i16x8_splat(0x3F);
+		auto opaque = wasm_i16x8_splat(0xFF);
+
+		std::size_t i = 0;
+		for (; count - i >= 8; i += 8) {
+			auto v = wasm_v128_load(in + i * 2);
+			v128_t lo, hi;
+
+			if (src == TextureFormat::A4R4G4B4) {
+				// Each pixel is stored as the bytes GB and AR. Widening the nibbles and interleaving the low ones with
+				// the high ones yields BGRA.
+				auto l = wasm_v128_and(v, nibble);
+				auto h = wasm_u8x16_shr(v, 4);
+				l = wasm_v128_or(l, wasm_i8x16_shl(l, 4));
+				h = wasm_v128_or(h, wasm_i8x16_shl(h, 4));
+
+				lo = wasm_i8x16_shuffle(l, h, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+				hi = wasm_i8x16_shuffle(l, h, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+				lo = wasm_i8x16_swizzle(lo, bgra);
+				hi = wasm_i8x16_swizzle(hi, bgra);
+			} else {
+				v128_t r, g, b, a;
+
+				if (src == TextureFormat::R5G6B5) {
+					r = _ztex_widen5_wasm(wasm_u16x8_shr(v, 11));
+					g = wasm_v128_and(wasm_u16x8_shr(v, 5), bits6);
+					g = wasm_i16x8_add(wasm_i16x8_mul(g, wasm_i16x8_splat(259)), wasm_i16x8_splat(3));
+					g = wasm_u16x8_shr(g, 6);
+					a = opaque;
+				} else {
+					r = _ztex_widen5_wasm(wasm_v128_and(wasm_u16x8_shr(v, 10), bits5));
+					g = _ztex_widen5_wasm(wasm_v128_and(wasm_u16x8_shr(v, 5), bits5));
+					a = wasm_v128_and(wasm_i16x8_shr(v, 15), opaque);
+				}
+
+				b = _ztex_widen5_wasm(wasm_v128_and(v, bits5));
+
+				auto rg = wasm_v128_or(r, wasm_i16x8_shl(g, 8));
+				auto ba = wasm_v128_or(b, wasm_i16x8_shl(a, 8));
+				lo = wasm_i16x8_shuffle(rg, ba, 0, 8, 1, 9, 2, 10, 3, 11);
+				hi = wasm_i16x8_shuffle(rg, ba, 4, 12, 5, 13, 6, 14, 7, 15);
+			}
+
+			wasm_v128_store(out + i * 4, lo);
+			wasm_v128_store(out + i * 4 + 16, hi);
+		}
+
+		return i;
+	}
+#endif
+
+	static void _ztex_swizzle(uint8_t* out,
+	                          uint8_t const* in,
+	                          std::size_t count,
+	                          std::uint32_t stride,
+	                          _ztex_swizzle_order order) {
+		std::size_t i = 0;
+#if defined(ZK_TEXTURE_SSSE3)
+		if (_ztex_has_ssse3()) i = _ztex_swizzle_ssse3(out, in, count, stride, order);
+#elif defined(ZK_TEXTURE_NEON)
+		i = _ztex_swizzle_neon(out, in, count, stride, order);
+#elif defined(ZK_TEXTURE_WASM_SIMD)
+		i = _ztex_swizzle_wasm(out, in, count, stride, order);
+#endif
+		_ztex_swizzle_scalar(out + i * 4, in + i * stride, count - i, stride, order);
+	}
+
+	static void _ztex_unpack16(uint8_t* out, uint8_t const* in, std::size_t count, TextureFormat src) {
+		std::size_t i = 0;
+#if defined(ZK_TEXTURE_SSSE3)
+		if (_ztex_has_ssse3()) i = _ztex_unpack16_ssse3(out, in, count, src);
+#elif defined(ZK_TEXTURE_NEON)
+		i = _ztex_unpack16_neon(out, in, count, src);
+#elif defined(ZK_TEXTURE_WASM_SIMD)
+		i = _ztex_unpack16_wasm(out, in, count, src);
+#endif
+		_ztex_unpack16_scalar(out + i * 4, in + i * 2, count - i, src);
+	}
+
+	static void _ztex_expand_palette(uint8_t* out, uint8_t const* in, std::size_t count, _ztex_palette_lut const& lut) {
+		std::size_t i = 0;
+#if defined(ZK_TEXTURE_SSSE3)
+		// There is no gather instruction before AVX2, nor in NEON and WebAssembly SIMD, where the scalar lookup is
+		// just as fast.
+		if (_ztex_has_avx2()) i = _ztex_expand_palette_avx2(out, in, count, lut);
+#endif
+		_ztex_expand_palette_scalar(out + i * 4, in + i, count - i, lut);
+	}
+
+	/// \brief The minimum number of DXT blocks each thread decodes or encodes. Smaller textures are not worth
+	///        starting threads for.
+	static constexpr std::size_t DXT_DECODE_BLOCKS_PER_THREAD = 16384;
+	static constexpr std::size_t DXT_ENCODE_BLOCKS_PER_THREAD = 256;
+
+	/// \brief Calls \p fn with ranges of rows of 4x4 blocks, concurrently on up to \p thread_count threads.
+	void _ztex_for_each_block_row(std::uint32_t width,
+	                              std::uint32_t height,
+	                              std::uint32_t thread_count,
+	                              std::size_t blocks_per_thread,
+	                              std::function<void(std::size_t, std::size_t)> const& fn) {
+		std::size_t rows = (height + 3) / 4;
+
+		// Each row of blocks is stored in its own range of both the compressed and the decompressed image, so
+		// bands of rows can be converted concurrently.
+		if (thread_count == 0) thread_count = static_cast<std::uint32_t>(get_executor()->concurrency() + 1);
+
+		auto blocks = rows * ((width + 3) / 4);
+		auto count = std::min<std::size_t>({thread_count, rows, blocks / blocks_per_thread});
+		if (count <= 1) return fn(0, rows);
+
+		auto chunk = (rows + count - 1) / count;
+		parallel_for(
+		    count,
+		    [&](std::size_t i) { fn(std::min(rows, i * chunk), std::min(rows, (i + 1) * chunk)); },
+		    thread_count);
+	}
+
+	/// \brief Decodes the color of a DXT block into 16 RGBA8 pixels, exactly like libsquish. DXT3 and DXT5 blocks
+	///        always use four colors.
+	static void _ztex_decode_dxt_color(std::uint8_t* pixels, std::uint8_t const* block, bool dxt1) {
+		std::uint8_t codes[16];
+
+		auto unpack565 = [](std::uint8_t const* packed, std::uint8_t* color) {
+			auto value = packed[0] | packed[1] << 8;
+			auto r = value >> 11 & 0x1F, g = value >> 5 & 0x3F, b = value & 0x1F;
+			color[0] = static_cast<std::uint8_t>(r << 3 | r >> 2);
+			color[1] = static_cast<std::uint8_t>(g << 2 | g >> 4);
+			color[2] = static_cast<std::uint8_t>(b << 3 | b >> 2);
+			color[3] = 0xFF;
+			return value;
+		};
+
+		auto three_colors = unpack565(block, codes) <= unpack565(block + 2, codes + 4) && dxt1;
+		for (auto i = 0u; i < 3; ++i) {
+			int c = codes[i], d = codes[4 + i];
+			codes[8 + i] = static_cast<std::uint8_t>(three_colors ? (c + d) / 2 : (2 * c + d) / 3);
+			codes[12 + i] = static_cast<std::uint8_t>(three_colors ? 0 : (c + 2 * d) / 3);
+		}
+
+		codes[8 + 3] = 0xFF;
+		codes[12 + 3] = three_colors ? 0 : 0xFF;
+
+		for (auto i = 0u; i < 16; ++i) {
+			auto index = block[4 + i / 4] >> (i % 4 * 2) & 0x3;
+			std::memcpy(pixels + i * 4, codes + index * 4, 4);
+		}
+	}
+
+	static void _ztex_decode_dxt3_alpha(std::uint8_t* pixels, std::uint8_t const* block) {
+		for (auto i = 0u; i < 8; ++i) {
+			auto lo = block[i] & 0x0F, hi = block[i] & 0xF0;
+			pixels[8 * i + 3] = static_cast<std::uint8_t>(lo | lo << 4);
+			pixels[8 * i + 7] = static_cast<std::uint8_t>(hi | hi >> 4);
+		}
+	}
+
+	static void _ztex_decode_dxt5_alpha(std::uint8_t* pixels, std::uint8_t const* block) {
+		int alpha0 = block[0], alpha1 = block[1];
+		std::uint8_t codes[8] = {block[0], block[1], 0, 0, 0, 0, 0, 0xFF};
+
+		if (alpha0 <= alpha1) {
+			for (auto i = 1; i < 5; ++i) {
+				codes[1 + i] = static_cast<std::uint8_t>(((5 - i) * alpha0 + i * alpha1) / 5);
+			}
+		} else {
+			for (auto i = 1; i < 7; ++i) {
+				codes[1 + i] = static_cast<std::uint8_t>(((7 - i) * alpha0 + i * alpha1) / 7);
 			}
+		}
+
+		// The 3-bit indices are stored in two groups of 24 bits.
+		for (auto i = 0u; i < 2; ++i) {
+			std::uint32_t value = block[2 + i * 3] | block[3 + i * 3] << 8 | block[4 + i * 3] << 16;
+			for (auto j = 0u; j < 8; ++j) {
+				pixels[(i * 8 + j) * 4 + 3] = codes[value >> 3 * j & 0x7];
+			}
+		}
+	}
 
+	/// \brief Decodes the given rows of blocks of a DXT1, DXT3 or DXT5 image.
+	static void _ztex_decode_dxt(std::uint8_t* out,
+	                             std::uint8_t const* blocks,
+	                             std::uint32_t width,
+	                             std::uint32_t height,
+	                             TextureFormat format,
+	                             std::size_t row_begin,
+	                             std::size_t row_end) {
+		std::size_t block_size = format == TextureFormat::DXT1 ? 8 : 16;
+		std::size_t blocks_per_row = (width + 3) / 4;
+		std::uint8_t pixels[64];
+
+		for (auto row = row_begin; row < row_end; ++row) {
+			auto* block = blocks + row * blocks_per_row * block_size;
+
+			for (std::size_t column = 0; column < blocks_per_row; ++column, block += block_size) {
+				switch (format) {
+				case TextureFormat::DXT1:
+					_ztex_decode_dxt_color(pixels, block, true);
+					break;
+				case TextureFormat::DXT3:
+					_ztex_decode_dxt_color(pixels, block + 8, false);
+					_ztex_decode_dxt3_alpha(pixels, block);
+					break;
+				default:
+					_ztex_decode_dxt_color(pixels, block + 8, false);
+					_ztex_decode_dxt5_alpha(pixels, block);
+					break;
+				}
+
+				// Blocks at the right and bottom edges may hang over the edge of the image.
+				auto x = column * 4, y = row * 4;
+				auto columns = std::min<std::size_t>(4, width - x);
+				auto rows = std::min<std::size_t>(4, height - y);
+
+				for (std::size_t i = 0; i < rows; ++i) {
+					std::memcpy(out + ((y + i) * width + x) * 4, pixels + i * 16, columns * 4);
+				}
+			}
+		}
+	}
+
+	/// \brief Encodes an RGBA8 image into DXT1, DXT3 or DXT5 using libsquish.
+	static std::vector<std::uint8_t> _ztex_encode_dxt(std::uint8_t const* rgba,
+	                                                  std::uint32_t width,
+	                                                  std::uint32_t height,
+	                                                  TextureFormat format,
+	                                                  TextureConversionOptions const& options) {
+		int flags = format == TextureFormat::DXT1 ? squish::kDxt1
+		    : format == TextureFormat::DXT3       ? squish::kDxt3
+		                                          : squish::kDxt5;
+
+		switch (options.quality) {
+		case TextureCompressionQuality::FAST:
+			flags |= squish::kColourRangeFit;
+			break;
+		case TextureCompressionQuality::NORMAL:
+			flags |= squish::kColourClusterFit;
+			break;
+		case TextureCompressionQuality::BEST:
+			flags |= squish::kColourIterativeClusterFit;
 			break;
 		}
+
+		std::size_t block_size = format == TextureFormat::DXT1 ? 8 : 16;
+		std::size_t blocks_per_row = (width + 3) / 4;
+
+		std::vector<std::uint8_t> conv;
+		conv.resize(blocks_per_row * ((height + 3) / 4) * block_size);
+
+		_ztex_for_each_block_row(width,
+		                         height,
+		                         options.thread_count,
+		                         DXT_ENCODE_BLOCKS_PER_THREAD,
+		                         [&](std::size_t begin, std::size_t end) {
+			                         if (begin >= end) return;
+
+			                         auto rows = std::min<std::size_t>(height, end * 4) - begin * 4;
+			                         squish::CompressImage(rgba + begin * 4 * width * 4,
+			                                               static_cast<int>(width),
+			                                               static_cast<int>(rows),
+			                                               conv.data() + begin * blocks_per_row * block_size,
+			                                               flags);
+		                         });
+
+		return conv;
+	}
+
+	static void _ztex_to_rgba_into(uint8_t* conv,
+	                               uint8_t const* bytes,
+	                               uint32_t width,
+	                               uint32_t height,
+	                               TextureFormat src,
+	                               std::uint32_t thread_count) {
+		std::size_t count = std::size_t {width} * height;
+
+		switch (src) {
+		case TextureFormat::DXT1:
+		case TextureFormat::DXT3:
+		case TextureFormat::DXT5:
+			_ztex_for_each_block_row(width,
+			                         height,
+			                         thread_count,
+			                         DXT_DECODE_BLOCKS_PER_THREAD,
+			                         [&](std::size_t begin, std::size_t end) {
+				                         _ztex_decode_dxt(conv, bytes, width, height, src, begin, end);
+			                         });
+			break;
+		case TextureFormat::R8G8B8A8:
+			std::memcpy(conv, bytes, count * 4);
+			break;
+		case TextureFormat::B8G8R8A8:
+			_ztex_swizzle(conv, bytes, count, 4, {2, 1, 0, 3});
+			break;
+		case TextureFormat::A8B8G8R8:
+			_ztex_swizzle(conv, bytes, count, 4, {3, 2, 1, 0});
+			break;
+		case TextureFormat::A8R8G8B8:
+			_ztex_swizzle(conv, bytes, count, 4, {1, 2, 3, 0});
+			break;
+		case TextureFormat::B8G8R8:
+			_ztex_swizzle(conv, bytes, count, 3, {2, 1, 0, 0xFF});
+			break;
+		case TextureFormat::R8G8B8:
+			_ztex_swizzle(conv, bytes, count, 3, {0, 1, 2, 0xFF});
+			break;
+		case TextureFormat::R5G6B5:
+		case TextureFormat::A1R5G5B5:
+		case TextureFormat::A4R4G4B4:
+			_ztex_unpack16(conv, bytes, count, src);
+			break;
 		default:
 			throw ParserError {"texture",
 			                   "cannot convert format to rgba: " + std::to_string(static_cast<int32_t>(src))};
 		}
+	}
 
+	std::vector<std::uint8_t> _ztex_to_rgba(uint8_t const* bytes,
+	                                        uint32_t width,
+	                                        uint32_t height,
+	                                        TextureFormat src,
+	                                        std::uint32_t thread_count) {
+		std::vector<std::uint8_t> conv;
+		conv.resize(width * height * 4);
+		_ztex_to_rgba_into(conv.data(), bytes, width, height, src, thread_count);
 		return conv;
 	}
 
-	std::vector<std::uint8_t>
-	_ztex_from_rgba(uint8_t const* bytes, uint32_t width, uint32_t height, TextureFormat dest) {
+	std::vector<std::uint8_t> _ztex_from_rgba(uint8_t const* bytes,
+	                                          uint32_t width,
+	                                          uint32_t height,
+	                                          TextureFormat dest,
+	                                          TextureConversionOptions const& options) {
 		std::vector<std::uint8_t> conv;
 
 		switch (dest) {
@@ -246,13 +799,9 @@ namespace zenkit {
 
 			break;
 		case TextureFormat::DXT1:
-			squish::CompressImage(bytes, static_cast<int>(width), static_cast<int>(height), conv.data(), squish::kDxt1);
-			break;
 		case TextureFormat::DXT3:
-			squish::CompressImage(bytes, static_cast<int>(width), static_cast<int>(height), conv.data(), squish::kDxt3);
-			break;
 		case TextureFormat::DXT5:
-			squish::CompressImage(bytes, static_cast<int>(width), static_cast<int>(height), conv.data(), squish::kDxt5);
+			conv = _ztex_encode_dxt(bytes, width, height, dest, options);
 			break;
 		default:
 			throw ParserError {"texture",
@@ -266,18 +815,34 @@ namespace zenkit {
 	                                               uint32_t width,
 	                                               uint32_t height,
 	                                               TextureFormat from,
-	                                               TextureFormat into) {
+	                                               TextureFormat into,
+	                                               TextureConversionOptions const& options) {
 		if (from == into) {
 			std::vector<std::uint8_t> conv;
 			conv.assign(bytes, bytes + _ztex_mipmap_size(from, width, height, 0));
 			return conv;
 		}
 
-		auto rgba = _ztex_to_rgba(bytes, width, height, from);
-		return _ztex_from_rgba(rgba.data(), width, height, into);
+		auto rgba = _ztex_to_rgba(bytes, width, height, from, options.thread_count);
+		return _ztex_from_rgba(rgba.data(), width, height, into, options);
 	}
 
+	struct Texture::LazyMipmaps {
+		// Ordered like Texture::_m_textures.
+		std::vector<ReadSpan> sources;
+		std::vector<std::vector<std::uint8_t>> loaded;
+		std::unique_ptr<std::once_flag[]> once;
+	};
+
 	void Texture::load(Read* r) {
+		this->load(r, {});
+	}
+
+	void Texture::load(Read* r, TextureLoadOptions const& options) {
+		ZKTRACE_ZONE(zone, "Texture.load");
+		MemoryScope memory {MemoryCategory::TEXTURE};
+		auto begin = r->tell();
+
 		if (r->read_string(4) != ZTEX_SIGNATURE) {
 			throw ParserError {"texture", "invalid signature"};
 		}
@@ -303,6 +868,34 @@ namespace zenkit {
 			}
 		}
 
+		this->_m_textures.clear();
+		this->_m_lazy.reset();
+
+		// Lazily loaded textures remember where their mipmaps are and copy them once they are accessed.
+		auto source = options.lazy ? r->as_contiguous() : ReadSpan {};
+		if (source.size() != 0) {
+			auto lazy = std::make_shared<LazyMipmaps>();
+			lazy->loaded.resize(this->_m_mipmap_count);
+			lazy->once = std::make_unique<std::once_flag[]>(this->_m_mipmap_count);
+
+			std::size_t offset = 0;
+			for (std::int64_t level = this->_m_mipmap_count - 1; level >= 0; --level) {
+				auto size =
+				    _ztex_mipmap_size(this->_m_format, this->_m_width, this->_m_height, static_cast<uint32_t>(level));
+				if (offset + size > source.size()) {
+					throw ParserError {"texture", "mipmap data out of bounds"};
+				}
+
+				lazy->sources.emplace_back(source.data() + offset, size);
+				offset += size;
+			}
+
+			r->seek(static_cast<ssize_t>(offset), Whence::CUR);
+			this->_m_lazy = std::move(lazy);
+			ZKTRACE_BYTES(zone, r->tell() - begin);
+			return;
+		}
+
 		// Lowest mipmap-level first
 		for (std::int64_t level = this->_m_mipmap_count - 1; level >= 0; --level) {
 			auto size =
@@ -314,27 +907,73 @@ namespace zenkit {
 
 			this->_m_textures.emplace_back(std::move(mipmap));
 		}
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+	}
+
+	std::vector<std::uint8_t> const& Texture::data(std::uint32_t mipmap_level) const {
+		auto index = _m_mipmap_count - 1 - mipmap_level;
+		if (_m_lazy == nullptr) return _m_textures.at(index);
+
+		auto& lazy = *_m_lazy;
+		auto const& source = lazy.sources.at(index);
+		std::call_once(lazy.once[index], [&lazy, &source, index] {
+			auto const* bytes = reinterpret_cast<std::uint8_t const*>(source.data());
+			lazy.loaded[index].assign(bytes, bytes + source.size());
+		});
+
+		return lazy.loaded[index];
+	}
+
+	ReadSpan Texture::data_view(std::uint32_t mipmap_level) const noexcept {
+		auto index = _m_mipmap_count - 1 - mipmap_level;
+		if (_m_lazy != nullptr) return _m_lazy->sources.at(index);
+
+		auto& map = _m_textures.at(index);
+		return {reinterpret_cast<std::byte const*>(map.data()), map.size()};
+	}
+
+	std::array<std::uint8_t, ZTEX_PALETTE_ENTRIES * 4> Texture::palette_rgba8() const noexcept {
+		std::array<std::uint8_t, ZTEX_PALETTE_ENTRIES * 4> palette;
+		for (auto i = 0u; i < ZTEX_PALETTE_ENTRIES; ++i) {
+			palette[i * 4 + 0] = _m_palette[i].r;
+			palette[i * 4 + 1] = _m_palette[i].g;
+			palette[i * 4 + 2] = _m_palette[i].b;
+			palette[i * 4 + 3] = _m_palette[i].a;
+		}
+
+		return palette;
 	}
 
 	std::vector<std::uint8_t> Texture::as_rgba8(std::uint32_t mipmap_level) const {
+		std::vector<std::uint8_t> conv;
+		conv.resize(std::size_t {mipmap_width(mipmap_level)} * mipmap_height(mipmap_level) * 4);
+		this->as_rgba8_into(conv.data(), conv.size(), mipmap_level);
+		return conv;
+	}
 
-		auto const& map = data(mipmap_level);
+	void Texture::as_rgba8_into(std::uint8_t* buffer, std::size_t size, std::uint32_t mipmap_level) const {
+		auto view = data_view(mipmap_level);
+		auto const* map = reinterpret_cast<std::uint8_t const*>(view.data());
 		auto width = mipmap_width(mipmap_level);
 		auto height = mipmap_height(mipmap_level);
 
+		auto expected = width * height * 4;
+		if (size < expected) {
+			throw InvalidMipmapSize {expected, size};
+		}
+
 		if (_m_format == TextureFormat::P8) {
-			std::vector<std::uint8_t> conv;
-			for (auto i = 0u; i < width * height; ++i) {
-				auto palentry = _m_palette[map[i]];
-				conv[i * 4 + 0] = palentry.r;
-				conv[i * 4 + 1] = palentry.g;
-				conv[i * 4 + 2] = palentry.b;
-				conv[i * 4 + 3] = palentry.a;
-			}
-			return conv;
+			auto palette = this->palette_rgba8();
+
+			_ztex_palette_lut lut;
+			std::memcpy(lut.data(), palette.data(), palette.size());
+
+			_ztex_expand_palette(buffer, map, std::size_t {width} * height, lut);
+			return;
 		}
 
-		return _ztex_to_rgba(map.data(), width, height, _m_format);
+		_ztex_to_rgba_into(buffer, map, width, height, _m_format, 0);
 	}
 
 	void Texture::save(Write* w) const {
@@ -357,8 +996,9 @@ namespace zenkit {
 			}
 		}
 
-		for (auto& m : this->_m_textures) {
-			w->write(m.data(), m.size());
+		for (auto level = this->_m_mipmap_count; level-- > 0;) {
+			auto view = this->data_view(level);
+			w->write(view.data(), view.size());
 		}
 	}
 
@@ -374,7 +1014,7 @@ namespace zenkit {
 		return *this;
 	}
 
-	Texture TextureBuilder::build(TextureFormat format) {
+	Texture TextureBuilder::build(TextureFormat format, TextureConversionOptions const& options) {
 		if (format == TextureFormat::P8) {
 			throw UnsupportedFormatError {"P8"};
 		}
@@ -390,7 +1030,8 @@ namespace zenkit {
 
 		for (auto i = 0u; i < _m_mipmaps.size(); ++i) {
 			auto& [data, fmt] = _m_mipmaps[i];
-			tex._m_textures.push_back(_ztex_convert_format(data.data(), _m_width >> i, _m_height >> i, fmt, format));
+			tex._m_textures.push_back(
+			    _ztex_convert_format(data.data(), _m_width >> i, _m_height >> i, fmt, format, options));
 		}
 
 		return tex;
@@ -0,0 +1,209 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/Trace.hh"
+#include "zenkit/Stream.hh"
+
+#include "Internal.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace zenkit {
+	namespace {
+		std::atomic_bool tracer_active {false};
+		std::atomic_uint32_t tracer_next_thread {0};
+
+		std::mutex tracer_lock;
+		std::vector<TraceSpan> tracer_spans;
+		std::chrono::steady_clock::time_point tracer_epoch;
+	} // namespace
+
+	static std::uint64_t to_nanoseconds(std::chrono::steady_clock::duration d) noexcept {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+	}
+
+	/// \return The time since an arbitrary point in nanoseconds.
+	static std::uint64_t monotonic_now() noexcept {
+		return to_nanoseconds(std::chrono::steady_clock::now().time_since_epoch());
+	}
+
+	static std::uint32_t tracer_thread() noexcept {
+		thread_local std::uint32_t id = tracer_next_thread.fetch_add(1);
+		return id;
+	}
+
+	namespace detail {
+		struct LoadStatsCollector {
+			LoadStats* stats;
+
+			// Counters which may be updated from within an allocation are kept outside of the lock.
+			std::atomic_uint64_t objects {0};
+			std::atomic_uint64_t allocations {0};
+			std::atomic_uint64_t allocated_bytes {0};
+
+			std::mutex lock;
+
+			void record(char const* name, std::uint64_t nanoseconds, std::uint64_t bytes, bool top_level) {
+				std::lock_guard guard {lock};
+
+				if (top_level) {
+					stats->loads += 1;
+					stats->bytes_read += bytes;
+					stats->nanoseconds += nanoseconds;
+				}
+
+				auto it = std::find_if(stats->phases.begin(), stats->phases.end(), [name](LoadPhaseStats const& p) {
+					return p.name == name || std::strcmp(p.name, name) == 0;
+				});
+
+				if (it == stats->phases.end()) {
+					stats->phases.push_back({name, nanoseconds, bytes, 1});
+				} else {
+					it->nanoseconds += nanoseconds;
+					it->bytes += bytes;
+					it->count += 1;
+				}
+			}
+		};
+
+		/// \brief The collector of the calling thread and the number of phases open on it.
+		thread_local LoadStatsCollector* current_collector = nullptr;
+		thread_local std::uint32_t current_depth = 0;
+
+		LoadStatsCollector* current_load_stats() noexcept {
+			return current_collector;
+		}
+
+		std::uint32_t current_load_depth() noexcept {
+			return current_depth;
+		}
+
+		LoadStatsTask::LoadStatsTask(LoadStatsCollector* collector, std::uint32_t depth) noexcept
+		    : _m_previous(current_collector), _m_previous_depth(current_depth) {
+			current_collector = collector;
+			current_depth = depth;
+		}
+
+		LoadStatsTask::~LoadStatsTask() noexcept {
+			current_collector = _m_previous;
+			current_depth = _m_previous_depth;
+		}
+
+		void count_load_objects(std::uint64_t count) noexcept {
+			if (current_collector != nullptr) current_collector->objects.fetch_add(count, std::memory_order_relaxed);
+		}
+
+		void count_load_allocation(std::size_t size) noexcept {
+			if (current_collector == nullptr) return;
+			current_collector->allocations.fetch_add(1, std::memory_order_relaxed);
+			current_collector->allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+	} // namespace detail
+
+	TraceZone::TraceZone(char const* name) noexcept : _m_name(name), _m_stats(detail::current_collector) {
+#if defined(_ZK_WITH_TRACING) && !defined(_ZK_WITH_TRACY)
+		_m_active = tracer_active.load(std::memory_order_acquire);
+#endif
+
+		if (_m_stats != nullptr) detail::current_depth += 1;
+		if (_m_active || _m_stats != nullptr) _m_begin = monotonic_now();
+	}
+
+	TraceZone::~TraceZone() noexcept {
+		if (!_m_active && _m_stats == nullptr) return;
+		auto end = monotonic_now();
+
+		try {
+			if (_m_stats != nullptr) {
+				detail::current_depth -= 1;
+				_m_stats->record(_m_name, end - _m_begin, _m_bytes, detail::current_depth == 0);
+			}
+
+			if (_m_active && tracer_active.load(std::memory_order_relaxed)) {
+				auto epoch = to_nanoseconds(tracer_epoch.time_since_epoch());
+				TraceSpan span {_m_name, tracer_thread(), _m_begin - epoch, end - epoch, _m_bytes};
+				std::lock_guard lock {tracer_lock};
+				tracer_spans.push_back(span);
+			}
+		} catch (...) {
+			// Dropping a span is better than terminating.
+		}
+	}
+
+	LoadStatsScope::LoadStatsScope(LoadStats& stats)
+	    : _m_collector(std::make_unique<detail::LoadStatsCollector>()), _m_previous(detail::current_collector),
+	      _m_previous_depth(detail::current_depth) {
+		_m_collector->stats = &stats;
+		detail::current_collector = _m_collector.get();
+		detail::current_depth = 0;
+	}
+
+	LoadStatsScope::~LoadStatsScope() noexcept {
+		detail::current_collector = _m_previous;
+		detail::current_depth = _m_previous_depth;
+
+		auto& stats = *_m_collector->stats;
+		stats.objects += _m_collector->objects.load();
+		stats.allocations += _m_collector->allocations.load();
+		stats.allocated_bytes += _m_collector->allocated_bytes.load();
+	}
+
+	bool Tracer::available() noexcept {
+#if defined(_ZK_WITH_TRACING) && !defined(_ZK_WITH_TRACY)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void Tracer::start() {
+		std::lock_guard lock {tracer_lock};
+		tracer_spans.clear();
+		tracer_epoch = std::chrono::steady_clock::now();
+		tracer_active.store(true);
+	}
+
+	void Tracer::stop() noexcept {
+		tracer_active.store(false);
+	}
+
+	bool Tracer::active() noexcept {
+		return tracer_active.load();
+	}
+
+	std::vector<TraceSpan> Tracer::spans() {
+		std::lock_guard lock {tracer_lock};
+		return tracer_spans;
+	}
+
+	void Tracer::write_chrome_trace(Write* w) {
+		auto spans = Tracer::spans();
+		char buf[256];
+
+		w->write_string("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+		for (size_t i = 0; i < spans.size(); ++i) {
+			auto const& span = spans[i];
+
+			// Span names are string literals in the library and never need escaping.
+			snprintf(buf,
+			         sizeof buf,
+			         "%s\n{\"name\":\"%s\",\"cat\":\"zenkit\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32
+			         ",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"bytes\":%" PRIu64 "}}",
+			         i == 0 ? "" : ",",
+			         span.name,
+			         span.thread,
+			         static_cast<double>(span.begin) / 1000.,
+			         static_cast<double>(span.end - span.begin) / 1000.,
+			         span.bytes);
+			w->write_string(buf);
+		}
+
+		w->write_string("\n]}\n");
+	}
+} // namespace zenkit
@@ -1,6 +1,7 @@
 // Copyright © 2023-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include "zenkit/Vfs.hh"
+#include "zenkit/Executor.hh"
 #include "zenkit/Misc.hh"
 
 #include "Internal.hh"
@@ -8,16 +9,367 @@
 #include "zenkit/Stream.hh"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <stack>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 namespace zenkit {
 	static constexpr std::string_view VFS_DISK_SIGNATURE_G1 = "PSVDSC_V2.00\r\n\r\n";
 	static constexpr std::string_view VFS_DISK_SIGNATURE_G2 = "PSVDSC_V2.00\n\r\n\r";
 	static constexpr std::string_view VFS_DISK_SIGNATURE_VDFSTOOL = "PSVDSC_V2.00\x1A\x1A\x1A\x1A";
 
+	namespace detail {
+		/// \brief An immutable snapshot of the lookup tables of a Vfs.
+		struct VfsIndex {
+			uint64_t generation;
+
+			/// \brief Maps lower-case paths without a leading slash to their nodes.
+			std::unordered_map<std::string, VfsNode*> paths;
+
+			/// \brief Maps lower-case names to the node Vfs::find should return for them.
+			std::unordered_map<std::string, VfsNode*> names;
+		};
+
+		/// \brief Access counters of a single file. See Vfs::set_access_stats.
+		struct VfsFileStats {
+			explicit VfsFileStats(std::atomic_uint64_t* c) : clock(c) {}
+
+			void record() noexcept {
+				opens.fetch_add(1, std::memory_order_relaxed);
+				if (first.load(std::memory_order_relaxed) != 0) return;
+
+				uint64_t expected = 0;
+				first.compare_exchange_strong(expected, clock->fetch_add(1, std::memory_order_relaxed) + 1);
+			}
+
+			std::atomic_uint32_t opens {0};
+			std::atomic_uint64_t first {0};
+			std::atomic_uint64_t* clock;
+		};
+
+		/// \brief The index of a single Vfs. Shared with all directories in its tree, so they can invalidate it.
+		struct VfsIndexCache {
+			/// \brief Incremented whenever a node of the tree gains or loses a child.
+			std::atomic_uint64_t generation {0};
+
+			/// \brief Serializes rebuilding the index.
+			std::mutex lock;
+			std::atomic<VfsIndex const*> current {nullptr};
+
+			/// \brief The latest index or `nullptr` if the tree was modified since it was built.
+			std::unique_ptr<VfsIndex> snapshot;
+
+			/// \brief Drops the index. No reader may be using it, since the tree must not be modified concurrently.
+			void invalidate() {
+				generation.fetch_add(1, std::memory_order_release);
+				if (current.load(std::memory_order_relaxed) == nullptr) return;
+
+				std::scoped_lock guard {lock};
+				current.store(nullptr, std::memory_order_relaxed);
+				snapshot.reset();
+			}
+		};
+
+		struct VfsState {
+			/// \brief Taken exclusively by all functions which modify the Vfs. See Vfs::lock_shared.
+			std::shared_mutex lock;
+
+			std::shared_ptr<VfsIndexCache> index = std::make_shared<VfsIndexCache>();
+
+			/// \brief The access counters of all files, if enabled. A deque keeps them at a stable address.
+			std::deque<VfsFileStats> stats;
+			std::atomic_uint64_t clock {0};
+		};
+
+		/// \brief Exclusively locks a Vfs for modification, unless the current thread already holds the lock.
+		class VfsWriteGuard {
+		public:
+			explicit VfsWriteGuard(VfsState& state) {
+				if (_s_locked == &state) return;
+
+				state.lock.lock();
+				_m_state = &state;
+				_m_previous = std::exchange(_s_locked, &state);
+
+				state.index->invalidate();
+			}
+
+			VfsWriteGuard(VfsWriteGuard const&) = delete;
+
+			~VfsWriteGuard() noexcept {
+				if (_m_state == nullptr) return;
+
+				_s_locked = _m_previous;
+				_m_state->lock.unlock();
+			}
+
+		private:
+			static thread_local VfsState* _s_locked;
+
+			VfsState* _m_state {nullptr};
+			VfsState* _m_previous {nullptr};
+		};
+
+		thread_local VfsState* VfsWriteGuard::_s_locked = nullptr;
+
+		/// \brief A host directory mounted into a Vfs whose changes are applied by Vfs::poll_host_changes.
+		///
+		/// On Linux, changes are reported by inotify. Elsewhere, the directory tree is scanned for changed modification
+		/// times and sizes on every poll, which only requires a stat call per entry.
+		class VfsHostWatch {
+		public:
+			VfsHostWatch(std::filesystem::path host_path, std::string_view mount)
+			    : host(std::move(host_path)), mount_point(mount) {
+#ifdef __linux__
+				_m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+				if (_m_fd < 0) throw Error {"cannot watch \"" + host.u8string() + "\": " + strerror(errno)};
+				this->add({});
+#else
+				this->scan(_m_snapshot);
+#endif
+			}
+
+			VfsHostWatch(VfsHostWatch const&) = delete;
+			VfsHostWatch& operator=(VfsHostWatch const&) = delete;
+
+			~VfsHostWatch() noexcept {
+#ifdef __linux__
+				::close(_m_fd);
+#endif
+			}
+
+			/// \brief Collects the paths, relative to the host directory, which changed since the last call.
+			void changes(std::vector<std::filesystem::path>& out) {
+#ifdef __linux__
+				alignas(inotify_event) char buf[16 * 1024];
+
+				for (ssize_t n; (n = ::read(_m_fd, buf, sizeof buf)) > 0;) {
+					for (char* p = buf; p < buf + n;) {
+						auto const* ev = reinterpret_cast<inotify_event const*>(p);
+						p += sizeof(inotify_event) + ev->len;
+
+						if (ev->mask & IN_Q_OVERFLOW) {
+							ZKLOGW("Vfs", "Too many changes in %s, some were missed", host.u8string().c_str());
+							continue;
+						}
+
+						auto it = _m_dirs.find(ev->wd);
+						if (it == _m_dirs.end()) continue;
+
+						if (ev->mask & IN_IGNORED) {
+							_m_dirs.erase(it);
+							continue;
+						}
+
+						if (ev->len == 0) continue;
+						auto rel = it->second / ev->name;
+
+						if (ev->mask & IN_ISDIR) {
+							if (ev->mask & (IN_CREATE | IN_MOVED_TO)) this->add(rel);
+							if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) this->remove(rel);
+						} else if (ev->mask & IN_CREATE) {
+							// New files are picked up once they have been written and closed.
+							continue;
+						}
+
+						out.push_back(std::move(rel));
+					}
+				}
+#else
+				std::unordered_map<std::string, Entry> current;
+				this->scan(current);
+
+				for (auto const& [rel, entry] : current) {
+					auto it = _m_snapshot.find(rel);
+					if (it == _m_snapshot.end() || it->second.time != entry.time || it->second.size != entry.size ||
+					    it->second.directory != entry.directory) {
+						out.emplace_back(rel);
+					}
+				}
+
+				for (auto const& [rel, entry] : _m_snapshot) {
+					if (current.find(rel) == current.end()) out.emplace_back(rel);
+				}
+
+				_m_snapshot = std::move(current);
+#endif
+			}
+
+			std::filesystem::path host;
+			std::string mount_point;
+
+		private:
+#ifdef __linux__
+			/// \brief Watches the given directory and all of its subdirectories.
+			void add(std::filesystem::path const& rel) {
+				auto wd = inotify_add_watch(_m_fd,
+				                            (host / rel).c_str(),
+				                            IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+				                                IN_ONLYDIR);
+				if (wd < 0) {
+					ZKLOGW("Vfs", "Cannot watch %s: %s", (host / rel).u8string().c_str(), strerror(errno));
+					return;
+				}
+
+				_m_dirs[wd] = rel;
+
+				std::error_code ec;
+				for (auto const& entry : std::filesystem::directory_iterator {host / rel, ec}) {
+					if (entry.is_directory(ec)) this->add(rel / entry.path().filename());
+				}
+			}
+
+			/// \brief Stops watching the given directory and all of its subdirectories.
+			void remove(std::filesystem::path const& rel) {
+				auto prefix = rel.generic_string() + '/';
+
+				for (auto it = _m_dirs.begin(); it != _m_dirs.end();) {
+					auto path = it->second.generic_string() + '/';
+					if (path.compare(0, prefix.size(), prefix) == 0) {
+						inotify_rm_watch(_m_fd, it->first);
+						it = _m_dirs.erase(it);
+					} else {
+						++it;
+					}
+				}
+			}
+
+			int _m_fd {-1};
+			std::unordered_map<int, std::filesystem::path> _m_dirs;
+#else
+			struct Entry {
+				std::filesystem::file_time_type time;
+				std::uintmax_t size;
+				bool directory;
+			};
+
+			void scan(std::unordered_map<std::string, Entry>& out) const {
+				std::error_code ec;
+				std::filesystem::recursive_directory_iterator it {host, ec}, end {};
+
+				for (; !ec && it != end; it.increment(ec)) {
+					Entry entry {};
+					entry.directory = it->is_directory(ec);
+					entry.time = it->last_write_time(ec);
+					entry.size = entry.directory ? 0 : it->file_size(ec);
+					out.emplace(it->path().lexically_relative(host).generic_string(), entry);
+				}
+			}
+
+			std::unordered_map<std::string, Entry> _m_snapshot;
+#endif
+		};
+	} // namespace detail
+
+	static void vfs_append_lower(std::string& key, std::string_view name) {
+		for (auto c : name) {
+			key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+		}
+	}
+
+	static constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+	static constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+	static constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+	static constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+	static constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+	static uint64_t xxh_rotl(uint64_t x, int r) noexcept {
+		return (x << r) | (x >> (64 - r));
+	}
+
+	static uint64_t xxh_round(uint64_t acc, uint64_t input) noexcept {
+		acc += input * XXH_PRIME64_2;
+		return xxh_rotl(acc, 31) * XXH_PRIME64_1;
+	}
+
+	static uint64_t xxh_merge(uint64_t acc, uint64_t val) noexcept {
+		acc ^= xxh_round(0, val);
+		return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+	}
+
+	/// \brief Calculates the XXH64 hash of the given data using a seed of 0.
+	static uint64_t vfs_xxh64(std::byte const* data, size_t size) noexcept {
+		auto read64 = [](std::byte const* p) {
+			uint64_t v;
+			memcpy(&v, p, sizeof v);
+			return v;
+		};
+
+		auto read32 = [](std::byte const* p) {
+			uint32_t v;
+			memcpy(&v, p, sizeof v);
+			return v;
+		};
+
+		auto const* p = data;
+		auto const* end = data + size;
+		uint64_t h;
+
+		if (size >= 32) {
+			uint64_t v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+			uint64_t v2 = XXH_PRIME64_2;
+			uint64_t v3 = 0;
+			uint64_t v4 = 0 - XXH_PRIME64_1;
+
+			for (; p + 32 <= end; p += 32) {
+				v1 = xxh_round(v1, read64(p));
+				v2 = xxh_round(v2, read64(p + 8));
+				v3 = xxh_round(v3, read64(p + 16));
+				v4 = xxh_round(v4, read64(p + 24));
+			}
+
+			h = xxh_rotl(v1, 1) + xxh_rotl(v2, 7) + xxh_rotl(v3, 12) + xxh_rotl(v4, 18);
+			h = xxh_merge(h, v1);
+			h = xxh_merge(h, v2);
+			h = xxh_merge(h, v3);
+			h = xxh_merge(h, v4);
+		} else {
+			h = XXH_PRIME64_5;
+		}
+
+		h += size;
+
+		for (; p + 8 <= end; p += 8) {
+			h ^= xxh_round(0, read64(p));
+			h = xxh_rotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+		}
+
+		if (p + 4 <= end) {
+			h ^= static_cast<uint64_t>(read32(p)) * XXH_PRIME64_1;
+			h = xxh_rotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+			p += 4;
+		}
+
+		for (; p < end; ++p) {
+			h ^= static_cast<uint64_t>(*p) * XXH_PRIME64_5;
+			h = xxh_rotl(h, 11) * XXH_PRIME64_1;
+		}
+
+		h ^= h >> 33;
+		h *= XXH_PRIME64_2;
+		h ^= h >> 29;
+		h *= XXH_PRIME64_3;
+		h ^= h >> 32;
+		return h;
+	}
+
 	VfsBrokenDiskError::VfsBrokenDiskError(std::string const& signature)
 	    : Error("VFS disk signature not recognized: \"" + signature + "\"") {}
 
@@ -26,24 +378,56 @@ namespace zenkit {
 	VfsNotFoundError::VfsNotFoundError(std::string const& name) : Error("not found: \"" + name + "\"") {}
 
 	VfsFileDescriptor::VfsFileDescriptor(std::byte const* mem, size_t len, bool del)
-	    : memory(mem), size(len), refcnt(del ? new size_t(1) : nullptr) {}
+	    : memory(mem), size(len), refcnt(del ? new std::atomic_size_t(1) : nullptr) {}
+
+	VfsFileDescriptor::VfsFileDescriptor(std::shared_ptr<detail::VfsLazyDisk> disk, size_t offset, size_t len)
+	    : memory(nullptr), size(len), refcnt(nullptr), _m_disk(std::move(disk)), _m_offset(offset) {}
 
 	VfsFileDescriptor::VfsFileDescriptor(VfsFileDescriptor const& cpy)
-	    : memory(cpy.memory), size(cpy.size), refcnt(cpy.refcnt) {
+	    : memory(cpy.memory), size(cpy.size), refcnt(cpy.refcnt), _m_disk(cpy._m_disk), _m_offset(cpy._m_offset),
+	      _m_hash(cpy._m_hash), _m_hashed(cpy._m_hashed), _m_stats(cpy._m_stats) {
 		if (this->refcnt == nullptr) return;
-		*this->refcnt += 1;
+		this->refcnt->fetch_add(1, std::memory_order_relaxed);
+	}
+
+	VfsFileDescriptor::VfsFileDescriptor(VfsFileDescriptor&& mv) noexcept
+	    : memory(mv.memory), size(mv.size), refcnt(mv.refcnt), _m_disk(std::move(mv._m_disk)),
+	      _m_offset(mv._m_offset), _m_hash(mv._m_hash), _m_hashed(mv._m_hashed), _m_stats(mv._m_stats) {
+		mv.refcnt = nullptr;
 	}
 
 	VfsFileDescriptor::~VfsFileDescriptor() noexcept {
 		if (this->refcnt == nullptr) return;
-		*this->refcnt -= 1;
 
-		if (*this->refcnt == 0) {
+		if (this->refcnt->fetch_sub(1, std::memory_order_acq_rel) == 1) {
 			delete[] memory;
 			delete this->refcnt;
 		}
 	}
 
+	VfsFileDescriptor& VfsFileDescriptor::operator=(VfsFileDescriptor const& cpy) {
+		if (this == &cpy) return *this;
+
+		VfsFileDescriptor tmp {cpy};
+		return *this = std::move(tmp);
+	}
+
+	VfsFileDescriptor& VfsFileDescriptor::operator=(VfsFileDescriptor&& mv) noexcept {
+		std::swap(memory, mv.memory);
+		std::swap(size, mv.size);
+		std::swap(refcnt, mv.refcnt);
+		std::swap(_m_disk, mv._m_disk);
+		std::swap(_m_offset, mv._m_offset);
+		std::swap(_m_hash, mv._m_hash);
+		std::swap(_m_hashed, mv._m_hashed);
+		std::swap(_m_stats, mv._m_stats);
+		return *this;
+	}
+
+	// Directories keep their children in a std::vector, which would copy whole subtrees when growing otherwise.
+	static_assert(std::is_nothrow_move_constructible_v<VfsNode>);
+	static_assert(std::is_nothrow_move_assignable_v<VfsNode>);
+
 	bool VfsNodeComparator::operator()(VfsNode const& a, VfsNode const& b) const noexcept {
 		return icompare(a.name(), b.name());
 	}
@@ -56,13 +440,42 @@ namespace zenkit {
 		return icompare(a, b.name());
 	}
 
-	VfsNode::VfsNode(std::string_view name, time_t ts) : _m_name(name), _m_time(ts), _m_data(ChildContainer {}) {}
+	VfsNode::VfsNode(std::string_view name, time_t ts) : _m_name(name), _m_time(ts), _m_data(Directory {}) {}
 
 	VfsNode::VfsNode(std::string_view name, VfsFileDescriptor dev, time_t ts)
 	    : _m_name(name), _m_time(ts), _m_data(dev) {}
 
+	VfsNode& VfsNode::operator=(VfsNode const& cpy) {
+		if (this == &cpy) return *this;
+
+		// A directory stays part of its own tree, so the copied children join it instead of the tree of the original.
+		std::shared_ptr<detail::VfsIndexCache> index;
+		if (auto* dir = std::get_if<Directory>(&_m_data)) index = dir->index;
+
+		_m_name = cpy._m_name;
+		_m_time = cpy._m_time;
+		_m_data = cpy._m_data;
+
+		if (index != nullptr) {
+			this->attach(index);
+			index->invalidate();
+		}
+
+		return *this;
+	}
+
+	void VfsNode::attach(std::shared_ptr<detail::VfsIndexCache> const& index) {
+		auto* dir = std::get_if<Directory>(&_m_data);
+		if (dir == nullptr) return;
+
+		dir->index = index;
+		for (auto& child : dir->children) {
+			child.attach(index);
+		}
+	}
+
 	VfsNode::ChildContainer const& VfsNode::children() const {
-		return std::get<ChildContainer>(_m_data);
+		return std::get<Directory>(_m_data).children;
 	}
 
 	std::string_view trim_trailing_whitespace(std::string_view s) {
@@ -74,45 +487,68 @@ namespace zenkit {
 	}
 
 	VfsNode const* VfsNode::child(std::string_view name) const {
-		auto& children = std::get<ChildContainer>(_m_data);
+		auto& children = std::get<Directory>(_m_data).children;
 
 		name = trim_trailing_whitespace(name);
-		auto it = children.find(name);
+		auto it = std::lower_bound(children.begin(), children.end(), name, VfsNodeComparator {});
 		if (it == children.end() || !iequals(it->name(), name)) return nullptr;
 		return &*it;
 	}
 
 	VfsNode* VfsNode::child(std::string_view name) {
-		auto& children = std::get<ChildContainer>(_m_data);
-
-		name = trim_trailing_whitespace(name);
-		auto it = children.find(name);
-		if (it == children.end() || !iequals(it->name(), name)) return nullptr;
-		return const_cast<VfsNode*>(&*it);
+		return const_cast<VfsNode*>(const_cast<VfsNode const*>(this)->child(name));
 	}
 
 	VfsNode* VfsNode::create(VfsNode node) {
 		this->remove(node.name());
 
-		auto& children = std::get<ChildContainer>(_m_data);
-		auto it = children.insert(std::move(node));
-		return const_cast<VfsNode*>(&*it.first);
+		auto& dir = std::get<Directory>(_m_data);
+		node.attach(dir.index);
+		if (dir.index != nullptr) dir.index->invalidate();
+
+		// Disks and host directories are mounted in order, so most nodes can simply be appended.
+		auto& children = dir.children;
+		if (children.empty() || VfsNodeComparator {}(children.back(), node)) {
+			return &children.emplace_back(std::move(node));
+		}
+
+		auto it = std::lower_bound(children.begin(), children.end(), node, VfsNodeComparator {});
+		if (!VfsNodeComparator {}(node, *it)) return &*it;
+		return &*children.insert(it, std::move(node));
 	}
 
 	bool VfsNode::remove(std::string_view name) {
-		auto& children = std::get<ChildContainer>(_m_data);
+		auto& dir = std::get<Directory>(_m_data);
+		auto& children = dir.children;
 
 		name = trim_trailing_whitespace(name);
-		auto it = children.find(name);
+		auto it = std::lower_bound(children.begin(), children.end(), name, VfsNodeComparator {});
 		if (it == children.end() || !iequals(it->name(), name)) return false;
 
 		children.erase(it);
+		if (dir.index != nullptr) dir.index->invalidate();
 		return true;
 	}
 
+	static std::unique_ptr<Read> vfs_open_lazy(detail::VfsLazyDisk& disk, std::size_t offset, std::size_t len);
+
 	std::unique_ptr<Read> VfsNode::open_read() const {
-		auto fd = std::get<VfsFileDescriptor>(_m_data);
-		return Read::from(fd.memory, fd.size);
+		auto const& fd = std::get<VfsFileDescriptor>(_m_data);
+		if (fd._m_stats != nullptr) fd._m_stats->record();
+		if (fd._m_disk != nullptr) return vfs_open_lazy(*fd._m_disk, fd._m_offset, fd.size);
+		return Read::from(fd.data(), fd.size);
+	}
+
+	ReadSpan VfsNode::data_view() const {
+		auto const& fd = std::get<VfsFileDescriptor>(_m_data);
+		if (fd._m_stats != nullptr) fd._m_stats->record();
+		return ReadSpan {fd.data(), fd.size};
+	}
+
+	std::uint64_t VfsNode::hash() const {
+		auto const& fd = std::get<VfsFileDescriptor>(_m_data);
+		if (fd._m_hashed) return fd._m_hash;
+		return vfs_xxh64(fd.data(), fd.size);
 	}
 
 	VfsNode VfsNode::directory(std::string_view name) {
@@ -143,9 +579,65 @@ namespace zenkit {
 		return _m_name;
 	}
 
-	Vfs::Vfs() : _m_root(VfsNode::directory("/")) {}
+	Vfs::Vfs() : _m_root(VfsNode::directory("/")), _m_state(std::make_unique<detail::VfsState>()) {
+		_m_root.attach(_m_state->index);
+	}
 
-	VfsNode const* Vfs::resolve(std::string_view path) const noexcept {
+	Vfs::Vfs(Vfs&&) noexcept = default;
+	Vfs::~Vfs() noexcept = default;
+
+	Vfs& Vfs::operator=(Vfs&&) noexcept = default;
+
+	std::shared_lock<std::shared_mutex> Vfs::lock_shared() const {
+		return std::shared_lock {_m_state->lock};
+	}
+
+	detail::VfsIndex const& Vfs::index() const {
+		auto& cache = *_m_state->index;
+		auto generation = cache.generation.load(std::memory_order_acquire);
+
+		auto const* current = cache.current.load(std::memory_order_acquire);
+		if (current != nullptr && current->generation == generation) return *current;
+
+		std::scoped_lock lock {cache.lock};
+		generation = cache.generation.load(std::memory_order_acquire);
+		current = cache.current.load(std::memory_order_relaxed);
+		if (current != nullptr && current->generation == generation) return *current;
+
+		auto snapshot = std::make_unique<detail::VfsIndex>();
+		auto& index = *snapshot;
+		index.generation = generation;
+
+		// Visit nodes in depth-first order starting at the root, so that Vfs::find
+		// returns the same node as a plain tree search would if names are ambiguous.
+		std::stack<std::pair<VfsNode const*, std::string>> tree {};
+		tree.emplace(&_m_root, "");
+
+		while (!tree.empty()) {
+			auto [node, prefix] = std::move(tree.top());
+			tree.pop();
+
+			for (auto const& child : node->children()) {
+				auto key = prefix;
+				vfs_append_lower(key, child.name());
+
+				auto* ptr = const_cast<VfsNode*>(&child);
+				index.names.emplace(key.substr(prefix.size()), ptr);
+
+				if (child.type() == VfsNodeType::DIRECTORY) {
+					tree.emplace(&child, key + '/');
+				}
+
+				index.paths.emplace(std::move(key), ptr);
+			}
+		}
+
+		cache.current.store(&index, std::memory_order_release);
+		cache.snapshot = std::move(snapshot);
+		return index;
+	}
+
+	VfsNode* Vfs::walk(std::string_view path) noexcept {
 		auto* context = &_m_root;
 
 		while (context != nullptr && !path.empty()) {
@@ -155,35 +647,53 @@ namespace zenkit {
 				continue;
 			}
 
-			auto name = path.substr(0, next);
-			context = context->child(name);
+			if (context->type() != VfsNodeType::DIRECTORY) return nullptr;
+			context = context->child(path.substr(0, next));
 
 			if (next == std::string_view::npos) break;
-
 			path = path.substr(next + 1);
 		}
 
 		return context;
 	}
 
-	VfsNode const* Vfs::find(std::string_view name) const noexcept {
-		std::stack<VfsNode const*> tree {{&_m_root}};
+	VfsNode const* Vfs::resolve(std::string_view path) const noexcept {
+		thread_local std::string key;
+		key.clear();
 
-		while (!tree.empty()) {
-			auto* node = tree.top();
-			tree.pop();
+		while (!path.empty()) {
+			auto next = path.find('/');
+			if (next == 0) {
+				path = path.substr(next + 1);
+				continue;
+			}
 
-			if (auto* child = node->child(name); child != nullptr) return child;
+			auto name = path.substr(0, next);
+			auto trimmed = trim_trailing_whitespace(name);
+			if (trimmed.empty()) return nullptr;
 
-			auto& children = node->children();
-			for (auto const& x : children) {
-				if (x.type() == VfsNodeType::FILE) continue;
+			if (!key.empty()) key.push_back('/');
+			vfs_append_lower(key, trimmed);
 
-				tree.push(&x);
-			}
+			if (next == std::string_view::npos) break;
+			path = path.substr(next + 1);
 		}
 
-		return nullptr;
+		if (key.empty()) return &_m_root;
+
+		auto const& paths = this->index().paths;
+		auto it = paths.find(key);
+		return it == paths.end() ? nullptr : it->second;
+	}
+
+	VfsNode const* Vfs::find(std::string_view name) const noexcept {
+		thread_local std::string key;
+		key.clear();
+		vfs_append_lower(key, trim_trailing_whitespace(name));
+
+		auto const& names = this->index().names;
+		auto it = names.find(key);
+		return it == names.end() ? nullptr : it->second;
 	}
 
 	VfsNode* Vfs::resolve(std::string_view path) noexcept {
@@ -194,6 +704,115 @@ namespace zenkit {
 		return const_cast<VfsNode*>(const_cast<Vfs const*>(this)->find(name));
 	}
 
+	/// \brief Case-insensitively match a name against a pattern containing `*` and `?` wildcards.
+	static bool vfs_glob_match(std::string_view pattern, std::string_view name) noexcept {
+		auto lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+
+		size_t p = 0, n = 0;
+		size_t star = std::string_view::npos, backtrack = 0;
+
+		while (n < name.size()) {
+			if (p < pattern.size() && (pattern[p] == '?' || lower(pattern[p]) == lower(name[n]))) {
+				++p;
+				++n;
+			} else if (p < pattern.size() && pattern[p] == '*') {
+				star = p++;
+				backtrack = n;
+			} else if (star != std::string_view::npos) {
+				p = star + 1;
+				n = ++backtrack;
+			} else {
+				return false;
+			}
+		}
+
+		while (p < pattern.size() && pattern[p] == '*') {
+			++p;
+		}
+
+		return p == pattern.size();
+	}
+
+	static bool vfs_glob_enumerate(VfsNode const& node,
+	                               std::vector<std::string_view> const& segments,
+	                               size_t i,
+	                               std::string& path,
+	                               std::function<bool(std::string_view, VfsNode const&)> const& cb) {
+		auto const& segment = segments[i];
+		auto last = i + 1 == segments.size();
+		auto prefix = path.size();
+
+		auto visit = [&](VfsNode const& child, size_t next) {
+			path.resize(prefix);
+			if (!path.empty()) path.push_back('/');
+			path.append(child.name());
+
+			if (next == segments.size()) {
+				if (!cb(path, child)) return false;
+			} else if (child.type() == VfsNodeType::DIRECTORY) {
+				if (!vfs_glob_enumerate(child, segments, next, path, cb)) return false;
+			}
+
+			return true;
+		};
+
+		if (segment == "**") {
+			// Match zero directories first, then descend one level keeping the `**` segment.
+			if (!last && !vfs_glob_enumerate(node, segments, i + 1, path, cb)) return false;
+
+			for (auto const& child : node.children()) {
+				if (last && !visit(child, i + 1)) return false;
+				if (child.type() == VfsNodeType::DIRECTORY && !visit(child, i)) return false;
+			}
+		} else if (segment.find_first_of("*?") == std::string_view::npos) {
+			auto const* child = node.child(segment);
+			if (child != nullptr && !visit(*child, i + 1)) return false;
+		} else {
+			for (auto const& child : node.children()) {
+				if (vfs_glob_match(segment, child.name()) && !visit(child, i + 1)) return false;
+			}
+		}
+
+		path.resize(prefix);
+		return true;
+	}
+
+	void Vfs::enumerate(std::string_view pattern,
+	                    std::function<bool(std::string_view path, VfsNode const& node)> const& cb) const {
+		std::vector<std::string_view> segments;
+
+		while (!pattern.empty()) {
+			auto next = pattern.find('/');
+			auto segment = trim_trailing_whitespace(pattern.substr(0, next));
+
+			// Consecutive `**` segments are equivalent to a single one.
+			if (!segment.empty() && (segment != "**" || segments.empty() || segments.back() != "**")) {
+				segments.push_back(segment);
+			}
+
+			if (next == std::string_view::npos) break;
+			pattern = pattern.substr(next + 1);
+		}
+
+		if (segments.empty()) return;
+
+		// Leading segments without wildcards are looked up directly instead of being matched against every child.
+		std::string path;
+		size_t literal = 0;
+		VfsNode const* base = &_m_root;
+
+		while (literal + 1 < segments.size() && segments[literal].find_first_of("*?") == std::string_view::npos) {
+			base = base->child(segments[literal]);
+			if (base == nullptr || base->type() != VfsNodeType::DIRECTORY) return;
+
+			if (!path.empty()) path.push_back('/');
+			path.append(base->name());
+			++literal;
+		}
+
+		vfs_glob_enumerate(*base, segments, literal, path, cb);
+	}
+
 	static uint32_t count_nodes(VfsNode const* node) {
 		uint32_t count = 1; /* self */
 
@@ -220,19 +839,27 @@ namespace zenkit {
 		return dos;
 	}
 
-	void Vfs::save(Write* w, GameVersion version, time_t unix_t) const {
-		std::vector<std::byte> catalog;
-		auto write_catalog = Write::to(&catalog);
+	namespace detail {
+		/// \brief The layout of a disk written by Vfs::save.
+		struct VfsDiskLayout {
+			std::vector<std::byte> catalog;
+			std::vector<std::pair<VfsFileDescriptor const*, uint32_t>> files;
+			uint32_t entries {0};
+			uint32_t file_count {0};
+			uint32_t end {0};
+		};
+	} // namespace detail
 
-		// Skip the header, we'll write it at the end.
-		unsigned header_size = 256 + 16 + 6 * 4;
-		unsigned catalog_size = (count_nodes(&_m_root) - 1) * (64 + 4 * 4); // -1 because the root node is not counted
-		w->seek(header_size + catalog_size, Whence::BEG);
+	static constexpr unsigned VFS_DISK_HEADER_SIZE = 256 + 16 + 6 * 4;
+	static constexpr unsigned VFS_DISK_ENTRY_SIZE = 64 + 4 * 4;
 
-		std::vector<std::byte> cache;
+	void Vfs::layout(detail::VfsDiskLayout& layout, VfsSaveOptions const& options) const {
+		auto write_catalog = Write::to(&layout.catalog);
 		std::string name;
-		uint32_t index = 0;
-		uint32_t files = 0;
+
+		// The catalog is written in tree order, but the payloads may be stored in a different order, so their offsets
+		// are filled in once the catalog is complete.
+		std::vector<std::pair<VfsNode const*, size_t>> entries;
 
 		std::function<void(VfsNode const*)> write_node = [&](VfsNode const* node) {
 			unsigned i = 0;
@@ -245,20 +872,14 @@ namespace zenkit {
 				write_catalog->write_string(name);
 
 				if (child.type() == VfsNodeType::FILE) {
-					auto rd = child.open_read();
-					rd->seek(0, Whence::END);
-					auto sz = rd->tell();
-					rd->seek(0, Whence::BEG);
+					auto const& fd = std::get<VfsFileDescriptor>(child._m_data);
+					entries.emplace_back(&child, write_catalog->tell());
 
-					write_catalog->write_uint(w->tell());                                         // Offset
-					write_catalog->write_uint(sz);                                                // Size
+					write_catalog->write_uint(0);                                                 // Offset
+					write_catalog->write_uint(static_cast<uint32_t>(fd.size));                    // Size
 					write_catalog->write_uint(i + 1 == node->children().size() ? 0x40000000 : 0); // Type
 
-					cache.resize(sz);
-					rd->read(cache.data(), sz);
-					w->write(cache.data(), sz);
-
-					files += 1;
+					layout.file_count++;
 				} else {
 					dirs.emplace_back(write_catalog->tell(), &child);
 					write_catalog->write_uint(0);                                                          // Offset
@@ -269,13 +890,13 @@ namespace zenkit {
 				write_catalog->write_uint(0); // Attributes
 
 				i++;
-				index++;
+				layout.entries++;
 			}
 
 			for (auto [off, dir] : dirs) {
 				auto here = static_cast<ssize_t>(write_catalog->tell());
 				write_catalog->seek(off, Whence::BEG);
-				write_catalog->write_uint(index);
+				write_catalog->write_uint(layout.entries);
 				write_catalog->seek(here, Whence::BEG);
 
 				write_node(dir);
@@ -284,37 +905,591 @@ namespace zenkit {
 
 		write_node(&_m_root);
 
-		// Write the header
+		if (options.access_order) {
+			// Files which were never opened go last, in tree order.
+			auto first_access = [](VfsNode const* node) {
+				auto const* stats = std::get<VfsFileDescriptor>(node->_m_data)._m_stats;
+				auto order = stats == nullptr ? 0 : stats->first.load(std::memory_order_relaxed);
+				return order == 0 ? UINT64_MAX : order;
+			};
+
+			std::stable_sort(entries.begin(), entries.end(), [&first_access](auto const& a, auto const& b) {
+				return first_access(a.first) < first_access(b.first);
+			});
+		}
+
+		// Maps content hashes to the first payload with that hash.
+		std::unordered_map<uint64_t, size_t> payloads;
+		uint32_t offset = VFS_DISK_HEADER_SIZE + static_cast<uint32_t>(layout.catalog.size());
+
+		auto place = [&](VfsNode const& node, VfsFileDescriptor const& fd) {
+			if (options.deduplicate) {
+				auto [it, inserted] = payloads.emplace(node.hash(), layout.files.size());
+				if (!inserted) {
+					auto [other, other_offset] = layout.files[it->second];
+					if (other->size == fd.size && (fd.size == 0 || memcmp(other->data(), fd.data(), fd.size) == 0)) {
+						return other_offset;
+					}
+				}
+			}
+
+			auto here = offset;
+			layout.files.emplace_back(&fd, here);
+			offset += static_cast<uint32_t>(fd.size);
+			return here;
+		};
+
+		for (auto [node, position] : entries) {
+			auto here = place(*node, std::get<VfsFileDescriptor>(node->_m_data));
+			memcpy(layout.catalog.data() + position, &here, sizeof here);
+		}
+
+		layout.end = offset;
+	}
+
+	static void vfs_write_header(Write* w,
+	                             detail::VfsDiskLayout const& layout,
+	                             GameVersion version,
+	                             time_t unix_t) {
 		std::string comment = "Created using ZenKit";
 		comment.resize(256, '\x1A');
 
-		auto off = w->tell();
 		w->seek(0, Whence::BEG);
 		w->write_string(comment);
 		w->write_string(version == GameVersion::GOTHIC_1 ? VFS_DISK_SIGNATURE_G1 : VFS_DISK_SIGNATURE_G2);
-		w->write_uint(index);
-		w->write_uint(files);
+		w->write_uint(layout.entries);
+		w->write_uint(layout.file_count);
 		w->write_uint(unix_t == 0 ? vfs_unix_to_dos_time(time(nullptr)) : vfs_unix_to_dos_time(unix_t));
-		w->write_uint(off + catalog.size());
-		w->write_uint(header_size);
-		w->write_uint(80);
-		w->seek(static_cast<ssize_t>(header_size), Whence::BEG);
-		w->write(catalog.data(), catalog.size());
+		w->write_uint(layout.end + static_cast<uint32_t>(layout.catalog.size()));
+		w->write_uint(VFS_DISK_HEADER_SIZE);
+		w->write_uint(VFS_DISK_ENTRY_SIZE);
+		w->write(layout.catalog.data(), layout.catalog.size());
 	}
 
-	void Vfs::mount_disk(std::filesystem::path const& host, VfsOverwriteBehavior overwrite) {
-#ifdef _ZK_WITH_MMAP
-		auto& mem = _m_data_mapped.emplace_back(host);
-		this->mount_disk(mem.data(), mem.size(), overwrite);
+	void Vfs::save(Write* w, GameVersion version, time_t unix_t, VfsSaveOptions const& options) const {
+		detail::VfsDiskLayout layout;
+		this->layout(layout, options);
+
+		// Skip the header, we'll write it at the end.
+		w->seek(static_cast<ssize_t>(VFS_DISK_HEADER_SIZE + layout.catalog.size()), Whence::BEG);
+
+		for (auto [fd, offset] : layout.files) {
+			w->write(fd->data(), fd->size);
+		}
+
+		vfs_write_header(w, layout, version, unix_t);
+	}
+
+	void Vfs::save(std::filesystem::path const& path,
+	               GameVersion version,
+	               time_t unix_t,
+	               VfsSaveOptions const& options) const {
+#if defined(_ZK_WITH_MMAP) && !defined(__EMSCRIPTEN__)
+		detail::VfsDiskLayout layout;
+		this->layout(layout, options);
+
+		MutableMmap map {path, layout.end};
+		auto w = Write::to(map.data(), map.size());
+		vfs_write_header(w.get(), layout, version, unix_t);
+
+		// Every payload has a fixed place in the output, so they can be copied in any order. Spreading them over
+		// multiple threads keeps the disk busy while the sources are being paged in.
+		parallel_for(layout.files.size(), [&](size_t i) {
+			auto [fd, offset] = layout.files[i];
+			if (fd->size != 0) memcpy(map.data() + offset, fd->data(), fd->size);
+		});
 #else
+		auto w = Write::to(path);
+		this->save(w.get(), version, unix_t, options);
+#endif
+	}
+
+#ifndef _ZK_WITH_MMAP
+	static std::unique_ptr<std::byte[]> vfs_read_host_file(std::filesystem::path const& host, size_t& size) {
 		std::ifstream stream {host, std::ios::in | std::ios::ate | std::ios::binary};
-		auto size = stream.tellg();
+		size = (size_t) stream.tellg();
 		stream.seekg(0);
 
-		auto& data = _m_data.emplace_back(new std::byte[(size_t) size]);
-		stream.read((char*) data.get(), size);
-		this->mount_disk(data.get(), (size_t) size, overwrite);
+		std::unique_ptr<std::byte[]> data {new std::byte[size]};
+		stream.read((char*) data.get(), (std::streamsize) size);
+		return data;
+	}
 #endif
+
+	/// \brief Merges the children of the given detached root node into the root of \p vfs.
+	static void vfs_mount_root(Vfs& vfs, VfsNode& root, VfsOverwriteBehavior overwrite) {
+		ZKTRACE("Vfs.merge");
+		for (auto& child : root.children()) {
+			vfs.mount(std::move(const_cast<VfsNode&>(child)), "/", overwrite);
+		}
+	}
+
+	namespace detail {
+		/// \brief A disk which is only mapped once a file stored on it is opened, or whose files are read from a
+		///        stream whenever they are opened.
+		struct VfsLazyDisk {
+			VfsLazyDisk(std::filesystem::path p, std::size_t len) : path(std::move(p)), size(len) {}
+			VfsLazyDisk(std::unique_ptr<Read> src, std::size_t len) : size(len), _m_source(std::move(src)) {}
+
+			/// \brief Get the contents of the file at the given offset. Files of streamed disks are read once and
+			///        kept in memory from then on.
+			std::byte const* data(std::size_t offset, std::size_t len) {
+				if (_m_source == nullptr) return data() + offset;
+
+				std::lock_guard<std::mutex> lock {_m_source_lock};
+				auto& file = _m_files[offset];
+				if (file == nullptr) {
+					auto buf = std::make_unique<std::byte[]>(len);
+					this->read_source(buf.get(), offset, len);
+					file = std::move(buf);
+				}
+
+				return file.get();
+			}
+
+			/// \brief Open the file at the given offset. Files of streamed disks are read into a buffer owned by the
+			///        returned stream, unless they are already kept in memory.
+			std::unique_ptr<Read> open(std::size_t offset, std::size_t len) {
+				if (_m_source == nullptr) return Read::from(data() + offset, len);
+
+				std::lock_guard<std::mutex> lock {_m_source_lock};
+				if (auto it = _m_files.find(offset); it != _m_files.end()) return Read::from(it->second.get(), len);
+
+				std::vector<std::byte> buf(len);
+				this->read_source(buf.data(), offset, len);
+				return Read::from(std::move(buf));
+			}
+
+			std::byte const* data() {
+				std::call_once(_m_mapped, [this] {
+					ZKLOGD("Vfs", "Mapping %s on first access", path.u8string().c_str());
+
+#ifdef _ZK_WITH_MMAP
+					_m_base = _m_data.emplace(path).data();
+#else
+					std::size_t len = 0;
+					_m_data = vfs_read_host_file(path, len);
+					_m_base = _m_data.get();
+#endif
+				});
+
+				return _m_base;
+			}
+
+			std::filesystem::path const path;
+			std::size_t const size;
+
+		private:
+			void read_source(std::byte* buf, std::size_t offset, std::size_t len) {
+				_m_source->seek(static_cast<ssize_t>(offset), Whence::BEG);
+				if (_m_source->read(buf, len) != len) {
+					throw std::runtime_error {"Failed to read " + std::to_string(len) + " bytes at offset " +
+					                          std::to_string(offset) + " from a streamed disk"};
+				}
+			}
+
+			std::once_flag _m_mapped;
+			std::byte const* _m_base {nullptr};
+
+			std::unique_ptr<Read> _m_source;
+			std::mutex _m_source_lock;
+			std::unordered_map<std::size_t, std::unique_ptr<std::byte[]>> _m_files;
+
+#ifdef _ZK_WITH_MMAP
+			std::optional<Mmap> _m_data;
+#else
+			std::unique_ptr<std::byte[]> _m_data;
+#endif
+		};
+	} // namespace detail
+
+	static std::unique_ptr<Read> vfs_open_lazy(detail::VfsLazyDisk& disk, std::size_t offset, std::size_t len) {
+		return disk.open(offset, len);
+	}
+
+	std::byte const* VfsFileDescriptor::data() const {
+		if (_m_disk == nullptr) return memory;
+		return _m_disk->data(_m_offset, size);
+	}
+
+	void Vfs::set_lazy_disks(bool enable) noexcept {
+		_m_lazy_disks = enable;
+	}
+
+	void Vfs::set_hash_files(bool enable) noexcept {
+		_m_hash_files = enable;
+	}
+
+	void Vfs::set_access_stats(bool enable) {
+		detail::VfsWriteGuard guard {*_m_state};
+		if (enable == _m_access_stats) return;
+
+		_m_access_stats = enable;
+		if (enable) {
+			attach_stats(_m_root);
+			return;
+		}
+
+		std::function<void(VfsNode&)> detach = [&detach](VfsNode& node) {
+			if (node.type() == VfsNodeType::FILE) {
+				std::get<VfsFileDescriptor>(node._m_data)._m_stats = nullptr;
+				return;
+			}
+
+			for (auto& child : std::get<VfsNode::Directory>(node._m_data).children) {
+				detach(child);
+			}
+		};
+
+		detach(_m_root);
+		_m_state->stats.clear();
+		_m_state->clock = 0;
+	}
+
+	void Vfs::attach_stats(VfsNode& node) {
+		if (node.type() == VfsNodeType::FILE) {
+			auto& fd = std::get<VfsFileDescriptor>(node._m_data);
+			if (fd._m_stats == nullptr) fd._m_stats = &_m_state->stats.emplace_back(&_m_state->clock);
+			return;
+		}
+
+		for (auto& child : std::get<VfsNode::Directory>(node._m_data).children) {
+			attach_stats(child);
+		}
+	}
+
+	VfsAccessStats Vfs::access_stats() const {
+		VfsAccessStats stats;
+		stats.sources.resize(_m_sources.size());
+		for (size_t i = 0; i < _m_sources.size(); ++i) {
+			stats.sources[i] = VfsSourceAccess {_m_sources[i].path, 0, 0};
+		}
+
+		auto order = this->source_order();
+		std::string path;
+
+		std::function<void(VfsNode const&)> visit = [&](VfsNode const& node) {
+			auto prefix = path.size();
+
+			for (auto const& child : node.children()) {
+				path.resize(prefix);
+				if (!path.empty()) path.push_back('/');
+				path.append(child.name());
+
+				if (child.type() == VfsNodeType::DIRECTORY) {
+					visit(child);
+					continue;
+				}
+
+				auto const& fd = std::get<VfsFileDescriptor>(child._m_data);
+				if (fd._m_stats == nullptr) continue;
+
+				auto opens = fd._m_stats->opens.load(std::memory_order_relaxed);
+				if (opens == 0) continue;
+
+				auto bytes = static_cast<uint64_t>(opens) * fd.size;
+				auto first = fd._m_stats->first.load(std::memory_order_relaxed);
+				stats.files.push_back(VfsFileAccess {path, opens, first, bytes});
+
+				uint32_t source;
+				uint64_t offset;
+				if (this->find_source(order, fd, source, offset)) {
+					stats.sources[source].opens += opens;
+					stats.sources[source].bytes += bytes;
+				}
+			}
+
+			path.resize(prefix);
+		};
+
+		visit(_m_root);
+
+		std::sort(stats.files.begin(), stats.files.end(), [](auto const& a, auto const& b) {
+			return a.first_access < b.first_access;
+		});
+
+		stats.sources.erase(std::remove_if(stats.sources.begin(),
+		                                   stats.sources.end(),
+		                                   [](auto const& source) { return source.opens == 0; }),
+		                    stats.sources.end());
+		return stats;
+	}
+
+	void Vfs::hash_tree(VfsNode& node) {
+		if (node.type() == VfsNodeType::FILE) {
+			auto& fd = std::get<VfsFileDescriptor>(node._m_data);
+			if (fd._m_hashed) return;
+
+			fd._m_hash = vfs_xxh64(fd.data(), fd.size);
+			fd._m_hashed = true;
+			return;
+		}
+
+		for (auto& child : std::get<VfsNode::Directory>(node._m_data).children) {
+			hash_tree(child);
+		}
+	}
+
+	static constexpr char VFS_INDEX_MAGIC[4] {'Z', 'K', 'V', 'I'};
+	static constexpr uint32_t VFS_INDEX_VERSION = 1;
+
+	// The smallest possible entries: An empty path, its size and its time or an empty name, its type and its time.
+	static constexpr size_t VFS_INDEX_SOURCE_SIZE_MIN = 4 + 8 + 8;
+	static constexpr size_t VFS_INDEX_NODE_SIZE_MIN = 1 + 4 + 8;
+
+	void Vfs::add_source(std::filesystem::path const& path,
+	                     std::byte const* data,
+	                     std::size_t size,
+	                     std::shared_ptr<detail::VfsLazyDisk> lazy) {
+		std::error_code ec;
+		auto absolute = std::filesystem::absolute(path, ec);
+		if (ec) absolute = path;
+
+		auto time = std::filesystem::last_write_time(path, ec);
+		if (ec) time = std::filesystem::file_time_type::min();
+
+		_m_sources.push_back(detail::VfsSource {std::move(absolute), time, data, size, std::move(lazy)});
+	}
+
+	std::vector<uint32_t> Vfs::source_order() const {
+		// Sort the sources by address, so the source of a file can be found using a binary search.
+		std::vector<uint32_t> order(_m_sources.size());
+		for (uint32_t i = 0; i < order.size(); ++i) {
+			order[i] = i;
+		}
+
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+			return std::less<> {}(_m_sources[a].data, _m_sources[b].data);
+		});
+
+		return order;
+	}
+
+	bool Vfs::find_source(std::vector<uint32_t> const& order,
+	                      VfsFileDescriptor const& fd,
+	                      uint32_t& source,
+	                      uint64_t& offset) const {
+		if (fd._m_disk != nullptr) {
+			for (uint32_t i = 0; i < _m_sources.size(); ++i) {
+				if (_m_sources[i].lazy == fd._m_disk) {
+					source = i;
+					offset = fd._m_offset;
+					return true;
+				}
+			}
+		}
+
+		auto it = std::upper_bound(order.begin(), order.end(), fd.memory, [this](auto const* mem, uint32_t i) {
+			return std::less<> {}(mem, _m_sources[i].data);
+		});
+
+		if (it == order.begin()) return false;
+
+		auto const& candidate = _m_sources[*std::prev(it)];
+		if (!std::less_equal<> {}(fd.memory + fd.size, candidate.data + candidate.size)) return false;
+
+		source = *std::prev(it);
+		offset = static_cast<uint64_t>(fd.memory - candidate.data);
+		return true;
+	}
+
+	void Vfs::save_index(std::filesystem::path const& path) const {
+		auto order = this->source_order();
+
+		auto find_source = [this, &order](VfsNode const& node) -> std::pair<uint32_t, uint64_t> {
+			uint32_t source;
+			uint64_t offset;
+
+			if (!this->find_source(order, std::get<VfsFileDescriptor>(node._m_data), source, offset)) {
+				throw Error {"cannot save index: \"" + node.name() + "\" was not mounted from a host file"};
+			}
+
+			return {source, offset};
+		};
+
+		auto w = Write::to(path);
+		w->write(VFS_INDEX_MAGIC, sizeof VFS_INDEX_MAGIC);
+		w->write_uint(VFS_INDEX_VERSION);
+
+		w->write_uint(static_cast<uint32_t>(_m_sources.size()));
+		for (auto const& source : _m_sources) {
+			auto source_path = source.path.u8string();
+			uint64_t size = source.size;
+			int64_t time = source.time.time_since_epoch().count();
+
+			w->write_uint(static_cast<uint32_t>(source_path.size()));
+			w->write_string(source_path);
+			w->write(&size, sizeof size);
+			w->write(&time, sizeof time);
+		}
+
+		std::function<void(VfsNode const&)> write_children = [&](VfsNode const& parent) {
+			w->write_uint(static_cast<uint32_t>(parent.children().size()));
+
+			for (auto const& node : parent.children()) {
+				int64_t time = node.time();
+
+				w->write_ubyte(static_cast<uint8_t>(node.type()));
+				w->write_uint(static_cast<uint32_t>(node.name().size()));
+				w->write_string(node.name());
+				w->write(&time, sizeof time);
+
+				if (node.type() == VfsNodeType::DIRECTORY) {
+					write_children(node);
+					continue;
+				}
+
+				auto [source, offset] = find_source(node);
+				uint64_t size = std::get<VfsFileDescriptor>(node._m_data).size;
+
+				w->write_uint(source);
+				w->write(&offset, sizeof offset);
+				w->write(&size, sizeof size);
+			}
+		};
+
+		write_children(_m_root);
+	}
+
+	bool Vfs::load_index(std::filesystem::path const& path) {
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec)) return false;
+
+		auto r = Read::from(path);
+		r->seek(0, Whence::END);
+		auto end = r->tell();
+		r->seek(0, Whence::BEG);
+
+		char magic[sizeof VFS_INDEX_MAGIC];
+		if (r->read(magic, sizeof magic) != sizeof magic || memcmp(magic, VFS_INDEX_MAGIC, sizeof magic) != 0 ||
+		    r->read_uint() != VFS_INDEX_VERSION) {
+			ZKLOGW("Vfs", "Ignoring invalid index %s", path.u8string().c_str());
+			return false;
+		}
+
+		// All counts and lengths come straight from the file, so they are checked against the bytes which are left
+		// before anything is allocated for them.
+		auto read_count = [&r, end, &path](size_t min_entry_size) {
+			auto count = r->read_uint();
+			if (count > (end - r->tell()) / min_entry_size) {
+				throw VfsBrokenDiskError {"Corrupt index " + path.u8string()};
+			}
+			return count;
+		};
+
+		auto read_string = [&read_count, &r]() {
+			return r->read_string(read_count(1));
+		};
+
+		std::vector<detail::VfsSource> sources(read_count(VFS_INDEX_SOURCE_SIZE_MIN));
+		for (auto& source : sources) {
+			auto source_path = read_string();
+			uint64_t size = 0;
+			int64_t time = 0;
+
+			r->read(&size, sizeof size);
+			r->read(&time, sizeof time);
+
+			source.path = std::filesystem::u8path(source_path);
+			source.time = std::filesystem::last_write_time(source.path, ec);
+
+			// Reject the index if any of the host files changed since it was saved.
+			if (ec || source.time.time_since_epoch().count() != time ||
+			    std::filesystem::file_size(source.path, ec) != size || ec) {
+				ZKLOGI("Vfs", "Index %s is out of date", path.u8string().c_str());
+				return false;
+			}
+
+			source.size = static_cast<size_t>(size);
+		}
+
+#ifdef _ZK_WITH_MMAP
+		std::vector<Mmap> data;
+#else
+		std::vector<std::unique_ptr<std::byte[]>> data;
+#endif
+
+		for (auto& source : sources) {
+			if (source.size == 0) continue;
+
+			if (_m_lazy_disks) {
+				source.lazy = std::make_shared<detail::VfsLazyDisk>(source.path, source.size);
+				continue;
+			}
+
+			try {
+#ifdef _ZK_WITH_MMAP
+				source.data = data.emplace_back(source.path).data();
+#else
+				source.data = data.emplace_back(vfs_read_host_file(source.path, source.size)).get();
+#endif
+			} catch (std::exception const& e) {
+				ZKLOGW("Vfs", "Failed to map %s: %s", source.path.u8string().c_str(), e.what());
+				return false;
+			}
+		}
+
+		std::function<bool(VfsNode&)> read_children = [&](VfsNode& parent) {
+			auto count = read_count(VFS_INDEX_NODE_SIZE_MIN);
+
+			for (uint32_t i = 0; i < count; ++i) {
+				int64_t time = 0;
+
+				auto type = static_cast<VfsNodeType>(r->read_ubyte());
+				auto name = read_string();
+				r->read(&time, sizeof time);
+
+				if (type == VfsNodeType::DIRECTORY) {
+					auto* dir = parent.create(VfsNode::directory(name, time));
+					if (!read_children(*dir)) return false;
+				} else if (type == VfsNodeType::FILE) {
+					auto source = r->read_uint();
+					uint64_t offset = 0, size = 0;
+					r->read(&offset, sizeof offset);
+					r->read(&size, sizeof size);
+
+					if (source >= sources.size()) return false;
+
+					// Written so that large values from the file cannot wrap around.
+					auto limit = sources[source].size;
+					if (offset > limit || size > limit - offset) return false;
+
+					auto const& src = sources[source];
+					parent.create(VfsNode::file(name,
+					                            src.lazy != nullptr
+					                                ? VfsFileDescriptor {src.lazy, offset, size}
+					                                : VfsFileDescriptor {src.data + offset, size, false},
+					                            time));
+				} else {
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		auto root = VfsNode::directory("/");
+		if (!read_children(root)) {
+			ZKLOGW("Vfs", "Ignoring invalid index %s", path.u8string().c_str());
+			return false;
+		}
+
+		detail::VfsWriteGuard guard {*_m_state};
+		for (auto& mem : data) {
+#ifdef _ZK_WITH_MMAP
+			_m_data_mapped.push_back(std::move(mem));
+#else
+			_m_data.push_back(std::move(mem));
+#endif
+		}
+
+		_m_sources.insert(_m_sources.end(), sources.begin(), sources.end());
+		vfs_mount_root(*this, root, VfsOverwriteBehavior::ALL);
+		return true;
+	}
+
+	void Vfs::mount_disk(std::filesystem::path const& host, VfsOverwriteBehavior overwrite) {
+		this->mount_disks({host}, overwrite);
 	}
 
 	static std::time_t vfs_dos_to_unix_time(std::uint32_t dos) noexcept {
@@ -331,6 +1506,7 @@ namespace zenkit {
 	}
 
 	void Vfs::mount_disk(Read* buf, VfsOverwriteBehavior overwrite) {
+		MemoryScope memory {MemoryCategory::VFS};
 		buf->seek(0, Whence::END);
 		auto size = buf->tell();
 		buf->seek(0, Whence::BEG);
@@ -347,7 +1523,11 @@ namespace zenkit {
 	}
 
 	void Vfs::mount(VfsNode node, std::string_view parent, VfsOverwriteBehavior overwrite) {
-		VfsNode* pNode = this->resolve(parent);
+		if (_m_hash_files) hash_tree(node);
+
+		detail::VfsWriteGuard guard {*_m_state};
+		if (_m_access_stats) attach_stats(node);
+		VfsNode* pNode = this->walk(parent);
 		if (pNode == nullptr) {
 			throw VfsNotFoundError {std::string {parent}};
 		}
@@ -399,6 +1579,7 @@ namespace zenkit {
 	}
 
 	VfsNode& Vfs::mkdir(std::string_view path) {
+		detail::VfsWriteGuard guard {*_m_state};
 		auto* context = &_m_root;
 
 		while (!path.empty()) {
@@ -427,23 +1608,31 @@ namespace zenkit {
 	}
 
 	bool Vfs::remove(std::string_view path) {
+		detail::VfsWriteGuard guard {*_m_state};
 		auto lastSlash = path.rfind('/');
 		auto parentPath = path.substr(0, lastSlash == std::string_view::npos ? 0 : lastSlash);
 		auto childName = path.substr(lastSlash + 1);
 
-		VfsNode* pNode = this->resolve(parentPath);
-		if (pNode == nullptr) return false;
+		VfsNode* pNode = this->walk(parentPath);
+		if (pNode == nullptr || pNode->type() != VfsNodeType::DIRECTORY) return false;
 		return pNode->remove(childName);
 	}
 
 	void Vfs::mount_host(std::filesystem::path const& sourcePath,
 	                     std::string_view mountPoint,
 	                     VfsOverwriteBehavior overwrite) {
+		detail::VfsWriteGuard guard {*_m_state};
 		auto root = VfsNode::directory(sourcePath.filename().string());
 
 		std::function<void(VfsNode*, std::filesystem::path const&)> load_directory =
 		    [this, &load_directory](VfsNode* parent, std::filesystem::path const& host) {
-			    for (auto const& ref : std::filesystem::directory_iterator(host)) {
+			    // Sort the entries beforehand so that they can be appended to their parent in order.
+			    std::vector<std::filesystem::directory_entry> entries {std::filesystem::directory_iterator(host), {}};
+			    std::sort(entries.begin(), entries.end(), [](auto const& a, auto const& b) {
+				    return icompare(a.path().filename().string(), b.path().filename().string());
+			    });
+
+			    for (auto const& ref : entries) {
 				    auto const& path = ref.path();
 				    auto time =
 				        std::chrono::duration_cast<std::chrono::seconds>(ref.last_write_time().time_since_epoch());
@@ -454,6 +1643,7 @@ namespace zenkit {
 				    } else if (ref.file_size() > 0) {
 #ifdef _ZK_WITH_MMAP
 					    auto& mem = this->_m_data_mapped.emplace_back(path);
+					    this->add_source(path, mem.data(), mem.size());
 					    parent->create(VfsNode::file(path.filename().string(),
 					                                 VfsFileDescriptor {mem.data(), mem.size(), false},
 					                                 time.count()));
@@ -464,6 +1654,7 @@ namespace zenkit {
 
 					    auto& data = _m_data.emplace_back(new std::byte[(size_t) size]);
 					    stream.read((char*) data.get(), size);
+					    this->add_source(path, data.get(), static_cast<size_t>(size));
 
 					    parent->create(VfsNode::file(path.filename().string(),
 					                                 VfsFileDescriptor {data.get(), static_cast<size_t>(size), false},
@@ -480,8 +1671,101 @@ namespace zenkit {
 		}
 	}
 
-	void Vfs::mount_disk(std::byte const* buf, std::size_t size, VfsOverwriteBehavior overwrite) {
-		auto r = Read::from(buf, size);
+	void Vfs::watch_host(std::filesystem::path const& host, std::string_view parent) {
+		auto watch = std::make_unique<detail::VfsHostWatch>(host, parent);
+
+		detail::VfsWriteGuard guard {*_m_state};
+		_m_watches.push_back(std::move(watch));
+	}
+
+	std::size_t Vfs::poll_host_changes() {
+		std::vector<std::pair<detail::VfsHostWatch const*, std::filesystem::path>> changes;
+		std::vector<std::filesystem::path> paths;
+
+		for (auto& watch : _m_watches) {
+			paths.clear();
+			watch->changes(paths);
+
+			// Parent directories sort before their contents, so they are created first.
+			std::sort(paths.begin(), paths.end());
+			paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+			for (auto& path : paths) {
+				changes.emplace_back(watch.get(), std::move(path));
+			}
+		}
+
+		// Don't block readers unless there is something to do.
+		if (changes.empty()) return 0;
+
+		detail::VfsWriteGuard guard {*_m_state};
+		for (auto const& [watch, rel] : changes) {
+			this->apply_host_change(*watch, rel);
+		}
+
+		return changes.size();
+	}
+
+	void Vfs::apply_host_change(detail::VfsHostWatch const& watch, std::filesystem::path const& rel) {
+		auto host = watch.host / rel;
+		auto name = rel.filename().string();
+		auto path = watch.mount_point + '/' + rel.generic_string();
+		auto* parent = this->walk(watch.mount_point + '/' + rel.parent_path().generic_string());
+
+		std::error_code ec;
+		auto status = std::filesystem::status(host, ec);
+
+		if (std::filesystem::is_directory(status)) {
+			if (parent != nullptr && parent->type() == VfsNodeType::DIRECTORY) {
+				auto const* existing = parent->child(name);
+				if (existing != nullptr && existing->type() == VfsNodeType::DIRECTORY) return;
+				if (existing != nullptr) parent->remove(name);
+			}
+
+			ZKLOGD("Vfs", "Mounting new host directory %s", host.u8string().c_str());
+			this->mkdir(path);
+			this->mount_host(host, path, VfsOverwriteBehavior::ALL);
+			return;
+		}
+
+		// Changes in directories which haven't been mounted yet are applied once the directory is.
+		if (parent == nullptr || parent->type() != VfsNodeType::DIRECTORY) return;
+
+		auto size = std::filesystem::is_regular_file(status) ? std::filesystem::file_size(host, ec) : 0;
+		if (ec || size == 0) {
+			// Like in #mount_host, empty files are not mounted.
+			parent->remove(name);
+			return;
+		}
+
+		std::ifstream stream {host, std::ios::in | std::ios::binary};
+		VfsFileDescriptor fd {new std::byte[size], static_cast<size_t>(size), true};
+		stream.read((char*) fd.memory, static_cast<std::streamsize>(size));
+
+		if (!stream) {
+			ZKLOGW("Vfs", "Failed to reload %s", host.u8string().c_str());
+			return;
+		}
+
+		auto time = std::chrono::duration_cast<std::chrono::seconds>(
+		    std::filesystem::last_write_time(host, ec).time_since_epoch());
+
+		ZKLOGD("Vfs", "Reloading host file %s", host.u8string().c_str());
+		auto node = VfsNode::file(name, std::move(fd), time.count());
+		if (_m_hash_files) hash_tree(node);
+		if (_m_access_stats) attach_stats(node);
+		parent->create(std::move(node));
+	}
+
+	/// \brief Parses the catalog of the disk in the given buffer into a detached tree.
+	/// \param overwrite The behavior to apply to conflicting entries within the same disk.
+	/// \return The root node of the disk.
+	static VfsNode vfs_parse_disk(Read* r,
+	                              std::size_t size,
+	                              VfsOverwriteBehavior overwrite,
+	                              std::function<VfsFileDescriptor(uint32_t, uint32_t)> const& make_file) {
+		ZKTRACE_ZONE(zone, "Vfs.parse_catalog");
+		auto begin = r->tell();
 
 		auto comment = r->read_string(256);
 		auto signature = r->read_string(16);
@@ -496,6 +1780,8 @@ namespace zenkit {
 			throw VfsBrokenDiskError {"Detected unsupported Union disk"};
 		}
 
+		auto header_size = r->tell() - begin;
+
 		if (signature == VFS_DISK_SIGNATURE_VDFSTOOL) {
 			ZKLOGI("Vfs", "VDFS tool disk detected");
 		} else if (signature == VFS_DISK_SIGNATURE_G1) {
@@ -515,7 +1801,7 @@ namespace zenkit {
 		}
 
 		std::function<bool(VfsNode*)> load_entry =
-		    [&load_entry, overwrite, catalog_offset, timestamp, &r, buf, size](VfsNode* parent) {
+		    [&load_entry, &make_file, overwrite, catalog_offset, timestamp, r, size](VfsNode* parent) {
 			    auto e_name = r->read_string(64);
 			    auto e_offset = r->read_uint();
 			    auto e_size = r->read_uint();
@@ -601,15 +1887,144 @@ namespace zenkit {
 					    parent->remove(e_name);
 				    }
 
-				    (void) parent->create(
-				        VfsNode::file(e_name, VfsFileDescriptor {buf + e_offset, e_size, false}, timestamp));
+				    (void) parent->create(VfsNode::file(e_name, make_file(e_offset, e_size), timestamp));
 			    }
 
 			    return last;
 		    };
 
+		auto root = VfsNode::directory("/");
+
 		r->seek(catalog_offset, Whence::BEG);
-		while (!load_entry(&_m_root))
+		while (!load_entry(&root))
 			;
+
+		// Only the header and the catalog are read, the contents of the files stay where they are.
+		ZKTRACE_BYTES(zone, header_size + r->tell() - catalog_offset);
+		return root;
+	}
+
+	void Vfs::mount_disk(std::byte const* buf, std::size_t size, VfsOverwriteBehavior overwrite) {
+		ZKTRACE_ZONE(zone, "Vfs.mount_disk");
+		ZKTRACE_BYTES(zone, size);
+		MemoryScope memory {MemoryCategory::VFS};
+
+		auto r = Read::from(buf, size);
+		auto root = vfs_parse_disk(r.get(), size, overwrite, [buf](uint32_t offset, uint32_t len) {
+			return VfsFileDescriptor {buf + offset, len, false};
+		});
+
+		detail::VfsWriteGuard guard {*_m_state};
+		vfs_mount_root(*this, root, overwrite);
+	}
+
+	void Vfs::mount_disk_streamed(std::unique_ptr<Read> source, VfsOverwriteBehavior overwrite) {
+		source->seek(0, Whence::END);
+		auto size = source->tell();
+		source->seek(0, Whence::BEG);
+
+		ZKTRACE_ZONE(zone, "Vfs.mount_disk");
+		ZKTRACE_BYTES(zone, size);
+		MemoryScope memory {MemoryCategory::VFS};
+
+		// The catalog is parsed before any file can be opened, so the source can be used without locking it.
+		auto* r = source.get();
+		auto disk = std::make_shared<detail::VfsLazyDisk>(std::move(source), size);
+		auto root = vfs_parse_disk(r, size, overwrite, [&disk](uint32_t offset, uint32_t len) {
+			return VfsFileDescriptor {disk, offset, len};
+		});
+
+		detail::VfsWriteGuard guard {*_m_state};
+		vfs_mount_root(*this, root, overwrite);
+	}
+
+	/// \brief A disk which has been loaded and parsed, but not yet merged into a Vfs.
+	struct VfsLoadedDisk {
+		std::optional<VfsNode> root;
+		std::shared_ptr<detail::VfsLazyDisk> lazy;
+		std::byte const* base {nullptr};
+		std::size_t size {0};
+
+#ifdef _ZK_WITH_MMAP
+		std::optional<Mmap> data;
+#else
+		std::unique_ptr<std::byte[]> data;
+#endif
+	};
+
+	static void vfs_load_disk(VfsLoadedDisk& disk,
+	                          std::filesystem::path const& host,
+	                          bool lazy,
+	                          VfsOverwriteBehavior overwrite) {
+		ZKTRACE_ZONE(zone, "Vfs.load_disk");
+		MemoryScope memory {MemoryCategory::VFS};
+
+		if (lazy) {
+			// Only read the header and catalog, using a buffered stream.
+			std::ifstream stream {host, std::ios::in | std::ios::binary};
+			if (!stream) throw std::runtime_error {"Failed to open " + host.string()};
+
+			disk.size = std::filesystem::file_size(host);
+			disk.lazy = std::make_shared<detail::VfsLazyDisk>(host, disk.size);
+
+			auto r = Read::from(&stream, 64 * 1024);
+			disk.root = vfs_parse_disk(r.get(), disk.size, overwrite, [&disk](uint32_t offset, uint32_t len) {
+				return VfsFileDescriptor {disk.lazy, offset, len};
+			});
+			ZKTRACE_BYTES(zone, disk.size);
+			return;
+		}
+
+#ifdef _ZK_WITH_MMAP
+		auto& mem = disk.data.emplace(host);
+		disk.base = mem.data();
+		disk.size = mem.size();
+#else
+		disk.data = vfs_read_host_file(host, disk.size);
+		disk.base = disk.data.get();
+#endif
+
+		auto r = Read::from(disk.base, disk.size);
+		disk.root = vfs_parse_disk(r.get(), disk.size, overwrite, [base = disk.base](uint32_t offset, uint32_t len) {
+			return VfsFileDescriptor {base + offset, len, false};
+		});
+		ZKTRACE_BYTES(zone, disk.size);
+	}
+
+	void Vfs::mount_disks(std::vector<std::filesystem::path> const& hosts, VfsOverwriteBehavior overwrite) {
+		ZKTRACE("Vfs.mount_disks");
+		MemoryScope memory {MemoryCategory::VFS};
+		std::vector<VfsLoadedDisk> disks(hosts.size());
+		std::vector<std::exception_ptr> errors(hosts.size());
+
+		auto load = [&](size_t i) {
+			MemoryScope scope {MemoryCategory::VFS};
+
+			try {
+				vfs_load_disk(disks[i], hosts[i], _m_lazy_disks, overwrite);
+				if (_m_hash_files) hash_tree(*disks[i].root);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		};
+
+		parallel_for(hosts.size(), load);
+
+		// Merge the disks in order to get the same result as mounting them one after another.
+		detail::VfsWriteGuard guard {*_m_state};
+		for (size_t i = 0; i < hosts.size(); ++i) {
+			if (errors[i]) std::rethrow_exception(errors[i]);
+
+			auto& disk = disks[i];
+			this->add_source(hosts[i], disk.base, disk.size, disk.lazy);
+
+#ifdef _ZK_WITH_MMAP
+			if (disk.data) _m_data_mapped.push_back(std::move(*disk.data));
+#else
+			if (disk.data) _m_data.push_back(std::move(disk.data));
+#endif
+
+			vfs_mount_root(*this, *disk.root, overwrite);
+		}
 	}
 } // namespace zenkit
@@ -2,16 +2,46 @@
 // SPDX-License-Identifier: MIT
 #include "zenkit/World.hh"
 #include "zenkit/Archive.hh"
+#include "zenkit/Executor.hh"
+#include "zenkit/MultiResolutionMesh.hh"
 #include "zenkit/Stream.hh"
+#include "zenkit/Vfs.hh"
 #include "zenkit/vobs/Misc.hh"
 
+#include "Cooked.hh"
 #include "Internal.hh"
 #include "zenkit/CutsceneLibrary.hh"
 
+#include <algorithm>
+#include <set>
+
 namespace zenkit {
 	[[maybe_unused]] static constexpr uint32_t BSP_VERSION_G1 = 0x2090000;
 	static constexpr uint32_t BSP_VERSION_G2 = 0x4090000;
 
+	static constexpr uint32_t COOKED_WORLD_MAGIC = 0x57434B5A; // "ZKCW"
+	static constexpr uint32_t COOKED_WORLD_VERSION = 1;
+	static constexpr uint32_t COOKED_WORLD_ALIGNMENT = 16;
+
+	enum class CookedWorldSection : uint32_t {
+		MESH = 0x4853454D,     // "MESH"
+		BSP_TREE = 0x54505342, // "BSPT"
+		VOB_TREE = 0x53424F56, // "VOBS"
+		WAY_NET = 0x4E594157,  // "WAYN"
+		ASSETS = 0x54455341,   // "ASET"
+	};
+
+	/// \brief The sizes of the types stored in their in-memory representation. Cooked worlds saved by a build which
+	///        lays out any of them differently are rejected.
+	static constexpr uint32_t COOKED_WORLD_LAYOUT[] = {
+	    sizeof(Vec3),
+	    sizeof(VertexFeature),
+	    sizeof(Polygon),
+	    sizeof(PolygonFlagSet),
+	    sizeof(BspNode),
+	    sizeof(BspTraversalNode),
+	};
+
 	/// \brief Tries to determine the serialization version of a game world.
 	///
 	/// This function might be very slow. If the VOb tree or way-net or both come before the mesh section in the
@@ -21,6 +51,7 @@ namespace zenkit {
 	/// \param buf A buffer containing the world's data.
 	/// \return The game version associated with that world.
 	static GameVersion determine_world_version(Read* buf) {
+		ZKTRACE("World.determine_version");
 		auto archive = ReadArchive::from(buf);
 
 		if (archive->is_save_game()) {
@@ -46,31 +77,73 @@ namespace zenkit {
 	}
 
 	void World::load(Read* r) {
+		this->load(r, WorldLoadOptions {});
+	}
+
+	void World::load(Read* r, WorldLoadOptions const& options) {
 		auto begin = r->tell();
 		auto version = determine_world_version(r);
 		r->seek(static_cast<ssize_t>(begin), Whence::BEG);
-		this->load(r, version);
+		this->load(r, version, options);
 	}
 
 	void World::load(Read* r, GameVersion version) {
+		this->load(r, version, nullptr);
+	}
+
+	void World::load(Read* r, GameVersion version, std::shared_ptr<ObjectArena> arena) {
+		WorldLoadOptions options {};
+		options.arena = std::move(arena);
+		this->load(r, version, options);
+	}
+
+	void World::load(Read* r, GameVersion version, WorldLoadOptions const& options) {
+		ZKTRACE_ZONE(zone, "World.load");
+		MemoryScope memory {MemoryCategory::WORLD};
+		auto begin = r->tell();
+
 		ArchiveObject chnk {};
 		auto ar = ReadArchive::from(r);
+
+		if (options.arena == nullptr && options.memory != nullptr) {
+			ar->set_arena(ObjectArena::create(1024 * 1024, options.memory));
+		} else {
+			ar->set_arena(options.arena);
+		}
 		ar->read_object_begin(chnk);
 
 		if (chnk.class_name != "oCWorld:zCWorld") {
 			throw ParserError {"World", "'oCWorld:zCWorld' chunk expected, got '" + chnk.class_name + "'"};
 		}
 
-		this->load(*ar, version);
+		this->load(*ar, version, options);
 
 		if (!ar->read_object_end()) {
-			ZKLOGW("World", "Not fully parsed");
+			// Skipped NPCs are left unread at the end of the world.
+			if (!options.skip_npcs || !ar->is_save_game()) ZKLOGW("World", "Not fully parsed");
 			ar->skip_object(true);
 		}
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
 	}
 
 	void World::load(ReadArchive& r, GameVersion version) {
+		this->load(r, version, WorldLoadOptions {});
+	}
+
+	void World::load(ReadArchive& r, GameVersion version, WorldLoadOptions const& options) {
+		MemoryScope memory {MemoryCategory::WORLD};
 		ArchiveObject hdr;
+		this->invalidate_vob_index();
+		this->invalidate_waypoint_index();
+
+#ifdef _ZK_WITH_THREADS
+		// With `options.parallel`, the mesh and BSP-tree are decoded by these tasks while the rest of the world is
+		// loaded. The group is declared after the tree, so that the tasks are done before it is destroyed.
+		BspTree parallel_bsp {};
+		TaskGroup parallel_tasks;
+		bool parallel = false;
+#endif
 
 		// Load properties of `zCWorld`
 		while (!r.read_object_end()) {
@@ -89,11 +162,18 @@ namespace zenkit {
 				auto* raw = r.get_stream();
 
 				auto bsp_version = raw->read_uint();
-				(void) /* size = */ raw->read_uint();
+				auto size = raw->read_uint();
+
+				ZKTRACE_ZONE(section_zone, "World.MeshAndBsp");
+				ZKTRACE_BYTES(section_zone, size);
 
 				std::uint16_t chunk_type;
 				auto mesh_offset = raw->tell();
 
+				// We're about to read the whole mesh and BSP-tree. For memory-mapped worlds, this lets the pages
+				// load in the background while we walk the chunk headers.
+				raw->prefetch(mesh_offset, size);
+
 				do {
 					chunk_type = raw->read_ushort();
 					raw->seek(raw->read_uint(), Whence::CUR);
@@ -104,32 +184,93 @@ namespace zenkit {
 					ZKLOGI("World", "XZEN world detected, forcing wide vertex indices");
 				}
 
-				this->world_bsp_tree.load(raw, bsp_version);
-				auto end = raw->tell();
+				auto bsp_offset = raw->tell();
+
+				if (options.skip_mesh && options.skip_bsp) {
+					// Only walk the chunk headers of the BSP-tree to find the end of the section.
+					do {
+						chunk_type = raw->read_ushort();
+						raw->seek(raw->read_uint(), Whence::CUR);
+					} while (chunk_type != 0xC0FF && !raw->eof());
+#ifdef _ZK_WITH_THREADS
+				} else if (options.parallel) {
+					do {
+						chunk_type = raw->read_ushort();
+						raw->seek(raw->read_uint(), Whence::CUR);
+					} while (chunk_type != 0xC0FF && !raw->eof());
+					auto end = raw->tell();
+
+					// Both sections are self-contained, so they can be decoded from their own slices.
+					raw->seek(static_cast<ssize_t>(mesh_offset), Whence::BEG);
+					std::shared_ptr<Read> mesh = raw->slice(bsp_offset - mesh_offset);
+					std::shared_ptr<Read> bsp = raw->slice(end - bsp_offset);
+
+					parallel_tasks.run([&parallel_bsp, bsp, bsp_version] {
+						MemoryScope scope {MemoryCategory::MESH};
+						parallel_bsp.load(bsp.get(), bsp_version);
+					});
+
+					if (!options.skip_mesh) {
+						parallel_tasks.run([this, mesh, is_xzen] { this->world_mesh.load(mesh.get(), is_xzen); });
+					}
+
+					parallel = true;
+
+					raw->seek(static_cast<ssize_t>(end), Whence::BEG);
+#endif
+				} else {
+					// The mesh needs the leaf polygons of the BSP-tree, so that is loaded even if it is skipped.
+					BspTree bsp {};
+					bsp.load(raw, bsp_version);
+					auto end = raw->tell();
+
+					if (!options.skip_mesh) {
+						// Hand the mesh loader a view bounded to the mesh chunks. For memory-backed worlds, this
+						// does not copy the mesh data.
+						raw->seek(static_cast<ssize_t>(mesh_offset), Whence::BEG);
+						auto mesh = raw->slice(bsp_offset - mesh_offset);
+						this->world_mesh.load(mesh.get(), bsp.leaf_polygons, is_xzen);
+					}
 
-				raw->seek(static_cast<ssize_t>(mesh_offset), Whence::BEG);
-				this->world_mesh.load(raw, this->world_bsp_tree.leaf_polygons, is_xzen);
+					if (!options.skip_bsp) {
+						this->world_bsp_tree = std::move(bsp);
+					}
 
-				raw->seek(static_cast<ssize_t>(end), Whence::BEG);
+					raw->seek(static_cast<ssize_t>(end), Whence::BEG);
+				}
+			} else if (hdr.object_name == "VobTree" && options.skip_vobs) {
+				r.skip_object(true);
+				continue;
 			} else if (hdr.object_name == "VobTree") {
+				ZKTRACE_ZONE(section_zone, "World.VobTree");
+				auto begin = r.get_stream()->tell();
+				r.set_class_filter(options.vob_classes);
+
 				auto count = r.read_int(); // childs0
 				for (auto i = 0; i < count; ++i) {
-					auto child = parse_vob_tree(r, version);
+					auto before = this->world_vobs.size();
+					parse_vob_tree(r, version, this->world_vobs);
 
 					// We failed to parse this root VObject.
-					if (child == nullptr) {
+					if (before == this->world_vobs.size() && options.vob_classes.empty()) {
 						ZKLOGE("World", "Failed to parse root VOb %d!", i);
-						continue;
 					}
-
-					this->world_vobs.push_back(std::move(child));
 				}
+
+				r.set_class_filter({});
+				ZKTRACE_BYTES(section_zone, r.get_stream()->tell() - begin);
+			} else if (hdr.object_name == "WayNet" && options.skip_way_net) {
+				r.skip_object(true);
+				continue;
 			} else if (hdr.object_name == "WayNet") {
+				ZKTRACE_ZONE(section_zone, "World.WayNet");
+				auto begin = r.get_stream()->tell();
 #ifndef ZK_FUTURE
 				this->world_way_net.load(r);
 #else
 				this->way_net = r.read_object<WayNet>(version);
 #endif
+				ZKTRACE_BYTES(section_zone, r.get_stream()->tell() - begin);
 			} else if (hdr.object_name == "CutscenePlayer") {
 				this->player = r.read_object<CutscenePlayer>(version);
 			} else if (hdr.object_name == "SkyCtrl") {
@@ -150,7 +291,30 @@ namespace zenkit {
 			}
 		}
 
-		if (r.is_save_game()) {
+#ifdef _ZK_WITH_THREADS
+		if (parallel) {
+			ZKTRACE("World.join_mesh_and_bsp");
+			parallel_tasks.wait();
+
+			// The mesh can only be triangulated once the leaf polygons of the BSP-tree are known.
+			if (!options.skip_mesh) {
+				this->world_mesh.triangulate(parallel_bsp.leaf_polygons);
+			}
+
+			if (!options.skip_bsp) {
+				this->world_bsp_tree = std::move(parallel_bsp);
+			}
+		}
+#endif
+
+		if (options.materials != nullptr && !options.skip_mesh) {
+			this->world_mesh.intern_materials(*options.materials);
+		}
+
+		if (r.is_save_game() && !options.skip_npcs) {
+			ZKTRACE_ZONE(npcs_zone, "World.npcs");
+			auto begin = r.get_stream()->tell();
+
 			// Then, read all the NPCs
 			auto npc_count = r.read_int(); // npcCount
 			this->npcs.resize(npc_count);
@@ -173,6 +337,8 @@ namespace zenkit {
 			if (version == GameVersion::GOTHIC_2) {
 				this->npc_spawn_flags = r.read_int(); // spawnFlags
 			}
+
+			ZKTRACE_BYTES(npcs_zone, r.get_stream()->tell() - begin);
 		}
 	}
 
@@ -244,10 +410,413 @@ namespace zenkit {
 		}
 	}
 
+	/// \brief Collects the names of the compiled textures and multi-resolution meshes used by a world.
+	static void collect_cooked_assets(World const& world, Vfs const& vfs, std::set<std::string>& names) {
+		auto add_texture = [&names](std::string_view name) {
+			if (name.empty()) return;
+			names.emplace(std::string {name.substr(0, name.rfind('.'))} + "-C.TEX");
+		};
+
+		for (auto& material : world.world_mesh.materials) {
+			add_texture(material.texture);
+		}
+
+		std::vector<VirtualObject const*> stack;
+		for (auto& root : world.world_vobs) {
+			if (root != nullptr) stack.push_back(root.get());
+		}
+
+		while (!stack.empty()) {
+			auto* vob = stack.back();
+			stack.pop_back();
+
+			for (auto& child : vob->children) {
+				if (child != nullptr) stack.push_back(child.get());
+			}
+
+			if (vob->visual == nullptr || vob->visual->name.empty()) continue;
+			auto const& name = vob->visual->name;
+
+			if (vob->visual->type == VisualType::DECAL) {
+				add_texture(name);
+			} else if (vob->visual->type == VisualType::MESH ||
+			           vob->visual->type == VisualType::MULTI_RESOLUTION_MESH) {
+				auto mrm = name.substr(0, name.rfind('.')) + ".MRM";
+				if (!names.emplace(mrm).second) continue;
+
+				// The textures used by the mesh are needed as well.
+				auto const* node = vfs.find(mrm);
+				if (node == nullptr) continue;
+
+				MultiResolutionMesh mesh {};
+				mesh.load(node->open_read().get());
+				for (auto& material : mesh.materials) {
+					add_texture(material.texture);
+				}
+			}
+		}
+	}
+
+	void World::save_cooked(Write* w, GameVersion version, Vfs const* assets) const {
+		ZKTRACE("World.save_cooked");
+		std::vector<std::pair<CookedWorldSection, std::vector<std::byte>>> sections;
+
+		{
+			auto& [id, data] = sections.emplace_back(CookedWorldSection::MESH, std::vector<std::byte> {});
+			this->world_mesh.save_cooked(Write::to(&data).get(), version);
+		}
+
+		{
+			auto& [id, data] = sections.emplace_back(CookedWorldSection::BSP_TREE, std::vector<std::byte> {});
+			this->world_bsp_tree.save_cooked(Write::to(&data).get());
+		}
+
+		{
+			auto& [id, data] = sections.emplace_back(CookedWorldSection::VOB_TREE, std::vector<std::byte> {});
+			auto stream = Write::to(&data);
+			auto ar = WriteArchive::to(stream.get(), ArchiveFormat::BINARY);
+
+			ar->write_int("childs0", this->world_vobs.size());
+			for (auto& root : this->world_vobs) {
+				save_vob_tree(*ar, version, root);
+			}
+
+			ar->write_header();
+		}
+
+		{
+			auto& [id, data] = sections.emplace_back(CookedWorldSection::WAY_NET, std::vector<std::byte> {});
+			auto stream = Write::to(&data);
+
+#ifndef ZK_FUTURE
+			stream->write_uint(static_cast<uint32_t>(this->world_way_net.waypoints.size()));
+			for (auto& wp : this->world_way_net.waypoints) {
+				detail::write_cooked(stream.get(), wp.name);
+				stream->write_int(wp.water_depth);
+				stream->write_ubyte(wp.under_water);
+				stream->write_vec3(wp.position);
+				stream->write_vec3(wp.direction);
+				stream->write_ubyte(wp.free_point);
+			}
+
+			detail::write_cooked(stream.get(), this->world_way_net.edges);
+#else
+			auto ar = WriteArchive::to(stream.get(), ArchiveFormat::BINARY);
+			ar->write_object("%", this->way_net, version);
+			ar->write_header();
+#endif
+		}
+
+		// Keeps the contents of the packed assets alive until they are written.
+		std::vector<std::vector<std::byte>> asset_data;
+
+		if (assets != nullptr) {
+			std::set<std::string> names;
+			collect_cooked_assets(*this, *assets, names);
+
+			Vfs pack {};
+			for (auto& name : names) {
+				auto const* node = assets->find(name);
+				if (node == nullptr) {
+					ZKLOGW("World", "Asset %s not found, not adding it to the cooked world", name.c_str());
+					continue;
+				}
+
+				auto r = node->open_read();
+				r->seek(0, Whence::END);
+				auto& data = asset_data.emplace_back(r->tell());
+				r->seek(0, Whence::BEG);
+				r->read(data.data(), data.size());
+
+				auto is_mesh = name.size() > 4 && iequals(std::string_view {name}.substr(name.size() - 4), ".MRM");
+				auto& dir = pack.mkdir(is_mesh ? "_WORK/DATA/MESHES/_COMPILED" : "_WORK/DATA/TEXTURES/_COMPILED");
+				dir.create(VfsNode::file(node->name(), VfsFileDescriptor {data.data(), data.size(), false}));
+			}
+
+			auto& [id, data] = sections.emplace_back(CookedWorldSection::ASSETS, std::vector<std::byte> {});
+			pack.save(Write::to(&data).get(), version);
+		}
+
+		auto align = [](uint32_t offset) {
+			return (offset + COOKED_WORLD_ALIGNMENT - 1) / COOKED_WORLD_ALIGNMENT * COOKED_WORLD_ALIGNMENT;
+		};
+
+		auto layout_count = static_cast<uint32_t>(std::size(COOKED_WORLD_LAYOUT));
+		auto header_size = 4 * (5 + layout_count) + 12 * static_cast<uint32_t>(sections.size());
+		auto offset = align(header_size);
+
+		w->write_uint(COOKED_WORLD_MAGIC);
+		w->write_uint(COOKED_WORLD_VERSION);
+		w->write_uint(layout_count);
+		for (auto size : COOKED_WORLD_LAYOUT) {
+			w->write_uint(size);
+		}
+
+		w->write_uint(static_cast<uint32_t>(version));
+		w->write_uint(static_cast<uint32_t>(sections.size()));
+
+		std::vector<uint32_t> offsets;
+		for (auto& [id, data] : sections) {
+			offsets.push_back(offset);
+
+			w->write_uint(static_cast<uint32_t>(id));
+			w->write_uint(offset);
+			w->write_uint(static_cast<uint32_t>(data.size()));
+			offset = align(offset + static_cast<uint32_t>(data.size()));
+		}
+
+		// Sections are padded, so that their arrays can be used straight from memory-mapped files.
+		std::byte const padding[COOKED_WORLD_ALIGNMENT] {};
+		w->write(padding, align(header_size) - header_size);
+
+		for (auto i = 0u; i < sections.size(); ++i) {
+			auto& data = sections[i].second;
+			w->write(data.data(), data.size());
+			w->write(padding, align(offsets[i] + data.size()) - offsets[i] - data.size());
+		}
+	}
+
+	void World::load_cooked(Read* r, WorldLoadOptions const& options, Vfs* assets) {
+		ZKTRACE("World.load_cooked");
+		MemoryScope memory {MemoryCategory::WORLD};
+		auto begin = r->tell();
+
+		if (r->read_uint() != COOKED_WORLD_MAGIC) {
+			throw ParserError {"World", "not a cooked world"};
+		}
+
+		auto incompatible = r->read_uint() != COOKED_WORLD_VERSION;
+		auto layout_count = r->read_uint();
+		incompatible |= layout_count != std::size(COOKED_WORLD_LAYOUT);
+
+		for (auto i = 0u; i < layout_count; ++i) {
+			auto size = r->read_uint();
+			incompatible |= i >= std::size(COOKED_WORLD_LAYOUT) || size != COOKED_WORLD_LAYOUT[i];
+		}
+
+		if (incompatible) {
+			throw ParserError {"World", "cooked world was saved by an incompatible build"};
+		}
+
+		auto version = static_cast<GameVersion>(r->read_uint());
+		auto section_count = detail::read_cooked_count(r, 3 * sizeof(std::uint32_t));
+
+		std::vector<std::tuple<CookedWorldSection, uint32_t, uint32_t>> table(section_count);
+		for (auto& [id, offset, size] : table) {
+			id = static_cast<CookedWorldSection>(r->read_uint());
+			offset = r->read_uint();
+			size = r->read_uint();
+		}
+
+		r->seek(0, Whence::END);
+		auto end = r->tell();
+
+		for (auto& [id, offset, size] : table) {
+			if (begin + offset + size > end) throw ParserError {"World", "cooked world is truncated"};
+		}
+
+		// For memory-backed streams, the slices share the memory of the cooked world.
+		auto section = [&](CookedWorldSection wanted) -> std::shared_ptr<Read> {
+			for (auto& [id, offset, size] : table) {
+				if (id != wanted) continue;
+
+				r->seek(static_cast<ssize_t>(begin + offset), Whence::BEG);
+				return r->slice(size);
+			}
+
+			return nullptr;
+		};
+
+		this->invalidate_vob_index();
+		this->invalidate_waypoint_index();
+
+		auto mesh = options.skip_mesh ? nullptr : section(CookedWorldSection::MESH);
+		auto bsp = options.skip_bsp ? nullptr : section(CookedWorldSection::BSP_TREE);
+
+#ifdef _ZK_WITH_THREADS
+		TaskGroup parallel_tasks;
+		if (options.parallel) {
+			if (mesh != nullptr) parallel_tasks.run([this, mesh] { this->world_mesh.load_cooked(mesh.get()); });
+			if (bsp != nullptr) parallel_tasks.run([this, bsp] { this->world_bsp_tree.load_cooked(bsp.get()); });
+			mesh = bsp = nullptr;
+		}
+#endif
+
+		if (mesh != nullptr) this->world_mesh.load_cooked(mesh.get());
+		if (bsp != nullptr) this->world_bsp_tree.load_cooked(bsp.get());
+
+		if (auto vobs = options.skip_vobs ? nullptr : section(CookedWorldSection::VOB_TREE); vobs != nullptr) {
+			ZKTRACE("World.VobTree");
+			auto ar = ReadArchive::from(vobs.get());
+
+			if (options.arena == nullptr && options.memory != nullptr) {
+				ar->set_arena(ObjectArena::create(1024 * 1024, options.memory));
+			} else {
+				ar->set_arena(options.arena);
+			}
+
+			ar->set_class_filter(options.vob_classes);
+
+			auto count = ar->read_int(); // childs0
+			for (auto i = 0; i < count; ++i) {
+				parse_vob_tree(*ar, version, this->world_vobs);
+			}
+		}
+
+		if (auto way_net = options.skip_way_net ? nullptr : section(CookedWorldSection::WAY_NET); way_net != nullptr) {
+			ZKTRACE("World.WayNet");
+
+#ifndef ZK_FUTURE
+			this->world_way_net.waypoints.resize(way_net->read_uint());
+			for (auto& wp : this->world_way_net.waypoints) {
+				detail::read_cooked(way_net.get(), wp.name);
+				wp.water_depth = way_net->read_int();
+				wp.under_water = way_net->read_ubyte() != 0;
+				wp.position = way_net->read_vec3();
+				wp.direction = way_net->read_vec3();
+				wp.free_point = way_net->read_ubyte() != 0;
+			}
+
+			detail::read_cooked(way_net.get(), this->world_way_net.edges);
+#else
+			auto ar = ReadArchive::from(way_net.get());
+			this->way_net = ar->read_object<WayNet>(version);
+#endif
+		}
+
+		if (assets != nullptr) {
+			if (auto pack = section(CookedWorldSection::ASSETS); pack != nullptr) {
+				assets->mount_disk(pack.get());
+			}
+		}
+
+#ifdef _ZK_WITH_THREADS
+		parallel_tasks.wait();
+#endif
+
+		if (options.materials != nullptr && !options.skip_mesh) {
+			this->world_mesh.intern_materials(*options.materials);
+		}
+	}
+
 	uint16_t World::get_version_identifier(GameVersion) const {
 		return 64513;
 	}
 
+	BoundingBoxSet World::build_vob_bounds(std::vector<VirtualObject*>& vobs) const {
+		vobs.clear();
+
+		std::vector<VirtualObject*> stack;
+		for (auto it = this->world_vobs.rbegin(); it != this->world_vobs.rend(); ++it) {
+			if (*it != nullptr) stack.push_back(it->get());
+		}
+
+		BoundingBoxSet set;
+		while (!stack.empty()) {
+			auto* vob = stack.back();
+			stack.pop_back();
+
+			vobs.push_back(vob);
+			set.add(vob->bbox);
+
+			for (auto it = vob->children.rbegin(); it != vob->children.rend(); ++it) {
+				if (*it != nullptr) stack.push_back(it->get());
+			}
+		}
+
+		return set;
+	}
+
+	void World::build_vob_index() const {
+		std::vector<VirtualObject*> vobs;
+		(void) this->build_vob_bounds(vobs);
+
+		this->_m_vob_names.clear();
+		this->_m_vob_names.reserve(vobs.size());
+		for (auto* vob : vobs) {
+			this->_m_vob_names.emplace_back(ihash(vob->vob_name), vob);
+		}
+
+		std::stable_sort(this->_m_vob_names.begin(), this->_m_vob_names.end(), [](auto const& a, auto const& b) {
+			return a.first < b.first;
+		});
+		this->_m_vob_names_valid = true;
+	}
+
+	VirtualObject* World::find_vob(std::string_view name) const {
+		if (!this->_m_vob_names_valid) this->build_vob_index();
+
+		auto hash = ihash(name);
+		auto it = std::lower_bound(this->_m_vob_names.begin(),
+		                           this->_m_vob_names.end(),
+		                           hash,
+		                           [](auto const& entry, std::uint64_t h) { return entry.first < h; });
+
+		for (; it != this->_m_vob_names.end() && it->first == hash; ++it) {
+			if (iequals(it->second->vob_name, name)) return it->second;
+		}
+
+		return nullptr;
+	}
+
+	void World::find_vobs(std::string_view name, std::vector<VirtualObject*>& vobs) const {
+		vobs.clear();
+		if (!this->_m_vob_names_valid) this->build_vob_index();
+
+		auto hash = ihash(name);
+		auto it = std::lower_bound(this->_m_vob_names.begin(),
+		                           this->_m_vob_names.end(),
+		                           hash,
+		                           [](auto const& entry, std::uint64_t h) { return entry.first < h; });
+
+		for (; it != this->_m_vob_names.end() && it->first == hash; ++it) {
+			if (iequals(it->second->vob_name, name)) vobs.push_back(it->second);
+		}
+	}
+
+	std::optional<std::uint32_t> World::find_waypoint(std::string_view name) const {
+#ifndef ZK_FUTURE
+		auto const& waypoints = this->world_way_net.waypoints;
+		auto name_of = [&waypoints](std::uint32_t i) -> std::string const& { return waypoints[i].name; };
+#else
+		static std::vector<std::shared_ptr<WayPoint>> const none {};
+		auto const& waypoints = this->way_net != nullptr ? this->way_net->points : none;
+		auto name_of = [&waypoints](std::uint32_t i) -> std::string const& { return waypoints[i]->name; };
+#endif
+
+		if (!this->_m_waypoint_names_valid) {
+			this->_m_waypoint_names.clear();
+			this->_m_waypoint_names.reserve(waypoints.size());
+			for (auto i = 0u; i < waypoints.size(); ++i) {
+				this->_m_waypoint_names.emplace_back(ihash(name_of(i)), i);
+			}
+
+			std::sort(this->_m_waypoint_names.begin(), this->_m_waypoint_names.end());
+			this->_m_waypoint_names_valid = true;
+		}
+
+		auto hash = ihash(name);
+		auto it = std::lower_bound(this->_m_waypoint_names.begin(),
+		                           this->_m_waypoint_names.end(),
+		                           std::pair<std::uint64_t, std::uint32_t> {hash, 0});
+
+		for (; it != this->_m_waypoint_names.end() && it->first == hash; ++it) {
+			if (it->second < waypoints.size() && iequals(name_of(it->second), name)) return it->second;
+		}
+
+		return std::nullopt;
+	}
+
+	void World::invalidate_vob_index() noexcept {
+		this->_m_vob_names.clear();
+		this->_m_vob_names_valid = false;
+	}
+
+	void World::invalidate_waypoint_index() noexcept {
+		this->_m_waypoint_names.clear();
+		this->_m_waypoint_names_valid = false;
+	}
+
 	void CutscenePlayer::load(ReadArchive& r, GameVersion version) {
 		this->last_process_day = r.read_int();  // lastProcessDay
 		this->last_process_hour = r.read_int(); // lastProcessHour
@@ -2,6 +2,23 @@
 // SPDX-License-Identifier: MIT
 #include "zenkit/addon/texcvt.hh"
 #include "zenkit/Stream.hh"
+#include "zenkit/Vfs.hh"
+
+#include "../Internal.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+
+#ifdef _ZK_WITH_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 #define MAKEFOURCC(ch0, ch1, ch2, ch3)                                                                                 \
 	((uint32_t) (uint8_t) (ch0) | ((uint32_t) (uint8_t) (ch1) << 8) | ((uint32_t) (uint8_t) (ch2) << 16) |             \
@@ -9,6 +26,11 @@
 
 namespace zenkit {
 	extern std::uint32_t _ztex_mipmap_size(TextureFormat, std::uint32_t, std::uint32_t, uint32_t);
+	extern void _ztex_for_each_block_row(std::uint32_t,
+	                                     std::uint32_t,
+	                                     std::uint32_t,
+	                                     std::size_t,
+	                                     std::function<void(std::size_t, std::size_t)> const&);
 
 	enum {
 		DDSD_CAPS = 0x00000001l,
@@ -226,7 +248,7 @@ namespace zenkit {
 
 	static void write_dds_data(Write* w, Texture const& tex) {
 		for (uint32_t level = 0; level < tex.mipmaps(); ++level) {
-			auto& data = tex.data(level);
+			auto data = tex.data_view(level);
 			w->write(data.data(), data.size());
 		}
 	}
@@ -245,4 +267,462 @@ namespace zenkit {
 		write_dds_data(w.get(), tex);
 		return buf;
 	}
+
+	static constexpr std::uint8_t KTX2_IDENTIFIER[12] =
+	    {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+	enum : std::uint32_t {
+		VK_FORMAT_R8G8B8A8_UNORM = 37,
+		VK_FORMAT_B8G8R8A8_UNORM = 44,
+		VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
+		VK_FORMAT_BC2_UNORM_BLOCK = 135,
+		VK_FORMAT_BC3_UNORM_BLOCK = 137,
+		VK_FORMAT_BC7_UNORM_BLOCK = 145,
+	};
+
+	enum : std::uint8_t {
+		KHR_DF_MODEL_RGBSDA = 1,
+		KHR_DF_MODEL_BC1A = 128,
+		KHR_DF_MODEL_BC2 = 129,
+		KHR_DF_MODEL_BC3 = 130,
+		KHR_DF_MODEL_BC7 = 134,
+		KHR_DF_PRIMARIES_BT709 = 1,
+		KHR_DF_TRANSFER_LINEAR = 1,
+		KHR_DF_FLAG_ALPHA_PREMULTIPLIED = 1,
+		KHR_DF_CHANNEL_RED = 0,
+		KHR_DF_CHANNEL_GREEN = 1,
+		KHR_DF_CHANNEL_BLUE = 2,
+		KHR_DF_CHANNEL_COLOR = 0,
+		KHR_DF_CHANNEL_BC1A_ALPHAPRESENT = 1,
+		KHR_DF_CHANNEL_ALPHA = 15,
+	};
+
+	/// \brief The minimum number of blocks each thread transcodes to BC7.
+	static constexpr std::size_t BC7_BLOCKS_PER_THREAD = 1024;
+
+	struct Ktx2Sample {
+		std::uint16_t bit_offset;
+		std::uint8_t bit_length;
+		std::uint8_t channel;
+		std::uint32_t upper;
+	};
+
+	struct Ktx2Layout {
+		std::uint32_t vk_format;
+		std::uint8_t color_model;
+		std::uint8_t block_size; // 1 for uncompressed formats, 4 for block-compressed ones.
+		std::uint8_t bytes_per_block;
+		std::vector<Ktx2Sample> samples;
+	};
+
+	static Ktx2Layout ktx2_layout(std::uint32_t vk_format) {
+		switch (vk_format) {
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			return {vk_format, KHR_DF_MODEL_BC1A, 4, 8, {{0, 63, KHR_DF_CHANNEL_BC1A_ALPHAPRESENT, 0xFFFFFFFF}}};
+		case VK_FORMAT_BC2_UNORM_BLOCK:
+			return {vk_format,
+			        KHR_DF_MODEL_BC2,
+			        4,
+			        16,
+			        {{0, 63, KHR_DF_CHANNEL_ALPHA, 0xFFFFFFFF}, {64, 63, KHR_DF_CHANNEL_COLOR, 0xFFFFFFFF}}};
+		case VK_FORMAT_BC3_UNORM_BLOCK:
+			return {vk_format,
+			        KHR_DF_MODEL_BC3,
+			        4,
+			        16,
+			        {{0, 63, KHR_DF_CHANNEL_ALPHA, 0xFFFFFFFF}, {64, 63, KHR_DF_CHANNEL_COLOR, 0xFFFFFFFF}}};
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+			return {vk_format, KHR_DF_MODEL_BC7, 4, 16, {{0, 127, KHR_DF_CHANNEL_COLOR, 0xFFFFFFFF}}};
+		case VK_FORMAT_B8G8R8A8_UNORM:
+			return {vk_format,
+			        KHR_DF_MODEL_RGBSDA,
+			        1,
+			        4,
+			        {{0, 7, KHR_DF_CHANNEL_BLUE, 0xFF},
+			         {8, 7, KHR_DF_CHANNEL_GREEN, 0xFF},
+			         {16, 7, KHR_DF_CHANNEL_RED, 0xFF},
+			         {24, 7, KHR_DF_CHANNEL_ALPHA, 0xFF}}};
+		default:
+			return {VK_FORMAT_R8G8B8A8_UNORM,
+			        KHR_DF_MODEL_RGBSDA,
+			        1,
+			        4,
+			        {{0, 7, KHR_DF_CHANNEL_RED, 0xFF},
+			         {8, 7, KHR_DF_CHANNEL_GREEN, 0xFF},
+			         {16, 7, KHR_DF_CHANNEL_BLUE, 0xFF},
+			         {24, 7, KHR_DF_CHANNEL_ALPHA, 0xFF}}};
+		}
+	}
+
+	/// \brief Appends the \p count lowest bits of \p value to a BC7 block, starting at bit \p offset.
+	static void bc7_put_bits(std::uint8_t* block, std::uint32_t& offset, std::uint32_t value, std::uint32_t count) {
+		for (auto i = 0u; i < count; ++i, ++offset) {
+			block[offset / 8] |= static_cast<std::uint8_t>((value >> i & 1) << (offset % 8));
+		}
+	}
+
+	/// \brief Encodes 16 RGBA8 pixels into a BC7 block using mode 6, which stores two RGBA endpoints with 7 bits
+	///        per channel and a shared low bit, and 16 interpolation steps between them.
+	static void bc7_encode_block(std::uint8_t* block, std::uint8_t const* pixels) {
+		static constexpr int WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+		// Use the two pixels farthest apart as the endpoints. DXT blocks only contain colors on the line between
+		// their two endpoints, so this recovers them.
+		auto distance = [&](int a, int b) {
+			auto d = 0;
+			for (auto c = 0; c < 4; ++c) {
+				auto v = pixels[a * 4 + c] - pixels[b * 4 + c];
+				d += v * v;
+			}
+			return d;
+		};
+
+		int e0 = 0, e1 = 0, farthest = -1;
+		for (auto a = 0; a < 16; ++a) {
+			for (auto b = a + 1; b < 16; ++b) {
+				auto d = distance(a, b);
+				if (d > farthest) {
+					farthest = d;
+					e0 = a;
+					e1 = b;
+				}
+			}
+		}
+
+		// Quantize the endpoints, choosing the shared low bit which loses the least precision.
+		int endpoints[2][4];
+		std::uint32_t pbits[2];
+		for (auto e = 0; e < 2; ++e) {
+			auto const* px = pixels + (e == 0 ? e0 : e1) * 4;
+			auto best = -1;
+
+			for (auto p = 0; p < 2; ++p) {
+				int quantized[4], error = 0;
+				for (auto c = 0; c < 4; ++c) {
+					quantized[c] = std::clamp((px[c] - p + 1) / 2, 0, 127) << 1 | p;
+					error += std::abs(quantized[c] - px[c]);
+				}
+
+				if (best < 0 || error < best) {
+					best = error;
+					pbits[e] = static_cast<std::uint32_t>(p);
+					std::copy(std::begin(quantized), std::end(quantized), endpoints[e]);
+				}
+			}
+		}
+
+		// Choose the interpolation step closest to each pixel.
+		std::uint32_t indices[16];
+		for (auto i = 0; i < 16; ++i) {
+			auto best = -1;
+			for (auto s = 0u; s < 16; ++s) {
+				auto error = 0;
+				for (auto c = 0; c < 4; ++c) {
+					auto v = ((64 - WEIGHTS[s]) * endpoints[0][c] + WEIGHTS[s] * endpoints[1][c] + 32) >> 6;
+					error += (v - pixels[i * 4 + c]) * (v - pixels[i * 4 + c]);
+				}
+
+				if (best < 0 || error < best) {
+					best = error;
+					indices[i] = s;
+				}
+			}
+		}
+
+		// The highest bit of the first index is implied to be zero. Swap the endpoints to make it so.
+		if (indices[0] >= 8) {
+			std::swap(endpoints[0], endpoints[1]);
+			std::swap(pbits[0], pbits[1]);
+			for (auto& index : indices) {
+				index = 15 - index;
+			}
+		}
+
+		std::memset(block, 0, 16);
+		std::uint32_t offset = 0;
+		bc7_put_bits(block, offset, 1 << 6, 7);
+
+		for (auto c = 0; c < 4; ++c) {
+			bc7_put_bits(block, offset, static_cast<std::uint32_t>(endpoints[0][c] >> 1), 7);
+			bc7_put_bits(block, offset, static_cast<std::uint32_t>(endpoints[1][c] >> 1), 7);
+		}
+
+		bc7_put_bits(block, offset, pbits[0], 1);
+		bc7_put_bits(block, offset, pbits[1], 1);
+		bc7_put_bits(block, offset, indices[0], 3);
+
+		for (auto i = 1; i < 16; ++i) {
+			bc7_put_bits(block, offset, indices[i], 4);
+		}
+	}
+
+	static std::vector<std::uint8_t> bc7_encode(std::vector<std::uint8_t> const& rgba,
+	                                            std::uint32_t width,
+	                                            std::uint32_t height,
+	                                            std::uint32_t threads) {
+		std::size_t blocks_per_row = (width + 3) / 4;
+		std::vector<std::uint8_t> blocks(blocks_per_row * ((height + 3) / 4) * 16);
+
+		auto encode = [&](std::size_t begin, std::size_t end) {
+			std::uint8_t pixels[64];
+
+			for (auto row = begin; row < end; ++row) {
+				for (std::size_t column = 0; column < blocks_per_row; ++column) {
+					// Blocks hanging over the edge of the image repeat its last row and column.
+					for (auto i = 0u; i < 16; ++i) {
+						auto x = std::min<std::size_t>(column * 4 + i % 4, width - 1);
+						auto y = std::min<std::size_t>(row * 4 + i / 4, height - 1);
+						std::memcpy(pixels + i * 4, rgba.data() + (y * width + x) * 4, 4);
+					}
+
+					bc7_encode_block(blocks.data() + (row * blocks_per_row + column) * 16, pixels);
+				}
+			}
+		};
+
+		_ztex_for_each_block_row(width, height, threads, BC7_BLOCKS_PER_THREAD, encode);
+
+		return blocks;
+	}
+
+	static void write_ktx2_dfd(Write* w, Ktx2Layout const& layout, bool premultiplied) {
+		auto block_size = static_cast<std::uint32_t>(24 + 16 * layout.samples.size());
+		w->write_uint(4 + block_size);
+		w->write_uint(0); // vendorId = KHRONOS, descriptorType = BASICFORMAT
+		w->write_uint(2 | block_size << 16);
+		w->write_ubyte(layout.color_model);
+		w->write_ubyte(KHR_DF_PRIMARIES_BT709);
+		w->write_ubyte(KHR_DF_TRANSFER_LINEAR);
+		w->write_ubyte(premultiplied ? KHR_DF_FLAG_ALPHA_PREMULTIPLIED : 0);
+
+		for (auto i = 0; i < 4; ++i) {
+			w->write_ubyte(i < 2 ? layout.block_size - 1 : 0);
+		}
+
+		for (auto i = 0; i < 8; ++i) {
+			w->write_ubyte(i == 0 ? layout.bytes_per_block : 0);
+		}
+
+		for (auto& sample : layout.samples) {
+			w->write_ushort(sample.bit_offset);
+			w->write_ubyte(sample.bit_length);
+			w->write_ubyte(sample.channel);
+			w->write_uint(0); // samplePosition
+			w->write_uint(0); // sampleLower
+			w->write_uint(sample.upper);
+		}
+	}
+
+	std::vector<std::byte> to_ktx2(Texture const& tex, Ktx2Format format, std::uint32_t thread_count) {
+		std::uint32_t vk_format = VK_FORMAT_R8G8B8A8_UNORM;
+		if (format == Ktx2Format::BC7) {
+			vk_format = VK_FORMAT_BC7_UNORM_BLOCK;
+		} else if (format == Ktx2Format::NATIVE) {
+			switch (tex.format()) {
+			case TextureFormat::DXT1:
+				vk_format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+				break;
+			case TextureFormat::DXT2:
+			case TextureFormat::DXT3:
+				vk_format = VK_FORMAT_BC2_UNORM_BLOCK;
+				break;
+			case TextureFormat::DXT4:
+			case TextureFormat::DXT5:
+				vk_format = VK_FORMAT_BC3_UNORM_BLOCK;
+				break;
+			case TextureFormat::B8G8R8A8:
+				vk_format = VK_FORMAT_B8G8R8A8_UNORM;
+				break;
+			default:
+				break;
+			}
+		}
+
+		auto native = vk_format != VK_FORMAT_R8G8B8A8_UNORM && vk_format != VK_FORMAT_BC7_UNORM_BLOCK;
+		native = native || (vk_format == VK_FORMAT_R8G8B8A8_UNORM && tex.format() == TextureFormat::R8G8B8A8);
+
+		// Level 0 is the largest mipmap.
+		std::vector<std::vector<std::uint8_t>> levels;
+		for (auto level = 0u; level < tex.mipmaps(); ++level) {
+			if (native) {
+				auto data = tex.data_view(level);
+				auto const* bytes = reinterpret_cast<std::uint8_t const*>(data.data());
+				levels.emplace_back(bytes, bytes + data.size());
+			} else if (vk_format == VK_FORMAT_BC7_UNORM_BLOCK) {
+				auto width = tex.mipmap_width(level), height = tex.mipmap_height(level);
+				levels.push_back(bc7_encode(tex.as_rgba8(level), width, height, thread_count));
+			} else {
+				levels.push_back(tex.as_rgba8(level));
+			}
+		}
+
+		auto layout = ktx2_layout(vk_format);
+		auto premultiplied = native && (tex.format() == TextureFormat::DXT2 || tex.format() == TextureFormat::DXT4);
+
+		std::vector<std::byte> buf {};
+		auto w = Write::to(&buf);
+
+		auto level_count = static_cast<std::uint32_t>(levels.size());
+		auto dfd_offset = 80 + level_count * 24;
+		auto dfd_length = static_cast<std::uint32_t>(4 + 24 + 16 * layout.samples.size());
+
+		w->write(KTX2_IDENTIFIER, sizeof KTX2_IDENTIFIER);
+		w->write_uint(vk_format);
+		w->write_uint(1); // typeSize
+		w->write_uint(tex.width());
+		w->write_uint(tex.height());
+		w->write_uint(0); // pixelDepth
+		w->write_uint(0); // layerCount
+		w->write_uint(1); // faceCount
+		w->write_uint(level_count);
+		w->write_uint(0); // supercompressionScheme
+
+		w->write_uint(dfd_offset);
+		w->write_uint(dfd_length);
+		w->write_uint(0); // kvdByteOffset
+		w->write_uint(0); // kvdByteLength
+		w->write_uint(0); // sgdByteOffset
+		w->write_uint(0);
+		w->write_uint(0); // sgdByteLength
+		w->write_uint(0);
+
+		// Mipmaps are stored smallest first, each aligned to the size of a block (or 4 bytes, whichever is larger).
+		std::uint64_t alignment = std::max<std::uint64_t>(4, layout.bytes_per_block);
+		std::vector<std::uint64_t> offsets(level_count);
+		std::uint64_t offset = dfd_offset + dfd_length;
+		for (auto level = level_count; level-- > 0;) {
+			offset = (offset + alignment - 1) / alignment * alignment;
+			offsets[level] = offset;
+			offset += levels[level].size();
+		}
+
+		for (auto level = 0u; level < level_count; ++level) {
+			std::uint64_t length = levels[level].size();
+			for (auto value : {offsets[level], length, length}) {
+				w->write_uint(static_cast<std::uint32_t>(value));
+				w->write_uint(static_cast<std::uint32_t>(value >> 32));
+			}
+		}
+
+		write_ktx2_dfd(w.get(), layout, premultiplied);
+
+		for (auto level = level_count; level-- > 0;) {
+			while (w->tell() < offsets[level]) {
+				w->write_ubyte(0);
+			}
+
+			w->write(levels[level].data(), levels[level].size());
+		}
+
+		return buf;
+	}
+
+	std::size_t convert_all(Vfs const& vfs,
+	                        std::string_view pattern,
+	                        TextureEncoder const& encoder,
+	                        TextureSink const& sink,
+	                        std::uint32_t thread_count) {
+		std::vector<std::pair<std::string, VfsNode const*>> files;
+		vfs.enumerate(pattern, [&files](std::string_view path, VfsNode const& node) {
+			if (node.type() == VfsNodeType::FILE) files.emplace_back(path, &node);
+			return true;
+		});
+
+		auto convert = [&](std::size_t i) -> std::optional<std::vector<std::byte>> {
+			try {
+				// The file stays mapped by the Vfs, so the mipmaps don't need to be copied.
+				auto r = files[i].second->open_read();
+				Texture tex {};
+				tex.load(r.get(), {true});
+				return encoder(tex);
+			} catch (std::exception const& e) {
+				ZKLOGE("Texture", "Failed to convert %s: %s", files[i].first.c_str(), e.what());
+				return std::nullopt;
+			}
+		};
+
+		std::size_t converted = 0;
+
+#ifndef _ZK_WITH_THREADS
+		// Threads are only available in browser builds with pthreads support.
+		(void) thread_count;
+		for (std::size_t i = 0; i < files.size(); ++i) {
+			if (auto data = convert(i)) {
+				sink(files[i].first, *data);
+				++converted;
+			}
+		}
+#else
+		if (thread_count == 0) thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+		auto max_waiting = std::size_t {thread_count} * 2;
+
+		std::mutex lock;
+		std::condition_variable ready;
+		std::condition_variable consumed;
+		std::deque<std::pair<std::size_t, std::optional<std::vector<std::byte>>>> done;
+		std::size_t next = 0;
+
+		auto worker = [&]() {
+			for (;;) {
+				std::size_t i;
+				{
+					std::unique_lock guard {lock};
+					consumed.wait(guard, [&] { return done.size() < max_waiting || next >= files.size(); });
+					if (next >= files.size()) return;
+					i = next++;
+				}
+
+				auto data = convert(i);
+
+				{
+					std::lock_guard guard {lock};
+					done.emplace_back(i, std::move(data));
+				}
+				ready.notify_one();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (std::size_t i = 0; i < std::min<std::size_t>(thread_count, files.size()); ++i) {
+			workers.emplace_back(worker);
+		}
+
+		auto join = [&workers]() {
+			for (auto& t : workers) {
+				t.join();
+			}
+		};
+
+		try {
+			for (std::size_t remaining = files.size(); remaining > 0; --remaining) {
+				std::unique_lock guard {lock};
+				ready.wait(guard, [&done] { return !done.empty(); });
+
+				auto item = std::move(done.front());
+				done.pop_front();
+				guard.unlock();
+				consumed.notify_one();
+
+				if (item.second) {
+					sink(files[item.first].first, *item.second);
+					++converted;
+				}
+			}
+		} catch (...) {
+			// Stop handing out new textures and wait for the ones in flight before propagating.
+			{
+				std::lock_guard guard {lock};
+				next = files.size();
+			}
+
+			consumed.notify_all();
+			join();
+			throw;
+		}
+
+		join();
+#endif
+
+		return converted;
+	}
 } // namespace zenkit
@@ -6,14 +6,93 @@
 #include "../Internal.hh"
 
 #include <array>
+#include <cctype>
 #include <charconv>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <sstream>
 #include <stdexcept>
 #include <utility>
 
 namespace zenkit {
+	static void ascii_skip_space(std::string_view& in) noexcept {
+		while (!in.empty() && std::isspace(static_cast<unsigned char>(in.front()))) {
+			in.remove_prefix(1);
+		}
+	}
+
+	static std::string_view ascii_next_token(std::string_view& in) noexcept {
+		ascii_skip_space(in);
+
+		size_t len = 0;
+		while (len < in.size() && !std::isspace(static_cast<unsigned char>(in[len]))) {
+			++len;
+		}
+
+		auto token = in.substr(0, len);
+		in.remove_prefix(len);
+		return token;
+	}
+
+	/// \brief Parses the next whitespace-separated integer from \p in and advances past it.
+	/// \return `false` if \p in does not start with a number.
+	/// \throws ParserError if the number does not fit into \p T.
+	template <typename T>
+	static bool ascii_parse_int(std::string_view& in, T& out) {
+		ascii_skip_space(in);
+		if (!in.empty() && in.front() == '+') in.remove_prefix(1);
+
+		auto [ptr, ec] = std::from_chars(in.data(), in.data() + in.size(), out);
+		if (ec == std::errc::result_out_of_range) {
+			throw ParserError {"ReadArchive.Ascii", "integer out of range: " + std::string {in}};
+		}
+		if (ec != std::errc {}) return false;
+
+		in.remove_prefix(static_cast<size_t>(ptr - in.data()));
+		return true;
+	}
+
+	/// \brief Parses the next whitespace-separated float from \p in and advances past it.
+	/// \return `false` if \p in does not start with a number.
+	static bool ascii_parse_float(std::string_view& in, float& out) {
+		ascii_skip_space(in);
+		if (!in.empty() && in.front() == '+') in.remove_prefix(1);
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		auto [ptr, ec] = std::from_chars(in.data(), in.data() + in.size(), out);
+		if (ec == std::errc::invalid_argument) return false;
+
+		in.remove_prefix(static_cast<size_t>(ptr - in.data()));
+		return true;
+#else
+		// Some standard libraries only implement integral std::from_chars. Copy the token into a small
+		// buffer to get the required NUL-terminator for strtof instead of allocating a std::string.
+		char buf[64];
+		size_t len = 0;
+		while (len < in.size() && len < sizeof buf - 1 && !std::isspace(static_cast<unsigned char>(in[len]))) {
+			buf[len] = in[len];
+			++len;
+		}
+		buf[len] = '\0';
+
+		char* end = nullptr;
+		out = std::strtof(buf, &end);
+		if (end == buf) return false;
+
+		in.remove_prefix(static_cast<size_t>(end - buf));
+		return true;
+#endif
+	}
+
+	template <typename T>
+	static T ascii_read_int(std::string_view in) {
+		T v {};
+		if (!ascii_parse_int(in, v)) {
+			throw ParserError {"ReadArchive.Ascii", "reading int: not a number: " + std::string {in}};
+		}
+		return v;
+	}
+
 	void ReadArchiveAscii::read_header() {
 		{
 			std::string objects = read->read_line(true);
@@ -21,11 +100,7 @@ namespace zenkit {
 				throw ParserError {"ReadArchive.Ascii", "objects field missing"};
 			}
 
-			try {
-				_m_objects = std::stoi(objects.substr(objects.find(' ') + 1));
-			} catch (std::invalid_argument const& e) {
-				throw ParserError {"ReadArchive.Ascii", e, "reading int"};
-			}
+			_m_objects = ascii_read_int<std::int32_t>(std::string_view {objects}.substr(objects.find(' ') + 1));
 		}
 
 		if (read->read_line(true) != "END") {
@@ -37,21 +112,21 @@ namespace zenkit {
 		if (read->eof()) return false;
 
 		auto mark = read->tell();
-		auto line = read->read_line(true);
+		auto view = read->read_line_view(true, _m_line);
 
 		// Fail quickly if we know this can't be an object begin
-		if (line.length() <= 2) {
+		if (view.length() <= 2 || view.front() != '[') {
 			read->seek(static_cast<ssize_t>(mark), Whence::BEG);
 			return false;
 		}
 
-		char class_name[128];
-		char object_name[128];
-
-		auto parsed_elements =
-		    std::sscanf(line.c_str(), "[%127s %127s %hu %u]", object_name, class_name, &obj.version, &obj.index);
+		// Format: [<object name> <class name> <version> <index>]
+		view.remove_prefix(1);
+		auto object_name = ascii_next_token(view);
+		auto class_name = ascii_next_token(view);
 
-		if (parsed_elements != 4) {
+		if (object_name.empty() || class_name.empty() || !ascii_parse_int(view, obj.version) ||
+		    !ascii_parse_int(view, obj.index)) {
 			read->seek(static_cast<ssize_t>(mark), Whence::BEG);
 			return false;
 		}
@@ -66,10 +141,9 @@ namespace zenkit {
 		if (read->eof()) return false;
 
 		auto mark = read->tell();
-		auto line = read->read_line(true);
+		auto view = read->read_line_view(true, _m_line);
 
 		// Compatibility fix for binary data in ASCII archives.
-		std::string_view view = line;
 		size_t spaces_count = 0;
 		for (; spaces_count < view.size() && std::isspace(static_cast<unsigned char>(view[spaces_count]));
 		     ++spaces_count)
@@ -87,76 +161,63 @@ namespace zenkit {
 		return true;
 	}
 
-	std::string ReadArchiveAscii::read_entry(std::string_view type) {
-		auto line = read->read_line(true);
+	std::string_view ReadArchiveAscii::read_entry(std::string_view type) {
+		auto line = read->read_line_view(true, _m_line);
 		line = line.substr(line.find('=') + 1);
 		auto colon = line.find(':');
 
 		if (line.substr(0, colon) != type) {
 			throw ParserError {"ReadArchive.Ascii",
-			                   "type mismatch: expected " + std::string {type} + ", got: " + line.substr(0, colon)};
+			                   "type mismatch: expected " + std::string {type} + ", got: " +
+			                       std::string {line.substr(0, colon)}};
 		}
 
 		return line.substr(colon + 1);
 	}
 
 	std::string ReadArchiveAscii::read_string() {
-		return read_entry("string");
+		return std::string {read_entry("string")};
 	}
 
 	std::int32_t ReadArchiveAscii::read_int() {
-		try {
-			return std::stoi(read_entry("int"));
-		} catch (std::invalid_argument const& e) {
-			throw ParserError {"ReadArchive.Ascii", e, "reading int"};
-		}
+		return ascii_read_int<std::int32_t>(read_entry("int"));
 	}
 
 	float ReadArchiveAscii::read_float() {
-		try {
-			return std::stof(read_entry("float"));
-		} catch (std::invalid_argument const& e) {
-			throw ParserError {"ReadArchive.Ascii", e, "reading int"};
+		auto in = read_entry("float");
+		float v = 0;
+
+		if (!ascii_parse_float(in, v)) {
+			throw ParserError {"ReadArchive.Ascii", "reading float: not a number: " + std::string {in}};
 		}
+
+		return v;
 	}
 
+	// These were previously parsed using `std::stoul` and truncated, so negative and oversized
+	// values wrap around instead of failing. Parse as a 64-bit signed integer to keep that behaviour.
 	std::uint8_t ReadArchiveAscii::read_byte() {
-		try {
-			return std::stoul(read_entry("int")) & 0xFF;
-		} catch (std::invalid_argument const& e) {
-			throw ParserError {"ReadArchive.Ascii", e, "reading int"};
-		}
+		return static_cast<std::uint8_t>(ascii_read_int<std::int64_t>(read_entry("int")) & 0xFF);
 	}
 
 	std::uint16_t ReadArchiveAscii::read_word() {
-		try {
-			return std::stoul(read_entry("int")) & 0xFF'FF;
-		} catch (std::invalid_argument const& e) {
-			throw ParserError {"ReadArchive.Ascii", e, "reading int"};
-		}
+		return static_cast<std::uint16_t>(ascii_read_int<std::int64_t>(read_entry("int")) & 0xFF'FF);
 	}
 
 	std::uint32_t ReadArchiveAscii::read_enum() {
-		try {
-			return std::stoul(read_entry("enum")) & 0xFFFF'FFFF;
-		} catch (std::invalid_argument const& e) {
-			throw ParserError {"ReadArchive.Ascii", e, "reading int"};
-		}
+		return static_cast<std::uint32_t>(ascii_read_int<std::int64_t>(read_entry("enum")) & 0xFFFF'FFFF);
 	}
 
 	bool ReadArchiveAscii::read_bool() {
-		try {
-			return std::stoul(read_entry("bool")) != 0;
-		} catch (std::invalid_argument const& e) {
-			throw ParserError {"ReadArchive.Ascii", e, "reading int"};
-		}
+		return ascii_read_int<std::int64_t>(read_entry("bool")) != 0;
 	}
 
+	// Missing or malformed components are left at zero, just like the stream extraction used to do.
 	Color ReadArchiveAscii::read_color() {
-		std::stringstream in {read_entry("color")};
+		auto in = read_entry("color");
 
-		std::uint16_t r, g, b, a;
-		in >> r >> g >> b >> a;
+		std::uint16_t r = 0, g = 0, b = 0, a = 0;
+		(void) (ascii_parse_int(in, r) && ascii_parse_int(in, g) && ascii_parse_int(in, b) && ascii_parse_int(in, a));
 		return Color {static_cast<std::uint8_t>(r),
 		              static_cast<std::uint8_t>(g),
 		              static_cast<std::uint8_t>(b),
@@ -164,30 +225,94 @@ namespace zenkit {
 	}
 
 	Vec3 ReadArchiveAscii::read_vec3() {
-		std::stringstream in {read_entry("vec3")};
+		auto in = read_entry("vec3");
 		Vec3 v {};
 
-		in >> v.x >> v.y >> v.z;
+		(void) (ascii_parse_float(in, v.x) && ascii_parse_float(in, v.y) && ascii_parse_float(in, v.z));
 		return v;
 	}
 
 	Vec2 ReadArchiveAscii::read_vec2() {
-		std::stringstream in {read_entry("rawFloat")};
+		auto in = read_entry("rawFloat");
 		Vec2 v {};
 
-		in >> v.x >> v.y;
+		(void) (ascii_parse_float(in, v.x) && ascii_parse_float(in, v.y));
 		return v;
 	}
 
 	void ReadArchiveAscii::skip_entry() {
-		(void) read->read_line(true);
+		(void) read->read_line_view(true, _m_line);
+	}
+
+	void ReadArchiveAscii::copy_entry(WriteArchive& w) {
+		auto line = read->read_line_view(true, _m_line);
+		auto eq = line.find('=');
+		auto colon = line.find(':', eq);
+
+		if (eq == std::string_view::npos || colon == std::string_view::npos) {
+			throw ParserError {"ReadArchive.Ascii", "invalid entry: " + std::string {line}};
+		}
+
+		auto name = line.substr(0, eq);
+		auto type = line.substr(eq + 1, colon - eq - 1);
+		auto value = line.substr(colon + 1);
+
+		if (type == "string") {
+			w.write_string(name, value);
+		} else if (type == "int") {
+			w.write_int(name, ascii_read_int<std::int32_t>(value));
+		} else if (type == "byte") {
+			w.write_byte(name, static_cast<std::uint8_t>(ascii_read_int<std::int64_t>(value)));
+		} else if (type == "word") {
+			w.write_word(name, static_cast<std::uint16_t>(ascii_read_int<std::int64_t>(value)));
+		} else if (type == "enum") {
+			w.write_enum(name, static_cast<std::uint32_t>(ascii_read_int<std::int64_t>(value)));
+		} else if (type == "bool") {
+			w.write_bool(name, ascii_read_int<std::int64_t>(value) != 0);
+		} else if (type == "float") {
+			float v = 0;
+			if (!ascii_parse_float(value, v)) {
+				throw ParserError {"ReadArchive.Ascii", "reading float: not a number: " + std::string {value}};
+			}
+			w.write_float(name, v);
+		} else if (type == "color") {
+			std::uint16_t r = 0, g = 0, b = 0, a = 0;
+			(void) (ascii_parse_int(value, r) && ascii_parse_int(value, g) && ascii_parse_int(value, b) &&
+			        ascii_parse_int(value, a));
+			w.write_color(name,
+			              Color {static_cast<std::uint8_t>(r),
+			                     static_cast<std::uint8_t>(g),
+			                     static_cast<std::uint8_t>(b),
+			                     static_cast<std::uint8_t>(a)});
+		} else if (type == "vec3") {
+			Vec3 v {};
+			(void) (ascii_parse_float(value, v.x) && ascii_parse_float(value, v.y) && ascii_parse_float(value, v.z));
+			w.write_vec3(name, v);
+		} else if (type == "rawFloat") {
+			std::vector<float> floats;
+			for (float v = 0; ascii_parse_float(value, v);) {
+				floats.push_back(v);
+			}
+			w.write_raw_float(name, floats.data(), static_cast<std::uint16_t>(floats.size()));
+		} else if (type == "raw") {
+			std::vector<std::byte> bytes(value.length() / 2);
+			for (size_t i = 0; i < bytes.size(); ++i) {
+				auto* it = value.data() + i * 2;
+				std::from_chars(it, it + 2, reinterpret_cast<std::uint8_t&>(bytes[i]), 16);
+			}
+			w.write_raw(name, bytes);
+		} else {
+			throw ParserError {"ReadArchive.Ascii", "unknown entry type: " + std::string {type}};
+		}
 	}
 
 	AxisAlignedBoundingBox ReadArchiveAscii::read_bbox() {
-		std::stringstream in {read_entry("rawFloat")};
+		auto in = read_entry("rawFloat");
 		AxisAlignedBoundingBox box {};
 
-		in >> box.min.x >> box.min.y >> box.min.z >> box.max.x >> box.max.y >> box.max.z;
+		(void) (ascii_parse_float(in, box.min.x) && ascii_parse_float(in, box.min.y) &&
+		        ascii_parse_float(in, box.min.z) && ascii_parse_float(in, box.max.x) &&
+		        ascii_parse_float(in, box.max.y) && ascii_parse_float(in, box.max.z));
 		return box;
 	}
 
@@ -371,16 +496,17 @@ namespace zenkit {
 		this->_m_write->write_string(name);
 		this->_m_write->write_string("=raw:");
 
-		std::array<char, 3> buf {};
-		buf[2] = '\0';
+		std::array<char, 2> buf {};
 		for (auto i = 0u; i < length; ++i) {
-			std::to_chars(buf.data(), buf.data() + buf.size(), static_cast<unsigned char>(v[i]), 16);
+			// std::to_chars does not terminate its output, so the length has to be taken from the returned pointer.
+			auto res = std::to_chars(buf.data(), buf.data() + buf.size(), static_cast<unsigned char>(v[i]), 16);
 
-			if (buf[1] == '\0') {
+			if (res.ptr == buf.data() + 1) {
 				this->_m_write->write_char('0');
 				this->_m_write->write_char(buf[0]);
 			} else {
-				this->_m_write->write_string(buf.data());
+				this->_m_write->write_char(buf[0]);
+				this->_m_write->write_char(buf[1]);
 			}
 		}
 
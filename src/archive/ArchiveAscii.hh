@@ -32,11 +32,13 @@ namespace zenkit {
 	protected:
 		void read_header() override;
 		void skip_entry() override;
+		void copy_entry(WriteArchive& w) override;
 
-		std::string read_entry(std::string_view type);
+		std::string_view read_entry(std::string_view type);
 
 	private:
 		int32_t _m_objects {0};
+		std::string _m_line; // Storage for lines read from streams which are not memory-backed.
 	};
 
 	class WriteArchiveAscii final : public WriteArchive {
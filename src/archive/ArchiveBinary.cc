@@ -105,9 +105,16 @@ namespace zenkit {
 	}
 
 	std::unique_ptr<Read> ReadArchiveBinary::read_raw(std::size_t size) {
-		std::vector bytes(size, std::byte {});
-		read->read(bytes.data(), bytes.size());
-		return Read::from(std::move(bytes));
+		return read->slice(size);
+	}
+
+	bool ReadArchiveBinary::read_packed(std::byte* buf, std::size_t size) {
+		// Entries in binary archives are stored without names or types, so a run of them is just their values.
+		if (read->read(buf, size) != size) {
+			throw ParserError {"ReadArchiveBinary", "archive is truncated"};
+		}
+
+		return true;
 	}
 
 	void ReadArchiveBinary::skip_entry() {
@@ -30,6 +30,7 @@ namespace zenkit {
 		AxisAlignedBoundingBox read_bbox() override;
 		Mat3 read_mat3x3() override;
 		std::unique_ptr<Read> read_raw(std::size_t size) override;
+		bool read_packed(std::byte* buf, std::size_t size) override;
 
 		void skip_object(bool skip_current) override;
 
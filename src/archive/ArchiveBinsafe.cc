@@ -8,31 +8,39 @@
 #include <algorithm>
 #include <charconv>
 #include <cstring>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <unordered_set>
 
 namespace zenkit {
 	void ReadArchiveBinsafe::read_header() {
 		_m_bs_version = read->read_uint();
 		_m_object_count = read->read_uint();
 
-		{
-			auto hash_table_offset = read->read_uint();
-			auto mark = read->tell();
-			read->seek(hash_table_offset, Whence::BEG);
+		// The hash table is stored at the end of the archive and only needed for the names of entries. It is read
+		// on first use, so that archives can be parsed while the rest of their stream is still being received.
+		_m_hash_table_offset = read->read_uint();
+	}
 
-			auto hash_table_size = read->read_uint();
-			_m_hash_table_entries.resize(hash_table_size);
+	void ReadArchiveBinsafe::read_hash_table() {
+		auto mark = read->tell();
+		read->seek(_m_hash_table_offset, Whence::BEG);
 
-			for (std::uint32_t i = 0; i < hash_table_size; ++i) {
-				auto key_length = read->read_ushort();
-				auto insertion_index = read->read_ushort();
-				auto hash_value = read->read_uint();
-				auto key = read->read_string(key_length);
+		auto hash_table_size = read->read_uint();
+		_m_hash_table_entries.resize(hash_table_size);
 
-				_m_hash_table_entries[insertion_index] = hash_table_entry {key, hash_value};
-			}
+		for (std::uint32_t i = 0; i < hash_table_size; ++i) {
+			auto key_length = read->read_ushort();
+			auto insertion_index = read->read_ushort();
+			auto hash_value = read->read_uint();
+			auto key = read->read_string(key_length);
 
-			read->seek(static_cast<ssize_t>(mark), Whence::BEG);
+			_m_hash_table_entries[insertion_index] = hash_table_entry {key, hash_value};
 		}
+
+		read->seek(static_cast<ssize_t>(mark), Whence::BEG);
+		_m_hash_table_loaded = true;
 	}
 
 	bool ReadArchiveBinsafe::read_object_begin(ArchiveObject& obj) {
@@ -103,6 +111,7 @@ namespace zenkit {
 		}
 
 		auto hash = read->read_uint();
+		if (!_m_hash_table_loaded) this->read_hash_table();
 		return _m_hash_table_entries[hash].key;
 	}
 
@@ -213,38 +222,128 @@ namespace zenkit {
 			ZKLOGW("ReadArchive.Binsafe", "Reading %zu bytes although %d are actually available", size, length);
 		}
 
-		std::vector bytes(length, std::byte {});
-		read->read(bytes.data(), length);
-		return Read::from(std::move(bytes));
+		return read->slice(length);
 	}
 
-	void ReadArchiveBinsafe::skip_entry() {
-		switch (static_cast<ArchiveEntryType>(read->read_ubyte())) {
+	void ReadArchiveBinsafe::skip_value(ArchiveEntryType type) {
+		switch (type) {
 		case ArchiveEntryType::STRING:
 		case ArchiveEntryType::RAW:
 		case ArchiveEntryType::RAW_FLOAT:
 			read->seek(read->read_ushort(), Whence::CUR);
 			break;
-		case ArchiveEntryType::ENUM:
-		case ArchiveEntryType::HASH:
+		default: {
+			auto tp = static_cast<uint8_t>(type);
+			if (tp >= std::size(type_sizes) || type_sizes[tp] == 0) {
+				throw ParserError {"ReadArchive.Binsafe", "invalid entry type: " + std::to_string(tp)};
+			}
+
+			read->seek(type_sizes[tp], Whence::CUR);
+			break;
+		}
+		}
+	}
+
+	void ReadArchiveBinsafe::skip_entry() {
+		auto type = static_cast<ArchiveEntryType>(read->read_ubyte());
+
+		// Fields are stored as a key into the hash table followed by the actual value. Skip both at once.
+		if (type == ArchiveEntryType::HASH) {
+			read->seek(sizeof(uint32_t), Whence::CUR);
+			type = static_cast<ArchiveEntryType>(read->read_ubyte());
+		}
+
+		this->skip_value(type);
+	}
+
+	void ReadArchiveBinsafe::skip_object(bool skip_current) {
+		int32_t level = skip_current ? 1 : 0;
+
+		// Every field value is preceded by its key into the hash table, so a string which is not preceded by a key
+		// has to be an object begin or end marker. This way, neither strings nor values need to be decoded.
+		do {
+			if (read->eof()) return;
+
+			auto type = static_cast<ArchiveEntryType>(read->read_ubyte());
+			if (type == ArchiveEntryType::HASH) {
+				read->seek(sizeof(uint32_t), Whence::CUR);
+				this->skip_value(static_cast<ArchiveEntryType>(read->read_ubyte()));
+				continue;
+			}
+
+			if (type != ArchiveEntryType::STRING) {
+				this->skip_value(type);
+				continue;
+			}
+
+			auto length = read->read_ushort();
+			if (length == 0) continue;
+
+			auto first = read->read_char();
+			if (length == 2) {
+				auto second = read->read_char();
+				if (first == '[' && second == ']') --level;
+				continue;
+			}
+
+			read->seek(length - 1, Whence::CUR);
+			if (first == '[') ++level;
+		} while (level > 0);
+	}
+
+	void ReadArchiveBinsafe::copy_entry(WriteArchive& w) {
+		auto const& name = this->get_entry_key();
+		auto type = static_cast<ArchiveEntryType>(read->read_ubyte());
+
+		switch (type) {
+		case ArchiveEntryType::STRING:
+			w.write_string(name, read->read_string(read->read_ushort()));
+			break;
 		case ArchiveEntryType::INTEGER:
+			w.write_int(name, read->read_int());
+			break;
 		case ArchiveEntryType::FLOAT:
-		case ArchiveEntryType::BOOL:
-		case ArchiveEntryType::COLOR:
-			(void) read->read_uint();
+			w.write_float(name, read->read_float());
 			break;
 		case ArchiveEntryType::BYTE:
-			(void) read->read_ubyte();
+			w.write_byte(name, read->read_ubyte());
 			break;
 		case ArchiveEntryType::WORD:
-			(void) read->read_ushort();
+			w.write_word(name, read->read_ushort());
+			break;
+		case ArchiveEntryType::BOOL:
+			w.write_bool(name, read->read_uint() != 0);
 			break;
 		case ArchiveEntryType::VEC3:
-			(void) read->read_float();
-			(void) read->read_float();
-			(void) read->read_float();
+			w.write_vec3(name, read->read_vec3());
+			break;
+		case ArchiveEntryType::COLOR: {
+			auto b = read->read_ubyte();
+			auto g = read->read_ubyte();
+			auto r = read->read_ubyte();
+			auto a = read->read_ubyte();
+			w.write_color(name, {r, g, b, a});
 			break;
 		}
+		case ArchiveEntryType::ENUM:
+			w.write_enum(name, read->read_uint());
+			break;
+		case ArchiveEntryType::RAW: {
+			std::vector<std::byte> bytes(read->read_ushort());
+			read->read(bytes.data(), bytes.size());
+			w.write_raw(name, bytes);
+			break;
+		}
+		case ArchiveEntryType::RAW_FLOAT: {
+			std::vector<float> floats(read->read_ushort() / sizeof(float));
+			read->read(floats.data(), floats.size() * sizeof(float));
+			w.write_raw_float(name, floats.data(), static_cast<std::uint16_t>(floats.size()));
+			break;
+		}
+		default:
+			throw ParserError {"ReadArchive.Binsafe",
+			                   "invalid entry type: " + std::to_string(static_cast<uint32_t>(type))};
+		}
 	}
 
 	template <ArchiveEntryType tp>
@@ -272,6 +371,20 @@ namespace zenkit {
 		}
 	}
 
+	/// \brief Interns the given field name in a process-wide pool.
+	///
+	/// Field names are a small, fixed vocabulary shared by all archives. Interning them means that each writer only
+	/// keeps views to the pooled strings and no key is allocated more than once per process.
+	///
+	/// \return A view of the interned name. It stays valid until the program exits.
+	static std::string_view binsafe_intern_key(std::string_view name) {
+		static std::mutex lock;
+		static std::unordered_set<std::string> pool;
+
+		std::lock_guard guard {lock};
+		return *pool.emplace(name).first;
+	}
+
 	WriteArchiveBinsafe::WriteArchiveBinsafe(Write* w) : _m_write(w) {
 		this->_m_head = this->_m_write->tell();
 		this->write_header();
@@ -434,14 +547,12 @@ namespace zenkit {
 			cur = this->_m_write->tell();
 		}
 
-		this->_m_write->write_uint(_m_hash_keys.size());
-
-		std::vector<std::pair<std::string, size_t>> vc {_m_hash_keys.begin(), _m_hash_keys.end()};
-		std::sort(vc.begin(), vc.end(), [](auto const& a, auto const& b) { return a.second < b.second; });
+		this->_m_write->write_uint(_m_hash_key_order.size());
 
-		for (auto const& [key, value] : vc) {
+		for (auto i = 0u; i < _m_hash_key_order.size(); ++i) {
+			auto key = _m_hash_key_order[i];
 			this->_m_write->write_ushort(key.length());
-			this->_m_write->write_ushort(value);
+			this->_m_write->write_ushort(i);
 
 			auto hash_value = 0u;
 			for (char c : key) {
@@ -461,8 +572,11 @@ namespace zenkit {
 
 		auto it = this->_m_hash_keys.find(name);
 		if (it == this->_m_hash_keys.end()) {
-			auto key = this->_m_hash_keys.size();
-			this->_m_hash_keys.emplace(std::string {name}, key);
+			auto key = static_cast<std::uint16_t>(this->_m_hash_key_order.size());
+			auto interned = binsafe_intern_key(name);
+
+			this->_m_hash_key_order.push_back(interned);
+			this->_m_hash_keys.emplace(interned, key);
 			this->_m_write->write_uint(key);
 		} else {
 			this->_m_write->write_uint(it->second);
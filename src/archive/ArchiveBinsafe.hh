@@ -4,7 +4,8 @@
 #include "zenkit/Archive.hh"
 #include "zenkit/Stream.hh"
 
-#include <map>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace zenkit {
@@ -59,11 +60,23 @@ namespace zenkit {
 		Mat3 read_mat3x3() override;
 		std::unique_ptr<Read> read_raw(std::size_t size) override;
 
+		void skip_object(bool skip_current) override;
+
 	protected:
 		void read_header() override;
 		void skip_entry() override;
 
+		/// \brief Skips the value of an entry of the given type without decoding it.
+		void skip_value(ArchiveEntryType type);
+
+		void copy_entry(WriteArchive& w) override;
+
+		[[nodiscard]] bool has_entries() const noexcept override {
+			return read->tell() < _m_hash_table_offset && !read->eof();
+		}
+
 		std::string const& get_entry_key();
+		void read_hash_table();
 
 		template <ArchiveEntryType tp>
 		std::uint16_t ensure_entry_meta();
@@ -71,7 +84,9 @@ namespace zenkit {
 	private:
 		std::uint32_t _m_object_count {0};
 		std::uint32_t _m_bs_version {0};
+		std::uint32_t _m_hash_table_offset {0};
 
+		bool _m_hash_table_loaded {false};
 		std::vector<hash_table_entry> _m_hash_table_entries;
 	};
 
@@ -122,7 +137,9 @@ namespace zenkit {
 
 		Write* _m_write;
 		std::uint32_t _m_index {0};
-		std::map<std::string, std::uint16_t, std::less<>> _m_hash_keys;
+		// Keys point into a process-wide pool of interned field names, see `binsafe_intern_key`.
+		std::unordered_map<std::string_view, std::uint16_t> _m_hash_keys;
+		std::vector<std::string_view> _m_hash_key_order;
 		std::size_t _m_head;
 	};
 } // namespace zenkit
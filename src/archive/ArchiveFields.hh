@@ -0,0 +1,164 @@
+// Copyright © 2021-2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "zenkit/Archive.hh"
+#include "zenkit/Misc.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace zenkit::detail {
+	/// \brief Describes how a value of type `T` is stored in a binary archive and how it is read from any archive.
+	template <typename T, typename = void>
+	struct ArchiveFieldTraits;
+
+	template <>
+	struct ArchiveFieldTraits<float> {
+		static constexpr std::size_t SIZE = 4;
+
+		static float unpack(std::byte const* p) {
+			float v;
+			std::memcpy(&v, p, sizeof v);
+			return v;
+		}
+
+		static float read(ReadArchive& r) {
+			return r.read_float();
+		}
+	};
+
+	template <>
+	struct ArchiveFieldTraits<std::int32_t> {
+		static constexpr std::size_t SIZE = 4;
+
+		static std::int32_t unpack(std::byte const* p) {
+			std::int32_t v;
+			std::memcpy(&v, p, sizeof v);
+			return v;
+		}
+
+		static std::int32_t read(ReadArchive& r) {
+			return r.read_int();
+		}
+	};
+
+	template <>
+	struct ArchiveFieldTraits<std::uint16_t> {
+		static constexpr std::size_t SIZE = 2;
+
+		static std::uint16_t unpack(std::byte const* p) {
+			std::uint16_t v;
+			std::memcpy(&v, p, sizeof v);
+			return v;
+		}
+
+		static std::uint16_t read(ReadArchive& r) {
+			return r.read_word();
+		}
+	};
+
+	template <>
+	struct ArchiveFieldTraits<std::uint8_t> {
+		static constexpr std::size_t SIZE = 1;
+
+		static std::uint8_t unpack(std::byte const* p) {
+			return static_cast<std::uint8_t>(p[0]);
+		}
+
+		static std::uint8_t read(ReadArchive& r) {
+			return r.read_byte();
+		}
+	};
+
+	template <>
+	struct ArchiveFieldTraits<bool> {
+		static constexpr std::size_t SIZE = 1;
+
+		static bool unpack(std::byte const* p) {
+			return p[0] != std::byte {0};
+		}
+
+		static bool read(ReadArchive& r) {
+			return r.read_bool();
+		}
+	};
+
+	template <>
+	struct ArchiveFieldTraits<Color> {
+		static constexpr std::size_t SIZE = 4;
+
+		static Color unpack(std::byte const* p) {
+			// Colors are stored as BGRA.
+			return {static_cast<std::uint8_t>(p[2]),
+			        static_cast<std::uint8_t>(p[1]),
+			        static_cast<std::uint8_t>(p[0]),
+			        static_cast<std::uint8_t>(p[3])};
+		}
+
+		static Color read(ReadArchive& r) {
+			return r.read_color();
+		}
+	};
+
+	template <>
+	struct ArchiveFieldTraits<Vec3> {
+		static constexpr std::size_t SIZE = 12;
+
+		static Vec3 unpack(std::byte const* p) {
+			float v[3];
+			std::memcpy(v, p, sizeof v);
+			return {v[0], v[1], v[2]};
+		}
+
+		static Vec3 read(ReadArchive& r) {
+			return r.read_vec3();
+		}
+	};
+
+	template <typename T>
+	struct ArchiveFieldTraits<T, std::enable_if_t<std::is_enum_v<T>>> {
+		// Binary archives store enums as a single byte.
+		static constexpr std::size_t SIZE = 1;
+
+		static T unpack(std::byte const* p) {
+			return static_cast<T>(p[0]);
+		}
+
+		static T read(ReadArchive& r) {
+			return static_cast<T>(r.read_enum());
+		}
+	};
+
+	template <typename C, typename T>
+	T archive_field_type(T C::*);
+
+	/// \brief A run of consecutive fixed-size archive entries, decoded directly into the given members.
+	///
+	/// The combined size of the run is known at compile time. For binary archives the whole run is fetched using a
+	/// single call to ReadArchive::read_packed and unpacked from a stack buffer. All other formats store a name and
+	/// type with every entry, so the members are read one by one using the regular ReadArchive functions instead.
+	///
+	/// Members must be listed in the order in which the entries appear in the archive. Objects whose layout differs
+	/// between game versions use a separate run for each version.
+	template <auto... Members>
+	struct ArchiveFieldRun {
+		static constexpr std::size_t SIZE =
+		    (ArchiveFieldTraits<decltype(archive_field_type(Members))>::SIZE + ... + 0);
+
+		template <typename C>
+		static void read(ReadArchive& r, C& obj) {
+			std::byte buf[SIZE] {};
+
+			if (r.read_packed(buf, SIZE)) {
+				std::byte const* p = buf;
+				((obj.*Members = ArchiveFieldTraits<decltype(archive_field_type(Members))>::unpack(p),
+				  p += ArchiveFieldTraits<decltype(archive_field_type(Members))>::SIZE),
+				 ...);
+			} else {
+				((obj.*Members = ArchiveFieldTraits<decltype(archive_field_type(Members))>::read(r)), ...);
+			}
+		}
+	};
+} // namespace zenkit::detail
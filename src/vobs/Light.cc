@@ -4,6 +4,7 @@
 #include "zenkit/Archive.hh"
 
 #include "../Internal.hh"
+#include "../archive/ArchiveFields.hh"
 
 #include <sstream>
 
@@ -14,12 +15,14 @@ namespace zenkit {
 
 	void LightPreset::load(ReadArchive& r, GameVersion version) {
 		this->preset = r.read_string();                           // lightPresetInUse
-		this->light_type = static_cast<LightType>(r.read_enum()); // lightType
-		this->range = r.read_float();                             // range
-		this->color = r.read_color();                             // color
-		this->cone_angle = r.read_float();                        // spotConeAngle
-		this->is_static = r.read_bool();                          // lightStatic
-		this->quality = static_cast<LightQuality>(r.read_enum()); // lightQuality
+
+		// lightType, range, color, spotConeAngle, lightStatic, lightQuality
+		detail::ArchiveFieldRun<&LightPreset::light_type,
+		                        &LightPreset::range,
+		                        &LightPreset::color,
+		                        &LightPreset::cone_angle,
+		                        &LightPreset::is_static,
+		                        &LightPreset::quality>::read(r, *this);
 		this->lensflare_fx = r.read_string();                     // lensflareFX
 
 		if (!this->is_static) {
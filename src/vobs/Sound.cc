@@ -3,6 +3,8 @@
 #include "zenkit/vobs/Sound.hh"
 #include "zenkit/Archive.hh"
 
+#include "../archive/ArchiveFields.hh"
+
 namespace zenkit {
 	void VSound::parse(VSound& obj, ReadArchive& r, GameVersion version) {
 		obj.load(r, version);
@@ -10,17 +12,21 @@ namespace zenkit {
 
 	void VSound::load(ReadArchive& r, GameVersion version) {
 		VirtualObject::load(r, version);
-		this->volume = r.read_float();                                          // sndVolume
-		this->mode = static_cast<SoundMode>(r.read_enum());                     // sndMode
-		this->random_delay = r.read_float();                                    // sndRandDelay
-		this->random_delay_var = r.read_float();                                // sndRandDelayVar
-		this->initially_playing = r.read_bool();                                // sndStartOn
-		this->ambient3d = r.read_bool();                                        // sndAmbient3D
-		this->obstruction = r.read_bool();                                      // sndObstruction
-		this->cone_angle = r.read_float();                                      // sndConeAngle
-		this->volume_type = static_cast<SoundTriggerVolumeType>(r.read_enum()); // sndVolType
-		this->radius = r.read_float();                                          // sndRadius
-		this->sound_name = r.read_string();                                     // sndName
+
+		// sndVolume, sndMode, sndRandDelay, sndRandDelayVar, sndStartOn, sndAmbient3D, sndObstruction,
+		// sndConeAngle, sndVolType, sndRadius
+		detail::ArchiveFieldRun<&VSound::volume,
+		                        &VSound::mode,
+		                        &VSound::random_delay,
+		                        &VSound::random_delay_var,
+		                        &VSound::initially_playing,
+		                        &VSound::ambient3d,
+		                        &VSound::obstruction,
+		                        &VSound::cone_angle,
+		                        &VSound::volume_type,
+		                        &VSound::radius>::read(r, *this);
+
+		this->sound_name = r.read_string(); // sndName
 
 		if (r.is_save_game()) {
 			// In save-games, sounds contain extra variables
@@ -5,6 +5,8 @@
 #include "zenkit/CutsceneLibrary.hh"
 #include "zenkit/vobs/Misc.hh"
 
+#include "../archive/ArchiveFields.hh"
+
 #include <unordered_map>
 
 namespace zenkit {
@@ -133,24 +135,29 @@ namespace zenkit {
 
 			this->vob_name = r.read_string();                                              // vobName
 			this->visual_name = r.read_string();                                           // visual
-			this->show_visual = r.read_bool();                                             // showVisual
-			this->sprite_camera_facing_mode = static_cast<SpriteAlignment>(r.read_enum()); // visualCamAlign
 
 			if (version == GameVersion::GOTHIC_1) {
-				this->cd_static = r.read_bool();                                // cdStatic
-				this->cd_dynamic = r.read_bool();                               // cdDyn
-				this->vob_static = r.read_bool();                               // staticVob
-				this->dynamic_shadows = static_cast<ShadowType>(r.read_enum()); // dynShadow
+				// showVisual, visualCamAlign, cdStatic, cdDyn, staticVob, dynShadow
+				detail::ArchiveFieldRun<&VirtualObject::show_visual,
+				                        &VirtualObject::sprite_camera_facing_mode,
+				                        &VirtualObject::cd_static,
+				                        &VirtualObject::cd_dynamic,
+				                        &VirtualObject::vob_static,
+				                        &VirtualObject::dynamic_shadows>::read(r, *this);
 			} else {
-				this->anim_mode = static_cast<AnimationType>(r.read_enum());    // visualAniMode
-				this->anim_strength = r.read_float();                           // visualAniModeStrength
-				this->far_clip_scale = r.read_float();                          // vobFarClipZScale
-				this->cd_static = r.read_bool();                                // cdStatic
-				this->cd_dynamic = r.read_bool();                               // cdDyn
-				this->vob_static = r.read_bool();                               // staticVob
-				this->dynamic_shadows = static_cast<ShadowType>(r.read_enum()); // dynShadow
-				this->bias = r.read_int();                                      // zbias
-				this->ambient = r.read_bool();                                  // isAmbient
+				// showVisual, visualCamAlign, visualAniMode, visualAniModeStrength, vobFarClipZScale, cdStatic,
+				// cdDyn, staticVob, dynShadow, zbias, isAmbient
+				detail::ArchiveFieldRun<&VirtualObject::show_visual,
+				                        &VirtualObject::sprite_camera_facing_mode,
+				                        &VirtualObject::anim_mode,
+				                        &VirtualObject::anim_strength,
+				                        &VirtualObject::far_clip_scale,
+				                        &VirtualObject::cd_static,
+				                        &VirtualObject::cd_dynamic,
+				                        &VirtualObject::vob_static,
+				                        &VirtualObject::dynamic_shadows,
+				                        &VirtualObject::bias,
+				                        &VirtualObject::ambient>::read(r, *this);
 			}
 		}
 
@@ -228,7 +235,8 @@ namespace zenkit {
 		bit1 |= (this->visual && !this->visual->name.empty()) << 2u;
 		bit1 |= (!!this->visual && this->visual->type != VisualType::UNKNOWN) << 3u;
 		bit1 |= (!!this->ai) << 4u;
-		bit1 |= (!!this->event_manager) << 5u;
+		// Event managers are only stored in save-games.
+		bit1 |= (!!this->event_manager && w.is_save_game()) << 5u;
 
 		// Gothic 1 does not store rigid-body information.
 		if (version == GameVersion::GOTHIC_1) {
@@ -271,7 +279,7 @@ namespace zenkit {
 			w.write_object("ai", this->ai, version);
 		}
 
-		if (this->event_manager) {
+		if (this->event_manager && w.is_save_game()) {
 			w.write_object(this->event_manager, version);
 		}
 
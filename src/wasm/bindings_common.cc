@@ -4,6 +4,9 @@
 #include "zenkit/Stream.hh"
 #include "zenkit/Texture.hh"
 
+#include <algorithm>
+#include <cstddef>
+
 namespace zenkit::wasm {
 
     std::unique_ptr<zenkit::Read> create_reader_from_buffer(uintptr_t data_ptr, size_t length) {
@@ -43,6 +46,109 @@ namespace zenkit::wasm {
         return zenkit::Read::from(std::move(data));
     }
 
+    void ChunkedRead::push(std::vector<std::byte> chunk) {
+        if (chunk.empty()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finished_) return;
+
+            offsets_.push_back(size_);
+            size_ += chunk.size();
+            chunks_.push_back(std::move(chunk));
+        }
+
+        cv_.notify_all();
+    }
+
+    void ChunkedRead::finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+
+        cv_.notify_all();
+    }
+
+    void ChunkedRead::abort() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            chunks_.clear();
+            offsets_.clear();
+            size_ = 0;
+            finished_ = true;
+        }
+
+        cv_.notify_all();
+    }
+
+    size_t ChunkedRead::received() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    bool ChunkedRead::finished() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return finished_;
+    }
+
+    size_t ChunkedRead::read(void* buf, size_t len) noexcept {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return finished_ || size_ >= position_ + len; });
+        if (position_ >= size_) return 0;
+
+        len = std::min(len, size_ - position_);
+
+        // Find the chunk containing the current position and copy from it and the chunks following it.
+        auto it = std::upper_bound(offsets_.begin(), offsets_.end(), position_);
+        auto chunk = static_cast<size_t>(it - offsets_.begin()) - 1;
+        auto out = static_cast<std::byte*>(buf);
+        auto remaining = len;
+
+        while (remaining > 0) {
+            auto const& data = chunks_[chunk];
+            auto start = position_ - offsets_[chunk];
+            auto count = std::min(remaining, data.size() - start);
+
+            std::memcpy(out, data.data() + start, count);
+            out += count;
+            position_ += count;
+            remaining -= count;
+            ++chunk;
+        }
+
+        return len;
+    }
+
+    void ChunkedRead::seek(ssize_t off, zenkit::Whence whence) noexcept {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        switch (whence) {
+        case zenkit::Whence::BEG:
+            position_ = static_cast<size_t>(off);
+            break;
+        case zenkit::Whence::CUR:
+            position_ = static_cast<size_t>(static_cast<ssize_t>(position_) + off);
+            break;
+        case zenkit::Whence::END:
+            // The end of the stream is only known once all of it has been received.
+            cv_.wait(lock, [&] { return finished_; });
+            position_ = static_cast<size_t>(static_cast<ssize_t>(size_) + off);
+            break;
+        }
+    }
+
+    size_t ChunkedRead::tell() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return position_;
+    }
+
+    bool ChunkedRead::eof() const noexcept {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return finished_ || size_ > position_; });
+        return position_ >= size_;
+    }
+
     std::unique_ptr<ReadArchiveWrapper> create_read_archive(uintptr_t data_ptr, size_t length) {
         auto reader = create_reader_from_buffer(data_ptr, length);
         auto archive = zenkit::ReadArchive::from(reader.get());
@@ -80,4 +186,79 @@ namespace zenkit::wasm {
         }
     }
 
+    std::unique_ptr<TypedBuffer> TextureWrapper::asRgba8View(uint32_t mip_level) const {
+        try {
+            if (mip_level >= tex_.mipmaps())
+                return nullptr;
+
+            std::vector<uint8_t> data(size_t(tex_.mipmap_width(mip_level)) * tex_.mipmap_height(mip_level) * 4);
+            if (data.empty())
+                return nullptr;
+
+            tex_.as_rgba8_into(data.data(), data.size(), mip_level);
+            return std::make_unique<TypedBuffer>(std::move(data));
+        } catch(...) {
+            return nullptr;
+        }
+    }
+
+    Result<bool> ModelMeshWrapper::loadFromArray(const emscripten::val& uint8_array) {
+        try {
+            auto reader = create_reader_from_js_array(uint8_array);
+            mesh_.load(reader.get());
+            return Result<bool>(true);
+        } catch (const std::exception& e) {
+            return Result<bool>(e.what());
+        }
+    }
+
+    template<typename T>
+    static emscripten::val to_typed_array(const char* type, const T* data, size_t count) {
+        emscripten::val js_array = emscripten::val::global(type).new_(count);
+        js_array.call<void>("set", emscripten::val(emscripten::typed_memory_view(count, data)));
+        return js_array;
+    }
+
+    emscripten::val ModelMeshWrapper::buildSkinnedBuffers(uint32_t mesh_index) const {
+        if (mesh_index >= mesh_.meshes.size())
+            return emscripten::val::null();
+
+        auto buffers = mesh_.meshes[mesh_index].build_skinned_buffers();
+        using Vertex = zenkit::SkinnedMeshBufferVertex;
+
+        emscripten::val result = emscripten::val::object();
+        result.set("vertices", to_typed_array("Uint8Array",
+                                              reinterpret_cast<const uint8_t*>(buffers.vertices.data()),
+                                              buffers.vertices.size() * sizeof(Vertex)));
+        result.set("vertexCount", buffers.vertices.size());
+        result.set("vertexStride", sizeof(Vertex));
+
+        emscripten::val layout = emscripten::val::object();
+        layout.set("positions", offsetof(Vertex, positions));
+        layout.set("weights", offsetof(Vertex, weights));
+        layout.set("normal", offsetof(Vertex, normal));
+        layout.set("texture", offsetof(Vertex, texture));
+        layout.set("nodes", offsetof(Vertex, nodes));
+        result.set("layout", layout);
+
+        if (buffers.wide_indices()) {
+            result.set("indices", to_typed_array("Uint32Array", buffers.indices32.data(), buffers.indices32.size()));
+        } else {
+            result.set("indices", to_typed_array("Uint16Array", buffers.indices16.data(), buffers.indices16.size()));
+        }
+
+        emscripten::val batches = emscripten::val::array();
+        for (const auto& batch : buffers.batches) {
+            emscripten::val b = emscripten::val::object();
+            b.set("material", batch.material);
+            b.set("indexOffset", batch.index_offset);
+            b.set("indexCount", batch.index_count);
+            batches.call<void>("push", b);
+        }
+        result.set("batches", batches);
+
+        result.set("nodes", to_typed_array("Int32Array", buffers.nodes.data(), buffers.nodes.size()));
+        return result;
+    }
+
 } // namespace zenkit::wasm
@@ -4,14 +4,18 @@
 
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <variant>
 #include <vector>
 #include <cstring>
 
 #include "zenkit/Stream.hh"
 #include "zenkit/Misc.hh"
 #include "zenkit/Mesh.hh"
+#include "zenkit/ModelMesh.hh"
 #include "zenkit/Archive.hh"
 #include "zenkit/Texture.hh"
 
@@ -48,6 +52,83 @@ namespace zenkit::wasm {
     std::unique_ptr<zenkit::Read> create_reader_from_string(const std::string& buffer);
     std::unique_ptr<zenkit::Read> create_reader_from_js_array(const emscripten::val& uint8_array);
 
+    /// \brief A stream over data which is pushed into it in chunks while it is being read, e.g. during a download.
+    ///
+    /// Reads past the data received so far block until enough data has been pushed or finish() is called, so the
+    /// stream has to be read on another thread than the one pushing data into it (ZK_WASM_THREADS), unless it is only
+    /// read after calling finish(). Chunks are kept as they are instead of being copied into one contiguous buffer.
+    class ChunkedRead final : public zenkit::Read {
+    public:
+        /// \brief Appends a chunk of data to the stream, waking up a blocked reader.
+        void push(std::vector<std::byte> chunk);
+
+        /// \brief Marks the end of the data. Reads past it return no data from now on.
+        void finish();
+
+        /// \brief Drops all data and marks the end of the stream, so that a blocked reader fails quickly.
+        void abort();
+
+        [[nodiscard]] size_t received() const;
+        [[nodiscard]] bool finished() const;
+
+        size_t read(void* buf, size_t len) noexcept override;
+        void seek(ssize_t off, zenkit::Whence whence) noexcept override;
+        [[nodiscard]] size_t tell() const noexcept override;
+        [[nodiscard]] bool eof() const noexcept override;
+
+    private:
+        mutable std::mutex mutex_;
+        mutable std::condition_variable cv_;
+
+        std::vector<std::vector<std::byte>> chunks_;
+        std::vector<size_t> offsets_; // The offset of each chunk in the stream
+        size_t size_ = 0;
+        size_t position_ = 0;
+        bool finished_ = false;
+    };
+
+    /// \brief A typed array owned by the WASM module which is handed to JS as a view instead of a copy.
+    ///
+    /// The array returned by view() aliases the WASM heap, so no data is copied into JS. It is only valid until
+    /// dispose() is called or the buffer is deleted. Growing the WASM memory detaches all views into it, so fetch the
+    /// view again after calling into ZenKit. Copy it using `view().slice()` if the data must outlive the buffer.
+    class TypedBuffer {
+    public:
+        template<typename T>
+        explicit TypedBuffer(std::vector<T> data) : data_(std::move(data)) {}
+
+        // Returns a typed array of the matching element type viewing the data, or null once disposed.
+        emscripten::val view() const {
+            return std::visit([](const auto& data) {
+                if (data.empty()) return emscripten::val::null();
+                return emscripten::val(emscripten::typed_memory_view(data.size(), data.data()));
+            }, data_);
+        }
+
+        // Releases the data right away instead of when the buffer is deleted. Views become invalid.
+        void dispose() {
+            std::visit([](auto& data) {
+                data.clear();
+                data.shrink_to_fit();
+            }, data_);
+        }
+
+        [[nodiscard]] size_t length() const {
+            return std::visit([](const auto& data) { return data.size(); }, data_);
+        }
+
+        [[nodiscard]] size_t byteLength() const {
+            return std::visit([](const auto& data) { return data.size() * sizeof(data[0]); }, data_);
+        }
+
+    private:
+        std::variant<std::vector<uint8_t>,
+                     std::vector<uint16_t>,
+                     std::vector<uint32_t>,
+                     std::vector<int32_t>,
+                     std::vector<float>> data_;
+    };
+
     // Vector and geometric wrapper classes
     struct Vector3 {
         float x, y, z;
@@ -357,14 +438,7 @@ namespace zenkit::wasm {
                 return emscripten::val::null();
             }
 
-            // Create a flat array of floats: [x1,y1,z1, x2,y2,z2, ...]
-            std::vector<float> flat_vertices;
-            flat_vertices.reserve(mesh_.vertices.size() * 3);
-            for (const auto& vertex : mesh_.vertices) {
-                flat_vertices.push_back(vertex.x);
-                flat_vertices.push_back(vertex.y);
-                flat_vertices.push_back(vertex.z);
-            }
+            auto flat_vertices = flatVertices();
 
             // Allocate JS Float32Array and copy data into it
             emscripten::val Float32Array = emscripten::val::global("Float32Array");
@@ -378,13 +452,7 @@ namespace zenkit::wasm {
                 return emscripten::val::null();
             }
 
-            std::vector<float> flat_normals;
-            flat_normals.reserve(mesh_.features.size() * 3);
-            for (const auto& feature : mesh_.features) {
-                flat_normals.push_back(feature.normal.x);
-                flat_normals.push_back(feature.normal.y);
-                flat_normals.push_back(feature.normal.z);
-            }
+            auto flat_normals = flatNormals();
 
             emscripten::val Float32Array = emscripten::val::global("Float32Array");
             emscripten::val js_array = Float32Array.new_(flat_normals.size());
@@ -397,12 +465,7 @@ namespace zenkit::wasm {
                 return emscripten::val::null();
             }
 
-            std::vector<float> flat_uvs;
-            flat_uvs.reserve(mesh_.features.size() * 2);
-            for (const auto& feature : mesh_.features) {
-                flat_uvs.push_back(feature.texture.x);
-                flat_uvs.push_back(feature.texture.y);
-            }
+            auto flat_uvs = flatUVs();
 
             emscripten::val Float32Array = emscripten::val::global("Float32Array");
             emscripten::val js_array = Float32Array.new_(flat_uvs.size());
@@ -478,9 +541,80 @@ namespace zenkit::wasm {
             return js_array;
         }
 
+        // Zero-copy variants of the typed array getters above. Each returns a TypedBuffer owning the data, which JS
+        // views in place using view(). Call dispose() or delete() once the data has been uploaded. Returns null if
+        // the mesh has no such data.
+        std::unique_ptr<TypedBuffer> getVerticesView() const {
+            if (mesh_.vertices.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(flatVertices());
+        }
+
+        std::unique_ptr<TypedBuffer> getNormalsView() const {
+            if (mesh_.features.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(flatNormals());
+        }
+
+        std::unique_ptr<TypedBuffer> getUVsView() const {
+            if (mesh_.features.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(flatUVs());
+        }
+
+        std::unique_ptr<TypedBuffer> getIndicesView() const {
+            if (mesh_.polygons.vertex_indices.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(mesh_.polygons.vertex_indices);
+        }
+
+        std::unique_ptr<TypedBuffer> getFeatureIndicesView() const {
+            if (mesh_.polygons.feature_indices.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(mesh_.polygons.feature_indices);
+        }
+
+        std::unique_ptr<TypedBuffer> getTriFeatureIndicesView() const {
+            if (mesh_.polygon_feature_indices.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(mesh_.polygon_feature_indices);
+        }
+
+        std::unique_ptr<TypedBuffer> getPolygonMaterialIndicesView() const {
+            if (mesh_.polygons.material_indices.empty()) return nullptr;
+            return std::make_unique<TypedBuffer>(mesh_.polygons.material_indices);
+        }
+
     private:
         const zenkit::Mesh& mesh_;
 
+        // Flat array of floats: [x1,y1,z1, x2,y2,z2, ...]
+        std::vector<float> flatVertices() const {
+            std::vector<float> flat_vertices;
+            flat_vertices.reserve(mesh_.vertices.size() * 3);
+            for (const auto& vertex : mesh_.vertices) {
+                flat_vertices.push_back(vertex.x);
+                flat_vertices.push_back(vertex.y);
+                flat_vertices.push_back(vertex.z);
+            }
+            return flat_vertices;
+        }
+
+        std::vector<float> flatNormals() const {
+            std::vector<float> flat_normals;
+            flat_normals.reserve(mesh_.features.size() * 3);
+            for (const auto& feature : mesh_.features) {
+                flat_normals.push_back(feature.normal.x);
+                flat_normals.push_back(feature.normal.y);
+                flat_normals.push_back(feature.normal.z);
+            }
+            return flat_normals;
+        }
+
+        std::vector<float> flatUVs() const {
+            std::vector<float> flat_uvs;
+            flat_uvs.reserve(mesh_.features.size() * 2);
+            for (const auto& feature : mesh_.features) {
+                flat_uvs.push_back(feature.texture.x);
+                flat_uvs.push_back(feature.texture.y);
+            }
+            return flat_uvs;
+        }
+
         // Helper methods for bounding box calculation
         Vector3 calculateBoundingBoxMin() const {
             if (mesh_.vertices.empty()) {
@@ -529,8 +663,31 @@ namespace zenkit::wasm {
         // Returns JS Uint8Array of RGBA8 pixels for the requested mip level
         emscripten::val asRgba8(uint32_t mip_level) const;
 
+        // Like asRgba8 but converts straight into a TypedBuffer, which JS views in place instead of copying.
+        // Returns null if the mip level cannot be converted.
+        std::unique_ptr<TypedBuffer> asRgba8View(uint32_t mip_level) const;
+
     private:
         zenkit::Texture tex_;
     };
 
+    // Model mesh wrapper for exposing GPU skinning buffers to JS
+    class ModelMeshWrapper {
+    public:
+        ModelMeshWrapper() = default;
+        ~ModelMeshWrapper() = default;
+
+        Result<bool> loadFromArray(const emscripten::val& uint8_array);
+
+        [[nodiscard]] uint32_t meshCount() const { return static_cast<uint32_t>(mesh_.meshes.size()); }
+
+        // Returns an object holding the interleaved vertices as a Uint8Array together with their stride and the
+        // byte offset of each attribute, the indices as a Uint16Array or Uint32Array, the batches and the
+        // hierarchy node index of each skinning node as an Int32Array. Returns null if the index is out of range.
+        emscripten::val buildSkinnedBuffers(uint32_t mesh_index) const;
+
+    private:
+        zenkit::ModelMesh mesh_;
+    };
+
 } // namespace zenkit::wasm
\ No newline at end of file
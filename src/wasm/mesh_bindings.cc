@@ -0,0 +1,17 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "bindings_common.hh"
+
+#include <emscripten/bind.h>
+
+EMSCRIPTEN_BINDINGS(zenkit_mesh) {
+    using namespace zenkit::wasm;
+    using namespace emscripten;
+
+    // Model mesh bindings
+    class_<ModelMeshWrapper>("ModelMesh")
+        .constructor<>()
+        .function("loadFromArray", &ModelMeshWrapper::loadFromArray)
+        .property("meshCount", &ModelMeshWrapper::meshCount)
+        .function("buildSkinnedBuffers", &ModelMeshWrapper::buildSkinnedBuffers);
+}
@@ -0,0 +1,20 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "bindings_common.hh"
+
+#include <emscripten/bind.h>
+
+EMSCRIPTEN_BINDINGS(zenkit_texture) {
+    using namespace zenkit::wasm;
+    using namespace emscripten;
+
+    // Texture bindings
+    class_<TextureWrapper>("Texture")
+        .constructor<>()
+        .function("loadFromArray", &TextureWrapper::loadFromArray)
+        .property("width", &TextureWrapper::width)
+        .property("height", &TextureWrapper::height)
+        .property("mipmaps", &TextureWrapper::mipmaps)
+        .function("asRgba8", &TextureWrapper::asRgba8)
+        .function("asRgba8View", &TextureWrapper::asRgba8View);
+}
@@ -0,0 +1,269 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "bindings_common.hh"
+#include "zenkit/Stream.hh"
+#include "zenkit/Vfs.hh"
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
+namespace zenkit::wasm {
+
+    /// \brief A stream over a remote file which fetches byte ranges of it using a JavaScript callback.
+    ///
+    /// The callback is called as `fetch(offset, length)` and has to return a Uint8Array with exactly `length` bytes
+    /// synchronously, e.g. using a synchronous XMLHttpRequest with a `Range` header. It should return null instead of
+    /// throwing if the range could not be fetched. Data is fetched in blocks of `block_size` bytes, consecutive missing
+    /// blocks with a single call, and the `max_blocks` most recently used blocks are kept in memory.
+    class RangeRead final : public zenkit::Read {
+    public:
+        RangeRead(emscripten::val fetch, size_t size, size_t block_size, size_t max_blocks)
+            : fetch_(std::move(fetch)), size_(size), block_size_(std::max<size_t>(block_size, 1)),
+              max_blocks_(std::max<size_t>(max_blocks, 1)) {}
+
+        size_t read(void* buf, size_t len) noexcept override {
+            if (position_ >= size_) return 0;
+
+            auto out = static_cast<std::byte*>(buf);
+            auto end = position_ + std::min(len, size_ - position_);
+            auto begin = position_;
+
+            while (position_ < end) {
+                auto index = position_ / block_size_;
+                auto offset = position_ % block_size_;
+
+                if (auto it = blocks_.find(index); it != blocks_.end()) {
+                    lru_.splice(lru_.begin(), lru_, it->second);
+
+                    auto const& block = it->second->second;
+                    auto count = std::min(end - position_, block.size() - offset);
+                    std::memcpy(out, block.data() + offset, count);
+                    out += count;
+                    position_ += count;
+                    continue;
+                }
+
+                // Fetch all consecutive blocks which are missing at once.
+                auto last = (end - 1) / block_size_;
+                auto stop = index + 1;
+                while (stop <= last && blocks_.count(stop) == 0) ++stop;
+
+                auto first = index * block_size_;
+                auto data = fetch(first, std::min(stop * block_size_, size_) - first);
+                if (data.empty()) break;
+
+                auto count = std::min(end - position_, data.size() - offset);
+                std::memcpy(out, data.data() + offset, count);
+                out += count;
+                position_ += count;
+
+                for (size_t i = 0; i * block_size_ < data.size(); ++i) {
+                    auto from = data.begin() + static_cast<ssize_t>(i * block_size_);
+                    auto to = data.begin() + static_cast<ssize_t>(std::min((i + 1) * block_size_, data.size()));
+                    insert(index + i, std::vector<std::byte>(from, to));
+                }
+            }
+
+            return position_ - begin;
+        }
+
+        void seek(ssize_t off, zenkit::Whence whence) noexcept override {
+            switch (whence) {
+            case zenkit::Whence::BEG:
+                position_ = static_cast<size_t>(off);
+                break;
+            case zenkit::Whence::CUR:
+                position_ = static_cast<size_t>(static_cast<ssize_t>(position_) + off);
+                break;
+            case zenkit::Whence::END:
+                position_ = static_cast<size_t>(static_cast<ssize_t>(size_) + off);
+                break;
+            }
+        }
+
+        [[nodiscard]] size_t tell() const noexcept override {
+            return position_;
+        }
+
+        [[nodiscard]] bool eof() const noexcept override {
+            return position_ >= size_;
+        }
+
+        /// \return The number of bytes fetched using the callback so far.
+        [[nodiscard]] size_t fetched() const noexcept {
+            return fetched_;
+        }
+
+    private:
+        using Block = std::pair<size_t, std::vector<std::byte>>;
+
+        std::vector<std::byte> fetch(size_t offset, size_t length) {
+            auto result = fetch_(static_cast<double>(offset), static_cast<double>(length));
+            if (result.isNull() || result.isUndefined()) return {};
+
+            std::vector<std::byte> data(result["length"].as<size_t>());
+            if (data.size() != length) return {};
+
+            emscripten::val(emscripten::typed_memory_view(data.size(), reinterpret_cast<uint8_t*>(data.data())))
+                .call<void>("set", result);
+
+            fetched_ += data.size();
+            return data;
+        }
+
+        void insert(size_t index, std::vector<std::byte> data) {
+            if (blocks_.count(index) != 0) return;
+
+            lru_.emplace_front(index, std::move(data));
+            blocks_.emplace(index, lru_.begin());
+
+            if (lru_.size() > max_blocks_) {
+                blocks_.erase(lru_.back().first);
+                lru_.pop_back();
+            }
+        }
+
+        emscripten::val fetch_;
+        size_t size_;
+        size_t block_size_;
+        size_t max_blocks_;
+        size_t position_ = 0;
+        size_t fetched_ = 0;
+
+        std::list<Block> lru_;
+        std::unordered_map<size_t, std::list<Block>::iterator> blocks_;
+    };
+
+    /// \brief WebAssembly wrapper for zenkit::Vfs
+    class VfsWrapper {
+    public:
+        /// \brief Mount a VDF disk from a JavaScript Uint8Array containing all of it.
+        bool mountDisk(const emscripten::val& uint8_array) {
+            try {
+                auto reader = create_reader_from_js_array(uint8_array);
+                vfs_.mount_disk(reader.get());
+                last_error_.clear();
+                return true;
+            } catch (const std::exception& e) {
+                last_error_ = e.what();
+                return false;
+            }
+        }
+
+        /// \brief Mount a VDF disk whose contents are fetched using a JavaScript callback as they are needed.
+        ///
+        /// Only the catalog of the disk is fetched while mounting and the contents of a file when it is read, see
+        /// RangeRead for the requirements of the callback. The callback is only called on the calling thread.
+        ///
+        /// \param size The size of the disk in bytes.
+        /// \param fetch The callback fetching byte ranges of the disk.
+        /// \param block_size The number of bytes to fetch at least.
+        /// \param max_blocks The number of fetched blocks to keep in memory.
+        bool mountRemoteDisk(double size, emscripten::val fetch, int block_size, int max_blocks) {
+            try {
+                auto source = std::make_unique<RangeRead>(std::move(fetch),
+                                                          static_cast<size_t>(size),
+                                                          static_cast<size_t>(block_size),
+                                                          static_cast<size_t>(max_blocks));
+                auto* remote = source.get();
+
+                vfs_.mount_disk_streamed(std::move(source));
+                remote_.push_back(remote);
+                last_error_.clear();
+                return true;
+            } catch (const std::exception& e) {
+                last_error_ = e.what();
+                return false;
+            }
+        }
+
+        /// \brief Check whether a file or directory exists, see readFile for how it is looked up.
+        bool exists(const std::string& path) const {
+            return lookup(path) != nullptr;
+        }
+
+        /// \brief Read a file, looked up by its path or, if there is no such path, by its name, ignoring case.
+        /// \return A Uint8Array with the contents of the file or null if it does not exist or could not be read.
+        emscripten::val readFile(const std::string& path) {
+            try {
+                auto const* node = lookup(path);
+                if (node == nullptr || node->type() != VfsNodeType::FILE) return emscripten::val::null();
+
+                auto r = node->open_read();
+                r->seek(0, Whence::END);
+                std::vector<uint8_t> data(r->tell());
+                r->seek(0, Whence::BEG);
+                r->read(data.data(), data.size());
+
+                emscripten::val js_array = emscripten::val::global("Uint8Array").new_(data.size());
+                js_array.call<void>("set", emscripten::val(emscripten::typed_memory_view(data.size(), data.data())));
+                return js_array;
+            } catch (const std::exception& e) {
+                last_error_ = e.what();
+                return emscripten::val::null();
+            }
+        }
+
+        /// \return The paths of all files in the Vfs.
+        emscripten::val listFiles() const {
+            emscripten::val result = emscripten::val::array();
+            collect(vfs_.root(), "", result);
+            return result;
+        }
+
+        /// \return The number of bytes fetched from remote disks so far.
+        [[nodiscard]] double getBytesFetched() const {
+            size_t total = 0;
+            for (auto const* remote : remote_) total += remote->fetched();
+            return static_cast<double>(total);
+        }
+
+        std::string getLastError() const {
+            return last_error_;
+        }
+
+    private:
+        VfsNode const* lookup(const std::string& path) const {
+            auto const* node = vfs_.resolve(path);
+            return node != nullptr ? node : vfs_.find(path);
+        }
+
+        static void collect(VfsNode const& node, const std::string& prefix, emscripten::val& out) {
+            for (auto const& child : node.children()) {
+                auto path = prefix.empty() ? child.name() : prefix + "/" + child.name();
+
+                if (child.type() == VfsNodeType::DIRECTORY) {
+                    collect(child, path, out);
+                } else {
+                    out.call<void>("push", path);
+                }
+            }
+        }
+
+        Vfs vfs_;
+        std::vector<RangeRead*> remote_; // Owned by the disks mounted in vfs_
+        std::string last_error_;
+    };
+
+    std::unique_ptr<VfsWrapper> createVfs() {
+        return std::make_unique<VfsWrapper>();
+    }
+
+} // namespace zenkit::wasm
+
+EMSCRIPTEN_BINDINGS(zenkit_vfs) {
+    using namespace zenkit::wasm;
+    using namespace emscripten;
+
+    class_<VfsWrapper>("Vfs")
+        .function("mountDisk", &VfsWrapper::mountDisk)
+        .function("mountRemoteDisk", &VfsWrapper::mountRemoteDisk)
+        .function("exists", &VfsWrapper::exists)
+        .function("readFile", &VfsWrapper::readFile)
+        .function("listFiles", &VfsWrapper::listFiles)
+        .function("getLastError", &VfsWrapper::getLastError)
+        .property("bytesFetched", &VfsWrapper::getBytesFetched);
+
+    function("createVfs", &createVfs);
+}
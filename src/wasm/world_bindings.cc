@@ -6,16 +6,93 @@
 #include "zenkit/Error.hh"
 #include "zenkit/Mesh.hh"
 #include "zenkit/world/BspTree.hh"
+#include "zenkit/vobs/VirtualObject.hh"
+
+#include <chrono>
+#include <cstddef>
+#include <future>
 
 namespace zenkit::wasm {
 
     // MeshWrapper is now defined in bindings_common.hh
 
+    /// \brief Copies a vector into a new JS typed array of the given type in one call.
+    template <typename T>
+    static emscripten::val to_typed_array(const char* type, const std::vector<T>& data) {
+        emscripten::val js_array = emscripten::val::global(type).new_(data.size());
+        if (!data.empty()) {
+            js_array.call<void>("set", emscripten::val(emscripten::typed_memory_view(data.size(), data.data())));
+        }
+        return js_array;
+    }
+
+    /// \brief Builds a string table passed to JS as one byte array and an array of offsets into it.
+    class StringTable {
+    public:
+        StringTable() : offsets_ {0} {}
+
+        void add(const std::string& value) {
+            data_.insert(data_.end(), value.begin(), value.end());
+            offsets_.push_back(static_cast<uint32_t>(data_.size()));
+        }
+
+        emscripten::val build() const {
+            emscripten::val table = emscripten::val::object();
+            table.set("data", to_typed_array("Uint8Array", data_));
+            table.set("offsets", to_typed_array("Uint32Array", offsets_));
+            return table;
+        }
+
+    private:
+        std::vector<uint8_t> data_;
+        std::vector<uint32_t> offsets_;
+    };
+
+    /// \brief WebAssembly wrapper for zenkit::ObjectArena, see WorldWrapper::setArena.
+    ///
+    /// Loading world after world allocates the objects of each one all over the heap, which fragments it. Worlds
+    /// loaded with an arena allocate their objects in its blocks instead, which are reused by the next world once
+    /// the previous one has been unloaded and the arena reset, so the heap stops growing.
+    class ArenaWrapper {
+    public:
+        explicit ArenaWrapper(size_t block_size) : arena_(ObjectArena::create(block_size)) {}
+
+        /// \brief Rewind the arena so that the next world reuses its blocks.
+        /// \return false if a world using the arena is still loaded, see WorldWrapper::unload.
+        bool reset() {
+            return arena_->reset();
+        }
+
+        [[nodiscard]] size_t getBytesUsed() const {
+            return arena_->bytes_used();
+        }
+
+        [[nodiscard]] size_t getBlockCount() const {
+            return arena_->block_count();
+        }
+
+        /// \brief A reference to the arena which does not prevent resetting it.
+        [[nodiscard]] std::weak_ptr<ObjectArena> handle() const {
+            return arena_;
+        }
+
+    private:
+        std::shared_ptr<ObjectArena> arena_;
+    };
+
+    std::unique_ptr<ArenaWrapper> createArena(double block_size) {
+        return std::make_unique<ArenaWrapper>(static_cast<size_t>(block_size));
+    }
+
     /// \brief WebAssembly wrapper for zenkit::World that mirrors the C++ structure
     class WorldWrapper {
     public:
         WorldWrapper() = default;
-        ~WorldWrapper() = default;
+
+        ~WorldWrapper() {
+            // The worker loading the world refers to it, so it has to finish first.
+            if (pending_.valid()) pending_.wait();
+        }
 
         // Non-copyable but movable
         WorldWrapper(const WorldWrapper&) = delete;
@@ -27,7 +104,7 @@ namespace zenkit::wasm {
         Result<bool> load(uintptr_t data_ptr, size_t length) {
             try {
                 auto reader = create_reader_from_buffer(data_ptr, length);
-                world_.load(reader.get());
+                world_.load(reader.get(), loadOptions());
                 last_error_.clear();
                 return Result<bool>(true);
             } catch (const std::exception& e) {
@@ -45,11 +122,11 @@ namespace zenkit::wasm {
                 
                 if (version == 0) {
                     // Auto-detect version
-                    world_.load(reader.get());
+                    world_.load(reader.get(), loadOptions());
                 } else {
                     // Use specific version
                     auto game_version = static_cast<GameVersion>(version);
-                    world_.load(reader.get(), game_version);
+                    world_.load(reader.get(), game_version, loadOptions());
                 }
                 
                 last_error_.clear();
@@ -65,7 +142,7 @@ namespace zenkit::wasm {
             try {
                 auto reader = create_reader_from_buffer(data_ptr, length);
                 auto game_version = static_cast<GameVersion>(version);
-                world_.load(reader.get(), game_version);
+                world_.load(reader.get(), game_version, loadOptions());
                 last_error_.clear();
                 return Result<bool>(true);
             } catch (const std::exception& e) {
@@ -74,6 +151,89 @@ namespace zenkit::wasm {
             }
         }
 
+        /// \brief Start loading the world from a JavaScript Uint8Array without blocking the calling thread.
+        ///
+        /// Only the data is copied on the calling thread. The world is parsed on a worker in builds with pthreads
+        /// support (ZK_WASM_THREADS) and by the first call to pollLoad() otherwise. The world must not be accessed
+        /// until pollLoad() returns a non-zero value. Used by `loadWorldAsync`.
+        ///
+        /// \param uint8_array JavaScript Uint8Array containing the world data
+        /// \param version Gothic game version (0 = auto-detect, 1 = Gothic 1, 2 = Gothic 2)
+        /// \param parallel Decode the mesh and BSP-tree on additional workers. Requires an explicit version.
+        /// \return false if the world is already being loaded.
+        bool startLoadFromArray(const emscripten::val& uint8_array, int version, bool parallel) {
+            if (pending_.valid()) return false;
+
+            // Copy the whole array at once through a view of the destination.
+            std::vector<std::byte> data(uint8_array["length"].as<size_t>());
+            emscripten::val(emscripten::typed_memory_view(data.size(), reinterpret_cast<uint8_t*>(data.data())))
+                .call<void>("set", uint8_array);
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+            constexpr auto policy = std::launch::async;
+#else
+            constexpr auto policy = std::launch::deferred;
+#endif
+
+            pending_ = std::async(policy, [this, data = std::move(data), version, parallel]() mutable {
+                auto reader = zenkit::Read::from(std::move(data));
+                loadFrom(reader.get(), version, parallel);
+            });
+
+            return true;
+        }
+
+        /// \brief Load the world from the given stream on the calling thread, throwing on errors.
+        /// \see startLoadFromArray
+        void loadFrom(zenkit::Read* reader, int version, bool parallel) {
+            if (version == 0) {
+                world_.load(reader, loadOptions());
+            } else {
+                auto options = loadOptions();
+                options.parallel = parallel;
+                world_.load(reader, static_cast<GameVersion>(version), options);
+            }
+        }
+
+        /// \brief Allocate the objects of worlds loaded from now on in the given arena instead of the heap.
+        ///
+        /// The world does not keep the arena alive. Worlds loaded after the arena has been deleted use the heap.
+        void setArena(const ArenaWrapper& arena) {
+            arena_ = arena.handle();
+        }
+
+        /// \brief Allocate the objects of worlds loaded from now on on the heap again.
+        void clearArena() {
+            arena_.reset();
+        }
+
+        /// \brief Destroy all data of the world, so that the arena it was loaded into can be reset.
+        /// \return false if the world is still being loaded.
+        bool unload() {
+            if (pending_.valid()) return false;
+
+            world_ = World {};
+            last_error_.clear();
+            return true;
+        }
+
+        /// \brief Check on a load started using startLoadFromArray().
+        /// \return 0 while the world is loading, 1 once it has been loaded and -1 if loading failed, in which case
+        ///         getLastError() returns the reason.
+        int pollLoad() {
+            if (!pending_.valid()) return last_error_.empty() ? 1 : -1;
+            if (pending_.wait_for(std::chrono::seconds(0)) == std::future_status::timeout) return 0;
+
+            try {
+                pending_.get();
+                last_error_.clear();
+                return 1;
+            } catch (const std::exception& e) {
+                last_error_ = e.what();
+                return -1;
+            }
+        }
+
         /// \brief Get last error message
         std::string getLastError() const {
             return last_error_;
@@ -102,9 +262,153 @@ namespace zenkit::wasm {
             return std::make_unique<MeshWrapper>(world_.world_mesh);
         }
 
+        /// \brief Build deduplicated, interleaved vertex and index buffers of the world mesh grouped by material.
+        ///
+        /// Everything is copied into a single ArrayBuffer which can be uploaded to the GPU as is: the vertices
+        /// (MeshBufferVertex, see `layout` for the offsets of its fields) followed by the indices at `indexByteOffset`,
+        /// which is always a multiple of 4. Indices are 16-bit wide if all vertices can be addressed using them, see
+        /// `indexFormat`. Each batch is a range of indices drawn using the material `material` of the mesh.
+        ///
+        /// \param optimize Reorder the triangles of each batch for the post-transform vertex cache of the GPU.
+        emscripten::val getRenderBuffers(bool optimize) const {
+            MeshBufferOptions options {};
+            options.optimize_vertex_cache = optimize;
+
+            auto buffers = world_.world_mesh.build_render_buffers(options);
+            using Vertex = MeshBufferVertex;
+
+            auto vertex_bytes = buffers.vertices.size() * sizeof(Vertex);
+            auto index_size = buffers.wide_indices() ? sizeof(uint32_t) : sizeof(uint16_t);
+            auto index_bytes = buffers.index_count() * index_size;
+            auto index_offset = (vertex_bytes + 3) & ~size_t {3};
+
+            std::vector<uint8_t> data(index_offset + index_bytes);
+            if (vertex_bytes != 0) std::memcpy(data.data(), buffers.vertices.data(), vertex_bytes);
+            if (buffers.wide_indices()) {
+                std::memcpy(data.data() + index_offset, buffers.indices32.data(), index_bytes);
+            } else if (index_bytes != 0) {
+                std::memcpy(data.data() + index_offset, buffers.indices16.data(), index_bytes);
+            }
+
+            emscripten::val result = emscripten::val::object();
+            result.set("buffer", to_typed_array("Uint8Array", data)["buffer"]);
+            result.set("vertexCount", buffers.vertices.size());
+            result.set("vertexStride", sizeof(Vertex));
+
+            emscripten::val layout = emscripten::val::object();
+            layout.set("position", offsetof(Vertex, position));
+            layout.set("normal", offsetof(Vertex, normal));
+            layout.set("texture", offsetof(Vertex, texture));
+            layout.set("color", offsetof(Vertex, color));
+            result.set("layout", layout);
+
+            result.set("indexByteOffset", index_offset);
+            result.set("indexCount", buffers.index_count());
+            result.set("indexFormat", std::string {buffers.wide_indices() ? "uint32" : "uint16"});
+
+            emscripten::val batches = emscripten::val::array();
+            for (const auto& batch : buffers.batches) {
+                emscripten::val b = emscripten::val::object();
+                b.set("material", batch.material);
+                b.set("indexOffset", batch.index_offset);
+                b.set("indexCount", batch.index_count);
+                batches.call<void>("push", b);
+            }
+            result.set("batches", batches);
+            return result;
+        }
+
+        /// \brief Export the data of all VObs of the world at once as a struct of typed arrays.
+        ///
+        /// Reading VObs field by field through embind takes one call into WASM per field and VOb. This copies the
+        /// commonly needed fields of all of them in one call instead. VObs are listed depth-first with every VOb
+        /// followed by its children, and the arrays are indexed by the position of a VOb in that list:
+        ///
+        ///  * `positions`: 3 floats per VOb, `rotations`: 9 floats per VOb (column-major),
+        ///  * `bboxes`: 6 floats per VOb (min x, y, z, max x, y, z),
+        ///  * `types`: VirtualObjectType, `visualTypes`: VisualType (255 if there is no visual),
+        ///  * `ids`: VirtualObject::id, `parents`: the index of the parent VOb or -1,
+        ///  * `names` and `visualNames`: string tables, see below.
+        ///
+        /// A string table is an object with `data`, a Uint8Array with all strings concatenated, and `offsets`, a
+        /// Uint32Array with `count + 1` entries, where the i-th string is `data[offsets[i]..offsets[i+1]]`. Strings are
+        /// stored as found in the world file, which is usually Windows-1252 encoded. Use `decodeStringTable` to
+        /// turn a table into an array of strings.
+        emscripten::val getVobData() const {
+            std::vector<VirtualObject const*> vobs;
+            std::vector<int32_t> parents;
+
+            // Pre-order traversal without recursion, since VOb trees can be deep.
+            std::vector<std::pair<VirtualObject const*, int32_t>> stack;
+            for (auto it = world_.world_vobs.rbegin(); it != world_.world_vobs.rend(); ++it) {
+                if (*it != nullptr) stack.emplace_back(it->get(), -1);
+            }
+
+            while (!stack.empty()) {
+                auto [vob, parent] = stack.back();
+                stack.pop_back();
+
+                auto index = static_cast<int32_t>(vobs.size());
+                vobs.push_back(vob);
+                parents.push_back(parent);
+
+                for (auto it = vob->children.rbegin(); it != vob->children.rend(); ++it) {
+                    if (*it != nullptr) stack.emplace_back(it->get(), index);
+                }
+            }
+
+            auto count = vobs.size();
+            std::vector<float> positions(count * 3);
+            std::vector<float> rotations(count * 9);
+            std::vector<float> bboxes(count * 6);
+            std::vector<uint16_t> types(count);
+            std::vector<uint8_t> visual_types(count);
+            std::vector<uint32_t> ids(count);
+
+            StringTable names;
+            StringTable visual_names;
+
+            for (size_t i = 0; i < count; ++i) {
+                auto const& vob = *vobs[i];
+
+                std::memcpy(&positions[i * 3], vob.position.pointer(), 3 * sizeof(float));
+                std::memcpy(&rotations[i * 9], vob.rotation.pointer(), 9 * sizeof(float));
+                std::memcpy(&bboxes[i * 6], vob.bbox.min.pointer(), 3 * sizeof(float));
+                std::memcpy(&bboxes[i * 6 + 3], vob.bbox.max.pointer(), 3 * sizeof(float));
+
+                types[i] = static_cast<uint16_t>(vob.type);
+                visual_types[i] = vob.visual != nullptr ? static_cast<uint8_t>(vob.visual->type) : 0xFF;
+                ids[i] = vob.id;
+
+                names.add(vob.vob_name);
+                visual_names.add(vob.visual != nullptr ? vob.visual->name : std::string {});
+            }
+
+            emscripten::val result = emscripten::val::object();
+            result.set("count", count);
+            result.set("positions", to_typed_array("Float32Array", positions));
+            result.set("rotations", to_typed_array("Float32Array", rotations));
+            result.set("bboxes", to_typed_array("Float32Array", bboxes));
+            result.set("types", to_typed_array("Uint16Array", types));
+            result.set("visualTypes", to_typed_array("Uint8Array", visual_types));
+            result.set("ids", to_typed_array("Uint32Array", ids));
+            result.set("parents", to_typed_array("Int32Array", parents));
+            result.set("names", names.build());
+            result.set("visualNames", visual_names.build());
+            return result;
+        }
+
     private:
+        [[nodiscard]] WorldLoadOptions loadOptions() const {
+            WorldLoadOptions options {};
+            options.arena = arena_.lock();
+            return options;
+        }
+
         World world_;
+        std::weak_ptr<ObjectArena> arena_;
         std::string last_error_;
+        std::future<void> pending_;
     };
 
     /// \brief Factory function for creating World instances
@@ -112,6 +416,107 @@ namespace zenkit::wasm {
         return std::make_unique<WorldWrapper>();
     }
 
+    /// \brief Loads a world from data pushed into it while it is being downloaded. Used by `loadWorldStream`.
+    ///
+    /// In builds with pthreads support (ZK_WASM_THREADS), the world is parsed on a worker as the data arrives, so
+    /// most of it has been parsed by the time the download finishes. Other builds keep the chunks as they arrive and
+    /// parse the world once finish() has been called, on the first call to poll() after it.
+    class WorldStreamLoader {
+    public:
+        /// \param version Gothic game version (0 = auto-detect, 1 = Gothic 1, 2 = Gothic 2)
+        /// \param parallel Decode the mesh and BSP-tree on additional workers. Requires an explicit version.
+        WorldStreamLoader(int version, bool parallel)
+            : world_(std::make_unique<WorldWrapper>()), source_(std::make_unique<ChunkedRead>()) {
+#ifdef __EMSCRIPTEN_PTHREADS__
+            constexpr auto policy = std::launch::async;
+#else
+            constexpr auto policy = std::launch::deferred;
+#endif
+
+            pending_ = std::async(policy, [world = world_.get(), source = source_.get(), version, parallel]() {
+                world->loadFrom(source, version, parallel);
+            });
+        }
+
+        ~WorldStreamLoader() {
+            // Unblock the worker, which refers to both the world and the stream. A deferred load is never started.
+            source_->abort();
+#ifdef __EMSCRIPTEN_PTHREADS__
+            if (pending_.valid()) pending_.wait();
+#endif
+        }
+
+        WorldStreamLoader(const WorldStreamLoader&) = delete;
+        WorldStreamLoader& operator=(const WorldStreamLoader&) = delete;
+
+        /// \brief Append the next chunk of the world's data, copying it from a JavaScript Uint8Array.
+        /// \return false if finish() has already been called.
+        bool push(const emscripten::val& uint8_array) {
+            if (source_->finished()) return false;
+
+            std::vector<std::byte> chunk(uint8_array["length"].as<size_t>());
+            emscripten::val(emscripten::typed_memory_view(chunk.size(), reinterpret_cast<uint8_t*>(chunk.data())))
+                .call<void>("set", uint8_array);
+
+            source_->push(std::move(chunk));
+            return true;
+        }
+
+        /// \brief Mark the end of the world's data.
+        void finish() {
+            source_->finish();
+        }
+
+        /// \brief Check on the load.
+        /// \return 0 while the world is loading, 1 once it has been loaded and -1 if loading failed, in which case
+        ///         getLastError() returns the reason.
+        int poll() {
+            if (!pending_.valid()) return last_error_.empty() ? 1 : -1;
+
+#ifndef __EMSCRIPTEN_PTHREADS__
+            // Without workers, the world can only be parsed once all of its data is available.
+            if (!source_->finished()) return 0;
+#endif
+
+            if (pending_.wait_for(std::chrono::seconds(0)) == std::future_status::timeout) return 0;
+
+            try {
+                pending_.get();
+                last_error_.clear();
+                return 1;
+            } catch (const std::exception& e) {
+                last_error_ = e.what();
+                return -1;
+            }
+        }
+
+        /// \brief Take the loaded world.
+        /// \return null unless poll() has returned 1 and the world has not been taken yet.
+        std::unique_ptr<WorldWrapper> takeWorld() {
+            if (pending_.valid() || !last_error_.empty()) return nullptr;
+            return std::move(world_);
+        }
+
+        /// \return The number of bytes pushed into the loader so far.
+        [[nodiscard]] size_t getBytesReceived() const {
+            return source_->received();
+        }
+
+        std::string getLastError() const {
+            return last_error_;
+        }
+
+    private:
+        std::unique_ptr<WorldWrapper> world_;
+        std::unique_ptr<ChunkedRead> source_;
+        std::future<void> pending_;
+        std::string last_error_;
+    };
+
+    std::unique_ptr<WorldStreamLoader> createWorldStreamLoader(int version, bool parallel) {
+        return std::make_unique<WorldStreamLoader>(version, parallel);
+    }
+
 } // namespace zenkit::wasm
 
 // Emscripten bindings for World class
@@ -124,20 +529,7 @@ EMSCRIPTEN_BINDINGS(zenkit_world) {
         .value("GOTHIC_1", zenkit::GameVersion::GOTHIC_1)
         .value("GOTHIC_2", zenkit::GameVersion::GOTHIC_2);
 
-    // Result template for bool operations
-    class_<Result<bool>>("BoolResult")
-        .property("success", &Result<bool>::success)
-        .property("errorMessage", &Result<bool>::error_message);
-
-    // Bind geometric structures
-    value_object<Vector3>("Vector3")
-        .field("x", &Vector3::x)
-        .field("y", &Vector3::y)  
-        .field("z", &Vector3::z);
-
-    value_object<Vector2>("Vector2")
-        .field("x", &Vector2::x)
-        .field("y", &Vector2::y);
+    // BoolResult, Vector3 and Vector2 are shared with other subsystems, see zenkit_wasm.cc
 
     value_object<VertexFeature>("VertexFeature")
         .field("texture", &VertexFeature::texture)
@@ -184,7 +576,15 @@ EMSCRIPTEN_BINDINGS(zenkit_world) {
         .function("getIndicesTypedArray", &MeshWrapper::getIndicesTypedArray)
         .function("getFeatureIndicesTypedArray", &MeshWrapper::getFeatureIndicesTypedArray)
         .function("getTriFeatureIndicesTypedArray", &MeshWrapper::getTriFeatureIndicesTypedArray)
-        .function("getPolygonMaterialIndicesTypedArray", &MeshWrapper::getPolygonMaterialIndicesTypedArray);
+        .function("getPolygonMaterialIndicesTypedArray", &MeshWrapper::getPolygonMaterialIndicesTypedArray)
+        // Zero-copy variants returning a TypedBuffer, see bindings_common.hh for their lifetime
+        .function("getVerticesView", &MeshWrapper::getVerticesView)
+        .function("getNormalsView", &MeshWrapper::getNormalsView)
+        .function("getUVsView", &MeshWrapper::getUVsView)
+        .function("getIndicesView", &MeshWrapper::getIndicesView)
+        .function("getFeatureIndicesView", &MeshWrapper::getFeatureIndicesView)
+        .function("getTriFeatureIndicesView", &MeshWrapper::getTriFeatureIndicesView)
+        .function("getPolygonMaterialIndicesView", &MeshWrapper::getPolygonMaterialIndicesView);
 
     // Main World wrapper - properties instead of count functions
     class_<WorldWrapper>("World")
@@ -192,6 +592,11 @@ EMSCRIPTEN_BINDINGS(zenkit_world) {
         .function("load", &WorldWrapper::load)
         .function("loadFromArray", &WorldWrapper::loadFromArray)
         .function("loadWithVersion", &WorldWrapper::loadWithVersion)
+        .function("startLoadFromArray", &WorldWrapper::startLoadFromArray)
+        .function("pollLoad", &WorldWrapper::pollLoad)
+        .function("setArena", &WorldWrapper::setArena)
+        .function("clearArena", &WorldWrapper::clearArena)
+        .function("unload", &WorldWrapper::unload)
 
         // Error handling methods
         .function("getLastError", &WorldWrapper::getLastError)
@@ -204,8 +609,31 @@ EMSCRIPTEN_BINDINGS(zenkit_world) {
         .property("hasSkyController", &WorldWrapper::hasSkyController)
 
         // Mesh access as property
-        .property("mesh", &WorldWrapper::getMesh, allow_raw_pointers());
+        .property("mesh", &WorldWrapper::getMesh, allow_raw_pointers())
+
+        // Bulk exports, see WorldWrapper::getRenderBuffers and WorldWrapper::getVobData
+        .function("getRenderBuffers", &WorldWrapper::getRenderBuffers)
+        .function("getVobData", &WorldWrapper::getVobData);
 
     // Factory function
     function("createWorld", &createWorld);
+
+    // Arenas for loading many worlds one after the other, see ArenaWrapper
+    class_<ArenaWrapper>("Arena")
+        .function("reset", &ArenaWrapper::reset)
+        .property("bytesUsed", &ArenaWrapper::getBytesUsed)
+        .property("blockCount", &ArenaWrapper::getBlockCount);
+
+    function("createArena", &createArena);
+
+    // Loading worlds while they are being downloaded, see `loadWorldStream`
+    class_<WorldStreamLoader>("WorldStreamLoader")
+        .function("push", &WorldStreamLoader::push)
+        .function("finish", &WorldStreamLoader::finish)
+        .function("poll", &WorldStreamLoader::poll)
+        .function("takeWorld", &WorldStreamLoader::takeWorld)
+        .function("getLastError", &WorldStreamLoader::getLastError)
+        .property("bytesReceived", &WorldStreamLoader::getBytesReceived);
+
+    function("createWorldStreamLoader", &createWorldStreamLoader);
 }
@@ -0,0 +1,81 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+
+// Loads the fastest ZenKit build supported by the current engine. The SIMD build (zenkit-simd.mjs, built with
+// ZK_WASM_SIMD) decodes textures and builds mesh buffers faster, but fails to compile on engines without WebAssembly
+// SIMD support, so the portable build (zenkit.mjs) is used for those and whenever the SIMD build is not shipped.
+
+// A module with a single function containing `i8x16.splat` and `i8x16.popcnt`, which only validates with SIMD support.
+const SIMD_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+]);
+
+/**
+ * Check whether the current engine supports 128-bit WebAssembly SIMD instructions.
+ *
+ * @returns {boolean} `true` if the SIMD build of ZenKit can be used.
+ */
+export function hasWasmSimd() {
+    try {
+        return typeof WebAssembly === 'object' && WebAssembly.validate(SIMD_PROBE);
+    } catch {
+        return false;
+    }
+}
+
+// Imports the factory of a build next to this file, or returns null if it is not shipped.
+async function importFactory(name) {
+    try {
+        return (await import(`./${name}.mjs`)).default;
+    } catch {
+        return null;
+    }
+}
+
+/**
+ * Instantiate ZenKit, preferring the SIMD build if the engine supports it.
+ *
+ * Takes the same module arguments as the factories exported by zenkit.mjs and zenkit-simd.mjs. Check
+ * `getLibraryInfo().hasSimd` of the result to find out which build was loaded.
+ *
+ * @param {object} [moduleArg] Emscripten module arguments, e.g. `locateFile`.
+ * @param {{simd?: boolean}} [options] Set `simd` to force or prevent using the SIMD build.
+ * @returns {Promise<object>} The ZenKit module.
+ */
+export default async function ZenKit(moduleArg = {}, options = {}) {
+    if (options.simd ?? hasWasmSimd()) {
+        // The SIMD build is optional, fall back to the portable one.
+        const factory = await importFactory('zenkit-simd');
+        if (factory !== null) {
+            return factory(moduleArg);
+        }
+    }
+
+    return (await import('./zenkit.mjs')).default(moduleArg);
+}
+
+/**
+ * Instantiate a minimal ZenKit module containing only the bindings of one subsystem.
+ *
+ * The modules (zenkit-texture.mjs, zenkit-mesh.mjs, zenkit-world.mjs, zenkit-archive.mjs and zenkit-vfs.mjs) are built
+ * with ZK_WASM_SPLIT and are much smaller than the full build, so they download and compile faster. Each module is a
+ * separate instance with its own memory, so objects cannot be shared between modules, only data such as Uint8Arrays.
+ * Falls back to the full build if the module is not shipped. Check `getLibraryInfo().module` of the result to find
+ * out which module was loaded.
+ *
+ * @param {'texture' | 'mesh' | 'world' | 'archive' | 'vfs'} name The subsystem. The mesh module contains the texture
+ *        bindings as well.
+ * @param {object} [moduleArg] Emscripten module arguments, e.g. `locateFile`.
+ * @param {{simd?: boolean}} [options] Set `simd` to force or prevent using the SIMD build.
+ * @returns {Promise<object>} The ZenKit module.
+ */
+export async function loadZenKitModule(name, moduleArg = {}, options = {}) {
+    const simd = options.simd ?? hasWasmSimd();
+    const factory = (simd ? await importFactory(`zenkit-${name}-simd`) : null) ?? await importFactory(`zenkit-${name}`);
+
+    if (factory !== null) {
+        return factory(moduleArg);
+    }
+
+    return ZenKit(moduleArg, { simd });
+}
@@ -0,0 +1,173 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+
+// Appended to the generated module using `--post-js`, so `Module` refers to the module instance.
+
+/**
+ * Load a world without blocking the calling thread.
+ *
+ * In builds with pthreads support (ZK_WASM_THREADS), the world is parsed on a worker and the returned promise
+ * resolves once it is done. Other builds parse the world on the calling thread right after this function returns.
+ *
+ * @param {Uint8Array} bytes The world data.
+ * @param {{version?: number, parallel?: boolean}} [options] The game version (0 = auto-detect, 1 = Gothic 1,
+ *        2 = Gothic 2) and whether to decode the mesh and BSP-tree on additional workers, which needs a version.
+ * @returns {Promise<World>} The loaded world. Call `delete()` on it once it is no longer needed.
+ */
+Module['loadWorldAsync'] = function (bytes, options = {}) {
+    const world = Module['createWorld']();
+    if (!world.startLoadFromArray(bytes, options.version ?? 0, options.parallel ?? false)) {
+        world.delete();
+        return Promise.reject(new Error('Failed to start loading the world'));
+    }
+
+    return new Promise((resolve, reject) => {
+        const poll = () => {
+            const state = world.pollLoad();
+            if (state === 0) {
+                setTimeout(poll, 1);
+            } else if (state > 0) {
+                resolve(world);
+            } else {
+                const error = new Error(world.getLastError());
+                world.delete();
+                reject(error);
+            }
+        };
+
+        setTimeout(poll, 0);
+    });
+};
+
+/**
+ * Load a world while it is being downloaded.
+ *
+ * The chunks of the stream are handed to ZenKit as they arrive instead of being collected into one array first. In
+ * builds with pthreads support (ZK_WASM_THREADS), the world is parsed on a worker while the rest of it is still being
+ * downloaded. Other builds parse it once the stream has ended.
+ *
+ * @param {ReadableStream<Uint8Array>} stream The world data, e.g. the `body` of a `fetch` response.
+ * @param {{version?: number, parallel?: boolean, onProgress?: (bytesReceived: number) => void}} [options] The game
+ *        version and `parallel` as for `loadWorldAsync`, and a function called after each chunk has been received.
+ * @returns {Promise<World>} The loaded world. Call `delete()` on it once it is no longer needed.
+ */
+Module['loadWorldStream'] = async function (stream, options = {}) {
+    const loader = Module['createWorldStreamLoader'](options.version ?? 0, options.parallel ?? false);
+
+    try {
+        const reader = stream.getReader();
+
+        for (;;) {
+            const { done, value } = await reader.read();
+            if (done) break;
+
+            loader.push(value);
+            options.onProgress?.(loader.bytesReceived);
+
+            // Stop downloading if the data received so far is already known to be invalid.
+            if (loader.poll() < 0) {
+                await reader.cancel();
+                break;
+            }
+        }
+
+        loader.finish();
+
+        await new Promise((resolve, reject) => {
+            const poll = () => {
+                const state = loader.poll();
+                if (state === 0) {
+                    setTimeout(poll, 1);
+                } else if (state > 0) {
+                    resolve();
+                } else {
+                    reject(new Error(loader.getLastError()));
+                }
+            };
+
+            poll();
+        });
+
+        return loader.takeWorld();
+    } finally {
+        loader.delete();
+    }
+};
+
+/**
+ * Create a callback fetching byte ranges of a file using synchronous HTTP range requests, for `Vfs.mountRemoteDisk`.
+ *
+ * Synchronous requests block the calling thread until they complete, so prefer reading files of remote disks from a
+ * worker. Binary responses of synchronous requests are decoded from a string, since the main thread does not allow
+ * setting their `responseType`.
+ *
+ * @param {string} url The URL of the file. The server has to support range requests.
+ * @returns {(offset: number, length: number) => Uint8Array | null} The callback.
+ */
+Module['createRangeFetcher'] = function (url) {
+    return (offset, length) => {
+        try {
+            const xhr = new XMLHttpRequest();
+            xhr.open('GET', url, false);
+            xhr.setRequestHeader('Range', `bytes=${offset}-${offset + length - 1}`);
+            xhr.overrideMimeType('text/plain; charset=x-user-defined');
+            xhr.send();
+
+            if (xhr.status !== 206 || xhr.responseText.length !== length) return null;
+
+            const bytes = new Uint8Array(length);
+            for (let i = 0; i < length; ++i) {
+                bytes[i] = xhr.responseText.charCodeAt(i) & 0xFF;
+            }
+
+            return bytes;
+        } catch {
+            return null;
+        }
+    };
+};
+
+/**
+ * Mount a VDF disk served over HTTP into a Vfs without downloading it completely.
+ *
+ * Only the catalog of the disk is downloaded while mounting. Files are downloaded when they are read using
+ * `vfs.readFile`, in blocks which are kept in an LRU cache.
+ *
+ * @param {Vfs} vfs The Vfs to mount the disk into, see `createVfs`.
+ * @param {string} url The URL of the disk. The server has to support range requests.
+ * @param {{blockSize?: number, cacheBlocks?: number}} [options] The minimum number of bytes per request (default
+ *        64 KiB) and the number of blocks to keep in memory (default 256).
+ * @returns {Promise<void>} Resolves once the disk has been mounted.
+ */
+Module['mountRemoteVdf'] = async function (vfs, url, options = {}) {
+    const head = await fetch(url, { method: 'HEAD' });
+    const size = Number(head.headers.get('Content-Length'));
+    if (!head.ok || !Number.isFinite(size) || size <= 0) {
+        throw new Error(`Failed to determine the size of ${url}`);
+    }
+
+    const fetcher = Module['createRangeFetcher'](url);
+    if (!vfs.mountRemoteDisk(size, fetcher, options.blockSize ?? 64 * 1024, options.cacheBlocks ?? 256)) {
+        throw new Error(vfs.getLastError());
+    }
+};
+
+/**
+ * Decode a string table returned by `World.getVobData` into an array of strings.
+ *
+ * @param {{data: Uint8Array, offsets: Uint32Array}} table The string table.
+ * @param {string} [encoding] The encoding of the strings, Windows-1252 by default like the game's files.
+ * @returns {string[]} The strings, in the same order as the VObs.
+ */
+Module['decodeStringTable'] = function (table, encoding = 'windows-1252') {
+    const decoder = new TextDecoder(encoding);
+    const strings = new Array(table.offsets.length - 1);
+
+    for (let i = 0; i < strings.length; ++i) {
+        const begin = table.offsets[i];
+        const end = table.offsets[i + 1];
+        strings[i] = begin === end ? '' : decoder.decode(table.data.subarray(begin, end));
+    }
+
+    return strings;
+};
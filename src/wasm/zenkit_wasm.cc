@@ -3,14 +3,20 @@
 /// \file zenkit_wasm.cc
 /// \brief Main WebAssembly entry point and coordinator for ZenKit bindings
 ///
-/// This file serves as the main coordinator for all ZenKit WebAssembly bindings.
-/// Individual class bindings are organized in separate files for maintainability.
+/// This file serves as the main coordinator for all ZenKit WebAssembly bindings and contains the bindings shared by
+/// all of them. It is linked into every module. The bindings of each subsystem are organized in separate files, so
+/// that ZK_WASM_SPLIT can build a minimal module containing only one of them, e.g. `zenkit-texture.js`.
 
 #include "bindings_common.hh"
 
 #include <emscripten/bind.h>
 #include <iostream>
 
+// The subsystems of this module, set by CMake for each module built.
+#ifndef ZK_WASM_MODULE
+    #define ZK_WASM_MODULE "full"
+#endif
+
 namespace zenkit::wasm {
 
     /// \brief Get ZenKit library version
@@ -22,7 +28,9 @@ namespace zenkit::wasm {
     struct LibraryInfo {
         std::string version;
         std::string build_type;
+        std::string module;
         bool has_mmap;
+        bool has_simd;
         bool debug_build;
     };
 
@@ -30,6 +38,7 @@ namespace zenkit::wasm {
     LibraryInfo getLibraryInfo() {
         LibraryInfo info;
         info.version = "1.3.0";
+        info.module = ZK_WASM_MODULE;
         #ifdef NDEBUG
             info.debug_build = false;
             info.build_type = "Release";
@@ -43,6 +52,12 @@ namespace zenkit::wasm {
         #else
             info.has_mmap = false;
         #endif
+
+        #ifdef __wasm_simd128__
+            info.has_simd = true;
+        #else
+            info.has_simd = false;
+        #endif
         
         return info;
     }
@@ -57,76 +72,34 @@ EMSCRIPTEN_BINDINGS(zenkit_main) {
     class_<LibraryInfo>("LibraryInfo")
         .property("version", &LibraryInfo::version)
         .property("buildType", &LibraryInfo::build_type)
+        .property("module", &LibraryInfo::module)
         .property("hasMmap", &LibraryInfo::has_mmap)
+        .property("hasSimd", &LibraryInfo::has_simd)
         .property("debugBuild", &LibraryInfo::debug_build);
 
     // Core library functions
     function("getZenKitVersion", &getZenKitVersion);
     function("getLibraryInfo", &getLibraryInfo);
 
-    // Texture bindings
-    class_<TextureWrapper>("Texture")
-        .constructor<>()
-        .function("loadFromArray", &TextureWrapper::loadFromArray)
-        .property("width", &TextureWrapper::width)
-        .property("height", &TextureWrapper::height)
-        .property("mipmaps", &TextureWrapper::mipmaps)
-        .function("asRgba8", &TextureWrapper::asRgba8);
+    // Typed arrays owned by the module, see TypedBuffer
+    class_<TypedBuffer>("TypedBuffer")
+        .function("view", &TypedBuffer::view)
+        .function("dispose", &TypedBuffer::dispose)
+        .property("length", &TypedBuffer::length)
+        .property("byteLength", &TypedBuffer::byteLength);
+
+    // Result template for bool operations
+    class_<Result<bool>>("BoolResult")
+        .property("success", &Result<bool>::success)
+        .property("errorMessage", &Result<bool>::error_message);
+
+    // Geometric structures shared by the archive and world bindings
+    value_object<Vector3>("Vector3")
+        .field("x", &Vector3::x)
+        .field("y", &Vector3::y)
+        .field("z", &Vector3::z);
+
+    value_object<Vector2>("Vector2")
+        .field("x", &Vector2::x)
+        .field("y", &Vector2::y);
 }
-
-// Archive reading bindings
-EMSCRIPTEN_BINDINGS(zenkit_archive) {
-    using namespace zenkit::wasm;
-    using namespace emscripten;
-
-    // Color data structure
-    value_object<ColorData>("ColorData")
-        .field("r", &ColorData::r)
-        .field("g", &ColorData::g)
-        .field("b", &ColorData::b)
-        .field("a", &ColorData::a);
-
-    // Archive object data structure
-    value_object<ArchiveObjectData>("ArchiveObjectData")
-        .field("objectName", &ArchiveObjectData::object_name)
-        .field("className", &ArchiveObjectData::class_name)
-        .field("version", &ArchiveObjectData::version)
-        .field("index", &ArchiveObjectData::index);
-
-    // Bounding box data structure
-    value_object<BoundingBoxData>("BoundingBoxData")
-        .field("min", &BoundingBoxData::min)
-        .field("max", &BoundingBoxData::max);
-
-    // Matrix 3x3 data structure
-    class_<Matrix3x3Data>("Matrix3x3Data")
-        .function("get", &Matrix3x3Data::get);
-
-    // Raw data result structure
-    class_<RawDataResult>("RawDataResult")
-        .property("data", &RawDataResult::data)
-        .function("readUbyte", &RawDataResult::read_ubyte);
-
-    // ReadArchive wrapper
-    class_<ReadArchiveWrapper>("ReadArchive")
-        .function("readObjectBegin", &ReadArchiveWrapper::read_object_begin)
-        .function("readObjectEnd", &ReadArchiveWrapper::read_object_end)
-        .function("readString", &ReadArchiveWrapper::read_string)
-        .function("readInt", &ReadArchiveWrapper::read_int)
-        .function("readFloat", &ReadArchiveWrapper::read_float)
-        .function("readByte", &ReadArchiveWrapper::read_byte)
-        .function("readWord", &ReadArchiveWrapper::read_word)
-        .function("readEnum", &ReadArchiveWrapper::read_enum)
-        .function("readBool", &ReadArchiveWrapper::read_bool)
-        .function("readColor", &ReadArchiveWrapper::read_color)
-        .function("readVec3", &ReadArchiveWrapper::read_vec3)
-        .function("readVec2", &ReadArchiveWrapper::read_vec2)
-        .function("readBbox", &ReadArchiveWrapper::read_bbox)
-        .function("readMat3x3", &ReadArchiveWrapper::read_mat3x3)
-        .function("readRaw", &ReadArchiveWrapper::read_raw)
-        .function("skipObject", &ReadArchiveWrapper::skip_object);
-
-    // Factory function
-    function("createReadArchive", &create_read_archive, allow_raw_pointers());
-    function("createReadArchiveFromArray", &create_read_archive_from_js_array, allow_raw_pointers());
-}
\ No newline at end of file
@@ -1,11 +1,17 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include "zenkit/world/BspTree.hh"
+#include "zenkit/Mesh.hh"
 #include "zenkit/Stream.hh"
 
+#include "../Cooked.hh"
 #include "../Internal.hh"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <map>
 
 namespace zenkit {
 	static constexpr auto version_g1 = 0x2090000;
@@ -20,7 +26,8 @@ namespace zenkit {
 		END = 0xC0FF
 	};
 
-	static void _parse_bsp_nodes(Read* in,
+	template <typename R>
+	static void _parse_bsp_nodes(R* in,
 	                             std::vector<BspNode>& nodes,
 	                             std::vector<std::uint64_t>& indices,
 	                             std::uint32_t version,
@@ -30,7 +37,8 @@ namespace zenkit {
 
 		auto& node = nodes.emplace_back();
 		node.parent_index = parent_index;
-		node.bbox.load(in);
+		node.bbox.min = in->read_vec3();
+		node.bbox.max = in->read_vec3();
 		node.polygon_index = in->read_uint();
 		node.polygon_count = in->read_uint();
 
@@ -72,6 +80,10 @@ namespace zenkit {
 	}
 
 	void BspTree::load(Read* r, std::uint32_t version) {
+		ZKTRACE_ZONE(zone, "BspTree.load");
+		MemoryScope memory {MemoryCategory::MESH};
+		auto begin = r->tell();
+
 		proto::read_chunked<BspChunkType>(r, "BspTree", [this, version](Read* c, BspChunkType type) {
 			ZKLOGI("BspTree", "Parsing chunk %x", static_cast<std::uint16_t>(type));
 
@@ -83,19 +95,25 @@ namespace zenkit {
 				break;
 			case BspChunkType::POLYGONS:
 				this->polygon_indices.resize(c->read_uint());
-
-				for (uint32_t& index : this->polygon_indices) {
-					index = c->read_uint();
-				}
+				c->read_uint_array(this->polygon_indices.data(), this->polygon_indices.size());
 				break;
 			case BspChunkType::TREE: {
+				ZKTRACE_ZONE(chunk_zone, "BspTree.nodes");
+				auto chunk_begin = c->tell();
+
 				uint32_t node_count = c->read_uint();
 				uint32_t leaf_count = c->read_uint();
 
 				this->nodes.reserve(node_count);
 				this->leaf_node_indices.reserve(leaf_count);
 
-				_parse_bsp_nodes(c, this->nodes, this->leaf_node_indices, version, -1, node_count == 1);
+				// The node tree is by far the largest part of the BSP-tree. Parse it directly from memory if we can.
+				if (auto span = c->as_contiguous(); span.data() != nullptr) {
+					_parse_bsp_nodes(&span, this->nodes, this->leaf_node_indices, version, -1, node_count == 1);
+					c->seek(static_cast<ssize_t>(span.tell()), Whence::CUR);
+				} else {
+					_parse_bsp_nodes(c, this->nodes, this->leaf_node_indices, version, -1, node_count == 1);
+				}
 
 				for (auto idx : this->leaf_node_indices) {
 					auto& node = this->nodes[idx];
@@ -105,13 +123,12 @@ namespace zenkit {
 					}
 				}
 				std::sort(this->leaf_polygons.begin(), this->leaf_polygons.end());
+				ZKTRACE_BYTES(chunk_zone, c->tell() - chunk_begin);
 				break;
 			}
 			case BspChunkType::LIGHT: {
 				this->light_points.resize(this->leaf_node_indices.size());
-				for (auto& light_point : this->light_points) {
-					light_point = c->read_vec3();
-				}
+				c->read_vec3_array(this->light_points.data(), this->light_points.size());
 				break;
 			}
 			case BspChunkType::OUTDOORS: {
@@ -129,21 +146,13 @@ namespace zenkit {
 					sector.node_indices.resize(node_count);
 					sector.portal_polygon_indices.resize(polygon_count);
 
-					for (std::uint32_t j = 0; j < node_count; ++j) {
-						sector.node_indices[j] = c->read_uint();
-					}
-
-					for (std::uint32_t j = 0; j < polygon_count; ++j) {
-						sector.portal_polygon_indices[j] = c->read_uint();
-					}
+					c->read_uint_array(sector.node_indices.data(), node_count);
+					c->read_uint_array(sector.portal_polygon_indices.data(), polygon_count);
 				}
 
 				auto portal_count = c->read_uint();
 				this->portal_polygon_indices.resize(portal_count);
-
-				for (std::uint32_t i = 0; i < portal_count; ++i) {
-					this->portal_polygon_indices[i] = c->read_uint();
-				}
+				c->read_uint_array(this->portal_polygon_indices.data(), portal_count);
 				break;
 			}
 			case BspChunkType::END:
@@ -155,6 +164,9 @@ namespace zenkit {
 
 			return false;
 		});
+
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+		this->build_traversal();
 	}
 
 	void BspTree::save(Write* w, GameVersion version) const {
@@ -237,4 +249,620 @@ namespace zenkit {
 			wr->write_ubyte(0); // padding
 		});
 	}
+
+	void BspTree::save_cooked(Write* w) const {
+		w->write_uint(static_cast<std::uint32_t>(this->mode));
+		detail::write_cooked(w, this->polygon_indices);
+		detail::write_cooked(w, this->leaf_polygons);
+		detail::write_cooked(w, this->light_points);
+		detail::write_cooked(w, this->portal_polygon_indices);
+		detail::write_cooked(w, this->nodes);
+		detail::write_cooked(w, this->leaf_node_indices);
+
+		w->write_uint(static_cast<std::uint32_t>(this->sectors.size()));
+		for (auto& sector : this->sectors) {
+			detail::write_cooked(w, sector.name);
+			detail::write_cooked(w, sector.node_indices);
+			detail::write_cooked(w, sector.portal_polygon_indices);
+		}
+
+		w->write_uint(this->traversal.root);
+		detail::write_cooked(w, this->traversal.nodes);
+		detail::write_cooked(w, this->traversal.leaves);
+	}
+
+	void BspTree::load_cooked(Read* r) {
+		ZKTRACE_ZONE(zone, "BspTree.load_cooked");
+		MemoryScope memory {MemoryCategory::MESH};
+		auto begin = r->tell();
+
+		this->mode = static_cast<BspTreeType>(r->read_uint());
+		detail::read_cooked(r, this->polygon_indices);
+		detail::read_cooked(r, this->leaf_polygons);
+		detail::read_cooked(r, this->light_points);
+		detail::read_cooked(r, this->portal_polygon_indices);
+		detail::read_cooked(r, this->nodes);
+		detail::read_cooked(r, this->leaf_node_indices);
+
+		this->sectors.resize(r->read_uint());
+		for (auto& sector : this->sectors) {
+			detail::read_cooked(r, sector.name);
+			detail::read_cooked(r, sector.node_indices);
+			detail::read_cooked(r, sector.portal_polygon_indices);
+		}
+
+		this->traversal.root = r->read_uint();
+		detail::read_cooked(r, this->traversal.nodes);
+		detail::read_cooked(r, this->traversal.leaves);
+		ZKTRACE_BYTES(zone, r->tell() - begin);
+	}
+
+	static Vec3 sub(Vec3 const& a, Vec3 const& b) {
+		return {a.x - b.x, a.y - b.y, a.z - b.z};
+	}
+
+	static Vec3 add(Vec3 const& a, Vec3 const& b) {
+		return {a.x + b.x, a.y + b.y, a.z + b.z};
+	}
+
+	static float dot(Vec3 const& a, Vec3 const& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	static Vec3 cross(Vec3 const& a, Vec3 const& b) {
+		return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+	}
+
+	/// \return The signed distance of \p point to \p plane. Positive values are in front of it.
+	static float plane_distance(Vec4 const& plane, Vec3 const& point) {
+		return plane.x * point.x + plane.y * point.y + plane.z * point.z - plane.w;
+	}
+
+	/// \brief Builds the traversal of the given nodes, see BspTraversal.
+	static void build_traversal(std::vector<BspNode> const& nodes, BspTraversal& traversal) {
+		traversal.root = BspTraversal::NONE;
+		traversal.nodes.clear();
+		traversal.leaves.clear();
+		if (nodes.empty()) return;
+
+		struct Entry {
+			std::int32_t index;
+			std::uint32_t parent;
+			bool front;
+		};
+
+		traversal.nodes.reserve(nodes.size());
+		std::vector<Entry> stack {{0, BspTraversal::NONE, true}};
+
+		// Links are only followed as often as there are nodes, in case they don't form a tree.
+		for (auto visited = 0u; !stack.empty() && visited < nodes.size(); ++visited) {
+			auto entry = stack.back();
+			stack.pop_back();
+
+			auto const& node = nodes[static_cast<std::uint32_t>(entry.index)];
+			std::uint32_t code;
+
+			if (node.is_leaf()) {
+				code = BspTraversal::LEAF | static_cast<std::uint32_t>(traversal.leaves.size());
+				traversal.leaves.push_back(static_cast<std::uint32_t>(entry.index));
+			} else {
+				code = static_cast<std::uint32_t>(traversal.nodes.size());
+				traversal.nodes.push_back({node.plane, BspTraversal::NONE, BspTraversal::NONE});
+
+				auto exists = [&](std::int32_t i) { return i >= 0 && static_cast<std::size_t>(i) < nodes.size(); };
+
+				// The front child is pushed last, so that it directly follows its parent.
+				if (exists(node.back_index)) stack.push_back({node.back_index, code, false});
+				if (exists(node.front_index)) stack.push_back({node.front_index, code, true});
+			}
+
+			if (entry.parent == BspTraversal::NONE) {
+				traversal.root = code;
+			} else {
+				auto& parent = traversal.nodes[entry.parent];
+				(entry.front ? parent.front : parent.back) = code;
+			}
+		}
+	}
+
+	void BspTree::build_traversal() {
+		zenkit::build_traversal(this->nodes, this->traversal);
+	}
+
+	/// \return The traversal of \p tree, building it into \p scratch if it does not match the nodes of the tree.
+	static BspTraversal const& get_traversal(BspTree const& tree, BspTraversal& scratch) {
+		auto const& traversal = tree.traversal;
+		if (traversal.nodes.size() + traversal.leaves.size() == tree.nodes.size()) return traversal;
+
+		build_traversal(tree.nodes, scratch);
+		return scratch;
+	}
+
+	std::int32_t BspTree::find_leaf(Vec3 const& point) const noexcept {
+		BspTraversal scratch;
+		auto const& traversal = get_traversal(*this, scratch);
+
+		auto code = traversal.root;
+		while (code != BspTraversal::NONE && (code & BspTraversal::LEAF) == 0) {
+			auto const& node = traversal.nodes[code];
+			code = plane_distance(node.plane, point) >= 0 ? node.front : node.back;
+		}
+
+		if (code == BspTraversal::NONE) return -1;
+		return static_cast<std::int32_t>(traversal.leaves[code & ~BspTraversal::LEAF]);
+	}
+
+	BspSector const* BspTree::sector_at(Vec3 const& point) const noexcept {
+		auto leaf = this->find_leaf(point);
+		if (leaf == -1) return nullptr;
+
+		for (auto const& sector : this->sectors) {
+			auto it = std::find(sector.node_indices.begin(), sector.node_indices.end(), static_cast<uint32_t>(leaf));
+			if (it != sector.node_indices.end()) return &sector;
+		}
+
+		return nullptr;
+	}
+
+	void BspTree::cull(Frustum const& frustum, std::vector<std::uint32_t>& leaves) const {
+		leaves.clear();
+		if (this->nodes.empty()) return;
+
+		struct Entry {
+			std::int32_t index;
+			std::uint8_t mask;
+		};
+
+		std::vector<Entry> stack {{0, 0x3F}};
+		auto exists = [&](std::int32_t i) { return i >= 0 && static_cast<std::size_t>(i) < this->nodes.size(); };
+
+		// Links are only followed as often as there are nodes, in case they don't form a tree.
+		for (auto visited = 0u; !stack.empty() && visited < this->nodes.size(); ++visited) {
+			auto entry = stack.back();
+			stack.pop_back();
+
+			auto const& node = this->nodes[static_cast<std::uint32_t>(entry.index)];
+			if (entry.mask != 0 && !frustum.test(node.bbox, entry.mask)) continue;
+
+			if (node.is_leaf()) {
+				leaves.push_back(static_cast<std::uint32_t>(entry.index));
+				continue;
+			}
+
+			if (exists(node.back_index)) stack.push_back({node.back_index, entry.mask});
+			if (exists(node.front_index)) stack.push_back({node.front_index, entry.mask});
+		}
+	}
+
+	namespace {
+		/// \brief The state of a ray cast through a BspTree.
+		struct BspRaycast {
+			BspTree const& tree;
+			BspTraversal const& traversal;
+			Mesh const& mesh;
+			Vec3 origin;
+			Vec3 direction;
+			float max_distance;
+			std::optional<BspRaycastHit> hit;
+
+			/// \brief Tests the ray against all polygons of the given leaf node and keeps the closest hit.
+			///
+			/// Polygons may reach into other leaves, so they are hit anywhere along the ray, not just within the
+			/// part of it passing through the leaf.
+			void test_leaf(std::uint32_t index) {
+				auto const& node = tree.nodes[index];
+
+				for (auto i = 0u; i < node.polygon_count; ++i) {
+					auto polygon_index = node.polygon_index + i;
+					if (polygon_index >= tree.polygon_indices.size()) break;
+
+					auto polygon = tree.polygon_indices[polygon_index];
+					if (polygon >= mesh.geometry.size()) continue;
+
+					// These polygons are not part of the triangulated mesh either, see Mesh::triangulate.
+					auto const& geometry = mesh.geometry[polygon];
+					if (geometry.index_count < 3 || geometry.flags.is_portal || geometry.flags.is_ghost_occluder ||
+					    geometry.flags.is_outdoor) {
+						continue;
+					}
+
+					auto max = hit ? hit->distance : max_distance;
+					auto distance = test_polygon(geometry, max);
+					if (distance < max) {
+						hit = BspRaycastHit {distance, add(origin, direction * distance), polygon, index};
+					}
+				}
+			}
+
+			/// \return The distance at which the ray hits the triangle fan of \p polygon or \p max if it does not
+			///         hit it any closer.
+			[[nodiscard]] float test_polygon(Polygon const& polygon, float max) const {
+				auto vertex = [&](std::size_t i) -> Vec3 const& {
+					return mesh.vertices[mesh.polygon_vertex_indices[polygon.index_offset + i]];
+				};
+
+				if (polygon.index_offset + polygon.index_count > mesh.polygon_vertex_indices.size()) return max;
+				for (auto i = 0u; i < polygon.index_count; ++i) {
+					if (mesh.polygon_vertex_indices[polygon.index_offset + i] >= mesh.vertices.size()) return max;
+				}
+
+				// Möller-Trumbore intersection of each triangle of the fan.
+				for (auto i = 2u; i < polygon.index_count; ++i) {
+					auto const& a = vertex(0);
+					auto e1 = sub(vertex(i - 1), a);
+					auto e2 = sub(vertex(i), a);
+
+					auto p = cross(direction, e2);
+					auto det = dot(e1, p);
+					if (std::abs(det) < 1e-8f) continue;
+
+					auto inv = 1.0f / det;
+					auto s = sub(origin, a);
+					auto u = dot(s, p) * inv;
+					if (u < 0 || u > 1) continue;
+
+					auto q = cross(s, e1);
+					auto v = dot(direction, q) * inv;
+					if (v < 0 || u + v > 1) continue;
+
+					auto t = dot(e2, q) * inv;
+					if (t >= 0 && t < max) max = t;
+				}
+
+				return max;
+			}
+
+			/// \brief Visits the nodes below \p code the ray passes through between \p t0 and \p t1 from front to
+			///        back until a polygon is hit.
+			void visit(std::uint32_t code, float t0, float t1) {
+				if (code == BspTraversal::NONE) return;
+
+				if ((code & BspTraversal::LEAF) != 0) {
+					test_leaf(traversal.leaves[code & ~BspTraversal::LEAF]);
+					return;
+				}
+
+				auto const& node = traversal.nodes[code];
+				auto d0 = plane_distance(node.plane, add(origin, direction * t0));
+				auto d1 = plane_distance(node.plane, add(origin, direction * t1));
+
+				if (d0 >= 0 && d1 >= 0) return visit(node.front, t0, t1);
+				if (d0 < 0 && d1 < 0) return visit(node.back, t0, t1);
+
+				// The ray crosses the plane, so the side of its start is visited first.
+				auto split = t0 + (t1 - t0) * d0 / (d0 - d1);
+				visit(d0 >= 0 ? node.front : node.back, t0, split);
+				if (hit && hit->distance <= split) return;
+				visit(d0 >= 0 ? node.back : node.front, split, t1);
+			}
+		};
+	} // namespace
+
+	std::optional<BspRaycastHit>
+	BspTree::raycast(Mesh const& mesh, Vec3 const& origin, Vec3 const& direction, float max_distance) const {
+		auto length = std::sqrt(dot(direction, direction));
+		if (this->nodes.empty() || length == 0 || !(max_distance > 0)) return std::nullopt;
+
+		BspTraversal scratch;
+		auto const& traversal = get_traversal(*this, scratch);
+
+		BspRaycast ray {*this, traversal, mesh, origin, direction * (1.0f / length), max_distance, std::nullopt};
+		ray.visit(traversal.root, 0, max_distance);
+		return ray.hit;
+	}
+
+	static constexpr char BSP_VISIBILITY_MAGIC[4] {'Z', 'K', 'P', 'V'};
+	static constexpr std::uint32_t BSP_VISIBILITY_VERSION = 1;
+
+	/// \brief Portals closer to a plane than this are considered to lie on it.
+	static constexpr float BSP_PORTAL_EPSILON = 0.01f;
+
+	/// \brief The maximum number of portals visited per sector before giving up on clipping and assuming all
+	///        reachable sectors to be visible.
+	static constexpr std::uint32_t BSP_PORTAL_BUDGET = 1 << 16;
+
+	namespace {
+		/// \brief A portal between sectors. Coincident portal polygons are merged into one.
+		struct BspPortal {
+			std::vector<Vec3> points;
+			Vec3 center;
+			Vec4 plane;
+		};
+
+		/// \brief A connection from one sector to another through a portal.
+		struct BspPortalLink {
+			std::uint32_t to;
+			std::uint32_t portal;
+		};
+
+		/// \brief Finds the sectors visible from a single sector by walking chains of portals.
+		struct BspVisibilityBuilder {
+			std::vector<BspPortal> portals;
+			std::vector<std::vector<BspPortalLink>> links;
+			std::vector<std::optional<Vec3>> centers;
+
+			std::uint64_t* row {nullptr};
+			std::vector<Vec4> planes;
+			std::vector<bool> on_path;
+			std::uint32_t budget {0};
+
+			void mark(std::uint32_t sector) {
+				row[sector / 64] |= std::uint64_t {1} << (sector % 64);
+			}
+
+			/// \return The plane of \p portal facing away from \p behind.
+			static Vec4 orient(BspPortal const& portal, Vec3 const& behind) {
+				auto const& p = portal.plane;
+				return plane_distance(p, behind) > 0 ? Vec4 {-p.x, -p.y, -p.z, -p.w} : p;
+			}
+
+			/// \return Whether any point of \p portal lies beyond all planes of the current chain.
+			[[nodiscard]] bool is_beyond(BspPortal const& portal) const {
+				for (auto const& plane : planes) {
+					auto beyond = std::any_of(portal.points.begin(), portal.points.end(), [&](Vec3 const& point) {
+						return plane_distance(plane, point) > BSP_PORTAL_EPSILON;
+					});
+
+					if (!beyond) return false;
+				}
+
+				return true;
+			}
+
+			void walk(std::uint32_t sector, std::uint32_t via) {
+				if (on_path[sector]) return;
+				on_path[sector] = true;
+
+				for (auto const& link : links[sector]) {
+					if (link.portal == via) continue;
+					if (budget == 0) break;
+					--budget;
+
+					auto const& portal = portals[link.portal];
+					if (!is_beyond(portal)) continue;
+					mark(link.to);
+
+					// Without a usable previous portal, the portal is oriented away from the sector itself.
+					auto const& previous = portals[via].center;
+					if (std::abs(plane_distance(portal.plane, previous)) > BSP_PORTAL_EPSILON) {
+						planes.push_back(orient(portal, previous));
+					} else if (centers[sector]) {
+						planes.push_back(orient(portal, *centers[sector]));
+					} else {
+						continue;
+					}
+
+					walk(link.to, link.portal);
+					planes.pop_back();
+				}
+
+				on_path[sector] = false;
+			}
+
+			/// \brief Marks all sectors reachable from \p source, regardless of whether they are visible.
+			void flood(std::uint32_t source) {
+				std::vector<bool> seen(links.size(), false);
+				std::vector<std::uint32_t> queue {source};
+				seen[source] = true;
+
+				while (!queue.empty()) {
+					auto sector = queue.back();
+					queue.pop_back();
+					mark(sector);
+
+					for (auto const& link : links[sector]) {
+						if (seen[link.to]) continue;
+						seen[link.to] = true;
+						queue.push_back(link.to);
+					}
+				}
+			}
+
+			void build(std::uint32_t source, std::uint64_t* out) {
+				row = out;
+				budget = BSP_PORTAL_BUDGET;
+				on_path.assign(links.size(), false);
+				on_path[source] = true;
+				mark(source);
+
+				for (auto const& link : links[source]) {
+					auto const& portal = portals[link.portal];
+					mark(link.to);
+
+					// The outside has no center, so its portals are oriented towards the sector they lead to.
+					if (centers[source]) {
+						planes.push_back(orient(portal, *centers[source]));
+					} else if (centers[link.to]) {
+						auto plane = orient(portal, *centers[link.to]);
+						planes.push_back(Vec4 {-plane.x, -plane.y, -plane.z, -plane.w});
+					} else {
+						continue;
+					}
+
+					walk(link.to, link.portal);
+					planes.pop_back();
+				}
+
+				if (budget == 0) {
+					ZKLOGW("BspTree", "Portal budget exceeded, assuming all reachable sectors to be visible");
+					flood(source);
+				}
+			}
+		};
+	} // namespace
+
+	BspVisibility BspTree::build_visibility(Mesh const& mesh) const {
+		auto sector_count = static_cast<std::uint32_t>(this->sectors.size());
+		auto outside = sector_count;
+
+		BspVisibilityBuilder builder;
+		builder.links.resize(sector_count + 1);
+		builder.centers.resize(sector_count + 1);
+
+		for (auto i = 0u; i < sector_count; ++i) {
+			std::optional<AxisAlignedBoundingBox> bounds;
+			for (auto node : this->sectors[i].node_indices) {
+				if (node >= this->nodes.size()) continue;
+				auto const& box = this->nodes[node].bbox;
+
+				if (!bounds) {
+					bounds = box;
+					continue;
+				}
+
+				for (auto k = 0u; k < 3; ++k) {
+					bounds->min[k] = std::min(bounds->min[k], box.min[k]);
+					bounds->max[k] = std::max(bounds->max[k], box.max[k]);
+				}
+			}
+
+			if (bounds) builder.centers[i] = add(bounds->min, sub(bounds->max, bounds->min) * 0.5f);
+		}
+
+		// Group coincident portal polygons by their sorted vertex positions.
+		std::map<std::vector<float>, std::uint32_t> portal_keys;
+		std::vector<std::vector<std::uint32_t>> portal_sectors;
+
+		for (auto i = 0u; i < sector_count; ++i) {
+			for (auto polygon_index : this->sectors[i].portal_polygon_indices) {
+				if (polygon_index >= mesh.geometry.size()) continue;
+				auto const& polygon = mesh.geometry[polygon_index];
+				if (polygon.index_count < 3 ||
+				    polygon.index_offset + polygon.index_count > mesh.polygon_vertex_indices.size()) {
+					continue;
+				}
+
+				BspPortal portal {};
+				std::vector<std::array<float, 3>> sorted;
+				for (auto k = 0u; k < polygon.index_count; ++k) {
+					auto vertex = mesh.polygon_vertex_indices[polygon.index_offset + k];
+					if (vertex >= mesh.vertices.size()) break;
+
+					auto const& point = mesh.vertices[vertex];
+					portal.points.push_back(point);
+					sorted.push_back({point.x, point.y, point.z});
+				}
+
+				if (portal.points.size() != polygon.index_count) continue;
+				std::sort(sorted.begin(), sorted.end());
+
+				std::vector<float> key;
+				for (auto const& point : sorted) {
+					key.insert(key.end(), point.begin(), point.end());
+				}
+
+				auto [it, added] = portal_keys.emplace(std::move(key), builder.portals.size());
+				if (added) {
+					// Newell's method gives a stable normal even for slightly non-planar polygons.
+					Vec3 normal {0, 0, 0};
+					Vec3 center {0, 0, 0};
+					for (auto k = 0u; k < portal.points.size(); ++k) {
+						auto const& a = portal.points[k];
+						auto const& b = portal.points[(k + 1) % portal.points.size()];
+						normal = add(normal, cross(a, b));
+						center = add(center, a);
+					}
+
+					auto length = std::sqrt(dot(normal, normal));
+					if (length == 0) length = 1;
+					normal = normal * (1.0f / length);
+					portal.center = center * (1.0f / static_cast<float>(portal.points.size()));
+					portal.plane = Vec4 {normal.x, normal.y, normal.z, dot(normal, portal.center)};
+
+					builder.portals.push_back(std::move(portal));
+					portal_sectors.emplace_back();
+				}
+
+				auto& owners = portal_sectors[it->second];
+				if (std::find(owners.begin(), owners.end(), i) == owners.end()) owners.push_back(i);
+			}
+		}
+
+		for (auto portal = 0u; portal < portal_sectors.size(); ++portal) {
+			auto owners = portal_sectors[portal];
+			if (owners.size() == 1) owners.push_back(outside);
+
+			for (auto a : owners) {
+				for (auto b : owners) {
+					if (a != b) builder.links[a].push_back({b, portal});
+				}
+			}
+		}
+
+		BspVisibility visibility {};
+		visibility.outside = outside;
+		visibility.fingerprint = this->sector_fingerprint();
+
+		auto words = (sector_count + 1 + 63) / 64;
+		visibility.bits.resize(static_cast<std::size_t>(words) * (sector_count + 1), 0);
+
+		for (auto i = 0u; i <= sector_count; ++i) {
+			builder.build(i, visibility.bits.data() + static_cast<std::size_t>(words) * i);
+		}
+
+		return visibility;
+	}
+
+	std::uint64_t BspTree::sector_fingerprint() const noexcept {
+		// FNV-1a over the sector layout.
+		std::uint64_t hash = 0xcbf29ce484222325;
+		auto mix = [&hash](std::uint64_t v) {
+			for (auto i = 0u; i < 8; ++i) {
+				hash ^= (v >> (i * 8)) & 0xFF;
+				hash *= 0x100000001b3;
+			}
+		};
+
+		mix(this->sectors.size());
+		for (auto const& sector : this->sectors) {
+			mix(sector.node_indices.size());
+			for (auto i : sector.node_indices) mix(i);
+
+			mix(sector.portal_polygon_indices.size());
+			for (auto i : sector.portal_polygon_indices) mix(i);
+		}
+
+		return hash;
+	}
+
+	bool BspVisibility::load(Read* r, BspTree const& tree) {
+		char magic[sizeof BSP_VISIBILITY_MAGIC];
+		if (r->read(magic, sizeof magic) != sizeof magic ||
+		    std::memcmp(magic, BSP_VISIBILITY_MAGIC, sizeof magic) != 0 || r->read_uint() != BSP_VISIBILITY_VERSION) {
+			return false;
+		}
+
+		std::uint64_t hash = 0;
+		if (r->read(&hash, sizeof hash) != sizeof hash || hash != tree.sector_fingerprint()) return false;
+
+		auto count = r->read_uint();
+		if (count != tree.sectors.size()) return false;
+
+		std::vector<std::uint64_t> data(static_cast<std::size_t>((count + 1 + 63) / 64) * (count + 1));
+		auto size = data.size() * sizeof(std::uint64_t);
+		if (r->read(data.data(), size) != size) return false;
+
+		this->outside = count;
+		this->fingerprint = hash;
+		this->bits = std::move(data);
+		return true;
+	}
+
+	void BspVisibility::save(Write* w) const {
+		w->write(BSP_VISIBILITY_MAGIC, sizeof BSP_VISIBILITY_MAGIC);
+		w->write_uint(BSP_VISIBILITY_VERSION);
+		w->write(&this->fingerprint, sizeof this->fingerprint);
+		w->write_uint(this->outside);
+		w->write(this->bits.data(), this->bits.size() * sizeof(std::uint64_t));
+	}
+
+	bool BspVisibility::is_visible(std::uint32_t from, std::uint32_t to) const noexcept {
+		if (from > this->outside || to > this->outside) return false;
+
+		auto words = static_cast<std::size_t>((this->outside + 1 + 63) / 64);
+		auto index = words * from + to / 64;
+		if (index >= this->bits.size()) return false;
+
+		return (this->bits[index] >> (to % 64)) & 1;
+	}
 } // namespace zenkit
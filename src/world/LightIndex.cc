@@ -0,0 +1,152 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/world/LightIndex.hh"
+#include "zenkit/World.hh"
+#include "zenkit/vobs/Light.hh"
+
+#include <algorithm>
+
+namespace zenkit {
+	/// \return The squared distance between a point and the closest point of a box.
+	static float distance_squared(AxisAlignedBoundingBox const& box, Vec3 const& point) {
+		float distance = 0;
+		for (auto i = 0u; i < 3; ++i) {
+			auto d = std::max({box.min[i] - point[i], 0.0f, point[i] - box.max[i]});
+			distance += d * d;
+		}
+		return distance;
+	}
+
+	void LightIndex::build(World const& world) {
+		std::vector<VLight*> found;
+		std::vector<VirtualObject*> stack;
+		for (auto const& vob : world.world_vobs) {
+			if (vob != nullptr) stack.push_back(vob.get());
+		}
+
+		while (!stack.empty()) {
+			auto* vob = stack.back();
+			stack.pop_back();
+
+			if (vob->get_object_type() == ObjectType::zCVobLight) found.push_back(static_cast<VLight*>(vob));
+
+			for (auto const& child : vob->children) {
+				if (child != nullptr) stack.push_back(child.get());
+			}
+		}
+
+		this->build(found, world.world_bsp_tree);
+	}
+
+	void LightIndex::build(std::vector<VLight*> const& lights, BspTree const& tree) {
+		this->lights.clear();
+		this->positions.clear();
+		this->radii.clear();
+
+		for (auto* light : lights) {
+			if (light == nullptr) continue;
+			this->lights.push_back(light);
+			this->positions.push_back(light->position);
+			this->radii.push_back(radius_of(*light));
+		}
+
+		// Collect (node, light) pairs by walking down the tree for each light, skipping subtrees out of its reach.
+		auto node_count = tree.nodes.size();
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+		std::vector<std::int32_t> stack;
+
+		for (auto light = 0u; light < this->lights.size() && node_count > 0; ++light) {
+			auto const& position = this->positions[light];
+			auto radius = this->radii[light];
+
+			stack.assign(1, 0);
+
+			// Links are only followed as often as there are nodes, in case they don't form a tree.
+			for (auto visited = 0u; !stack.empty() && visited < node_count; ++visited) {
+				auto index = stack.back();
+				stack.pop_back();
+
+				auto const& node = tree.nodes[static_cast<std::uint32_t>(index)];
+				if (distance_squared(node.bbox, position) > radius * radius) continue;
+
+				if (node.is_leaf()) {
+					pairs.emplace_back(static_cast<std::uint32_t>(index), light);
+					continue;
+				}
+
+				for (auto child : {node.front_index, node.back_index}) {
+					if (child >= 0 && static_cast<std::size_t>(child) < node_count) stack.push_back(child);
+				}
+			}
+		}
+
+		// Sort the pairs into the rows of the nodes.
+		this->offsets.assign(node_count + 1, 0);
+		for (auto [node, _] : pairs) {
+			++this->offsets[node + 1];
+		}
+
+		for (auto i = 0u; i < node_count; ++i) {
+			this->offsets[i + 1] += this->offsets[i];
+		}
+
+		this->indices.resize(pairs.size());
+		std::vector<std::uint32_t> fill(this->offsets.begin(), this->offsets.end() - 1);
+		for (auto [node, light] : pairs) {
+			this->indices[fill[node]++] = light;
+		}
+	}
+
+	void LightIndex::query_leaf(std::uint32_t node, std::vector<VLight*>& result) const {
+		result.clear();
+		if (static_cast<std::size_t>(node) + 1 >= this->offsets.size()) return;
+
+		for (auto i = this->offsets[node]; i < this->offsets[node + 1]; ++i) {
+			result.push_back(this->lights[this->indices[i]]);
+		}
+	}
+
+	void LightIndex::query_point(BspTree const& tree, Vec3 const& point, std::vector<VLight*>& result) const {
+		result.clear();
+
+		auto reaches = [this, &point](std::uint32_t light) {
+			auto const& p = this->positions[light];
+			auto dx = p.x - point.x;
+			auto dy = p.y - point.y;
+			auto dz = p.z - point.z;
+			return dx * dx + dy * dy + dz * dz <= this->radii[light] * this->radii[light];
+		};
+
+		auto leaf = tree.find_leaf(point);
+		if (leaf < 0 || static_cast<std::size_t>(leaf) + 1 >= this->offsets.size()) {
+			// The point is outside of the tree, so there is no list to consult.
+			for (auto i = 0u; i < this->lights.size(); ++i) {
+				if (reaches(i)) result.push_back(this->lights[i]);
+			}
+			return;
+		}
+
+		for (auto i = this->offsets[leaf]; i < this->offsets[leaf + 1]; ++i) {
+			if (reaches(this->indices[i])) result.push_back(this->lights[this->indices[i]]);
+		}
+	}
+
+	void LightIndex::query_box(AxisAlignedBoundingBox const& box, std::vector<VLight*>& result) const {
+		result.clear();
+
+		for (auto i = 0u; i < this->lights.size(); ++i) {
+			if (distance_squared(box, this->positions[i]) <= this->radii[i] * this->radii[i]) {
+				result.push_back(this->lights[i]);
+			}
+		}
+	}
+
+	float LightIndex::radius_of(VLight const& light) noexcept {
+		auto scale = 1.0f;
+		for (auto s : light.range_animation_scale) {
+			scale = std::max(scale, s);
+		}
+
+		return light.range * scale;
+	}
+} // namespace zenkit
@@ -0,0 +1,385 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/world/VobSpatialIndex.hh"
+#include "zenkit/World.hh"
+#include "zenkit/vobs/VirtualObject.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace zenkit {
+	namespace {
+		/// \brief Cell coordinates are clamped to this range so that they fit into 21 bits of a cell key.
+		constexpr std::int32_t CELL_LIMIT = (1 << 20) - 1;
+
+		AxisAlignedBoundingBox bounds_of(VirtualObject const& vob) {
+			auto const& box = vob.bbox;
+			auto const& p = vob.position;
+
+			if (p.x < box.min.x || p.y < box.min.y || p.z < box.min.z || p.x > box.max.x || p.y > box.max.y ||
+			    p.z > box.max.z) {
+				return {p, p};
+			}
+
+			return box;
+		}
+
+		bool overlaps(AxisAlignedBoundingBox const& a, AxisAlignedBoundingBox const& b) {
+			return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y &&
+			    a.min.z <= b.max.z && a.max.z >= b.min.z;
+		}
+
+		/// \brief Intersects a ray with a box using the slab method.
+		/// \return The distance at which the ray enters the box or a negative value if it misses.
+		float intersect(AxisAlignedBoundingBox const& box, Vec3 const& origin, Vec3 const& direction, float max) {
+			float t_near = 0;
+			float t_far = max;
+
+			for (auto i = 0u; i < 3; ++i) {
+				if (direction[i] == 0) {
+					if (origin[i] < box.min[i] || origin[i] > box.max[i]) return -1;
+					continue;
+				}
+
+				auto inv = 1.0f / direction[i];
+				auto t0 = (box.min[i] - origin[i]) * inv;
+				auto t1 = (box.max[i] - origin[i]) * inv;
+				if (t0 > t1) std::swap(t0, t1);
+
+				t_near = std::max(t_near, t0);
+				t_far = std::min(t_far, t1);
+				if (t_near > t_far) return -1;
+			}
+
+			return t_near;
+		}
+	} // namespace
+
+	VobSpatialIndex::VobSpatialIndex(float cell_size) : _m_cell_size(cell_size > 0 ? cell_size : 1.0f) {}
+
+	void VobSpatialIndex::build(World const& world) {
+		this->clear();
+
+		std::vector<VirtualObject*> stack;
+		for (auto it = world.world_vobs.rbegin(); it != world.world_vobs.rend(); ++it) {
+			if (*it != nullptr) stack.push_back(it->get());
+		}
+
+		while (!stack.empty()) {
+			auto* vob = stack.back();
+			stack.pop_back();
+			this->insert(vob);
+
+			for (auto it = vob->children.rbegin(); it != vob->children.rend(); ++it) {
+				if (*it != nullptr) stack.push_back(it->get());
+			}
+		}
+	}
+
+	void VobSpatialIndex::insert(VirtualObject* vob) {
+		if (vob == nullptr) return;
+
+		auto it = _m_lookup.find(vob);
+		if (it != _m_lookup.end()) {
+			this->update(vob);
+			return;
+		}
+
+		std::uint32_t index;
+		if (_m_free.empty()) {
+			index = static_cast<std::uint32_t>(_m_entries.size());
+			_m_entries.emplace_back();
+		} else {
+			index = _m_free.back();
+			_m_free.pop_back();
+		}
+
+		auto& entry = _m_entries[index];
+		entry.vob = vob;
+		entry.box = bounds_of(*vob);
+		_m_lookup.emplace(vob, index);
+		this->link(index);
+	}
+
+	bool VobSpatialIndex::remove(VirtualObject const* vob) {
+		auto it = _m_lookup.find(vob);
+		if (it == _m_lookup.end()) return false;
+
+		auto index = it->second;
+		this->unlink(index);
+		_m_entries[index].vob = nullptr;
+		_m_free.push_back(index);
+		_m_lookup.erase(it);
+		return true;
+	}
+
+	void VobSpatialIndex::update(VirtualObject* vob) {
+		if (vob == nullptr) return;
+
+		auto it = _m_lookup.find(vob);
+		if (it == _m_lookup.end()) {
+			this->insert(vob);
+			return;
+		}
+
+		auto& entry = _m_entries[it->second];
+		auto box = bounds_of(*vob);
+
+		bool same_cells = true;
+		for (auto i = 0u; i < 3; ++i) {
+			same_cells = same_cells && cell_of(box.min[i]) == entry.min[i] && cell_of(box.max[i]) == entry.max[i];
+		}
+
+		entry.box = box;
+		if (same_cells) return;
+
+		this->unlink(it->second);
+		this->link(it->second);
+	}
+
+	void VobSpatialIndex::clear() noexcept {
+		_m_entries.clear();
+		_m_free.clear();
+		_m_oversized.clear();
+		_m_lookup.clear();
+		_m_cells.clear();
+
+		for (auto i = 0u; i < 3; ++i) {
+			_m_bounds_min[i] = 0;
+			_m_bounds_max[i] = -1;
+		}
+	}
+
+	std::size_t VobSpatialIndex::size() const noexcept {
+		return _m_lookup.size();
+	}
+
+	void VobSpatialIndex::query_box(AxisAlignedBoundingBox const& box, std::vector<VirtualObject*>& vobs) const {
+		vobs.clear();
+
+		std::int32_t min[3], max[3];
+		for (auto i = 0u; i < 3; ++i) {
+			min[i] = cell_of(box.min[i]);
+			max[i] = cell_of(box.max[i]);
+		}
+
+		std::vector<std::uint32_t> candidates;
+		this->collect(min, max, candidates);
+
+		for (auto index : candidates) {
+			auto const& entry = _m_entries[index];
+			if (overlaps(entry.box, box)) vobs.push_back(entry.vob);
+		}
+	}
+
+	void VobSpatialIndex::query_radius(Vec3 const& center, float radius, std::vector<VirtualObject*>& vobs) const {
+		vobs.clear();
+
+		std::int32_t min[3], max[3];
+		for (auto i = 0u; i < 3; ++i) {
+			min[i] = cell_of(center[i] - radius);
+			max[i] = cell_of(center[i] + radius);
+		}
+
+		std::vector<std::uint32_t> candidates;
+		this->collect(min, max, candidates);
+
+		for (auto index : candidates) {
+			auto const& entry = _m_entries[index];
+
+			// The squared distance from the center to the closest point of the box.
+			float distance = 0;
+			for (auto i = 0u; i < 3; ++i) {
+				auto d = std::max({entry.box.min[i] - center[i], 0.0f, center[i] - entry.box.max[i]});
+				distance += d * d;
+			}
+
+			if (distance <= radius * radius) vobs.push_back(entry.vob);
+		}
+	}
+
+	void VobSpatialIndex::query_ray(Vec3 const& origin,
+	                                Vec3 const& direction,
+	                                float max_distance,
+	                                std::vector<VirtualObject*>& vobs) const {
+		vobs.clear();
+
+		std::vector<std::uint32_t> candidates {_m_oversized};
+
+		// Clip the ray to the cells containing any VOb, then walk the cells it passes through.
+		AxisAlignedBoundingBox grid {};
+		for (auto i = 0u; i < 3; ++i) {
+			grid.min[i] = static_cast<float>(_m_bounds_min[i]) * _m_cell_size;
+			grid.max[i] = static_cast<float>(_m_bounds_max[i] + 1) * _m_cell_size;
+		}
+
+		auto t = _m_bounds_min[0] <= _m_bounds_max[0] ? intersect(grid, origin, direction, max_distance) : -1;
+		if (t >= 0) {
+			std::int32_t cell[3], step[3];
+			float next[3], delta[3];
+
+			for (auto i = 0u; i < 3; ++i) {
+				auto p = origin[i] + direction[i] * t;
+				cell[i] = std::clamp(cell_of(p), _m_bounds_min[i], _m_bounds_max[i]);
+
+				if (direction[i] > 0) {
+					step[i] = 1;
+					delta[i] = _m_cell_size / direction[i];
+					next[i] = (static_cast<float>(cell[i] + 1) * _m_cell_size - origin[i]) / direction[i];
+				} else if (direction[i] < 0) {
+					step[i] = -1;
+					delta[i] = -_m_cell_size / direction[i];
+					next[i] = (static_cast<float>(cell[i]) * _m_cell_size - origin[i]) / direction[i];
+				} else {
+					step[i] = 0;
+					delta[i] = std::numeric_limits<float>::infinity();
+					next[i] = std::numeric_limits<float>::infinity();
+				}
+			}
+
+			for (;;) {
+				auto found = _m_cells.find(key_of(cell[0], cell[1], cell[2]));
+				if (found != _m_cells.end()) {
+					candidates.insert(candidates.end(), found->second.begin(), found->second.end());
+				}
+
+				auto axis = next[0] < next[1] ? (next[0] < next[2] ? 0u : 2u) : (next[1] < next[2] ? 1u : 2u);
+				if (std::isinf(next[axis]) || next[axis] > max_distance) break;
+
+				cell[axis] += step[axis];
+				if (cell[axis] < _m_bounds_min[axis] || cell[axis] > _m_bounds_max[axis]) break;
+				next[axis] += delta[axis];
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+		std::vector<std::pair<float, VirtualObject*>> hits;
+		for (auto index : candidates) {
+			auto const& entry = _m_entries[index];
+			auto distance = intersect(entry.box, origin, direction, max_distance);
+			if (distance >= 0) hits.emplace_back(distance, entry.vob);
+		}
+
+		std::stable_sort(hits.begin(), hits.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+		for (auto& hit : hits) {
+			vobs.push_back(hit.second);
+		}
+	}
+
+	std::int32_t VobSpatialIndex::cell_of(float v) const noexcept {
+		auto cell = std::floor(v / _m_cell_size);
+		if (!(cell > -CELL_LIMIT)) return -CELL_LIMIT;
+		if (!(cell < CELL_LIMIT)) return CELL_LIMIT;
+		return static_cast<std::int32_t>(cell);
+	}
+
+	std::uint64_t VobSpatialIndex::key_of(std::int32_t x, std::int32_t y, std::int32_t z) noexcept {
+		auto bits = [](std::int32_t v) { return static_cast<std::uint64_t>(v + CELL_LIMIT + 1) & 0x1FFFFF; };
+		return bits(x) | bits(y) << 21 | bits(z) << 42;
+	}
+
+	void VobSpatialIndex::link(std::uint32_t index) {
+		auto& entry = _m_entries[index];
+
+		std::uint64_t count = 1;
+		for (auto i = 0u; i < 3; ++i) {
+			entry.min[i] = cell_of(entry.box.min[i]);
+			entry.max[i] = cell_of(entry.box.max[i]);
+			count *= static_cast<std::uint64_t>(entry.max[i] - entry.min[i] + 1);
+		}
+
+		entry.oversized = count > MAX_CELLS;
+		if (entry.oversized) {
+			_m_oversized.push_back(index);
+			return;
+		}
+
+		for (auto i = 0u; i < 3; ++i) {
+			if (_m_bounds_min[i] > _m_bounds_max[i]) {
+				_m_bounds_min[i] = entry.min[i];
+				_m_bounds_max[i] = entry.max[i];
+			} else {
+				_m_bounds_min[i] = std::min(_m_bounds_min[i], entry.min[i]);
+				_m_bounds_max[i] = std::max(_m_bounds_max[i], entry.max[i]);
+			}
+		}
+
+		for (auto x = entry.min[0]; x <= entry.max[0]; ++x) {
+			for (auto y = entry.min[1]; y <= entry.max[1]; ++y) {
+				for (auto z = entry.min[2]; z <= entry.max[2]; ++z) {
+					_m_cells[key_of(x, y, z)].push_back(index);
+				}
+			}
+		}
+	}
+
+	void VobSpatialIndex::unlink(std::uint32_t index) {
+		auto const& entry = _m_entries[index];
+
+		if (entry.oversized) {
+			_m_oversized.erase(std::find(_m_oversized.begin(), _m_oversized.end(), index));
+			return;
+		}
+
+		for (auto x = entry.min[0]; x <= entry.max[0]; ++x) {
+			for (auto y = entry.min[1]; y <= entry.max[1]; ++y) {
+				for (auto z = entry.min[2]; z <= entry.max[2]; ++z) {
+					auto it = _m_cells.find(key_of(x, y, z));
+					if (it == _m_cells.end()) continue;
+
+					auto& cell = it->second;
+					cell.erase(std::find(cell.begin(), cell.end(), index));
+					if (cell.empty()) _m_cells.erase(it);
+				}
+			}
+		}
+	}
+
+	void VobSpatialIndex::collect(std::int32_t const (&min)[3],
+	                              std::int32_t const (&max)[3],
+	                              std::vector<std::uint32_t>& out) const {
+		out = _m_oversized;
+
+		if (_m_bounds_min[0] <= _m_bounds_max[0]) {
+			std::int32_t lo[3], hi[3];
+			std::uint64_t count = 1;
+
+			for (auto i = 0u; i < 3; ++i) {
+				lo[i] = std::max(min[i], _m_bounds_min[i]);
+				hi[i] = std::min(max[i], _m_bounds_max[i]);
+				if (lo[i] > hi[i]) return;
+				count *= static_cast<std::uint64_t>(hi[i] - lo[i] + 1);
+			}
+
+			if (count > _m_cells.size()) {
+				// The query covers more cells than are occupied, so look at each occupied cell instead.
+				for (auto const& [key, cell] : _m_cells) {
+					std::int32_t c[3];
+					for (auto i = 0u; i < 3; ++i) {
+						c[i] = static_cast<std::int32_t>((key >> (21 * i)) & 0x1FFFFF) - CELL_LIMIT - 1;
+					}
+
+					if (c[0] >= lo[0] && c[0] <= hi[0] && c[1] >= lo[1] && c[1] <= hi[1] && c[2] >= lo[2] &&
+					    c[2] <= hi[2]) {
+						out.insert(out.end(), cell.begin(), cell.end());
+					}
+				}
+			} else {
+				for (auto x = lo[0]; x <= hi[0]; ++x) {
+					for (auto y = lo[1]; y <= hi[1]; ++y) {
+						for (auto z = lo[2]; z <= hi[2]; ++z) {
+							auto it = _m_cells.find(key_of(x, y, z));
+							if (it != _m_cells.end()) out.insert(out.end(), it->second.begin(), it->second.end());
+						}
+					}
+				}
+			}
+		}
+
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+	}
+} // namespace zenkit
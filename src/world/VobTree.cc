@@ -4,9 +4,21 @@
 #include "zenkit/Archive.hh"
 #include "zenkit/vobs/VirtualObject.hh"
 
+#include "../Internal.hh"
+
+#include <algorithm>
+#include <string>
+
 namespace zenkit {
 	std::shared_ptr<VirtualObject> parse_vob_tree(ReadArchive& in, GameVersion version) {
+		std::vector<std::shared_ptr<VirtualObject>> out;
+		parse_vob_tree(in, version, out);
+		return out.size() == 1 ? std::move(out.front()) : nullptr;
+	}
+
+	void parse_vob_tree(ReadArchive& in, GameVersion version, std::vector<std::shared_ptr<VirtualObject>>& out) {
 		auto obj = in.read_object(version);
+		auto filtered = in.last_object_filtered();
 		if (obj != nullptr && !is_vobject(obj->get_object_type())) {
 			obj = nullptr;
 		}
@@ -15,7 +27,7 @@ namespace zenkit {
 		std::shared_ptr<VirtualObject> object {obj, reinterpret_cast<VirtualObject*>(obj.get())};
 
 		auto child_count = static_cast<size_t>(in.read_int());
-		if (object == nullptr) {
+		if (object == nullptr && !filtered) {
 			std::function<void(size_t)> skip;
 			skip = [&skip, &in](size_t count) {
 				for (auto i = 0u; i < count; ++i) {
@@ -27,19 +39,88 @@ namespace zenkit {
 			};
 
 			skip(child_count);
-			return nullptr;
+			return;
 		}
 
-		object->children.reserve(child_count);
+		// Children of VObs skipped by the class filter are attached to the closest loaded ancestor instead.
+		auto& children = object != nullptr ? object->children : out;
+		if (object != nullptr) children.reserve(child_count);
 
 		for (auto i = 0u; i < child_count; ++i) {
-			auto child = parse_vob_tree(in, version);
-			if (child == nullptr) continue;
+			parse_vob_tree(in, version, children);
+		}
+
+		if (object != nullptr) {
+			out.push_back(std::move(object));
+		}
+	}
+
+	VobStream::VobStream(std::unique_ptr<ReadArchive> archive, GameVersion version)
+	    : _m_archive(std::move(archive)), _m_version(version) {
+		_m_archive->set_index(std::make_shared<ArchiveIndex>());
+	}
+
+	std::unique_ptr<VobStream> VobStream::from(Read* r, GameVersion version) {
+		auto ar = ReadArchive::from(r);
+
+		ArchiveObject chnk {};
+		if (!ar->read_object_begin(chnk) || chnk.class_name != "oCWorld:zCWorld") {
+			throw ParserError {"VobStream", "'oCWorld:zCWorld' chunk expected, got '" + chnk.class_name + "'"};
+		}
+
+		std::unique_ptr<VobStream> stream {new VobStream(std::move(ar), version)};
+		auto& archive = *stream->_m_archive;
 
-			object->children.push_back(std::move(child));
+		while (!archive.read_object_end()) {
+			if (!archive.read_object_begin(chnk)) {
+				throw ParserError {"VobStream", "Failed to load zCWorld: expected object, got field!"};
+			}
+
+			if (chnk.object_name == "VobTree") {
+				auto count = archive.read_int(); // childs0
+				if (count < 0) {
+					throw ParserError {"VobStream", "invalid VOb count: " + std::to_string(count)};
+				}
+
+				stream->_m_remaining = static_cast<size_t>(count);
+				break;
+			}
+
+			if (chnk.object_name == "EndMarker") break;
+			archive.skip_object(true);
+		}
+
+		if (stream->_m_remaining == 0) {
+			ZKLOGW("VobStream", "World does not contain any VObs");
+		}
+
+		return stream;
+	}
+
+	std::shared_ptr<VirtualObject> VobStream::next() {
+		while (_m_pending.empty() && _m_remaining > 0) {
+			// The count comes straight from the archive. Don't read past the end of the VOb tree if it is too large.
+			if (_m_archive->read_object_end()) {
+				ZKLOGW("VobStream", "VOb tree ended %zu VObs early", _m_remaining);
+				_m_remaining = 0;
+				break;
+			}
+
+			// Objects of previous trees are only needed to resolve references, which the index takes care of.
+			_m_archive->clear_object_cache();
+
+			parse_vob_tree(*_m_archive, _m_version, _m_pending);
+			--_m_remaining;
+
+			// Children of a filtered root VOb are returned one by one, in order.
+			std::reverse(_m_pending.begin(), _m_pending.end());
 		}
 
-		return object;
+		if (_m_pending.empty()) return nullptr;
+
+		auto vob = std::move(_m_pending.back());
+		_m_pending.pop_back();
+		return vob;
 	}
 
 	void save_vob_tree(WriteArchive& w, GameVersion version, std::shared_ptr<VirtualObject> const& obj) {
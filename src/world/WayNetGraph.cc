@@ -0,0 +1,413 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/world/WayNetGraph.hh"
+#include "zenkit/Executor.hh"
+#include "zenkit/Stream.hh"
+#include "zenkit/world/WayNet.hh"
+
+#include "../Internal.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace zenkit {
+	static constexpr auto NO_PARENT = std::numeric_limits<std::uint32_t>::max();
+	static constexpr char DISTANCE_TABLE_MAGIC[4] = {'Z', 'K', 'W', 'D'};
+	static constexpr std::uint32_t DISTANCE_TABLE_VERSION = 1;
+
+	static float distance(Vec3 const& a, Vec3 const& b) {
+		auto x = a.x - b.x;
+		auto y = a.y - b.y;
+		auto z = a.z - b.z;
+		return std::sqrt(x * x + y * y + z * z);
+	}
+
+	void WayNetGraph::build(WayNet const& way_net) {
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+
+#ifndef ZK_FUTURE
+		this->positions.resize(way_net.waypoints.size());
+		for (auto i = 0u; i < way_net.waypoints.size(); ++i) {
+			this->positions[i] = way_net.waypoints[i].position;
+		}
+
+		edges.reserve(way_net.edges.size());
+		for (auto& edge : way_net.edges) {
+			edges.emplace_back(edge.a, edge.b);
+		}
+#else
+		std::unordered_map<WayPoint const*, std::uint32_t> indices;
+		this->positions.resize(way_net.points.size());
+		for (auto i = 0u; i < way_net.points.size(); ++i) {
+			this->positions[i] = way_net.points[i]->position;
+			indices.emplace(way_net.points[i].get(), i);
+		}
+
+		edges.reserve(way_net.edges.size());
+		for (auto& [a, b] : way_net.edges) {
+			auto it_a = indices.find(a.get());
+			auto it_b = indices.find(b.get());
+			if (it_a == indices.end() || it_b == indices.end()) continue;
+			edges.emplace_back(it_a->second, it_b->second);
+		}
+#endif
+
+		auto count = static_cast<std::uint32_t>(this->positions.size());
+		auto invalid = [count](auto const& e) {
+			return e.first >= count || e.second >= count || e.first == e.second;
+		};
+		edges.erase(std::remove_if(edges.begin(), edges.end(), invalid), edges.end());
+
+		// Count the neighbors of each waypoint first, then place every edge in both directions.
+		this->offsets.assign(count + 1, 0);
+		for (auto [a, b] : edges) {
+			++this->offsets[a + 1];
+			++this->offsets[b + 1];
+		}
+
+		std::partial_sum(this->offsets.begin(), this->offsets.end(), this->offsets.begin());
+
+		this->targets.resize(edges.size() * 2);
+		this->costs.resize(edges.size() * 2);
+
+		std::vector<std::uint32_t> fill(this->offsets.begin(), this->offsets.end() - 1);
+		for (auto [a, b] : edges) {
+			auto cost = distance(this->positions[a], this->positions[b]);
+			this->targets[fill[a]] = b;
+			this->costs[fill[a]++] = cost;
+			this->targets[fill[b]] = a;
+			this->costs[fill[b]++] = cost;
+		}
+
+		// Order the waypoints as a balanced k-d tree. The median of each range is its root, the elements before it
+		// form the left and the elements after it the right subtree.
+		this->_m_tree.resize(count);
+		std::iota(this->_m_tree.begin(), this->_m_tree.end(), 0);
+
+		struct Range {
+			std::size_t begin, end;
+			unsigned axis;
+		};
+
+		std::vector<Range> stack {{0, count, 0}};
+		while (!stack.empty()) {
+			auto [begin, end, axis] = stack.back();
+			stack.pop_back();
+			if (end - begin < 2) continue;
+
+			auto mid = begin + (end - begin) / 2;
+			std::nth_element(this->_m_tree.begin() + static_cast<std::ptrdiff_t>(begin),
+			                 this->_m_tree.begin() + static_cast<std::ptrdiff_t>(mid),
+			                 this->_m_tree.begin() + static_cast<std::ptrdiff_t>(end),
+			                 [this, axis = axis](std::uint32_t a, std::uint32_t b) {
+				                 return this->positions[a][axis] < this->positions[b][axis];
+			                 });
+
+			stack.push_back({begin, mid, (axis + 1) % 3});
+			stack.push_back({mid + 1, end, (axis + 1) % 3});
+		}
+	}
+
+	std::optional<float> WayNetGraph::find_path(std::uint32_t from,
+	                                            std::uint32_t to,
+	                                            std::vector<std::uint32_t>& path,
+	                                            WayNetScratch& scratch) const {
+		path.clear();
+
+		auto count = this->positions.size();
+		if (from >= count || to >= count) return std::nullopt;
+
+		if (scratch._m_stamp.size() != count) {
+			scratch._m_cost.resize(count);
+			scratch._m_parent.resize(count);
+			scratch._m_stamp.assign(count, 0);
+			scratch._m_generation = 0;
+		}
+
+		// Waypoints are only valid for the current query if their stamp matches, so the buffers never need to be
+		// cleared between queries.
+		if (++scratch._m_generation == 0) {
+			std::fill(scratch._m_stamp.begin(), scratch._m_stamp.end(), 0);
+			scratch._m_generation = 1;
+		}
+
+		auto generation = scratch._m_generation;
+		auto& cost = scratch._m_cost;
+		auto& parent = scratch._m_parent;
+		auto& stamp = scratch._m_stamp;
+		auto& open = scratch._m_open;
+
+		auto goal = this->positions[to];
+		auto compare = [](WayNetScratch::Entry const& a, WayNetScratch::Entry const& b) {
+			return a.priority > b.priority;
+		};
+
+		open.clear();
+		open.push_back({distance(this->positions[from], goal), from});
+		cost[from] = 0;
+		parent[from] = NO_PARENT;
+		stamp[from] = generation;
+
+		auto found = false;
+		while (!open.empty()) {
+			std::pop_heap(open.begin(), open.end(), compare);
+			auto [priority, current] = open.back();
+			open.pop_back();
+
+			if (current == to) {
+				found = true;
+				break;
+			}
+
+			// Skip entries which were superseded by a shorter path to the same waypoint.
+			if (priority > cost[current] + distance(this->positions[current], goal)) continue;
+
+			for (auto i = this->offsets[current]; i < this->offsets[current + 1]; ++i) {
+				auto next = this->targets[i];
+				auto next_cost = cost[current] + this->costs[i];
+				if (stamp[next] == generation && next_cost >= cost[next]) continue;
+
+				stamp[next] = generation;
+				cost[next] = next_cost;
+				parent[next] = current;
+				open.push_back({next_cost + distance(this->positions[next], goal), next});
+				std::push_heap(open.begin(), open.end(), compare);
+			}
+		}
+
+		if (!found) return std::nullopt;
+
+		for (auto waypoint = to; waypoint != NO_PARENT; waypoint = parent[waypoint]) {
+			path.push_back(waypoint);
+		}
+
+		std::reverse(path.begin(), path.end());
+		return cost[to];
+	}
+
+	std::optional<float>
+	WayNetGraph::find_path(std::uint32_t from, std::uint32_t to, std::vector<std::uint32_t>& path) const {
+		WayNetScratch scratch {};
+		return this->find_path(from, to, path, scratch);
+	}
+
+	void WayNetGraph::distances(std::vector<std::uint32_t> const& sources,
+	                            std::vector<float>& distances,
+	                            WayNetScratch& scratch) const {
+		distances.resize(this->positions.size());
+		this->dijkstra(sources.data(), sources.size(), distances.data(), scratch);
+	}
+
+	void WayNetGraph::dijkstra(std::uint32_t const* sources,
+	                           std::size_t source_count,
+	                           float* distances,
+	                           WayNetScratch& scratch) const {
+		auto count = this->positions.size();
+		std::fill(distances, distances + count, std::numeric_limits<float>::infinity());
+
+		auto& open = scratch._m_open;
+		auto compare = [](WayNetScratch::Entry const& a, WayNetScratch::Entry const& b) {
+			return a.priority > b.priority;
+		};
+
+		open.clear();
+		for (auto i = 0u; i < source_count; ++i) {
+			if (sources[i] >= count || distances[sources[i]] == 0) continue;
+			distances[sources[i]] = 0;
+			open.push_back({0, sources[i]});
+		}
+
+		while (!open.empty()) {
+			std::pop_heap(open.begin(), open.end(), compare);
+			auto [cost, current] = open.back();
+			open.pop_back();
+
+			// Skip entries which were superseded by a shorter path to the same waypoint.
+			if (cost > distances[current]) continue;
+
+			for (auto i = this->offsets[current]; i < this->offsets[current + 1]; ++i) {
+				auto next = this->targets[i];
+				auto next_cost = cost + this->costs[i];
+				if (next_cost >= distances[next]) continue;
+
+				distances[next] = next_cost;
+				open.push_back({next_cost, next});
+				std::push_heap(open.begin(), open.end(), compare);
+			}
+		}
+	}
+
+	WayNetDistanceTable WayNetGraph::build_distance_table(std::vector<std::uint32_t> const& targets) const {
+		auto count = this->positions.size();
+
+		WayNetDistanceTable table {};
+		table.fingerprint = this->fingerprint();
+		table.waypoint_count = static_cast<std::uint32_t>(count);
+		table.targets = targets;
+
+		// Sorted targets allow for binary searches when looking up distances.
+		std::sort(table.targets.begin(), table.targets.end());
+		table.targets.erase(std::unique(table.targets.begin(), table.targets.end()), table.targets.end());
+		table.targets.erase(std::lower_bound(table.targets.begin(), table.targets.end(), count), table.targets.end());
+		table.distances.resize(table.targets.size() * count);
+
+		// Edges can be travelled in both directions, so the distances to a target are the distances from it. Each
+		// thread reuses its scratch space for all of the targets it handles.
+		std::atomic_size_t next {0};
+		auto work = [this, &table, &next, count](std::size_t) {
+			WayNetScratch scratch {};
+			for (auto i = next++; i < table.targets.size(); i = next++) {
+				this->dijkstra(&table.targets[i], 1, table.distances.data() + i * count, scratch);
+			}
+		};
+
+		auto thread_count = std::min(table.targets.size(), get_executor()->concurrency() + 1);
+		parallel_for(thread_count, work);
+		return table;
+	}
+
+	WayNetDistanceTable WayNetGraph::build_distance_table() const {
+		std::vector<std::uint32_t> targets(this->positions.size());
+		std::iota(targets.begin(), targets.end(), 0);
+		return this->build_distance_table(targets);
+	}
+
+	std::uint64_t WayNetGraph::fingerprint() const noexcept {
+		// FNV-1a over the waypoints and edges.
+		std::uint64_t hash = 0xcbf29ce484222325;
+		auto mix = [&hash](std::uint64_t v) {
+			for (auto i = 0u; i < 8; ++i) {
+				hash ^= (v >> (i * 8)) & 0xFF;
+				hash *= 0x100000001b3;
+			}
+		};
+
+		auto mix_float = [&mix](float v) {
+			std::uint32_t bits;
+			std::memcpy(&bits, &v, sizeof bits);
+			mix(bits);
+		};
+
+		mix(this->positions.size());
+		for (auto const& position : this->positions) {
+			mix_float(position.x);
+			mix_float(position.y);
+			mix_float(position.z);
+		}
+
+		mix(this->targets.size());
+		for (auto target : this->targets) {
+			mix(target);
+		}
+
+		for (auto offset : this->offsets) {
+			mix(offset);
+		}
+
+		return hash;
+	}
+
+	std::optional<std::uint32_t> WayNetGraph::nearest_waypoint(Vec3 const& position) const {
+		if (this->_m_tree.empty()) return std::nullopt;
+
+		auto best = this->_m_tree[0];
+		auto best_distance = std::numeric_limits<float>::max();
+		this->nearest(0, this->_m_tree.size(), 0, position, best, best_distance);
+		return best;
+	}
+
+	void WayNetGraph::nearest(std::size_t begin,
+	                          std::size_t end,
+	                          unsigned axis,
+	                          Vec3 const& position,
+	                          std::uint32_t& best,
+	                          float& best_distance) const {
+		if (begin >= end) return;
+
+		auto mid = begin + (end - begin) / 2;
+		auto waypoint = this->_m_tree[mid];
+		auto& point = this->positions[waypoint];
+
+		auto x = point.x - position.x;
+		auto y = point.y - position.y;
+		auto z = point.z - position.z;
+		auto d = x * x + y * y + z * z;
+		if (d < best_distance) {
+			best_distance = d;
+			best = waypoint;
+		}
+
+		// Search the side of the splitting plane containing the position first. The other side can only contain
+		// a closer waypoint if the plane itself is closer than the best waypoint found so far.
+		auto delta = position[axis] - point[axis];
+		auto next_axis = (axis + 1) % 3;
+
+		if (delta < 0) {
+			this->nearest(begin, mid, next_axis, position, best, best_distance);
+			if (delta * delta < best_distance) this->nearest(mid + 1, end, next_axis, position, best, best_distance);
+		} else {
+			this->nearest(mid + 1, end, next_axis, position, best, best_distance);
+			if (delta * delta < best_distance) this->nearest(begin, mid, next_axis, position, best, best_distance);
+		}
+	}
+
+	bool WayNetDistanceTable::load(Read* r, WayNetGraph const& graph) {
+		char magic[sizeof DISTANCE_TABLE_MAGIC];
+		if (r->read(magic, sizeof magic) != sizeof magic ||
+		    std::memcmp(magic, DISTANCE_TABLE_MAGIC, sizeof magic) != 0 || r->read_uint() != DISTANCE_TABLE_VERSION) {
+			return false;
+		}
+
+		std::uint64_t hash = 0;
+		if (r->read(&hash, sizeof hash) != sizeof hash || hash != graph.fingerprint()) return false;
+
+		auto count = r->read_uint();
+		if (count != graph.size()) return false;
+
+		std::vector<std::uint32_t> target_data(r->read_uint());
+		auto size = target_data.size() * sizeof(std::uint32_t);
+		if (r->read(target_data.data(), size) != size) return false;
+		if (!std::is_sorted(target_data.begin(), target_data.end()) ||
+		    (!target_data.empty() && target_data.back() >= count)) {
+			return false;
+		}
+
+		std::vector<float> distance_data(target_data.size() * count);
+		size = distance_data.size() * sizeof(float);
+		if (r->read(distance_data.data(), size) != size) return false;
+
+		this->fingerprint = hash;
+		this->waypoint_count = count;
+		this->targets = std::move(target_data);
+		this->distances = std::move(distance_data);
+		return true;
+	}
+
+	void WayNetDistanceTable::save(Write* w) const {
+		w->write(DISTANCE_TABLE_MAGIC, sizeof DISTANCE_TABLE_MAGIC);
+		w->write_uint(DISTANCE_TABLE_VERSION);
+		w->write(&this->fingerprint, sizeof this->fingerprint);
+		w->write_uint(this->waypoint_count);
+		w->write_uint(static_cast<std::uint32_t>(this->targets.size()));
+		w->write(this->targets.data(), this->targets.size() * sizeof(std::uint32_t));
+		w->write(this->distances.data(), this->distances.size() * sizeof(float));
+	}
+
+	std::optional<float> WayNetDistanceTable::distance(std::uint32_t waypoint, std::uint32_t target) const {
+		if (waypoint >= this->waypoint_count) return std::nullopt;
+
+		auto it = std::lower_bound(this->targets.begin(), this->targets.end(), target);
+		if (it == this->targets.end() || *it != target) return std::nullopt;
+
+		auto row = static_cast<std::size_t>(it - this->targets.begin());
+		auto index = row * this->waypoint_count + waypoint;
+		if (index >= this->distances.size() || std::isinf(this->distances[index])) return std::nullopt;
+
+		return this->distances[index];
+	}
+} // namespace zenkit
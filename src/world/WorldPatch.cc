@@ -0,0 +1,440 @@
+// Copyright © 2021-2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include "zenkit/world/WorldPatch.hh"
+#include "zenkit/Archive.hh"
+#include "zenkit/Stream.hh"
+#include "zenkit/World.hh"
+#include "zenkit/vobs/Misc.hh"
+
+#include "../Internal.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+
+namespace zenkit {
+	namespace {
+		struct PatchNode {
+			std::shared_ptr<VirtualObject> vob;
+			VirtualObject* parent;
+		};
+
+		/// \brief All VObs of a world by their key, in pre-order.
+		struct PatchIndex {
+			std::vector<std::string> order;
+			std::unordered_map<std::string, PatchNode> nodes;
+			std::unordered_map<VirtualObject const*, std::string> keys;
+
+			/// \brief The number of VObs with each name which were indexed so far.
+			std::unordered_map<std::string, std::uint32_t> seen;
+		};
+
+		/// \brief A VOb stored in an archive of its own, without its children.
+		struct PatchBlob {
+			std::vector<std::byte> data;
+			size_t begin; ///< The offset of the VOb in #data, after the archive header.
+
+			bool operator==(PatchBlob const& other) const {
+				// The archive header contains the current time, exclude it.
+				return std::equal(data.begin() + static_cast<std::ptrdiff_t>(begin),
+				                  data.end(),
+				                  other.data.begin() + static_cast<std::ptrdiff_t>(other.begin),
+				                  other.data.end());
+			}
+		};
+	} // namespace
+
+	static void patch_count_names(std::vector<std::shared_ptr<VirtualObject>> const& vobs,
+	                              std::unordered_map<std::string, int>& names) {
+		for (auto const& vob : vobs) {
+			if (vob == nullptr) continue;
+			if (!vob->vob_name.empty()) ++names[vob->vob_name];
+			patch_count_names(vob->children, names);
+		}
+	}
+
+	static void patch_index(std::vector<std::shared_ptr<VirtualObject>> const& vobs,
+	                        VirtualObject* parent,
+	                        std::unordered_map<std::string, int> const& names,
+	                        PatchIndex& index) {
+		for (auto const& vob : vobs) {
+			if (vob == nullptr) continue;
+
+			auto it = names.find(vob->vob_name);
+			auto key = WorldPatch::key(*vob, it != names.end() && it->second == 1, index.seen[vob->vob_name]++);
+
+			if (!index.nodes.emplace(key, PatchNode {vob, parent}).second) {
+				ZKLOGW("WorldPatch", "Duplicate VOb key %s, ignoring VOb", key.c_str());
+				continue;
+			}
+
+			index.order.push_back(key);
+			index.keys.emplace(vob.get(), key);
+			patch_index(vob->children, vob.get(), names, index);
+		}
+	}
+
+	static PatchIndex patch_index(std::vector<std::shared_ptr<VirtualObject>> const& roots) {
+		std::unordered_map<std::string, int> names;
+		patch_count_names(roots, names);
+
+		PatchIndex index;
+		patch_index(roots, nullptr, names, index);
+		return index;
+	}
+
+	/// \brief Copies the NPCs of a world into a list of VObs, so they can be patched like a VOb tree.
+	static std::vector<std::shared_ptr<VirtualObject>> patch_npcs(World const& world) {
+		return {world.npcs.begin(), world.npcs.end()};
+	}
+
+	static PatchBlob patch_serialize(VirtualObject const& vob, GameVersion version, bool save_game) {
+		PatchBlob blob;
+		auto w = Write::to(&blob.data);
+		auto ar = save_game ? WriteArchive::to_save(w.get(), ArchiveFormat::BINARY)
+		                    : WriteArchive::to(w.get(), ArchiveFormat::BINARY);
+
+		blob.begin = w->tell();
+		ar->write_object("%", &vob, version);
+		ar->write_header();
+		return blob;
+	}
+
+	/// \brief Reads an object of any VOb class. ReadArchive::read_object<VirtualObject> only accepts `zCVob` itself.
+	static std::shared_ptr<VirtualObject> patch_read_vob(ReadArchive& ar, GameVersion version) {
+		auto obj = ar.read_object(version);
+		if (obj == nullptr || !is_vobject(obj->get_object_type())) return nullptr;
+
+		// NOTE: The NDK does not seem to support `reinterpret_pointer_cast`.
+		return std::shared_ptr<VirtualObject> {obj, reinterpret_cast<VirtualObject*>(obj.get())};
+	}
+
+	/// \brief Copies a VOb without its children, so that patches do not share VObs with the world they were made from.
+	static std::shared_ptr<VirtualObject> patch_copy(PatchBlob const& blob, uint32_t id, GameVersion version) {
+		auto r = Read::from(&blob.data);
+		auto ar = ReadArchive::from(r.get());
+
+		auto vob = patch_read_vob(*ar, version);
+		if (vob != nullptr) vob->id = id;
+		return vob;
+	}
+
+	std::string WorldPatch::key(VirtualObject const& vob, bool unique_name, std::uint32_t occurrence) {
+		if (unique_name && !vob.vob_name.empty()) return vob.vob_name;
+
+		// VirtualObject::id is the index of the VOb in the archive it was loaded from, so it changes whenever a VOb
+		// is added before it. The order of VObs with the same name only changes if one of them is moved.
+		return "#" + std::to_string(occurrence) + ":" + vob.vob_name;
+	}
+
+	static void patch_diff(std::vector<std::shared_ptr<VirtualObject>> const& base,
+	                       std::vector<std::shared_ptr<VirtualObject>> const& target,
+	                       GameVersion version,
+	                       bool save_game,
+	                       std::vector<std::string>& removed,
+	                       std::vector<WorldPatchEntry>& changed) {
+		auto from = patch_index(base);
+		auto to = patch_index(target);
+
+		for (auto const& key : to.order) {
+			auto const& node = to.nodes.at(key);
+			auto parent = node.parent == nullptr ? std::string {} : to.keys.at(node.parent);
+
+			auto blob = patch_serialize(*node.vob, version, save_game);
+
+			auto it = from.nodes.find(key);
+			if (it != from.nodes.end()) {
+				auto const& old = it->second;
+				auto old_parent = old.parent == nullptr ? std::string {} : from.keys.at(old.parent);
+
+				if (old_parent == parent && patch_serialize(*old.vob, version, save_game) == blob) continue;
+			}
+
+			auto vob = patch_copy(blob, node.vob->id, version);
+			changed.push_back(WorldPatchEntry {key, std::move(parent), std::move(vob)});
+		}
+
+		for (auto const& key : from.order) {
+			if (to.nodes.find(key) != to.nodes.end()) continue;
+
+			// Removing a VOb also removes its children, so only the topmost removed VOb has to be recorded.
+			auto const* parent = from.nodes.at(key).parent;
+			if (parent != nullptr && to.nodes.find(from.keys.at(parent)) == to.nodes.end()) continue;
+
+			removed.push_back(key);
+		}
+	}
+
+	WorldPatch WorldPatch::diff(World const& base, World const& target, GameVersion version, bool save_game) {
+		WorldPatch patch;
+		patch.save_game = save_game;
+		patch_diff(base.world_vobs, target.world_vobs, version, save_game, patch.removed, patch.changed);
+
+		if (!save_game) return patch;
+
+		auto npcs = patch_npcs(target);
+		patch_diff(patch_npcs(base), npcs, version, true, patch.removed_npcs, patch.changed_npcs);
+
+		// Spawn locations usually refer to NPCs of the world. Those are stored by key so they are shared again
+		// when the patch is applied.
+		auto index = patch_index(npcs);
+		for (auto const& spawn : target.npc_spawns) {
+			WorldPatchSpawn entry {{}, nullptr, spawn.position, spawn.timer};
+
+			if (auto it = index.keys.find(spawn.npc.get()); it != index.keys.end()) {
+				entry.npc = it->second;
+			} else if (spawn.npc != nullptr) {
+				auto copy = patch_copy(patch_serialize(*spawn.npc, version, true), spawn.npc->id, version);
+				entry.vob = std::dynamic_pointer_cast<VNpc>(copy);
+			}
+
+			patch.npc_spawns.push_back(std::move(entry));
+		}
+
+		patch.npc_spawn_enabled = target.npc_spawn_enabled;
+		patch.npc_spawn_flags = target.npc_spawn_flags;
+
+		if (target.sky_controller != nullptr) {
+			patch.sky_controller = std::make_shared<SkyController>(*target.sky_controller);
+		}
+
+		return patch;
+	}
+
+	static std::vector<std::shared_ptr<VirtualObject>>&
+	patch_children(std::vector<std::shared_ptr<VirtualObject>>& roots, VirtualObject* parent) {
+		return parent == nullptr ? roots : parent->children;
+	}
+
+	static void patch_apply(std::vector<std::shared_ptr<VirtualObject>>& roots,
+	                        std::vector<std::string> const& removed,
+	                        std::vector<WorldPatchEntry>& changed) {
+		auto index = patch_index(roots);
+
+		auto resolve_parent = [&index](std::string const& key) -> VirtualObject* {
+			if (key.empty()) return nullptr;
+
+			auto it = index.nodes.find(key);
+			if (it == index.nodes.end()) {
+				ZKLOGW("WorldPatch", "Parent VOb %s not found, adding as a root VOb", key.c_str());
+				return nullptr;
+			}
+
+			return it->second.vob.get();
+		};
+
+		for (auto& entry : changed) {
+			if (entry.vob == nullptr) continue;
+
+			auto* parent = resolve_parent(entry.parent);
+			auto& siblings = patch_children(roots, parent);
+
+			auto it = index.nodes.find(entry.key);
+			if (it == index.nodes.end()) {
+				siblings.push_back(entry.vob);
+			} else {
+				auto& old = it->second;
+				auto& old_siblings = patch_children(roots, old.parent);
+				auto pos = std::find(old_siblings.begin(), old_siblings.end(), old.vob);
+
+				entry.vob->id = old.vob->id;
+				entry.vob->children = std::move(old.vob->children);
+
+				if (old.parent == parent && pos != old_siblings.end()) {
+					*pos = entry.vob;
+				} else {
+					if (pos != old_siblings.end()) old_siblings.erase(pos);
+					siblings.push_back(entry.vob);
+				}
+
+				index.keys.erase(old.vob.get());
+			}
+
+			for (auto const& child : entry.vob->children) {
+				if (auto key = index.keys.find(child.get()); key != index.keys.end()) {
+					index.nodes.at(key->second).parent = entry.vob.get();
+				}
+			}
+
+			index.nodes.insert_or_assign(entry.key, PatchNode {entry.vob, parent});
+			index.keys.insert_or_assign(entry.vob.get(), entry.key);
+		}
+
+		for (auto const& key : removed) {
+			auto it = index.nodes.find(key);
+			if (it == index.nodes.end()) {
+				ZKLOGW("WorldPatch", "VOb %s not found, cannot remove it", key.c_str());
+				continue;
+			}
+
+			auto& siblings = patch_children(roots, it->second.parent);
+			siblings.erase(std::remove(siblings.begin(), siblings.end(), it->second.vob), siblings.end());
+		}
+	}
+
+	void WorldPatch::apply(World& world) {
+		patch_apply(world.world_vobs, this->removed, this->changed);
+
+		if (this->save_game) {
+			auto npcs = patch_npcs(world);
+			patch_apply(npcs, this->removed_npcs, this->changed_npcs);
+
+			world.npcs.clear();
+			for (auto& npc : npcs) {
+				if (auto cast = std::dynamic_pointer_cast<VNpc>(npc)) world.npcs.push_back(std::move(cast));
+			}
+
+			auto index = patch_index(npcs);
+			world.npc_spawns.clear();
+
+			for (auto& spawn : this->npc_spawns) {
+				auto npc = std::move(spawn.vob);
+
+				if (!spawn.npc.empty()) {
+					auto it = index.nodes.find(spawn.npc);
+					if (it == index.nodes.end()) {
+						ZKLOGW("WorldPatch", "Spawned NPC %s not found", spawn.npc.c_str());
+					} else {
+						npc = std::dynamic_pointer_cast<VNpc>(it->second.vob);
+					}
+				}
+
+				world.npc_spawns.push_back(SpawnLocation {std::move(npc), spawn.position, spawn.timer});
+			}
+
+			world.npc_spawn_enabled = this->npc_spawn_enabled;
+			world.npc_spawn_flags = this->npc_spawn_flags;
+			if (this->sky_controller != nullptr) world.sky_controller = std::move(this->sky_controller);
+		}
+
+		world.invalidate_vob_index();
+
+		this->changed.clear();
+		this->removed.clear();
+		this->changed_npcs.clear();
+		this->removed_npcs.clear();
+		this->npc_spawns.clear();
+		this->sky_controller = nullptr;
+	}
+
+	static void patch_read_entries(ReadArchive& ar, GameVersion version, std::vector<WorldPatchEntry>& entries) {
+		auto count = ar.read_int(); // changed
+		entries.clear();
+		entries.reserve(static_cast<size_t>(std::max(count, 0)));
+
+		for (auto i = 0; i < count; ++i) {
+			WorldPatchEntry entry;
+			entry.key = ar.read_string();    // key
+			entry.parent = ar.read_string(); // parent
+			auto id = ar.read_int();         // id
+
+			entry.vob = patch_read_vob(ar, version); // vob
+			if (entry.vob == nullptr) {
+				throw ParserError {"WorldPatch", "invalid VOb for " + entry.key};
+			}
+
+			entry.vob->id = static_cast<uint32_t>(id);
+			entries.push_back(std::move(entry));
+		}
+	}
+
+	static void patch_read_keys(ReadArchive& ar, std::vector<std::string>& keys) {
+		auto count = ar.read_int(); // removed
+		keys.clear();
+		keys.reserve(static_cast<size_t>(std::max(count, 0)));
+
+		for (auto i = 0; i < count; ++i) {
+			keys.push_back(ar.read_string()); // key
+		}
+	}
+
+	static void
+	patch_write_entries(WriteArchive& ar, GameVersion version, std::vector<WorldPatchEntry> const& entries) {
+		ar.write_int("changed", static_cast<int32_t>(entries.size()));
+		for (auto const& entry : entries) {
+			ar.write_string("key", entry.key);
+			ar.write_string("parent", entry.parent);
+			ar.write_int("id", static_cast<int32_t>(entry.vob->id));
+
+			// Children are recorded as separate entries.
+			ar.write_object("vob", static_cast<Object const*>(entry.vob.get()), version);
+		}
+	}
+
+	static void patch_write_keys(WriteArchive& ar, std::vector<std::string> const& keys) {
+		ar.write_int("removed", static_cast<int32_t>(keys.size()));
+		for (auto const& key : keys) {
+			ar.write_string("key", key);
+		}
+	}
+
+	void WorldPatch::load(Read* r, GameVersion version) {
+		auto ar = ReadArchive::from(r);
+
+		ArchiveObject obj;
+		if (!ar->read_object_begin(obj) || obj.object_name != "WorldPatch") {
+			throw ParserError {"WorldPatch", "'WorldPatch' chunk expected, got '" + obj.object_name + "'"};
+		}
+
+		patch_read_keys(*ar, this->removed);
+		patch_read_entries(*ar, version, this->changed);
+
+		// Patches of save-games additionally contain the NPCs of the world.
+		this->save_game = ar->is_save_game();
+		this->removed_npcs.clear();
+		this->changed_npcs.clear();
+		this->npc_spawns.clear();
+		this->sky_controller = nullptr;
+
+		if (this->save_game) {
+			patch_read_keys(*ar, this->removed_npcs);
+			patch_read_entries(*ar, version, this->changed_npcs);
+
+			auto spawn_count = ar->read_int(); // spawns
+			for (auto i = 0; i < spawn_count; ++i) {
+				auto& spawn = this->npc_spawns.emplace_back();
+				spawn.npc = ar->read_string();              // npc
+				spawn.vob = ar->read_object<VNpc>(version); // vob
+				spawn.position = ar->read_vec3();           // spawnPos
+				spawn.timer = ar->read_float();             // timer
+			}
+
+			this->npc_spawn_enabled = ar->read_bool();                      // spawningEnabled
+			this->npc_spawn_flags = ar->read_int();                         // spawnFlags
+			this->sky_controller = ar->read_object<SkyController>(version); // sky
+		}
+
+		if (!ar->read_object_end()) {
+			ZKLOGW("WorldPatch", "Not fully parsed");
+			ar->skip_object(true);
+		}
+	}
+
+	void WorldPatch::save(Write* w, GameVersion version, ArchiveFormat format) const {
+		auto ar = this->save_game ? WriteArchive::to_save(w, format) : WriteArchive::to(w, format);
+		ar->write_object_begin("WorldPatch", "", 0);
+
+		patch_write_keys(*ar, this->removed);
+		patch_write_entries(*ar, version, this->changed);
+
+		if (this->save_game) {
+			patch_write_keys(*ar, this->removed_npcs);
+			patch_write_entries(*ar, version, this->changed_npcs);
+
+			ar->write_int("spawns", static_cast<int32_t>(this->npc_spawns.size()));
+			for (auto const& spawn : this->npc_spawns) {
+				ar->write_string("npc", spawn.npc);
+				ar->write_object("vob", static_cast<Object const*>(spawn.vob.get()), version);
+				ar->write_vec3("spawnPos", spawn.position);
+				ar->write_float("timer", spawn.timer);
+			}
+
+			ar->write_bool("spawningEnabled", this->npc_spawn_enabled);
+			ar->write_int("spawnFlags", this->npc_spawn_flags);
+			ar->write_object("sky", static_cast<Object const*>(this->sky_controller.get()), version);
+		}
+
+		ar->write_object_end();
+		ar->write_header();
+	}
+} // namespace zenkit
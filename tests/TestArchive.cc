@@ -3,9 +3,20 @@
 #include <zenkit/Archive.hh>
 #include <zenkit/Stream.hh>
 #include <zenkit/Error.hh>
+#include <zenkit/World.hh>
+#include <zenkit/vobs/Light.hh>
+#include <zenkit/vobs/Misc.hh>
+#include <zenkit/vobs/MovableObject.hh>
+#include <zenkit/vobs/Sound.hh>
+#include <zenkit/world/VobTree.hh>
 
 #include <doctest/doctest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+
 TEST_SUITE("ReadArchive") {
 	TEST_CASE("ReadArchive.from(ASCII)") {
 		zenkit::Logger::set_default(zenkit::LogLevel::DEBUG);
@@ -91,6 +102,375 @@ TEST_SUITE("ReadArchive") {
 		REQUIRE_THROWS_AS(reader->read_float(), zenkit::ParserError);
 	}
 
+	TEST_CASE("ReadArchive.from(ASCII,numbers)") {
+		std::string_view text = "ZenGin Archive\nver 1\nzCArchiverGeneric\nASCII\nsaveGame 0\n"
+		                        "date 01.01.2001 00:00:00\nuser luis\nEND\nobjects 1\nEND\n\n"
+		                        "[%  zCVob   3   0]\n"
+		                        "\ta=int:+12\n"
+		                        "\tb=int:-1\n"
+		                        "\tc=float:-1.5e2\n"
+		                        "\td=vec3:1 2\n"
+		                        "\te=int:nope\n"
+		                        "\tf=int:99999999999\n"
+		                        "[]\n";
+
+		std::vector<std::byte> buf {reinterpret_cast<std::byte const*>(text.data()),
+		                            reinterpret_cast<std::byte const*>(text.data() + text.size())};
+		auto in = zenkit::Read::from(std::move(buf));
+		auto reader = zenkit::ReadArchive::from(in.get());
+
+		zenkit::ArchiveObject obj;
+		REQUIRE(reader->read_object_begin(obj));
+		CHECK_EQ(obj.object_name, "%");
+		CHECK_EQ(obj.class_name, "zCVob");
+		CHECK_EQ(obj.version, 3);
+		CHECK_EQ(obj.index, 0);
+
+		CHECK_EQ(reader->read_int(), 12);
+		CHECK_EQ(reader->read_byte(), 0xFF);
+		CHECK_EQ(reader->read_float(), -150.0f);
+
+		auto v = reader->read_vec3();
+		CHECK_EQ(v.x, 1.0f);
+		CHECK_EQ(v.y, 2.0f);
+		CHECK_EQ(v.z, 0.0f);
+
+		CHECK_THROWS_AS(reader->read_int(), zenkit::ParserError);
+		CHECK_THROWS_AS(reader->read_int(), zenkit::ParserError);
+		CHECK(reader->read_object_end());
+	}
+
+	TEST_CASE("ReadArchive.set_class_filter") {
+		// zCVob -> oCItem -> zCVob
+		auto grandchild = std::make_shared<zenkit::VirtualObject>();
+		grandchild->type = zenkit::VirtualObjectType::zCVob;
+		grandchild->vob_name = "grandchild";
+
+		auto child = std::make_shared<zenkit::VItem>();
+		child->type = zenkit::VirtualObjectType::oCItem;
+		child->vob_name = "child";
+		child->visual = std::make_shared<zenkit::VisualMultiResolutionMesh>();
+		child->visual->type = zenkit::VisualType::MULTI_RESOLUTION_MESH;
+		child->visual->name = "ITMW_1H_SWORD_01.3DS";
+		child->children.push_back(grandchild);
+
+		auto root = std::make_shared<zenkit::VirtualObject>();
+		root->type = zenkit::VirtualObjectType::zCVob;
+		root->vob_name = "root";
+		root->children.push_back(child);
+
+		std::vector<std::byte> data {};
+		auto out = zenkit::Write::to(&data);
+		auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::BINARY);
+		zenkit::save_vob_tree(*out_ar, zenkit::GameVersion::GOTHIC_1, root);
+		out_ar->write_header();
+
+		// Skipped VObs pass their loaded children up to the closest loaded ancestor.
+		{
+			auto r = zenkit::Read::from(&data);
+			auto ar = zenkit::ReadArchive::from(r.get());
+			ar->set_class_filter({zenkit::ObjectType::oCItem});
+			CHECK(ar->is_class_loaded(zenkit::ObjectType::oCItem));
+			CHECK_FALSE(ar->is_class_loaded(zenkit::ObjectType::zCVob));
+
+			std::vector<std::shared_ptr<zenkit::VirtualObject>> vobs;
+			zenkit::parse_vob_tree(*ar, zenkit::GameVersion::GOTHIC_1, vobs);
+
+			REQUIRE_EQ(vobs.size(), 1);
+			CHECK_EQ(vobs[0]->type, zenkit::VirtualObjectType::oCItem);
+			CHECK_EQ(vobs[0]->vob_name, "child");
+			CHECK(vobs[0]->children.empty());
+
+			// Only VObs are filtered, the objects they contain are still loaded.
+			CHECK(ar->is_class_loaded(zenkit::ObjectType::zCProgMeshProto));
+			REQUIRE_NE(vobs[0]->visual, nullptr);
+			CHECK_EQ(vobs[0]->visual->type, zenkit::VisualType::MULTI_RESOLUTION_MESH);
+			CHECK_EQ(vobs[0]->visual->name, "ITMW_1H_SWORD_01.3DS");
+		}
+
+		{
+			auto r = zenkit::Read::from(&data);
+			auto ar = zenkit::ReadArchive::from(r.get());
+			ar->set_class_filter({zenkit::ObjectType::zCVob});
+
+			std::vector<std::shared_ptr<zenkit::VirtualObject>> vobs;
+			zenkit::parse_vob_tree(*ar, zenkit::GameVersion::GOTHIC_1, vobs);
+
+			REQUIRE_EQ(vobs.size(), 1);
+			CHECK_EQ(vobs[0]->vob_name, "root");
+			REQUIRE_EQ(vobs[0]->children.size(), 1);
+			CHECK_EQ(vobs[0]->children[0]->vob_name, "grandchild");
+		}
+	}
+
+	TEST_CASE("ReadArchive.seek_object") {
+		auto child = std::make_shared<zenkit::VItem>();
+		child->type = zenkit::VirtualObjectType::oCItem;
+		child->vob_name = "child";
+		child->instance = "ITMW_1H_SWORD_01";
+
+		auto root = std::make_shared<zenkit::VirtualObject>();
+		root->type = zenkit::VirtualObjectType::zCVob;
+		root->vob_name = "root";
+		root->children.push_back(child);
+
+		std::vector<std::byte> data {};
+		auto written = std::make_shared<zenkit::ArchiveIndex>();
+		{
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::BINARY);
+			out_ar->set_index(written);
+			zenkit::save_vob_tree(*out_ar, zenkit::GameVersion::GOTHIC_1, root);
+			out_ar->write_header();
+		}
+
+		REQUIRE_EQ(written->objects().size(), 2);
+
+		// Round-trip the index through its on-disk representation.
+		std::vector<std::byte> index_data {};
+		auto index_out = zenkit::Write::to(&index_data);
+		written->save(index_out.get());
+
+		auto index = std::make_shared<zenkit::ArchiveIndex>();
+		auto index_in = zenkit::Read::from(&index_data);
+		index->load(index_in.get());
+
+		REQUIRE_EQ(index->objects().size(), 2);
+
+		// Indices which claim to have more entries than they can hold are rejected.
+		auto broken = index_data;
+		broken[8] = std::byte {0xFF};
+		broken[11] = std::byte {0x7F};
+		auto broken_in = zenkit::Read::from(&broken);
+		CHECK_THROWS_AS(zenkit::ArchiveIndex {}.load(broken_in.get()), zenkit::ParserError);
+
+		auto const& loc = index->objects()[1];
+		CHECK_EQ(loc.class_name, "oCItem:zCVob");
+		CHECK_EQ(index->find(loc.index), &loc);
+		CHECK_EQ(index->find("%"), &index->objects()[0]);
+
+		auto r = zenkit::Read::from(&data);
+		auto ar = zenkit::ReadArchive::from(r.get());
+		CHECK_FALSE(ar->seek_object(loc.index));
+
+		ar->set_index(index);
+		REQUIRE(ar->seek_object(loc.index));
+
+		auto item = ar->read_object<zenkit::VItem>(zenkit::GameVersion::GOTHIC_1);
+		REQUIRE(item != nullptr);
+		CHECK_EQ(item->vob_name, "child");
+		CHECK_EQ(item->instance, "ITMW_1H_SWORD_01");
+	}
+
+	TEST_CASE("ReadArchive.read_object(references)") {
+		// Enough objects to make both the read and the write cache grow a couple of times.
+		std::vector<std::shared_ptr<zenkit::VirtualObject>> objects;
+		for (int i = 0; i < 1500; ++i) {
+			auto vob = std::make_shared<zenkit::VirtualObject>();
+			vob->type = zenkit::VirtualObjectType::zCVob;
+			vob->vob_name = "vob" + std::to_string(i);
+			objects.push_back(vob);
+		}
+
+		std::vector<std::byte> data {};
+		{
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::BINARY);
+			for (auto const& vob : objects) {
+				out_ar->write_object("vob", vob, zenkit::GameVersion::GOTHIC_1);
+			}
+
+			// The second time around, only references are written.
+			for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+				out_ar->write_object("ref", *it, zenkit::GameVersion::GOTHIC_1);
+			}
+
+			out_ar->write_header();
+		}
+
+		auto r = zenkit::Read::from(&data);
+		auto ar = zenkit::ReadArchive::from(r.get());
+
+		std::vector<std::shared_ptr<zenkit::VirtualObject>> loaded;
+		for (size_t i = 0; i < objects.size(); ++i) {
+			loaded.push_back(ar->read_object<zenkit::VirtualObject>(zenkit::GameVersion::GOTHIC_1));
+			REQUIRE(loaded.back() != nullptr);
+		}
+
+		CHECK_EQ(loaded[1234]->vob_name, "vob1234");
+
+		for (auto it = loaded.rbegin(); it != loaded.rend(); ++it) {
+			auto ref = ar->read_object<zenkit::VirtualObject>(zenkit::GameVersion::GOTHIC_1);
+			REQUIRE_EQ(ref, *it);
+		}
+
+		ar->clear_object_cache();
+		CHECK(r->eof());
+	}
+
+	TEST_CASE("VobStream.next") {
+		zenkit::World world {};
+		for (auto name : {"first", "second", "third"}) {
+			auto vob = std::make_shared<zenkit::VirtualObject>();
+			vob->type = zenkit::VirtualObjectType::zCVob;
+			vob->vob_name = name;
+
+			auto child = std::make_shared<zenkit::VirtualObject>();
+			child->type = zenkit::VirtualObjectType::zCVob;
+			child->vob_name = std::string {name} + "_child";
+			vob->children.push_back(child);
+
+			world.world_vobs.push_back(vob);
+		}
+
+		std::vector<std::byte> data {};
+		{
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::BINARY);
+			out_ar->write_object("%", &world, zenkit::GameVersion::GOTHIC_1);
+			out_ar->write_header();
+		}
+
+		auto r = zenkit::Read::from(&data);
+		auto stream = zenkit::VobStream::from(r.get(), zenkit::GameVersion::GOTHIC_1);
+		CHECK_EQ(stream->remaining(), 3);
+
+		for (auto name : {"first", "second", "third"}) {
+			auto vob = stream->next();
+			REQUIRE(vob != nullptr);
+			CHECK_EQ(vob->vob_name, name);
+			REQUIRE_EQ(vob->children.size(), 1);
+			CHECK_EQ(vob->children[0]->vob_name, std::string {name} + "_child");
+		}
+
+		CHECK_EQ(stream->remaining(), 0);
+		CHECK(stream->next() == nullptr);
+	}
+
+	TEST_CASE("VobStream.next(corrupt)") {
+		zenkit::World world {};
+		auto vob = std::make_shared<zenkit::VirtualObject>();
+		vob->type = zenkit::VirtualObjectType::zCVob;
+		vob->vob_name = "only";
+		world.world_vobs.push_back(vob);
+
+		std::vector<std::byte> data {};
+		{
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::ASCII);
+			out_ar->write_object("%", &world, zenkit::GameVersion::GOTHIC_1);
+			out_ar->write_header();
+		}
+
+		auto with_count = [&data](std::string_view count) {
+			std::string text {reinterpret_cast<char const*>(data.data()), data.size()};
+			auto pos = text.find("childs0=int:1");
+			REQUIRE_NE(pos, std::string::npos);
+			text.replace(pos, 13, "childs0=int:" + std::string {count});
+
+			std::vector<std::byte> bytes(text.size());
+			std::memcpy(bytes.data(), text.data(), text.size());
+			return bytes;
+		};
+
+		// A count which is too large must not read past the end of the VOb tree.
+		auto large = with_count("5");
+		auto r = zenkit::Read::from(&large);
+		auto stream = zenkit::VobStream::from(r.get(), zenkit::GameVersion::GOTHIC_1);
+		CHECK_EQ(stream->remaining(), 5);
+
+		auto first = stream->next();
+		REQUIRE(first != nullptr);
+		CHECK_EQ(first->vob_name, "only");
+		CHECK(stream->next() == nullptr);
+		CHECK_EQ(stream->remaining(), 0);
+
+		auto negative = with_count("-1");
+		r = zenkit::Read::from(&negative);
+		CHECK_THROWS_AS(zenkit::VobStream::from(r.get(), zenkit::GameVersion::GOTHIC_1), zenkit::ParserError);
+	}
+
+	TEST_CASE("ReadArchive.set_arena") {
+		auto arena = zenkit::ObjectArena::create(4096);
+
+		auto buf = zenkit::Read::from("./samples/G1/VOb/oCMobContainer.zen");
+		auto ar = zenkit::ReadArchive::from(buf.get());
+		ar->set_arena(arena);
+		CHECK_EQ(ar->get_arena(), arena);
+
+		auto obj = ar->read_object(zenkit::GameVersion::GOTHIC_1);
+		REQUIRE(obj != nullptr);
+		CHECK(obj->get_object_type() == zenkit::ObjectType::oCMobContainer);
+		CHECK_GT(arena->bytes_used(), 0);
+
+		CHECK_GE(arena->block_count(), 1);
+
+		std::weak_ptr<zenkit::ObjectArena> weak = arena;
+		arena.reset();
+		ar.reset();
+		CHECK_FALSE(weak.expired());
+		obj.reset();
+		CHECK(weak.expired());
+	}
+
+	TEST_CASE("ObjectArena.reset") {
+		auto arena = zenkit::ObjectArena::create(4096);
+
+		auto load = [&arena] {
+			auto buf = zenkit::Read::from("./samples/G1/VOb/oCMobContainer.zen");
+			auto ar = zenkit::ReadArchive::from(buf.get());
+			ar->set_arena(arena);
+			return ar->read_object(zenkit::GameVersion::GOTHIC_1);
+		};
+
+		auto obj = load();
+		REQUIRE(obj != nullptr);
+		auto used = arena->bytes_used();
+		auto blocks = arena->block_count();
+		(void) arena->allocate(8192, 8); // A block larger than the default block size
+
+		// Objects allocated in the arena are still alive.
+		CHECK_FALSE(arena->reset());
+		CHECK_GT(arena->bytes_used(), used);
+
+		obj.reset();
+		CHECK(arena->reset());
+		CHECK_EQ(arena->bytes_used(), 0);
+		CHECK_EQ(arena->block_count(), blocks);
+
+		// Loading the same object again reuses the blocks kept by the arena.
+		obj = load();
+		REQUIRE(obj != nullptr);
+		CHECK(obj->get_object_type() == zenkit::ObjectType::oCMobContainer);
+		CHECK_EQ(arena->bytes_used(), used);
+		CHECK_EQ(arena->block_count(), blocks);
+	}
+
+	TEST_CASE("ReadArchive.read_string_interned") {
+		auto pool = std::make_shared<zenkit::StringPool>();
+		CHECK_EQ(pool->size(), 1);
+		CHECK_EQ(pool->intern(""), 0);
+		CHECK_EQ(pool->intern("ZOMBIE.MDS"), 1);
+		CHECK_EQ(pool->intern(std::string {"ZOMBIE"} + ".MDS"), 1);
+		CHECK_EQ(pool->find("ZOMBIE.MDS"), 1);
+		CHECK_FALSE(pool->find("zombie.mds").has_value());
+		CHECK_EQ(pool->get(1), "ZOMBIE.MDS");
+		CHECK_EQ(pool->get(42), "");
+		CHECK_EQ(pool->bytes_used(), 10);
+
+		auto in = zenkit::Read::from("./samples/binary.zen");
+		auto reader = zenkit::ReadArchive::from(in.get());
+		reader->set_string_pool(pool);
+
+		auto first = reader->read_string_interned();
+		CHECK_EQ(pool->get(first), "DT_BOOKSHELF_V1_1");
+
+		zenkit::ArchiveObject obj;
+		REQUIRE(reader->read_object_begin(obj));
+		CHECK_EQ(reader->read_string_interned(), first);
+		CHECK_EQ(pool->size(), 3);
+	}
+
 	TEST_CASE("ReadArchive.open(BINARY)") {
 		auto in = zenkit::Read::from("./samples/binary.zen");
 		auto reader = zenkit::ReadArchive::from(in.get());
@@ -119,6 +499,265 @@ TEST_SUITE("ReadArchive") {
 		CHECK_EQ(reader->read_float(), 0.0f);
 	}
 
+	TEST_CASE("WriteArchive.to(BINSAFE)") {
+		// Write two archives so that the second one reuses the interned keys of the first.
+		for (auto i = 0; i < 2; ++i) {
+			std::vector<std::byte> data {};
+			{
+				auto out = zenkit::Write::to(&data);
+				auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::BINSAFE);
+				out_ar->write_object_begin("obj", "zCVob", 1);
+				out_ar->write_int("first", 42 + i);
+				out_ar->write_string("second", "hello");
+				out_ar->write_int("first", 7);
+				out_ar->write_object_end();
+
+				out_ar->write_object_begin("skipped", "zCVob", 1);
+				out_ar->write_string("second", "[not an object]");
+				out_ar->write_vec3("third", {1, 2, 3});
+				out_ar->write_object_begin("child", "zCVob", 1);
+				out_ar->write_raw("fourth", std::vector<std::byte>(300));
+				out_ar->write_object_end();
+				out_ar->write_object_end();
+
+				out_ar->write_int("first", 99);
+				out_ar->write_header();
+			}
+
+			auto r = zenkit::Read::from(&data);
+			auto ar = zenkit::ReadArchive::from(r.get());
+
+			zenkit::ArchiveObject obj;
+			REQUIRE(ar->read_object_begin(obj));
+			CHECK_EQ(obj.object_name, "obj");
+			CHECK_EQ(obj.class_name, "zCVob");
+			CHECK_EQ(ar->read_int(), 42 + i);
+			CHECK_EQ(ar->read_string(), "hello");
+			CHECK_EQ(ar->read_int(), 7);
+			CHECK(ar->read_object_end());
+
+			ar->skip_object(false);
+			CHECK_EQ(ar->read_int(), 99);
+		}
+	}
+
+	TEST_CASE("WriteArchive.to(ASCII,raw)") {
+		// Single-digit bytes following two-digit ones used to be written with a stale second digit.
+		std::vector<std::byte> bytes {std::byte {0xAB}, std::byte {0x01}, std::byte {0x10}, std::byte {0x0F}};
+
+		std::vector<std::byte> data {};
+		{
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::ASCII);
+			out_ar->write_object_begin("obj", "zCVob", 1);
+			out_ar->write_raw("raw", bytes);
+			out_ar->write_object_end();
+			out_ar->write_header();
+		}
+
+		auto r = zenkit::Read::from(&data);
+		auto ar = zenkit::ReadArchive::from(r.get());
+
+		zenkit::ArchiveObject obj;
+		REQUIRE(ar->read_object_begin(obj));
+
+		auto raw = ar->read_raw(bytes.size());
+		CHECK_EQ(raw->read_ubyte(), 0xAB);
+		CHECK_EQ(raw->read_ubyte(), 0x01);
+		CHECK_EQ(raw->read_ubyte(), 0x10);
+		CHECK_EQ(raw->read_ubyte(), 0x0F);
+		CHECK(ar->read_object_end());
+	}
+
+	/// \brief Forwards to another stream and remembers the end of the furthest read from it.
+	class WatermarkRead final : public zenkit::Read {
+	public:
+		explicit WatermarkRead(zenkit::Read* inner) : _m_inner(inner) {}
+
+		size_t read(void* buf, size_t len) noexcept override {
+			auto n = _m_inner->read(buf, len);
+			watermark = std::max(watermark, _m_inner->tell());
+			return n;
+		}
+
+		void seek(ssize_t off, zenkit::Whence whence) noexcept override {
+			_m_inner->seek(off, whence);
+		}
+
+		[[nodiscard]] size_t tell() const noexcept override {
+			return _m_inner->tell();
+		}
+
+		[[nodiscard]] bool eof() const noexcept override {
+			return _m_inner->eof();
+		}
+
+		size_t watermark = 0;
+
+	private:
+		zenkit::Read* _m_inner;
+	};
+
+	TEST_CASE("ReadArchive.open(BINSAFE,streaming)") {
+		std::vector<std::byte> data {};
+		{
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::BINSAFE);
+			out_ar->write_object_begin("obj", "zCVob", 1);
+			out_ar->write_int("first", 42);
+			out_ar->write_string("second", "hello");
+			out_ar->write_object_end();
+			out_ar->write_header();
+		}
+
+		// The hash table of entry names follows the objects. It must not be read when only reading values, so that
+		// archives can be parsed from streams which have not been fully received yet.
+		auto header_end = std::string_view {reinterpret_cast<char const*>(data.data()), data.size()}.find("END\n");
+		REQUIRE_NE(header_end, std::string_view::npos);
+
+		std::uint32_t hash_table_offset = 0;
+		std::memcpy(&hash_table_offset, data.data() + header_end + 4 + 8, sizeof hash_table_offset);
+		REQUIRE(hash_table_offset < data.size());
+
+		auto r = zenkit::Read::from(&data);
+		WatermarkRead w {r.get()};
+		auto ar = zenkit::ReadArchive::from(&w);
+
+		zenkit::ArchiveObject obj;
+		REQUIRE(ar->read_object_begin(obj));
+		CHECK_EQ(obj.object_name, "obj");
+		CHECK_EQ(ar->read_int(), 42);
+		CHECK_EQ(ar->read_string(), "hello");
+		CHECK(ar->read_object_end());
+		CHECK_LE(w.watermark, hash_table_offset);
+	}
+
+	TEST_CASE("ReadArchive.read_packed") {
+		auto light = std::make_shared<zenkit::VLight>();
+		light->type = zenkit::VirtualObjectType::zCVobLight;
+		light->light_type = zenkit::LightType::POINT;
+		light->range = 2500.5f;
+		light->color = {10, 20, 30, 255};
+		light->cone_angle = 45.0f;
+		light->is_static = true;
+		light->quality = zenkit::LightQuality::LOW;
+		light->lensflare_fx = "FLARE";
+
+		auto sound = std::make_shared<zenkit::VSound>();
+		sound->type = zenkit::VirtualObjectType::zCVobSound;
+		sound->volume = 80.0f;
+		sound->mode = zenkit::SoundMode::RANDOM;
+		sound->random_delay = 5.0f;
+		sound->random_delay_var = 2.0f;
+		sound->initially_playing = true;
+		sound->obstruction = true;
+		sound->cone_angle = 90.0f;
+		sound->volume_type = zenkit::SoundTriggerVolumeType::ELLIPSOIDAL;
+		sound->radius = 1200.0f;
+		sound->sound_name = "OW_RIVER";
+		light->children.push_back(sound);
+
+		for (auto fmt : {zenkit::ArchiveFormat::BINARY, zenkit::ArchiveFormat::BINSAFE}) {
+			std::vector<std::byte> data {};
+			auto out = zenkit::Write::to(&data);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), fmt);
+			zenkit::save_vob_tree(*out_ar, zenkit::GameVersion::GOTHIC_2, light);
+			out_ar->write_header();
+
+			auto r = zenkit::Read::from(&data);
+			auto ar = zenkit::ReadArchive::from(r.get());
+
+			std::byte buf[4];
+			CHECK_EQ(ar->read_packed(buf, 0), fmt == zenkit::ArchiveFormat::BINARY);
+
+			auto vob = zenkit::parse_vob_tree(*ar, zenkit::GameVersion::GOTHIC_2);
+			auto l = std::dynamic_pointer_cast<zenkit::VLight>(vob);
+			REQUIRE(l != nullptr);
+			CHECK_EQ(l->light_type, zenkit::LightType::POINT);
+			CHECK_EQ(l->range, 2500.5f);
+			CHECK_EQ(l->color, zenkit::Color {10, 20, 30, 255});
+			CHECK_EQ(l->cone_angle, 45.0f);
+			CHECK(l->is_static);
+			CHECK_EQ(l->quality, zenkit::LightQuality::LOW);
+			CHECK_EQ(l->lensflare_fx, "FLARE");
+
+			REQUIRE_EQ(l->children.size(), 1);
+			auto s = std::dynamic_pointer_cast<zenkit::VSound>(l->children[0]);
+			REQUIRE(s != nullptr);
+			CHECK_EQ(s->volume, 80.0f);
+			CHECK_EQ(s->mode, zenkit::SoundMode::RANDOM);
+			CHECK_EQ(s->random_delay, 5.0f);
+			CHECK_EQ(s->random_delay_var, 2.0f);
+			CHECK(s->initially_playing);
+			CHECK_FALSE(s->ambient3d);
+			CHECK(s->obstruction);
+			CHECK_EQ(s->cone_angle, 90.0f);
+			CHECK_EQ(s->volume_type, zenkit::SoundTriggerVolumeType::ELLIPSOIDAL);
+			CHECK_EQ(s->radius, 1200.0f);
+			CHECK_EQ(s->sound_name, "OW_RIVER");
+
+			// Runs which reach past the end of a binary archive are rejected.
+			if (fmt == zenkit::ArchiveFormat::BINARY) {
+				r->seek(-2, zenkit::Whence::END);
+				CHECK_THROWS_AS((void) ar->read_packed(buf, sizeof buf), zenkit::ParserError);
+			}
+		}
+	}
+
+	TEST_CASE("ReadArchive.transcode") {
+		auto in = zenkit::Read::from("./samples/G1/VOb/oCMobContainer.zen");
+		auto original =
+		    zenkit::ReadArchive::from(in.get())->read_object<zenkit::VContainer>(zenkit::GameVersion::GOTHIC_1);
+		REQUIRE(original != nullptr);
+
+		std::vector<std::byte> ascii {};
+		using zenkit::ArchiveFormat;
+		for (auto format : {ArchiveFormat::ASCII, ArchiveFormat::BINARY, ArchiveFormat::BINSAFE}) {
+			std::vector<std::byte> data {};
+			{
+				in = zenkit::Read::from("./samples/G1/VOb/oCMobContainer.zen");
+				auto src = zenkit::ReadArchive::from(in.get());
+
+				auto out = zenkit::Write::to(&data);
+				auto out_ar = zenkit::WriteArchive::to(out.get(), format);
+				src->transcode(*out_ar);
+			}
+
+			auto r = zenkit::Read::from(&data);
+			auto ar = zenkit::ReadArchive::from(r.get());
+			CHECK_EQ(ar->get_header().format, format);
+
+			auto obj = ar->read_object<zenkit::VContainer>(zenkit::GameVersion::GOTHIC_1);
+			REQUIRE(obj != nullptr);
+			CHECK_EQ(obj->vob_name, original->vob_name);
+			CHECK_EQ(obj->contents, original->contents);
+			CHECK_EQ(obj->locked, original->locked);
+
+			// The ASCII writer only stores six decimal places of floats.
+			if (format == zenkit::ArchiveFormat::ASCII) {
+				ascii = std::move(data);
+			} else {
+				CHECK_EQ(obj->position, original->position);
+				CHECK_EQ(obj->bbox.max, original->bbox.max);
+			}
+		}
+
+		// Binary archives do not store the types of their entries.
+		std::vector<std::byte> binary {};
+		{
+			auto r = zenkit::Read::from(&ascii);
+			auto out = zenkit::Write::to(&binary);
+			auto out_ar = zenkit::WriteArchive::to(out.get(), ArchiveFormat::BINARY);
+			zenkit::ReadArchive::from(r.get())->transcode(*out_ar);
+		}
+
+		std::vector<std::byte> data {};
+		auto r = zenkit::Read::from(&binary);
+		auto out = zenkit::Write::to(&data);
+		auto out_ar = zenkit::WriteArchive::to(out.get(), zenkit::ArchiveFormat::ASCII);
+		CHECK_THROWS_AS(zenkit::ReadArchive::from(r.get())->transcode(*out_ar), zenkit::ParserError);
+	}
+
 	TEST_CASE("ReadArchive.open(BIN_SAFE)" * doctest::skip()) {
 		// FIXME: Stub
 	}
@@ -0,0 +1,77 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <doctest/doctest.h>
+#include <zenkit/AssetCache.hh>
+#include <zenkit/ModelHierarchy.hh>
+#include <zenkit/MultiResolutionMesh.hh>
+#include <zenkit/Vfs.hh>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static std::vector<std::byte> read_file(char const* path) {
+	std::ifstream in {path, std::ios::binary};
+	std::vector<char> data {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+
+	std::vector<std::byte> bytes(data.size());
+	std::memcpy(bytes.data(), data.data(), data.size());
+	return bytes;
+}
+
+TEST_SUITE("AssetCache") {
+	TEST_CASE("AssetCache.load") {
+		auto mesh = read_file("./samples/mesh0.mrm");
+		auto hierarchy = read_file("./samples/hierarchy0.mdh");
+
+		zenkit::Vfs vfs {};
+		auto& dir = vfs.mkdir("MESHES");
+		dir.create(zenkit::VfsNode::file("A.MRM", zenkit::VfsFileDescriptor {mesh.data(), mesh.size(), false}));
+		dir.create(zenkit::VfsNode::file("B.MRM", zenkit::VfsFileDescriptor {mesh.data(), mesh.size(), false}));
+		dir.create(
+		    zenkit::VfsNode::file("C.MDH", zenkit::VfsFileDescriptor {hierarchy.data(), hierarchy.size(), false}));
+
+		zenkit::AssetCache cache {};
+
+		// Files with the same contents share one instance, regardless of their name.
+		auto a = cache.load_multi_resolution_mesh(*vfs.find("A.MRM"));
+		auto b = cache.load_multi_resolution_mesh(*vfs.find("B.MRM"));
+		CHECK_EQ(a, b);
+		CHECK_EQ(a->positions.size(), 8);
+		CHECK_EQ(cache.size(), 1);
+
+		auto h = cache.load_model_hierarchy(*vfs.find("C.MDH"));
+		CHECK_EQ(cache.find_model_hierarchy(h->checksum), h);
+		CHECK_EQ(cache.find_model_hierarchy(h->checksum + 1), nullptr);
+		CHECK_EQ(cache.size(), 2);
+
+		// With weak ownership, assets are released once they are no longer used.
+		a.reset();
+		b.reset();
+		CHECK_EQ(cache.size(), 1);
+
+		auto reloaded = cache.load_multi_resolution_mesh(*vfs.find("B.MRM"));
+		CHECK_EQ(reloaded->positions.size(), 8);
+
+		cache.clear();
+		CHECK_EQ(cache.size(), 0);
+		CHECK_EQ(cache.find_model_hierarchy(h->checksum), nullptr);
+	}
+
+	TEST_CASE("AssetCache.load(shared)") {
+		auto mesh = read_file("./samples/mesh0.mrm");
+
+		zenkit::Vfs vfs {};
+		vfs.mkdir("MESHES").create(
+		    zenkit::VfsNode::file("A.MRM", zenkit::VfsFileDescriptor {mesh.data(), mesh.size(), false}));
+
+		// With shared ownership, assets stay alive until the cache is cleared.
+		zenkit::AssetCache cache {zenkit::AssetCacheOwnership::SHARED};
+		auto const* first = cache.load_multi_resolution_mesh(*vfs.find("A.MRM")).get();
+		CHECK_EQ(cache.size(), 1);
+		CHECK_EQ(cache.load_multi_resolution_mesh(*vfs.find("A.MRM")).get(), first);
+
+		cache.clear();
+		CHECK_EQ(cache.size(), 0);
+	}
+}
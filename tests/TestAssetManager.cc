@@ -0,0 +1,158 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <doctest/doctest.h>
+#include <zenkit/AssetManager.hh>
+#include <zenkit/Executor.hh>
+#include <zenkit/MultiResolutionMesh.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/Vfs.hh>
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::vector<std::byte> read_file(char const* path) {
+	std::ifstream in {path, std::ios::binary};
+	std::vector<char> data {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+
+	std::vector<std::byte> bytes(data.size());
+	std::memcpy(bytes.data(), data.data(), data.size());
+	return bytes;
+}
+
+/// \brief An executor which only runs its tasks when asked to.
+class ManualExecutor final : public zenkit::Executor {
+public:
+	[[nodiscard]] std::size_t concurrency() const noexcept override {
+		return 1;
+	}
+
+	void execute(std::function<void()> task) override {
+		tasks.push_back(std::move(task));
+	}
+
+	void run() {
+		auto pending = std::move(tasks);
+		for (auto& task : pending) {
+			task();
+		}
+	}
+
+	std::vector<std::function<void()>> tasks;
+};
+
+/// \brief An asset which consists of the first character of its file and records the order it was loaded in.
+struct Letter {
+	static inline std::string loaded;
+	char value;
+
+	void load(zenkit::Read* r) {
+		value = r->read_char();
+		loaded += value;
+	}
+};
+
+TEST_SUITE("AssetManager") {
+	TEST_CASE("AssetManager.request") {
+		auto mesh = read_file("./samples/mesh0.mrm");
+
+		zenkit::Vfs vfs {};
+		vfs.mkdir("MESHES").create(
+		    zenkit::VfsNode::file("CHESTBIG.MRM", zenkit::VfsFileDescriptor {mesh.data(), mesh.size(), false}));
+
+		zenkit::ThreadPool pool {2};
+		zenkit::AssetManager manager {vfs, zenkit::AssetManagerOptions {1024 * 1024, 0, &pool}};
+
+		// Requests for the same asset share one load, regardless of the case of the name.
+		auto a = manager.request<zenkit::MultiResolutionMesh>("chestbig.mrm", 1);
+		auto b = manager.request<zenkit::MultiResolutionMesh>("CHESTBIG.MRM");
+		CHECK(a.valid());
+		CHECK_EQ(manager.size(), 1);
+
+		auto value = a.wait();
+		REQUIRE_NE(value, nullptr);
+		CHECK_EQ(value->positions.size(), 8);
+		CHECK(b.ready());
+		CHECK_EQ(b.get(), value);
+		CHECK_EQ(manager.memory_used(), mesh.size());
+
+		auto missing = manager.request<zenkit::MultiResolutionMesh>("MISSING.MRM");
+		CHECK_EQ(missing.wait(), nullptr);
+		CHECK(missing.ready());
+		CHECK_EQ(manager.size(), 2);
+
+		// Assets which are in use are not released.
+		missing = {};
+		manager.clear();
+		CHECK_EQ(manager.size(), 1);
+		CHECK_EQ(manager.memory_used(), mesh.size());
+
+		a = {};
+		b = {};
+		value.reset();
+		manager.clear();
+		CHECK_EQ(manager.size(), 0);
+		CHECK_EQ(manager.memory_used(), 0);
+		CHECK_FALSE(zenkit::AssetHandle<zenkit::MultiResolutionMesh> {}.valid());
+	}
+
+	TEST_CASE("AssetManager.priority") {
+		std::byte const letters[] = {std::byte {'A'}, std::byte {'B'}, std::byte {'C'}, std::byte {'D'}};
+
+		zenkit::Vfs vfs {};
+		auto& dir = vfs.mkdir("LETTERS");
+		for (auto i = 0; i < 4; ++i) {
+			std::string name {static_cast<char>(letters[i])};
+			dir.create(zenkit::VfsNode::file(name, zenkit::VfsFileDescriptor {letters + i, 1, false}));
+		}
+
+		ManualExecutor executor {};
+		Letter::loaded.clear();
+
+		{
+			zenkit::AssetManager manager {vfs, zenkit::AssetManagerOptions {2, 1, &executor}};
+
+			auto a = manager.request<Letter>("A", 0);
+			auto b = manager.request<Letter>("B", 5);
+			auto c = manager.request<Letter>("C", 1);
+			auto d = manager.request<Letter>("D", 0);
+			CHECK_EQ(executor.tasks.size(), 1);
+			CHECK_FALSE(a.ready());
+			CHECK_EQ(a.get(), nullptr);
+
+			// Waiting for an asset which has not started loading yet loads it on the calling thread.
+			CHECK_EQ(d.wait()->value, 'D');
+			CHECK_EQ(Letter::loaded, "D");
+
+			// Requesting an asset again raises its priority.
+			CHECK(manager.request<Letter>("A", 10).valid());
+			executor.run();
+			CHECK_EQ(Letter::loaded, "DABC");
+			CHECK_EQ(c.get()->value, 'C');
+
+			// Once the budget is exceeded, the least recently requested assets which are not in use are released.
+			d = {};
+			b = {};
+			CHECK_EQ(manager.size(), 4);
+			CHECK_EQ(manager.memory_used(), 4);
+
+			CHECK(manager.request<Letter>("C").ready());
+			CHECK_EQ(manager.size(), 2);
+			CHECK_EQ(manager.memory_used(), 2);
+
+			// Pending requests are dropped when the manager is destroyed.
+			auto e = manager.request<Letter>("B");
+			CHECK_FALSE(e.ready());
+			c = {};
+		}
+
+		CHECK_EQ(Letter::loaded, "DABC");
+
+		// Workers which were never run don't touch the destroyed manager.
+		executor.run();
+		CHECK_EQ(Letter::loaded, "DABC");
+	}
+}
@@ -0,0 +1,300 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/Mesh.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/world/BspTree.hh>
+
+#include <doctest/doctest.h>
+
+/// \brief Builds an axis-aligned frustum containing the box from \p min to \p max.
+static zenkit::Frustum make_frustum(zenkit::Vec3 min, zenkit::Vec3 max) {
+	return zenkit::Frustum {{
+	    zenkit::Vec4 {1, 0, 0, min.x},
+	    zenkit::Vec4 {-1, 0, 0, -max.x},
+	    zenkit::Vec4 {0, 1, 0, min.y},
+	    zenkit::Vec4 {0, -1, 0, -max.y},
+	    zenkit::Vec4 {0, 0, 1, min.z},
+	    zenkit::Vec4 {0, 0, -1, -max.z},
+	}};
+}
+
+/// \brief Builds a tree split at `x = 0` with a wall at `x = 5` in front of the plane and a wall at `x = -5` behind
+///        it. The front leaf is part of the sector `ROOM`.
+static zenkit::BspTree make_tree(zenkit::Mesh& mesh) {
+	for (auto x : {5.0f, -5.0f}) {
+		auto offset = mesh.polygon_vertex_indices.size();
+
+		for (auto [y, z] : {std::pair {-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}}) {
+			mesh.polygon_vertex_indices.push_back(static_cast<std::uint32_t>(mesh.vertices.size()));
+			mesh.vertices.emplace_back(x, y, z);
+		}
+
+		auto& polygon = mesh.geometry.emplace_back();
+		polygon.index_offset = offset;
+		polygon.index_count = 4;
+	}
+
+	zenkit::BspTree tree {};
+	tree.polygon_indices = {0, 1};
+
+	auto& root = tree.nodes.emplace_back();
+	root.plane = {1, 0, 0, 0};
+	root.polygon_index = 0;
+	root.polygon_count = 2;
+	root.front_index = 1;
+	root.back_index = 2;
+	root.bbox = {{-5, -1, -1}, {5, 1, 1}};
+
+	auto& front = tree.nodes.emplace_back();
+	front.polygon_index = 0;
+	front.polygon_count = 1;
+	front.parent_index = 0;
+	front.bbox = {{0, -1, -1}, {5, 1, 1}};
+
+	auto& back = tree.nodes.emplace_back();
+	back.polygon_index = 1;
+	back.polygon_count = 1;
+	back.parent_index = 0;
+	back.bbox = {{-5, -1, -1}, {0, 1, 1}};
+
+	tree.leaf_node_indices = {1, 2};
+	tree.sectors.push_back({"ROOM", {1}, {}});
+	return tree;
+}
+
+/// \brief Builds an indoor tree with four sectors. `A`, `B` and `C` form a corridor along the x-axis with portals at
+///        `x = 10` and `x = 20` and a portal to the outside at `x = 30`. `D` is next to `A` and connected to `B`
+///        through a portal in the same plane as the one between `A` and `B`.
+static zenkit::BspTree make_sectors(zenkit::Mesh& mesh) {
+	auto add_portal = [&mesh](float x, float y0, float y1) {
+		auto offset = mesh.polygon_vertex_indices.size();
+		for (auto const& v : {zenkit::Vec3 {x, y0, 0}, zenkit::Vec3 {x, y1, 0}, zenkit::Vec3 {x, y1, 10}}) {
+			mesh.polygon_vertex_indices.push_back(static_cast<std::uint32_t>(mesh.vertices.size()));
+			mesh.vertices.push_back(v);
+		}
+
+		zenkit::Polygon polygon {};
+		polygon.flags.is_portal = 1;
+		polygon.index_count = 3;
+		polygon.index_offset = offset;
+		mesh.geometry.push_back(polygon);
+		return static_cast<std::uint32_t>(mesh.geometry.size() - 1);
+	};
+
+	auto ab = add_portal(10, 0, 10);
+	auto ba = add_portal(10, 0, 10); // Coincident with `ab` but listed by `B`.
+	auto bc = add_portal(20, 0, 10);
+	auto c_out = add_portal(30, 0, 10);
+	auto bd = add_portal(10, 10, 20);
+
+	zenkit::BspTree tree {};
+	tree.mode = zenkit::BspTreeType::INDOOR;
+	for (auto const& box : {zenkit::AxisAlignedBoundingBox {{0, 0, 0}, {10, 10, 10}},
+	                        zenkit::AxisAlignedBoundingBox {{10, 0, 0}, {20, 20, 10}},
+	                        zenkit::AxisAlignedBoundingBox {{20, 0, 0}, {30, 10, 10}},
+	                        zenkit::AxisAlignedBoundingBox {{0, 10, 0}, {10, 20, 10}}}) {
+		tree.nodes.emplace_back().bbox = box;
+	}
+
+	tree.sectors.push_back({"A", {0}, {ab}});
+	tree.sectors.push_back({"B", {1}, {ba, bc, bd}});
+	tree.sectors.push_back({"C", {2}, {bc, c_out}});
+	tree.sectors.push_back({"D", {3}, {bd}});
+	return tree;
+}
+
+TEST_SUITE("BspTree") {
+	TEST_CASE("BspTree.find_leaf") {
+		zenkit::Mesh mesh {};
+		auto tree = make_tree(mesh);
+
+		// Without a traversal, each query builds a temporary one.
+		CHECK(tree.traversal.nodes.empty());
+		CHECK_EQ(tree.find_leaf({1, 0, 0}), 1);
+
+		tree.build_traversal();
+		REQUIRE_EQ(tree.traversal.nodes.size(), 1);
+		CHECK_EQ(tree.traversal.root, 0);
+		CHECK_EQ(tree.traversal.nodes[0].front, zenkit::BspTraversal::LEAF | 0);
+		CHECK_EQ(tree.traversal.nodes[0].back, zenkit::BspTraversal::LEAF | 1);
+		REQUIRE_EQ(tree.traversal.leaves.size(), 2);
+		CHECK_EQ(tree.traversal.leaves[0], 1);
+		CHECK_EQ(tree.traversal.leaves[1], 2);
+
+		CHECK_EQ(tree.find_leaf({1, 0, 0}), 1);
+		CHECK_EQ(tree.find_leaf({-1, 0, 0}), 2);
+		CHECK_EQ(tree.find_leaf({0, 3, 0}), 1);
+		CHECK_EQ(zenkit::BspTree {}.find_leaf({0, 0, 0}), -1);
+
+		REQUIRE_NE(tree.sector_at({1, 0, 0}), nullptr);
+		CHECK_EQ(tree.sector_at({1, 0, 0})->name, "ROOM");
+		CHECK_EQ(tree.sector_at({-1, 0, 0}), nullptr);
+	}
+
+	TEST_CASE("BspTree.raycast") {
+		zenkit::Mesh mesh {};
+		auto tree = make_tree(mesh);
+		tree.build_traversal();
+
+		// The ray starts behind the plane and crosses it before hitting the wall in front of it.
+		auto hit = tree.raycast(mesh, {-1, 0, 0}, {1, 0, 0}, 100);
+		REQUIRE(hit.has_value());
+		CHECK_EQ(hit->polygon, 0);
+		CHECK_EQ(hit->node, 1);
+		CHECK_EQ(hit->distance, doctest::Approx(6));
+		CHECK_EQ(hit->point.x, doctest::Approx(5));
+
+		hit = tree.raycast(mesh, {-1, 0.5f, 0.5f}, {-2, 0, 0}, 100);
+		REQUIRE(hit.has_value());
+		CHECK_EQ(hit->polygon, 1);
+		CHECK_EQ(hit->distance, doctest::Approx(4));
+
+		CHECK_FALSE(tree.raycast(mesh, {-1, 0, 0}, {1, 0, 0}, 5).has_value());
+		CHECK_FALSE(tree.raycast(mesh, {-1, 2, 0}, {1, 0, 0}, 100).has_value());
+
+		// Portals are ignored.
+		mesh.geometry[0].flags.is_portal = 1;
+		CHECK_FALSE(tree.raycast(mesh, {-1, 0, 0}, {1, 0, 0}, 100).has_value());
+	}
+
+	TEST_CASE("BspTree.cull") {
+		zenkit::Mesh mesh {};
+		auto tree = make_tree(mesh);
+		std::vector<std::uint32_t> leaves {7};
+
+		tree.cull(make_frustum({1, -10, -10}, {10, 10, 10}), leaves);
+		REQUIRE_EQ(leaves.size(), 1);
+		CHECK_EQ(leaves[0], 1);
+
+		tree.cull(make_frustum({-10, -10, -10}, {10, 10, 10}), leaves);
+		REQUIRE_EQ(leaves.size(), 2);
+		CHECK_EQ(leaves[0], 1);
+		CHECK_EQ(leaves[1], 2);
+
+		tree.cull(make_frustum({-10, 2, -10}, {10, 10, 10}), leaves);
+		CHECK(leaves.empty());
+	}
+
+	TEST_CASE("Frustum") {
+		auto frustum = make_frustum({-1, -1, -1}, {1, 1, 1});
+		CHECK_EQ(frustum.test({{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}}), zenkit::FrustumTest::INSIDE);
+		CHECK_EQ(frustum.test({{0.5f, 0.5f, 0.5f}, {2, 2, 2}}), zenkit::FrustumTest::INTERSECTS);
+		CHECK_EQ(frustum.test({{1.5f, 0, 0}, {2, 2, 2}}), zenkit::FrustumTest::OUTSIDE);
+
+		// The identity matrix maps the cube from -1 to 1 onto itself.
+		auto planes = zenkit::Frustum::from_matrix(zenkit::Mat4::identity()).planes;
+		for (auto i = 0u; i < planes.size(); ++i) {
+			CHECK_EQ(planes[i].x, frustum.planes[i].x);
+			CHECK_EQ(planes[i].y, frustum.planes[i].y);
+			CHECK_EQ(planes[i].z, frustum.planes[i].z);
+			CHECK_EQ(planes[i].w, frustum.planes[i].w);
+		}
+
+		zenkit::BoundingBoxSet set {};
+		for (auto i = 0; i < 6; ++i) {
+			auto x = static_cast<float>(i) - 2.5f;
+			CHECK_EQ(set.add({{x, 0, 0}, {x + 1, 0.25f, 0.25f}}), i);
+		}
+
+		std::vector<std::uint32_t> visible;
+		set.cull(frustum, visible);
+		REQUIRE_EQ(set.size(), 6);
+		REQUIRE_EQ(visible.size(), 3);
+		CHECK_EQ(visible[0], 1);
+		CHECK_EQ(visible[1], 2);
+		CHECK_EQ(visible[2], 3);
+	}
+
+	TEST_CASE("AxisAlignedBoundingBox") {
+		// Irregular boxes and points, so that every lane of the batched tests is exercised.
+		std::vector<zenkit::AxisAlignedBoundingBox> boxes;
+		std::vector<zenkit::Vec3> points;
+		for (auto i = 0; i < 37; ++i) {
+			auto x = static_cast<float>((i * 7) % 11) - 5;
+			auto y = static_cast<float>((i * 5) % 13) - 6;
+			auto z = static_cast<float>((i * 3) % 7) - 3;
+			boxes.push_back({{x, y, z}, {x + static_cast<float>(i % 3), y + 2, z + static_cast<float>(i % 4)}});
+			points.emplace_back(x, z, y);
+		}
+
+		auto merged = zenkit::merge_bounding_boxes(boxes.data(), boxes.size());
+		CHECK_EQ(merged.min, zenkit::Vec3 {-5, -6, -3});
+		CHECK_EQ(merged.max, zenkit::Vec3 {7, 8, 6});
+		CHECK_EQ(zenkit::merge_bounding_boxes(boxes.data(), 0).max, zenkit::Vec3 {0});
+
+		zenkit::AxisAlignedBoundingBox query {{-2, -1, -1}, {1, 2, 0}};
+		std::vector<std::uint32_t> hits, expected;
+
+		zenkit::find_intersecting_boxes(query, boxes.data(), boxes.size(), hits);
+		for (auto i = 0u; i < boxes.size(); ++i) {
+			if (boxes[i].intersects(query)) expected.push_back(i);
+		}
+		CHECK_FALSE(expected.empty());
+		CHECK_EQ(hits, expected);
+
+		expected.clear();
+		zenkit::find_boxes_containing({0, 0, 0}, boxes.data(), boxes.size(), hits);
+		for (auto i = 0u; i < boxes.size(); ++i) {
+			if (boxes[i].contains({0, 0, 0})) expected.push_back(i);
+		}
+		CHECK_FALSE(expected.empty());
+		CHECK_EQ(hits, expected);
+
+		expected.clear();
+		query = {{-2, -2, -3}, {3, 3, 3}};
+		zenkit::find_points_inside(query, points.data(), points.size(), hits);
+		for (auto i = 0u; i < points.size(); ++i) {
+			if (query.contains(points[i])) expected.push_back(i);
+		}
+		CHECK_LT(expected.size(), points.size());
+		CHECK_FALSE(expected.empty());
+		CHECK_EQ(hits, expected);
+
+		// A rotation by 90° around the z-axis followed by a translation along the x-axis.
+		zenkit::Mat4 transform {zenkit::Vec4 {0, 1, 0, 0},
+		                        zenkit::Vec4 {-1, 0, 0, 0},
+		                        zenkit::Vec4 {0, 0, 1, 0},
+		                        zenkit::Vec4 {10, 0, 0, 1}};
+		zenkit::AxisAlignedBoundingBox box {{0, 0, 0}, {1, 2, 3}};
+		zenkit::transform_bounding_boxes(transform, &box, &box, 1);
+		CHECK_EQ(box.min, zenkit::Vec3 {8, 0, 0});
+		CHECK_EQ(box.max, zenkit::Vec3 {10, 1, 3});
+	}
+
+	TEST_CASE("BspTree.build_visibility") {
+		zenkit::Mesh mesh {};
+		auto tree = make_sectors(mesh);
+		auto vis = tree.build_visibility(mesh);
+		REQUIRE_EQ(vis.outside, 4);
+
+		auto A = 0u, B = 1u, C = 2u, D = 3u, OUT = vis.outside;
+		for (auto i = 0u; i <= OUT; ++i) {
+			CHECK(vis.is_visible(i, i));
+			CHECK(vis.is_visible(i, B));
+			CHECK(vis.is_visible(B, i));
+		}
+
+		CHECK(vis.is_visible(A, C));
+		CHECK(vis.is_visible(A, OUT));
+		CHECK(vis.is_visible(OUT, A));
+		CHECK(vis.is_visible(D, OUT));
+
+		// The portals between `A` and `B` and between `B` and `D` lie in the same plane.
+		CHECK_FALSE(vis.is_visible(A, D));
+		CHECK_FALSE(vis.is_visible(D, A));
+		CHECK_FALSE(vis.is_visible(A, 7));
+
+		std::vector<std::byte> data;
+		vis.save(zenkit::Write::to(&data).get());
+
+		zenkit::BspVisibility loaded {};
+		REQUIRE(loaded.load(zenkit::Read::from(&data).get(), tree));
+		CHECK_EQ(loaded.outside, vis.outside);
+		CHECK_EQ(loaded.bits, vis.bits);
+
+		// Visibility built for different sectors is rejected.
+		tree.sectors.pop_back();
+		CHECK_FALSE(loaded.load(zenkit::Read::from(&data).get(), tree));
+		CHECK_EQ(loaded.outside, vis.outside);
+	}
+}
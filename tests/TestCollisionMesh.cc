@@ -0,0 +1,113 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/CollisionMesh.hh>
+#include <zenkit/Mesh.hh>
+#include <zenkit/Stream.hh>
+
+#include <doctest/doctest.h>
+
+#include <cmath>
+
+/// \brief Builds a mesh with a 20x20 floor quad at `y = 0` centered on the origin, a portal at `x = 5` and a wall
+///        at `x = -5` using a material without collision.
+static zenkit::Mesh make_mesh() {
+	zenkit::Mesh mesh {};
+	mesh.materials.resize(2);
+	mesh.materials[1].disable_collision = true;
+
+	auto add_polygon = [&mesh](std::initializer_list<zenkit::Vec3> points, std::uint32_t material, bool portal) {
+		zenkit::Polygon polygon {};
+		polygon.material = material;
+		polygon.flags.is_portal = portal ? 1 : 0;
+		polygon.index_offset = mesh.polygon_vertex_indices.size();
+		polygon.index_count = points.size();
+
+		for (auto const& point : points) {
+			mesh.polygon_vertex_indices.push_back(static_cast<std::uint32_t>(mesh.vertices.size()));
+			mesh.vertices.push_back(point);
+		}
+
+		mesh.geometry.push_back(polygon);
+	};
+
+	add_polygon({{-10, 0, -10}, {10, 0, -10}, {10, 0, 10}, {-10, 0, 10}}, 0, false);
+	add_polygon({{5, 0, -10}, {5, 10, -10}, {5, 10, 10}}, 0, true);
+	add_polygon({{-5, 0, -10}, {-5, 10, -10}, {-5, 10, 10}}, 1, false);
+	return mesh;
+}
+
+TEST_SUITE("CollisionMesh") {
+	TEST_CASE("CollisionMesh.build") {
+		auto mesh = make_mesh();
+		zenkit::CollisionMesh collision {};
+		collision.build(mesh);
+
+		// Only the floor collides.
+		REQUIRE_EQ(collision.triangles.size(), 2);
+		CHECK_EQ(collision.triangles[0].polygon, 0);
+		CHECK_EQ(collision.triangles[1].polygon, 0);
+		REQUIRE_EQ(collision.nodes.size(), 1);
+		CHECK_EQ(collision.nodes[0].count, 2);
+
+		collision.build(mesh, {1, 2});
+		CHECK(collision.triangles.empty());
+		CHECK(collision.nodes.empty());
+		CHECK_FALSE(collision.raycast({0, 5, 0}, {0, -10, 0}).has_value());
+	}
+
+	TEST_CASE("CollisionMesh.queries") {
+		auto mesh = make_mesh();
+		zenkit::CollisionMesh collision {};
+		collision.build(mesh);
+
+		auto ray = collision.raycast({1, 5, 1}, {0, -10, 0});
+		REQUIRE(ray.has_value());
+		CHECK_EQ(ray->fraction, doctest::Approx(0.5));
+		CHECK_EQ(ray->normal.y, doctest::Approx(1));
+		CHECK_FALSE(collision.raycast({1, 5, 1}, {0, 10, 0}).has_value());
+
+		// Snap a sphere with a radius of 1 onto the floor.
+		auto sweep = collision.sweep_sphere({1, 5, 1}, {1, -5, 1}, 1);
+		REQUIRE(sweep.has_value());
+		CHECK_EQ(sweep->fraction, doctest::Approx(0.4));
+		CHECK_EQ(sweep->point.y, doctest::Approx(0));
+		CHECK_EQ(sweep->normal.y, doctest::Approx(1));
+
+		// The sphere hits the edge of the floor from the side.
+		sweep = collision.sweep_sphere({15, 0.5f, 0}, {5, 0.5f, 0}, 1);
+		REQUIRE(sweep.has_value());
+		CHECK_EQ(sweep->point.x, doctest::Approx(10));
+		CHECK_EQ(sweep->fraction, doctest::Approx((5 - std::sqrt(0.75f)) / 10));
+
+		sweep = collision.sweep_sphere({0, 0.5f, 0}, {0, 5, 0}, 1);
+		REQUIRE(sweep.has_value());
+		CHECK_EQ(sweep->fraction, 0);
+		CHECK_FALSE(collision.sweep_sphere({0, 2, 0}, {0, 5, 0}, 1).has_value());
+
+		std::vector<std::uint32_t> triangles;
+		collision.overlap_capsule({0, 0.5f, 0}, {0, 2, 0}, 1, triangles);
+		CHECK_EQ(triangles.size(), 2);
+		collision.overlap_capsule({0, 1.5f, 0}, {0, 2, 0}, 1, triangles);
+		CHECK(triangles.empty());
+		collision.overlap_capsule({8, 0.05f, -9}, {20, 0.05f, -9}, 0.1f, triangles);
+		CHECK_EQ(triangles.size(), 1);
+	}
+
+	TEST_CASE("CollisionMesh.save") {
+		auto mesh = make_mesh();
+		zenkit::CollisionMesh collision {};
+		collision.build(mesh);
+
+		std::vector<std::byte> data;
+		collision.save(zenkit::Write::to(&data).get());
+
+		zenkit::CollisionMesh loaded {};
+		REQUIRE(loaded.load(zenkit::Read::from(&data).get()));
+		CHECK_EQ(loaded.nodes.size(), collision.nodes.size());
+		REQUIRE_EQ(loaded.triangles.size(), collision.triangles.size());
+		CHECK_EQ(loaded.triangles[1].c, collision.triangles[1].c);
+
+		data.resize(data.size() - 1);
+		CHECK_FALSE(zenkit::CollisionMesh {}.load(zenkit::Read::from(&data).get()));
+	}
+}
@@ -4,7 +4,10 @@
 #include <zenkit/CutsceneLibrary.hh>
 #include <zenkit/Stream.hh>
 
+#include <atomic>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 static void verify_g1(zenkit::CutsceneLibrary const& msgs) {
 	CHECK_EQ(msgs.blocks.size(), 7360);
@@ -60,6 +63,108 @@ TEST_SUITE("CutsceneLibrary") {
 		verify_g1(*msgs);
 	}
 
+	TEST_CASE("CutsceneLibrary.load(lazy)") {
+		zenkit::CutsceneLibrary lib;
+		for (auto name : {"DIA_B", "DIA_A", "DIA_C"}) {
+			auto block = std::make_shared<zenkit::CutsceneBlock>();
+			block->name = name;
+			block->get_message()->text = std::string {"Text of "} + name;
+			block->get_message()->name = std::string {name} + ".WAV";
+			lib.blocks.push_back(block);
+		}
+
+		for (auto format : {zenkit::ArchiveFormat::BINARY, zenkit::ArchiveFormat::ASCII}) {
+			std::vector<std::byte> data;
+			auto w = zenkit::Write::to(&data);
+			auto aw = zenkit::WriteArchive::to(w.get(), format);
+			aw->write_object("%", &lib, zenkit::GameVersion::GOTHIC_1);
+			aw->write_header();
+
+			auto r = zenkit::Read::from(&data);
+			zenkit::CutsceneLibrary msgs;
+			msgs.load(r.get(), zenkit::GameVersion::GOTHIC_1, {true});
+
+			REQUIRE_EQ(msgs.blocks.size(), 3);
+			CHECK_EQ(msgs.blocks[0]->name, "DIA_A");
+			CHECK_EQ(msgs.blocks[0]->get_message()->text, "");
+
+			auto block = msgs.block_by_name("dia_c");
+			REQUIRE_NE(block, nullptr);
+			CHECK_EQ(block->name, "DIA_C");
+			CHECK_EQ(block->get_message()->text, "Text of DIA_C");
+			CHECK_EQ(block->get_message()->name, "DIA_C.WAV");
+
+			CHECK_EQ(msgs.block_by_name("DIA_A")->get_message()->text, "Text of DIA_A");
+			CHECK_EQ(msgs.block_by_name("DIA_D"), nullptr);
+
+			// The index is rebuilt by the next lookups, even if they happen on multiple threads at once.
+			msgs.invalidate_block_index();
+
+			std::atomic_int found {0};
+			std::vector<std::thread> threads;
+			for (auto i = 0; i < 4; ++i) {
+				threads.emplace_back([&msgs, &found] { found += msgs.block_by_name("dia_b") != nullptr; });
+			}
+
+			for (auto& thread : threads) {
+				thread.join();
+			}
+
+			CHECK_EQ(found, 4);
+			CHECK_EQ(msgs.block_by_name("DIA_B")->get_message()->text, "Text of DIA_B");
+		}
+	}
+
+	TEST_CASE("CutsceneLibrary.load(compact)") {
+		zenkit::CutsceneLibrary lib;
+		for (auto name : {"DIA_B", "DIA_A", "DIA_C"}) {
+			auto block = std::make_shared<zenkit::CutsceneBlock>();
+			block->name = name;
+			block->get_message()->text = std::string {"Text of "} + name;
+			block->get_message()->name = std::string {name} + ".WAV";
+			lib.blocks.push_back(block);
+		}
+
+		for (auto format : {zenkit::ArchiveFormat::BINARY, zenkit::ArchiveFormat::ASCII}) {
+			std::vector<std::byte> data;
+			auto w = zenkit::Write::to(&data);
+			auto aw = zenkit::WriteArchive::to(w.get(), format);
+			aw->write_object("%", &lib, zenkit::GameVersion::GOTHIC_1);
+			aw->write_header();
+
+			auto r = zenkit::Read::from(&data);
+			zenkit::CutsceneLibrary msgs;
+			msgs.load(r.get(), zenkit::GameVersion::GOTHIC_1, {false, true});
+
+			CHECK(msgs.blocks.empty());
+			REQUIRE_EQ(msgs.message_count(), 3);
+			CHECK_EQ(msgs.message(0).block, "DIA_A");
+			CHECK_EQ(msgs.message(2).text, "Text of DIA_C");
+			CHECK_EQ(msgs.block_by_name("DIA_A"), nullptr);
+
+			auto msg = msgs.message_by_name("dia_b");
+			REQUIRE(msg.has_value());
+			CHECK_EQ(msg->block, "DIA_B");
+			CHECK_EQ(msg->text, "Text of DIA_B");
+			CHECK_EQ(msg->name, "DIA_B.WAV");
+			CHECK_FALSE(msgs.message_by_name("DIA_D").has_value());
+
+			// Compact libraries are stored like regular ones.
+			data.clear();
+			w = zenkit::Write::to(&data);
+			aw = zenkit::WriteArchive::to(w.get(), zenkit::ArchiveFormat::BINARY);
+			aw->write_object("%", &msgs, zenkit::GameVersion::GOTHIC_1);
+			aw->write_header();
+
+			r = zenkit::Read::from(&data);
+			zenkit::CutsceneLibrary again;
+			again.load(r.get(), zenkit::GameVersion::GOTHIC_1);
+			REQUIRE_EQ(again.blocks.size(), 3);
+			CHECK_EQ(again.block_by_name("DIA_C")->get_message()->text, "Text of DIA_C");
+			CHECK_EQ(again.message_by_name("DIA_C")->name, "DIA_C.WAV");
+		}
+	}
+
 	TEST_CASE("CutsceneLibrary.load(GOTHIC2)" * doctest::skip()) {
 		// TODO: Stub
 	}
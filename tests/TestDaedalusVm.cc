@@ -0,0 +1,1000 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/DaedalusVm.hh>
+#include <zenkit/Logger.hh>
+#include <zenkit/Stream.hh>
+
+#include <cstring>
+
+#include <doctest/doctest.h>
+
+using Op = zenkit::DaedalusOpcode;
+using Type = zenkit::DaedalusDataType;
+
+/// \brief Assembles a minimal compiled Daedalus script in memory.
+class ScriptBuilder {
+public:
+	std::uint32_t variable(std::string const& name, Type type, std::uint32_t count = 1) {
+		return this->add(name, type, 0, count, 0, 0);
+	}
+
+	/// \brief Declares a function starting at the current end of the code, followed by its parameters.
+	std::uint32_t function(std::string const& name,
+	                       std::vector<Type> const& params,
+	                       Type rtype = Type::VOID,
+	                       bool external = false) {
+		auto flags = zenkit::DaedalusSymbolFlag::CONST;
+		if (rtype != Type::VOID) flags |= zenkit::DaedalusSymbolFlag::RETURN;
+		if (external) flags |= zenkit::DaedalusSymbolFlag::EXTERNAL;
+
+		auto index = this->add(name,
+		                       Type::FUNCTION,
+		                       flags,
+		                       static_cast<std::uint32_t>(params.size()),
+		                       static_cast<std::uint32_t>(rtype),
+		                       external ? 0 : here());
+
+		for (auto i = 0u; i < params.size(); ++i) {
+			this->variable(name + ".P" + std::to_string(i), params[i]);
+		}
+
+		return index;
+	}
+
+	/// \brief Declares a class followed by its members, which are integers unless their types are given.
+	std::uint32_t
+	klass(std::string const& name, std::vector<std::string> const& members, std::vector<Type> const& types = {}) {
+		auto index = this->add(name, Type::CLASS, 0, static_cast<std::uint32_t>(members.size()), 0, 0);
+
+		for (auto i = 0u; i < members.size(); ++i) {
+			auto flags = zenkit::DaedalusSymbolFlag::MEMBER;
+			auto type = i < types.size() ? types[i] : Type::INT;
+			auto member = this->add(name + "." + members[i], type, flags, 1, 4 * i, 0);
+			_m_symbols[member].parent = static_cast<std::int32_t>(index);
+		}
+
+		return index;
+	}
+
+	/// \brief Declares an instance or prototype with the given parent. Its code is empty.
+	std::uint32_t instance(std::string const& name, std::uint32_t parent, Type type = Type::INSTANCE) {
+		auto index = this->add(name, type, zenkit::DaedalusSymbolFlag::CONST, 0, 0, here());
+		_m_symbols[index].parent = static_cast<std::int32_t>(parent);
+		return index;
+	}
+
+	[[nodiscard]] std::uint32_t here() const {
+		return static_cast<std::uint32_t>(_m_code.size());
+	}
+
+	ScriptBuilder& op(Op o) {
+		_m_code.push_back(static_cast<std::uint8_t>(o));
+		return *this;
+	}
+
+	/// \brief Emits an instruction with a 32-bit operand and returns the offset of the operand.
+	std::size_t op(Op o, std::uint32_t operand) {
+		this->op(o);
+		auto at = _m_code.size();
+		for (auto i = 0; i < 4; ++i) {
+			_m_code.push_back(static_cast<std::uint8_t>(operand >> (8 * i)));
+		}
+		return at;
+	}
+
+	void patch(std::size_t at, std::uint32_t operand) {
+		for (auto i = 0; i < 4; ++i) {
+			_m_code[at + i] = static_cast<std::uint8_t>(operand >> (8 * i));
+		}
+	}
+
+	[[nodiscard]] zenkit::DaedalusScript build() const {
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		w->write_ubyte(50);
+		w->write_uint(static_cast<std::uint32_t>(_m_symbols.size()));
+
+		for (auto i = 0u; i < _m_symbols.size(); ++i) {
+			w->write_uint(i); // Sort table
+		}
+
+		for (auto const& sym : _m_symbols) {
+			w->write_uint(1);
+			w->write_line(sym.name);
+			w->write_uint(sym.vary);
+			w->write_uint(sym.count | static_cast<std::uint32_t>(sym.type) << 12 | sym.flags << 16);
+
+			for (auto i = 0; i < 5; ++i) {
+				w->write_uint(0); // File, line and character info
+			}
+
+			auto values = (sym.flags & zenkit::DaedalusSymbolFlag::MEMBER) == 0;
+			for (auto i = 0u; values && i < sym.count && (sym.type == Type::INT || sym.type == Type::FLOAT); ++i) {
+				w->write_uint(0);
+			}
+
+			for (auto i = 0u; values && i < sym.count && sym.type == Type::STRING; ++i) {
+				w->write_line("");
+			}
+
+			if (values && sym.type == Type::CLASS) w->write_int(0); // Class offset
+			if (values && (sym.type == Type::FUNCTION || sym.type == Type::INSTANCE || sym.type == Type::PROTOTYPE))
+				w->write_uint(sym.address);
+			w->write_int(sym.parent);
+		}
+
+		w->write_uint(static_cast<std::uint32_t>(_m_code.size()));
+		w->write(_m_code.data(), _m_code.size());
+
+		auto r = zenkit::Read::from(&data);
+		zenkit::DaedalusScript script;
+		script.load(r.get());
+		return script;
+	}
+
+private:
+	struct Symbol {
+		std::string name;
+		Type type;
+		std::uint32_t flags, count, vary, address;
+		std::int32_t parent {-1};
+	};
+
+	std::uint32_t add(std::string const& name,
+	                  Type type,
+	                  std::uint32_t flags,
+	                  std::uint32_t count,
+	                  std::uint32_t vary,
+	                  std::uint32_t address) {
+		_m_symbols.push_back({name, type, flags, count, vary, address});
+		return static_cast<std::uint32_t>(_m_symbols.size() - 1);
+	}
+
+	std::vector<Symbol> _m_symbols;
+	std::vector<std::uint8_t> _m_code;
+};
+
+/// \brief Builds `func int SUM(var int n)`, which adds up `TWICE(i)` for all `i` in `[0, n)` using the globals
+///        `I` and `S`. `TWICE` is an external.
+static ScriptBuilder make_sum_script() {
+	ScriptBuilder b;
+	auto i = b.variable("I", Type::INT);
+	auto s = b.variable("S", Type::INT);
+	b.op(Op::RSR);
+
+	auto twice = b.function("TWICE", {Type::INT}, Type::INT, true);
+	auto sum = b.function("SUM", {Type::INT}, Type::INT);
+	b.op(Op::PUSHV, sum + 1);
+	b.op(Op::MOVI);
+	b.op(Op::PUSHI, 0);
+	b.op(Op::PUSHV, i);
+	b.op(Op::MOVI);
+	b.op(Op::PUSHI, 0);
+	b.op(Op::PUSHV, s);
+	b.op(Op::MOVI);
+
+	auto loop = b.here();
+	b.op(Op::PUSHV, sum + 1);
+	b.op(Op::PUSHV, i);
+	b.op(Op::LT);
+	auto end = b.op(Op::BZ, 0);
+	b.op(Op::PUSHV, i);
+	b.op(Op::BE, twice);
+	b.op(Op::PUSHV, s);
+	b.op(Op::ADDMOVI);
+	b.op(Op::PUSHI, 1);
+	b.op(Op::PUSHV, i);
+	b.op(Op::ADDMOVI);
+	b.op(Op::B, loop);
+
+	b.patch(end, b.here());
+	b.op(Op::PUSHV, s);
+	b.op(Op::RSR);
+	return b;
+}
+
+struct TestInstance : zenkit::DaedalusInstance {};
+
+struct IdInstance : zenkit::DaedalusInstance {
+	std::int32_t id;
+};
+
+struct ThingInstance : zenkit::DaedalusInstance {
+	std::int32_t id;
+	std::string name;
+	float weights[2];
+	std::int32_t extra;
+};
+
+static int32_t twice(int32_t v) {
+	return v * 2;
+}
+
+/// \brief `SUM` from #make_sum_script as translated by the `daedalus2cpp` example.
+static void compiled_sum(zenkit::DaedalusVm& vm) {
+	std::int32_t a, b;
+	vm.unsafe_exec(1);
+	vm.unsafe_exec(6);
+	vm.push_int(0);
+	vm.unsafe_exec(12);
+	vm.unsafe_exec(17);
+	vm.push_int(0);
+	vm.unsafe_exec(23);
+	vm.unsafe_exec(28);
+L29:
+	vm.unsafe_exec(29);
+	vm.unsafe_exec(34);
+	a = vm.pop_int();
+	b = vm.pop_int();
+	vm.push_int(a < b);
+	if (vm.pop_int() == 0) goto L77;
+	vm.unsafe_exec(45);
+	vm.unsafe_exec(50);
+	vm.unsafe_exec(55);
+	vm.unsafe_exec(60);
+	vm.push_int(1);
+	vm.unsafe_exec(66);
+	vm.unsafe_exec(71);
+	goto L29;
+L77:
+	vm.unsafe_exec(77);
+	return;
+}
+
+TEST_SUITE("DaedalusVm") {
+	TEST_CASE("DaedalusVm.call_function") {
+		auto script = make_sum_script().build();
+		CHECK_EQ(script.instructions().size(), 23);
+		CHECK_EQ(script.instruction_index(1), 1);
+		CHECK_EQ(script.instruction_index(2), static_cast<std::uint32_t>(-1));
+
+		zenkit::DaedalusVm vm {std::move(script)};
+		vm.register_external("TWICE", [](int32_t v) { return v * 2; });
+
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 100), 9900);
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 0), 0);
+	}
+
+	TEST_CASE("DaedalusVm.register_external(pointer)") {
+		zenkit::DaedalusVm vm {make_sum_script().build()};
+		vm.register_external<twice>("TWICE");
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 10), 90);
+
+		// Registering another callback replaces the function pointer.
+		vm.register_external("TWICE", [](int32_t v) { return v; });
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 10), 45);
+
+		CHECK_THROWS_AS(vm.register_external<twice>("SUM"), zenkit::DaedalusVmException);
+	}
+
+	TEST_CASE("DaedalusVm.register_exception_handler") {
+		auto vm = zenkit::DaedalusVm {make_sum_script().build()};
+
+		// Without an external for TWICE, each BE raises an exception.
+		int errors = 0;
+		vm.register_exception_handler([&errors](zenkit::DaedalusVm& v, auto const&, auto const& instr) {
+			CHECK_EQ(instr.op, Op::BE);
+			v.push_int(1);
+			return ++errors < 5 ? zenkit::DaedalusVmExceptionStrategy::CONTINUE
+			                    : zenkit::DaedalusVmExceptionStrategy::RETURN;
+		});
+
+		(void) vm.call_function<int32_t>("SUM", 10);
+		CHECK_EQ(errors, 5);
+		CHECK_EQ(vm.find_symbol_by_name("S")->get_int(), 4);
+	}
+
+	TEST_CASE("DaedalusVm.fused_instructions") {
+		// func int F(var int p) { x = 7; x += 3; while (p > 0) { x += p; p -= 1; } return (100 - x) * 2; }
+		// func int G() { return 5 / 0; }
+		ScriptBuilder b;
+		auto x = b.variable("X", Type::INT);
+		b.op(Op::RSR);
+
+		auto f = b.function("F", {Type::INT}, Type::INT);
+		b.op(Op::PUSHV, f + 1);
+		b.op(Op::MOVI);
+		b.op(Op::PUSHI, 7);
+		b.op(Op::PUSHV, x);
+		b.op(Op::MOVI);
+		b.op(Op::PUSHI, 3);
+		b.op(Op::PUSHV, x);
+		b.op(Op::ADDMOVI);
+
+		auto loop = b.here();
+		b.op(Op::PUSHI, 0);
+		b.op(Op::PUSHV, f + 1);
+		b.op(Op::GT);
+		auto end = b.op(Op::BZ, 0);
+		b.op(Op::PUSHV, f + 1);
+		b.op(Op::PUSHV, x);
+		b.op(Op::ADDMOVI);
+		b.op(Op::PUSHI, 1);
+		b.op(Op::PUSHV, f + 1);
+		b.op(Op::SUBMOVI);
+		b.op(Op::B, loop);
+
+		b.patch(end, b.here());
+		b.op(Op::PUSHV, x);
+		b.op(Op::PUSHI, 100);
+		b.op(Op::SUB);
+		b.op(Op::PUSHI, 2);
+		b.op(Op::MUL);
+		b.op(Op::RSR);
+
+		b.function("G", {}, Type::INT);
+		b.op(Op::PUSHI, 0);
+		b.op(Op::PUSHI, 5);
+		b.op(Op::DIV);
+		b.op(Op::RSR);
+
+		zenkit::DaedalusVm vm {b.build()};
+		CHECK_EQ(vm.call_function<int32_t>("F", 4), 160);
+		CHECK_EQ(vm.find_symbol_by_name("X")->get_int(), 20);
+
+		// The profiler runs the instructions one by one, which has to give the same result.
+		vm.set_profiling(true);
+		CHECK_EQ(vm.call_function<int32_t>("F", 4), 160);
+		vm.set_profiling(false);
+
+		// Errors are still reported at the instruction which caused them.
+		vm.register_exception_handler([](zenkit::DaedalusVm& v, auto const&, auto const& instr) {
+			CHECK_EQ(instr.op, Op::DIV);
+			v.push_int(-1);
+			return zenkit::DaedalusVmExceptionStrategy::CONTINUE;
+		});
+		CHECK_EQ(vm.call_function<int32_t>("G"), -1);
+	}
+
+	TEST_CASE("DaedalusVm.push_instance") {
+		// func int TEST() { return CHECK(MAKE()); }
+		ScriptBuilder b;
+		b.op(Op::RSR);
+		auto make = b.function("MAKE", {}, Type::INSTANCE, true);
+		auto check = b.function("CHECK", {Type::INSTANCE}, Type::INT, true);
+		b.function("TEST", {}, Type::INT);
+		b.op(Op::BE, make);
+		b.op(Op::BE, check);
+		b.op(Op::RSR);
+
+		zenkit::DaedalusVm vm {b.build()};
+
+		// The instance returned by MAKE is only owned by the VM until it is popped by CHECK.
+		std::weak_ptr<TestInstance> made;
+		vm.register_external("MAKE", [&made]() {
+			auto inst = std::make_shared<TestInstance>();
+			made = inst;
+			return std::static_pointer_cast<zenkit::DaedalusInstance>(inst);
+		});
+		vm.register_external("CHECK", [&made](std::shared_ptr<zenkit::DaedalusInstance> inst) {
+			return static_cast<int32_t>(inst != nullptr && inst == made.lock());
+		});
+
+		CHECK_EQ(vm.call_function<int32_t>("TEST"), 1);
+		CHECK(made.expired());
+	}
+
+	TEST_CASE("DaedalusVm.push_string") {
+		// func string TEST() { return CONCAT(NAME(1), NAME(2)); }
+		ScriptBuilder b;
+		b.op(Op::RSR);
+		auto name = b.function("NAME", {Type::INT}, Type::STRING, true);
+		auto concat = b.function("CONCAT", {Type::STRING, Type::STRING}, Type::STRING, true);
+		b.function("TEST", {}, Type::STRING);
+		b.op(Op::PUSHI, 1);
+		b.op(Op::BE, name);
+		b.op(Op::PUSHI, 2);
+		b.op(Op::BE, name);
+		b.op(Op::BE, concat);
+		b.op(Op::RSR);
+
+		zenkit::DaedalusVm vm {b.build()};
+		vm.register_external("NAME", [](int32_t v) { return std::string {v == 1 ? "Xardas" : "Pyrokar"}; });
+		vm.register_external("CONCAT", [](std::string_view x, std::string_view y) {
+			return std::string {x} + "," + std::string {y};
+		});
+
+		// Both results of NAME stay on the stack at the same time.
+		for (auto i = 0; i < 3000; ++i) {
+			REQUIRE_EQ(vm.call_function<std::string>("TEST"), "Xardas,Pyrokar");
+		}
+
+		vm.push_string("Lee");
+		CHECK_EQ(std::get<0>(vm.pop_reference())->get_string(), "Lee");
+	}
+
+	TEST_CASE("DaedalusVm.call_stack_overflow") {
+		// func void RECURSE() { RECURSE(); }
+		ScriptBuilder b;
+		b.op(Op::RSR);
+		auto address = b.here();
+		b.function("RECURSE", {});
+		b.op(Op::BL, address);
+		b.op(Op::RSR);
+
+		// The error is only reported once, not by every one of the nested calls.
+		std::size_t errors = 0;
+		zenkit::Logger::set(zenkit::LogLevel::ERROR, [&errors](zenkit::LogLevel, char const*, char const* message) {
+			errors += std::strstr(message, "+++ Error") != nullptr;
+		});
+
+		zenkit::DaedalusVm vm {b.build()};
+		CHECK_THROWS_AS(vm.call_function("RECURSE"), zenkit::DaedalusVmException);
+		zenkit::Logger::set(zenkit::LogLevel::INFO, {});
+		CHECK_EQ(errors, 1);
+	}
+
+	TEST_CASE("DaedalusVm.fork") {
+		auto script = make_sum_script().build();
+		script.find_symbol_by_name("S")->set_int(7);
+
+		zenkit::DaedalusVm a {script.fork()};
+		zenkit::DaedalusVm b {script.fork()};
+		a.register_external("TWICE", [](int32_t v) { return v * 2; });
+		b.register_external("TWICE", [](int32_t v) { return v; });
+
+		// The decoded code is shared, the symbol values are not.
+		CHECK_EQ(a.instructions().data(), script.instructions().data());
+		CHECK_EQ(b.instructions().data(), script.instructions().data());
+		CHECK_EQ(a.symbols().size(), script.symbols().size() + 1);
+		CHECK_EQ(a.find_symbol_by_name("S")->get_int(), 7);
+
+		CHECK_EQ(a.call_function<int32_t>("SUM", 10), 90);
+		CHECK_EQ(b.call_function<int32_t>("SUM", 4), 6);
+		CHECK_EQ(a.find_symbol_by_name("S")->get_int(), 90);
+		CHECK_EQ(b.find_symbol_by_name("S")->get_int(), 6);
+		CHECK_EQ(script.find_symbol_by_name("S")->get_int(), 7);
+
+		// Forking a VM's script does not copy the VM's internal symbols.
+		CHECK_EQ(a.fork().symbols().size(), script.symbols().size());
+	}
+
+	TEST_CASE("DaedalusVm.snapshot") {
+		auto builder = make_sum_script();
+		builder.variable("NAMES", Type::STRING, 2);
+
+		zenkit::DaedalusVm vm {builder.build()};
+		vm.register_external("TWICE", [](int32_t v) { return v * 2; });
+
+		auto* names = vm.find_symbol_by_name("NAMES");
+		names->set_string("Diego", 0);
+		names->set_string("Milten", 1);
+		vm.find_symbol_by_name("S")->set_int(3);
+
+		auto snapshot = vm.snapshot();
+
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 10), 90);
+		names->set_string("Lester", 1);
+
+		vm.restore(snapshot);
+		CHECK_EQ(vm.find_symbol_by_name("S")->get_int(), 3);
+		CHECK_EQ(vm.find_symbol_by_name("I")->get_int(), 0);
+		CHECK_EQ(vm.find_symbol_by_name("SUM.P0")->get_int(), 0);
+		CHECK_EQ(names->get_string(0), "Diego");
+		CHECK_EQ(names->get_string(1), "Milten");
+
+		zenkit::DaedalusVm other {make_sum_script().build()};
+		CHECK_THROWS_AS(other.restore(snapshot), zenkit::DaedalusVmException);
+
+		// Snapshots which don't match the symbols are rejected without changing any of them.
+		auto broken = snapshot;
+		broken.values.pop_back();
+		vm.find_symbol_by_name("S")->set_int(7);
+		CHECK_THROWS_AS(vm.restore(broken), zenkit::DaedalusVmException);
+		CHECK_EQ(vm.find_symbol_by_name("S")->get_int(), 7);
+		CHECK_EQ(names->get_string(1), "Milten");
+
+		broken = snapshot;
+		broken.values.emplace_back();
+		CHECK_THROWS_AS(vm.restore(broken), zenkit::DaedalusVmException);
+		CHECK_EQ(vm.find_symbol_by_name("S")->get_int(), 7);
+	}
+
+	TEST_CASE("DaedalusVm.register_compiled_function") {
+		auto script = make_sum_script().build();
+		auto code = script.find_function_code(*script.find_symbol_by_name("SUM"));
+		CHECK_EQ(code.size(), 22);
+		CHECK_EQ(code.front(), 1);
+		CHECK_EQ(code.back(), 82);
+		CHECK(script.find_function_code(*script.find_symbol_by_name("TWICE")).empty());
+
+		auto checksum = script.function_checksum(*script.find_symbol_by_name("SUM"));
+		zenkit::DaedalusVm vm {std::move(script)};
+		vm.register_external("TWICE", [](int32_t v) { return v * 2; });
+
+		// Code generated from a different version of the function is rejected and the interpreter is used instead.
+		CHECK_FALSE(vm.register_compiled_function("SUM", checksum + 1, compiled_sum));
+		CHECK_FALSE(vm.register_compiled_function("TWICE", checksum, compiled_sum));
+		CHECK(vm.register_compiled_function("SUM", checksum, compiled_sum));
+
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 100), 9900);
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 0), 0);
+		CHECK_EQ(vm.find_symbol_by_name("I")->get_int(), 0);
+
+		// Errors unwind the compiled function and the VM fixes up the return value.
+		vm.register_exception_handler([](zenkit::DaedalusVm&, zenkit::DaedalusScriptError const&, auto const&) {
+			return zenkit::DaedalusVmExceptionStrategy::CONTINUE;
+		});
+		vm.register_external("TWICE", [](int32_t) -> int32_t { throw zenkit::DaedalusVmException {"twice"}; });
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 10), 0);
+	}
+
+	TEST_CASE("DaedalusVm.set_profiling") {
+		auto script = make_sum_script().build();
+		auto sum = script.find_symbol_by_name("SUM")->index();
+		auto twice = script.find_symbol_by_name("TWICE")->index();
+
+		zenkit::DaedalusVm vm {std::move(script)};
+		vm.register_external("TWICE", [](int32_t v) { return v * 2; });
+
+		CHECK_EQ(vm.profile(), nullptr);
+		vm.set_profiling(true);
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 3), 6);
+
+		auto const* profile = vm.profile();
+		REQUIRE_NE(profile, nullptr);
+
+		// 8 instructions to set up, 12 for each iteration, 4 to leave the loop and 2 to return.
+		CHECK_EQ(profile->instructions, 50);
+		CHECK_EQ(profile->functions[sum].calls, 1);
+		CHECK_EQ(profile->functions[sum].inclusive_instructions, 50);
+		CHECK_EQ(profile->functions[sum].exclusive_instructions, 50);
+		CHECK_EQ(profile->functions[twice].calls, 3);
+		CHECK_EQ(profile->functions[twice].inclusive_instructions, 0);
+		CHECK_GE(profile->functions[sum].inclusive_time, profile->functions[twice].inclusive_time);
+
+		REQUIRE_EQ(profile->nodes.size(), 3);
+		CHECK_EQ(profile->nodes[2].symbol, twice);
+		CHECK_EQ(profile->nodes[2].parent, 1);
+		CHECK_EQ(profile->nodes[2].stats.calls, 3);
+
+		std::vector<std::byte> folded;
+		auto w = zenkit::Write::to(&folded);
+		profile->save_folded(w.get(), vm, zenkit::DaedalusProfileWeight::INSTRUCTIONS);
+		std::string text {reinterpret_cast<char const*>(folded.data()), folded.size()};
+		CHECK_EQ(text, "SUM 50\n");
+
+		// Enabling the profiler again starts over.
+		vm.set_profiling(true);
+		CHECK_EQ(vm.profile()->instructions, 0);
+
+		vm.set_profiling(false);
+		CHECK_EQ(vm.profile(), nullptr);
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 3), 6);
+	}
+
+	TEST_CASE("DaedalusVm.register_trace_hook") {
+		zenkit::DaedalusVm vm {make_sum_script().build()};
+		vm.register_external("TWICE", [](int32_t v) { return v * 2; });
+
+		int count = 0;
+		vm.register_trace_hook([&count](zenkit::DaedalusVm&, zenkit::DaedalusInstruction const&) { ++count; });
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 3), 6);
+		CHECK_EQ(count, 50);
+
+		// Removing the hook switches back to the uninstrumented interpreter.
+		vm.register_trace_hook({});
+		CHECK_EQ(vm.call_function<int32_t>("SUM", 3), 6);
+		CHECK_EQ(count, 50);
+	}
+
+	TEST_CASE("DaedalusVm.resolve_symbol") {
+		auto builder = make_sum_script();
+		builder.variable("Dup", Type::INT);
+		auto dup = builder.variable("DUP", Type::INT);
+
+		auto script = builder.build();
+		CHECK_EQ(script.find_symbol_by_name("sum"), script.find_symbol_by_name("SUM"));
+		CHECK_EQ(script.find_symbol_by_name("Sum.p0")->name(), "SUM.P0");
+		CHECK_EQ(script.find_symbol_by_name("SU"), nullptr);
+		CHECK_EQ(script.find_symbol_by_name(""), nullptr);
+
+		// Like before, the last symbol with any given name wins.
+		CHECK_EQ(script.find_symbol_by_name("dup")->index(), dup);
+
+		auto handle = script.resolve_symbol("sum");
+		REQUIRE(handle);
+		CHECK_EQ(script.find_symbol(handle), script.find_symbol_by_name("SUM"));
+		CHECK_FALSE(script.resolve_symbol("nope"));
+		CHECK_EQ(script.find_symbol(script.resolve_symbol("nope")), nullptr);
+
+		// Handles are shared with forks, but not with unrelated scripts.
+		zenkit::DaedalusVm vm {script.fork()};
+		vm.register_external("TWICE", [](int32_t v) { return v * 2; });
+		CHECK_EQ(vm.call_function<int32_t>(handle, 3), 6);
+
+		auto other = make_sum_script().build();
+		CHECK_EQ(other.find_symbol(handle), nullptr);
+	}
+
+	TEST_CASE("DaedalusVm.enumerate_instances_by_class_name") {
+		ScriptBuilder b;
+		auto npc = b.klass("C_NPC", {"ID", "FLAGS"});
+		auto item = b.klass("C_ITEM", {"ID"});
+		b.instance("NPC_A", npc);
+		auto proto = b.instance("NPC_DEFAULT", npc, Type::PROTOTYPE);
+		b.instance("NPC_B", proto);
+		b.instance("ITEM_A", item);
+		b.instance("NPC_C", npc);
+		b.op(Op::RSR);
+
+		auto script = b.build();
+
+		auto members = script.find_class_members(*script.find_symbol_by_name("C_NPC"));
+		REQUIRE_EQ(members.size(), 2);
+		CHECK_EQ(members[0]->name(), "C_NPC.ID");
+		CHECK_EQ(members[1]->name(), "C_NPC.FLAGS");
+		CHECK_EQ(script.find_class_members(*script.find_symbol_by_name("C_ITEM")).size(), 1);
+		CHECK(script.find_class_members(*script.find_symbol_by_name("NPC_A")).empty());
+
+		std::vector<std::string> names;
+		script.enumerate_instances_by_class_name("C_NPC", [&names](zenkit::DaedalusSymbol& sym) {
+			names.push_back(sym.name());
+		});
+		std::vector<std::string> expected {"NPC_A", "NPC_B", "NPC_C"};
+		CHECK_EQ(names, expected);
+
+		names.clear();
+		script.enumerate_instances_by_class_name("NPC_DEFAULT", [&names](zenkit::DaedalusSymbol& sym) {
+			names.push_back(sym.name());
+		});
+		CHECK_EQ(names, std::vector<std::string> {"NPC_B"});
+
+		// The index is shared with forks.
+		auto fork = script.fork();
+		names.clear();
+		fork.enumerate_instances_by_class_name("c_item", [&names](zenkit::DaedalusSymbol& sym) {
+			names.push_back(sym.name());
+		});
+		CHECK_EQ(names, std::vector<std::string> {"ITEM_A"});
+	}
+
+	TEST_CASE("DaedalusVm.init_instances") {
+		ScriptBuilder b;
+		b.variable("SELF", Type::INSTANCE);
+		auto cls = b.klass("C_ID", {"ID"});
+		b.op(Op::RSR);
+
+		// Every instance assigns 10 + its number to its ID.
+		for (auto i = 0; i < 3; ++i) {
+			b.instance("ID_" + std::to_string(i), cls);
+			b.op(Op::PUSHI, 10 + i);
+			b.op(Op::PUSHV, cls + 1);
+			b.op(Op::MOVI);
+			b.op(Op::RSR);
+		}
+
+		zenkit::DaedalusVm vm {b.build()};
+		vm.register_member("C_ID.ID", &IdInstance::id);
+
+		std::vector<zenkit::DaedalusSymbol*> symbols;
+		vm.enumerate_instances_by_class_name("C_ID", [&symbols](zenkit::DaedalusSymbol& sym) {
+			symbols.push_back(&sym);
+		});
+		REQUIRE_EQ(symbols.size(), 3);
+
+		auto self = std::make_shared<IdInstance>();
+		vm.global_self()->set_instance(self);
+
+		auto instances = vm.init_instances<IdInstance>(symbols);
+		REQUIRE_EQ(instances.size(), 3);
+		for (auto i = 0u; i < instances.size(); ++i) {
+			CHECK_EQ(instances[i]->id, 10 + static_cast<std::int32_t>(i));
+			CHECK_EQ(symbols[i]->get_instance(), instances[i]);
+			CHECK_EQ(instances[i]->symbol_index(), symbols[i]->index());
+		}
+
+		CHECK_EQ(vm.global_self()->get_instance(), self);
+		CHECK_EQ(vm.unsafe_get_gi(), nullptr);
+
+		// Instances can be created by the caller.
+		auto created = 0;
+		auto reused = vm.init_instances<IdInstance>(symbols, [&](zenkit::DaedalusSymbol& sym) {
+			++created;
+			return std::static_pointer_cast<IdInstance>(sym.get_instance());
+		});
+		CHECK_EQ(created, 3);
+		CHECK_EQ(reused, instances);
+
+		// The class registration is still checked.
+		CHECK_THROWS_AS((void) vm.init_instances<TestInstance>(symbols), zenkit::DaedalusVmException);
+		CHECK_THROWS_AS((void) vm.init_instances<IdInstance>({nullptr}), zenkit::DaedalusVmException);
+		CHECK_EQ(vm.global_self()->get_instance(), self);
+	}
+
+	TEST_CASE("DaedalusVm.init_opaque_instance") {
+		ScriptBuilder b;
+		b.variable("SELF", Type::INSTANCE);
+		auto types = std::vector<Type> {Type::INT, Type::STRING, Type::FLOAT, Type::STRING};
+		auto cls = b.klass("C_ITEM", {"ID", "NAME", "WEIGHT", "TEXT"}, types);
+		b.op(Op::RSR);
+
+		auto sym = b.instance("ITEM", cls);
+		b.op(Op::PUSHI, 7);
+		b.op(Op::PUSHV, cls + 1);
+		b.op(Op::MOVI);
+		b.op(Op::RSR);
+
+		zenkit::DaedalusVm vm {b.build()};
+		vm.register_as_opaque("C_ITEM");
+
+		// Strings come first, followed by all other members.
+		auto* cls_sym = vm.find_symbol_by_index(cls);
+		CHECK_EQ(vm.find_symbol_by_index(cls + 2)->offset_as_member(), 0);
+		CHECK_EQ(vm.find_symbol_by_index(cls + 4)->offset_as_member(), sizeof(std::string));
+		CHECK_EQ(vm.find_symbol_by_index(cls + 1)->offset_as_member(), 2 * sizeof(std::string));
+		CHECK_EQ(vm.find_symbol_by_index(cls + 3)->offset_as_member(), 2 * sizeof(std::string) + 4);
+		CHECK_EQ(cls_sym->class_size(), 2 * sizeof(std::string) + 8);
+
+		auto inst = vm.init_opaque_instance(vm.find_symbol_by_index(sym));
+		CHECK_EQ(vm.find_symbol_by_index(cls + 1)->get_int(0, inst.get()), 7);
+		CHECK_EQ(vm.find_symbol_by_index(cls + 3)->get_float(0, inst.get()), 0.f);
+		CHECK_EQ(vm.find_symbol_by_index(cls + 2)->get_string(0, inst.get()), "");
+
+		auto text = std::string(64, 'x');
+		vm.find_symbol_by_index(cls + 4)->set_string(text, 0, inst.get());
+		CHECK_EQ(vm.find_symbol_by_index(cls + 4)->get_string(0, inst.get()), text);
+		CHECK_EQ(vm.find_symbol_by_index(cls + 2)->get_string(0, inst.get()), "");
+	}
+
+	TEST_CASE("DaedalusScript.analyze_functions") {
+		ScriptBuilder b;
+		b.op(Op::RSR);
+
+		auto twice = b.function("TWICE", {Type::INT}, Type::INT, true);
+
+		auto pure_at = b.here();
+		auto pure = b.function("PURE", {Type::INT}, Type::INT);
+		b.op(Op::PUSHI, 1);
+		b.op(Op::PUSHV, pure + 1);
+		b.op(Op::ADD);
+		b.op(Op::RSR);
+
+		auto impure_at = b.here();
+		auto impure = b.function("IMPURE", {Type::INT}, Type::INT);
+		b.op(Op::PUSHV, impure + 1);
+		b.op(Op::BE, twice);
+		b.op(Op::RSR);
+
+		auto calls_pure = b.function("CALLS_PURE", {}, Type::INT);
+		b.op(Op::PUSHI, 2);
+		b.op(Op::BL, pure_at);
+		b.op(Op::RSR);
+
+		auto calls_impure = b.function("CALLS_IMPURE", {}, Type::INT);
+		b.op(Op::PUSHI, 2);
+		b.op(Op::BL, impure_at);
+		b.op(Op::RSR);
+
+		auto script = b.build();
+		auto functions = script.analyze_functions();
+		REQUIRE_EQ(functions.size(), 4);
+
+		CHECK_EQ(functions[0].symbol, pure);
+		CHECK(functions[0].callees.empty());
+		CHECK(functions[0].pure);
+
+		auto callees = std::vector<std::uint32_t> {twice};
+		CHECK_EQ(functions[1].symbol, impure);
+		CHECK_EQ(functions[1].callees, callees);
+		CHECK_FALSE(functions[1].pure);
+
+		callees = {pure};
+		CHECK_EQ(functions[2].symbol, calls_pure);
+		CHECK_EQ(functions[2].callees, callees);
+		CHECK(functions[2].pure);
+
+		callees = {impure};
+		CHECK_EQ(functions[3].symbol, calls_impure);
+		CHECK_EQ(functions[3].callees, callees);
+		CHECK_FALSE(functions[3].pure);
+	}
+
+	TEST_CASE("DaedalusVm.init_instance(constant)") {
+		ScriptBuilder b;
+		b.variable("SELF", Type::INSTANCE);
+		auto name = b.variable("NAME_SWORD", Type::STRING);
+		auto types = std::vector<Type> {Type::INT, Type::STRING, Type::FLOAT};
+		auto cls = b.klass("C_ITEM", {"ID", "NAME", "WEIGHT"}, types);
+		b.op(Op::RSR);
+
+		auto proto_at = b.here();
+		auto proto = b.instance("P_ITEM", cls, Type::PROTOTYPE);
+		b.op(Op::PUSHI, 1);
+		b.op(Op::PUSHV, cls + 1);
+		b.op(Op::MOVI);
+		b.op(Op::RSR);
+
+		auto weight = 2.5f;
+		std::uint32_t weight_bits;
+		std::memcpy(&weight_bits, &weight, sizeof weight_bits);
+
+		auto sword = b.instance("ITEM_SWORD", proto);
+		b.op(Op::BL, proto_at);
+		b.op(Op::PUSHV, name);
+		b.op(Op::PUSHV, cls + 2);
+		b.op(Op::MOVS);
+		b.op(Op::PUSHI, weight_bits);
+		b.op(Op::PUSHV, cls + 3);
+		b.op(Op::MOVF);
+		b.op(Op::RSR);
+
+		// Compound assignments are not folded.
+		auto shield = b.instance("ITEM_SHIELD", cls);
+		b.op(Op::PUSHI, 5);
+		b.op(Op::PUSHV, cls + 1);
+		b.op(Op::ADDMOVI);
+		b.op(Op::RSR);
+
+		zenkit::DaedalusVm vm {b.build()};
+		vm.register_as_opaque("C_ITEM");
+		vm.find_symbol_by_index(name)->set_string("Sword");
+
+		auto const* init = vm.find_constant_initializer(*vm.find_symbol_by_index(sword));
+		REQUIRE_NE(init, nullptr);
+		auto prototypes = std::vector<std::uint32_t> {proto};
+		CHECK_EQ(init->prototypes, prototypes);
+		REQUIRE_EQ(init->assignments.size(), 3);
+		CHECK_EQ(init->assignments[0].member, cls + 1);
+		CHECK_EQ(init->assignments[0].immediate, 1);
+		CHECK_EQ(init->assignments[1].source, name);
+		CHECK_EQ(init->assignments[2].op, Op::MOVF);
+		CHECK_EQ(vm.find_constant_initializer(*vm.find_symbol_by_index(shield)), nullptr);
+
+		auto check = [&](std::shared_ptr<zenkit::DaedalusInstance> const& inst) {
+			CHECK_EQ(vm.find_symbol_by_index(cls + 1)->get_int(0, inst.get()), 1);
+			CHECK_EQ(vm.find_symbol_by_index(cls + 2)->get_string(0, inst.get()), "Sword");
+			CHECK_EQ(vm.find_symbol_by_index(cls + 3)->get_float(0, inst.get()), weight);
+		};
+
+		check(vm.init_opaque_instance(vm.find_symbol_by_index(sword)));
+
+		auto other = vm.init_opaque_instance(vm.find_symbol_by_index(shield));
+		CHECK_EQ(vm.find_symbol_by_index(cls + 1)->get_int(0, other.get()), 5);
+
+		// Interpreting the code yields the same instance.
+		vm.set_profiling(true);
+		check(vm.init_opaque_instance(vm.find_symbol_by_index(sword)));
+		CHECK_GT(vm.profile()->instructions, 0);
+		vm.set_profiling(false);
+
+		// Trace hooks see the instructions of the initializer.
+		std::size_t traced = 0;
+		vm.register_trace_hook([&traced](zenkit::DaedalusVm&, zenkit::DaedalusInstruction const&) { ++traced; });
+		check(vm.init_opaque_instance(vm.find_symbol_by_index(sword)));
+		CHECK_GT(traced, 0);
+	}
+
+	TEST_CASE("DaedalusVm.unsafe_call_resumable") {
+		ScriptBuilder b;
+		b.op(Op::RSR);
+
+		auto wait = b.function("WAIT", {Type::INT}, Type::INT, true);
+
+		// func int G(var int x) { return WAIT(x) + 1; }
+		auto g_at = b.here();
+		auto g = b.function("G", {Type::INT}, Type::INT);
+		b.op(Op::PUSHV, g + 1);
+		b.op(Op::MOVI);
+		b.op(Op::PUSHI, 1);
+		b.op(Op::PUSHV, g + 1);
+		b.op(Op::BE, wait);
+		b.op(Op::ADD);
+		b.op(Op::RSR);
+
+		// func int F() { return G(5) + 10; }
+		auto f = b.function("F", {}, Type::INT);
+		b.op(Op::PUSHI, 10);
+		b.op(Op::PUSHI, 5);
+		b.op(Op::BL, g_at);
+		b.op(Op::ADD);
+		b.op(Op::RSR);
+
+		zenkit::DaedalusVm vm {b.build()};
+
+		auto waited = 0;
+		vm.register_external("WAIT", [&vm, &waited](std::int32_t x) {
+			waited = x;
+			vm.suspend();
+			return -1;
+		});
+
+		CHECK_THROWS_AS(vm.suspend(), zenkit::DaedalusVmException);
+		CHECK_THROWS_AS((void) vm.resume(), zenkit::DaedalusVmException);
+
+		CHECK_FALSE(vm.unsafe_call_resumable(vm.find_symbol_by_index(f)));
+		CHECK(vm.suspended());
+		CHECK_EQ(waited, 5);
+		CHECK_THROWS_AS((void) vm.unsafe_call_resumable(vm.find_symbol_by_index(f)), zenkit::DaedalusVmException);
+
+		vm.push_int(7);
+		CHECK(vm.resume());
+		CHECK_FALSE(vm.suspended());
+		CHECK_EQ(vm.pop_int(), 18);
+
+		// The VM can be used as usual afterwards.
+		vm.register_external("WAIT", [](std::int32_t x) { return x * 2; });
+		CHECK_EQ(vm.call_function<int>("G", 3), 7);
+	}
+
+	TEST_CASE("DaedalusScript.save_compiled") {
+		auto b = make_sum_script();
+		b.variable("NAME", Type::STRING);
+		auto original = b.build();
+		original.find_symbol_by_name("NAME")->set_string("Line\nbreak");
+
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		original.save_compiled(w.get());
+
+		zenkit::DaedalusScript script;
+		auto r = zenkit::Read::from(&data);
+		script.load_compiled(r.get());
+
+		REQUIRE_EQ(script.symbols().size(), original.symbols().size());
+		CHECK_EQ(script.instructions().size(), original.instructions().size());
+		CHECK_EQ(script.size(), original.size());
+		CHECK_EQ(script.find_symbol_by_name("name")->get_string(), "Line\nbreak");
+		CHECK_EQ(script.find_symbol_by_address(1), script.find_symbol_by_name("SUM"));
+
+		auto const* sum = script.find_symbol_by_name("SUM");
+		CHECK_EQ(script.function_checksum(*sum), original.function_checksum(*original.find_symbol_by_name("SUM")));
+
+		zenkit::DaedalusVm vm {std::move(script)};
+		vm.register_external("TWICE", [](std::int32_t v) { return 2 * v; });
+		CHECK_EQ(vm.call_function<int>("SUM", 4), 12);
+
+		// Scripts are saved without the symbols added by the VM.
+		data.clear();
+		w = zenkit::Write::to(&data);
+		vm.save_compiled(w.get());
+
+		zenkit::DaedalusScript again;
+		r = zenkit::Read::from(&data);
+		again.load_compiled(r.get());
+		CHECK_EQ(again.symbols().size(), original.symbols().size());
+
+		data[0] = std::byte {0};
+		r = zenkit::Read::from(&data);
+		CHECK_THROWS_AS(again.load_compiled(r.get()), zenkit::ParserError);
+	}
+
+	TEST_CASE("DaedalusScript.register_members") {
+		ScriptBuilder b;
+		auto types = std::vector<Type> {Type::INT, Type::STRING, Type::FLOAT};
+		b.klass("C_THING", {"ID", "NAME", "WEIGHTS"}, types);
+		auto script = b.build();
+
+		script.register_members("c_thing",
+		                        {
+		                            {"id", &ThingInstance::id},
+		                            {"NAME", &ThingInstance::name},
+		                            {"WEIGHTS", &ThingInstance::weights},
+		                            {"EXTRA", &ThingInstance::extra, true},
+		                        });
+
+		auto* id = script.find_symbol_by_name("C_THING.ID");
+		auto* name = script.find_symbol_by_name("C_THING.NAME");
+		auto* weights = script.find_symbol_by_name("C_THING.WEIGHTS");
+		ThingInstance thing {};
+		auto offset = [&thing](void const* field) {
+			return static_cast<std::uint32_t>(static_cast<std::byte const*>(field) -
+			                                  reinterpret_cast<std::byte const*>(&thing));
+		};
+
+		CHECK_EQ(id->offset_as_member(), offset(&thing.id));
+		CHECK_EQ(name->offset_as_member(), offset(&thing.name));
+		CHECK_EQ(weights->offset_as_member(), offset(&thing.weights));
+		CHECK(name->registered_to() == typeid(ThingInstance));
+		CHECK(script.find_symbol_by_name("C_THING")->registered_to() == typeid(ThingInstance));
+
+		CHECK_THROWS_AS(script.register_members("C_THING", {{"EXTRA", &ThingInstance::extra}}),
+		                zenkit::DaedalusSymbolNotFound);
+		CHECK_THROWS_AS(script.register_members("C_OTHER", {{"ID", &ThingInstance::id}}),
+		                zenkit::DaedalusSymbolNotFound);
+		CHECK_THROWS_AS(script.register_members("C_THING", {{"NAME", &ThingInstance::extra}}),
+		                zenkit::DaedalusInvalidRegistrationDataType);
+		CHECK_THROWS_AS(script.register_members("C_THING", {{"ID", &IdInstance::id}}),
+		                zenkit::DaedalusMemberRegistrationError);
+	}
+}
@@ -0,0 +1,121 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <doctest/doctest.h>
+#include <zenkit/Executor.hh>
+#include <zenkit/Memory.hh>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+/// \brief An executor which never runs its tasks, like a job system which is busy with other work.
+class DeferredExecutor final : public zenkit::Executor {
+public:
+	[[nodiscard]] std::size_t concurrency() const noexcept override {
+		return 4;
+	}
+
+	void execute(std::function<void()> task) override {
+		tasks.push_back(std::move(task));
+	}
+
+	std::vector<std::function<void()>> tasks;
+};
+
+TEST_SUITE("Executor") {
+	TEST_CASE("parallel_for") {
+		std::vector<std::atomic_int> counts(10000);
+		zenkit::parallel_for(counts.size(), [&](std::size_t i) { counts[i]++; });
+
+		for (auto& count : counts) {
+			CHECK_EQ(count.load(), 1);
+		}
+
+		auto empty = 0;
+		zenkit::parallel_for(0, [&](std::size_t) { empty++; });
+		CHECK_EQ(empty, 0);
+	}
+
+	TEST_CASE("parallel_for(exception)") {
+		std::atomic_int calls {0};
+		auto fn = [&](std::size_t i) {
+			calls++;
+			if (i == 5) throw std::runtime_error {"five"};
+		};
+
+		CHECK_THROWS_AS(zenkit::parallel_for(1000, fn), std::runtime_error);
+		CHECK_GE(calls.load(), 1);
+	}
+
+	TEST_CASE("parallel_for(nested)") {
+		zenkit::ThreadPool pool {2};
+		zenkit::set_executor(&pool);
+
+		std::atomic_int total {0};
+		zenkit::parallel_for(16, [&](std::size_t) {
+			zenkit::parallel_for(16, [&](std::size_t) { total++; });
+		});
+
+		zenkit::set_executor(nullptr);
+		CHECK_EQ(total.load(), 256);
+	}
+
+	TEST_CASE("TaskGroup") {
+		DeferredExecutor executor {};
+		zenkit::set_executor(&executor);
+
+		std::atomic_int total {0};
+		zenkit::parallel_for(100, [&](std::size_t i) { total += static_cast<int>(i); });
+		CHECK_EQ(total.load(), 4950);
+		CHECK_EQ(executor.tasks.size(), 4);
+
+		zenkit::set_executor(nullptr);
+
+		// Tasks which were already run by the waiting thread must not be run again.
+		for (auto& task : executor.tasks) {
+			task();
+		}
+		CHECK_EQ(total.load(), 4950);
+
+		zenkit::TaskGroup group {&executor};
+		zenkit::MemoryCategory category = zenkit::MemoryCategory::OTHER;
+		{
+			zenkit::MemoryScope scope {zenkit::MemoryCategory::TEXTURE};
+			group.run([&] { category = zenkit::current_memory_category(); });
+		}
+
+		group.run([] { throw std::runtime_error {"failed"}; });
+		CHECK_THROWS_AS(group.wait(), std::runtime_error);
+		CHECK_EQ(category, zenkit::MemoryCategory::TEXTURE);
+	}
+
+	TEST_CASE("ThreadPool") {
+		std::atomic_int total {0};
+
+		{
+			zenkit::ThreadPool pool {3};
+			CHECK_EQ(pool.concurrency(), 3);
+
+			zenkit::TaskGroup group {&pool};
+			for (auto i = 0; i < 100; ++i) {
+				group.run([&total, &pool] {
+					// Tasks added from a worker go to its own queue and may be stolen by the others.
+					zenkit::TaskGroup inner {&pool};
+					inner.run([&total] { total++; });
+					inner.run([&total] { total++; });
+					inner.wait();
+				});
+			}
+
+			group.wait();
+			CHECK_EQ(total.load(), 200);
+
+			for (auto i = 0; i < 100; ++i) {
+				pool.execute([&total] { total++; });
+			}
+		}
+
+		// Destroying the pool runs the remaining tasks.
+		CHECK_EQ(total.load(), 300);
+	}
+}
@@ -91,4 +91,37 @@ TEST_SUITE("Font") {
 
 		verify_g2(fnt);
 	}
+
+	TEST_CASE("Font.layout") {
+		std::vector<zenkit::FontGlyph> glyphs(256, zenkit::FontGlyph {0, {}});
+		glyphs['A'] = {5, {zenkit::Vec2 {0.0f, 0.0f}, zenkit::Vec2 {0.25f, 0.5f}}};
+		glyphs['B'] = {3, {zenkit::Vec2 {0.25f, 0.0f}, zenkit::Vec2 {0.5f, 0.5f}}};
+		glyphs[0xE4] = {7, {zenkit::Vec2 {0.5f, 0.5f}, zenkit::Vec2 {1.0f, 1.0f}}}; // 'ä' in Windows-1250/1252
+
+		zenkit::Font fnt {"TEST.TGA", 10, glyphs};
+
+		CHECK_EQ(fnt.measure(""), zenkit::Vec2 {0, 10});
+		CHECK_EQ(fnt.measure("AB"), zenkit::Vec2 {8, 10});
+		CHECK_EQ(fnt.measure("B\nA\xE4" "A"), zenkit::Vec2 {17, 20});
+
+		// Characters without a glyph are skipped.
+		std::vector<zenkit::FontQuad> quads;
+		auto size = fnt.layout("A?\n\xE4" "B", quads, zenkit::Vec2 {100, 50});
+		CHECK_EQ(size, zenkit::Vec2 {10, 20});
+
+		REQUIRE_EQ(quads.size(), 3);
+		CHECK_EQ(quads[0].position[0], zenkit::Vec2 {100, 50});
+		CHECK_EQ(quads[0].position[1], zenkit::Vec2 {105, 60});
+		CHECK_EQ(quads[0].uv[1], glyphs['A'].uv[1]);
+		CHECK_EQ(quads[1].position[0], zenkit::Vec2 {100, 60});
+		CHECK_EQ(quads[1].uv[0], glyphs[0xE4].uv[0]);
+		CHECK_EQ(quads[2].position[0], zenkit::Vec2 {107, 60});
+		CHECK_EQ(quads[2].position[1], zenkit::Vec2 {110, 70});
+
+		// The width table has to be updated after changing glyphs.
+		fnt.glyphs['B'].width = 4;
+		CHECK_EQ(fnt.measure("B"), zenkit::Vec2 {3, 10});
+		fnt.update_metrics();
+		CHECK_EQ(fnt.measure("B"), zenkit::Vec2 {4, 10});
+	}
 }
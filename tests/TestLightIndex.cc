@@ -0,0 +1,128 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/vobs/Light.hh>
+#include <zenkit/world/BspTree.hh>
+#include <zenkit/world/LightIndex.hh>
+
+#include <doctest/doctest.h>
+
+#include <memory>
+
+/// \brief Builds a tree split at `x = 0` into a front leaf from `x = 0` to `x = 10` and a back leaf from `x = -10` to
+///        `x = 0`.
+static zenkit::BspTree make_tree() {
+	zenkit::BspTree tree {};
+
+	auto& root = tree.nodes.emplace_back();
+	root.plane = {1, 0, 0, 0};
+	root.front_index = 1;
+	root.back_index = 2;
+	root.bbox = {{-10, -1, -1}, {10, 1, 1}};
+
+	auto& front = tree.nodes.emplace_back();
+	front.parent_index = 0;
+	front.bbox = {{0, -1, -1}, {10, 1, 1}};
+
+	auto& back = tree.nodes.emplace_back();
+	back.parent_index = 0;
+	back.bbox = {{-10, -1, -1}, {0, 1, 1}};
+
+	tree.leaf_node_indices = {1, 2};
+	return tree;
+}
+
+static std::shared_ptr<zenkit::VLight> make_light(float x, float range) {
+	auto light = std::make_shared<zenkit::VLight>();
+	light->position = {x, 0, 0};
+	light->range = range;
+	return light;
+}
+
+TEST_SUITE("LightIndex") {
+	TEST_CASE("LightIndex.build") {
+		auto tree = make_tree();
+		auto front = make_light(5, 2);
+		auto back = make_light(-5, 2);
+		auto middle = make_light(1, 2);
+
+		zenkit::LightIndex index {};
+		index.build({front.get(), back.get(), nullptr, middle.get()}, tree);
+
+		CHECK_EQ(index.size(), 3);
+		REQUIRE_EQ(index.offsets.size(), 4);
+
+		std::vector<zenkit::VLight*> lights;
+		index.query_leaf(0, lights);
+		CHECK(lights.empty());
+
+		index.query_leaf(1, lights);
+		REQUIRE_EQ(lights.size(), 2);
+		CHECK_EQ(lights[0], front.get());
+		CHECK_EQ(lights[1], middle.get());
+
+		index.query_leaf(2, lights);
+		REQUIRE_EQ(lights.size(), 2);
+		CHECK_EQ(lights[0], back.get());
+		CHECK_EQ(lights[1], middle.get());
+
+		index.query_leaf(3, lights);
+		CHECK(lights.empty());
+	}
+
+	TEST_CASE("LightIndex.radius_of") {
+		auto light = make_light(0, 100);
+		CHECK_EQ(zenkit::LightIndex::radius_of(*light), 100);
+
+		light->range_animation_scale = {0.5f, 2.0f, 1.5f};
+		CHECK_EQ(zenkit::LightIndex::radius_of(*light), 200);
+
+		light->range_animation_scale = {0.5f};
+		CHECK_EQ(zenkit::LightIndex::radius_of(*light), 100);
+	}
+
+	TEST_CASE("LightIndex.query_point") {
+		auto tree = make_tree();
+		auto front = make_light(5, 2);
+		auto middle = make_light(1, 2);
+
+		zenkit::LightIndex index {};
+		index.build({front.get(), middle.get()}, tree);
+
+		std::vector<zenkit::VLight*> lights;
+		index.query_point(tree, {6, 0, 0}, lights);
+		REQUIRE_EQ(lights.size(), 1);
+		CHECK_EQ(lights[0], front.get());
+
+		index.query_point(tree, {-0.5f, 0, 0}, lights);
+		REQUIRE_EQ(lights.size(), 1);
+		CHECK_EQ(lights[0], middle.get());
+
+		index.query_point(tree, {-5, 0, 0}, lights);
+		CHECK(lights.empty());
+
+		// Without a tree, all lights are tested.
+		index.query_point(zenkit::BspTree {}, {4, 0, 0}, lights);
+		REQUIRE_EQ(lights.size(), 1);
+		CHECK_EQ(lights[0], front.get());
+	}
+
+	TEST_CASE("LightIndex.query_box") {
+		auto tree = make_tree();
+		auto front = make_light(5, 2);
+		auto back = make_light(-5, 2);
+
+		zenkit::LightIndex index {};
+		index.build({front.get(), back.get()}, tree);
+
+		std::vector<zenkit::VLight*> lights;
+		index.query_box({{6, -1, -1}, {8, 1, 1}}, lights);
+		REQUIRE_EQ(lights.size(), 1);
+		CHECK_EQ(lights[0], front.get());
+
+		index.query_box({{-4, 3, -1}, {4, 4, 1}}, lights);
+		CHECK(lights.empty());
+
+		index.query_box({{-10, -1, -1}, {10, 1, 1}}, lights);
+		CHECK_EQ(lights.size(), 2);
+	}
+}
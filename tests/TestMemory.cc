@@ -0,0 +1,69 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <doctest/doctest.h>
+#include <zenkit/Memory.hh>
+#include <zenkit/Object.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/World.hh>
+
+TEST_SUITE("Memory") {
+	TEST_CASE("MemoryScope") {
+		CHECK_EQ(zenkit::current_memory_category(), zenkit::MemoryCategory::OTHER);
+
+		{
+			zenkit::MemoryScope world {zenkit::MemoryCategory::WORLD};
+			CHECK_EQ(zenkit::current_memory_category(), zenkit::MemoryCategory::WORLD);
+
+			{
+				zenkit::MemoryScope mesh {zenkit::MemoryCategory::MESH};
+				CHECK_EQ(zenkit::current_memory_category(), zenkit::MemoryCategory::MESH);
+			}
+
+			CHECK_EQ(zenkit::current_memory_category(), zenkit::MemoryCategory::WORLD);
+		}
+
+		CHECK_EQ(zenkit::current_memory_category(), zenkit::MemoryCategory::OTHER);
+	}
+
+	TEST_CASE("MemoryTracker") {
+		zenkit::MemoryTracker tracker {};
+
+		{
+			auto arena = zenkit::ObjectArena::create(4096, &tracker);
+			CHECK_NE(arena->allocate(64, 8), nullptr);
+
+			zenkit::MemoryScope scope {zenkit::MemoryCategory::TEXTURE};
+			CHECK_NE(arena->allocate(8192, 64), nullptr);
+		}
+
+		auto other = tracker.stats(zenkit::MemoryCategory::OTHER);
+		CHECK_EQ(other.current, 0);
+		CHECK_EQ(other.total, 4096);
+		CHECK_EQ(other.allocations, 1);
+
+		auto texture = tracker.stats(zenkit::MemoryCategory::TEXTURE);
+		CHECK_EQ(texture.current, 0);
+		CHECK_GE(texture.peak, 8192);
+		CHECK_EQ(texture.allocations, 1);
+
+		CHECK_EQ(tracker.total().allocations, 2);
+	}
+
+	TEST_CASE("MemoryTracker(World)") {
+		zenkit::MemoryTracker tracker {};
+
+		{
+			zenkit::WorldLoadOptions options {};
+			options.memory = &tracker;
+
+			auto in = zenkit::Read::from("./samples/G1/Save/WORLD.SAV");
+			zenkit::World world {};
+			world.load(in.get(), zenkit::GameVersion::GOTHIC_1, options);
+
+			CHECK_FALSE(world.world_vobs.empty());
+			CHECK_GT(tracker.stats(zenkit::MemoryCategory::WORLD).current, 0);
+		}
+
+		CHECK_EQ(tracker.total().current, 0);
+	}
+}
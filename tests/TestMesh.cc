@@ -0,0 +1,283 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/Mesh.hh>
+#include <zenkit/Stream.hh>
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+
+/// \brief Builds a mesh with three 10x10 floor quads at `y = 0`. The first two share an edge and lie in the tile
+///        `(0, 0)` for a tile size of 100, the third one lies in the tile `(-1, 2)`.
+static zenkit::Mesh make_mesh() {
+	zenkit::Mesh mesh {};
+	mesh.materials.resize(3);
+	mesh.materials[0].name = "A";
+	mesh.materials[1].name = "B";
+	mesh.materials[2].name = "C";
+	mesh.features.resize(2);
+	mesh.features[1].light = 0xFF00FF00;
+	mesh.vertices = {{0, 0, 0}, {10, 0, 0}, {10, 0, 10}, {0, 0, 10}, {20, 0, 0}, {20, 0, 10}};
+
+	auto add_polygon = [&mesh](std::initializer_list<std::uint32_t> vertices, std::uint32_t material) {
+		zenkit::Polygon polygon {};
+		polygon.material = material;
+		polygon.lightmap = -1;
+		polygon.index_offset = mesh.polygon_vertex_indices.size();
+		polygon.index_count = vertices.size();
+
+		for (auto vertex : vertices) {
+			mesh.polygon_vertex_indices.push_back(vertex);
+			mesh.polygon_feature_indices.push_back(material == 2 ? 1 : 0);
+		}
+
+		mesh.geometry.push_back(polygon);
+	};
+
+	add_polygon({0, 1, 2, 3}, 1);
+	add_polygon({1, 4, 5, 2}, 1);
+
+	auto distant = static_cast<std::uint32_t>(mesh.vertices.size());
+	mesh.vertices.insert(mesh.vertices.end(), {{-50, 0, 250}, {-40, 0, 250}, {-40, 0, 260}});
+	add_polygon({distant, distant + 1, distant + 2}, 2);
+	return mesh;
+}
+
+TEST_SUITE("Mesh") {
+	TEST_CASE("Mesh.split_into_tiles") {
+		auto mesh = make_mesh();
+		auto tiles = mesh.split_into_tiles(100);
+		REQUIRE_EQ(tiles.size(), 2);
+
+		auto& distant = tiles[0];
+		CHECK_EQ(distant.x, -1);
+		CHECK_EQ(distant.z, 2);
+		CHECK_EQ(distant.polygons, std::vector<std::uint32_t> {2});
+		CHECK_EQ(distant.mesh.vertices.size(), 3);
+		CHECK_EQ(distant.mesh.polygon_vertex_indices, std::vector<std::uint32_t> {0, 1, 2});
+		REQUIRE_EQ(distant.mesh.features.size(), 1);
+		CHECK_EQ(distant.mesh.features[0].light, 0xFF00FF00);
+		REQUIRE_EQ(distant.mesh.materials.size(), 1);
+		CHECK_EQ(distant.mesh.materials[0].name, "C");
+		CHECK_EQ(distant.mesh.geometry[0].material, 0);
+		CHECK_EQ(distant.mesh.bbox.min, zenkit::Vec3 {-50, 0, 250});
+		CHECK_EQ(distant.mesh.bbox.max, zenkit::Vec3 {-40, 0, 260});
+
+		// The shared edge is kept shared inside of the tile.
+		auto& origin = tiles[1];
+		CHECK_EQ(origin.x, 0);
+		CHECK_EQ(origin.z, 0);
+		CHECK_EQ(origin.polygons, std::vector<std::uint32_t> {0, 1});
+		CHECK_EQ(origin.mesh.vertices.size(), 6);
+		CHECK_EQ(origin.mesh.polygon_vertex_indices, std::vector<std::uint32_t> {0, 1, 2, 3, 1, 4, 5, 2});
+		CHECK_EQ(origin.mesh.features.size(), 1);
+		REQUIRE_EQ(origin.mesh.materials.size(), 1);
+		CHECK_EQ(origin.mesh.materials[0].name, "B");
+		CHECK_EQ(origin.mesh.polygons.material_indices, std::vector<std::uint32_t> {0, 0, 0, 0});
+		CHECK_EQ(origin.mesh.polygons.vertex_indices.size(), 12);
+
+		tiles = mesh.split_into_tiles(100, {2, 2, 7});
+		REQUIRE_EQ(tiles.size(), 1);
+		CHECK_EQ(tiles[0].polygons, std::vector<std::uint32_t> {2});
+
+		CHECK(mesh.split_into_tiles(0).empty());
+	}
+
+	TEST_CASE("Mesh.save(tile)") {
+		auto mesh = make_mesh();
+		auto tiles = mesh.split_into_tiles(100);
+		REQUIRE_EQ(tiles.size(), 2);
+
+		for (auto version : {zenkit::GameVersion::GOTHIC_1, zenkit::GameVersion::GOTHIC_2}) {
+			auto& tile = tiles[1].mesh;
+
+			std::vector<std::byte> data;
+			tile.save(zenkit::Write::to(&data).get(), version);
+
+			zenkit::Mesh loaded {};
+			loaded.load(zenkit::Read::from(&data).get(), false);
+
+			CHECK_EQ(loaded.vertices, tile.vertices);
+			CHECK_EQ(loaded.polygon_vertex_indices, tile.polygon_vertex_indices);
+			CHECK_EQ(loaded.polygon_feature_indices, tile.polygon_feature_indices);
+			REQUIRE_EQ(loaded.geometry.size(), tile.geometry.size());
+			CHECK_EQ(loaded.geometry[1].index_offset, 4);
+			CHECK_EQ(loaded.geometry[1].lightmap, -1);
+			REQUIRE_EQ(loaded.materials.size(), 1);
+			CHECK_EQ(loaded.materials[0].name, "B");
+		}
+	}
+
+	TEST_CASE("Mesh.build_lightmap_atlas") {
+		auto load_texture = []() {
+			auto texture = std::make_shared<zenkit::Texture>();
+			texture->load(zenkit::Read::from("./samples/erz.tex").get());
+			return texture;
+		};
+
+		auto mesh = make_mesh();
+		auto a = load_texture();
+		auto b = load_texture();
+		mesh.lightmaps.push_back({a, {{0.01f, 0, 0}, {0, 0, 0.01f}}, {0, 0, 0}});
+		mesh.lightmaps.push_back({b, {{0.01f, 0, 0}, {0, 0, 0.01f}}, {0, 0, 0}});
+		mesh.lightmaps.push_back({a, {{0.02f, 0, 0}, {0, 0, 0.02f}}, {0, 0, 0}});
+		mesh.lightmaps.push_back({nullptr, {}, {}});
+
+		// Both 128x128 textures with padding fit next to each other.
+		auto atlas = mesh.build_lightmap_atlas({512, 2});
+		REQUIRE_EQ(atlas.pages.size(), 1);
+		CHECK_EQ(atlas.pages[0].width, 264);
+		CHECK_EQ(atlas.pages[0].height, 132);
+		REQUIRE_EQ(atlas.regions.size(), 4);
+		CHECK_EQ(atlas.regions[0].page, 0);
+		CHECK_EQ(atlas.regions[0].offset.x, doctest::Approx(2.f / 264));
+		CHECK_EQ(atlas.regions[0].offset.y, doctest::Approx(2.f / 132));
+		CHECK_EQ(atlas.regions[0].scale.x, doctest::Approx(128.f / 264));
+		CHECK_EQ(atlas.regions[1].offset.x, doctest::Approx(134.f / 264));
+		CHECK_EQ(atlas.regions[2].offset.x, atlas.regions[0].offset.x);
+		CHECK_EQ(atlas.regions[3].page, zenkit::LightMapAtlasRegion::NO_PAGE);
+
+		// The borders of each texture are repeated in its padding.
+		auto rgba = a->as_rgba8(0);
+		auto& pixels = atlas.pages[0].pixels;
+		CHECK(std::equal(rgba.begin(), rgba.begin() + 4, pixels.begin()));
+		CHECK(std::equal(rgba.begin(), rgba.begin() + 4, pixels.begin() + (2 * 264 + 2) * 4));
+		CHECK(std::equal(rgba.end() - 128 * 4, rgba.end(), pixels.begin() + (131 * 264 + 2) * 4));
+
+		auto uv = zenkit::LightMapAtlas::uv(mesh.lightmaps[1], atlas.regions[1], {50, 0, 100});
+		CHECK_EQ(uv.x, doctest::Approx(134.f / 264 + 0.5f * 128 / 264));
+		CHECK_EQ(uv.y, doctest::Approx(2.f / 132 + 128.f / 132));
+
+		// Pages too small for both textures.
+		atlas = mesh.build_lightmap_atlas({256, 2});
+		REQUIRE_EQ(atlas.pages.size(), 2);
+		CHECK_EQ(atlas.regions[1].page, 1);
+		CHECK_EQ(atlas.regions[2].page, 0);
+
+		mesh.polygons.vertex_indices = {0, 1, 2, 3, 4, 5};
+		mesh.polygons.lightmap_indices = {2, -1};
+
+		std::vector<zenkit::Vec2> uvs;
+		atlas.compute_uvs(mesh, uvs);
+		REQUIRE_EQ(uvs.size(), 6);
+		CHECK_EQ(uvs[0], atlas.regions[2].offset);
+		CHECK_EQ(uvs[2].x, doctest::Approx(atlas.regions[2].offset.x + 0.2f * atlas.regions[2].scale.x));
+		CHECK_EQ(uvs[5], zenkit::Vec2 {0, 0});
+	}
+
+	TEST_CASE("Mesh.material_batches") {
+		zenkit::Mesh mesh {};
+		mesh.materials.resize(4);
+		mesh.polygons.material_indices = {2, 0, 2, 1, 0, 7, 2};
+
+		auto batches = mesh.material_batches();
+		CHECK_EQ(batches.triangles, std::vector<std::uint32_t> {1, 4, 3, 0, 2, 6});
+		REQUIRE_EQ(batches.batches.size(), 3);
+		CHECK_EQ(batches.batches[0].material, 0);
+		CHECK_EQ(batches.batches[0].offset, 0);
+		CHECK_EQ(batches.batches[0].count, 2);
+		CHECK_EQ(batches.batches[1].material, 1);
+		CHECK_EQ(batches.batches[2].material, 2);
+		CHECK_EQ(batches.batches[2].offset, 3);
+		CHECK_EQ(batches.batches[2].count, 3);
+
+		// Large meshes are sorted on multiple threads, which must give the same stable order.
+		mesh.polygons.material_indices.resize(300000);
+		for (auto i = 0u; i < mesh.polygons.material_indices.size(); ++i) {
+			mesh.polygons.material_indices[i] = (i * 7919u) % 5;
+		}
+
+		batches = mesh.material_batches();
+		REQUIRE_EQ(batches.triangles.size(), 240000);
+		REQUIRE_EQ(batches.batches.size(), 4);
+		for (auto& batch : batches.batches) {
+			for (auto i = batch.offset; i < batch.offset + batch.count; ++i) {
+				CHECK_EQ(mesh.polygons.material_indices[batches.triangles[i]], batch.material);
+				if (i > batch.offset) CHECK_LT(batches.triangles[i - 1], batches.triangles[i]);
+			}
+		}
+	}
+
+	TEST_CASE("OrientedBoundingBox.intersect") {
+		// A box rotated by 45 degrees around the y axis.
+		auto c = std::sqrt(0.5f);
+		zenkit::OrientedBoundingBox box {};
+		box.center = zenkit::Vec3 {10, 0, 0};
+		box.axes[0] = zenkit::Vec3 {c, 0, -c};
+		box.axes[1] = zenkit::Vec3 {0, 1, 0};
+		box.axes[2] = zenkit::Vec3 {c, 0, c};
+		box.half_width = zenkit::Vec3 {1, 1, 1};
+
+		auto hit = box.intersect(zenkit::Vec3 {0, 0, 0}, zenkit::Vec3 {1, 0, 0});
+		REQUIRE(hit);
+		CHECK_EQ(*hit, doctest::Approx(10 - std::sqrt(2.0f)));
+
+		CHECK_EQ(box.intersect(zenkit::Vec3 {10, 0, 0}, zenkit::Vec3 {0, 1, 0}), 0.0f);
+		CHECK_FALSE(box.intersect(zenkit::Vec3 {0, 0, 0}, zenkit::Vec3 {-1, 0, 0}));
+		CHECK_FALSE(box.intersect(zenkit::Vec3 {0, 2, 0}, zenkit::Vec3 {1, 0, 0}));
+
+		// Overlaps
+		auto other = box;
+		other.center = zenkit::Vec3 {12.3f, 0, 0};
+		CHECK(box.intersects(other)); // The corners face each other along x.
+
+		other.center = zenkit::Vec3 {12.9f, 0, 0};
+		CHECK_FALSE(box.intersects(other));
+
+		other.axes[0] = zenkit::Vec3 {1, 0, 0};
+		other.axes[2] = zenkit::Vec3 {0, 0, 1};
+		other.center = zenkit::Vec3 {12.3f, 0, 0};
+		CHECK(box.intersects(other));
+
+		other.center = zenkit::Vec3 {10, 2.5f, 0};
+		CHECK_FALSE(box.intersects(other));
+	}
+
+	TEST_CASE("OrientedBoundingBox.raycast") {
+		auto make_box = [](zenkit::Vec3 center, float size) {
+			zenkit::OrientedBoundingBox box {};
+			box.center = center;
+			box.axes[0] = zenkit::Vec3 {1, 0, 0};
+			box.axes[1] = zenkit::Vec3 {0, 1, 0};
+			box.axes[2] = zenkit::Vec3 {0, 0, 1};
+			box.half_width = zenkit::Vec3 {size};
+			return box;
+		};
+
+		auto root = make_box({0, 0, 0}, 10);
+		root.children.push_back(make_box({5, 0, 0}, 1));
+		root.children.push_back(make_box({-5, 0, 0}, 1));
+		root.children.push_back(make_box({0, 5, 0}, 1));
+
+		auto hit = root.raycast(zenkit::Vec3 {-20, 0, 0}, zenkit::Vec3 {1, 0, 0});
+		REQUIRE(hit);
+		CHECK_EQ(hit->distance, doctest::Approx(14));
+		CHECK_EQ(hit->box, &root.children[1]);
+
+		hit = root.raycast(zenkit::Vec3 {20, 0, 0}, zenkit::Vec3 {-1, 0, 0});
+		REQUIRE(hit);
+		CHECK_EQ(hit->box, &root.children[0]);
+
+		// The ray passes through the root, but misses all leaves.
+		CHECK_FALSE(root.raycast(zenkit::Vec3 {-20, -5, 0}, zenkit::Vec3 {1, 0, 0}));
+		CHECK_FALSE(root.raycast(zenkit::Vec3 {-20, 0, 0}, zenkit::Vec3 {1, 0, 0}, 10));
+
+		// Only the leaves of both trees count as overlapping.
+		auto other = make_box({0, 0, 0}, 1);
+		CHECK_FALSE(root.overlaps(other));
+		CHECK_FALSE(other.overlaps(root));
+
+		other.center = zenkit::Vec3 {0, 3.5f, 0};
+		CHECK(root.overlaps(other));
+		CHECK(other.overlaps(root));
+
+		auto tree = make_box({0, 0, 0}, 4);
+		tree.children.push_back(make_box({0, 3.5f, 0}, 1));
+		tree.children.push_back(make_box({0, -3.5f, 0}, 1));
+		CHECK(root.overlaps(tree));
+
+		tree.children.erase(tree.children.begin());
+		CHECK_FALSE(root.overlaps(tree));
+	}
+}
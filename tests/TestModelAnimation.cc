@@ -100,4 +100,129 @@ TEST_SUITE("ModelAnimation") {
 		    "\t\t\tANI\t\t\t(\"S_FISTRUN\"\t\t\t\t1\t\"S_FISTRUN\"\t\t0.0 0.1 MI\t\"HUM_AMB_FISTRUN_M01.ASC\"\tF   "
 		    "1\t50\tFPS:10)");
 	}
+
+	TEST_CASE("ModelAnimation.load(compact)") {
+		auto in = Read::from("./samples/G2/HUMANS-S_FISTRUN.MAN");
+		ModelAnimation full {};
+		full.load(in.get());
+
+		in = Read::from("./samples/G2/HUMANS-S_FISTRUN.MAN");
+		ModelAnimation anim {};
+		anim.load(in.get(), ModelAnimationLoadOptions {true});
+
+		CHECK(anim.is_compact());
+		CHECK(anim.samples.empty());
+		CHECK_EQ(anim.quantized_samples.size(), 25 * 20 /* node_count * frame_count */);
+		CHECK_EQ(anim.node_indices, G2_NODE_INDICES);
+		CHECK_EQ(anim.sample(0, 0), G2_SAMPLE0);
+		CHECK_EQ(anim.sample(9, 24), G2_SAMPLE249);
+		CHECK_EQ(anim.sample(19, 24), G2_SAMPLE499);
+		CHECK_EQ(anim.sample(20, 0), AnimationSample {});
+
+		std::vector<AnimationSample> frame(anim.node_count);
+		std::vector<AnimationSample> expected(anim.node_count);
+		for (auto i = 0u; i < anim.frame_count; ++i) {
+			REQUIRE(anim.decode_frame(i, frame.data()));
+			REQUIRE(full.decode_frame(i, expected.data()));
+			CHECK_EQ(frame, expected);
+		}
+
+		CHECK_FALSE(anim.decode_frame(anim.frame_count, frame.data()));
+	}
+
+	TEST_CASE("ModelAnimation.sample_pose") {
+		auto in = Read::from("./samples/G2/HUMANS-S_FISTRUN.MAN");
+		ModelAnimation anim {};
+		anim.load(in.get());
+
+		std::vector<AnimationSample> pose(anim.node_count);
+		anim.sample_pose(0, pose.data());
+		CHECK_EQ(pose[0], G2_SAMPLE0);
+
+		// Exactly on a frame, the frame's samples are returned unchanged.
+		anim.sample_pose(9.0f / anim.fps, pose.data());
+		CHECK_EQ(pose[24], G2_SAMPLE249);
+
+		// Between two frames, the samples are interpolated.
+		anim.sample_pose(0.5f / anim.fps, pose.data());
+		auto a = anim.sample(0, 0);
+		auto b = anim.sample(1, 0);
+		CHECK_EQ(pose[0].position.x, doctest::Approx((a.position.x + b.position.x) / 2));
+		CHECK_EQ(pose[0].position.y, doctest::Approx((a.position.y + b.position.y) / 2));
+
+		auto const& q = pose[0].rotation;
+		CHECK_EQ(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z, doctest::Approx(1));
+
+		// Without looping, time is clamped to the last frame.
+		anim.sample_pose(100, pose.data(), false);
+		CHECK_EQ(pose[24], G2_SAMPLE499);
+
+		// With looping, the animation wraps around.
+		anim.sample_pose(static_cast<float>(anim.frame_count) / anim.fps, pose.data());
+		CHECK_EQ(pose[0], G2_SAMPLE0);
+	}
+
+	TEST_CASE("ModelAnimation.blend_poses") {
+		AnimationSample a {Vec3 {0, 0, 0}, Quat {1, 0, 0, 0}};
+		AnimationSample b {Vec3 {2, 4, 6}, Quat {-1, 0, 0, 0}};
+		AnimationSample out {};
+
+		// Opposite quaternions describe the same rotation, so blending them must not cancel out.
+		ModelAnimation::blend_poses(&a, &b, 1, 0.5f, &out);
+		CHECK_EQ(out.position, Vec3 {1, 2, 3});
+		CHECK_EQ(out.rotation.w, doctest::Approx(1));
+
+		ModelAnimation::blend_poses(&a, &b, 1, 0, &out);
+		CHECK_EQ(out, a);
+	}
+
+	TEST_CASE("ModelAnimation.apply_layer") {
+		auto in = Read::from("./samples/G2/HUMANS-S_FISTRUN.MAN");
+		ModelAnimation anim {};
+		anim.load(in.get());
+
+		AnimationSample rest {Vec3 {1, 1, 1}, Quat {1, 0, 0, 0}};
+		std::vector<AnimationSample> pose(40, rest);
+		anim.apply_layer(0, 1, pose.data(), pose.size());
+
+		CHECK_EQ(pose[0], G2_SAMPLE0);
+		CHECK_EQ(pose[7], rest); // Node 7 is not animated.
+		CHECK_EQ(pose[33], anim.sample(0, 24));
+		CHECK_EQ(pose[34], rest);
+
+		pose.assign(40, rest);
+		anim.apply_layer(0, 0, pose.data(), pose.size());
+		CHECK_EQ(pose[0], rest);
+	}
+
+	TEST_CASE("ModelAnimation.events_in_range") {
+		ModelAnimation anim {};
+		anim.events.resize(5);
+		anim.events[0].frame = 4;
+		anim.events[1].frame = 1;
+		anim.events[2].frame = 4;
+		anim.events[3].frame = 0;
+		anim.events[4].frame = 9;
+		anim.index_events();
+
+		auto all = anim.events_in_range(-1, 9);
+		REQUIRE_EQ(all.size(), 5);
+		CHECK_EQ(&all[0], &anim.events[3]);
+		CHECK_EQ(&all[1], &anim.events[1]);
+		CHECK_EQ(&all[2], &anim.events[0]); // Events in the same frame keep their order.
+		CHECK_EQ(&all[3], &anim.events[2]);
+		CHECK_EQ(&all[4], &anim.events[4]);
+
+		auto some = anim.events_in_range(0, 4);
+		REQUIRE_EQ(some.size(), 3);
+		CHECK_EQ(some.begin()->frame, 1);
+
+		CHECK(anim.events_in_range(4, 8).empty());
+		CHECK(anim.events_in_range(9, 20).empty());
+		CHECK(anim.events_in_range(4, 4).empty());
+
+		// The index follows the animation when it is copied.
+		auto copy = anim;
+		CHECK_EQ(&copy.events_in_range(-1, 0)[0], &copy.events[3]);
+	}
 }
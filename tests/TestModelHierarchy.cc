@@ -1,6 +1,7 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include <doctest/doctest.h>
+#include <zenkit/ModelAnimation.hh>
 #include <zenkit/ModelHierarchy.hh>
 #include <zenkit/Stream.hh>
 
@@ -38,4 +39,171 @@ TEST_SUITE("ModelHierarchy") {
 	TEST_CASE("ModelHierarchy.load(GOTHIC2)" * doctest::skip()) {
 		// TODO: Stub
 	}
+
+	TEST_CASE("ModelHierarchy.build_evaluation_order") {
+		zenkit::ModelHierarchy hierarchy {};
+		hierarchy.nodes.resize(5);
+		hierarchy.nodes[0].parent_index = 2;
+		hierarchy.nodes[1].parent_index = -1;
+		hierarchy.nodes[2].parent_index = 1;
+		hierarchy.nodes[3].parent_index = 4; // 3 and 4 form a cycle.
+		hierarchy.nodes[4].parent_index = 3;
+
+		hierarchy.build_evaluation_order();
+		CHECK_EQ(hierarchy.evaluation_order, std::vector<std::uint16_t> {1, 2, 0, 3, 4});
+
+		auto in = zenkit::Read::from("./samples/hierarchy0.mdh");
+		hierarchy.load(in.get());
+		CHECK_EQ(hierarchy.evaluation_order.size(), hierarchy.nodes.size());
+		CHECK_EQ(hierarchy.evaluation_order[0], 0);
+	}
+
+	TEST_CASE("ModelHierarchy.find_node") {
+		auto in = zenkit::Read::from("./samples/hierarchy0.mdh");
+		zenkit::ModelHierarchy hierarchy {};
+		hierarchy.load(in.get());
+
+		for (auto i = 0u; i < hierarchy.nodes.size(); ++i) {
+			CHECK_EQ(hierarchy.find_node(hierarchy.nodes[i].name), i);
+		}
+
+		CHECK_EQ(hierarchy.find_node("bip01 nabe"), 1);
+		CHECK_EQ(hierarchy.find_node("BIP01"), std::nullopt);
+		CHECK_EQ(hierarchy.find_node(""), std::nullopt);
+
+		// Without rebuilding the index, changed nodes are still found.
+		hierarchy.nodes.push_back({0, "EXTRA", {}});
+		CHECK_EQ(hierarchy.find_node("Extra"), 7);
+
+		hierarchy.build_node_index();
+		CHECK_EQ(hierarchy.find_node("Extra"), 7);
+	}
+
+	TEST_CASE("ModelHierarchy.remap_nodes") {
+		zenkit::ModelHierarchy source {};
+		source.nodes.push_back({-1, "BIP01", {}});
+		source.nodes.push_back({0, "BIP01 HEAD", {}});
+		source.nodes.push_back({0, "BIP01 TAIL", {}});
+		source.checksum = 1;
+		source.build_node_index();
+
+		zenkit::ModelHierarchy target {};
+		target.nodes.push_back({-1, "Bip01", {}});
+		target.nodes.push_back({0, "BIP01 SPINE", {}});
+		target.nodes.push_back({1, "BIP01 HEAD", {}});
+		target.checksum = 2;
+		target.build_node_index();
+
+		zenkit::ModelAnimation anim {};
+		anim.node_indices = {2, 1, 0};
+		anim.checksum = 1;
+
+		auto remap = anim.remap_nodes(source, target);
+		CHECK_EQ(remap->source_checksum, 1);
+		CHECK_EQ(remap->target_checksum, 2);
+		CHECK_EQ(remap->nodes, std::vector<std::uint32_t> {zenkit::AnimationNodeRemap::NONE, 2, 0});
+
+		// The mapping is cached until another pair of hierarchies is used.
+		CHECK_EQ(anim.remap_nodes(source, target), remap);
+		CHECK_NE(anim.remap_nodes(source, source), remap);
+		CHECK_EQ(anim.remap_nodes(source, source)->nodes, std::vector<std::uint32_t> {2, 1, 0});
+
+		// Loading the animation replaces its node indices, so the mapping has to be rebuilt.
+		remap = anim.remap_nodes(source, target);
+		anim.load(zenkit::Read::from("./samples/G1/HUMANS-S_FISTRUN.MAN").get());
+		CHECK_NE(anim.remap_nodes(source, target), remap);
+
+		// Hierarchies without a checksum can't be told apart, so their mappings are not cached.
+		target.checksum = 0;
+		CHECK_NE(anim.remap_nodes(source, target), anim.remap_nodes(source, target));
+	}
+
+	TEST_CASE("ModelHierarchy.AnimationBinding") {
+		zenkit::ModelHierarchy source {};
+		source.nodes.push_back({-1, "BIP01", {}});
+		source.nodes.push_back({0, "BIP01 HEAD", {}});
+		source.nodes.push_back({0, "BIP01 TAIL", {}});
+		source.checksum = 1;
+		source.build_node_index();
+
+		zenkit::ModelHierarchy target {};
+		target.nodes.push_back({-1, "BIP01", {}});
+		target.nodes.push_back({0, "BIP01 SPINE", {}});
+		target.nodes.push_back({1, "BIP01 HEAD", {}});
+		target.checksum = 2;
+		target.build_node_index();
+
+		zenkit::ModelAnimation anim {};
+		anim.frame_count = 1;
+		anim.node_count = 3;
+		anim.fps = 25;
+		anim.checksum = 1;
+		anim.node_indices = {2, 1, 0};
+		anim.samples = {
+		    {zenkit::Vec3 {2, 0, 0}, zenkit::Quat {1, 0, 0, 0}},
+		    {zenkit::Vec3 {1, 0, 0}, zenkit::Quat {1, 0, 0, 0}},
+		    {zenkit::Vec3 {0, 0, 0}, zenkit::Quat {1, 0, 0, 0}},
+		};
+
+		zenkit::AnimationBinding direct {anim, source};
+		CHECK_EQ(direct.bound_node_count(), 3);
+		CHECK_EQ(direct.channel(0), 2);
+		CHECK_EQ(direct.channel(2), 0);
+
+		// The tail does not exist in the target and the spine is not animated.
+		zenkit::AnimationBinding binding {anim, source, target};
+		CHECK_EQ(binding.node_count(), 3);
+		CHECK_EQ(binding.bound_node_count(), 2);
+		CHECK_EQ(binding.channel(0), 2);
+		CHECK_EQ(binding.channel(1), zenkit::AnimationBinding::NONE);
+		CHECK_EQ(binding.channel(2), 1);
+		CHECK_EQ(binding.channel(3), zenkit::AnimationBinding::NONE);
+
+		zenkit::AnimationSample rest {zenkit::Vec3 {9, 9, 9}, zenkit::Quat {1, 0, 0, 0}};
+		std::vector<zenkit::AnimationSample> pose(3, rest);
+		binding.apply_layer(0, 1, pose.data());
+		CHECK_EQ(pose[0].position, zenkit::Vec3 {0, 0, 0});
+		CHECK_EQ(pose[1], rest);
+		CHECK_EQ(pose[2].position, zenkit::Vec3 {1, 0, 0});
+
+		// Binding to a hierarchy with another checksum without a source binds nothing.
+		zenkit::AnimationBinding mismatch {anim, target};
+		CHECK_EQ(mismatch.bound_node_count(), 0);
+	}
+
+	TEST_CASE("ModelHierarchy.compute_world_transforms") {
+		auto in = zenkit::Read::from("./samples/hierarchy0.mdh");
+		zenkit::ModelHierarchy hierarchy {};
+		hierarchy.load(in.get());
+
+		auto count = hierarchy.nodes.size();
+		std::vector<zenkit::AnimationSample> pose(count);
+		hierarchy.compute_rest_pose(pose.data());
+
+		// The rest pose reproduces the transforms of the nodes.
+		std::vector<zenkit::Mat3x4> local(count);
+		hierarchy.compute_local_transforms(pose.data(), local.data());
+		for (auto i = 0u; i < count; ++i) {
+			zenkit::Mat3x4 expected {hierarchy.nodes[i].transform};
+			for (auto r = 0u; r < 3; ++r) {
+				for (auto c = 0u; c < 4; ++c) {
+					CHECK_EQ(local[i][r][c], doctest::Approx(expected[r][c]).epsilon(0.001));
+				}
+			}
+		}
+
+		std::vector<zenkit::Mat3x4> world(count);
+		hierarchy.compute_world_transforms(local.data(), world.data());
+		for (auto i = 0u; i < count; ++i) {
+			auto parent = hierarchy.nodes[i].parent_index;
+			CHECK_EQ(world[i], parent < 0 ? local[i] : world[parent] * local[i]);
+		}
+
+		// Node 1 is translated along the z-axis of its parent, which is flipped.
+		CHECK_EQ(world[1].transform_point({0, 0, 0}).z, doctest::Approx(394.040466));
+
+		std::vector<zenkit::Mat3x4> from_pose(count);
+		hierarchy.compute_world_transforms(pose.data(), from_pose.data());
+		CHECK_EQ(from_pose, world);
+	}
 }
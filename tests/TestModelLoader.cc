@@ -0,0 +1,87 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <doctest/doctest.h>
+#include <zenkit/ModelLoader.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/Vfs.hh>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static std::vector<std::byte> read_file(char const* path) {
+	std::ifstream in {path, std::ios::binary};
+	std::vector<char> data {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+
+	std::vector<std::byte> bytes(data.size());
+	std::memcpy(bytes.data(), data.data(), data.size());
+	return bytes;
+}
+
+static void add_file(zenkit::VfsNode& dir, std::string_view name, std::vector<std::byte> const& data) {
+	dir.create(zenkit::VfsNode::file(name, zenkit::VfsFileDescriptor {data.data(), data.size(), false}));
+}
+
+static std::string const SCRIPT = R"(Model("HUMANS") {
+	meshAndTree("Hum_Body_Naked0.asc" DONT_USE_MESH)
+	registerMesh("SecretDoor.asc")
+	registerMesh("Missing.asc")
+
+	aniEnum {
+		ani("S_FISTRUN" 1 "S_FISTRUN" 0.0 0.0 M. "Hum_Run.asc" F 0 10)
+		ani("S_MISSING" 1 "" 0.0 0.0 M. "Hum_Run.asc" F 0 10)
+	}
+})";
+
+TEST_SUITE("ModelLoader") {
+	TEST_CASE("ModelLoader.load") {
+		auto hierarchy = read_file("./samples/hierarchy0.mdh");
+		auto mesh = read_file("./samples/secretdoor.mdm");
+		auto animation = read_file("./samples/G1/HUMANS-S_FISTRUN.MAN");
+
+		std::vector<std::byte> script(SCRIPT.size());
+		std::memcpy(script.data(), SCRIPT.data(), SCRIPT.size());
+
+		zenkit::Vfs vfs {};
+		auto& anims = vfs.mkdir("ANIMS/_COMPILED");
+		add_file(anims, "HUMANS.MDS", script);
+		add_file(anims, "HUMANS.MDH", hierarchy);
+		add_file(anims, "SECRETDOOR.MDM", mesh);
+		add_file(anims, "HUMANS-S_FISTRUN.MAN", animation);
+
+		zenkit::ModelLoader loader {vfs, {2}};
+
+		auto model = loader.load("Humans.mds");
+		REQUIRE_NE(model.script, nullptr);
+		CHECK_EQ(model.script->animations.size(), 2);
+
+		REQUIRE_NE(model.hierarchy, nullptr);
+		CHECK_EQ(model.hierarchy->nodes.size(), 7);
+		CHECK_EQ(model.mesh, nullptr);
+
+		REQUIRE_EQ(model.meshes.size(), 2);
+		REQUIRE_NE(model.meshes[0], nullptr);
+		CHECK_EQ(model.meshes[0]->attachments.size(), 1);
+		CHECK_EQ(model.meshes[1], nullptr);
+
+		REQUIRE_EQ(model.animations.size(), 2);
+		REQUIRE_NE(model.animations[0], nullptr);
+		CHECK_EQ(model.animations[0]->name, "S_FISTRUN");
+		CHECK_EQ(model.animations[1], nullptr);
+
+		// Loading the model again shares all files with the first one.
+		auto again = loader.load("HUMANS");
+		CHECK_EQ(again.script, model.script);
+		CHECK_EQ(again.hierarchy, model.hierarchy);
+		CHECK_EQ(again.meshes[0], model.meshes[0]);
+		CHECK_EQ(again.animations[0], model.animations[0]);
+
+		// After clearing the loader, files are loaded again.
+		loader.clear();
+		auto reloaded = loader.load("HUMANS");
+		CHECK_NE(reloaded.hierarchy, model.hierarchy);
+		CHECK_EQ(reloaded.hierarchy->nodes.size(), 7);
+
+		CHECK_EQ(loader.load("NOTHING").script, nullptr);
+	}
+}
@@ -68,4 +68,97 @@ TEST_SUITE("ModelMesh") {
 	TEST_CASE("ModelMesh.load(GOTHIC2)" * doctest::skip()) {
 		// TODO: Stub
 	}
+
+	TEST_CASE("SoftSkinMesh.skin") {
+		auto in = zenkit::Read::from("./samples/smoke_waterpipe.mdm");
+		zenkit::ModelMesh mesh {};
+		mesh.load(in.get());
+
+		auto& sk = mesh.meshes[0];
+		REQUIRE_EQ(sk.packed_weights.offsets.size(), 116);
+		CHECK_EQ(sk.packed_weights.offsets[115], 115);
+		CHECK_EQ(sk.packed_weights.positions[62], zenkit::Vec3 {0.260997772f, 18.0412712f, -23.9048882f});
+		CHECK_EQ(sk.packed_weights.node_indices[62], 4);
+
+		// Move hierarchy node 5, which is node 1 of the mesh, by 10 along the x-axis.
+		std::vector<zenkit::Mat3x4> transforms(6, zenkit::Mat3x4::identity());
+		transforms[5][0].w = 10;
+
+		std::vector<zenkit::Vec3> positions(sk.mesh.positions.size());
+		sk.skin(transforms.data(), transforms.size(), positions.data());
+
+		for (auto i = 0u; i < positions.size(); ++i) {
+			auto expected = sk.weights[i][0].position;
+			if (sk.weights[i][0].node_index == 1) expected.x += 10;
+			CHECK_EQ(positions[i], expected);
+		}
+
+		// Without packed weights, the nested weights are used.
+		std::vector<zenkit::Vec3> unpacked(positions.size());
+		sk.packed_weights = {};
+		sk.skin(transforms.data(), transforms.size(), unpacked.data());
+		CHECK_EQ(unpacked, positions);
+
+		// Nodes without a transform don't contribute.
+		sk.skin(transforms.data(), 1, unpacked.data());
+		CHECK_EQ(unpacked[62], zenkit::Vec3 {0, 0, 0});
+	}
+
+	TEST_CASE("ModelMesh.build_skinned_buffers") {
+		auto in = zenkit::Read::from("./samples/smoke_waterpipe.mdm");
+		zenkit::ModelMesh mesh {};
+		mesh.load(in.get());
+
+		auto buffers = mesh.build_skinned_buffers();
+		REQUIRE_EQ(buffers.size(), 1);
+
+		auto& sk = mesh.meshes[0];
+		auto& sub_mesh = sk.mesh.sub_meshes[0];
+		auto& b = buffers[0];
+
+		CHECK_EQ(b.nodes, sk.nodes);
+		CHECK_EQ(b.vertices.size(), sub_mesh.wedges.size());
+		CHECK_FALSE(b.wide_indices());
+		CHECK_EQ(b.index_count(), sub_mesh.triangles.size() * 3);
+		REQUIRE_EQ(b.batches.size(), 1);
+		CHECK_EQ(b.batches[0].material, 0);
+		CHECK_EQ(b.batches[0].index_count, b.index_count());
+
+		for (auto i = 0u; i < b.vertices.size(); ++i) {
+			auto& v = b.vertices[i];
+			auto& wedge = sub_mesh.wedges[i];
+			auto& weight = sk.weights[wedge.index][0];
+
+			CHECK_EQ(v.positions[0], weight.position);
+			CHECK_EQ(v.weights[0], 1.0f);
+			CHECK_EQ(v.weights[1], 0.0f);
+			CHECK_EQ(v.nodes[0], weight.node_index);
+			CHECK_EQ(v.normal, wedge.normal);
+			CHECK_EQ(v.texture, wedge.texture);
+		}
+
+		// Only the four strongest influences are kept.
+		sk.weights[0] = {
+		    {0.1f, {1, 0, 0}, 1},
+		    {0.4f, {2, 0, 0}, 2},
+		    {0.05f, {3, 0, 0}, 3},
+		    {0.2f, {4, 0, 0}, 4},
+		    {0.25f, {5, 0, 0}, 5},
+		};
+
+		auto skinned = sk.build_skinned_buffers(zenkit::MeshBufferOptions {true});
+		CHECK(skinned.wide_indices());
+
+		for (auto i = 0u; i < sub_mesh.wedges.size(); ++i) {
+			if (sub_mesh.wedges[i].index != 0) continue;
+
+			auto& v = skinned.vertices[i];
+			CHECK_EQ(v.nodes[0], 2);
+			CHECK_EQ(v.nodes[1], 5);
+			CHECK_EQ(v.nodes[2], 4);
+			CHECK_EQ(v.nodes[3], 1);
+			CHECK_EQ(v.weights[0] + v.weights[1] + v.weights[2] + v.weights[3], doctest::Approx(1));
+			CHECK_EQ(v.weights[0], doctest::Approx(0.4f / 0.95f));
+		}
+	}
 }
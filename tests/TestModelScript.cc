@@ -5,6 +5,9 @@
 #include <zenkit/ModelScript.hh>
 #include <zenkit/Stream.hh>
 
+#include <algorithm>
+#include <fstream>
+
 TEST_SUITE("ModelScript") {
 	TEST_CASE("ModelScript.load(GOTHIC?)") {
 		zenkit::Logger::set_default(zenkit::LogLevel::INFO);
@@ -243,6 +246,125 @@ TEST_SUITE("ModelScript") {
 		CHECK_EQ(script.animations[47].events[3].frames[1], 15);
 	}
 
+	TEST_CASE("ModelScript.load(STREAM)") {
+		// Scripts from streams which are not backed by memory are buffered before tokenizing.
+		std::ifstream in {"./samples/waran.mds", std::ios::binary};
+		auto r = zenkit::Read::from(&in);
+		zenkit::ModelScript script {};
+		script.load(r.get());
+
+		CHECK_EQ(script.skeleton.name, "TestModelMesh.asc");
+		CHECK_EQ(script.animations.size(), 2);
+		CHECK_EQ(script.animations[1].events[1].frames, std::vector {1, 2, 3, 4, 5});
+		CHECK_EQ(script.model_tags.size(), 2);
+		CHECK_EQ(script.model_tags[1].bone, "tag2");
+	}
+
+	TEST_CASE("ModelScript.save") {
+		auto r = zenkit::Read::from("./samples/waran.mds");
+		zenkit::ModelScript source {};
+		source.load(r.get());
+
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		source.save(w.get());
+
+		auto rb = zenkit::Read::from(&data);
+		zenkit::ModelScript script {};
+		script.load(rb.get());
+
+		CHECK_EQ(script.skeleton.disable_mesh, source.skeleton.disable_mesh);
+		CHECK_EQ(script.skeleton.name, source.skeleton.name);
+		CHECK_EQ(script.meshes, source.meshes);
+		CHECK_EQ(script.disabled_animations, source.disabled_animations);
+
+		REQUIRE_EQ(script.animations.size(), source.animations.size());
+		for (auto i = 0u; i < script.animations.size(); ++i) {
+			auto& a = script.animations[i];
+			auto& b = source.animations[i];
+
+			CHECK_EQ(a.name, b.name);
+			CHECK_EQ(a.layer, b.layer);
+			CHECK_EQ(a.next, b.next);
+			CHECK_EQ(a.blend_in, b.blend_in);
+			CHECK_EQ(a.blend_out, b.blend_out);
+			CHECK_EQ(a.flags, b.flags);
+			CHECK_EQ(a.model, b.model);
+			CHECK_EQ(a.direction, b.direction);
+			CHECK_EQ(a.first_frame, b.first_frame);
+			CHECK_EQ(a.last_frame, b.last_frame);
+			CHECK_EQ(a.fps, b.fps);
+			CHECK_EQ(a.speed, b.speed);
+			CHECK_EQ(a.collision_volume_scale, b.collision_volume_scale);
+			CHECK_EQ(a.events.size(), b.events.size());
+			CHECK_EQ(a.pfx.size(), b.pfx.size());
+			CHECK_EQ(a.pfx_stop.size(), b.pfx_stop.size());
+			CHECK_EQ(a.sfx.size(), b.sfx.size());
+			CHECK_EQ(a.sfx_ground.size(), b.sfx_ground.size());
+			CHECK_EQ(a.morph.size(), b.morph.size());
+			CHECK_EQ(a.tremors.size(), b.tremors.size());
+		}
+
+		CHECK_EQ(script.animations[1].events[1].type, zenkit::MdsEventType::COMBO_WINDOW);
+		CHECK_EQ(script.animations[1].events[1].frames, std::vector {1, 2, 3, 4, 5});
+
+		REQUIRE_EQ(script.aliases.size(), source.aliases.size());
+		CHECK_EQ(script.aliases[0].alias, source.aliases[0].alias);
+		CHECK_EQ(script.aliases[0].flags, source.aliases[0].flags);
+		CHECK_EQ(script.aliases[0].direction, source.aliases[0].direction);
+
+		REQUIRE_EQ(script.blends.size(), source.blends.size());
+		CHECK_EQ(script.blends[0].next, source.blends[0].next);
+
+		REQUIRE_EQ(script.combinations.size(), source.combinations.size());
+		CHECK_EQ(script.combinations[1].model, source.combinations[1].model);
+		CHECK_EQ(script.combinations[1].last_frame, source.combinations[1].last_frame);
+
+		REQUIRE_EQ(script.model_tags.size(), source.model_tags.size());
+		CHECK_EQ(script.model_tags[1].bone, source.model_tags[1].bone);
+	}
+
+	TEST_CASE("ModelScript.events_in_range") {
+		auto buf = zenkit::Read::from("./samples/waran.msb");
+		zenkit::ModelScript script {};
+		script.load(buf.get());
+
+		auto& anim = script.animations[47];
+		REQUIRE_EQ(anim.events.size(), 4);
+
+		// All events fire in the first frame and are returned in the order they are listed in.
+		auto first = anim.events_in_range(-1, 0);
+		REQUIRE_EQ(first.size(), 4);
+		CHECK_EQ(&first[0], &anim.events[0]);
+		CHECK_EQ(first[3].type, zenkit::MdsEventType::COMBO_WINDOW);
+		CHECK(anim.events_in_range(0, 10).empty());
+
+		for (auto& a : script.animations) {
+			for (int32_t from = -1; from <= a.last_frame; ++from) {
+				for (int32_t to = from + 1; to <= a.last_frame; to += 3) {
+					auto range = a.events_in_range(from, to);
+					auto expected = std::count_if(a.events.begin(), a.events.end(), [&](auto const& e) {
+						return e.frame > from && e.frame <= to;
+					});
+
+					CHECK_EQ(range.size(), static_cast<size_t>(expected));
+
+					auto previous = from;
+					for (auto& e : range) {
+						CHECK(e.frame >= previous);
+						CHECK(e.frame <= to);
+						previous = e.frame;
+					}
+				}
+			}
+
+			CHECK_EQ(a.sfx_ground_in_range(-1, a.last_frame).size(), a.sfx_ground.size());
+		}
+
+		CHECK(anim.events_in_range(5, 5).empty());
+		CHECK(anim.events_in_range(5, 4).empty());
+	}
+
 	TEST_CASE("ModelScript.load(GOTHIC1)" * doctest::skip()) {
 		// TODO: Stub
 	}
@@ -56,4 +56,44 @@ TEST_SUITE("MorphMesh") {
 	TEST_CASE("MorphMesh.load(GOTHIC2)" * doctest::skip()) {
 		// TODO: Stub
 	}
+
+	TEST_CASE("MorphMesh.evaluate") {
+		auto in = zenkit::Read::from("./samples/morph0.mmb");
+		zenkit::MorphMesh mesh {};
+		mesh.load(in.get());
+
+		auto& anim = mesh.animations[1];
+		std::vector<zenkit::Vec3> positions;
+
+		// Without any animations, the mesh is at rest.
+		mesh.evaluate({}, positions);
+		CHECK_EQ(positions, mesh.morph_positions);
+
+		// The animation plays 10 frames in 400 milliseconds, so frame 1 is reached after 40 milliseconds.
+		mesh.evaluate({{1, 0.04f}}, positions);
+		for (auto i = 0u; i < anim.vertices.size(); ++i) {
+			auto const& base = mesh.morph_positions[anim.vertices[i]];
+			auto const& sample = anim.samples[anim.vertices.size() + i];
+			auto const& p = positions[anim.vertices[i]];
+			CHECK_EQ(p.x, doctest::Approx(base.x + sample.x));
+			CHECK_EQ(p.y, doctest::Approx(base.y + sample.y));
+			CHECK_EQ(p.z, doctest::Approx(base.z + sample.z));
+		}
+
+		CHECK_EQ(positions[0], mesh.morph_positions[0]);
+
+		// Half way between frame 0 and 1 at half the weight.
+		mesh.evaluate({{1, 0.02f, 0.5f}}, positions);
+		auto v = anim.vertices[0];
+		auto expected = mesh.morph_positions[v].x + 0.5f * (anim.samples[0].x + anim.samples[3].x) / 2;
+		CHECK_EQ(positions[v].x, doctest::Approx(expected));
+
+		// Without looping, the last frame is held.
+		mesh.evaluate({{1, 100, 1, false}}, positions);
+		CHECK_EQ(positions[v].x, doctest::Approx(mesh.morph_positions[v].x + anim.samples[27].x));
+
+		// Animations are added up and invalid ones ignored.
+		mesh.evaluate({{1, 0.04f}, {1, 0.04f}, {100, 0}}, positions);
+		CHECK_EQ(positions[v].x, doctest::Approx(mesh.morph_positions[v].x + 2 * anim.samples[3].x));
+	}
 }
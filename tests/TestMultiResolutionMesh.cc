@@ -4,6 +4,12 @@
 #include <zenkit/MultiResolutionMesh.hh>
 #include <zenkit/Stream.hh>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
 static bool compare_triangle(zenkit::MeshTriangle a, zenkit::MeshTriangle b) {
 	return a.wedges[0] == b.wedges[0] && a.wedges[1] == b.wedges[1] && a.wedges[2] == b.wedges[2];
 }
@@ -78,6 +84,247 @@ TEST_SUITE("MultiResolutionMesh") {
 		CHECK_EQ(submesh.wedge_map[31], 0);
 	}
 
+	TEST_CASE("MultiResolutionMesh.load(skip)") {
+		auto in = zenkit::Read::from("./samples/mesh0.mrm");
+		zenkit::MultiResolutionMesh mesh {};
+		mesh.load(in.get(), {true, true});
+
+		CHECK_EQ(mesh.positions.size(), 8);
+		REQUIRE_EQ(mesh.sub_meshes.size(), 1);
+
+		auto const& submesh = mesh.sub_meshes[0];
+		CHECK_EQ(submesh.mat.name, "EVT_TPL_GITTERKAEFIG_01");
+		CHECK_EQ(submesh.triangles.size(), 16);
+		CHECK_EQ(submesh.wedges.size(), 32);
+		CHECK(compare_triangle(submesh.triangles[15], {28, 20, 3}));
+		CHECK(compare_wedge(submesh.wedges[31], {{0, 0, -1}, {-1.50000048, 2.49251938}, 7}));
+
+		CHECK(submesh.triangle_plane_indices.empty());
+		CHECK(submesh.triangle_planes.empty());
+		CHECK(submesh.wedge_map.empty());
+
+		// Without the wedge map, no detail can be removed.
+		CHECK_EQ(mesh.build_lod(0.5f).index_count(), 48);
+
+		// The reader is left at the same position as when loading everything.
+		auto full_in = zenkit::Read::from("./samples/mesh0.mrm");
+		zenkit::MultiResolutionMesh full {};
+		full.load(full_in.get());
+		CHECK_EQ(in->tell(), full_in->tell());
+	}
+
+	TEST_CASE("MultiResolutionMesh.build_render_buffers") {
+		auto in = zenkit::Read::from("./samples/mesh0.mrm");
+		zenkit::MultiResolutionMesh mesh {};
+		mesh.load(in.get());
+
+		auto buffers = mesh.build_render_buffers();
+		CHECK_FALSE(buffers.wide_indices());
+		REQUIRE_EQ(buffers.batches.size(), 1);
+		CHECK_EQ(buffers.batches[0].material, 0);
+		CHECK_EQ(buffers.batches[0].index_offset, 0);
+		CHECK_EQ(buffers.batches[0].index_count, 48);
+		REQUIRE_EQ(buffers.index_count(), 48);
+		CHECK_LE(buffers.vertices.size(), 32);
+
+		// Each index refers to the same vertex data as the wedge it was built from.
+		auto const& submesh = mesh.sub_meshes[0];
+		for (auto i = 0u; i < 48; ++i) {
+			auto const& wedge = submesh.wedges[submesh.triangles[i / 3].wedges[i % 3]];
+			auto const& vertex = buffers.vertices[buffers.indices16[i]];
+			CHECK_EQ(vertex.position, mesh.positions[wedge.index]);
+			CHECK_EQ(vertex.normal, wedge.normal);
+			CHECK_EQ(vertex.texture, wedge.texture);
+		}
+
+		// Reordering for the vertex cache keeps all triangles.
+		auto optimized = mesh.build_render_buffers({true, true});
+		REQUIRE(optimized.wide_indices());
+		REQUIRE_EQ(optimized.index_count(), 48);
+
+		auto triangles = [](auto const& indices, auto const& vertices) {
+			std::vector<std::array<float, 9>> out;
+			for (auto i = 0u; i < indices.size(); i += 3) {
+				std::array<float, 9> t {};
+				for (auto k = 0u; k < 3; ++k) {
+					auto const& p = vertices[indices[i + k]].position;
+					t[k * 3 + 0] = p.x;
+					t[k * 3 + 1] = p.y;
+					t[k * 3 + 2] = p.z;
+				}
+				out.push_back(t);
+			}
+
+			std::sort(out.begin(), out.end());
+			return out;
+		};
+
+		CHECK_EQ(triangles(optimized.indices32, optimized.vertices), triangles(buffers.indices16, buffers.vertices));
+	}
+
+	TEST_CASE("MultiResolutionMesh.build_lod") {
+		auto in = zenkit::Read::from("./samples/mesh0.mrm");
+		zenkit::MultiResolutionMesh mesh {};
+		mesh.load(in.get());
+
+		// Keeping all wedges yields the full-detail mesh.
+		auto full = mesh.build_lod(1);
+		CHECK_EQ(full.index_count(), mesh.build_render_buffers().index_count());
+
+		// Collapsing the wedges of the last two positions drops the triangles which degenerate and moves
+		// the remaining corners onto the kept positions.
+		auto reduced = mesh.build_lod(0.75f);
+		REQUIRE_EQ(reduced.batches.size(), 1);
+		CHECK_EQ(reduced.index_count(), 24);
+
+		for (auto i = 0u; i < reduced.indices16.size(); i += 3) {
+			auto const& a = reduced.vertices[reduced.indices16[i + 0]].position;
+			auto const& b = reduced.vertices[reduced.indices16[i + 1]].position;
+			auto const& c = reduced.vertices[reduced.indices16[i + 2]].position;
+			CHECK_FALSE(a == b);
+			CHECK_FALSE(b == c);
+			CHECK_FALSE(a == c);
+
+			for (auto const& p : {a, b, c}) {
+				CHECK_FALSE(p == mesh.positions[6]);
+				CHECK_FALSE(p == mesh.positions[7]);
+			}
+		}
+
+		// The chain shares the vertex buffer between levels, each of which has its own batches.
+		auto chain = mesh.build_lod_chain(3, 0.75f);
+		REQUIRE_EQ(chain.levels.size(), 3);
+		CHECK_EQ(chain.levels[0].ratio, 1);
+		CHECK_EQ(chain.levels[1].ratio, 0.75f);
+
+		std::uint32_t previous = 48;
+		for (auto const& level : chain.levels) {
+			std::uint32_t count = 0;
+			for (auto i = 0u; i < level.batch_count; ++i) {
+				count += chain.buffers.batches[level.batch_offset + i].index_count;
+			}
+
+			CHECK_LE(count, previous);
+			previous = count;
+		}
+
+		REQUIRE_EQ(chain.levels[1].batch_count, 1);
+		CHECK_EQ(chain.buffers.batches[chain.levels[0].batch_offset].index_count, 48);
+		CHECK_EQ(chain.buffers.batches[chain.levels[1].batch_offset].index_count, 24);
+		CHECK_EQ(chain.buffers.vertices.size(), full.vertices.size());
+	}
+
+	TEST_CASE("MultiResolutionMesh.load(compact)") {
+		auto in = zenkit::Read::from("./samples/mesh0.mrm");
+		zenkit::MultiResolutionMesh full {};
+		full.load(in.get());
+
+		in = zenkit::Read::from("./samples/mesh0.mrm");
+		zenkit::MultiResolutionMesh mesh {};
+		mesh.load(in.get(), {false, false, true});
+
+		CHECK(mesh.is_compact());
+		CHECK(mesh.positions.empty());
+		CHECK(mesh.normals.empty());
+		CHECK_EQ(mesh.quantized_positions.size(), full.positions.size());
+		CHECK_EQ(mesh.quantized_normals.size(), full.normals.size());
+		REQUIRE_EQ(mesh.sub_meshes.size(), full.sub_meshes.size());
+		CHECK(mesh.sub_meshes[0].wedges.empty());
+		CHECK_EQ(mesh.sub_meshes[0].quantized_wedges.size(), full.sub_meshes[0].wedges.size());
+
+		auto extent = full.bbox.max.x - full.bbox.min.x;
+		for (auto i = 0u; i < full.positions.size(); ++i) {
+			auto p = mesh.quantized_positions[i].decode(mesh.quantized_position_min, mesh.quantized_position_scale);
+			CHECK(std::abs(p.x - full.positions[i].x) <= extent / 65535.0f);
+			CHECK(std::abs(p.y - full.positions[i].y) <= extent / 65535.0f);
+			CHECK(std::abs(p.z - full.positions[i].z) <= extent / 65535.0f);
+		}
+
+		// Compact meshes build the same buffers, up to the precision of the quantized values.
+		auto a = full.build_render_buffers();
+		auto b = mesh.build_render_buffers();
+		CHECK_EQ(b.index_count(), a.index_count());
+		REQUIRE_EQ(b.vertices.size(), a.vertices.size());
+		for (auto i = 0u; i < a.vertices.size(); ++i) {
+			CHECK_EQ(b.vertices[i].texture.x, doctest::Approx(a.vertices[i].texture.x).epsilon(0.001));
+			CHECK_EQ(b.vertices[i].texture.y, doctest::Approx(a.vertices[i].texture.y).epsilon(0.001));
+			CHECK_EQ(b.vertices[i].normal.z, doctest::Approx(a.vertices[i].normal.z).epsilon(0.001));
+		}
+
+		mesh.decode();
+		CHECK_FALSE(mesh.is_compact());
+		CHECK_EQ(mesh.positions.size(), full.positions.size());
+		CHECK_EQ(mesh.sub_meshes[0].wedges.size(), full.sub_meshes[0].wedges.size());
+		CHECK_EQ(mesh.sub_meshes[0].wedges[0].index, full.sub_meshes[0].wedges[0].index);
+	}
+
+	TEST_CASE("MultiResolutionMesh.load(materials)") {
+		zenkit::MaterialRegistry registry {};
+		zenkit::MultiResolutionMeshLoadOptions options {};
+		options.materials = &registry;
+
+		zenkit::MultiResolutionMesh a {}, b {};
+		a.load(zenkit::Read::from("./samples/mesh0.mrm").get(), options);
+		b.load(zenkit::Read::from("./samples/mesh0.mrm").get(), options);
+
+		CHECK(a.materials.empty());
+		CHECK(a.sub_meshes[0].mat.name.empty());
+		REQUIRE_EQ(a.material_handles.size(), 1);
+		CHECK_EQ(b.material_handles, a.material_handles);
+		CHECK_EQ(registry.size(), 1);
+
+		auto material = registry.get(a.material_handles[0]);
+		REQUIRE(material != nullptr);
+		CHECK_EQ(material->name, "EVT_TPL_GITTERKAEFIG_01");
+		CHECK_EQ(registry.get(1), nullptr);
+
+		// Materials are compared by all of their fields.
+		auto changed = *material;
+		CHECK_EQ(registry.find(changed), a.material_handles[0]);
+		changed.wave_grid_size = 1;
+		CHECK_FALSE(registry.find(changed).has_value());
+		CHECK_EQ(registry.intern(changed), 1);
+		CHECK_EQ(registry.size(), 2);
+
+		// The mesh does not have its materials, so it can't be saved.
+		std::vector<std::byte> data;
+		CHECK_THROWS_AS(a.save(zenkit::Write::to(&data).get(), zenkit::GameVersion::GOTHIC_1), std::logic_error);
+	}
+
+	TEST_CASE("MultiResolutionMesh.quantize") {
+		CHECK_EQ(sizeof(zenkit::QuantizedPosition), 6);
+		CHECK_EQ(sizeof(zenkit::QuantizedNormal), 4);
+		CHECK_EQ(sizeof(zenkit::QuantizedMeshWedge), 10);
+
+		std::array<zenkit::Vec3, 6> normals {
+		    zenkit::Vec3 {0, 0, 1},
+		    zenkit::Vec3 {0, 0, -1},
+		    zenkit::Vec3 {1, 0, 0},
+		    zenkit::Vec3 {0, -1, 0},
+		    zenkit::Vec3 {0.48f, -0.6f, -0.64f},
+		    zenkit::Vec3 {-0.36f, 0.48f, 0.8f},
+		};
+
+		for (auto& n : normals) {
+			auto d = zenkit::QuantizedNormal::encode(n).decode();
+			CHECK_EQ(d.x, doctest::Approx(n.x).epsilon(0.0001));
+			CHECK_EQ(d.y, doctest::Approx(n.y).epsilon(0.0001));
+			CHECK_EQ(d.z, doctest::Approx(n.z).epsilon(0.0001));
+		}
+
+		// Texture coordinates are stored as half-precision floats.
+		zenkit::MeshWedge wedge {zenkit::Vec3 {0, 1, 0}, zenkit::Vec2 {0.5f, -2.25f}, 7};
+		auto q = zenkit::QuantizedMeshWedge::encode(wedge);
+		CHECK_EQ(q.texture[0], 0x3800);
+		CHECK_EQ(q.texture[1], 0xC080);
+		CHECK_EQ(q.decode().texture, wedge.texture);
+		CHECK_EQ(q.decode().index, 7);
+
+		auto tiny = zenkit::QuantizedMeshWedge::encode({{}, zenkit::Vec2 {1e-6f, 70000.0f}, 0});
+		CHECK_EQ(tiny.texture[0], 0x0011); // Subnormal
+		CHECK_EQ(tiny.texture[1], 0x7C00); // Infinity
+	}
+
 	TEST_CASE("MultiResolutionMesh.load(GOTHIC1)" * doctest::skip()) {
 		// TODO: Stub
 	}
@@ -3,6 +3,10 @@
 #include <doctest/doctest.h>
 #include <zenkit/SaveGame.hh>
 #include <zenkit/World.hh>
+#include <zenkit/vobs/Misc.hh>
+#include <zenkit/world/WorldPatch.hh>
+
+#include <filesystem>
 
 TEST_SUITE("SaveGame") {
 	TEST_CASE("SaveGame.load(GOTHIC1)") {
@@ -103,4 +107,110 @@ TEST_SUITE("SaveGame") {
 		auto wld = save.load_world();
 		// TODO: Add more checks
 	}
+
+	TEST_CASE("SaveGame.load(options)") {
+		zenkit::SaveGame save {zenkit::GameVersion::GOTHIC_2};
+		save.load("./samples/G2/SaveFast", {true, true});
+
+		CHECK_EQ(save.metadata.title, "inminevalley");
+		CHECK(save.state.symbols.empty());
+		CHECK_FALSE(save.thumbnail);
+		CHECK_EQ(save.worlds(), std::vector<std::string> {"NEWWORLD", "OLDWORLD"});
+
+		auto full = save.load_world("oldworld.zen");
+		REQUIRE_NE(full, nullptr);
+		REQUIRE_FALSE(full->world_vobs.empty());
+		REQUIRE_FALSE(full->npcs.empty());
+
+		zenkit::WorldLoadOptions npcs_only {};
+		npcs_only.skip_vobs = true;
+
+		auto npcs = save.load_world("OldWorld", npcs_only);
+		REQUIRE_NE(npcs, nullptr);
+		CHECK(npcs->world_vobs.empty());
+		CHECK_EQ(npcs->npcs.size(), full->npcs.size());
+		CHECK_EQ(npcs->npc_spawns.size(), full->npc_spawns.size());
+
+		zenkit::WorldLoadOptions vobs_only {};
+		vobs_only.skip_npcs = true;
+
+		auto vobs = save.load_world("OLDWORLD", vobs_only);
+		REQUIRE_NE(vobs, nullptr);
+		CHECK_EQ(vobs->world_vobs.size(), full->world_vobs.size());
+		CHECK(vobs->npcs.empty());
+
+		CHECK_EQ(save.load_world("NOWORLD", vobs_only), nullptr);
+	}
+
+	TEST_CASE("SaveGame.save_async") {
+		zenkit::SaveGame save {zenkit::GameVersion::GOTHIC_2};
+		save.load("./samples/G2/SaveFast");
+
+		std::shared_ptr<zenkit::World const> world = save.load_world("OLDWORLD");
+		REQUIRE_NE(world, nullptr);
+
+		auto path = std::filesystem::temp_directory_path() / "zenkit-test-save-async";
+		auto done = save.save_async(path, world, "OLDWORLD");
+
+		// The save-game may be changed while it is being written.
+		save.metadata.title = "changed";
+		done.get();
+
+		CHECK_EQ(save.worlds(), std::vector<std::string> {"NEWWORLD", "OLDWORLD"});
+
+		zenkit::SaveGame loaded {zenkit::GameVersion::GOTHIC_2};
+		loaded.load(path);
+		CHECK_EQ(loaded.metadata.title, "inminevalley");
+		CHECK_EQ(loaded.state.symbols.size(), save.state.symbols.size());
+		CHECK_EQ(loaded.worlds(), save.worlds());
+
+		auto reloaded = loaded.load_world("OLDWORLD");
+		REQUIRE_NE(reloaded, nullptr);
+		CHECK_EQ(reloaded->world_vobs.size(), world->world_vobs.size());
+		CHECK_EQ(reloaded->npcs.size(), world->npcs.size());
+
+		std::filesystem::remove_all(path);
+	}
+
+	TEST_CASE("SaveGame.save_delta") {
+		zenkit::SaveGame save {zenkit::GameVersion::GOTHIC_2};
+		save.load("./samples/G2/SaveFast");
+
+		auto base = save.load_world("OLDWORLD");
+		auto world = save.load_world("OLDWORLD");
+		REQUIRE_NE(world, nullptr);
+		REQUIRE_GT(world->npcs.size(), 1);
+		REQUIRE_FALSE(world->world_vobs.empty());
+
+		world->npcs[0]->position.x += 100;
+		world->npcs.pop_back();
+		world->world_vobs[0]->show_visual = !world->world_vobs[0]->show_visual;
+
+		auto path = std::filesystem::temp_directory_path() / "zenkit-test-save-delta";
+		save.save_delta(path, *base, *world, "OLDWORLD");
+
+		// Only the changes are stored.
+		CHECK_LT(std::filesystem::file_size(path / "OLDWORLD.DELTA"),
+		         std::filesystem::file_size("./samples/G2/SaveFast/OLDWORLD.SAV") / 10);
+		CHECK_FALSE(std::filesystem::exists(path / "OLDWORLD.SAV"));
+		CHECK_EQ(save.worlds(), std::vector<std::string> {"NEWWORLD", "OLDWORLD"});
+		CHECK_EQ(save.load_world("OLDWORLD"), nullptr);
+
+		// The delta is applied to the same base world again.
+		zenkit::SaveGame loaded {zenkit::GameVersion::GOTHIC_2};
+		loaded.load(path);
+
+		zenkit::SaveGame original {zenkit::GameVersion::GOTHIC_2};
+		original.load("./samples/G2/SaveFast", {true, true});
+
+		auto restored = original.load_world("OLDWORLD");
+		CHECK_FALSE(loaded.load_world_delta("NEWWORLD", *restored));
+		REQUIRE(loaded.load_world_delta("oldworld", *restored));
+		CHECK(zenkit::WorldPatch::diff(*world, *restored, zenkit::GameVersion::GOTHIC_2, true).empty());
+		CHECK_EQ(restored->npcs.size(), world->npcs.size());
+		CHECK_EQ(restored->npcs[0]->position, world->npcs[0]->position);
+		CHECK_EQ(restored->npc_spawns.size(), world->npc_spawns.size());
+
+		std::filesystem::remove_all(path);
+	}
 }
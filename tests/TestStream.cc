@@ -1,9 +1,14 @@
 // Copyright © 2023 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
+#include "zenkit/Error.hh"
 #include "zenkit/Stream.hh"
 
 #include <doctest/doctest.h>
 
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
 template <typename... Args>
 static std::vector<std::byte> bytes(Args... bytes) {
 	return std::vector<std::byte> {static_cast<std::byte>(bytes)...};
@@ -141,6 +146,149 @@ TEST_SUITE("Read") {
 		CHECK(r->eof());
 		CHECK(r->read_line(true).empty());
 	}
+
+	TEST_CASE("Read.read_line_view") {
+		std::string_view data {"Hi\r\n \tnext\0end\n \0", 17};
+
+		std::string buffer;
+
+		auto r = zenkit::Read::from(reinterpret_cast<std::byte const*>(data.data()), data.size());
+		CHECK_EQ(r->read_line_view(true, buffer), "Hi");
+		CHECK_EQ(r->tell(), 6);
+		CHECK_EQ(r->read_line_view(true, buffer), "next");
+		CHECK_EQ(r->tell(), 11);
+		CHECK_EQ(r->read_line_view(true, buffer), "end");
+		CHECK(r->eof());
+		CHECK(buffer.empty());
+
+		// Streams which are not memory-backed must produce the same result.
+		std::stringstream stream {std::string {data}};
+		auto s = zenkit::Read::from(&stream);
+		CHECK_EQ(s->read_line_view(true, buffer), "Hi");
+		CHECK_EQ(s->tell(), 6);
+		CHECK_EQ(s->read_line_view(true, buffer), "next");
+		CHECK_EQ(s->tell(), 11);
+		CHECK_EQ(s->read_line_view(true, buffer), "end");
+		CHECK_EQ(buffer, "end");
+	}
+
+	TEST_CASE("Read.read_ushort_array") {
+		auto r = zenkit::Read::from(bytes(0x01, 0x00, 0xFF, 0xFF, 0x02));
+
+		uint16_t values[3] {0xAAAA, 0xAAAA, 0xAAAA};
+		r->read_ushort_array(values, 3);
+		CHECK_EQ(values[0], 1);
+		CHECK_EQ(values[1], 0xFFFF);
+		CHECK_EQ(values[2], 0x0002);
+		CHECK(r->eof());
+	}
+
+	TEST_CASE("Read.read_vec3_array") {
+		auto r = zenkit::Read::from(bytes(0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x40, 0x40));
+
+		zenkit::Vec3 values[2] {zenkit::Vec3 {5}, zenkit::Vec3 {5}};
+		r->read_vec3_array(values, 2);
+		CHECK_EQ(values[0], zenkit::Vec3 {1, 2, 3});
+		CHECK_EQ(values[1], zenkit::Vec3 {0, 0, 0});
+	}
+
+	TEST_CASE("Read.from(istream,buffered)") {
+		std::stringstream stream {"abcdefghij"};
+		auto r = zenkit::Read::from(&stream, 4);
+
+		CHECK_EQ(r->read_char(), 'a');
+		CHECK_EQ(r->read_string(5), "bcdef");
+		CHECK_EQ(r->tell(), 6);
+
+		r->seek(-2, zenkit::Whence::CUR);
+		CHECK_EQ(r->read_char(), 'e');
+
+		r->seek(-1, zenkit::Whence::END);
+		CHECK_EQ(r->read_char(), 'j');
+		CHECK_EQ(r->read_char(), '\0');
+		CHECK(r->eof());
+
+		r->seek(1, zenkit::Whence::BEG);
+		CHECK_FALSE(r->eof());
+		CHECK_EQ(r->read_string(9), "bcdefghij");
+	}
+
+	TEST_CASE("Read.slice") {
+		auto r = zenkit::Read::from(bytes('a', 'b', 'c', 'd', 'e'));
+		CHECK_EQ(r->read_char(), 'a');
+
+		auto slice = r->slice(3);
+		CHECK_EQ(r->tell(), 4);
+		CHECK_EQ(slice->tell(), 0);
+		CHECK_EQ(slice->read_string(3), "bcd");
+		CHECK(slice->eof());
+		CHECK_EQ(slice->read_char(), '\0');
+
+		slice->seek(-1, zenkit::Whence::END);
+		CHECK_EQ(slice->read_char(), 'd');
+
+		// Slices are clamped to the parent stream.
+		auto tail = r->slice(10);
+		CHECK_EQ(tail->read_string(2), std::string {"e\0", 2});
+		CHECK(r->eof());
+	}
+
+	TEST_CASE("Read.prefetch") {
+		auto r = zenkit::Read::from("./samples/basic.bin");
+		auto first = r->read_ubyte();
+
+		// These are only hints and must not change the observable state of the stream.
+		r->prefetch(0, 1024 * 1024);
+		r->prefetch(1024 * 1024, 16);
+		r->advise_sequential();
+
+		CHECK_EQ(r->tell(), 1);
+		r->seek(0, zenkit::Whence::BEG);
+		CHECK_EQ(r->read_ubyte(), first);
+	}
+
+	TEST_CASE("Read.from_many") {
+		std::vector<std::filesystem::path> paths {"./samples/basic.bin", "./samples/missing.bin", "./samples/empty.txt"};
+		std::vector<int> seen(paths.size(), 0);
+
+		zenkit::Read::from_many(
+		    paths,
+		    [&](size_t i, std::unique_ptr<zenkit::Read> r) {
+			    seen[i] += 1;
+
+			    if (i == 1) {
+				    CHECK_EQ(r, nullptr);
+			    } else {
+				    CHECK_NE(r, nullptr);
+			    }
+
+			    if (i == 2) CHECK(r->eof());
+		    },
+		    2);
+
+		CHECK_EQ(seen, std::vector<int> {1, 1, 1});
+	}
+
+	TEST_CASE("Read.as_contiguous") {
+		auto r = zenkit::Read::from(bytes(0xFF, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0xFF));
+		CHECK_EQ(r->read_ubyte(), 0xFF);
+
+		auto span = r->as_contiguous();
+		CHECK_NE(span.data(), nullptr);
+		CHECK_EQ(span.size(), 7);
+		CHECK_EQ(span.read_ushort(), 1);
+		CHECK_EQ(span.read_uint(), 2);
+		CHECK_EQ(span.remaining(), 1);
+
+		// Reading past the end yields zero and does not overrun the span.
+		CHECK_EQ(span.read_uint(), 0);
+		CHECK(span.eof());
+
+		// The span does not advance the stream itself.
+		CHECK_EQ(r->tell(), 1);
+		r->seek(static_cast<long>(span.tell()), zenkit::Whence::CUR);
+		CHECK(r->eof());
+	}
 }
 
 TEST_SUITE("Write") {
@@ -273,6 +421,102 @@ TEST_SUITE("Write") {
 		CHECK_EQ(BUF[5], std::byte {'!'});
 	}
 
+	TEST_CASE("Write.to(ostream,buffered)") {
+		enum class TestChunk : uint16_t { A = 0x0102 };
+
+		std::stringstream stream {};
+		auto w = zenkit::Write::to(&stream, 4);
+
+		w->write_char('x');
+		zenkit::proto::write_chunk(w.get(), TestChunk::A, [](zenkit::Write* c) { c->write_string("abcdef"); });
+		w->write_char('y');
+		CHECK_EQ(w->tell(), 14);
+
+		w->flush();
+		CHECK_EQ(stream.str(), std::string {"x\x02\x01\x06\0\0\0abcdefy", 14});
+	}
+
+	TEST_CASE("Write.to_mmap") {
+		auto path = std::filesystem::temp_directory_path() / "zenkit-test-write-mmap.bin";
+
+		{
+			auto w = zenkit::Write::to_mmap(path, 2);
+			w->write_uint(0xDEADBEEF);
+			w->write_string("Hello!");
+			w->seek(0, zenkit::Whence::BEG);
+			w->write_ubyte(0xAA);
+		}
+
+		{
+			auto r = zenkit::Read::from(path);
+			CHECK_EQ(r->read_uint(), 0xDEADBEAA);
+			CHECK_EQ(r->read_string(6), "Hello!");
+			CHECK(r->eof());
+		}
+
+		std::filesystem::remove(path);
+	}
+
+	TEST_CASE("Write.to_compressed") {
+		std::vector<std::byte> data {};
+		for (uint32_t i = 0; i < 5000; ++i) {
+			// Alternate between highly repetitive and noisy sections, so both frame types are produced.
+			auto v = (i / 1000) % 2 == 0 ? i % 7 : (i * 2654435761U) >> 13;
+			data.push_back(static_cast<std::byte>(v));
+		}
+
+		std::vector<std::byte> packed {};
+		{
+			auto sink = zenkit::Write::to(&packed);
+			auto w = zenkit::Write::to_compressed(sink.get(), 1024);
+			w->write(data.data(), 10);
+
+			// Seeking within the current frame is allowed.
+			w->seek(0, zenkit::Whence::BEG);
+			w->write(data.data(), 4);
+			w->seek(0, zenkit::Whence::END);
+			w->write(data.data() + 10, data.size() - 10);
+		}
+
+		CHECK_LT(packed.size(), data.size());
+
+		auto r = zenkit::Read::from_compressed(zenkit::Read::from(&packed));
+		std::vector<std::byte> out(data.size());
+		CHECK_EQ(r->read(out.data(), out.size()), data.size());
+		CHECK(r->eof());
+		CHECK(out == data);
+
+		r->seek(3070, zenkit::Whence::BEG);
+		CHECK_EQ(r->read_ubyte(), static_cast<uint8_t>(data[3070]));
+		r->seek(-1, zenkit::Whence::END);
+		CHECK_EQ(r->read_ubyte(), static_cast<uint8_t>(data.back()));
+		r->seek(10, zenkit::Whence::BEG);
+		CHECK_EQ(r->read_ubyte(), static_cast<uint8_t>(data[10]));
+
+		// Counts in the trailer which don't fit into the stream are rejected before anything is allocated for them.
+		auto corrupt = packed;
+		uint32_t frame_count = 0x10000000;
+		std::memcpy(corrupt.data() + corrupt.size() - 8, &frame_count, sizeof frame_count);
+		CHECK_THROWS_AS(static_cast<void>(zenkit::Read::from_compressed(zenkit::Read::from(&corrupt))),
+		                zenkit::ParserError);
+
+		corrupt = packed;
+		uint64_t size = 0x100000000000;
+		std::memcpy(corrupt.data() + corrupt.size() - 16, &size, sizeof size);
+		CHECK_THROWS_AS(static_cast<void>(zenkit::Read::from_compressed(zenkit::Read::from(&corrupt))),
+		                zenkit::ParserError);
+
+		corrupt.resize(10);
+		CHECK_THROWS_AS(static_cast<void>(zenkit::Read::from_compressed(zenkit::Read::from(&corrupt))),
+		                zenkit::ParserError);
+
+		packed[packed.size() - 1] = std::byte {0};
+		CHECK_THROWS(static_cast<void>(zenkit::Read::from_compressed(zenkit::Read::from(&packed))));
+
+		auto sink = zenkit::Write::to(&packed);
+		CHECK_THROWS_AS(static_cast<void>(zenkit::Write::to_compressed(sink.get(), 0)), std::invalid_argument);
+	}
+
 	TEST_CASE("Write.write_line") {
 		auto w = zenkit::Write::to(&BUF);
 		BUF.clear();
@@ -3,6 +3,49 @@
 #include <doctest/doctest.h>
 #include <zenkit/Stream.hh>
 #include <zenkit/Texture.hh>
+#include <zenkit/Vfs.hh>
+#include <zenkit/addon/texcvt.hh>
+
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+static zenkit::Texture make_texture(zenkit::TextureFormat format,
+                                    std::uint32_t width,
+                                    std::uint32_t height,
+                                    std::vector<std::uint8_t> const& pixels,
+                                    std::vector<zenkit::ColorARGB> const& palette = {}) {
+	std::vector<std::byte> bytes;
+	auto w = zenkit::Write::to(&bytes);
+	w->write_string("ZTEX");
+	w->write_uint(0);
+	w->write_uint(static_cast<std::uint32_t>(format));
+	w->write_uint(width);
+	w->write_uint(height);
+	w->write_uint(1);
+	w->write_uint(width);
+	w->write_uint(height);
+	w->write_uint(0);
+
+	if (format == zenkit::TextureFormat::P8) {
+		for (auto i = 0u; i < zenkit::ZTEX_PALETTE_ENTRIES; ++i) {
+			auto c = i < palette.size() ? palette[i] : zenkit::ColorARGB {};
+			w->write_ubyte(c.b);
+			w->write_ubyte(c.g);
+			w->write_ubyte(c.r);
+			w->write_ubyte(c.a);
+		}
+	}
+
+	w->write(pixels.data(), pixels.size());
+
+	zenkit::Texture texture {};
+	auto r = zenkit::Read::from(&bytes);
+	texture.load(r.get());
+	return texture;
+}
 
 TEST_SUITE("Texture") {
 	TEST_CASE("Texture.load(GOTHIC?)") {
@@ -28,6 +71,329 @@ TEST_SUITE("Texture") {
 		CHECK_EQ(texture.format(), zenkit::TextureFormat::DXT1);
 	}
 
+	TEST_CASE("Texture.load(lazy)") {
+		auto in = zenkit::Read::from("./samples/erz.tex");
+		zenkit::Texture eager {};
+		eager.load(in.get());
+
+		in->seek(0, zenkit::Whence::END);
+		std::vector<std::byte> bytes(in->tell());
+		in->seek(0, zenkit::Whence::BEG);
+		in->read(bytes.data(), bytes.size());
+
+		auto r = zenkit::Read::from(&bytes);
+		zenkit::Texture texture {};
+		texture.load(r.get(), {true});
+		CHECK(r->eof());
+		CHECK_EQ(texture.mipmaps(), 5);
+
+		for (auto level = 0u; level < texture.mipmaps(); ++level) {
+			auto view = texture.data_view(level);
+			CHECK_GE(view.data(), bytes.data());
+			CHECK_LE(view.data() + view.size(), bytes.data() + bytes.size());
+			CHECK_EQ(texture.data(level), eager.data(level));
+		}
+
+		// Levels the texture doesn't have are rejected before anything is loaded.
+		CHECK_THROWS_AS((void) texture.data(texture.mipmaps()), std::out_of_range);
+
+		auto copy = texture;
+		CHECK_EQ(copy.data(4), eager.data(4));
+		CHECK_EQ(copy.as_rgba8(0), eager.as_rgba8(0));
+	}
+
+	TEST_CASE("Texture.as_rgba8") {
+		// 19 pixels, so that both the vectorized and the scalar conversion are used.
+		static constexpr std::uint32_t WIDTH = 19;
+
+		auto check = [](zenkit::TextureFormat format, std::uint32_t bpp, auto&& expect) {
+			std::vector<std::uint8_t> pixels(WIDTH * bpp);
+			for (auto i = 0u; i < pixels.size(); ++i) {
+				pixels[i] = static_cast<std::uint8_t>(i * 37 + 11);
+			}
+
+			auto texture = make_texture(format, WIDTH, 1, pixels);
+			auto rgba = texture.as_rgba8();
+			REQUIRE_EQ(rgba.size(), WIDTH * 4);
+
+			for (auto i = 0u; i < WIDTH; ++i) {
+				std::uint8_t const* px = pixels.data() + i * bpp;
+				std::uint8_t expected[4];
+				expect(px, expected);
+
+				CHECK_EQ(rgba[i * 4 + 0], expected[0]);
+				CHECK_EQ(rgba[i * 4 + 1], expected[1]);
+				CHECK_EQ(rgba[i * 4 + 2], expected[2]);
+				CHECK_EQ(rgba[i * 4 + 3], expected[3]);
+			}
+		};
+
+		auto set = [](std::uint8_t* out, int r, int g, int b, int a) {
+			out[0] = static_cast<std::uint8_t>(r);
+			out[1] = static_cast<std::uint8_t>(g);
+			out[2] = static_cast<std::uint8_t>(b);
+			out[3] = static_cast<std::uint8_t>(a);
+		};
+
+		using zenkit::TextureFormat;
+		check(TextureFormat::R8G8B8A8, 4, [&](auto p, auto o) { set(o, p[0], p[1], p[2], p[3]); });
+		check(TextureFormat::B8G8R8A8, 4, [&](auto p, auto o) { set(o, p[2], p[1], p[0], p[3]); });
+		check(TextureFormat::A8B8G8R8, 4, [&](auto p, auto o) { set(o, p[3], p[2], p[1], p[0]); });
+		check(TextureFormat::A8R8G8B8, 4, [&](auto p, auto o) { set(o, p[1], p[2], p[3], p[0]); });
+		check(TextureFormat::B8G8R8, 3, [&](auto p, auto o) { set(o, p[2], p[1], p[0], 0xFF); });
+		check(TextureFormat::R8G8B8, 3, [&](auto p, auto o) { set(o, p[0], p[1], p[2], 0xFF); });
+
+		check(TextureFormat::R5G6B5, 2, [&](auto p, auto o) {
+			auto v = p[0] | p[1] << 8;
+			set(o, (v >> 11 & 31) * 255 / 31, (v >> 5 & 63) * 255 / 63, (v & 31) * 255 / 31, 0xFF);
+		});
+		check(TextureFormat::A1R5G5B5, 2, [&](auto p, auto o) {
+			auto v = p[0] | p[1] << 8;
+			set(o, (v >> 10 & 31) * 255 / 31, (v >> 5 & 31) * 255 / 31, (v & 31) * 255 / 31, v >> 15 ? 0xFF : 0);
+		});
+		check(TextureFormat::A4R4G4B4, 2, [&](auto p, auto o) {
+			set(o, (p[1] & 15) * 17, (p[0] >> 4) * 17, (p[0] & 15) * 17, (p[1] >> 4) * 17);
+		});
+
+		// Full intensity maps to 255 for all channel widths.
+		auto white = make_texture(TextureFormat::R5G6B5, 1, 1, {0xFF, 0xFF}).as_rgba8();
+		CHECK_EQ(white, std::vector<std::uint8_t> {0xFF, 0xFF, 0xFF, 0xFF});
+	}
+
+	TEST_CASE("Texture.as_rgba8_into") {
+		std::vector<std::uint8_t> pixels {0, 1, 2, 1};
+		auto texture = make_texture(zenkit::TextureFormat::P8,
+		                            2,
+		                            2,
+		                            pixels,
+		                            {zenkit::ColorARGB {1, 2, 3, 4}, zenkit::ColorARGB {5, 6, 7, 8}});
+
+		std::vector<std::uint8_t> buffer(20, 0xAA);
+		texture.as_rgba8_into(buffer.data(), buffer.size());
+
+		std::vector<std::uint8_t> expected {2, 3, 4, 1, 6, 7, 8, 5, 0, 0, 0, 0, 6, 7, 8, 5, 0xAA, 0xAA, 0xAA, 0xAA};
+		CHECK_EQ(buffer, expected);
+		CHECK_EQ(texture.as_rgba8(), std::vector<std::uint8_t> {expected.begin(), expected.begin() + 16});
+
+		CHECK_THROWS_AS(texture.as_rgba8_into(buffer.data(), 15), zenkit::InvalidMipmapSize);
+	}
+
+	TEST_CASE("Texture.as_rgba8(P8)") {
+		std::vector<zenkit::ColorARGB> palette;
+		for (auto i = 0u; i < zenkit::ZTEX_PALETTE_ENTRIES; ++i) {
+			auto c = static_cast<std::uint8_t>(i);
+			palette.push_back({c, static_cast<std::uint8_t>(~c), static_cast<std::uint8_t>(c * 3), 7});
+		}
+
+		// Enough pixels to cover both the vectorized and the scalar lookup.
+		std::vector<std::uint8_t> pixels(13 * 3);
+		for (auto i = 0u; i < pixels.size(); ++i) {
+			pixels[i] = static_cast<std::uint8_t>(255 - i * 7);
+		}
+
+		auto texture = make_texture(zenkit::TextureFormat::P8, 13, 3, pixels, palette);
+		auto lut = texture.palette_rgba8();
+		CHECK_EQ(lut[4 * 2 + 0], palette[2].r);
+		CHECK_EQ(lut[4 * 2 + 1], palette[2].g);
+		CHECK_EQ(lut[4 * 2 + 2], palette[2].b);
+		CHECK_EQ(lut[4 * 2 + 3], palette[2].a);
+
+		// The index data is kept as-is.
+		auto view = texture.data_view();
+		REQUIRE_EQ(view.size(), pixels.size());
+		CHECK_EQ(std::memcmp(view.data(), pixels.data(), pixels.size()), 0);
+
+		auto rgba = texture.as_rgba8();
+		REQUIRE_EQ(rgba.size(), pixels.size() * 4);
+		for (auto i = 0u; i < pixels.size(); ++i) {
+			CHECK_EQ(std::memcmp(rgba.data() + i * 4, lut.data() + pixels[i] * 4, 4), 0);
+		}
+	}
+
+	TEST_CASE("Texture.as_rgba8(DXT)") {
+		auto pixel = [](std::vector<std::uint8_t> const& rgba, std::uint32_t i) {
+			return std::vector<std::uint8_t> {rgba.begin() + i * 4, rgba.begin() + i * 4 + 4};
+		};
+
+		using Pixel = std::vector<std::uint8_t>;
+
+		// Four colors, red to blue.
+		auto rgba = make_texture(zenkit::TextureFormat::DXT1, 4, 4, {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0}).as_rgba8();
+		CHECK_EQ(pixel(rgba, 0), Pixel {255, 0, 0, 255});
+		CHECK_EQ(pixel(rgba, 1), Pixel {0, 0, 255, 255});
+		CHECK_EQ(pixel(rgba, 2), Pixel {170, 0, 85, 255});
+		CHECK_EQ(pixel(rgba, 3), Pixel {85, 0, 170, 255});
+		CHECK_EQ(pixel(rgba, 15), Pixel {255, 0, 0, 255});
+
+		// Three colors and transparent black.
+		rgba = make_texture(zenkit::TextureFormat::DXT1, 4, 4, {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0, 0, 0}).as_rgba8();
+		CHECK_EQ(pixel(rgba, 2), Pixel {127, 0, 127, 255});
+		CHECK_EQ(pixel(rgba, 3), Pixel {0, 0, 0, 0});
+
+		std::vector<std::uint8_t> color {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0};
+
+		std::vector<std::uint8_t> block {0x1F, 0, 0, 0, 0, 0, 0, 0};
+		block.insert(block.end(), color.begin(), color.end());
+		rgba = make_texture(zenkit::TextureFormat::DXT3, 4, 4, block).as_rgba8();
+		CHECK_EQ(pixel(rgba, 0), Pixel {255, 0, 0, 0xFF});
+		CHECK_EQ(pixel(rgba, 1), Pixel {0, 0, 255, 0x11});
+		CHECK_EQ(pixel(rgba, 2), Pixel {170, 0, 85, 0});
+
+		block = {255, 0, 0x88, 0x0E, 0, 0, 0, 0};
+		block.insert(block.end(), color.begin(), color.end());
+		rgba = make_texture(zenkit::TextureFormat::DXT5, 4, 4, block).as_rgba8();
+		CHECK_EQ(pixel(rgba, 0), Pixel {255, 0, 0, 255});
+		CHECK_EQ(pixel(rgba, 1), Pixel {0, 0, 255, 0});
+		CHECK_EQ(pixel(rgba, 2), Pixel {170, 0, 85, 218});
+		CHECK_EQ(pixel(rgba, 3), Pixel {85, 0, 170, 36});
+
+		block = {0, 255, 0x88, 0x0E, 0, 0, 0, 0};
+		block.insert(block.end(), color.begin(), color.end());
+		rgba = make_texture(zenkit::TextureFormat::DXT5, 4, 4, block).as_rgba8();
+		CHECK_EQ(pixel(rgba, 1), Pixel {0, 0, 255, 255});
+		CHECK_EQ(pixel(rgba, 2), Pixel {170, 0, 85, 51});
+		CHECK_EQ(pixel(rgba, 3), Pixel {85, 0, 170, 255});
+	}
+
+	TEST_CASE("TextureBuilder.build(DXT)") {
+		// Large enough to be compressed on multiple threads.
+		std::vector<std::uint8_t> rgba(128 * 64 * 4);
+		for (auto i = 0u; i < rgba.size(); i += 4) {
+			rgba[i + 0] = 255;
+			rgba[i + 1] = 0;
+			rgba[i + 2] = 255;
+			rgba[i + 3] = 255;
+		}
+
+		zenkit::TextureBuilder builder {128, 64};
+		builder.add_mipmap(rgba, zenkit::TextureFormat::R8G8B8A8);
+
+		auto texture = builder.build(zenkit::TextureFormat::DXT1, {zenkit::TextureCompressionQuality::FAST, 2});
+		CHECK_EQ(texture.format(), zenkit::TextureFormat::DXT1);
+		CHECK_EQ(texture.data().size(), 128 * 64 / 2);
+		CHECK_EQ(texture.as_rgba8(), rgba);
+	}
+
+	TEST_CASE("Texture.to_ktx2") {
+		auto in = zenkit::Read::from("./samples/erz.tex");
+		zenkit::Texture texture {};
+		texture.load(in.get());
+
+		auto read = [](std::vector<std::byte> const& ktx, std::size_t offset) {
+			std::uint32_t v;
+			std::memcpy(&v, ktx.data() + offset, sizeof v);
+			return v;
+		};
+
+		// DXT1 is stored without being decoded.
+		auto ktx = zenkit::to_ktx2(texture);
+		REQUIRE_GT(ktx.size(), 80);
+		CHECK_EQ(std::memcmp(ktx.data(), "\xABKTX 20\xBB\r\n\x1A\n", 12), 0);
+		CHECK_EQ(read(ktx, 12), 133); // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+		CHECK_EQ(read(ktx, 20), 128);
+		CHECK_EQ(read(ktx, 24), 128);
+		CHECK_EQ(read(ktx, 40), 5);
+
+		for (auto level = 0u; level < 5; ++level) {
+			auto offset = read(ktx, 80 + level * 24);
+			auto length = read(ktx, 80 + level * 24 + 8);
+			auto& data = texture.data(level);
+
+			CHECK_EQ(offset % 8, 0);
+			REQUIRE_EQ(length, data.size());
+			CHECK_EQ(std::memcmp(ktx.data() + offset, data.data(), length), 0);
+		}
+
+		// Transcode to BC7 and decode the first block again, which only supports mode 6.
+		ktx = zenkit::to_ktx2(texture, zenkit::Ktx2Format::BC7, 2);
+		CHECK_EQ(read(ktx, 12), 145); // VK_FORMAT_BC7_UNORM_BLOCK
+		CHECK_EQ(read(ktx, 80 + 8), 128 * 128);
+
+		auto const* block = reinterpret_cast<std::uint8_t const*>(ktx.data() + read(ktx, 80));
+		std::uint32_t bit = 0;
+		auto bits = [&](std::uint32_t count) {
+			std::uint32_t v = 0;
+			for (auto i = 0u; i < count; ++i, ++bit) {
+				v |= static_cast<std::uint32_t>(block[bit / 8] >> (bit % 8) & 1) << i;
+			}
+			return v;
+		};
+
+		REQUIRE_EQ(bits(7), 1 << 6);
+
+		int endpoints[2][4];
+		for (auto c = 0; c < 4; ++c) {
+			endpoints[0][c] = static_cast<int>(bits(7)) << 1;
+			endpoints[1][c] = static_cast<int>(bits(7)) << 1;
+		}
+
+		auto p0 = static_cast<int>(bits(1)), p1 = static_cast<int>(bits(1));
+		for (auto c = 0; c < 4; ++c) {
+			endpoints[0][c] |= p0;
+			endpoints[1][c] |= p1;
+		}
+
+		static constexpr int WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+		auto rgba = texture.as_rgba8();
+		for (auto i = 0u; i < 16; ++i) {
+			auto w = WEIGHTS[bits(i == 0 ? 3 : 4)];
+			auto const* expected = rgba.data() + ((i / 4) * 128 + i % 4) * 4;
+
+			for (auto c = 0; c < 4; ++c) {
+				auto v = ((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6;
+				CHECK_LE(std::abs(v - expected[c]), 8);
+			}
+		}
+
+		// Other formats are decoded.
+		auto rgba_texture = make_texture(zenkit::TextureFormat::B8G8R8, 2, 1, {1, 2, 3, 4, 5, 6});
+		ktx = zenkit::to_ktx2(rgba_texture);
+		CHECK_EQ(read(ktx, 12), 37); // VK_FORMAT_R8G8B8A8_UNORM
+		std::vector<std::uint8_t> level0(8);
+		std::memcpy(level0.data(), ktx.data() + read(ktx, 80), 8);
+		CHECK_EQ(level0, std::vector<std::uint8_t> {3, 2, 1, 255, 6, 5, 4, 255});
+	}
+
+	TEST_CASE("Texture.convert_all") {
+		auto in = zenkit::Read::from("./samples/erz.tex");
+		in->seek(0, zenkit::Whence::END);
+		std::vector<std::byte> bytes(in->tell());
+		in->seek(0, zenkit::Whence::BEG);
+		in->read(bytes.data(), bytes.size());
+
+		zenkit::Vfs vfs {};
+		auto& dir = vfs.mkdir("TEXTURES/_COMPILED");
+		for (auto name : {"A-C.TEX", "B-C.TEX", "C-C.TEX", "D-C.TEX", "E-C.TEX"}) {
+			dir.create(zenkit::VfsNode::file(name, zenkit::VfsFileDescriptor {bytes.data(), bytes.size(), false}));
+		}
+
+		// Invalid textures are skipped.
+		dir.create(zenkit::VfsNode::file("F-C.TEX", zenkit::VfsFileDescriptor {bytes.data() + 4, 64, false}));
+		dir.create(zenkit::VfsNode::file("G.TGA", zenkit::VfsFileDescriptor {bytes.data(), bytes.size(), false}));
+
+		auto expected = zenkit::to_dds([&] {
+			zenkit::Texture tex {};
+			in->seek(0, zenkit::Whence::BEG);
+			tex.load(in.get());
+			return tex;
+		}());
+
+		std::set<std::string> paths;
+		auto count = zenkit::convert_all(
+		    vfs,
+		    "TEXTURES/**/*-C.TEX",
+		    zenkit::to_dds,
+		    [&](std::string_view path, std::vector<std::byte> const& data) {
+			    paths.emplace(path);
+			    CHECK_EQ(data, expected);
+		    },
+		    2);
+
+		CHECK_EQ(count, 5);
+		CHECK_EQ(paths.size(), 5);
+		CHECK_EQ(paths.count("TEXTURES/_COMPILED/A-C.TEX"), 1);
+	}
+
 	TEST_CASE("Texture.load(GOTHIC1)" * doctest::skip()) {
 		// TODO: Stub
 	}
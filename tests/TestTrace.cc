@@ -0,0 +1,129 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <doctest/doctest.h>
+#include <zenkit/Executor.hh>
+#include <zenkit/Memory.hh>
+#include <zenkit/MultiResolutionMesh.hh>
+#include <zenkit/Stream.hh>
+#include <zenkit/Texture.hh>
+#include <zenkit/Trace.hh>
+#include <zenkit/World.hh>
+
+#include <cstring>
+#include <sstream>
+
+TEST_SUITE("Trace") {
+	TEST_CASE("Tracer") {
+		zenkit::Tracer::start();
+		CHECK(zenkit::Tracer::active());
+
+		auto in = zenkit::Read::from("./samples/erz.tex");
+		zenkit::Texture texture {};
+		texture.load(in.get());
+
+		zenkit::Tracer::stop();
+		CHECK_FALSE(zenkit::Tracer::active());
+
+		auto spans = zenkit::Tracer::spans();
+		if (zenkit::Tracer::available()) {
+			REQUIRE_EQ(spans.size(), 1);
+			CHECK_EQ(std::strcmp(spans[0].name, "Texture.load"), 0);
+			CHECK_LE(spans[0].begin, spans[0].end);
+			CHECK_EQ(spans[0].bytes, in->tell());
+		} else {
+			CHECK(spans.empty());
+		}
+
+		std::ostringstream json;
+		{
+			auto out = zenkit::Write::to(&json);
+			zenkit::Tracer::write_chrome_trace(out.get());
+		}
+
+		CHECK_EQ(json.str().rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+		CHECK_EQ(json.str().find("\"name\":\"Texture.load\"") != std::string::npos, zenkit::Tracer::available());
+	}
+
+	TEST_CASE("LoadStats") {
+		zenkit::LoadStats stats {};
+		zenkit::MemoryTracker tracker {};
+
+		auto tex = zenkit::Read::from("./samples/erz.tex");
+		auto mrm = zenkit::Read::from("./samples/mesh0.mrm");
+
+		{
+			zenkit::LoadStatsScope scope {stats};
+
+			// Loads done in a task of a TaskGroup are attributed to the scope they were added in.
+			zenkit::TaskGroup group {};
+			group.run([&tex] {
+				zenkit::Texture texture {};
+				texture.load(tex.get());
+			});
+			group.wait();
+
+			zenkit::MultiResolutionMesh mesh {};
+			mesh.load(mrm.get());
+
+			tracker.deallocate(tracker.allocate(64, 8), 64, 8);
+
+			// Only the innermost scope collects statistics.
+			zenkit::LoadStats inner {};
+			{
+				zenkit::LoadStatsScope inner_scope {inner};
+				zenkit::Texture texture {};
+				texture.load(zenkit::Read::from("./samples/erz.tex").get());
+			}
+			CHECK_EQ(inner.loads, 1);
+		}
+
+		CHECK_EQ(stats.loads, 2);
+		CHECK_EQ(stats.bytes_read, tex->tell() + mrm->tell());
+		CHECK_EQ(stats.objects, 1); // The material of the mesh.
+		CHECK_EQ(stats.allocations, 1);
+		CHECK_EQ(stats.allocated_bytes, 64);
+
+		REQUIRE_EQ(stats.phases.size(), 2);
+		CHECK_EQ(std::strcmp(stats.phases[0].name, "Texture.load"), 0);
+		CHECK_EQ(stats.phases[0].bytes, tex->tell());
+		CHECK_EQ(stats.phases[0].count, 1);
+		CHECK_EQ(std::strcmp(stats.phases[1].name, "MultiResolutionMesh.load"), 0);
+		CHECK_LE(stats.phases[0].nanoseconds + stats.phases[1].nanoseconds, stats.nanoseconds);
+
+		// Loads outside of a scope are not counted.
+		zenkit::Texture texture {};
+		texture.load(zenkit::Read::from("./samples/erz.tex").get());
+		CHECK_EQ(stats.loads, 2);
+	}
+
+	TEST_CASE("LoadStats(nested)") {
+		zenkit::LoadStats stats {};
+		auto in = zenkit::Read::from("./samples/G1/Save/WORLD.SAV");
+
+		{
+			zenkit::LoadStatsScope scope {stats};
+			zenkit::World world {};
+			world.load(in.get(), zenkit::GameVersion::GOTHIC_1);
+		}
+
+		// Phases nested in the world count towards their own totals, but not as separate loads.
+		CHECK_EQ(stats.loads, 1);
+		CHECK_EQ(stats.bytes_read, in->tell());
+
+		auto find = [&stats](char const* name) -> zenkit::LoadPhaseStats const* {
+			for (auto& phase : stats.phases) {
+				if (std::strcmp(phase.name, name) == 0) return &phase;
+			}
+			return nullptr;
+		};
+
+		auto world = find("World.load");
+		auto vobs = find("World.VobTree");
+		REQUIRE_NE(world, nullptr);
+		REQUIRE_NE(vobs, nullptr);
+		CHECK_EQ(world->bytes, in->tell());
+		CHECK_GT(vobs->bytes, 0);
+		CHECK_LT(vobs->bytes, world->bytes);
+		CHECK_LE(vobs->nanoseconds, world->nanoseconds);
+	}
+}
@@ -2,6 +2,16 @@
 // SPDX-License-Identifier: MIT
 #include <zenkit/Vfs.hh>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
 #include <doctest/doctest.h>
 
 void check_vfs(zenkit::Vfs const& vdf) {
@@ -69,4 +79,493 @@ TEST_SUITE("Vfs") {
 		vdf.mount_host("./samples/basic.vdf.dir", "/");
 		check_vfs(vdf);
 	}
+
+	TEST_CASE("Vfs.mount_disks(GOTHIC?)") {
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_disks({"./samples/basic.vdf", "./samples/basic.vdf"});
+		check_vfs(vdf);
+
+		auto broken = zenkit::Vfs {};
+		CHECK_THROWS_AS(broken.mount_disks({"./samples/basic.vdf", "./samples/basic.bin"}),
+		                zenkit::VfsBrokenDiskError);
+		check_vfs(broken);
+	}
+
+	TEST_CASE("Vfs.save") {
+		auto disk = std::filesystem::temp_directory_path() / "zenkit-test-save.vdf";
+
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_disk("./samples/basic.vdf");
+
+		std::vector<std::byte> expected;
+		auto w = zenkit::Write::to(&expected);
+		vdf.save(w.get(), zenkit::GameVersion::GOTHIC_1, 1000);
+		vdf.save(disk, zenkit::GameVersion::GOTHIC_1, 1000);
+
+		auto r = zenkit::Read::from(disk);
+		std::vector<std::byte> actual(expected.size() + 1);
+		CHECK_EQ(r->read(actual.data(), actual.size()), expected.size());
+		actual.resize(expected.size());
+		CHECK(actual == expected);
+
+		{
+			auto saved = zenkit::Vfs {};
+			saved.mount_disk(disk);
+			check_vfs(saved);
+
+			auto config = saved.find("config.yml")->open_read();
+			CHECK_EQ(config->read_string(6), "# Some");
+		}
+
+		std::filesystem::remove(disk);
+	}
+
+	TEST_CASE("Vfs.save(deduplicate)") {
+		static constexpr char DATA[] = "identical contents";
+		auto const* mem = reinterpret_cast<std::byte const*>(DATA);
+
+		auto vdf = zenkit::Vfs {};
+		vdf.mkdir("/a");
+		vdf.resolve("/a")->create(zenkit::VfsNode::file("one.txt", {mem, sizeof DATA - 1, false}, 0));
+		vdf.resolve("/")->create(zenkit::VfsNode::file("two.txt", {mem, sizeof DATA - 1, false}, 0));
+		vdf.resolve("/")->create(zenkit::VfsNode::file("three.txt", {mem, 9, false}, 0));
+
+		std::vector<std::byte> plain;
+		auto w = zenkit::Write::to(&plain);
+		vdf.save(w.get(), zenkit::GameVersion::GOTHIC_2, 1000);
+
+		std::vector<std::byte> deduplicated;
+		w = zenkit::Write::to(&deduplicated);
+		zenkit::VfsSaveOptions options;
+		options.deduplicate = true;
+		vdf.save(w.get(), zenkit::GameVersion::GOTHIC_2, 1000, options);
+		CHECK_EQ(plain.size() - deduplicated.size(), sizeof DATA - 1);
+
+		auto r = zenkit::Read::from(&deduplicated);
+		auto saved = zenkit::Vfs {};
+		saved.mount_disk(r.get());
+		CHECK_EQ(saved.resolve("a/one.txt")->open_read()->read_string(sizeof DATA - 1), DATA);
+		CHECK_EQ(saved.resolve("two.txt")->open_read()->read_string(sizeof DATA - 1), DATA);
+		CHECK_EQ(saved.resolve("three.txt")->open_read()->read_string(9), "identical");
+	}
+
+	TEST_CASE("Vfs.access_stats") {
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_disk("./samples/basic.vdf");
+		vdf.set_access_stats(true);
+
+		(void) vdf.find("MIT.MD")->open_read();
+		(void) vdf.find("config.yml")->open_read();
+		(void) vdf.find("MIT.MD")->data_view();
+
+		auto stats = vdf.access_stats();
+		REQUIRE_EQ(stats.files.size(), 2);
+		CHECK_EQ(stats.files[0].path, "LICENSES/MIT.MD");
+		CHECK_EQ(stats.files[0].opens, 2);
+		CHECK_EQ(stats.files[0].first_access, 1);
+		CHECK_EQ(stats.files[1].path, "CONFIG.YML");
+		CHECK_EQ(stats.files[1].opens, 1);
+		CHECK_EQ(stats.files[1].first_access, 2);
+
+		REQUIRE_EQ(stats.sources.size(), 1);
+		CHECK_EQ(stats.sources[0].opens, 3);
+		CHECK_EQ(stats.sources[0].bytes, stats.files[0].bytes + stats.files[1].bytes);
+
+		// Files are laid out in access order, but the catalog stays the same.
+		zenkit::VfsSaveOptions options;
+		options.access_order = true;
+
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		vdf.save(w.get(), zenkit::GameVersion::GOTHIC_1, 1000, options);
+
+		auto r = zenkit::Read::from(&data);
+		auto saved = zenkit::Vfs {};
+		saved.mount_disk(r.get());
+		check_vfs(saved);
+		CHECK_LT(saved.find("MIT.MD")->data_view().data(), saved.find("config.yml")->data_view().data());
+		CHECK_LT(saved.find("config.yml")->data_view().data(), saved.find("README.MD")->data_view().data());
+		CHECK_EQ(saved.find("config.yml")->open_read()->read_string(6), "# Some");
+
+		vdf.set_access_stats(false);
+		CHECK(vdf.access_stats().files.empty());
+	}
+
+	TEST_CASE("Vfs.save_index") {
+		auto dir = std::filesystem::temp_directory_path();
+		auto disk = dir / "zenkit-test-index.vdf";
+		auto index = dir / "zenkit-test-index.bin";
+		std::filesystem::copy_file("./samples/basic.vdf", disk, std::filesystem::copy_options::overwrite_existing);
+
+		{
+			auto vdf = zenkit::Vfs {};
+			vdf.mount_disk(disk);
+			vdf.save_index(index);
+		}
+
+		{
+			auto vdf = zenkit::Vfs {};
+			CHECK(vdf.load_index(index));
+			check_vfs(vdf);
+
+			auto r = vdf.find("config.yml")->open_read();
+			CHECK_EQ(r->read_string(6), "# Some");
+		}
+
+		// Files which reach past the end of their source are rejected, even if their offset and size wrap around.
+		{
+			std::string data;
+			{
+				std::ifstream in {index, std::ios::binary};
+				data.assign(std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {});
+			}
+
+			auto name = data.find("CONFIG.YML");
+			REQUIRE_NE(name, std::string::npos);
+
+			// The name is followed by its time, the index of its source, its offset and its size.
+			std::uint64_t const offset = ~std::uint64_t {0} - 15, size = 32;
+			std::memcpy(data.data() + name + 10 + 8 + 4, &offset, sizeof offset);
+			std::memcpy(data.data() + name + 10 + 8 + 4 + 8, &size, sizeof size);
+
+			auto broken = dir / "zenkit-test-index-broken.bin";
+			std::ofstream {broken, std::ios::binary}.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+			auto vdf = zenkit::Vfs {};
+			CHECK_FALSE(vdf.load_index(broken));
+			std::filesystem::remove(broken);
+		}
+
+		// Modifying the disk must invalidate the index.
+		std::filesystem::last_write_time(disk, std::filesystem::last_write_time(disk) + std::chrono::seconds {10});
+
+		{
+			auto vdf = zenkit::Vfs {};
+			CHECK_FALSE(vdf.load_index(index));
+			CHECK(vdf.root().children().empty());
+		}
+
+		// Nodes which don't live in a host file can't be indexed.
+		{
+			auto vdf = zenkit::Vfs {};
+			auto r = zenkit::Read::from("./samples/basic.vdf");
+			vdf.mount_disk(r.get());
+			CHECK_THROWS(vdf.save_index(index));
+		}
+
+		// Files mounted from the host are indexed as well.
+		{
+			auto vdf = zenkit::Vfs {};
+			vdf.mount_host("./samples/basic.vdf.dir", "/");
+			vdf.save_index(index);
+		}
+
+		{
+			auto vdf = zenkit::Vfs {};
+			CHECK(vdf.load_index(index));
+			check_vfs(vdf);
+		}
+
+		// Truncated indices must be rejected before their counts are used.
+		std::filesystem::resize_file(index, std::filesystem::file_size(index) / 2);
+
+		{
+			auto vdf = zenkit::Vfs {};
+			CHECK_THROWS_AS(vdf.load_index(index), zenkit::VfsBrokenDiskError);
+			CHECK(vdf.root().children().empty());
+		}
+
+		std::filesystem::remove(disk);
+		std::filesystem::remove(index);
+	}
+
+	TEST_CASE("Vfs.set_lazy_disks(GOTHIC?)") {
+		auto vdf = zenkit::Vfs {};
+		vdf.set_lazy_disks(true);
+		vdf.mount_disk("./samples/basic.vdf");
+		check_vfs(vdf);
+
+		auto r = vdf.find("config.yml")->open_read();
+		CHECK_EQ(r->read_string(6), "# Some");
+
+		// Indices can be loaded lazily, too.
+		auto index = std::filesystem::temp_directory_path() / "zenkit-test-lazy-index.bin";
+		vdf.save_index(index);
+
+		auto cached = zenkit::Vfs {};
+		cached.set_lazy_disks(true);
+		CHECK(cached.load_index(index));
+		check_vfs(cached);
+		CHECK_EQ(cached.find("config.yml")->open_read()->read_string(6), "# Some");
+
+		std::filesystem::remove(index);
+	}
+
+	TEST_CASE("Vfs.watch_host") {
+		auto dir = std::filesystem::temp_directory_path() / "zenkit-test-watch";
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir / "sub");
+
+		auto write = [](std::filesystem::path const& path, std::string_view contents) {
+			std::ofstream out {path, std::ios::binary | std::ios::trunc};
+			out << contents;
+		};
+
+		auto read = [](zenkit::VfsNode const* node) {
+			REQUIRE(node != nullptr);
+			auto view = node->data_view();
+			return std::string {reinterpret_cast<char const*>(view.data()), view.size()};
+		};
+
+		write(dir / "a.txt", "first");
+		write(dir / "sub" / "b.txt", "second");
+
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_host(dir, "/");
+		vdf.watch_host(dir, "/");
+		CHECK_EQ(vdf.poll_host_changes(), 0);
+
+		write(dir / "a.txt", "updated");
+		write(dir / "sub" / "c.txt", "created");
+		std::filesystem::remove(dir / "sub" / "b.txt");
+		std::filesystem::create_directories(dir / "new");
+		write(dir / "new" / "d.txt", "nested");
+
+		CHECK_GT(vdf.poll_host_changes(), 0);
+		CHECK_EQ(read(vdf.resolve("a.txt")), "updated");
+		CHECK_EQ(read(vdf.resolve("sub/c.txt")), "created");
+		CHECK_EQ(vdf.resolve("sub/b.txt"), nullptr);
+		CHECK_EQ(read(vdf.resolve("new/d.txt")), "nested");
+
+		std::filesystem::remove_all(dir / "new");
+		vdf.poll_host_changes();
+		CHECK_EQ(vdf.resolve("new"), nullptr);
+
+		std::filesystem::remove_all(dir);
+	}
+
+	TEST_CASE("Vfs.open_read(concurrent)") {
+		auto vdf = zenkit::Vfs {};
+		vdf.set_lazy_disks(true);
+		vdf.mount_disk("./samples/basic.vdf");
+
+		std::atomic_size_t failures {0};
+		std::vector<std::thread> threads;
+
+		// Lookups and reads don't need any locking once mounting is done.
+		for (int i = 0; i < 8; ++i) {
+			threads.emplace_back([&vdf, &failures] {
+				for (int j = 0; j < 200; ++j) {
+					auto const* node = vdf.find("config.yml");
+					auto const* same = vdf.resolve("/CONFIG.YML");
+
+					if (node == nullptr || node != same || node->open_read()->read_string(6) != "# Some") {
+						failures += 1;
+					}
+				}
+			});
+		}
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		// Modifying the Vfs at runtime requires readers to hold a shared lock.
+		threads.clear();
+		threads.emplace_back([&vdf] {
+			for (int j = 0; j < 50; ++j) {
+				vdf.mkdir("scratch/" + std::to_string(j));
+				vdf.remove("scratch");
+			}
+		});
+
+		for (int i = 0; i < 4; ++i) {
+			threads.emplace_back([&vdf, &failures] {
+				for (int j = 0; j < 200; ++j) {
+					auto lock = vdf.lock_shared();
+					auto const* node = vdf.find("MIT.MD");
+
+					if (node == nullptr || node->open_read()->read_string(9) != "# The MIT") {
+						failures += 1;
+					}
+				}
+			});
+		}
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		CHECK_EQ(failures.load(), 0);
+		CHECK_EQ(vdf.resolve("scratch"), nullptr);
+	}
+
+	TEST_CASE("Vfs.enumerate") {
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_disk("./samples/basic.vdf");
+
+		auto collect = [&vdf](std::string_view pattern) {
+			std::vector<std::string> paths;
+			vdf.enumerate(pattern, [&paths](std::string_view path, zenkit::VfsNode const&) {
+				paths.emplace_back(path);
+				return true;
+			});
+			return paths;
+		};
+
+		CHECK_EQ(collect("*.MD"), std::vector<std::string> {"README.MD"});
+		CHECK_EQ(collect("/licenses/gpl/*"),
+		         std::vector<std::string> {"LICENSES/GPL/GPL-3.0.MD", "LICENSES/GPL/LGPL-3.0.MD"});
+		CHECK_EQ(collect("licenses/gpl/?gpl-3.0.md"), std::vector<std::string> {"LICENSES/GPL/LGPL-3.0.MD"});
+		CHECK_EQ(collect("**/*.md").size(), 4);
+		CHECK_EQ(collect("licenses/**").size(), 4);
+		CHECK_EQ(collect("**/gpl/**/*gpl*").size(), 2);
+		CHECK_EQ(collect("config.yml"), std::vector<std::string> {"CONFIG.YML"});
+		CHECK(collect("config.yml/*").empty());
+		CHECK(collect("nonexistent/**").empty());
+		CHECK(collect("").empty());
+
+		size_t count = 0;
+		vdf.enumerate("**", [&count](std::string_view, zenkit::VfsNode const&) { return ++count < 2; });
+		CHECK_EQ(count, 2);
+	}
+
+	TEST_CASE("Vfs.find(modified)") {
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_disk("./samples/basic.vdf");
+		CHECK_NE(vdf.find("MIT.MD"), nullptr);
+
+		CHECK(vdf.remove("LICENSES/MIT.MD"));
+		CHECK_EQ(vdf.find("MIT.MD"), nullptr);
+		CHECK_EQ(vdf.resolve("LICENSES/MIT.MD"), nullptr);
+
+		// Nodes created directly must be picked up as well.
+		vdf.mkdir("a/b").create(zenkit::VfsNode::directory("MIT.MD"));
+		CHECK_EQ(vdf.find("mit.md"), vdf.resolve("/A/B/mit.md"));
+		CHECK(vdf.find("MIT.MD")->type() == zenkit::VfsNodeType::DIRECTORY);
+
+		// Nodes copied from another Vfs must invalidate the index of the Vfs they were inserted into.
+		auto other = zenkit::Vfs {};
+		other.mkdir("c").create(zenkit::VfsNode::directory("D"));
+		auto* copy = vdf.mkdir("a").create(*other.resolve("c"));
+		CHECK_NE(vdf.find("D"), nullptr);
+
+		copy->child("D")->create(zenkit::VfsNode::directory("E"));
+		CHECK_NE(vdf.find("E"), nullptr);
+		CHECK_EQ(other.find("E"), nullptr);
+
+		// Files can't have children.
+		CHECK_EQ(vdf.resolve("config.yml/x"), nullptr);
+	}
+
+	TEST_CASE("VfsNode.hash") {
+		static constexpr char DATA[] = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+		auto const* mem = reinterpret_cast<std::byte const*>(DATA);
+
+		CHECK_EQ(zenkit::VfsNode::file("a", {mem, 0, false}).hash(), 0xEF46DB3751D8E999);
+		CHECK_EQ(zenkit::VfsNode::file("a", {mem, 3, false}).hash(), 0x44BC2CF5AD770999);
+		CHECK_EQ(zenkit::VfsNode::file("a", {mem, sizeof DATA - 1, false}).hash(), 0xD5000C4AC53D14A0);
+		CHECK_THROWS(zenkit::VfsNode::directory("a").hash());
+
+		auto plain = zenkit::Vfs {};
+		plain.mount_disk("./samples/basic.vdf");
+
+		auto hashed = zenkit::Vfs {};
+		hashed.set_hash_files(true);
+		hashed.mount_disks({"./samples/basic.vdf"});
+		CHECK_EQ(hashed.find("MIT.MD")->hash(), plain.find("MIT.MD")->hash());
+		CHECK_NE(hashed.find("MIT.MD")->hash(), hashed.find("README.MD")->hash());
+	}
+
+	/// \brief Forwards to another stream and counts the bytes read from it.
+	class CountingRead final : public zenkit::Read {
+	public:
+		explicit CountingRead(std::unique_ptr<zenkit::Read> inner, std::atomic_size_t& count)
+		    : _m_inner(std::move(inner)), _m_count(count) {}
+
+		size_t read(void* buf, size_t len) noexcept override {
+			auto n = _m_inner->read(buf, len);
+			_m_count += n;
+			return n;
+		}
+
+		void seek(ssize_t off, zenkit::Whence whence) noexcept override {
+			_m_inner->seek(off, whence);
+		}
+
+		[[nodiscard]] size_t tell() const noexcept override {
+			return _m_inner->tell();
+		}
+
+		[[nodiscard]] bool eof() const noexcept override {
+			return _m_inner->eof();
+		}
+
+	private:
+		std::unique_ptr<zenkit::Read> _m_inner;
+		std::atomic_size_t& _m_count;
+	};
+
+	TEST_CASE("Vfs.mount_disk_streamed(GOTHIC?)") {
+		std::atomic_size_t count {0};
+
+		auto vdf = zenkit::Vfs {};
+		vdf.mount_disk_streamed(std::make_unique<CountingRead>(zenkit::Read::from("./samples/basic.vdf"), count));
+		check_vfs(vdf);
+
+		// Only the header and catalog are read while mounting.
+		auto mounted = count.load();
+		CHECK_LT(mounted, std::filesystem::file_size("./samples/basic.vdf"));
+
+		auto const* node = vdf.find("config.yml");
+		auto r = node->open_read();
+		r->seek(0, zenkit::Whence::END);
+		auto size = r->tell();
+		r->seek(0, zenkit::Whence::BEG);
+		CHECK_EQ(r->read_string(6), "# Some");
+		CHECK_EQ(count.load(), mounted + size);
+
+		// Views are read once and kept around.
+		auto view = node->data_view();
+		CHECK_EQ(std::string_view {reinterpret_cast<char const*>(view.data()), 6}, "# Some");
+		CHECK_EQ(node->data_view().data(), view.data());
+		CHECK_EQ(node->open_read()->read_string(6), "# Some");
+		CHECK_EQ(count.load(), mounted + size * 2);
+	}
+
+	TEST_CASE("VfsNode.data_view") {
+		auto vdf = zenkit::Vfs {};
+		vdf.set_lazy_disks(true);
+		vdf.mount_disk("./samples/basic.vdf");
+
+		auto const* node = vdf.find("config.yml");
+		auto view = node->data_view();
+		auto r = node->open_read();
+		r->seek(0, zenkit::Whence::END);
+		CHECK_EQ(view.size(), r->tell());
+		CHECK_EQ(std::string_view {reinterpret_cast<char const*>(view.data()), 6}, "# Some");
+		CHECK_EQ(node->data_view().data(), view.data());
+		CHECK_THROWS(vdf.find("licenses")->data_view());
+	}
+
+	TEST_CASE("VfsNode.create") {
+		auto root = zenkit::VfsNode::directory("/");
+		root.create(zenkit::VfsNode::directory("b"));
+		root.create(zenkit::VfsNode::directory("C"));
+		root.create(zenkit::VfsNode::directory("a"));
+		root.create(zenkit::VfsNode::directory("B", 10));
+
+		// Children are kept ordered by name, and replaced if the name already exists.
+		std::vector<std::string> names {};
+		for (auto const& child : root.children()) {
+			names.push_back(child.name());
+		}
+
+		CHECK_EQ(names, std::vector<std::string> {"a", "B", "C"});
+		CHECK_EQ(root.child("b")->time(), 10);
+
+		CHECK(root.remove("A "));
+		CHECK_EQ(root.child("a"), nullptr);
+		CHECK_EQ(root.children().size(), 2);
+	}
 }
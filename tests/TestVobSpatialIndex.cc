@@ -0,0 +1,95 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/World.hh>
+#include <zenkit/vobs/VirtualObject.hh>
+#include <zenkit/world/VobSpatialIndex.hh>
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+
+static std::shared_ptr<zenkit::VirtualObject> make_vob(zenkit::Vec3 min, zenkit::Vec3 max) {
+	auto vob = std::make_shared<zenkit::VirtualObject>();
+	vob->bbox = {min, max};
+	vob->position = zenkit::Vec3 {(min.x + max.x) / 2, (min.y + max.y) / 2, (min.z + max.z) / 2};
+	return vob;
+}
+
+static bool contains(std::vector<zenkit::VirtualObject*> const& vobs, std::shared_ptr<zenkit::VirtualObject> const& v) {
+	return std::find(vobs.begin(), vobs.end(), v.get()) != vobs.end();
+}
+
+TEST_SUITE("VobSpatialIndex") {
+	TEST_CASE("VobSpatialIndex.query") {
+		zenkit::World world {};
+		auto a = make_vob({0, 0, 0}, {10, 10, 10});
+		auto b = make_vob({200, 0, 0}, {210, 10, 10});
+		auto c = make_vob({-1000, -1000, -1000}, {1000, 1000, 1000});
+		auto d = std::make_shared<zenkit::VirtualObject>();
+		d->position = zenkit::Vec3 {500, 5, 5};
+
+		world.world_vobs = {a, c};
+		a->children = {b, d};
+
+		zenkit::VobSpatialIndex index {50};
+		index.build(world);
+		REQUIRE_EQ(index.size(), 4);
+
+		std::vector<zenkit::VirtualObject*> vobs;
+		index.query_box({{-5, -5, -5}, {5, 5, 5}}, vobs);
+		CHECK_EQ(vobs.size(), 2);
+		CHECK(contains(vobs, a));
+		CHECK(contains(vobs, c));
+
+		// The box of `d` does not contain its position, so its position is used instead.
+		index.query_radius({510, 5, 5}, 15, vobs);
+		CHECK_EQ(vobs.size(), 2);
+		CHECK(contains(vobs, c));
+		CHECK(contains(vobs, d));
+
+		index.query_radius({5, 5, 5}, 150, vobs);
+		CHECK_EQ(vobs.size(), 2);
+
+		index.query_ray({-100, 5, 5}, {1, 0, 0}, 1000, vobs);
+		REQUIRE_EQ(vobs.size(), 4);
+		CHECK_EQ(vobs[0], c.get());
+		CHECK_EQ(vobs[1], a.get());
+		CHECK_EQ(vobs[2], b.get());
+		CHECK_EQ(vobs[3], d.get());
+
+		index.query_ray({-100, 5, 5}, {1, 0, 0}, 150, vobs);
+		CHECK_EQ(vobs.size(), 2);
+	}
+
+	TEST_CASE("VobSpatialIndex.update") {
+		auto a = make_vob({0, 0, 0}, {10, 10, 10});
+		auto b = make_vob({20, 0, 0}, {30, 10, 10});
+
+		zenkit::VobSpatialIndex index {50};
+		index.insert(a.get());
+		index.insert(b.get());
+
+		std::vector<zenkit::VirtualObject*> vobs;
+		index.query_radius({300, 5, 5}, 20, vobs);
+		CHECK(vobs.empty());
+
+		a->bbox = {{300, 0, 0}, {310, 10, 10}};
+		a->position = {305, 5, 5};
+		index.update(a.get());
+
+		index.query_radius({300, 5, 5}, 20, vobs);
+		REQUIRE_EQ(vobs.size(), 1);
+		CHECK_EQ(vobs[0], a.get());
+
+		index.query_box({{0, 0, 0}, {15, 15, 15}}, vobs);
+		CHECK(vobs.empty());
+
+		CHECK(index.remove(b.get()));
+		CHECK_FALSE(index.remove(b.get()));
+		CHECK_EQ(index.size(), 1);
+
+		index.query_ray({0, 5, 5}, {1, 0, 0}, 1000, vobs);
+		REQUIRE_EQ(vobs.size(), 1);
+		CHECK_EQ(vobs[0], a.get());
+	}
+}
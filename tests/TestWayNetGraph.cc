@@ -0,0 +1,166 @@
+// Copyright © 2024 GothicKit Contributors.
+// SPDX-License-Identifier: MIT
+#include <zenkit/Stream.hh>
+#include <zenkit/world/WayNet.hh>
+#include <zenkit/world/WayNetGraph.hh>
+
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <random>
+
+static zenkit::WayNet make_way_net() {
+	zenkit::WayNet way_net {};
+
+	for (auto position : std::initializer_list<zenkit::Vec3> {
+	         {0, 0, 0},
+	         {100, 0, 0},
+	         {200, 0, 0},
+	         {0, 0, 100},
+	         {100, 0, 150},
+	         {500, 0, 500},
+	     }) {
+		auto& wp = way_net.waypoints.emplace_back();
+		wp.position = position;
+	}
+
+	way_net.edges = {{0, 1}, {1, 2}, {0, 3}, {3, 4}, {4, 2}, {2, 2}, {0, 9}};
+	return way_net;
+}
+
+TEST_SUITE("WayNetGraph") {
+	TEST_CASE("WayNetGraph.build") {
+		zenkit::WayNetGraph graph {};
+		graph.build(make_way_net());
+
+		REQUIRE_EQ(graph.size(), 6);
+		CHECK_EQ(graph.offsets, std::vector<std::uint32_t> {0, 2, 4, 6, 8, 10, 10});
+		CHECK_EQ(graph.targets.size(), 10);
+		CHECK_EQ(graph.costs[0], doctest::Approx(100));
+	}
+
+	TEST_CASE("WayNetGraph.find_path") {
+		zenkit::WayNetGraph graph {};
+		graph.build(make_way_net());
+
+		zenkit::WayNetScratch scratch {};
+		std::vector<std::uint32_t> path;
+
+		auto length = graph.find_path(0, 2, path, scratch);
+		REQUIRE(length.has_value());
+		CHECK_EQ(*length, doctest::Approx(200));
+		CHECK_EQ(path, std::vector<std::uint32_t> {0, 1, 2});
+
+		length = graph.find_path(3, 2, path, scratch);
+		REQUIRE(length.has_value());
+		CHECK_EQ(*length, doctest::Approx(std::sqrt(12500.f) + std::sqrt(32500.f)));
+		CHECK_EQ(path, std::vector<std::uint32_t> {3, 4, 2});
+
+		length = graph.find_path(4, 4, path, scratch);
+		REQUIRE(length.has_value());
+		CHECK_EQ(*length, 0);
+		CHECK_EQ(path, std::vector<std::uint32_t> {4});
+
+		CHECK_FALSE(graph.find_path(0, 5, path, scratch).has_value());
+		CHECK(path.empty());
+		CHECK_FALSE(graph.find_path(0, 6, path).has_value());
+
+		// The scratch buffers are reset between queries.
+		length = graph.find_path(2, 0, path);
+		REQUIRE(length.has_value());
+		CHECK_EQ(path, std::vector<std::uint32_t> {2, 1, 0});
+	}
+
+	TEST_CASE("WayNetGraph.distances") {
+		zenkit::WayNetGraph graph {};
+		graph.build(make_way_net());
+
+		zenkit::WayNetScratch scratch {};
+		std::vector<float> distances;
+		graph.distances({1, 3, 42}, distances, scratch);
+
+		REQUIRE_EQ(distances.size(), 6);
+		CHECK_EQ(distances[0], doctest::Approx(100));
+		CHECK_EQ(distances[1], 0);
+		CHECK_EQ(distances[2], doctest::Approx(100));
+		CHECK_EQ(distances[3], 0);
+		CHECK_EQ(distances[4], doctest::Approx(std::sqrt(12500.f)));
+		CHECK(std::isinf(distances[5]));
+	}
+
+	TEST_CASE("WayNetGraph.build_distance_table") {
+		zenkit::WayNetGraph graph {};
+		graph.build(make_way_net());
+
+		auto table = graph.build_distance_table({4, 0, 4, 17});
+		CHECK_EQ(table.targets, std::vector<std::uint32_t> {0, 4});
+		CHECK_EQ(table.distance(2, 0), doctest::Approx(200));
+		CHECK_EQ(table.distance(0, 4), doctest::Approx(100 + std::sqrt(12500.f)));
+		CHECK_FALSE(table.distance(5, 0).has_value());
+		CHECK_FALSE(table.distance(0, 1).has_value());
+		CHECK_FALSE(table.distance(6, 0).has_value());
+
+		auto all = graph.build_distance_table();
+		std::vector<std::uint32_t> path;
+		for (auto a = 0u; a < graph.size(); ++a) {
+			for (auto b = 0u; b < graph.size(); ++b) {
+				auto expected = graph.find_path(a, b, path);
+				auto actual = all.distance(a, b);
+				REQUIRE_EQ(actual.has_value(), expected.has_value());
+				if (expected) CHECK_EQ(*actual, doctest::Approx(*expected));
+			}
+		}
+
+		std::vector<std::byte> data;
+		table.save(zenkit::Write::to(&data).get());
+
+		zenkit::WayNetDistanceTable loaded {};
+		REQUIRE(loaded.load(zenkit::Read::from(&data).get(), graph));
+		CHECK_EQ(loaded.targets, table.targets);
+		CHECK_EQ(loaded.distance(2, 0), doctest::Approx(200));
+
+		// Tables built from a different graph are rejected.
+		auto way_net = make_way_net();
+		way_net.waypoints[5].position.x += 1;
+		graph.build(way_net);
+		CHECK_FALSE(zenkit::WayNetDistanceTable {}.load(zenkit::Read::from(&data).get(), graph));
+	}
+
+	TEST_CASE("WayNetGraph.nearest_waypoint") {
+		zenkit::WayNetGraph graph {};
+		CHECK_FALSE(graph.nearest_waypoint({0, 0, 0}).has_value());
+
+		graph.build(make_way_net());
+		CHECK_EQ(graph.nearest_waypoint({10, 0, 10}), 0);
+		CHECK_EQ(graph.nearest_waypoint({90, 0, 130}), 4);
+		CHECK_EQ(graph.nearest_waypoint({1000, 0, 1000}), 5);
+
+		std::mt19937 rng {42};
+		std::uniform_real_distribution<float> coordinate {-1000, 1000};
+
+		zenkit::WayNet way_net {};
+		for (auto i = 0; i < 500; ++i) {
+			way_net.waypoints.emplace_back().position = {coordinate(rng), coordinate(rng), coordinate(rng)};
+		}
+
+		graph.build(way_net);
+
+		auto distance = [](zenkit::Vec3 const& a, zenkit::Vec3 const& b) {
+			return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z);
+		};
+
+		for (auto i = 0; i < 100; ++i) {
+			zenkit::Vec3 position {coordinate(rng), coordinate(rng), coordinate(rng)};
+
+			auto expected = 0u;
+			for (auto j = 1u; j < way_net.waypoints.size(); ++j) {
+				if (distance(way_net.waypoints[j].position, position) <
+				    distance(way_net.waypoints[expected].position, position)) {
+					expected = j;
+				}
+			}
+
+			CHECK_EQ(graph.nearest_waypoint(position), expected);
+		}
+	}
+}
@@ -1,12 +1,18 @@
 // Copyright © 2021-2024 GothicKit Contributors.
 // SPDX-License-Identifier: MIT
 #include <doctest/doctest.h>
+#include <zenkit/Archive.hh>
 #include <zenkit/Material.hh>
+#include <zenkit/Vfs.hh>
 #include <zenkit/World.hh>
+#include <zenkit/vobs/Misc.hh>
 #include <zenkit/vobs/VirtualObject.hh>
+#include <zenkit/world/WorldPatch.hh>
 
 #include <zenkit/Stream.hh>
 
+#include <algorithm>
+
 TEST_SUITE("World") {
 	TEST_CASE("World.load(GOTHIC1)") {
 		auto in = zenkit::Read::from("./samples/world.proprietary.zen");
@@ -367,7 +373,362 @@ TEST_SUITE("World") {
 #endif
 	}
 
+	TEST_CASE("World.load(arena)") {
+		auto in = zenkit::Read::from("./samples/world.proprietary.zen");
+		zenkit::World plain {};
+		plain.load(in.get(), zenkit::GameVersion::GOTHIC_1);
+
+		in = zenkit::Read::from("./samples/world.proprietary.zen");
+		auto arena = zenkit::ObjectArena::create();
+		auto wld = std::make_unique<zenkit::World>();
+		wld->load(in.get(), zenkit::GameVersion::GOTHIC_1, arena);
+
+		REQUIRE_EQ(wld->world_vobs.size(), plain.world_vobs.size());
+		CHECK_EQ(wld->world_vobs[0]->children.size(), plain.world_vobs[0]->children.size());
+		CHECK_EQ(wld->world_vobs[0]->children[0]->vob_name, plain.world_vobs[0]->children[0]->vob_name);
+		CHECK_GT(arena->bytes_used(), 0);
+		CHECK_LT(arena->block_count(), 100);
+
+		// Objects keep the arena alive.
+		std::weak_ptr<zenkit::ObjectArena> weak = arena;
+		arena.reset();
+		CHECK_FALSE(weak.expired());
+		CHECK_EQ(wld->world_vobs[0]->children[0]->vob_name, plain.world_vobs[0]->children[0]->vob_name);
+
+		wld.reset();
+		CHECK(weak.expired());
+	}
+
+	TEST_CASE("World.load(parallel)") {
+		auto in = zenkit::Read::from("./samples/world.proprietary.zen");
+		zenkit::World plain {};
+		plain.load(in.get(), zenkit::GameVersion::GOTHIC_1);
+
+		zenkit::WorldLoadOptions options {};
+		options.parallel = true;
+
+		in = zenkit::Read::from("./samples/world.proprietary.zen");
+		zenkit::World wld {};
+		wld.load(in.get(), zenkit::GameVersion::GOTHIC_1, options);
+
+		CHECK_EQ(wld.world_mesh.vertices.size(), plain.world_mesh.vertices.size());
+		CHECK_EQ(wld.world_mesh.polygons.vertex_indices, plain.world_mesh.polygons.vertex_indices);
+		CHECK_EQ(wld.world_bsp_tree.nodes.size(), plain.world_bsp_tree.nodes.size());
+		CHECK_EQ(wld.world_bsp_tree.leaf_polygons, plain.world_bsp_tree.leaf_polygons);
+		REQUIRE_EQ(wld.world_vobs.size(), plain.world_vobs.size());
+		CHECK_EQ(wld.world_vobs[0]->children.size(), plain.world_vobs[0]->children.size());
+	}
+
 	TEST_CASE("World.load(GOTHIC2)" * doctest::skip()) {
 		// TODO: Stub
 	}
 }
+
+TEST_SUITE("WorldCooked") {
+	TEST_CASE("World.save_cooked") {
+		auto in = zenkit::Read::from("./samples/G1/Save/WORLD.SAV");
+		zenkit::World wld {};
+		wld.load(in.get(), zenkit::GameVersion::GOTHIC_1);
+
+		auto& material = wld.world_mesh.materials.emplace_back();
+		material.name = "STONE";
+		material.texture = "STONE.TGA";
+		wld.world_mesh.vertices = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+		wld.world_mesh.polygons.vertex_indices = {0, 1, 2};
+		wld.world_mesh.polygons.material_indices = {0};
+		wld.world_bsp_tree.nodes.push_back(zenkit::BspNode {{1, 0, 0, 5}, {}, 0, 1, -1, -1, -1});
+		wld.world_bsp_tree.leaf_polygons = {0};
+		wld.world_bsp_tree.sectors.push_back(zenkit::BspSector {"SECTOR", {0}, {}});
+
+		std::vector<std::byte> texture(100, std::byte {0x42});
+		zenkit::Vfs assets {};
+		assets.mkdir("/_WORK/DATA/TEXTURES/_COMPILED")
+		    .create(zenkit::VfsNode::file("STONE-C.TEX", {texture.data(), texture.size(), false}));
+
+		std::vector<std::byte> data;
+		wld.save_cooked(zenkit::Write::to(&data).get(), zenkit::GameVersion::GOTHIC_1, &assets);
+
+		zenkit::Vfs loaded_assets {};
+		zenkit::World cooked {};
+		cooked.load_cooked(zenkit::Read::from(&data).get(), {}, &loaded_assets);
+
+		CHECK_EQ(cooked.world_mesh.vertices, wld.world_mesh.vertices);
+		CHECK_EQ(cooked.world_mesh.polygons.vertex_indices, wld.world_mesh.polygons.vertex_indices);
+		REQUIRE_EQ(cooked.world_mesh.materials.size(), 1);
+		CHECK_EQ(cooked.world_mesh.materials[0].texture, "STONE.TGA");
+
+		REQUIRE_EQ(cooked.world_bsp_tree.nodes.size(), 1);
+		CHECK_EQ(cooked.world_bsp_tree.nodes[0].plane, zenkit::Vec4 {1, 0, 0, 5});
+		REQUIRE_EQ(cooked.world_bsp_tree.sectors.size(), 1);
+		CHECK_EQ(cooked.world_bsp_tree.sectors[0].name, "SECTOR");
+
+		REQUIRE_EQ(cooked.world_vobs.size(), wld.world_vobs.size());
+		CHECK_EQ(cooked.world_vobs[0]->vob_name, wld.world_vobs[0]->vob_name);
+		CHECK_EQ(cooked.world_vobs[0]->children.size(), wld.world_vobs[0]->children.size());
+
+		REQUIRE_EQ(cooked.world_way_net.waypoints.size(), wld.world_way_net.waypoints.size());
+		CHECK_EQ(cooked.world_way_net.waypoints.back().name, wld.world_way_net.waypoints.back().name);
+		CHECK_EQ(cooked.world_way_net.waypoints.back().position, wld.world_way_net.waypoints.back().position);
+		CHECK_EQ(cooked.world_way_net.edges.size(), wld.world_way_net.edges.size());
+
+		auto const* tex = loaded_assets.find("STONE-C.TEX");
+		REQUIRE_NE(tex, nullptr);
+		CHECK_EQ(tex->open_read()->read_ubyte(), 0x42);
+
+		// Loading in parallel and skipping parts of the world.
+		zenkit::WorldLoadOptions options {};
+		options.parallel = true;
+		options.skip_vobs = true;
+
+		zenkit::World partial {};
+		partial.load_cooked(zenkit::Read::from(&data).get(), options);
+		CHECK_EQ(partial.world_mesh.vertices, wld.world_mesh.vertices);
+		CHECK_EQ(partial.world_bsp_tree.nodes.size(), 1);
+		CHECK(partial.world_vobs.empty());
+
+		// Arrays which are longer than the rest of the world are rejected before they are allocated.
+		float const first[] = {1, 2, 3};
+		auto broken = data;
+		auto it = std::search(broken.begin(), broken.end(), reinterpret_cast<std::byte const*>(first),
+		                      reinterpret_cast<std::byte const*>(first) + sizeof first);
+		REQUIRE_NE(it, broken.end());
+		std::fill(it - 4, it, std::byte {0xFF});
+		CHECK_THROWS_AS(cooked.load_cooked(zenkit::Read::from(&broken).get()), zenkit::ParserError);
+
+		// Worlds saved by incompatible builds are rejected.
+		data[8] = std::byte {0xFF};
+		CHECK_THROWS_AS(cooked.load_cooked(zenkit::Read::from(&data).get()), zenkit::ParserError);
+
+		data[0] = std::byte {0};
+		CHECK_THROWS_AS(cooked.load_cooked(zenkit::Read::from(&data).get()), zenkit::ParserError);
+	}
+}
+
+static std::shared_ptr<zenkit::VirtualObject> make_vob(std::string name, zenkit::Vec3 position = {}) {
+	auto vob = std::make_shared<zenkit::VirtualObject>();
+	vob->type = zenkit::VirtualObjectType::zCVob;
+	vob->vob_name = std::move(name);
+	vob->position = position;
+	return vob;
+}
+
+static std::shared_ptr<zenkit::VirtualObject> find_vob(std::vector<std::shared_ptr<zenkit::VirtualObject>> const& vobs,
+                                                       std::string_view name) {
+	for (auto const& vob : vobs) {
+		if (vob->vob_name == name) return vob;
+		if (auto child = find_vob(vob->children, name); child != nullptr) return child;
+	}
+
+	return nullptr;
+}
+
+TEST_SUITE("WorldPatch") {
+	TEST_CASE("WorldPatch.diff") {
+		// base:   A(B, C), D, E
+		// target: A(C', F), D(B), G
+		zenkit::World base {};
+		base.world_vobs.push_back(make_vob("A"));
+		base.world_vobs[0]->children.push_back(make_vob("B"));
+		base.world_vobs[0]->children.push_back(make_vob("C"));
+		base.world_vobs.push_back(make_vob("D"));
+		base.world_vobs.push_back(make_vob("E"));
+		base.world_vobs[2]->children.push_back(make_vob("E_CHILD"));
+
+		zenkit::World target {};
+		target.world_vobs.push_back(make_vob("A"));
+		target.world_vobs[0]->children.push_back(make_vob("C", {1, 2, 3}));
+		target.world_vobs[0]->children.push_back(make_vob("F"));
+		target.world_vobs.push_back(make_vob("D"));
+		target.world_vobs[1]->children.push_back(make_vob("B"));
+		target.world_vobs.push_back(make_vob("G"));
+
+		auto patch = zenkit::WorldPatch::diff(base, target, zenkit::GameVersion::GOTHIC_1);
+		REQUIRE_EQ(patch.changed.size(), 4);
+		CHECK_EQ(patch.changed[0].key, "C");
+		CHECK_EQ(patch.changed[1].key, "F");
+		CHECK_EQ(patch.changed[1].parent, "A");
+		CHECK_EQ(patch.changed[2].key, "B");
+		CHECK_EQ(patch.changed[2].parent, "D");
+		CHECK_EQ(patch.changed[3].key, "G");
+		REQUIRE_EQ(patch.removed.size(), 1);
+		CHECK_EQ(patch.removed[0], "E");
+
+		CHECK(zenkit::WorldPatch::diff(target, target, zenkit::GameVersion::GOTHIC_1).empty());
+
+		// Round-trip the patch through an archive before applying it.
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		patch.save(w.get(), zenkit::GameVersion::GOTHIC_1, zenkit::ArchiveFormat::ASCII);
+
+		zenkit::WorldPatch loaded {};
+		auto r = zenkit::Read::from(&data);
+		loaded.load(r.get(), zenkit::GameVersion::GOTHIC_1);
+		REQUIRE_EQ(loaded.changed.size(), 4);
+
+		auto a = base.world_vobs[0];
+		loaded.apply(base);
+		CHECK(loaded.empty());
+
+		REQUIRE_EQ(base.world_vobs.size(), 3);
+		CHECK_EQ(base.world_vobs[0], a);
+		CHECK_EQ(base.world_vobs[1]->vob_name, "D");
+		CHECK_EQ(base.world_vobs[2]->vob_name, "G");
+
+		REQUIRE_EQ(a->children.size(), 2);
+		CHECK_EQ(a->children[0]->vob_name, "C");
+		CHECK_EQ(a->children[0]->position, zenkit::Vec3 {1, 2, 3});
+		CHECK_EQ(a->children[1]->vob_name, "F");
+
+		REQUIRE_EQ(base.world_vobs[1]->children.size(), 1);
+		CHECK_EQ(base.world_vobs[1]->children[0]->vob_name, "B");
+		CHECK_EQ(find_vob(base.world_vobs, "E_CHILD"), nullptr);
+	}
+
+	TEST_CASE("WorldPatch.diff(ambiguous)") {
+		// VObs without a unique name are matched by their order, not by their archive index.
+		zenkit::World base {};
+		base.world_vobs.push_back(make_vob(""));
+		base.world_vobs.push_back(make_vob("DUP"));
+		base.world_vobs[1]->children.push_back(make_vob(""));
+		base.world_vobs.push_back(make_vob("DUP"));
+		base.world_vobs[0]->id = 1;
+		base.world_vobs[1]->children[0]->id = 2;
+
+		zenkit::World target {};
+		target.world_vobs.push_back(make_vob(""));
+		target.world_vobs.push_back(make_vob("DUP"));
+		target.world_vobs[1]->children.push_back(make_vob("", {1, 2, 3}));
+		target.world_vobs.push_back(make_vob("DUP"));
+		target.world_vobs[0]->id = 7;
+		target.world_vobs[1]->children[0]->id = 3;
+
+		auto patch = zenkit::WorldPatch::diff(base, target, zenkit::GameVersion::GOTHIC_1);
+		REQUIRE_EQ(patch.changed.size(), 1);
+		CHECK_EQ(patch.changed[0].key, "#1:");
+		CHECK_EQ(patch.changed[0].parent, "#0:DUP");
+		CHECK(patch.removed.empty());
+
+		auto unchanged = base.world_vobs[0];
+		patch.apply(base);
+		REQUIRE_EQ(base.world_vobs.size(), 3);
+		CHECK_EQ(base.world_vobs[0], unchanged);
+		REQUIRE_EQ(base.world_vobs[1]->children.size(), 1);
+		CHECK_EQ(base.world_vobs[1]->children[0]->position, zenkit::Vec3 {1, 2, 3});
+		CHECK_EQ(base.world_vobs[1]->children[0]->id, 2);
+	}
+}
+
+TEST_SUITE("WorldIndex") {
+	TEST_CASE("WorldIndex.find_vob") {
+		zenkit::World world {};
+		auto a = std::make_shared<zenkit::VirtualObject>();
+		auto b = std::make_shared<zenkit::VirtualObject>();
+		auto c = std::make_shared<zenkit::VirtualObject>();
+		a->vob_name = "OW_CAMPFIRE";
+		b->vob_name = "Ow_Campfire";
+		c->vob_name = "FP_ROAM_01";
+
+		world.world_vobs = {a, c};
+		a->children = {b};
+
+		CHECK_EQ(world.find_vob("ow_campfire"), a.get());
+		CHECK_EQ(world.find_vob("FP_ROAM_01"), c.get());
+		CHECK_EQ(world.find_vob("FP_ROAM_02"), nullptr);
+
+		std::vector<zenkit::VirtualObject*> vobs;
+		world.find_vobs("OW_CAMPFIRE", vobs);
+		CHECK_EQ(vobs, std::vector<zenkit::VirtualObject*> {a.get(), b.get()});
+
+		// Changes are only picked up after invalidating the index.
+		c->vob_name = "FP_ROAM_02";
+		CHECK_EQ(world.find_vob("FP_ROAM_02"), nullptr);
+		world.invalidate_vob_index();
+		CHECK_EQ(world.find_vob("fp_roam_02"), c.get());
+	}
+
+	TEST_CASE("WorldIndex.find_waypoint") {
+		zenkit::World world {};
+		CHECK_FALSE(world.find_waypoint("WP_START").has_value());
+
+		world.world_way_net.waypoints.emplace_back().name = "WP_START";
+		world.world_way_net.waypoints.emplace_back().name = "WP_END";
+		CHECK_FALSE(world.find_waypoint("WP_START").has_value());
+
+		world.invalidate_waypoint_index();
+		CHECK_EQ(world.find_waypoint("wp_start"), 0);
+		CHECK_EQ(world.find_waypoint("WP_End"), 1);
+		CHECK_FALSE(world.find_waypoint("WP").has_value());
+	}
+}
+
+TEST_SUITE("WorldLoad") {
+	TEST_CASE("WorldLoad.arena") {
+		auto in = zenkit::Read::from("./samples/G1/Save/WORLD.SAV");
+		zenkit::World plain {};
+		plain.load(in.get(), zenkit::GameVersion::GOTHIC_1);
+
+		in = zenkit::Read::from("./samples/G1/Save/WORLD.SAV");
+		auto arena = zenkit::ObjectArena::create();
+		auto wld = std::make_unique<zenkit::World>();
+		wld->load(in.get(), zenkit::GameVersion::GOTHIC_1, arena);
+
+		REQUIRE_EQ(wld->world_vobs.size(), plain.world_vobs.size());
+		CHECK_EQ(wld->world_vobs[0]->vob_name, plain.world_vobs[0]->vob_name);
+		CHECK_EQ(wld->world_vobs.back()->vob_name, plain.world_vobs.back()->vob_name);
+		REQUIRE_EQ(wld->npcs.size(), plain.npcs.size());
+		CHECK_EQ(wld->npcs[0]->vob_name, plain.npcs[0]->vob_name);
+		CHECK_GT(arena->bytes_used(), 0);
+		CHECK_LT(arena->block_count(), 100);
+
+		// Objects keep the arena alive.
+		std::weak_ptr<zenkit::ObjectArena> weak = arena;
+		arena.reset();
+		CHECK_FALSE(weak.expired());
+		CHECK_EQ(wld->world_vobs[0]->vob_name, plain.world_vobs[0]->vob_name);
+
+		wld.reset();
+		CHECK(weak.expired());
+	}
+
+	TEST_CASE("WorldLoad.parallel") {
+		auto in = zenkit::Read::from("./samples/G1/Save/WORLD.SAV");
+		auto wld = std::make_shared<zenkit::World>();
+		wld->load(in.get(), zenkit::GameVersion::GOTHIC_1);
+
+		// Save-games don't contain the mesh and BSP-tree, so add some to decode in parallel.
+		wld->world_mesh.materials.emplace_back().name = "STONE";
+		wld->world_mesh.vertices = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+		wld->world_mesh.polygons.vertex_indices = {0, 1, 2};
+		wld->world_mesh.polygons.material_indices = {0};
+		wld->world_bsp_tree.nodes.push_back(zenkit::BspNode {{1, 0, 0, 5}, {}, 0, 1, -1, -1, -1});
+		wld->world_bsp_tree.polygon_indices = {0};
+		wld->world_bsp_tree.leaf_node_indices = {0};
+		wld->world_bsp_tree.sectors.push_back(zenkit::BspSector {"SECTOR", {0}, {}});
+
+		std::vector<std::byte> data;
+		auto w = zenkit::Write::to(&data);
+		auto ar = zenkit::WriteArchive::to(w.get(), zenkit::ArchiveFormat::BINARY);
+		ar->write_object(wld, zenkit::GameVersion::GOTHIC_1);
+		ar->write_header();
+
+		zenkit::World plain {};
+		plain.load(zenkit::Read::from(&data).get(), zenkit::GameVersion::GOTHIC_1);
+
+		zenkit::WorldLoadOptions options {};
+		options.parallel = true;
+
+		zenkit::World parallel {};
+		parallel.load(zenkit::Read::from(&data).get(), zenkit::GameVersion::GOTHIC_1, options);
+
+		REQUIRE_EQ(plain.world_mesh.vertices.size(), 3);
+		CHECK_EQ(parallel.world_mesh.vertices, plain.world_mesh.vertices);
+		CHECK_EQ(parallel.world_mesh.polygons.vertex_indices, plain.world_mesh.polygons.vertex_indices);
+		REQUIRE_EQ(plain.world_bsp_tree.nodes.size(), 1);
+		CHECK_EQ(parallel.world_bsp_tree.nodes.size(), plain.world_bsp_tree.nodes.size());
+		CHECK_EQ(parallel.world_bsp_tree.leaf_polygons, plain.world_bsp_tree.leaf_polygons);
+		REQUIRE_EQ(parallel.world_bsp_tree.sectors.size(), 1);
+		CHECK_EQ(parallel.world_bsp_tree.sectors[0].name, "SECTOR");
+		REQUIRE_EQ(parallel.world_vobs.size(), plain.world_vobs.size());
+		CHECK_EQ(parallel.world_vobs.back()->vob_name, plain.world_vobs.back()->vob_name);
+	}
+}
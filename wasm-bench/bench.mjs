@@ -0,0 +1,261 @@
+#!/usr/bin/env node
+/**
+ * ZenKit WASM Benchmarks
+ *
+ * Measures the time, peak WASM heap and bytes copied between JS and WASM of loading worlds, meshes and textures from
+ * the sample assets, see cases.mjs. Build the module using `npm run build:wasm` first.
+ *
+ * Usage: node wasm-bench/bench.mjs [--browser] [--filter <name>] [--runs <n>] [--time <ms>] [--no-save]
+ *                                  [--threshold <percent>] [--fail-on-regression]
+ *
+ *   --browser             Run in headless Chrome using puppeteer instead of Node.
+ *                         Install it using `npm install --no-save puppeteer`.
+ *   --filter <name>       Only run the cases whose name contains <name>.
+ *   --runs <n>            Run each case at least <n> times (default: 5).
+ *   --time <ms>           Run each case for at least <ms> milliseconds (default: 500).
+ *   --no-save             Don't append the results to the history.
+ *   --threshold <percent> Report cases whose median time grew by more than this (default: 15). Any growth of the
+ *                         peak heap or the copy volume is reported, since they are deterministic.
+ *   --fail-on-regression  Exit with a non-zero status if a regression was found.
+ *
+ * Results are appended to test-results/wasm-bench/history.json, separately for Node and Chrome. Each run is compared
+ * to the median of the last five runs in the same environment, and the trend of the last ten runs is shown.
+ */
+
+import fs from 'fs';
+import http from 'http';
+import path from 'path';
+import { execSync } from 'child_process';
+import { fileURLToPath, pathToFileURL } from 'url';
+import { runBenchmarks } from './cases.mjs';
+
+const ROOT = path.resolve(path.dirname(fileURLToPath(import.meta.url)), '..');
+const MODULE = path.join(ROOT, 'build-wasm', 'wasm', 'zenkit.mjs');
+const HISTORY = path.join(ROOT, 'test-results', 'wasm-bench', 'history.json');
+const HISTORY_LENGTH = 100;
+
+function parseArgs(argv) {
+    const args = { browser: false, filter: '', runs: 5, time: 500, save: true, threshold: 15, fail: false };
+
+    for (let i = 0; i < argv.length; i++) {
+        switch (argv[i]) {
+        case '--browser': args.browser = true; break;
+        case '--filter': args.filter = argv[++i] ?? ''; break;
+        case '--runs': args.runs = Number(argv[++i]); break;
+        case '--time': args.time = Number(argv[++i]); break;
+        case '--no-save': args.save = false; break;
+        case '--threshold': args.threshold = Number(argv[++i]); break;
+        case '--fail-on-regression': args.fail = true; break;
+        default:
+            console.error(`Unknown argument: ${argv[i]}`);
+            process.exit(2);
+        }
+    }
+
+    return args;
+}
+
+async function runInNode(args) {
+    const factory = (await import(pathToFileURL(MODULE).href)).default;
+    const loadAsset = async (asset) => {
+        const file = path.join(ROOT, asset);
+        return fs.existsSync(file) ? new Uint8Array(fs.readFileSync(file)) : null;
+    };
+
+    return runBenchmarks(() => factory(), loadAsset, {
+        filter: args.filter,
+        minRuns: args.runs,
+        minTime: args.time,
+        log: (line) => console.log(`  ${line}`),
+    });
+}
+
+const MIME_TYPES = {
+    '.html': 'text/html',
+    '.mjs': 'text/javascript',
+    '.js': 'text/javascript',
+    '.wasm': 'application/wasm',
+};
+
+// Serves the repository root. Cross-origin isolation is required by builds with pthreads support.
+function serve() {
+    const server = http.createServer((req, res) => {
+        const file = path.join(ROOT, decodeURIComponent(new URL(req.url, 'http://localhost').pathname));
+        if (!file.startsWith(ROOT) || !fs.existsSync(file) || !fs.statSync(file).isFile()) {
+            res.writeHead(404).end();
+            return;
+        }
+
+        res.writeHead(200, {
+            'Content-Type': MIME_TYPES[path.extname(file)] ?? 'application/octet-stream',
+            'Cross-Origin-Opener-Policy': 'same-origin',
+            'Cross-Origin-Embedder-Policy': 'require-corp',
+        });
+        fs.createReadStream(file).pipe(res);
+    });
+
+    return new Promise((resolve) => server.listen(0, '127.0.0.1', () => resolve(server)));
+}
+
+async function runInBrowser(args) {
+    let puppeteer;
+    try {
+        puppeteer = (await import('puppeteer')).default;
+    } catch {
+        console.error('puppeteer is required for --browser, install it using `npm install --no-save puppeteer`');
+        process.exit(2);
+    }
+
+    const server = await serve();
+    const browser = await puppeteer.launch({ headless: true });
+
+    try {
+        const page = await browser.newPage();
+        page.on('console', (message) => console.log(`  ${message.text()}`));
+
+        const query = new URLSearchParams({ filter: args.filter, minRuns: args.runs, minTime: args.time });
+        await page.goto(`http://127.0.0.1:${server.address().port}/wasm-bench/bench.html?${query}`);
+        await page.waitForFunction('window.benchResults || window.benchError', { timeout: 0 });
+
+        const error = await page.evaluate(() => window.benchError);
+        if (error) throw new Error(error);
+
+        return { results: await page.evaluate(() => window.benchResults), version: await browser.version() };
+    } finally {
+        await browser.close();
+        server.close();
+    }
+}
+
+function gitRevision() {
+    try {
+        return execSync('git rev-parse --short HEAD', { cwd: ROOT, stdio: ['ignore', 'pipe', 'ignore'] }).toString().trim();
+    } catch {
+        return null;
+    }
+}
+
+function loadHistory() {
+    try {
+        return JSON.parse(fs.readFileSync(HISTORY, 'utf8'));
+    } catch {
+        return [];
+    }
+}
+
+const median = (values) => {
+    const sorted = [...values].sort((a, b) => a - b);
+    return sorted[Math.floor(sorted.length / 2)];
+};
+
+const SPARKS = '▁▂▃▄▅▆▇█';
+
+// Draws the given values as a bar chart in a single line.
+function sparkline(values) {
+    const lo = Math.min(...values);
+    const hi = Math.max(...values);
+    return values.map((v) => SPARKS[hi === lo ? 0 : Math.round(((v - lo) / (hi - lo)) * (SPARKS.length - 1))]).join('');
+}
+
+const formatTime = (ms) => `${ms.toFixed(ms < 1 ? 3 : 2)} ms`;
+
+const formatBytes = (bytes) => {
+    if (bytes >= 1024 * 1024) return `${(bytes / 1024 / 1024).toFixed(1)} MiB`;
+    if (bytes >= 1024) return `${(bytes / 1024).toFixed(1)} KiB`;
+    return `${bytes} B`;
+};
+
+const formatChange = (current, baseline) => {
+    if (baseline === undefined || baseline === 0) return '';
+    const change = ((current - baseline) / baseline) * 100;
+    return `${change >= 0 ? '+' : ''}${change.toFixed(1)}%`;
+};
+
+// Prints the results compared to the previous runs and returns the regressions found.
+function report(results, previous, threshold) {
+    const regressions = [];
+    const rows = [['case', 'median', 'Δ', 'trend', 'min', 'runs', 'peak heap', 'Δ', 'copied/run', 'Δ']];
+
+    for (const [name, r] of Object.entries(results)) {
+        const past = previous.map((run) => run.results[name]).filter(Boolean);
+        const recent = past.slice(-5);
+
+        const baseTime = recent.length ? median(recent.map((p) => p.median)) : undefined;
+        const baseHeap = recent.length ? recent[recent.length - 1].heap : undefined;
+        const baseCopied = recent.length ? recent[recent.length - 1].copied : undefined;
+
+        if (baseTime !== undefined && r.median > baseTime * (1 + threshold / 100)) {
+            regressions.push(`${name}: median ${formatChange(r.median, baseTime)}`);
+        }
+        if (baseHeap !== undefined && r.heap > baseHeap) {
+            regressions.push(`${name}: peak heap ${formatChange(r.heap, baseHeap)}`);
+        }
+        if (baseCopied !== undefined && r.copied > baseCopied) {
+            regressions.push(`${name}: copied ${formatChange(r.copied, baseCopied)}`);
+        }
+
+        rows.push([
+            name,
+            formatTime(r.median),
+            formatChange(r.median, baseTime),
+            sparkline([...past.slice(-9).map((p) => p.median), r.median]),
+            formatTime(r.min),
+            String(r.runs),
+            formatBytes(r.heap),
+            formatChange(r.heap, baseHeap),
+            formatBytes(r.copied),
+            formatChange(r.copied, baseCopied),
+        ]);
+    }
+
+    const widths = rows[0].map((_, i) => Math.max(...rows.map((row) => row[i].length)));
+    for (const row of rows) {
+        console.log(row.map((cell, i) => (i === 0 ? cell.padEnd(widths[i]) : cell.padStart(widths[i]))).join('  '));
+    }
+
+    return regressions;
+}
+
+async function main() {
+    const args = parseArgs(process.argv.slice(2));
+
+    if (!fs.existsSync(MODULE)) {
+        console.error(`WASM module not found at ${MODULE}, build it using \`npm run build:wasm\``);
+        process.exit(2);
+    }
+
+    const environment = args.browser ? 'chrome' : 'node';
+    console.log(`Running ZenKit WASM benchmarks in ${environment}...`);
+
+    let results;
+    let version = process.version;
+    if (args.browser) {
+        ({ results, version } = await runInBrowser(args));
+    } else {
+        results = await runInNode(args);
+    }
+
+    console.log();
+
+    const history = loadHistory();
+    const previous = history.filter((run) => run.environment === environment);
+    const regressions = report(results, previous, args.threshold);
+
+    if (args.save) {
+        history.push({ date: new Date().toISOString(), revision: gitRevision(), environment, version, results });
+        fs.mkdirSync(path.dirname(HISTORY), { recursive: true });
+        fs.writeFileSync(HISTORY, JSON.stringify(history.slice(-HISTORY_LENGTH), null, 2));
+    }
+
+    if (regressions.length) {
+        console.log();
+        console.log('Possible regressions compared to the previous runs:');
+        for (const regression of regressions) console.log(`  ${regression}`);
+        if (args.fail) process.exit(1);
+    }
+}
+
+main().catch((error) => {
+    console.error(error);
+    process.exit(1);
+});
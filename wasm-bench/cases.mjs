@@ -0,0 +1,207 @@
+/**
+ * ZenKit WASM Benchmark Cases
+ *
+ * Shared by the Node and the headless Chrome runner, see bench.mjs. Each case runs in a fresh module instance, so the
+ * size of its WASM memory after the case is the peak heap of the case, since the memory never shrinks.
+ */
+
+// Assets relative to the repository root. Cases with missing assets are skipped.
+export const ASSETS = {
+    world: 'TOTENINSEL.ZEN',
+    modelMesh: 'tests/samples/secretdoor.mdm',
+    texture: 'tests/samples/erz.tex',
+};
+
+/**
+ * Count the bytes of the typed arrays in `value` which were copied out of the WASM heap. Views into the heap, like
+ * those of TypedBuffer, are not copies and are not counted.
+ */
+function countCopied(value, heap, seen = new Set()) {
+    if (value === null || typeof value !== 'object' || seen.has(value)) return 0;
+    seen.add(value);
+
+    if (value instanceof ArrayBuffer) return value === heap ? 0 : value.byteLength;
+    if (ArrayBuffer.isView(value)) return value.buffer === heap ? 0 : value.byteLength;
+
+    // Embind handles are not data.
+    if ('$$' in value) return 0;
+
+    let total = 0;
+    for (const key of Object.keys(value)) {
+        total += countCopied(value[key], heap, seen);
+    }
+    return total;
+}
+
+function loadWorld(zk, bytes) {
+    const world = zk.createWorld();
+    const result = world.loadFromArray(bytes);
+    if (!result.success) {
+        const error = result.errorMessage;
+        world.delete();
+        throw new Error(`Failed to load world: ${error}`);
+    }
+    return world;
+}
+
+function loadTexture(zk, bytes) {
+    const texture = new zk.Texture();
+    const result = texture.loadFromArray(bytes);
+    if (!result.success) {
+        texture.delete();
+        throw new Error(`Failed to load texture: ${result.errorMessage}`);
+    }
+    return texture;
+}
+
+/**
+ * The benchmark cases. `setup` prepares state which is not measured, `run` is measured and returns the data handed
+ * to JavaScript, which is counted as copied, and `input` is the number of bytes copied into the heap per run.
+ */
+export const CASES = [
+    {
+        name: 'world.loadFromArray',
+        asset: 'world',
+        input: (bytes) => bytes.length,
+        run: (zk, ctx, bytes) => {
+            loadWorld(zk, bytes).delete();
+        },
+    },
+    {
+        name: 'world.mesh.getTypedArrays',
+        asset: 'world',
+        setup: (zk, bytes) => ({ world: loadWorld(zk, bytes) }),
+        run: (zk, ctx) => {
+            const mesh = ctx.world.mesh;
+            const out = [
+                mesh.getVerticesTypedArray(),
+                mesh.getNormalsTypedArray(),
+                mesh.getUVsTypedArray(),
+                mesh.getIndicesTypedArray(),
+                mesh.getTriFeatureIndicesTypedArray(),
+                mesh.getPolygonMaterialIndicesTypedArray(),
+            ];
+            mesh.delete();
+            return out;
+        },
+        teardown: (ctx) => ctx.world.delete(),
+    },
+    {
+        name: 'world.getRenderBuffers',
+        asset: 'world',
+        setup: (zk, bytes) => ({ world: loadWorld(zk, bytes) }),
+        run: (zk, ctx) => ctx.world.getRenderBuffers(false),
+        teardown: (ctx) => ctx.world.delete(),
+    },
+    {
+        name: 'world.getVobData',
+        asset: 'world',
+        setup: (zk, bytes) => ({ world: loadWorld(zk, bytes) }),
+        run: (zk, ctx) => ctx.world.getVobData(),
+        teardown: (ctx) => ctx.world.delete(),
+    },
+    {
+        name: 'modelMesh.load+buildSkinnedBuffers',
+        asset: 'modelMesh',
+        input: (bytes) => bytes.length,
+        run: (zk, ctx, bytes) => {
+            const mesh = new zk.ModelMesh();
+            try {
+                const result = mesh.loadFromArray(bytes);
+                if (!result.success) throw new Error(`Failed to load model mesh: ${result.errorMessage}`);
+
+                const out = [];
+                for (let i = 0; i < mesh.meshCount; i++) out.push(mesh.buildSkinnedBuffers(i));
+                return out;
+            } finally {
+                mesh.delete();
+            }
+        },
+    },
+    {
+        name: 'texture.loadFromArray',
+        asset: 'texture',
+        input: (bytes) => bytes.length,
+        run: (zk, ctx, bytes) => {
+            loadTexture(zk, bytes).delete();
+        },
+    },
+    {
+        name: 'texture.asRgba8',
+        asset: 'texture',
+        setup: (zk, bytes) => ({ texture: loadTexture(zk, bytes) }),
+        run: (zk, ctx) => ctx.texture.asRgba8(0),
+        teardown: (ctx) => ctx.texture.delete(),
+    },
+    {
+        name: 'texture.asRgba8View',
+        asset: 'texture',
+        setup: (zk, bytes) => ({ texture: loadTexture(zk, bytes) }),
+        run: (zk, ctx) => {
+            const buffer = ctx.texture.asRgba8View(0);
+            const view = buffer.view();
+            buffer.delete();
+            return view;
+        },
+        teardown: (ctx) => ctx.texture.delete(),
+    },
+];
+
+const now = () => globalThis.performance.now();
+
+/**
+ * Run the benchmark cases.
+ *
+ * @param {() => Promise<object>} createModule Instantiates a new ZenKit module.
+ * @param {(path: string) => Promise<Uint8Array | null>} loadAsset Loads an asset relative to the repository root or
+ *        returns null if it does not exist.
+ * @param {{filter?: string, minRuns?: number, minTime?: number, log?: (line: string) => void}} [options] Only run
+ *        cases whose name contains `filter`. Each case is run at least `minRuns` times and for `minTime` ms.
+ * @returns {Promise<object>} The results by case name: the median and fastest time per run in ms, the number of runs,
+ *          the peak size of the WASM heap and the number of bytes copied between JS and WASM per run.
+ */
+export async function runBenchmarks(createModule, loadAsset, options = {}) {
+    const { filter = '', minRuns = 5, minTime = 500, log = () => {} } = options;
+    const assets = {};
+    const results = {};
+
+    for (const c of CASES) {
+        if (!c.name.includes(filter)) continue;
+
+        if (!(c.asset in assets)) assets[c.asset] = await loadAsset(ASSETS[c.asset]);
+        const bytes = assets[c.asset];
+        if (bytes === null) {
+            log(`skipping ${c.name}: ${ASSETS[c.asset]} not found`);
+            continue;
+        }
+
+        const zk = await createModule();
+        const ctx = c.setup ? c.setup(zk, bytes) : {};
+
+        // Warm up once, which also measures the copy volume.
+        const copied = countCopied(c.run(zk, ctx, bytes), zk.HEAPU8.buffer) + (c.input ? c.input(bytes) : 0);
+
+        const times = [];
+        const start = now();
+        while (times.length < minRuns || now() - start < minTime) {
+            const begin = now();
+            c.run(zk, ctx, bytes);
+            times.push(now() - begin);
+        }
+
+        if (c.teardown) c.teardown(ctx);
+
+        times.sort((a, b) => a - b);
+        results[c.name] = {
+            median: times[Math.floor(times.length / 2)],
+            min: times[0],
+            runs: times.length,
+            heap: zk.HEAPU8.length,
+            copied,
+        };
+
+        log(`${c.name}: ${results[c.name].median.toFixed(2)} ms`);
+    }
+
+    return results;
+}
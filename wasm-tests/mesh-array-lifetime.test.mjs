@@ -64,6 +64,42 @@ describe('Mesh typed array lifetime', () => {
         }
     });
 
+    test('view variants alias the WASM heap without copying and can be disposed', () => {
+        const { world, cleanup } = loadZenIntoWorld();
+        try {
+            const mesh = world.mesh;
+            const copy = mesh.getVerticesTypedArray();
+            const buffer = mesh.getVerticesView();
+            try {
+                expect(buffer.length).toBe(copy.length);
+                expect(buffer.byteLength).toBe(copy.length * 4);
+
+                // The view is only valid until the next call into ZenKit may grow the heap, so fetch it right here.
+                const vertices = buffer.view();
+                expect(vertices).toBeInstanceOf(Float32Array);
+                expect(vertices.buffer).toBe(zenkit.HEAPU8.buffer);
+                expect(vertices[0]).toBe(copy[0]);
+                expect(vertices[vertices.length - 1]).toBe(copy[copy.length - 1]);
+
+                buffer.dispose();
+                expect(buffer.length).toBe(0);
+                expect(buffer.view()).toBeNull();
+            } finally {
+                buffer.delete();
+            }
+
+            const indices = mesh.getIndicesView();
+            try {
+                expect(indices.view()).toBeInstanceOf(Uint32Array);
+                expect(indices.length).toBe(mesh.getIndicesTypedArray().length);
+            } finally {
+                indices.delete();
+            }
+        } finally {
+            cleanup();
+        }
+    });
+
     test('typed arrays remain readable after GC pressure when world reference is lost (best-effort)', () => {
         // This test is best-effort and may be skipped if Node GC is not exposed
         const canGc = typeof global.gc === 'function';
@@ -4,6 +4,9 @@
  * Tests the core functionality of loading and initializing the ZenKit WASM module.
  */
 
+import path from 'path';
+import fs from 'fs';
+
 describe('ZenKit WASM Module', () => {
     let zenkit;
 
@@ -41,6 +44,7 @@ describe('ZenKit WASM Module', () => {
             expect(info).toHaveProperty('version');
             expect(info).toHaveProperty('buildType');
             expect(info).toHaveProperty('hasMmap');
+            expect(info).toHaveProperty('hasSimd');
             expect(info).toHaveProperty('debugBuild');
         });
 
@@ -89,5 +93,52 @@ describe('ZenKit WASM Module', () => {
             zenkit._free(ptr);
         });
     });
+
+    describe('Loader', () => {
+        const loaderPath = path.join(process.cwd(), 'build-wasm', 'wasm', 'zenkit-loader.mjs');
+        const simdPath = path.join(process.cwd(), 'build-wasm', 'wasm', 'zenkit-simd.mjs');
+        let loader;
+
+        beforeAll(async () => {
+            loader = await import(`file://${loaderPath}`);
+        });
+
+        test('should detect WebAssembly SIMD support', () => {
+            expect(typeof loader.hasWasmSimd()).toBe('boolean');
+        });
+
+        test('should load the portable build if SIMD is disabled', async () => {
+            const instance = await loader.default({}, { simd: false });
+            expect(instance.getLibraryInfo().hasSimd).toBe(false);
+        });
+
+        test('should load the SIMD build if it is available and supported', async () => {
+            const instance = await loader.default();
+            const expected = loader.hasWasmSimd() && fs.existsSync(simdPath);
+            expect(instance.getLibraryInfo().hasSimd).toBe(expected);
+            expect(instance.getZenKitVersion()).toBe(zenkit.getZenKitVersion());
+        });
+
+        test('should report the full build as its module', () => {
+            expect(zenkit.getLibraryInfo().module).toBe('full');
+        });
+
+        test.each(['texture', 'mesh', 'world', 'archive', 'vfs'])('should load the %s module', async (name) => {
+            const instance = await loader.loadZenKitModule(name, {}, { simd: false });
+            const split = fs.existsSync(path.join(process.cwd(), 'build-wasm', 'wasm', `zenkit-${name}.mjs`));
+
+            expect(instance.getLibraryInfo().module).toBe(split ? name : 'full');
+            expect(instance.getZenKitVersion()).toBe(zenkit.getZenKitVersion());
+        });
+
+        test('should only contain the bindings of the subsystem in a split module', async () => {
+            if (!fs.existsSync(path.join(process.cwd(), 'build-wasm', 'wasm', 'zenkit-texture.mjs'))) return;
+
+            const instance = await loader.loadZenKitModule('texture', {}, { simd: false });
+            expect(typeof instance.Texture).toBe('function');
+            expect(instance.createWorld).toBeUndefined();
+            expect(instance.createVfs).toBeUndefined();
+        });
+    });
 });
 
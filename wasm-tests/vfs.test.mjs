@@ -0,0 +1,99 @@
+/**
+ * ZenKit Vfs Tests
+ *
+ * Tests mounting VDF disks, both from memory and lazily using a callback fetching byte ranges.
+ */
+
+import fs from 'fs';
+
+describe('ZenKit Vfs', () => {
+    let zenkit;
+    let disk;
+
+    beforeAll(async () => {
+        zenkit = await setupZenKit();
+        disk = new Uint8Array(fs.readFileSync(getTestDataPath('basic.vdf')));
+    }, 30000);
+
+    const expectBasicVdf = (vfs) => {
+        const files = vfs.listFiles();
+        expect(files).toContain('config.yml');
+        expect(files).toContain('readme.md');
+        expect(vfs.exists('licenses/gpl/lgpl-3.0.md')).toBe(true);
+        expect(vfs.exists('MIT.MD')).toBe(true);
+        expect(vfs.exists('nonexistent')).toBe(false);
+
+        const config = vfs.readFile('config.yml');
+        expect(new TextDecoder().decode(config.subarray(0, 6))).toBe('# Some');
+        expect(vfs.readFile('nonexistent')).toBeNull();
+    };
+
+    test('should mount a disk from memory', () => {
+        const vfs = zenkit.createVfs();
+
+        try {
+            expect(vfs.mountDisk(disk)).toBe(true);
+            expectBasicVdf(vfs);
+            expect(vfs.bytesFetched).toBe(0);
+        } finally {
+            vfs.delete();
+        }
+    });
+
+    test('should only fetch the ranges of a remote disk which are needed', () => {
+        const vfs = zenkit.createVfs();
+        const requests = [];
+        const fetchRange = (offset, length) => {
+            requests.push([offset, length]);
+            return disk.slice(offset, offset + length);
+        };
+
+        try {
+            expect(vfs.mountRemoteDisk(disk.length, fetchRange, 256, 8)).toBe(true);
+
+            // Only the header and catalog have been fetched.
+            const mounted = vfs.bytesFetched;
+            expect(mounted).toBeGreaterThan(0);
+            expect(mounted).toBeLessThan(disk.length);
+
+            expectBasicVdf(vfs);
+            expect(vfs.bytesFetched).toBeLessThan(disk.length);
+
+            for (const [offset, length] of requests) {
+                expect(offset % 256).toBe(0);
+                expect(offset + length).toBeLessThanOrEqual(disk.length);
+            }
+        } finally {
+            vfs.delete();
+        }
+    });
+
+    test('should fail to read files if their ranges cannot be fetched', () => {
+        const vfs = zenkit.createVfs();
+        let available = true;
+
+        try {
+            expect(vfs.mountRemoteDisk(disk.length, (offset, length) => {
+                return available ? disk.slice(offset, offset + length) : null;
+            }, 256, 1)).toBe(true);
+
+            available = false;
+            expect(vfs.readFile('readme.md')).toBeNull();
+            expect(vfs.getLastError()).not.toBe('');
+        } finally {
+            vfs.delete();
+        }
+    });
+
+    test('should reject invalid disks', () => {
+        const vfs = zenkit.createVfs();
+
+        try {
+            expect(vfs.mountRemoteDisk(1024, () => new Uint8Array(1024).fill(0x41).subarray(0, 1024), 256, 8))
+                .toBe(false);
+            expect(vfs.getLastError()).not.toBe('');
+        } finally {
+            vfs.delete();
+        }
+    });
+});
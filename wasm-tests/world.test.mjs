@@ -163,6 +163,136 @@ describe('ZenKit World', () => {
         });
     });
 
+    describe('Arenas', () => {
+        test('should only reset an arena once the world using it has been unloaded', () => {
+            const arena = zenkit.createArena(64 * 1024);
+            const world = zenkit.createWorld();
+
+            try {
+                world.setArena(arena);
+                expect(arena.bytesUsed).toBe(0);
+                expect(arena.reset()).toBe(true);
+
+                const result = world.loadFromArray(new TextEncoder().encode('not a world'));
+                expect(result.success).toBe(false);
+
+                expect(world.unload()).toBe(true);
+                expect(world.getLastError()).toBe('');
+                expect(arena.reset()).toBe(true);
+                expect(arena.bytesUsed).toBe(0);
+            } finally {
+                world.delete();
+                arena.delete();
+            }
+        });
+
+        test('should fall back to the heap once the arena has been deleted', () => {
+            const arena = zenkit.createArena(64 * 1024);
+            const world = zenkit.createWorld();
+
+            try {
+                world.setArena(arena);
+                arena.delete();
+                expect(world.loadFromArray(new Uint8Array(16)).success).toBe(false);
+                world.clearArena();
+            } finally {
+                world.delete();
+            }
+        });
+    });
+
+    describe('Render Buffers', () => {
+        test('should export empty render buffers for an unloaded world', () => {
+            const world = zenkit.createWorld();
+
+            try {
+                const buffers = world.getRenderBuffers(false);
+                expect(buffers.buffer).toBeInstanceOf(ArrayBuffer);
+                expect(buffers.buffer.byteLength).toBe(0);
+                expect(buffers.vertexCount).toBe(0);
+                expect(buffers.vertexStride).toBe(36);
+                expect(buffers.layout).toEqual({ position: 0, normal: 12, texture: 24, color: 32 });
+                expect(buffers.indexCount).toBe(0);
+                expect(buffers.indexFormat).toBe('uint16');
+                expect(buffers.batches).toEqual([]);
+            } finally {
+                world.delete();
+            }
+        });
+    });
+
+    describe('Bulk VOb Access', () => {
+        test('should export an empty VOb table for an unloaded world', () => {
+            const world = zenkit.createWorld();
+
+            try {
+                const vobs = world.getVobData();
+                expect(vobs.count).toBe(0);
+                expect(vobs.positions).toBeInstanceOf(Float32Array);
+                expect(vobs.positions.length).toBe(0);
+                expect(vobs.rotations.length).toBe(0);
+                expect(vobs.bboxes.length).toBe(0);
+                expect(vobs.types).toBeInstanceOf(Uint16Array);
+                expect(vobs.parents).toBeInstanceOf(Int32Array);
+                expect(vobs.names.offsets).toEqual(new Uint32Array([0]));
+                expect(zenkit.decodeStringTable(vobs.names)).toEqual([]);
+                expect(zenkit.decodeStringTable(vobs.visualNames)).toEqual([]);
+            } finally {
+                world.delete();
+            }
+        });
+
+        test('should decode string tables', () => {
+            const table = {
+                data: new Uint8Array([0x46, 0x49, 0x52, 0x45, 0x50, 0x4C, 0xC4, 0x54, 0x5A, 0x45]),
+                offsets: new Uint32Array([0, 4, 4, 10]),
+            };
+
+            expect(zenkit.decodeStringTable(table)).toEqual(['FIRE', '', 'PL\u00C4TZE']);
+        });
+    });
+
+    describe('Streaming World Loading', () => {
+        const streamOf = (bytes, chunkSize) => new ReadableStream({
+            start(controller) {
+                for (let i = 0; i < bytes.length; i += chunkSize) {
+                    controller.enqueue(bytes.subarray(i, i + chunkSize));
+                }
+                controller.close();
+            },
+        });
+
+        test('should count the bytes pushed into a stream loader', () => {
+            const loader = zenkit.createWorldStreamLoader(0, false);
+
+            try {
+                expect(loader.push(new Uint8Array(10))).toBe(true);
+                expect(loader.push(new Uint8Array(5))).toBe(true);
+                expect(loader.bytesReceived).toBe(15);
+
+                loader.finish();
+                expect(loader.push(new Uint8Array(1))).toBe(false);
+                expect(loader.bytesReceived).toBe(15);
+            } finally {
+                loader.delete();
+            }
+        });
+
+        test('should reject invalid world data received in chunks', async () => {
+            const bytes = new TextEncoder().encode('ZenGin Archive\nver 1\nnot a world\n'.repeat(64));
+            const progress = [];
+
+            await expect(zenkit.loadWorldStream(streamOf(bytes, 100), {
+                onProgress: (received) => progress.push(received),
+            })).rejects.toThrow();
+
+            expect(progress.length).toBeGreaterThan(0);
+            for (let i = 1; i < progress.length; i++) {
+                expect(progress[i]).toBeGreaterThan(progress[i - 1]);
+            }
+        });
+    });
+
     describe('World Resource Management', () => {
         test('should clean up resources after errors', () => {
             const world = zenkit.createWorld();
@@ -4,10 +4,45 @@ declare module 'zenkit' {
     openVdf(path: string): Promise<VdfArchive>;
     createVdf(): VdfArchive;
 
+    /** Creates an empty virtual file system to mount VDF disks into. */
+    createVfs(): Vfs;
+
+    /**
+     * Mounts a VDF disk served over HTTP without downloading it completely. Only its catalog is fetched up front; the
+     * contents of files are fetched using range requests once they are read.
+     */
+    mountRemoteVdf(vfs: Vfs, url: string, options?: { blockSize?: number; cacheBlocks?: number }): Promise<void>;
+
+    /** Creates a callback for Vfs.mountRemoteDisk which uses synchronous HTTP range requests. */
+    createRangeFetcher(url: string): (offset: number, length: number) => Uint8Array | null;
+
     // World operations
     loadWorld(buffer: ArrayBuffer): Promise<World>;
+
+    /**
+     * Parses a world on a worker when built with ZK_WASM_THREADS, without blocking the calling thread. Builds
+     * without pthreads support parse it on the calling thread once the current task has finished. Setting
+     * `parallel` additionally decodes the mesh and BSP-tree on their own workers and requires a `version`.
+     */
+    loadWorldAsync(data: Uint8Array, options?: { version?: 0 | 1 | 2; parallel?: boolean }): Promise<World>;
+
+    /**
+     * Loads a world while it is being downloaded, e.g. from the `body` of a `fetch` response, without collecting it
+     * into one array first. Builds with ZK_WASM_THREADS parse the world on a worker while it is being received.
+     */
+    loadWorldStream(
+      stream: ReadableStream<Uint8Array>,
+      options?: { version?: 0 | 1 | 2; parallel?: boolean; onProgress?: (bytesReceived: number) => void },
+    ): Promise<World>;
+
+    /** Creates an arena for the objects of worlds, allocating memory in blocks of the given size. */
+    createArena(blockSize: number): Arena;
+
     loadMesh(buffer: ArrayBuffer): Promise<Mesh>;
 
+    /** Decodes a string table, by default as Windows-1252 like the game's files. */
+    decodeStringTable(table: StringTable, encoding?: string): string[];
+
     // Texture operations
     loadTexture(buffer: ArrayBuffer): Promise<Texture>;
   }
@@ -24,8 +59,103 @@ declare module 'zenkit' {
     data: Uint8Array;
   }
 
+  export interface Vfs {
+    mountDisk(data: Uint8Array): boolean;
+
+    /**
+     * Mounts a disk of the given size whose byte ranges are returned synchronously by `fetch`, which should return
+     * null if a range cannot be fetched. At least `blockSize` bytes are fetched at once and the `cacheBlocks` most
+     * recently used blocks are kept in memory.
+     */
+    mountRemoteDisk(
+      size: number,
+      fetch: (offset: number, length: number) => Uint8Array | null,
+      blockSize: number,
+      cacheBlocks: number,
+    ): boolean;
+
+    exists(path: string): boolean;
+
+    /** Reads a file by its path or, if there is no such path, by its name, ignoring case. */
+    readFile(path: string): Uint8Array | null;
+    listFiles(): string[];
+    getLastError(): string;
+
+    /** The number of bytes fetched from remote disks so far. */
+    readonly bytesFetched: number;
+    delete(): void;
+  }
+
   export interface World {
-    // World data
+    /** Allocates the objects of worlds loaded from now on in the arena. The world does not keep the arena alive. */
+    setArena(arena: Arena): void;
+    clearArena(): void;
+
+    /** Destroys all data of the world, so that its arena can be reset. Returns false while the world is loading. */
+    unload(): boolean;
+
+    /**
+     * Builds interleaved vertex and index buffers of the world mesh grouped by material, optionally reordering the
+     * triangles of each batch for the vertex cache of the GPU.
+     */
+    getRenderBuffers(optimizeVertexCache: boolean): RenderBuffers;
+
+    /** Copies the commonly needed fields of all VObs at once, see VobData. */
+    getVobData(): VobData;
+  }
+
+  /**
+   * Deduplicated, interleaved vertices followed by the indices in a single buffer. Each vertex is `vertexStride` bytes
+   * wide and holds three floats for the position and the normal, two for the UV and a packed RGBA color at the offsets
+   * in `layout`.
+   */
+  export interface RenderBuffers {
+    buffer: ArrayBuffer;
+    vertexCount: number;
+    vertexStride: number;
+    layout: { position: number; normal: number; texture: number; color: number };
+    indexByteOffset: number;
+    indexCount: number;
+    indexFormat: 'uint16' | 'uint32';
+    /** Ranges of indices drawn using the material at index `material` of the world mesh. */
+    batches: { material: number; indexOffset: number; indexCount: number }[];
+  }
+
+  /** Memory for the objects of worlds which is reused for the next world after a reset. */
+  export interface Arena {
+    /** Rewinds the arena. Returns false and does nothing while a world using it is still loaded. */
+    reset(): boolean;
+    readonly bytesUsed: number;
+    readonly blockCount: number;
+    delete(): void;
+  }
+
+  /** A list of strings, where string `i` is stored in `data` from `offsets[i]` up to `offsets[i + 1]`. */
+  export interface StringTable {
+    data: Uint8Array;
+    offsets: Uint32Array;
+  }
+
+  /**
+   * The VObs of a world as a struct of arrays. VObs are listed depth-first, every VOb followed by its children, and
+   * all arrays are indexed by the position of a VOb in that list.
+   */
+  export interface VobData {
+    count: number;
+    /** 3 floats per VOb. */
+    positions: Float32Array;
+    /** 9 floats per VOb, a column-major 3x3 matrix. */
+    rotations: Float32Array;
+    /** 6 floats per VOb, the minimum followed by the maximum corner. */
+    bboxes: Float32Array;
+    types: Uint16Array;
+    /** The VisualType of each VOb or 255 if it does not have a visual. */
+    visualTypes: Uint8Array;
+    ids: Uint32Array;
+    /** The index of the parent of each VOb or -1. */
+    parents: Int32Array;
+    names: StringTable;
+    visualNames: StringTable;
   }
 
   export interface Mesh {
@@ -36,6 +166,19 @@ declare module 'zenkit' {
     // Texture data
   }
 
+  /** Whether the engine supports WebAssembly SIMD, i.e. whether the SIMD build of ZenKit can be loaded. */
+  export function hasWasmSimd(): boolean;
+
+  /**
+   * Loads the minimal module of a subsystem built with ZK_WASM_SPLIT, falling back to the full build if it is not
+   * deployed. The mesh module contains the texture bindings as well.
+   */
+  export function loadZenKitModule(
+    name: 'texture' | 'mesh' | 'world' | 'archive' | 'vfs',
+    moduleArg?: object,
+    options?: { simd?: boolean },
+  ): Promise<ZenKit>;
+
   const zenkit: ZenKit;
   export default zenkit;
 }